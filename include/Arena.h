@@ -0,0 +1,48 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Arena allocator for objects which all share the same lifetime, such as everything allocated for a debug session. */
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <try_catch.h>
+
+
+/* Small allocations are carved out of blocks of this many bytes.  Allocations larger than a quarter of a block get a
+   block of their own so that they don't waste the remainder of the current one. */
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+typedef struct ArenaBlock ArenaBlock;
+
+/* A zero filled Arena is empty and ready for use. */
+typedef struct Arena
+{
+    ArenaBlock* pBlocks;
+    uint8_t*    pNext;
+    size_t      bytesLeft;
+    size_t      blockCount;
+} Arena;
+
+
+/* Allocations are zero filled and aligned for any type.  Throws outOfMemoryException on failure.  There is no way to
+   free individual allocations, they are all freed at once by Arena_Uninit(). */
+__throws void* Arena_Alloc(Arena* pThis, size_t size);
+/* pOld must be NULL or have been returned from pThis with a size of oldSize.  The contents are preserved and any
+   growth is zero filled.  Growing the most recent allocation is done in place when there is room in its block, otherwise
+   the old allocation is abandoned until Arena_Uninit(). */
+__throws void* Arena_Realloc(Arena* pThis, void* pOld, size_t oldSize, size_t newSize);
+         void  Arena_Uninit(Arena* pThis);
+
+
+#endif /* _ARENA_H_ */
@@ -0,0 +1,24 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Monotonic clock used to time the phases of a CrashDebug session. */
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+#include <stdint.h>
+
+
+/* Returns the number of microseconds elapsed since some arbitrary point in the past. */
+uint64_t Clock_GetMicroseconds(void);
+
+
+#endif /* _CLOCK_H_ */
@@ -0,0 +1,37 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Compact dump container with a region index, optional per-region LZ compression and CRC-32 checksums. */
+#ifndef _COMPACT_DUMP_H_
+#define _COMPACT_DUMP_H_
+
+
+#include <try_catch.h>
+#include <DumpStream.h>
+#include <IMemory.h>
+#include <mriPlatform.h>
+
+
+/* Compact dump files start with these 4 bytes. */
+#define COMPACT_DUMP_SIGNATURE      "CDMP"
+#define COMPACT_DUMP_SIGNATURE_SIZE 4
+
+
+__throws void CompactDump_Read(IMemory* pMem, RegisterContext* pContext, const char* pFilename);
+/* Compact dumps need random access so the rest of pStream is copied into memory rather than mapped. */
+__throws void CompactDump_ReadFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream);
+/* Writes the registers and every writable region of pMem (a MemorySim instance) to pFilename.  FLASH isn't included
+   since it comes from the --elf/--bin image, just like it does for CrashCatcher dumps. */
+__throws void CompactDump_Write(IMemory* pMem, const RegisterContext* pContext, const char* pFilename);
+
+
+#endif /* _COMPACT_DUMP_H_ */
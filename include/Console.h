@@ -13,10 +13,14 @@
 #ifndef _CONSOLE_H_
 #define _CONSOLE_H_
 
+#include <stdint.h>
 #include <try_catch.h>
 
 
 __throws int  Console_HasStdInDataToRead(void);
+/* Blocks until stdin has data to read or timeoutMilliseconds has elapsed without consuming any CPU while waiting.
+   Returns non-zero if there is data to be read. */
+__throws int  Console_WaitForStdInData(uint32_t timeoutMilliseconds);
 __throws int  Console_ReadStdIn(void);
 __throws void Console_WriteStdOut(int character);
 
@@ -0,0 +1,77 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Captures a CrashCatcher hex dump from a live serial port or pty, skipping the text which surrounds it. */
+#ifndef _CRASH_CAPTURE_H_
+#define _CRASH_CAPTURE_H_
+
+#include <DumpStream.h>
+#include <IMemory.h>
+#include <mriPlatform.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <try_catch.h>
+
+
+/* Lines which the CrashCatcher HexDump module sends before and after each dump. */
+#define CRASH_CAPTURE_BANNER_TEXT "CRASH ENCOUNTERED"
+#define CRASH_CAPTURE_END_TEXT    "End of dump"
+
+/* Baud rate used by CrashCapture_FromFile() when pCaptureFilename is a serial port and no other rate is requested. */
+#define CRASH_CAPTURE_DEFAULT_BAUD_RATE 115200
+
+typedef enum CrashCaptureLineType
+{
+    CRASH_CAPTURE_LINE_BLANK,
+    CRASH_CAPTURE_LINE_BANNER,
+    /* Hex digits starting with the "6343" signature. */
+    CRASH_CAPTURE_LINE_SIGNATURE,
+    CRASH_CAPTURE_LINE_HEX,
+    CRASH_CAPTURE_LINE_END,
+    CRASH_CAPTURE_LINE_OTHER
+} CrashCaptureLineType;
+
+typedef struct CrashCapture
+{
+    /* Binary CrashCatcher dump decoded so far. */
+    uint8_t* pDump;
+    size_t   dumpSize;
+    size_t   dumpCapacity;
+    int      state;
+    int      pendingNibble;
+    /* Set when lines are to be ignored until the "CRASH ENCOUNTERED" banner, both at the start and after a dump is
+       interrupted. */
+    int      isBannerRequired;
+} CrashCapture;
+
+
+/* Blocks reading lines from pCaptureFilename until a complete hex dump has been received and then loads it into pMem
+   and pContext.  Everything before the "CRASH ENCOUNTERED" banner is ignored, so hex in other output can't be mistaken
+   for a dump.  The dump then starts with the first line of hex digits beginning with the "6343" signature and ends with
+   the "End of dump" line.  A dump interrupted by a new banner or by other text is discarded and capture starts over
+   with the next one.  When pCaptureFilename is a serial port it is switched to raw mode at baudRate first. */
+__throws void CrashCapture_FromFile(IMemory* pMem, RegisterContext* pContext, const char* pCaptureFilename,
+                                    uint32_t baudRate);
+/* Same as above but reads from an already open stream which the caller still owns. */
+__throws void CrashCapture_FromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream);
+
+/* Incremental interface used by the above for callers which provide their own lines of text.  HandleLine() returns
+   TRUE once the "End of dump" line has completed a dump, at which point pDump/dumpSize hold it in binary form.  Unlike
+   the above, a capture started with Init() accepts a dump without first seeing the banner since callers such as
+   CrashLog hand it lines starting at the signature. */
+         void                 CrashCapture_Init(CrashCapture* pThis);
+         void                 CrashCapture_Uninit(CrashCapture* pThis);
+__throws int                  CrashCapture_HandleLine(CrashCapture* pThis, const char* pLine, size_t lineLength);
+         CrashCaptureLineType CrashCapture_ClassifyLine(const char* pLine, size_t lineLength);
+
+
+#endif /* _CRASH_CAPTURE_H_ */
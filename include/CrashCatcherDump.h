@@ -15,12 +15,23 @@
 
 
 #include <try_catch.h>
+#include <DumpStream.h>
 #include <MemorySim.h>
 #include <mriPlatform.h>
 
 
 __throws void CrashCatcherDump_ReadBinary(IMemory* pMem, RegisterContext* pContext, const char* pCrashDumpFilename);
 __throws void CrashCatcherDump_ReadHex(IMemory* pMem, RegisterContext* pContext, const char* pCrashDumpFilename);
+/* Same as above but read from an already open stream which the caller still owns.  Binary dump regions are only loaded
+   lazily from the file when pStream is seekable. */
+__throws void CrashCatcherDump_ReadBinaryFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream);
+__throws void CrashCatcherDump_ReadHexFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream);
+/* Reads a binary dump which has already been copied into memory.  Regions are copied out of pDump so it can be freed
+   as soon as this returns. */
+__throws void CrashCatcherDump_ReadBinaryFromMemory(IMemory* pMem,
+                                                   RegisterContext* pContext,
+                                                   const void* pDump,
+                                                   size_t dumpSize);
 
 
 #endif /* _CRASH_CATCHER_DUMP_H_ */
@@ -14,7 +14,9 @@
 #define _CRASHDEBUG_COMMANDLINE_H_
 
 #include <mriPlatform.h>
+#include <ElfSymbols.h>
 #include <IMemory.h>
+#include <MappedFile.h>
 #include <try_catch.h>
 
 typedef struct CrashDebugCommandLine
@@ -22,9 +24,30 @@ typedef struct CrashDebugCommandLine
     const char*     pElfFilename;
     const char*     pBinFilename;
     const char*     pDumpFilename;
+    const char*     pCacheDirectory;
+    const char*     pDedupDirectory;
+    const char*     pSplitDirectory;
+    const char*     pCoreFilename;
+    const char*     pConvertFilename;
+    const char*     pTraceFilename;
+    const char*     pDiffFilename;
+    const char*     pCaptureFilename;
+    const char*     pCaptureScriptFilename;
+    const char*     pMemoryMapFilename;
     IMemory*        pMemory;
+    MappedFile      elfCacheFile;
+    ElfSymbols      symbols;
     RegisterContext context;
+    uint64_t        startMicroseconds;
+    uint64_t        imageLoadedMicroseconds;
+    uint64_t        dumpLoadedMicroseconds;
     uint32_t        baseAddress;
+    uint32_t        baudRate;
+    unsigned int    jobCount;
+    unsigned int    ramImageCount;
+    int             displayStats;
+    int             displayHeap;
+    int             displayStacks;
 } CrashDebugCommandLine;
 
 
@@ -0,0 +1,26 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Report of the runtime statistics gathered when the --stats command line option is used. */
+#ifndef _CRASHDEBUG_STATS_H_
+#define _CRASHDEBUG_STATS_H_
+
+#include <CrashDebugCommandLine.h>
+#include <StatsIComm.h>
+
+
+/* Prints the time spent in each phase of the session along with the MemorySim counters for pCommandLine->pMemory and
+   the per packet type GDB counters from pRspStats to stderr.  pRspStats can be NULL if GDB was never connected. */
+void CrashDebugStats_Print(const CrashDebugCommandLine* pCommandLine, const RspStats* pRspStats);
+
+
+#endif /* _CRASHDEBUG_STATS_H_ */
@@ -0,0 +1,59 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Groups a directory full of crash dumps (or a log containing many hex dumps) by their crash signatures. */
+#ifndef _CRASH_DEDUP_H_
+#define _CRASH_DEDUP_H_
+
+#include <CrashLog.h>
+#include <CrashSignature.h>
+#include <IMemory.h>
+#include <stddef.h>
+#include <try_catch.h>
+
+
+typedef struct CrashDedupEntry
+{
+    /* Dumps found in a log are named "logFilename:lineNumber". */
+    char*          pFilename;
+    unsigned long  lineNumber;
+    size_t         logDumpIndex;
+    CrashSignature signature;
+    int            exceptionCode;
+    char           exceptionMessage[256];
+} CrashDedupEntry;
+
+typedef struct CrashDedup
+{
+    CrashDedupEntry* pEntries;
+    size_t           entryCount;
+    CrashLog         log;
+    const char*      pSplitDirectory;
+} CrashDedup;
+
+
+/* Loads every dump in pDumpDirectory on top of the read-only FLASH regions already in pFlashMemory (which must be a
+   MemorySim instance) and calculates its crash signature.  The dumps are processed by jobCount threads (or one per
+   processor if jobCount is 0).  Upon return, pEntries is sorted so that dumps with the same signature are adjacent
+   and dumps which failed to load (non-zero exceptionCode) are at the end.  If pDumpDirectory is actually a regular
+   file then it is treated as a log, just like CrashDedup_InitFromLog() without a split directory. */
+__throws void CrashDedup_Init(CrashDedup* pThis, IMemory* pFlashMemory, const char* pDumpDirectory, unsigned int jobCount);
+/* Same as CrashDedup_Init() but for every CrashCatcher hex dump embedded in the serial log, pLogFilename.  The log is
+   indexed in one pass and then each dump is decoded by the worker threads.  If pSplitDirectory isn't NULL, each dump
+   is also written to it as a binary dump named crash-lineNumber.dmp. */
+__throws void CrashDedup_InitFromLog(CrashDedup* pThis, IMemory* pFlashMemory, const char* pLogFilename,
+                                     const char* pSplitDirectory, unsigned int jobCount);
+         void CrashDedup_Uninit(CrashDedup* pThis);
+         void CrashDedup_PrintReport(CrashDedup* pThis);
+
+
+#endif /* _CRASH_DEDUP_H_ */
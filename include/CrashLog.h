@@ -0,0 +1,50 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Indexes the CrashCatcher hex dumps embedded in a serial log so that they can be decoded independently. */
+#ifndef _CRASH_LOG_H_
+#define _CRASH_LOG_H_
+
+#include <CrashCapture.h>
+#include <MappedFile.h>
+#include <stddef.h>
+#include <try_catch.h>
+
+
+typedef struct CrashLogDump
+{
+    /* Offset and size of the dump's text within the log, from its signature line through its "End of dump" line. */
+    size_t        offset;
+    size_t        size;
+    /* 1-based line number of the signature line. */
+    unsigned long lineNumber;
+} CrashLogDump;
+
+typedef struct CrashLog
+{
+    MappedFile    mapping;
+    CrashLogDump* pDumps;
+    size_t        dumpCount;
+} CrashLog;
+
+
+/* Maps pLogFilename and finds every complete hex dump within it in a single pass, using the same framing rules as
+   CrashCapture.  Dumps which are interrupted or never finish aren't indexed. */
+__throws void CrashLog_Open(CrashLog* pThis, const char* pLogFilename);
+         void CrashLog_Close(CrashLog* pThis);
+
+/* Decodes the indexed dump into pCapture (which must have just been initialized).  The log is only read so different
+   threads can decode different dumps at the same time. */
+__throws void CrashLog_DecodeDump(const CrashLog* pThis, size_t dumpIndex, CrashCapture* pCapture);
+
+
+#endif /* _CRASH_LOG_H_ */
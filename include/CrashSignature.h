@@ -0,0 +1,39 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Calculates a stable signature for a crash so that dumps of the same crash can be grouped together. */
+#ifndef _CRASH_SIGNATURE_H_
+#define _CRASH_SIGNATURE_H_
+
+#include <IMemory.h>
+#include <mriPlatform.h>
+#include <stdint.h>
+
+
+/* Maximum number of return addresses recovered from the stack and included in the signature. */
+#define CRASH_SIGNATURE_MAX_FRAMES 8
+
+typedef struct CrashSignature
+{
+    uint64_t    hash;
+    FaultStatus faultStatus;
+    uint32_t    pc;
+    uint32_t    frameCount;
+    uint32_t    frames[CRASH_SIGNATURE_MAX_FRAMES];
+} CrashSignature;
+
+
+/* pMem must be a MemorySim instance since its read-only regions are used to recognize code addresses. */
+CrashSignature CrashSignature_Calculate(IMemory* pMem, const RegisterContext* pContext);
+
+
+#endif /* _CRASH_SIGNATURE_H_ */
@@ -0,0 +1,34 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* CRC-32 checksum using the same polynomial (0xEDB88320 reflected) as zlib, gzip and PNG.  The non-reflected variant
+   used by GDB's qCRC packet (polynomial 0x04C11DB7 with no final inversion) is also provided. */
+#ifndef _CRC32_H_
+#define _CRC32_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* Crc32_Update(Crc32_Update(0, pA, a), pB, b) matches the CRC of the concatenated buffers. */
+uint32_t Crc32_Calculate(const void* pData, size_t size);
+uint32_t Crc32_Update(uint32_t crc, const void* pData, size_t size);
+
+/* Matches the CRC calculated by GDB's compare-sections command.  The CRC starts at CRC32_GDB_INITIAL and
+   Crc32_GdbUpdate() can be called repeatedly to add more data to it. */
+#define CRC32_GDB_INITIAL 0xFFFFFFFF
+
+uint32_t Crc32_GdbCalculate(const void* pData, size_t size);
+uint32_t Crc32_GdbUpdate(uint32_t crc, const void* pData, size_t size);
+
+
+#endif /* _CRC32_H_ */
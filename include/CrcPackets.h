@@ -0,0 +1,26 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* PacketIComm handler which answers GDB's qCRC requests (used by compare-sections) directly from the simulated memory
+   rather than letting GDB read each section back to calculate its CRC itself. */
+#ifndef _CRC_PACKETS_H_
+#define _CRC_PACKETS_H_
+
+#include <stddef.h>
+
+
+/* PacketHandler to be passed to PacketIComm_AddHandler() along with the MemorySim based IMemory to be checked. */
+int CrcPackets_Handle(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                      char* pResponse, size_t responseSize);
+
+
+#endif /* _CRC_PACKETS_H_ */
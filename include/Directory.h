@@ -0,0 +1,33 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Lists the names of the entries in a host directory. */
+#ifndef _DIRECTORY_H_
+#define _DIRECTORY_H_
+
+#include <try_catch.h>
+
+
+typedef struct Directory Directory;
+
+
+/* Throws fileException if pDirectory can't be opened. */
+__throws Directory*  Directory_Open(const char* pDirectory);
+/* Returns the name of the next entry (valid until the next call) or NULL once they have all been returned.  Hidden
+   entries, whose names start with a '.', are skipped.  The order is file system specific. */
+         const char* Directory_Next(Directory* pThis);
+         void        Directory_Close(Directory* pThis);
+/* Returns TRUE if pPath is an existing regular file rather than a directory or something else. */
+         int         Directory_IsRegularFile(const char* pPath);
+
+
+#endif /* _DIRECTORY_H_ */
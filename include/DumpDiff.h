@@ -0,0 +1,54 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Compares the RAM contents of two crash dumps taken from the same firmware. */
+#ifndef _DUMP_DIFF_H_
+#define _DUMP_DIFF_H_
+
+#include <ElfSymbols.h>
+#include <IMemory.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <try_catch.h>
+
+
+/* Differing ranges separated by fewer than this many matching bytes are coalesced into a single range. */
+#define DUMP_DIFF_COALESCE_GAP 4
+
+typedef struct DumpDiffRange
+{
+    uint32_t address;
+    uint32_t size;
+} DumpDiffRange;
+
+typedef struct DumpDiff
+{
+    DumpDiffRange* pRanges;
+    size_t         rangeCount;
+    size_t         rangeCapacity;
+    uint64_t       bytesCompared;
+    uint64_t       bytesDiffering;
+} DumpDiff;
+
+
+/* Compares every region in pMemory1 against the same addresses in pMemory2 (both must be MemorySim instances).  Only
+   addresses mapped in both are compared.  Upon return, pRanges is sorted by address. */
+__throws void DumpDiff_Compare(DumpDiff* pThis, IMemory* pMemory1, IMemory* pMemory2);
+/* Loads pDumpFilename on top of the read-only FLASH regions already in pMemory (which must be a MemorySim instance)
+   and compares it against the dump already loaded into pMemory. */
+__throws void DumpDiff_CompareWithFile(DumpDiff* pThis, IMemory* pMemory, const char* pDumpFilename);
+         void DumpDiff_Uninit(DumpDiff* pThis);
+/* Each range is annotated with the symbol containing its first byte if pSymbols has one. */
+         void DumpDiff_PrintReport(const DumpDiff* pThis, const ElfSymbols* pSymbols);
+
+
+#endif /* _DUMP_DIFF_H_ */
@@ -0,0 +1,35 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Loads RAM contents and CPU registers from any of the supported crash dump formats. */
+#ifndef _DUMP_LOAD_H_
+#define _DUMP_LOAD_H_
+
+
+#include <stdio.h>
+#include <try_catch.h>
+#include <IMemory.h>
+#include <mriPlatform.h>
+
+
+/* Passing this as the dump filename reads the dump from stdin instead. */
+#define DUMP_LOAD_STDIN_FILENAME "-"
+
+
+/* Determines the type of dump (GDB log, CrashCatcher hex, CrashCatcher binary, compact dump or region manifest) from its
+   first few bytes.  The dump is read sequentially so pDumpFilename can also be a named pipe or DUMP_LOAD_STDIN_FILENAME. */
+__throws void DumpLoad_FromFile(IMemory* pMem, RegisterContext* pContext, const char* pDumpFilename);
+/* Same as above but reads the dump from pFile, which doesn't need to be seekable.  pFile is closed unless it is stdin. */
+__throws void DumpLoad_FromStream(IMemory* pMem, RegisterContext* pContext, FILE* pFile);
+
+
+#endif /* _DUMP_LOAD_H_ */
@@ -0,0 +1,51 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Sequential reader for dump files which also works on pipes and stdin where seeking isn't possible. */
+#ifndef _DUMP_STREAM_H_
+#define _DUMP_STREAM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <try_catch.h>
+
+
+/* The largest number of bytes which can be peeked at before the first read. */
+#define DUMP_STREAM_MAX_PEEK 8
+
+typedef struct DumpStream
+{
+    FILE*   pFile;
+    uint8_t peeked[DUMP_STREAM_MAX_PEEK];
+    size_t  peekedCount;
+    size_t  peekedIndex;
+} DumpStream;
+
+
+/* The stream takes ownership of pFile and closes it in DumpStream_Close() unless it is stdin. */
+         void   DumpStream_Init(DumpStream* pThis, FILE* pFile);
+         void   DumpStream_Close(DumpStream* pThis);
+/* Hands ownership of the underlying file over to the caller.  The stream can't be used afterwards. */
+         FILE*  DumpStream_Detach(DumpStream* pThis);
+
+/* Returns up to size bytes from the start of the stream without consuming them.  Must be called before any reads. */
+         size_t DumpStream_Peek(DumpStream* pThis, void* pBuffer, size_t size);
+/* Same semantics as fread() and fgets() but they first return any bytes previously peeked at. */
+         size_t DumpStream_Read(DumpStream* pThis, void* pBuffer, size_t size);
+         char*  DumpStream_Gets(DumpStream* pThis, char* pBuffer, int size);
+/* Offset of the next byte to be read from the stream or -1 if it isn't seekable. */
+         long   DumpStream_Tell(DumpStream* pThis);
+/* Total size of the underlying file or -1 if it isn't seekable (a pipe or terminal for example). */
+__throws long   DumpStream_GetSize(DumpStream* pThis);
+
+
+#endif /* _DUMP_STREAM_H_ */
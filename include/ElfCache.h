@@ -0,0 +1,38 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Content addressed cache of preprocessed FLASH images extracted from ELF files. */
+#ifndef _ELF_CACHE_H_
+#define _ELF_CACHE_H_
+
+#include <ElfSymbols.h>
+#include <IMemory.h>
+#include <MappedFile.h>
+#include <stddef.h>
+#include <try_catch.h>
+
+
+/* Loads the same read-only regions into pMemory as ElfLoad_FromMemory() would.  The cache entry for the ELF is found
+   in pCacheDirectory based on its GNU build-id (or a hash of the whole ELF if it has no build-id).  On a cache hit the
+   regions are backed directly by a mapping of the cache file, which is returned and must be kept open until pMemory
+   has been uninitialized.  On a cache miss, the ELF is parsed as usual, a new cache entry is written, and an empty
+   mapping is returned.  Failures to read or write the cache are never fatal.
+
+   If pSymbols isn't NULL, it is filled in with the same symbols as ElfSymbols_Init() would return.  On a cache hit they
+   come from the symbol index stored in the cache file so the ELF's symbol table is never parsed.  pSymbols->pSymbols
+   is left NULL if the ELF has no valid symbol table, leaving it to the caller to decide whether that is an error.
+*/
+__throws MappedFile ElfCache_Load(IMemory* pMemory, ElfSymbols* pSymbols, const char* pCacheDirectory,
+                                  const void* pElf, size_t elfSize);
+
+
+#endif /* _ELF_CACHE_H_ */
@@ -0,0 +1,27 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Exports simulated memory and registers as an ARM ELF core file which GDB can open directly with core-file. */
+#ifndef _ELF_CORE_H_
+#define _ELF_CORE_H_
+
+#include <IMemory.h>
+#include <mriPlatform.h>
+#include <try_catch.h>
+
+
+/* pMemory must be a MemorySim instance.  Each of its non-alias regions becomes a PT_LOAD segment and the registers
+   are stored in NT_PRSTATUS (and NT_ARM_VFP if the dump contained floating point registers) notes. */
+__throws void ElfCore_Write(IMemory* pMemory, const RegisterContext* pContext, const char* pCoreFilename);
+
+
+#endif /* _ELF_CORE_H_ */
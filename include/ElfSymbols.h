@@ -0,0 +1,46 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Symbol table extracted from an ELF image so that the address of globals can be found by name. */
+#ifndef _ELF_SYMBOLS_H_
+#define _ELF_SYMBOLS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <try_catch.h>
+
+
+typedef struct ElfSymbol
+{
+    const char* pName;
+    uint32_t    address;
+    uint32_t    size;
+} ElfSymbol;
+
+typedef struct ElfSymbols
+{
+    ElfSymbol* pSymbols;
+    char*      pStrings;
+    size_t     symbolCount;
+} ElfSymbols;
+
+
+/* Copies the defined symbols out of pElf's symbol table so that pElf doesn't need to be kept around afterwards. */
+__throws void             ElfSymbols_Init(ElfSymbols* pThis, const void* pElf, size_t elfSize);
+         void             ElfSymbols_Uninit(ElfSymbols* pThis);
+/* Returns NULL if there is no symbol named pName. */
+         const ElfSymbol* ElfSymbols_Find(const ElfSymbols* pThis, const char* pName);
+/* Returns the smallest sized symbol which contains address or NULL if there is none. */
+         const ElfSymbol* ElfSymbols_FindByAddress(const ElfSymbols* pThis, uint32_t address);
+
+
+#endif /* _ELF_SYMBOLS_H_ */
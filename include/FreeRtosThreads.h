@@ -0,0 +1,61 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Reconstructs the list of FreeRTOS tasks, and the register context of each, from the kernel's data structures. */
+#ifndef _FREERTOS_THREADS_H_
+#define _FREERTOS_THREADS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ElfSymbols.h>
+#include <IMemory.h>
+#include <mriPlatform.h>
+#include <try_catch.h>
+
+
+/* Same as FreeRTOS' default configMAX_TASK_NAME_LEN. */
+#define RTOS_THREAD_NAME_SIZE 16
+
+typedef struct RtosThread
+{
+    /* Address of the task's TCB, which is also used as its GDB thread id. */
+    uint32_t        id;
+    uint32_t        priority;
+    const char*     pState;
+    char            name[RTOS_THREAD_NAME_SIZE + 1];
+    /* pxStack, the lowest address of the task's stack. */
+    uint32_t        stackBase;
+    /* Address just past pxEndOfStack or 0 if the TCB doesn't record a plausible one. */
+    uint32_t        stackEnd;
+    RegisterContext context;
+} RtosThread;
+
+typedef struct RtosThreads
+{
+    RtosThread* pThreads;
+    size_t      threadCount;
+    /* Id of the task that was running when the dump was taken. */
+    uint32_t    haltedThreadId;
+} RtosThreads;
+
+
+/* Walks pxCurrentTCB, pxReadyTasksLists and the delayed, pending, suspended and terminating task lists found in
+   pSymbols.  The running task gets a copy of pHaltedContext and every other task gets the registers which the
+   Cortex-M port saved on its stack when it was switched out. */
+__throws void              FreeRtosThreads_Init(RtosThreads* pThis, IMemory* pMemory, const ElfSymbols* pSymbols,
+                                                const RegisterContext* pHaltedContext);
+         void              FreeRtosThreads_Uninit(RtosThreads* pThis);
+/* Returns NULL if there is no thread with this id. */
+         RtosThread*       FreeRtosThreads_Find(const RtosThreads* pThis, uint32_t id);
+
+
+#endif /* _FREERTOS_THREADS_H_ */
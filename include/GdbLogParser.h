@@ -15,11 +15,14 @@
 
 
 #include <try_catch.h>
+#include <DumpStream.h>
 #include <MemorySim.h>
 #include <mriPlatform.h>
 
 
 __throws void GdbLogParse(IMemory* pMem, RegisterContext* pContext, const char* pLogFilename);
+/* Parses the log in a single pass so pLogStream doesn't need to be seekable.  The caller still owns pLogStream. */
+__throws void GdbLogParse_FromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pLogStream);
 
 
 #endif /* _GDB_LOG_PARSER_H_ */
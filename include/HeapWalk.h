@@ -0,0 +1,49 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Walks the chunks of a newlib (dlmalloc based) heap found in a crash dump to validate them and report fragmentation. */
+#ifndef _HEAP_WALK_H_
+#define _HEAP_WALK_H_
+
+#include <ElfSymbols.h>
+#include <IMemory.h>
+#include <try_catch.h>
+
+
+typedef struct HeapWalkResult
+{
+    /* Address of the first chunk and the end of the top (wilderness) chunk. */
+    uint32_t heapStart;
+    uint32_t heapEnd;
+    uint32_t usedChunks;
+    uint32_t usedBytes;
+    /* Free chunk counts and sizes include the top chunk. */
+    uint32_t freeChunks;
+    uint32_t freeBytes;
+    uint32_t topSize;
+    uint32_t largestFreeBlock;
+    /* Set when the walk stopped early at an invalid chunk. */
+    int      isCorrupt;
+    uint32_t corruptChunk;
+    char     corruption[128];
+} HeapWalkResult;
+
+
+/* Walks the heap using the __malloc_av_ and __malloc_sbrk_base globals from the firmware's symbols. */
+__throws HeapWalkResult HeapWalk_FromSymbols(IMemory* pMemory, const ElfSymbols* pSymbols);
+/* Walks the heap starting at sbrkBase (the first address returned by sbrk) where mallocStateAddress is the address of
+   newlib's __malloc_av_ bin array. */
+__throws HeapWalkResult HeapWalk_Dlmalloc(IMemory* pMemory, uint32_t mallocStateAddress, uint32_t sbrkBase);
+         void           HeapWalk_PrintReport(const HeapWalkResult* pResult);
+
+
+#endif /* _HEAP_WALK_H_ */
@@ -13,12 +13,15 @@
 #ifndef _ICOMM_H_
 #define _ICOMM_H_
 
+#include <stdint.h>
+
 
 typedef struct IComm IComm;
 
 typedef struct ICommVTable
 {
     int  (*hasReceiveData)(IComm* pComm);
+    int  (*waitForReceiveData)(IComm* pComm, uint32_t timeoutMilliseconds);
     int  (*receiveChar)(IComm* pComm);
     void (*sendChar)(IComm* pComm, int character);
     int  (*shouldStopRun)(IComm* pThis);
@@ -36,6 +39,11 @@ static inline int IComm_HasReceiveData(IComm* pThis)
     return pThis->pVTable->hasReceiveData(pThis);
 }
 
+static inline int IComm_WaitForReceiveData(IComm* pThis, uint32_t timeoutMilliseconds)
+{
+    return pThis->pVTable->waitForReceiveData(pThis, timeoutMilliseconds);
+}
+
 static inline int IComm_ReceiveChar(IComm* pThis)
 {
     return pThis->pVTable->receiveChar(pThis);
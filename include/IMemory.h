@@ -28,6 +28,15 @@ typedef struct IMemoryVTable
     __throws void (* write32)(IMemory* pThis, uint32_t address, uint32_t value);
     __throws void (* write16)(IMemory* pThis, uint32_t address, uint16_t value);
     __throws void (* write8)(IMemory* pThis, uint32_t address, uint8_t value);
+
+    /* Variants of the above which return 0 instead of throwing when the access faults. */
+    int (* tryRead32)(IMemory* pThis, uint32_t address, uint32_t* pValue);
+    int (* tryRead16)(IMemory* pThis, uint32_t address, uint16_t* pValue);
+    int (* tryRead8)(IMemory* pThis, uint32_t address, uint8_t* pValue);
+
+    int (* tryWrite32)(IMemory* pThis, uint32_t address, uint32_t value);
+    int (* tryWrite16)(IMemory* pThis, uint32_t address, uint16_t value);
+    int (* tryWrite8)(IMemory* pThis, uint32_t address, uint8_t value);
 } IMemoryVTable;
 
 struct IMemory
@@ -66,5 +75,35 @@ static __throws __inline void IMemory_Write8(IMemory* pThis, uint32_t address, u
     pThis->pVTable->write8(pThis, address, value);
 }
 
+static __inline int IMemory_TryRead32(IMemory* pThis, uint32_t address, uint32_t* pValue)
+{
+    return pThis->pVTable->tryRead32(pThis, address, pValue);
+}
+
+static __inline int IMemory_TryRead16(IMemory* pThis, uint32_t address, uint16_t* pValue)
+{
+    return pThis->pVTable->tryRead16(pThis, address, pValue);
+}
+
+static __inline int IMemory_TryRead8(IMemory* pThis, uint32_t address, uint8_t* pValue)
+{
+    return pThis->pVTable->tryRead8(pThis, address, pValue);
+}
+
+static __inline int IMemory_TryWrite32(IMemory* pThis, uint32_t address, uint32_t value)
+{
+    return pThis->pVTable->tryWrite32(pThis, address, value);
+}
+
+static __inline int IMemory_TryWrite16(IMemory* pThis, uint32_t address, uint16_t value)
+{
+    return pThis->pVTable->tryWrite16(pThis, address, value);
+}
+
+static __inline int IMemory_TryWrite8(IMemory* pThis, uint32_t address, uint8_t value)
+{
+    return pThis->pVTable->tryWrite8(pThis, address, value);
+}
+
 
 #endif /* _IMEMORY_H_ */
@@ -0,0 +1,31 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Small LZ77 style codec (similar to the LZ4 block format) used to compress memory regions in dump files. */
+#ifndef _LZ_CODEC_H_
+#define _LZ_CODEC_H_
+
+#include <stddef.h>
+#include <try_catch.h>
+
+
+/* Worst case size of LzCodec_Compress() output for X bytes of incompressible input. */
+#define LZ_CODEC_MAX_COMPRESSED_SIZE(X) ((X) + (X) / 255 + 16)
+
+
+/* Returns the number of bytes written to pDest or 0 if the compressed data wouldn't fit in destSize bytes. */
+         size_t LzCodec_Compress(const void* pSrc, size_t srcSize, void* pDest, size_t destSize);
+/* Throws bufferOverrunException if pSrc is corrupt or doesn't decompress to exactly destSize bytes. */
+__throws void   LzCodec_Decompress(const void* pSrc, size_t srcSize, void* pDest, size_t destSize);
+
+
+#endif /* _LZ_CODEC_H_ */
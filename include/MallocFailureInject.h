@@ -18,6 +18,7 @@
 /* Pointer to malloc routine which can be intercepted by this module. */
 extern void* (*hook_malloc)(size_t size);
 extern void* (*hook_realloc)(void* ptr, size_t size);
+extern void* (*hook_calloc)(size_t count, size_t size);
 
 /* Provide a hook for free as well so that production code can skip leak detection. */
 extern void  (*hook_free)(void* ptr);
@@ -32,6 +33,9 @@ void        MallocFailureInject_Restore(void);
 #undef  realloc
 #define realloc hook_realloc
 
+#undef  calloc
+#define calloc hook_calloc
+
 #undef  free
 #define free hook_free
 
@@ -0,0 +1,40 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Maps the contents of a file into the address space of the host process. */
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <try_catch.h>
+
+
+typedef enum MappedFileAccess
+{
+    /* Pages can only be read. */
+    MAPPED_FILE_READ_ONLY,
+    /* Pages can be written but the writes are private to this process and never make it back to the file. */
+    MAPPED_FILE_COPY_ON_WRITE
+} MappedFileAccess;
+
+typedef struct MappedFile
+{
+    void*  pData;
+    size_t size;
+} MappedFile;
+
+
+__throws MappedFile MappedFile_Open(const char* pFilename, MappedFileAccess access);
+         void       MappedFile_Close(MappedFile* pThis);
+
+
+#endif /* _MAPPED_FILE_H_ */
@@ -14,7 +14,9 @@
 #define _MEMORY_SIM_H_
 
 
+#include <stddef.h>
 #include <IMemory.h>
+#include <MappedFile.h>
 
 
 /* MemorySim_CreateRegionsFromFlashImage() will place read-only FLASH image contents at this address. */
@@ -30,18 +32,87 @@ typedef enum WatchpointType
     WATCHPOINT_READ_WRITE = 3
 } WatchpointType;
 
+/* Description of a simulated memory region as returned by MemorySim_GetRegionInfo().  pData is NULL for aliases. */
+typedef struct MemoryRegionInfo
+{
+    const void* pData;
+    uint32_t    baseAddress;
+    uint32_t    size;
+    int         isReadOnly;
+    int         isAlias;
+} MemoryRegionInfo;
+
+/* Counters maintained by each MemorySim instance and returned by MemorySim_GetStats(). */
+typedef struct MemorySimStats
+{
+    /* Number of times that a region was searched for to handle a simulated address. */
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t misses;
+    /* Bytes accessed through IMemory or mapped to the host, plus the bytes filled in by lazy region loads. */
+    uint64_t bytesCopied;
+    uint64_t lazyRegionLoads;
+    /* Accesses to regions which had at least one breakpoint or watchpoint set that had to be checked. */
+    uint64_t watchpointChecks;
+} MemorySimStats;
 
+/* Loader used to fill in the contents of regions created with MemorySim_CreateLazyRegion() the first time that they
+   are accessed.  A single loader can back multiple regions.  MemorySim maintains refCount and calls release() once the
+   last region referencing the loader has been freed.  A loader that ends up with no regions must be released by its
+   creator. */
+typedef struct MemorySimLoader MemorySimLoader;
+struct MemorySimLoader
+{
+    __throws void (*load)(MemorySimLoader* pThis, uint32_t sourceOffset, void* pDest, uint32_t size);
+             void (*release)(MemorySimLoader* pThis);
+    uint32_t      refCount;
+};
+
+
+/* MemorySim_Init() returns a process wide instance while MemorySim_Create() heap allocates a new instance which is
+   independent of all others (ie. one per worker thread) and must be freed with MemorySim_Destroy().  Each instance
+   allocates its regions, their data and bookkeeping from its own arena which MemorySim_Uninit() frees all at once. */
 IMemory*                     MemorySim_Init(void);
 void                         MemorySim_Uninit(IMemory* pMemory);
+__throws IMemory*            MemorySim_Create(void);
+void                         MemorySim_Destroy(IMemory* pMemory);
 __throws void                MemorySim_CreateRegion(IMemory* pMemory, uint32_t baseAddress, uint32_t size);
+__throws void                MemorySim_CreateRegionFromHostBuffer(IMemory* pMemory, uint32_t baseAddress, void* pBuffer, uint32_t size);
+/* The region takes ownership of *pMapping (which is cleared) and closes it once the region is freed. */
+__throws void                MemorySim_CreateRegionFromMappedFile(IMemory* pMemory, uint32_t baseAddress, MappedFile* pMapping);
+__throws void                MemorySim_CreateLazyRegion(IMemory* pMemory, uint32_t baseAddress, uint32_t size, MemorySimLoader* pLoader, uint32_t sourceOffset);
 __throws void                MemorySim_CreateAlias(IMemory* pMemory, uint32_t aliasAddress, uint32_t redirectAddress, uint32_t size);
 void                         MemorySim_MakeRegionReadOnly(IMemory* pMemory, uint32_t baseAddress);
+/* Adds a read-only region to pDest for each read-only region (but not alias) in pSrc which references pSrc's copy of
+   the data rather than duplicating it.  pSrc must outlive pDest.  Lazy regions in pSrc are loaded first. */
+__throws void                MemorySim_ShareReadOnlyRegions(IMemory* pDest, IMemory* pSrc);
 __throws void                MemorySim_LoadFromFlashImage(IMemory* pMemory, uint32_t baseAddress, const void* pFlashImage, uint32_t flashImageSize);
 __throws void                MemorySim_CreateRegionsFromFlashImage(IMemory* pMemory, const void* pFlashImage, uint32_t flashImageSize);
 __throws const char*         MemorySim_GetMemoryMapXML(IMemory* pMemory);
 __throws void*               MemorySim_MapSimulatedAddressToHostAddressForWrite(IMemory* pMemory, uint32_t address, uint32_t size);
 __throws const void*         MemorySim_MapSimulatedAddressToHostAddressForRead(IMemory* pMemory, uint32_t address, uint32_t size);
+/* IMemory_Read16() and IMemory_TryRead16() are treated as instruction fetches which stop at breakpoints and add to the
+   FLASH read counts.  These are the equivalent data reads which do neither but still trigger read watchpoints. */
+__throws uint16_t            MemorySim_ReadData16(IMemory* pMemory, uint32_t address);
+         int                 MemorySim_TryReadData16(IMemory* pMemory, uint32_t address, uint16_t* pValue);
 __throws uint32_t            MemorySim_GetFlashReadCount(IMemory* pMemory, uint32_t address);
+         size_t              MemorySim_GetRegionCount(IMemory* pMemory);
+/* Returns TRUE if address falls within a read-only region, or an alias of one, and fills in *pBaseAddress and *pSize
+   with that region's bounds.  Unlike MemorySim_GetRegionInfo(), lazy regions aren't loaded. */
+         int                 MemorySim_FindReadOnlyRegion(IMemory* pMemory, uint32_t address,
+                                                          uint32_t* pBaseAddress, uint32_t* pSize);
+/* Returns TRUE and fills in *pNextAddress with the lowest mapped address at or above address.  Returns FALSE if
+   nothing is mapped at or above address. */
+         int                 MemorySim_FindNextMappedAddress(IMemory* pMemory, uint32_t address, uint32_t* pNextAddress);
+__throws MemoryRegionInfo    MemorySim_GetRegionInfo(IMemory* pMemory, size_t index);
+/* Returns the host memory backing the simulated memory at address (or NULL if unmapped) and fills in *pSpanSize with
+   the number of bytes which can be read from it before the end of its region.  Read counts aren't affected. */
+__throws const void*         MemorySim_MapSimulatedAddressToHostSpan(IMemory* pMemory, uint32_t address, uint32_t* pSpanSize);
+/* Searches the patternSize bytes of pPattern in the simulated memory from address up to address + length.  Returns
+   TRUE and fills in *pFoundAddress with the lowest matching address if found.  Unmapped gaps are skipped and matches
+   can span adjacent regions.  Read counts and watchpoints aren't affected. */
+__throws int                 MemorySim_Search(IMemory* pMemory, uint32_t address, uint32_t length,
+                                              const void* pPattern, uint32_t patternSize, uint32_t* pFoundAddress);
 
 __throws void MemorySim_SetHardwareBreakpoint(IMemory* pMemory, uint32_t address, uint32_t size);
 __throws void MemorySim_ClearHardwareBreakpoint(IMemory* pMemory, uint32_t address, uint32_t size);
@@ -50,5 +121,7 @@ __throws void MemorySim_SetHardwareWatchpoint(IMemory* pMemory, uint32_t address
 __throws void MemorySim_ClearHardwareWatchpoint(IMemory* pMemory, uint32_t address, uint32_t size, WatchpointType type);
          int  MemorySim_WasWatchpointEncountered(IMemory* pMemory);
 
+         MemorySimStats MemorySim_GetStats(IMemory* pMemory);
+
 
 #endif /* _MEMORY_SIM_H_ */
@@ -0,0 +1,49 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* IComm decorator which lets handlers answer GDB remote serial protocol (RSP) requests natively.  Packets which no
+   handler claims are passed through untouched to the MRI core on the other side of it.  It can also cache the
+   responses to memory and register reads so that repeated requests are answered without involving the MRI core. */
+#ifndef _PACKET_ICOMM_H_
+#define _PACKET_ICOMM_H_
+
+#include <stddef.h>
+#include <IComm.h>
+#include <try_catch.h>
+
+
+/* Requests longer than this are never offered to the handlers. */
+#define PACKET_ICOMM_MAX_REQUEST_SIZE  256
+#define PACKET_ICOMM_MAX_RESPONSE_SIZE 256
+#define PACKET_ICOMM_MAX_HANDLERS      4
+
+/* Response cache size used by CrashDebug itself. */
+#define PACKET_ICOMM_DEFAULT_CACHE_SIZE (4 * 1024 * 1024)
+
+/* pRequest points to the packet data between the '$' and '#' (still escaped if it contains binary data) and isn't
+   NUL terminated.  Handlers which claim the packet return TRUE after filling in pResponse with a NUL terminated
+   response of less than responseSize characters.  They return FALSE to let the MRI core handle the packet instead. */
+typedef int (*PacketHandler)(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                             char* pResponse, size_t responseSize);
+
+
+         IComm* PacketIComm_Init(IComm* pWrappedComm);
+         void   PacketIComm_Uninit(IComm* pComm);
+/* Handlers are offered each packet in the order that they were added. */
+__throws void   PacketIComm_AddHandler(IComm* pComm, PacketHandler handler, void* pHandlerObject);
+/* Responses to m, g, p and the qXfer memory-map/features requests are cached, still encoded, until up to
+   maxCacheSize bytes have been used.  Any write (M, X, G, P) or other request which can change the target, such as
+   resuming execution or switching threads, flushes the whole cache.  The cache is disabled by default. */
+         void   PacketIComm_EnableResponseCache(IComm* pComm, size_t maxCacheSize);
+
+
+#endif /* _PACKET_ICOMM_H_ */
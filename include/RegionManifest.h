@@ -0,0 +1,40 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Captures RAM with GDB "dump binary memory" commands and loads the resulting raw region files by mapping them. */
+#ifndef _REGION_MANIFEST_H_
+#define _REGION_MANIFEST_H_
+
+#include <DumpStream.h>
+#include <IMemory.h>
+#include <mriPlatform.h>
+#include <try_catch.h>
+
+
+/* Every manifest starts with this line.  DumpLoad uses it to recognize manifests passed to --dump. */
+#define REGION_MANIFEST_SIGNATURE "# CrashDebug region manifest"
+
+
+/* Reads the output of GDB's "info mem" command from pMemoryMapFilename and writes a GDB script to pScriptFilename which
+   saves each read-write region to a raw binary file with "dump binary memory" and the registers with
+   "info all-registers".  A manifest listing those files is written alongside the script, with the script's extension
+   replaced by .manifest.  The script refers to the files relative to the current directory. */
+__throws void RegionManifest_WriteCaptureScript(const char* pScriptFilename, const char* pMemoryMapFilename);
+
+/* Maps each raw region file listed in the manifest into pMem (copy-on-write so that GDB can still modify RAM) and
+   parses the registers from the GDB log it lists.  Relative filenames are relative to the manifest's directory, or
+   the current directory if pManifestFilename is NULL.  The caller still owns pStream. */
+__throws void RegionManifest_Load(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream,
+                                  const char* pManifestFilename);
+
+
+#endif /* _REGION_MANIFEST_H_ */
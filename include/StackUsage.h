@@ -0,0 +1,64 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Reports how much of each stack has been used by scanning up from its base for the pattern it was filled with. */
+#ifndef _STACK_USAGE_H_
+#define _STACK_USAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ElfSymbols.h>
+#include <FreeRtosThreads.h>
+#include <IMemory.h>
+#include <try_catch.h>
+
+
+/* FreeRTOS fills task stacks with tskSTACK_FILL_BYTE (0xA5) when they are created. */
+#define STACK_USAGE_DEFAULT_FILL 0xA5A5A5A5
+
+typedef struct StackUsageEntry
+{
+    char     name[RTOS_THREAD_NAME_SIZE + 1];
+    /* Lowest address of the stack and the address just past its highest word.  end is 0 when it isn't known, as
+       happens for FreeRTOS tasks built without configRECORD_STACK_HIGH_ADDRESS. */
+    uint32_t base;
+    uint32_t end;
+    /* Bytes up from base which still hold the fill pattern and the bytes from there up to end. */
+    uint32_t freeBytes;
+    uint32_t usedBytes;
+    /* Set when the scan ran into memory which isn't in the dump so freeBytes is only a lower bound. */
+    int      isIncomplete;
+} StackUsageEntry;
+
+typedef struct StackUsage
+{
+    StackUsageEntry* pStacks;
+    size_t           stackCount;
+    uint32_t         fillPattern;
+} StackUsage;
+
+
+/* Scans the main stack, found through the linker script's __StackLimit/__StackTop (or _estack/_Min_Stack_Size)
+   symbols, and the stack of each task in pThreads (which can be NULL).  pMemory must be a MemorySim instance.
+   Throws elfFormatException if there are no stacks to scan. */
+__throws void     StackUsage_Init(StackUsage* pThis, IMemory* pMemory, const ElfSymbols* pSymbols,
+                                  const RtosThreads* pThreads, uint32_t fillPattern);
+         void     StackUsage_Uninit(StackUsage* pThis);
+/* Returns the number of bytes from base up (but not past base + maxSize) which match fillPattern, where the pattern
+   is aligned so that its low byte lands on 4-byte aligned addresses.  Sets *pIsIncomplete if the scan stopped at
+   memory which isn't in pMemory.  Read counts and watchpoints aren't affected. */
+__throws uint32_t StackUsage_CountFillBytes(IMemory* pMemory, uint32_t base, uint32_t maxSize, uint32_t fillPattern,
+                                            int* pIsIncomplete);
+         void     StackUsage_PrintReport(const StackUsage* pThis);
+
+
+#endif /* _STACK_USAGE_H_ */
@@ -0,0 +1,48 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* IComm decorator which gathers statistics about the GDB remote serial protocol (RSP) traffic passing through it. */
+#ifndef _STATS_ICOMM_H_
+#define _STATS_ICOMM_H_
+
+#include <stdint.h>
+#include <IComm.h>
+
+
+/* Statistics for all packets of one type where the type is the first character of the packet (ie. 'm' for memory
+   reads).  Bytes received outside of a packet (like '+' acknowledgements) are counted against that character instead.
+   Sent bytes are counted against the type of the last received packet since they make up the response to it. */
+typedef struct RspPacketStats
+{
+    uint64_t packetCount;
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    /* Time from receiving the end of each packet to sending the end of its response packet. This covers the time
+       the MRI core spends handling the request, including hex encoding the response. */
+    uint64_t responseMicroseconds;
+} RspPacketStats;
+
+typedef struct RspStats
+{
+    RspPacketStats packets[128];
+    /* Time from startMicroseconds passed into StatsIComm_Init() until the first packet was received. */
+    uint64_t       firstPacketMicroseconds;
+    int            hasReceivedPacket;
+} RspStats;
+
+
+IComm*          StatsIComm_Init(IComm* pWrappedComm, uint64_t startMicroseconds);
+void            StatsIComm_Uninit(IComm* pComm);
+const RspStats* StatsIComm_GetStats(IComm* pComm);
+
+
+#endif /* _STATS_ICOMM_H_ */
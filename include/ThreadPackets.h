@@ -0,0 +1,42 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* PacketIComm handler which answers GDB's thread related remote serial protocol (RSP) requests from a list of RTOS
+   threads. */
+#ifndef _THREAD_PACKETS_H_
+#define _THREAD_PACKETS_H_
+
+#include <FreeRtosThreads.h>
+#include <mriPlatform.h>
+
+
+typedef struct ThreadPackets
+{
+    RtosThreads*     pThreads;
+    RegisterContext* pContext;
+    RtosThread*      pSelectedThread;
+    size_t           nextThreadInfoIndex;
+} ThreadPackets;
+
+
+/* Handles qfThreadInfo, qsThreadInfo, qC, qThreadExtraInfo, H and T packets.  Selecting a thread with Hg copies its
+   registers into pContext, the context used by the MRI core, so that later g and p packets read that thread's
+   registers.  pThreads must outlive pThis.  Uninit leaves pContext holding the halted thread's registers again. */
+void ThreadPackets_Init(ThreadPackets* pThis, RtosThreads* pThreads, RegisterContext* pContext);
+void ThreadPackets_Uninit(ThreadPackets* pThis);
+
+/* PacketHandler to be passed to PacketIComm_AddHandler() along with a ThreadPackets object. */
+int  ThreadPackets_Handle(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                          char* pResponse, size_t responseSize);
+
+
+#endif /* _THREAD_PACKETS_H_ */
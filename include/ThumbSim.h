@@ -0,0 +1,89 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Interpreter for the Thumb-2 instruction set of ARMv7-M (Cortex-M3/M4) processors which executes code directly against
+   the registers and simulated memory of a crash dump. */
+#ifndef _THUMB_SIM_H_
+#define _THUMB_SIM_H_
+
+#include <stdint.h>
+#include <Arena.h>
+#include <IMemory.h>
+#include <mriPlatform.h>
+
+
+/* Number of hash buckets used to find the pages of predecoded instructions. Must be a power of 2. */
+#define THUMB_SIM_PAGE_BUCKETS 256
+
+typedef enum ThumbSimStopReason
+{
+    /* The requested number of instructions were executed. */
+    THUMB_SIM_STOP_COUNT,
+    /* Fetch of the next instruction hit a hardware breakpoint set with MemorySim_SetHardwareBreakpoint(). */
+    THUMB_SIM_STOP_BREAKPOINT,
+    /* The last instruction executed accessed memory covered by a MemorySim watchpoint. */
+    THUMB_SIM_STOP_WATCHPOINT,
+    /* The next instruction is a BKPT instruction. */
+    THUMB_SIM_STOP_BKPT,
+    /* The next instruction accesses unmapped memory or writes to read-only memory. */
+    THUMB_SIM_STOP_BUS_FAULT,
+    /* The next instruction is undefined or unsupported (floating point, DSP extensions and SVC for example), makes an
+       unaligned multiple word access, or the processor has been switched out of Thumb state. */
+    THUMB_SIM_STOP_USAGE_FAULT
+} ThumbSimStopReason;
+
+typedef struct ThumbSimStats
+{
+    uint64_t instructions;
+    /* Instructions found already decoded in the cache and those which had to be decoded. */
+    uint64_t cacheHits;
+    uint64_t decodes;
+} ThumbSimStats;
+
+typedef struct ThumbSimPage ThumbSimPage;
+
+typedef struct ThumbSim
+{
+    IMemory*           pMemory;
+    RegisterContext*   pContext;
+    Arena              arena;
+    ThumbSimPage*      buckets[THUMB_SIM_PAGE_BUCKETS];
+    ThumbSimPage*      pLastPage;
+    ThumbSimStats      stats;
+    uint32_t           pc;
+    uint32_t           nextPC;
+    uint32_t           itState;
+    uint32_t           instructionsLeft;
+    ThumbSimStopReason stopReason;
+    /* Special registers which aren't part of a crash dump.  CONTROL.SPSEL is inferred from the stack pointers in the
+       register context and the rest start out as 0. */
+    uint32_t           primask;
+    uint32_t           basepri;
+    uint32_t           faultmask;
+    uint32_t           control;
+    int                isExclusive;
+} ThumbSim;
+
+
+/* pMemory must be a MemorySim instance.  Instructions in its read-only regions are decoded once and cached for the
+   lifetime of pThis.  Instructions elsewhere are decoded each time that they are executed. */
+void               ThumbSim_Init(ThumbSim* pThis, IMemory* pMemory, RegisterContext* pContext);
+void               ThumbSim_Uninit(ThumbSim* pThis);
+/* Executes up to maxInstructions instructions starting at the PC in the register context.  Execution stops early, with
+   PC left pointing at the offending instruction, for anything that would cause a debug event or fault on real
+   hardware.  The first halfword of every instruction is fetched through IMemory so hardware breakpoints and the FLASH
+   read counts see each one as it is executed. */
+ThumbSimStopReason ThumbSim_Run(ThumbSim* pThis, uint32_t maxInstructions);
+ThumbSimStats      ThumbSim_GetStats(ThumbSim* pThis);
+
+
+#endif /* _THUMB_SIM_H_ */
@@ -0,0 +1,61 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* IComm decorator which traces the latency of each GDB remote serial protocol (RSP) request passing through it. */
+#ifndef _TRACE_ICOMM_H_
+#define _TRACE_ICOMM_H_
+
+#include <stdint.h>
+#include <IComm.h>
+#include <try_catch.h>
+
+
+/* Trace files start with these 4 bytes and a 32-bit version, followed by a TraceRecord for each request. */
+#define TRACE_FILE_SIGNATURE      "CDTR"
+#define TRACE_FILE_SIGNATURE_SIZE 4
+#define TRACE_FILE_VERSION        1
+
+typedef struct TraceRecord
+{
+    /* Time that the first byte of the request was received, relative to the call to TraceIComm_Init(). */
+    uint64_t requestMicroseconds;
+    /* Time from receiving the first byte of the request to sending the last byte of its response packet. */
+    uint32_t latencyMicroseconds;
+    /* First character of the request packet (ie. 'm' for memory reads). */
+    uint8_t  packetType;
+    uint8_t  reserved[3];
+} TraceRecord;
+
+/* Bucket 0 counts latencies of 0us and bucket N counts latencies in the range [2^(N-1), 2^N)us. */
+#define TRACE_HISTOGRAM_BUCKETS 32
+
+typedef struct TraceHistogram
+{
+    uint32_t count;
+    uint32_t maxMicroseconds;
+    uint32_t buckets[TRACE_HISTOGRAM_BUCKETS];
+} TraceHistogram;
+
+
+__throws IComm*                TraceIComm_Init(IComm* pWrappedComm, const char* pTraceFilename);
+         void                  TraceIComm_Uninit(IComm* pComm);
+         const TraceHistogram* TraceIComm_GetHistogram(IComm* pComm, int packetType);
+         int                   TraceIComm_HasWriteFailed(IComm* pComm);
+/* Prints the latency percentiles for each packet type seen to stderr. */
+         void                  TraceIComm_PrintSummary(IComm* pComm);
+
+/* Returns the upper bound of the histogram bucket containing the requested percentile (0 - 100), clamped to the
+   largest latency actually seen. */
+uint32_t TraceHistogram_GetPercentile(const TraceHistogram* pHistogram, unsigned int percentile);
+
+
+#endif /* _TRACE_ICOMM_H_ */
@@ -0,0 +1,32 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Spreads the processing of a list of items across a pool of host threads. */
+#ifndef _WORK_QUEUE_H_
+#define _WORK_QUEUE_H_
+
+#include <stddef.h>
+
+
+/* Called once for each item index.  It must not throw since other threads may still be working on the queue. */
+typedef void (*WorkQueueItemHandler)(void* pContext, size_t index);
+
+
+/* Calls handler for each index from 0 to itemCount - 1 on up to jobCount threads (including the calling thread) and
+   returns once all of the items have been processed.  The calling thread picks up the slack if any of the other
+   threads fail to start. */
+void         WorkQueue_Run(size_t itemCount, unsigned int jobCount, WorkQueueItemHandler handler, void* pContext);
+/* Returns the number of processors available to this process, or 1 if it can't be determined. */
+unsigned int WorkQueue_GetProcessorCount(void);
+
+
+#endif /* _WORK_QUEUE_H_ */
@@ -24,6 +24,8 @@
 #define ARRAY_SIZE(X) (sizeof(X)/sizeof(X[0]))
 
 __throws long GetFileSize(FILE* pFile);
+/* Returns the 0 - 15 value of an upper or lowercase hex digit or -1 if hexDigit isn't a hex digit. */
+         int  HexDigitToNibble(char hexDigit);
 
 
 #endif /* _COMMON_H_ */
@@ -86,8 +86,24 @@ typedef struct RegisterContext
 /* Default value to be placed in MSP and PSP if crash dump (ie. version 2.0) doesn't contain specific values. */
 #define DEFAULT_SP_VALUE 0xBAADBAAD
 
+/* Exception number of the active handler and the contents of the fault status registers at the time of the crash.
+   The status registers are left as 0 if they weren't captured in the dump. */
+typedef struct FaultStatus
+{
+    uint32_t exceptionNumber;
+    uint32_t hardFaultStatus;
+    uint32_t configurableFaultStatus;
+} FaultStatus;
+
 
 __throws void mriPlatform_Init(RegisterContext* pContext, IMemory* pMem);
+         void mriPlatform_Uninit(void);
          void mriPlatform_Run(IComm* pComm);
+/* Only sets a flag so it is safe to call from a signal handler.  Makes mriPlatform_Run() return the next time that it
+   polls for data from GDB, even if it is in the middle of waiting for a packet. */
+         void mriPlatform_RequestStop(void);
+
+/* Doesn't depend on the state set by mriPlatform_Init() so it can be called for any dump from any thread. */
+FaultStatus mriPlatform_GetFaultStatus(IMemory* pMem, const RegisterContext* pContext);
 
 #endif /* _MRI_PLATFORM_H_ */
@@ -36,6 +36,7 @@
 #define elfFormatException                  (mriMaxException + 14)
 #define fileFormatException                 (mriMaxException + 15)
 #define stackOverflowException              (mriMaxException + 16)
+#define stopRequestedException              (mriMaxException + 17)
 
 
 #ifndef __debugbreak
@@ -50,9 +51,20 @@ typedef struct ExceptionHandler
 } ExceptionHandler;
 
 
-extern ExceptionHandler* g_pExceptionHandlers;
-extern char              g_exceptionMessage[1024];
-extern int               g_exceptionCode;
+/* Each thread has its own exception state so that worker threads can throw and catch independently.  The GNU
+   __thread extension is preferred, even when compiling C++, since it never requires C++ style TLS wrapper functions and
+   therefore links the same from C and C++ sources. */
+#if defined(__GNUC__)
+    #define TRY_CATCH_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+    #define TRY_CATCH_THREAD_LOCAL __declspec(thread)
+#else
+    #define TRY_CATCH_THREAD_LOCAL _Thread_local
+#endif
+
+extern TRY_CATCH_THREAD_LOCAL ExceptionHandler* g_pExceptionHandlers;
+extern TRY_CATCH_THREAD_LOCAL char              g_exceptionMessage[1024];
+extern TRY_CATCH_THREAD_LOCAL int               g_exceptionCode;
 
 
 /* On Linux, it is possible that __try and __catch are already defined. */
@@ -0,0 +1,45 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <Clock.h>
+#include <mockClock.h>
+
+
+static uint64_t g_microseconds = 0;
+static uint64_t g_increment = 0;
+
+
+void ClockMock_Uninit(void)
+{
+    g_microseconds = 0;
+    g_increment = 0;
+}
+
+
+void ClockMock_SetMicroseconds(uint64_t microseconds)
+{
+    g_microseconds = microseconds;
+}
+
+
+void ClockMock_SetIncrement(uint64_t increment)
+{
+    g_increment = increment;
+}
+
+
+uint64_t Clock_GetMicroseconds(void)
+{
+    uint64_t microseconds = g_microseconds;
+    g_microseconds += g_increment;
+    return microseconds;
+}
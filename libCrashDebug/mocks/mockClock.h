@@ -0,0 +1,28 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* Mock of the Clock module which lets tests control the time that it returns. */
+#ifndef _MOCK_CLOCK_H_
+#define _MOCK_CLOCK_H_
+
+#include <stdint.h>
+
+
+void ClockMock_Uninit(void);
+
+/* Sets the time returned by the next Clock_GetMicroseconds() call. */
+void ClockMock_SetMicroseconds(uint64_t microseconds);
+/* Every Clock_GetMicroseconds() call advances the time by this many microseconds after returning it. */
+void ClockMock_SetIncrement(uint64_t increment);
+
+
+#endif /* _MOCK_CLOCK_H_ */
@@ -16,6 +16,9 @@
 
 static int         g_hasStdInDataToReadException = noException;
 static int         g_hasStdInDataToReadReturn = 0;
+static int         g_waitForStdInDataException = noException;
+static int         g_waitForStdInDataReturn = 0;
+static uint32_t    g_waitForStdInDataLastTimeout = 0;
 static int         g_readStdInException = noException;
 static const char* g_pReadStdInCurr = NULL;
 static const char* g_pReadStdInEnd = NULL;
@@ -29,6 +32,9 @@ void ConsoleMock_Uninit(void)
 {
     g_hasStdInDataToReadException = noException;
     g_hasStdInDataToReadReturn = 0;
+    g_waitForStdInDataException = noException;
+    g_waitForStdInDataReturn = 0;
+    g_waitForStdInDataLastTimeout = 0;
     g_readStdInException = noException;
     g_pReadStdInCurr = g_pReadStdInEnd = NULL;
     g_writeStdOutException = noException;
@@ -49,6 +55,24 @@ void ConsoleMock_HasStdInDataToRead_SetReturn(int returnValue)
 }
 
 
+void ConsoleMock_WaitForStdInData_SetException(int exceptionToThrow)
+{
+    g_waitForStdInDataException = exceptionToThrow;
+}
+
+
+void ConsoleMock_WaitForStdInData_SetReturn(int returnValue)
+{
+    g_waitForStdInDataReturn = returnValue;
+}
+
+
+uint32_t ConsoleMock_WaitForStdInData_GetLastTimeout(void)
+{
+    return g_waitForStdInDataLastTimeout;
+}
+
+
 void ConsoleMock_ReadStdIn_SetException(int exceptionToThrow)
 {
     g_readStdInException = exceptionToThrow;
@@ -88,6 +112,14 @@ __throws int  Console_HasStdInDataToRead(void)
     return g_hasStdInDataToReadReturn;
 }
 
+__throws int Console_WaitForStdInData(uint32_t timeoutMilliseconds)
+{
+    g_waitForStdInDataLastTimeout = timeoutMilliseconds;
+    if (g_waitForStdInDataException)
+        __throw(g_waitForStdInDataException);
+    return g_waitForStdInDataReturn;
+}
+
 __throws int Console_ReadStdIn(void)
 {
     if (g_readStdInException)
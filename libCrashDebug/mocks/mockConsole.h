@@ -14,12 +14,18 @@
 #ifndef _MOCK_CONSOLE_H
 #define _MOCK_CONSOLE_H
 
+#include <stdint.h>
+
 
 void ConsoleMock_Uninit(void);
 
 void ConsoleMock_HasStdInDataToRead_SetException(int exceptionToThrow);
 void ConsoleMock_HasStdInDataToRead_SetReturn(int returnValue);
 
+void     ConsoleMock_WaitForStdInData_SetException(int exceptionToThrow);
+void     ConsoleMock_WaitForStdInData_SetReturn(int returnValue);
+uint32_t ConsoleMock_WaitForStdInData_GetLastTimeout(void);
+
 void ConsoleMock_ReadStdIn_SetException(int exceptionToThrow);
 void ConsoleMock_ReadStdIn_SetBuffer(const char* pBuffer, size_t bufferSize);
 
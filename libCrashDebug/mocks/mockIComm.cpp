@@ -77,7 +77,7 @@ static char*       g_pTransmitDataBufferCurr;
 static int         g_isGdbConnected = TRUE;
 
 
-static void waitForReceiveData(IComm* pComm);
+static void blockUntilReceiveData(IComm* pComm);
 static int isReceiveBufferEmpty();
 static void freeReceiveAllocations();
 static char* allocateAndCopyChecksummedData(const char* pData);
@@ -88,12 +88,13 @@ static void commUninitTransmitDataBuffer();
 
 /* Implementation of IComm interface for this mock. */
 static int  hasReceiveData(IComm* pComm);
+static int  waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds);
 static int  receiveChar(IComm* pComm);
 static void sendChar(IComm* pComm, int character);
 static int  shouldStopRun(IComm* pComm);
 static int  isGdbConnected(IComm* pComm);
 
-static ICommVTable g_icommVTable = {hasReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
+static ICommVTable g_icommVTable = {hasReceiveData, waitForReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
 
 static struct TestIComm
 {
@@ -124,6 +125,11 @@ static int hasReceiveData(IComm* pComm)
     return TRUE;
 }
 
+static int waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds)
+{
+    return hasReceiveData(pComm);
+}
+
 static int isReceiveBufferEmpty()
 {
     if (g_receiveIndex >= ARRAY_SIZE(g_receiveBuffers))
@@ -133,11 +139,11 @@ static int isReceiveBufferEmpty()
 
 static int receiveChar(IComm* pComm)
 {
-    waitForReceiveData(pComm);
+    blockUntilReceiveData(pComm);
     return g_receiveBuffers[g_receiveIndex].getNextChar();
 }
 
-static void waitForReceiveData(IComm* pComm)
+static void blockUntilReceiveData(IComm* pComm)
 {
     while (!IComm_HasReceiveData(pComm))
     {
@@ -152,6 +158,12 @@ static void sendChar(IComm* pComm, int character)
 
 static int shouldStopRun(IComm* pComm)
 {
+    /* Values larger than 1 count down the calls to be made before returning TRUE. */
+    if (g_shouldStopRun > 1)
+    {
+        g_shouldStopRun--;
+        return FALSE;
+    }
     return g_shouldStopRun;
 }
 
@@ -0,0 +1,547 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <CompactDump.h>
+#include <Crc32.h>
+#include <FileFailureInject.h>
+#include <LzCodec.h>
+#include <MallocFailureInject.h>
+#include <MappedFile.h>
+#include <MemorySim.h>
+
+
+/* Compact dump files start with this header, followed by the RegisterContext, regionCount CompactDumpRegion index
+   entries and then the (possibly compressed) contents of each region. */
+#define COMPACT_DUMP_VERSION 1
+
+/* Everything but the signature and region contents is stored as little-endian 32-bit words, so that the file layout
+   doesn't depend on the host's byte order or structure packing.  The header is the signature followed by its 3 fields,
+   the RegisterContext is flags, R[], exceptionPSR and FPR[] and each index entry is its 6 fields in order. */
+#define COMPACT_DUMP_HEADER_SIZE        (COMPACT_DUMP_SIGNATURE_SIZE + 3 * sizeof(uint32_t))
+#define COMPACT_DUMP_CONTEXT_WORD_COUNT (1 + TOTAL_REG_COUNT + 1 + TOTAL_FPREG_COUNT)
+#define COMPACT_DUMP_CONTEXT_SIZE       (COMPACT_DUMP_CONTEXT_WORD_COUNT * sizeof(uint32_t))
+#define COMPACT_DUMP_REGION_SIZE        (6 * sizeof(uint32_t))
+
+typedef struct CompactDumpHeader
+{
+    char     signature[COMPACT_DUMP_SIGNATURE_SIZE];
+    uint32_t version;
+    uint32_t regionCount;
+    /* CRC-32 of the RegisterContext and region index which follow the header. */
+    uint32_t indexCrc;
+} CompactDumpHeader;
+
+typedef enum CompactDumpEncoding
+{
+    COMPACT_DUMP_ENCODING_RAW = 0,
+    COMPACT_DUMP_ENCODING_LZ = 1
+} CompactDumpEncoding;
+
+typedef struct CompactDumpRegion
+{
+    uint32_t baseAddress;
+    uint32_t size;
+    uint32_t encoding;
+    uint32_t fileOffset;
+    uint32_t storedSize;
+    /* CRC-32 of the uncompressed region contents. */
+    uint32_t crc;
+} CompactDumpRegion;
+
+/* Keeps the compact dump file mapped so that its regions can be decoded on first access. */
+typedef struct MappedFileLoader
+{
+    MemorySimLoader loader;
+    MappedFile      mapping;
+    /* Dumps read from a pipe are copied into a heap allocation rather than mapped. */
+    int             isHeapCopy;
+} MappedFileLoader;
+
+typedef struct RegionToWrite
+{
+    CompactDumpRegion index;
+    uint8_t           storedIndex[COMPACT_DUMP_REGION_SIZE];
+    const uint8_t*    pData;
+    uint8_t*          pCompressed;
+} RegionToWrite;
+
+typedef struct Writer
+{
+    FILE*             pFile;
+    const char*       pFilename;
+    RegionToWrite*    pRegions;
+    CompactDumpHeader header;
+    uint8_t           context[COMPACT_DUMP_CONTEXT_SIZE];
+} Writer;
+
+
+static void readAndReleaseUnusedLoader(IMemory* pMem, RegisterContext* pContext, MappedFileLoader* pLoader);
+static MappedFileLoader* createMappedFileLoader(const char* pFilename);
+static MappedFileLoader* createHeapCopyLoader(DumpStream* pStream);
+static void readWholeStream(MappedFile* pCopy, DumpStream* pStream);
+static void* throwingZeroedMalloc(size_t size);
+static void readCompactDump(IMemory* pMem, RegisterContext* pContext, MappedFileLoader* pLoader);
+static void fetchHeader(CompactDumpHeader* pHeader, const MappedFile* pMapping);
+static void decodeHeader(CompactDumpHeader* pHeader, const uint8_t* pStored);
+static void validateIndexCrc(const MappedFile* pMapping, const CompactDumpHeader* pHeader);
+static void decodeIndexEntry(CompactDumpRegion* pRegion, const uint8_t* pStored);
+static void validateRegion(const MappedFile* pMapping, const CompactDumpRegion* pRegion);
+static void loadRegion(MemorySimLoader* pLoader, uint32_t sourceOffset, void* pDest, uint32_t size);
+static void decodeRegion(const CompactDumpRegion* pRegion, const uint8_t* pStored, uint8_t* pDest);
+static void decodeContext(RegisterContext* pContext, const uint8_t* pStored);
+static uint32_t decodeWord(const uint8_t* pStored);
+static void releaseMappedFileLoader(MemorySimLoader* pLoader);
+static void initWriter(Writer* pWriter, IMemory* pMem, const RegisterContext* pContext, const char* pFilename);
+static void encodeHeader(uint8_t* pStored, const CompactDumpHeader* pHeader);
+static void encodeContext(uint8_t* pStored, const RegisterContext* pContext);
+static void encodeIndexEntry(uint8_t* pStored, const CompactDumpRegion* pRegion);
+static uint8_t* encodeWord(uint8_t* pStored, uint32_t word);
+static int isRegionToWrite(const MemoryRegionInfo* pInfo);
+static void compressRegion(RegionToWrite* pRegion, uint32_t fileOffset);
+static void writeCompactDump(Writer* pWriter);
+static void writeBytes(Writer* pWriter, const void* pData, size_t size);
+static void uninitWriter(Writer* pWriter);
+
+
+__throws void CompactDump_Read(IMemory* pMem, RegisterContext* pContext, const char* pFilename)
+{
+    readAndReleaseUnusedLoader(pMem, pContext, createMappedFileLoader(pFilename));
+}
+
+__throws void CompactDump_ReadFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream)
+{
+    readAndReleaseUnusedLoader(pMem, pContext, createHeapCopyLoader(pStream));
+}
+
+static void readAndReleaseUnusedLoader(IMemory* pMem, RegisterContext* pContext, MappedFileLoader* pLoader)
+{
+    /* Only the index is read here.  Regions are decoded on first access and MemorySim releases the loader (and the
+       mapping of the file) along with the last of those regions. */
+    __try
+    {
+        readCompactDump(pMem, pContext, pLoader);
+    }
+    __catch
+    {
+        if (pLoader->loader.refCount == 0)
+            releaseMappedFileLoader(&pLoader->loader);
+        __rethrow;
+    }
+    if (pLoader->loader.refCount == 0)
+        releaseMappedFileLoader(&pLoader->loader);
+}
+
+static MappedFileLoader* createMappedFileLoader(const char* pFilename)
+{
+    MappedFileLoader* pLoader = throwingZeroedMalloc(sizeof(*pLoader));
+
+    __try
+    {
+        pLoader->mapping = MappedFile_Open(pFilename, MAPPED_FILE_READ_ONLY);
+    }
+    __catch
+    {
+        free(pLoader);
+        __rethrow;
+    }
+    pLoader->loader.load = loadRegion;
+    pLoader->loader.release = releaseMappedFileLoader;
+    return pLoader;
+}
+
+static MappedFileLoader* createHeapCopyLoader(DumpStream* pStream)
+{
+    MappedFileLoader* pLoader = throwingZeroedMalloc(sizeof(*pLoader));
+
+    pLoader->loader.load = loadRegion;
+    pLoader->loader.release = releaseMappedFileLoader;
+    pLoader->isHeapCopy = TRUE;
+    __try
+    {
+        readWholeStream(&pLoader->mapping, pStream);
+    }
+    __catch
+    {
+        releaseMappedFileLoader(&pLoader->loader);
+        __rethrow;
+    }
+    return pLoader;
+}
+
+static void readWholeStream(MappedFile* pCopy, DumpStream* pStream)
+{
+    size_t capacity = 0;
+    size_t bytesRead = 0;
+
+    do
+    {
+        if (pCopy->size == capacity)
+        {
+            size_t newCapacity = capacity ? 2 * capacity : 64 * 1024;
+            void*  pRealloc = realloc(pCopy->pData, newCapacity);
+            if (!pRealloc)
+                __throw(outOfMemoryException);
+            pCopy->pData = pRealloc;
+            capacity = newCapacity;
+        }
+        bytesRead = DumpStream_Read(pStream, (uint8_t*)pCopy->pData + pCopy->size, capacity - pCopy->size);
+        if (bytesRead > capacity - pCopy->size)
+            __throw_msg(fileException, "Failed to read the compact dump file.");
+        pCopy->size += bytesRead;
+    } while (bytesRead > 0);
+}
+
+static void* throwingZeroedMalloc(size_t size)
+{
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        __throw(outOfMemoryException);
+    memset(p, 0, size);
+    return p;
+}
+
+static void readCompactDump(IMemory* pMem, RegisterContext* pContext, MappedFileLoader* pLoader)
+{
+    const uint8_t*    pData = (const uint8_t*)pLoader->mapping.pData;
+    const uint8_t*    pIndex = pData + COMPACT_DUMP_HEADER_SIZE + COMPACT_DUMP_CONTEXT_SIZE;
+    CompactDumpHeader header;
+    uint32_t          i;
+
+    fetchHeader(&header, &pLoader->mapping);
+    validateIndexCrc(&pLoader->mapping, &header);
+    decodeContext(pContext, pData + COMPACT_DUMP_HEADER_SIZE);
+    for (i = 0 ; i < header.regionCount ; i++)
+    {
+        const uint8_t*    pEntry = pIndex + i * COMPACT_DUMP_REGION_SIZE;
+        CompactDumpRegion region;
+
+        decodeIndexEntry(&region, pEntry);
+        validateRegion(&pLoader->mapping, &region);
+        MemorySim_CreateLazyRegion(pMem, region.baseAddress, region.size, &pLoader->loader,
+                                   pEntry - pData);
+    }
+}
+
+static void fetchHeader(CompactDumpHeader* pHeader, const MappedFile* pMapping)
+{
+    size_t maxRegionCount;
+
+    if (pMapping->size < COMPACT_DUMP_HEADER_SIZE + COMPACT_DUMP_CONTEXT_SIZE)
+        __throw_msg(fileFormatException, "The dump file was too short to contain the compact dump header.");
+    decodeHeader(pHeader, pMapping->pData);
+    if (0 != memcmp(pHeader->signature, COMPACT_DUMP_SIGNATURE, sizeof(pHeader->signature)))
+        __throw_msg(fileFormatException, "The dump file didn't start with the expected compact dump signature.");
+    if (pHeader->version != COMPACT_DUMP_VERSION)
+        __throw_msg(fileFormatException, "The compact dump file has unsupported version %u.", pHeader->version);
+    maxRegionCount = (pMapping->size - COMPACT_DUMP_HEADER_SIZE - COMPACT_DUMP_CONTEXT_SIZE) / COMPACT_DUMP_REGION_SIZE;
+    if (pHeader->regionCount > maxRegionCount)
+        __throw_msg(fileFormatException, "The dump file was too short to contain the compact dump region index.");
+}
+
+static void decodeHeader(CompactDumpHeader* pHeader, const uint8_t* pStored)
+{
+    memcpy(pHeader->signature, pStored, sizeof(pHeader->signature));
+    pStored += sizeof(pHeader->signature);
+    pHeader->version = decodeWord(pStored);
+    pHeader->regionCount = decodeWord(pStored + 4);
+    pHeader->indexCrc = decodeWord(pStored + 8);
+}
+
+static void validateIndexCrc(const MappedFile* pMapping, const CompactDumpHeader* pHeader)
+{
+    const uint8_t* pIndex = (const uint8_t*)pMapping->pData + COMPACT_DUMP_HEADER_SIZE;
+    size_t         indexSize = COMPACT_DUMP_CONTEXT_SIZE + pHeader->regionCount * COMPACT_DUMP_REGION_SIZE;
+
+    if (Crc32_Calculate(pIndex, indexSize) != pHeader->indexCrc)
+        __throw_msg(fileFormatException, "The compact dump file's register context and region index failed CRC check.");
+}
+
+static void decodeIndexEntry(CompactDumpRegion* pRegion, const uint8_t* pStored)
+{
+    pRegion->baseAddress = decodeWord(pStored);
+    pRegion->size = decodeWord(pStored + 4);
+    pRegion->encoding = decodeWord(pStored + 8);
+    pRegion->fileOffset = decodeWord(pStored + 12);
+    pRegion->storedSize = decodeWord(pStored + 16);
+    pRegion->crc = decodeWord(pStored + 20);
+}
+
+static void validateRegion(const MappedFile* pMapping, const CompactDumpRegion* pRegion)
+{
+    if (pRegion->fileOffset > pMapping->size || pRegion->storedSize > pMapping->size - pRegion->fileOffset)
+    {
+        __throw_msg(fileFormatException, "The compact dump file contained a truncated memory region at 0x%08X.",
+                    pRegion->baseAddress);
+    }
+    if (pRegion->encoding != COMPACT_DUMP_ENCODING_RAW && pRegion->encoding != COMPACT_DUMP_ENCODING_LZ)
+    {
+        __throw_msg(fileFormatException, "The compact dump file contained an unknown encoding for memory region at 0x%08X.",
+                    pRegion->baseAddress);
+    }
+}
+
+static void loadRegion(MemorySimLoader* pLoader, uint32_t sourceOffset, void* pDest, uint32_t size)
+{
+    MappedFileLoader* pThis = (MappedFileLoader*)pLoader;
+    const uint8_t*    pData = (const uint8_t*)pThis->mapping.pData;
+    CompactDumpRegion region;
+
+    decodeIndexEntry(&region, pData + sourceOffset);
+    decodeRegion(&region, pData + region.fileOffset, pDest);
+    if (Crc32_Calculate(pDest, region.size) != region.crc)
+    {
+        __throw_msg(fileFormatException, "The compact dump file contained a corrupt memory region at 0x%08X.",
+                    region.baseAddress);
+    }
+}
+
+static void decodeRegion(const CompactDumpRegion* pRegion, const uint8_t* pStored, uint8_t* pDest)
+{
+    switch (pRegion->encoding)
+    {
+    case COMPACT_DUMP_ENCODING_RAW:
+        if (pRegion->storedSize != pRegion->size)
+            break;
+        memcpy(pDest, pStored, pRegion->size);
+        return;
+    case COMPACT_DUMP_ENCODING_LZ:
+        __try
+            LzCodec_Decompress(pStored, pRegion->storedSize, pDest, pRegion->size);
+        __catch
+            break;
+        return;
+    default:
+        __throw_msg(fileFormatException, "The compact dump file contained an unknown encoding for memory region at 0x%08X.",
+                    pRegion->baseAddress);
+    }
+    __throw_msg(fileFormatException, "The compact dump file contained a corrupt memory region at 0x%08X.",
+                pRegion->baseAddress);
+}
+
+static void decodeContext(RegisterContext* pContext, const uint8_t* pStored)
+{
+    size_t i;
+
+    pContext->flags = decodeWord(pStored);
+    pStored += sizeof(uint32_t);
+    for (i = 0 ; i < TOTAL_REG_COUNT ; i++, pStored += sizeof(uint32_t))
+        pContext->R[i] = decodeWord(pStored);
+    pContext->exceptionPSR = decodeWord(pStored);
+    pStored += sizeof(uint32_t);
+    for (i = 0 ; i < TOTAL_FPREG_COUNT ; i++, pStored += sizeof(uint32_t))
+        pContext->FPR[i] = decodeWord(pStored);
+}
+
+static uint32_t decodeWord(const uint8_t* pStored)
+{
+    return (uint32_t)pStored[0] | ((uint32_t)pStored[1] << 8) |
+           ((uint32_t)pStored[2] << 16) | ((uint32_t)pStored[3] << 24);
+}
+
+static void releaseMappedFileLoader(MemorySimLoader* pLoader)
+{
+    MappedFileLoader* pThis = (MappedFileLoader*)pLoader;
+
+    if (pThis->isHeapCopy)
+        free(pThis->mapping.pData);
+    else
+        MappedFile_Close(&pThis->mapping);
+    free(pThis);
+}
+
+
+__throws void CompactDump_Write(IMemory* pMem, const RegisterContext* pContext, const char* pFilename)
+{
+    Writer writer;
+
+    memset(&writer, 0, sizeof(writer));
+    __try
+    {
+        initWriter(&writer, pMem, pContext, pFilename);
+        writeCompactDump(&writer);
+    }
+    __catch
+    {
+        int wasFileCreated = writer.pFile != NULL;
+
+        uninitWriter(&writer);
+        if (wasFileCreated)
+            remove(pFilename);
+        __rethrow;
+    }
+    uninitWriter(&writer);
+}
+
+static void initWriter(Writer* pWriter, IMemory* pMem, const RegisterContext* pContext, const char* pFilename)
+{
+    size_t   regionCount = MemorySim_GetRegionCount(pMem);
+    uint32_t fileOffset;
+    uint32_t indexCrc;
+    size_t   i;
+
+    pWriter->pFilename = pFilename;
+    memcpy(pWriter->header.signature, COMPACT_DUMP_SIGNATURE, sizeof(pWriter->header.signature));
+    pWriter->header.version = COMPACT_DUMP_VERSION;
+    for (i = 0 ; i < regionCount ; i++)
+    {
+        MemoryRegionInfo info = MemorySim_GetRegionInfo(pMem, i);
+        if (isRegionToWrite(&info))
+            pWriter->header.regionCount++;
+    }
+    pWriter->pRegions = throwingZeroedMalloc(pWriter->header.regionCount * sizeof(*pWriter->pRegions));
+
+    encodeContext(pWriter->context, pContext);
+    fileOffset = COMPACT_DUMP_HEADER_SIZE + sizeof(pWriter->context) +
+                 pWriter->header.regionCount * COMPACT_DUMP_REGION_SIZE;
+    indexCrc = Crc32_Calculate(pWriter->context, sizeof(pWriter->context));
+    pWriter->header.regionCount = 0;
+    for (i = 0 ; i < regionCount ; i++)
+    {
+        MemoryRegionInfo info = MemorySim_GetRegionInfo(pMem, i);
+        RegionToWrite*   pRegion = &pWriter->pRegions[pWriter->header.regionCount];
+
+        if (!isRegionToWrite(&info))
+            continue;
+        pRegion->index.baseAddress = info.baseAddress;
+        pRegion->index.size = info.size;
+        pRegion->pData = info.pData;
+        compressRegion(pRegion, fileOffset);
+        fileOffset += pRegion->index.storedSize;
+        encodeIndexEntry(pRegion->storedIndex, &pRegion->index);
+        indexCrc = Crc32_Update(indexCrc, pRegion->storedIndex, sizeof(pRegion->storedIndex));
+        pWriter->header.regionCount++;
+    }
+    pWriter->header.indexCrc = indexCrc;
+}
+
+static void encodeHeader(uint8_t* pStored, const CompactDumpHeader* pHeader)
+{
+    memcpy(pStored, pHeader->signature, sizeof(pHeader->signature));
+    pStored += sizeof(pHeader->signature);
+    pStored = encodeWord(pStored, pHeader->version);
+    pStored = encodeWord(pStored, pHeader->regionCount);
+    encodeWord(pStored, pHeader->indexCrc);
+}
+
+static void encodeContext(uint8_t* pStored, const RegisterContext* pContext)
+{
+    size_t i;
+
+    pStored = encodeWord(pStored, pContext->flags);
+    for (i = 0 ; i < TOTAL_REG_COUNT ; i++)
+        pStored = encodeWord(pStored, pContext->R[i]);
+    pStored = encodeWord(pStored, pContext->exceptionPSR);
+    for (i = 0 ; i < TOTAL_FPREG_COUNT ; i++)
+        pStored = encodeWord(pStored, pContext->FPR[i]);
+}
+
+static void encodeIndexEntry(uint8_t* pStored, const CompactDumpRegion* pRegion)
+{
+    pStored = encodeWord(pStored, pRegion->baseAddress);
+    pStored = encodeWord(pStored, pRegion->size);
+    pStored = encodeWord(pStored, pRegion->encoding);
+    pStored = encodeWord(pStored, pRegion->fileOffset);
+    pStored = encodeWord(pStored, pRegion->storedSize);
+    encodeWord(pStored, pRegion->crc);
+}
+
+static uint8_t* encodeWord(uint8_t* pStored, uint32_t word)
+{
+    pStored[0] = word & 0xFF;
+    pStored[1] = (word >> 8) & 0xFF;
+    pStored[2] = (word >> 16) & 0xFF;
+    pStored[3] = word >> 24;
+    return pStored + sizeof(uint32_t);
+}
+
+static int isRegionToWrite(const MemoryRegionInfo* pInfo)
+{
+    return !pInfo->isReadOnly && !pInfo->isAlias;
+}
+
+static void compressRegion(RegionToWrite* pRegion, uint32_t fileOffset)
+{
+    uint32_t size = pRegion->index.size;
+    size_t   compressedSize = 0;
+
+    pRegion->index.crc = Crc32_Calculate(pRegion->pData, size);
+    pRegion->index.fileOffset = fileOffset;
+    pRegion->index.encoding = COMPACT_DUMP_ENCODING_RAW;
+    pRegion->index.storedSize = size;
+
+    /* Regions are only stored compressed if that actually makes them smaller. */
+    pRegion->pCompressed = malloc(size);
+    if (pRegion->pCompressed && size > 0)
+        compressedSize = LzCodec_Compress(pRegion->pData, size, pRegion->pCompressed, size - 1);
+    if (compressedSize == 0)
+    {
+        free(pRegion->pCompressed);
+        pRegion->pCompressed = NULL;
+        return;
+    }
+    pRegion->index.encoding = COMPACT_DUMP_ENCODING_LZ;
+    pRegion->index.storedSize = compressedSize;
+}
+
+static void writeCompactDump(Writer* pWriter)
+{
+    uint8_t  storedHeader[COMPACT_DUMP_HEADER_SIZE];
+    uint32_t i;
+
+    pWriter->pFile = fopen(pWriter->pFilename, "wb");
+    if (!pWriter->pFile)
+        __throw_msg(fileException, "Failed to create \"%s\" compact dump file.", pWriter->pFilename);
+
+    encodeHeader(storedHeader, &pWriter->header);
+    writeBytes(pWriter, storedHeader, sizeof(storedHeader));
+    writeBytes(pWriter, pWriter->context, sizeof(pWriter->context));
+    for (i = 0 ; i < pWriter->header.regionCount ; i++)
+        writeBytes(pWriter, pWriter->pRegions[i].storedIndex, sizeof(pWriter->pRegions[i].storedIndex));
+    for (i = 0 ; i < pWriter->header.regionCount ; i++)
+    {
+        RegionToWrite* pRegion = &pWriter->pRegions[i];
+        writeBytes(pWriter, pRegion->pCompressed ? pRegion->pCompressed : pRegion->pData, pRegion->index.storedSize);
+    }
+
+    if (fclose(pWriter->pFile) != 0)
+    {
+        pWriter->pFile = NULL;
+        remove(pWriter->pFilename);
+        __throw_msg(fileException, "Failed to write \"%s\" compact dump file.", pWriter->pFilename);
+    }
+    pWriter->pFile = NULL;
+}
+
+static void writeBytes(Writer* pWriter, const void* pData, size_t size)
+{
+    if (fwrite(pData, 1, size, pWriter->pFile) != size)
+        __throw_msg(fileException, "Failed to write \"%s\" compact dump file.", pWriter->pFilename);
+}
+
+static void uninitWriter(Writer* pWriter)
+{
+    uint32_t i;
+
+    if (pWriter->pFile)
+    {
+        fclose(pWriter->pFile);
+        pWriter->pFile = NULL;
+    }
+    for (i = 0 ; pWriter->pRegions && i < pWriter->header.regionCount ; i++)
+        free(pWriter->pRegions[i].pCompressed);
+    free(pWriter->pRegions);
+    pWriter->pRegions = NULL;
+}
@@ -0,0 +1,339 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <CrashCapture.h>
+#include <CrashCatcherDump.h>
+#include <FileFailureInject.h>
+#include <MallocFailureInject.h>
+
+
+/* CRASH_CATCHER_SIGNATURE_BYTE0 and CRASH_CATCHER_SIGNATURE_BYTE1 as hex digits. */
+#define HEX_SIGNATURE "6343"
+
+typedef enum CaptureState
+{
+    WAITING_FOR_BANNER,
+    WAITING_FOR_SIGNATURE,
+    CAPTURING_DUMP,
+    DUMP_COMPLETE
+} CaptureState;
+
+
+static FILE* openFileAndThrowOnError(const char* pCaptureFilename);
+static void configureSerialPort(FILE* pFile, const char* pCaptureFilename, uint32_t baudRate);
+static void captureDump(CrashCapture* pCapture, DumpStream* pStream);
+static const char* trimWhitespace(const char* pLine, size_t* pLineLength);
+static int isHexLine(const char* pLine, size_t lineLength);
+static void restartCapture(CrashCapture* pThis);
+static void appendHexLine(CrashCapture* pThis, const char* pLine, size_t lineLength);
+static void appendByte(CrashCapture* pThis, uint8_t byte);
+
+
+__throws void CrashCapture_FromFile(IMemory* pMem, RegisterContext* pContext, const char* pCaptureFilename,
+                                    uint32_t baudRate)
+{
+    DumpStream stream;
+
+    DumpStream_Init(&stream, openFileAndThrowOnError(pCaptureFilename));
+    __try
+    {
+        configureSerialPort(stream.pFile, pCaptureFilename, baudRate);
+        CrashCapture_FromStream(pMem, pContext, &stream);
+    }
+    __catch
+    {
+        DumpStream_Close(&stream);
+        __rethrow;
+    }
+    DumpStream_Close(&stream);
+}
+
+static FILE* openFileAndThrowOnError(const char* pCaptureFilename)
+{
+    FILE* pFile = fopen(pCaptureFilename, "rb");
+    if (!pFile)
+        __throw_msg(fileException, "Failed to open \"%s\" for crash dump capture.", pCaptureFilename);
+    return pFile;
+}
+
+#ifdef WIN32
+#include <io.h>
+#include <windows.h>
+
+static void configureSerialPort(FILE* pFile, const char* pCaptureFilename, uint32_t baudRate)
+{
+    HANDLE hPort = (HANDLE)_get_osfhandle(_fileno(pFile));
+    DCB    settings;
+
+    /* Only COM ports have a DCB so plain files and pipes are left alone. */
+    memset(&settings, 0, sizeof(settings));
+    settings.DCBlength = sizeof(settings);
+    if (GetFileType(hPort) != FILE_TYPE_CHAR || !GetCommState(hPort, &settings))
+        return;
+    settings.BaudRate = baudRate;
+    settings.ByteSize = 8;
+    settings.Parity = NOPARITY;
+    settings.StopBits = ONESTOPBIT;
+    settings.fBinary = TRUE;
+    settings.fOutxCtsFlow = FALSE;
+    settings.fOutxDsrFlow = FALSE;
+    settings.fOutX = FALSE;
+    settings.fInX = FALSE;
+    if (!SetCommState(hPort, &settings))
+        __throw_msg(fileException, "Failed to set \"%s\" to %u baud.", pCaptureFilename, baudRate);
+}
+
+#else
+#include <termios.h>
+#include <unistd.h>
+
+static speed_t lookupBaudRate(uint32_t baudRate);
+
+static void configureSerialPort(FILE* pFile, const char* pCaptureFilename, uint32_t baudRate)
+{
+    int            fd = fileno(pFile);
+    struct termios settings;
+    speed_t        speed;
+
+    /* Plain files and pipes are left alone.  A tty defaults to canonical mode with echo and CR/LF translation, none of
+       which should be applied to the raw serial output from the device. */
+    if (!isatty(fd))
+        return;
+    speed = lookupBaudRate(baudRate);
+    if (tcgetattr(fd, &settings) != 0)
+        __throw_msg(fileException, "Failed to read the serial port settings of \"%s\".", pCaptureFilename);
+    cfmakeraw(&settings);
+    settings.c_cflag |= CLOCAL | CREAD;
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+    /* TCSANOW rather than TCSAFLUSH so that anything already received isn't discarded. */
+    if (tcsetattr(fd, TCSANOW, &settings) != 0)
+        __throw_msg(fileException, "Failed to set \"%s\" to %u baud.", pCaptureFilename, baudRate);
+}
+
+static speed_t lookupBaudRate(uint32_t baudRate)
+{
+    static const struct
+    {
+        uint32_t baudRate;
+        speed_t  speed;
+    } baudRates[] =
+    {
+        { 9600, B9600 },
+        { 19200, B19200 },
+        { 38400, B38400 },
+        { 57600, B57600 },
+        { 115200, B115200 },
+        { 230400, B230400 },
+#ifdef B460800
+        { 460800, B460800 },
+#endif
+#ifdef B921600
+        { 921600, B921600 },
+#endif
+    };
+    size_t i;
+
+    for (i = 0 ; i < ARRAY_SIZE(baudRates) ; i++)
+    {
+        if (baudRates[i].baudRate == baudRate)
+            return baudRates[i].speed;
+    }
+    __throw_msg(invalidArgumentException, "%u isn't a supported baud rate.", baudRate);
+    return B0;
+}
+#endif /* WIN32 */
+
+__throws void CrashCapture_FromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream)
+{
+    CrashCapture capture;
+
+    CrashCapture_Init(&capture);
+    capture.isBannerRequired = TRUE;
+    restartCapture(&capture);
+    __try
+    {
+        captureDump(&capture, pStream);
+        CrashCatcherDump_ReadBinaryFromMemory(pMem, pContext, capture.pDump, capture.dumpSize);
+    }
+    __catch
+    {
+        CrashCapture_Uninit(&capture);
+        __rethrow;
+    }
+    CrashCapture_Uninit(&capture);
+}
+
+static void captureDump(CrashCapture* pCapture, DumpStream* pStream)
+{
+    char lineText[1024];
+
+    /* Each line is decoded as soon as it arrives so the dump is ready to load as soon as its end is seen. */
+    do
+    {
+        if (NULL == DumpStream_Gets(pStream, lineText, sizeof(lineText)))
+            __throw_msg(fileFormatException, "The capture stream ended before a complete crash dump was received.");
+    } while (!CrashCapture_HandleLine(pCapture, lineText, strlen(lineText)));
+}
+
+
+void CrashCapture_Init(CrashCapture* pThis)
+{
+    memset(pThis, 0, sizeof(*pThis));
+    restartCapture(pThis);
+}
+
+void CrashCapture_Uninit(CrashCapture* pThis)
+{
+    free(pThis->pDump);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+__throws int CrashCapture_HandleLine(CrashCapture* pThis, const char* pLine, size_t lineLength)
+{
+    CrashCaptureLineType lineType = CrashCapture_ClassifyLine(pLine, lineLength);
+
+    pLine = trimWhitespace(pLine, &lineLength);
+    if (pThis->state == WAITING_FOR_BANNER)
+    {
+        if (lineType == CRASH_CAPTURE_LINE_BANNER)
+            pThis->state = WAITING_FOR_SIGNATURE;
+        return FALSE;
+    }
+    if (pThis->state == WAITING_FOR_SIGNATURE)
+    {
+        if (lineType == CRASH_CAPTURE_LINE_SIGNATURE)
+        {
+            pThis->state = CAPTURING_DUMP;
+            appendHexLine(pThis, pLine, lineLength);
+        }
+        return FALSE;
+    }
+
+    switch (lineType)
+    {
+    case CRASH_CAPTURE_LINE_BLANK:
+        break;
+    case CRASH_CAPTURE_LINE_SIGNATURE:
+    case CRASH_CAPTURE_LINE_HEX:
+        appendHexLine(pThis, pLine, lineLength);
+        break;
+    case CRASH_CAPTURE_LINE_END:
+        pThis->state = DUMP_COMPLETE;
+        return TRUE;
+    case CRASH_CAPTURE_LINE_BANNER:
+        /* The device crashed again part way through the dump so wait for the signature of the new one. */
+        restartCapture(pThis);
+        pThis->state = WAITING_FOR_SIGNATURE;
+        break;
+    case CRASH_CAPTURE_LINE_OTHER:
+    default:
+        /* The device was reset or the line was corrupted part way through the dump. */
+        restartCapture(pThis);
+        break;
+    }
+    return FALSE;
+}
+
+CrashCaptureLineType CrashCapture_ClassifyLine(const char* pLine, size_t lineLength)
+{
+    pLine = trimWhitespace(pLine, &lineLength);
+    if (lineLength == 0)
+        return CRASH_CAPTURE_LINE_BLANK;
+    if (isHexLine(pLine, lineLength))
+    {
+        if (lineLength >= sizeof(HEX_SIGNATURE) - 1 && 0 == memcmp(pLine, HEX_SIGNATURE, sizeof(HEX_SIGNATURE) - 1))
+            return CRASH_CAPTURE_LINE_SIGNATURE;
+        return CRASH_CAPTURE_LINE_HEX;
+    }
+    if (lineLength == sizeof(CRASH_CAPTURE_END_TEXT) - 1 && 0 == memcmp(pLine, CRASH_CAPTURE_END_TEXT, lineLength))
+        return CRASH_CAPTURE_LINE_END;
+    if (lineLength == sizeof(CRASH_CAPTURE_BANNER_TEXT) - 1 &&
+        0 == memcmp(pLine, CRASH_CAPTURE_BANNER_TEXT, lineLength))
+    {
+        return CRASH_CAPTURE_LINE_BANNER;
+    }
+    return CRASH_CAPTURE_LINE_OTHER;
+}
+
+static const char* trimWhitespace(const char* pLine, size_t* pLineLength)
+{
+    size_t lineLength = *pLineLength;
+
+    while (lineLength > 0 && isspace((unsigned char)*pLine))
+    {
+        pLine++;
+        lineLength--;
+    }
+    while (lineLength > 0 && isspace((unsigned char)pLine[lineLength - 1]))
+        lineLength--;
+    *pLineLength = lineLength;
+    return pLine;
+}
+
+static int isHexLine(const char* pLine, size_t lineLength)
+{
+    size_t i;
+
+    for (i = 0 ; i < lineLength ; i++)
+    {
+        if (!isxdigit((unsigned char)pLine[i]))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void restartCapture(CrashCapture* pThis)
+{
+    pThis->state = pThis->isBannerRequired ? WAITING_FOR_BANNER : WAITING_FOR_SIGNATURE;
+    pThis->dumpSize = 0;
+    pThis->pendingNibble = -1;
+}
+
+static void appendHexLine(CrashCapture* pThis, const char* pLine, size_t lineLength)
+{
+    size_t i;
+
+    for (i = 0 ; i < lineLength ; i++)
+    {
+        uint8_t nibble = (uint8_t)HexDigitToNibble(pLine[i]);
+
+        if (pThis->pendingNibble < 0)
+        {
+            pThis->pendingNibble = nibble;
+        }
+        else
+        {
+            appendByte(pThis, (pThis->pendingNibble << 4) | nibble);
+            pThis->pendingNibble = -1;
+        }
+    }
+}
+
+static void appendByte(CrashCapture* pThis, uint8_t byte)
+{
+    if (pThis->dumpSize == pThis->dumpCapacity)
+    {
+        size_t   newCapacity = pThis->dumpCapacity ? 2 * pThis->dumpCapacity : 4096;
+        uint8_t* pRealloc = realloc(pThis->pDump, newCapacity);
+        if (!pRealloc)
+            __throw(outOfMemoryException);
+        pThis->pDump = pRealloc;
+        pThis->dumpCapacity = newCapacity;
+    }
+    pThis->pDump[pThis->dumpSize++] = byte;
+}
@@ -16,7 +16,9 @@
 #include <FileFailureInject.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <MallocFailureInject.h>
 
 
 typedef union
@@ -25,23 +27,42 @@ typedef union
     uint32_t                     sentinel;
 } RegionOrSentinel;
 
+/* Binary dumps keep the dump file open so that their memory regions can be loaded from it on first access. */
+typedef struct FileLoader
+{
+    MemorySimLoader loader;
+    FILE*           pFile;
+} FileLoader;
+
 typedef struct Object
 {
     int              (*read)(struct Object* pObject, void* pBuffer, size_t bytesToRead);
     IMemory*         pMem;
     RegisterContext* pContext;
-    FILE*            pFile;
+    DumpStream*      pStream;
+    FileLoader*      pLoader;
+    /* Dump being read by CrashCatcherDump_ReadBinaryFromMemory(). */
+    const uint8_t*   pDump;
+    size_t           dumpSize;
+    size_t           dumpOffset;
+    /* Size of the dump file for binary dumps whose regions can be loaded lazily, -1 otherwise (pipes for example). */
+    long             fileSize;
     int              isVersion2Dump;
 } Object;
 
 
+static void readFromFile(IMemory* pMem,
+                         RegisterContext* pContext,
+                         const char* pCrashDumpFilename,
+                         void (*readFromStream)(IMemory*, RegisterContext*, DumpStream*));
+static FILE* openFileAndThrowOnError(const char* pLogFilename);
 static int binaryRead(Object* pObject, void* pBuffer, size_t bytesToRead);
+static int memoryRead(Object* pObject, void* pBuffer, size_t bytesToRead);
 static void initObject(Object* pObject,
                        IMemory* pMem,
                        RegisterContext* pContext,
-                       const char* pCrashDumpFilename,
+                       DumpStream* pStream,
                        int (*read)(struct Object*, void*, size_t));
-static FILE* openFileAndThrowOnError(const char* pLogFilename);
 static void readDump(Object* pObject);
 static void validateDumpSignature(Object* pObject);
 static void readFlags(Object* pObject);
@@ -50,54 +71,108 @@ static void readFloatingPointRegisters(Object* pObject);
 static void readMemoryRegions(Object* pObject);
 static int readNextMemoryRegion(Object* pObject);
 static int isStackOverflowSentinelInsteadOfRegionDescription(int bytesRead, const RegionOrSentinel* pSentinel);
+static int isRegionDataInFile(Object* pObject, uint32_t bytesInRegion);
+static void createLazyMemoryRegion(Object* pObject, CrashCatcherMemoryRegionInfo* pRegion);
+static FileLoader* createFileLoader(FILE* pFile);
+static void loadFromFile(MemorySimLoader* pLoader, uint32_t sourceOffset, void* pDest, uint32_t size);
+static void releaseFileLoader(MemorySimLoader* pLoader);
 static void createAndLoadMemoryRegion(Object* pObject, CrashCatcherMemoryRegionInfo* pRegion);
 static void destructObject(Object* pObject);
 static int hexRead(Object* pObject, void* pBuffer, size_t bytesToRead);
 static int readNextCharacterSkippingNewLines(Object* pObject, char* pHexDigit);
-static uint8_t nibbleDigitToVal(char hexDigit);
 
 
 __throws void CrashCatcherDump_ReadBinary(IMemory* pMem, RegisterContext* pContext, const char* pCrashDumpFilename)
 {
-    Object         object;
+    readFromFile(pMem, pContext, pCrashDumpFilename, CrashCatcherDump_ReadBinaryFromStream);
+}
+
+static void readFromFile(IMemory* pMem,
+                         RegisterContext* pContext,
+                         const char* pCrashDumpFilename,
+                         void (*readFromStream)(IMemory*, RegisterContext*, DumpStream*))
+{
+    DumpStream stream;
+
+    DumpStream_Init(&stream, openFileAndThrowOnError(pCrashDumpFilename));
+    __try
+        readFromStream(pMem, pContext, &stream);
+    __catch
+    {
+        DumpStream_Close(&stream);
+        __rethrow;
+    }
+    DumpStream_Close(&stream);
+}
+
+static FILE* openFileAndThrowOnError(const char* pLogFilename)
+{
+    FILE* pLogFile = fopen(pLogFilename, "rb");
+    if (!pLogFile)
+        __throw_msg(fileException, "Failed to open the \"%s\" dump file.", pLogFilename);
+    return pLogFile;
+}
+
+__throws void CrashCatcherDump_ReadBinaryFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream)
+{
+    Object object;
 
+    initObject(&object, pMem, pContext, pStream, binaryRead);
     __try
     {
-        initObject(&object, pMem, pContext, pCrashDumpFilename, binaryRead);
+        /* Regions will just be loaded up front if the size of the file can't be determined. */
+        object.fileSize = DumpStream_GetSize(pStream);
         readDump(&object);
-        destructObject(&object);
     }
     __catch
     {
         destructObject(&object);
         __rethrow;
     }
+    destructObject(&object);
 }
 
 static int binaryRead(Object* pObject, void* pBuffer, size_t bytesToRead)
 {
-    return fread(pBuffer, 1, bytesToRead, pObject->pFile);
+    return DumpStream_Read(pObject->pStream, pBuffer, bytesToRead);
+}
+
+__throws void CrashCatcherDump_ReadBinaryFromMemory(IMemory* pMem,
+                                                   RegisterContext* pContext,
+                                                   const void* pDump,
+                                                   size_t dumpSize)
+{
+    Object object;
+
+    initObject(&object, pMem, pContext, NULL, memoryRead);
+    object.pDump = pDump;
+    object.dumpSize = dumpSize;
+    readDump(&object);
+}
+
+static int memoryRead(Object* pObject, void* pBuffer, size_t bytesToRead)
+{
+    size_t bytesLeft = pObject->dumpSize - pObject->dumpOffset;
+
+    if (bytesToRead > bytesLeft)
+        bytesToRead = bytesLeft;
+    memcpy(pBuffer, pObject->pDump + pObject->dumpOffset, bytesToRead);
+    pObject->dumpOffset += bytesToRead;
+    return bytesToRead;
 }
 
 static void initObject(Object* pObject,
                        IMemory* pMem,
                        RegisterContext* pContext,
-                       const char* pCrashDumpFilename,
+                       DumpStream* pStream,
                        int (*read)(struct Object*, void*, size_t))
 {
     memset(pObject, 0, sizeof(*pObject));
+    pObject->fileSize = -1;
     pObject->read = read;
     pObject->pMem = pMem;
     pObject->pContext = pContext;
-    pObject->pFile = openFileAndThrowOnError(pCrashDumpFilename);
-}
-
-static FILE* openFileAndThrowOnError(const char* pLogFilename)
-{
-    FILE* pLogFile = fopen(pLogFilename, "rb");
-    if (!pLogFile)
-        __throw_msg(fileException, "Failed to open the \"%s\" dump file.", pLogFilename);
-    return pLogFile;
+    pObject->pStream = pStream;
 }
 
 static void readDump(Object* pObject)
@@ -197,7 +272,10 @@ static int readNextMemoryRegion(Object* pObject)
 
     __try
     {
-        createAndLoadMemoryRegion(pObject, &regionOrSentinel.region);
+        if (isRegionDataInFile(pObject, regionOrSentinel.region.endAddress - regionOrSentinel.region.startAddress))
+            createLazyMemoryRegion(pObject, &regionOrSentinel.region);
+        else
+            createAndLoadMemoryRegion(pObject, &regionOrSentinel.region);
     }
     __catch
     {
@@ -214,29 +292,81 @@ static int isStackOverflowSentinelInsteadOfRegionDescription(int bytesRead, cons
     return (bytesRead == sizeof(pSentinel->sentinel) && pSentinel->sentinel == CRASH_CATCHER_STACK_SENTINEL);
 }
 
+static int isRegionDataInFile(Object* pObject, uint32_t bytesInRegion)
+{
+    long offset;
+
+    if (pObject->fileSize < 0)
+        return FALSE;
+    offset = DumpStream_Tell(pObject->pStream);
+    return offset >= 0 && (uint64_t)offset + bytesInRegion <= (uint64_t)pObject->fileSize;
+}
+
+static void createLazyMemoryRegion(Object* pObject, CrashCatcherMemoryRegionInfo* pRegion)
+{
+    uint32_t bytesInRegion = pRegion->endAddress - pRegion->startAddress;
+    long     offset = DumpStream_Tell(pObject->pStream);
+
+    /* Just index where the region's data lives in the file and skip over it. It is read in on first access. */
+    if (!pObject->pLoader)
+        pObject->pLoader = createFileLoader(pObject->pStream->pFile);
+    MemorySim_CreateLazyRegion(pObject->pMem, pRegion->startAddress, bytesInRegion, &pObject->pLoader->loader, offset);
+    if (fseek(pObject->pStream->pFile, bytesInRegion, SEEK_CUR) != 0)
+        __throw(fileFormatException);
+}
+
+static FileLoader* createFileLoader(FILE* pFile)
+{
+    FileLoader* pLoader = malloc(sizeof(*pLoader));
+    if (!pLoader)
+        __throw(outOfMemoryException);
+    memset(pLoader, 0, sizeof(*pLoader));
+    pLoader->loader.load = loadFromFile;
+    pLoader->loader.release = releaseFileLoader;
+    pLoader->pFile = pFile;
+    return pLoader;
+}
+
+static void loadFromFile(MemorySimLoader* pLoader, uint32_t sourceOffset, void* pDest, uint32_t size)
+{
+    FileLoader* pThis = (FileLoader*)pLoader;
+
+    if (fseek(pThis->pFile, sourceOffset, SEEK_SET) != 0 || fread(pDest, 1, size, pThis->pFile) != size)
+        __throw(fileException);
+}
+
+static void releaseFileLoader(MemorySimLoader* pLoader)
+{
+    FileLoader* pThis = (FileLoader*)pLoader;
+
+    if (pThis->pFile != stdin)
+        fclose(pThis->pFile);
+    free(pThis);
+}
+
 static void createAndLoadMemoryRegion(Object* pObject, CrashCatcherMemoryRegionInfo* pRegion)
 {
     uint32_t bytesInRegion = pRegion->endAddress - pRegion->startAddress;
-    uint32_t address = pRegion->startAddress;
-    uint32_t i;
+    uint8_t* pDest;
+    int      bytesRead;
 
+    /* Read straight into the region's host buffer rather than a byte at a time through IMemory. */
     MemorySim_CreateRegion(pObject->pMem, pRegion->startAddress, bytesInRegion);
-    for (i = 0 ; i < bytesInRegion ; i++)
-    {
-        uint8_t byte;
-        int bytesRead = pObject->read(pObject, &byte, 1);
-        if (bytesRead != 1)
-            __throw(fileFormatException);
-        IMemory_Write8(pObject->pMem, address++, byte);
-    }
+    pDest = MemorySim_MapSimulatedAddressToHostAddressForWrite(pObject->pMem, pRegion->startAddress, bytesInRegion);
+    bytesRead = pObject->read(pObject, pDest, bytesInRegion);
+    if (bytesRead < 0 || (uint32_t)bytesRead != bytesInRegion)
+        __throw(fileFormatException);
 }
 
 static void destructObject(Object* pObject)
 {
-    if (pObject && pObject->pFile)
+    if (pObject->pLoader)
     {
-        fclose(pObject->pFile);
-        pObject->pFile = NULL;
+        /* The dump file is now owned by the loader which MemorySim will release along with the last lazy region. */
+        DumpStream_Detach(pObject->pStream);
+        if (pObject->pLoader->loader.refCount == 0)
+            releaseFileLoader(&pObject->pLoader->loader);
+        pObject->pLoader = NULL;
     }
 }
 
@@ -244,19 +374,15 @@ static void destructObject(Object* pObject)
 
 __throws void CrashCatcherDump_ReadHex(IMemory* pMem, RegisterContext* pContext, const char* pCrashDumpFilename)
 {
-    Object         object;
+    readFromFile(pMem, pContext, pCrashDumpFilename, CrashCatcherDump_ReadHexFromStream);
+}
 
-    __try
-    {
-        initObject(&object, pMem, pContext, pCrashDumpFilename, hexRead);
-        readDump(&object);
-        destructObject(&object);
-    }
-    __catch
-    {
-        destructObject(&object);
-        __rethrow;
-    }
+__throws void CrashCatcherDump_ReadHexFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream)
+{
+    Object object;
+
+    initObject(&object, pMem, pContext, pStream, hexRead);
+    readDump(&object);
 }
 
 static int hexRead(Object* pObject, void* pBuffer, size_t bytesToRead)
@@ -268,6 +394,8 @@ static int hexRead(Object* pObject, void* pBuffer, size_t bytesToRead)
     {
         char hiNibble;
         char loNibble;
+        int  hiValue;
+        int  loValue;
         int  result;
 
         result = readNextCharacterSkippingNewLines(pObject, &hiNibble);
@@ -276,7 +404,11 @@ static int hexRead(Object* pObject, void* pBuffer, size_t bytesToRead)
         result = readNextCharacterSkippingNewLines(pObject, &loNibble);
         if (result != 1)
             break;
-        *pCurr++ = (nibbleDigitToVal(hiNibble) << 4) | nibbleDigitToVal(loNibble);
+        hiValue = HexDigitToNibble(hiNibble);
+        loValue = HexDigitToNibble(loNibble);
+        if (hiValue < 0 || loValue < 0)
+            __throw(fileFormatException);
+        *pCurr++ = (hiValue << 4) | loValue;
         bytesRead++;
     }
     return bytesRead;
@@ -289,23 +421,10 @@ static int readNextCharacterSkippingNewLines(Object* pObject, char* pHexDigit)
 
     do
     {
-        result = fread(&curr, 1, 1, pObject->pFile);
+        result = DumpStream_Read(pObject->pStream, &curr, 1);
     } while (result == 1 && (curr == '\r' || curr == '\n'));
 
     if (result == 1)
         *pHexDigit = curr;
     return result;
 }
-
-static uint8_t nibbleDigitToVal(char hexDigit)
-{
-    if (hexDigit >= '0' && hexDigit <= '9')
-        return hexDigit - '0';
-    if (hexDigit >= 'a' && hexDigit <= 'f')
-        return hexDigit - 'a' + 10;
-    if (hexDigit >= 'A' && hexDigit <= 'F')
-        return hexDigit - 'A' + 10;
-
-    __throw(fileFormatException);
-    return 0;
-}
@@ -10,13 +10,15 @@
     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
     GNU General Public License for more details.
 */
+#include <Clock.h>
 #include <common.h>
-#include <CrashCatcher.h>
-#include <CrashCatcherDump.h>
+#include <CrashCapture.h>
 #include <CrashDebugCommandLine.h>
+#include <DumpLoad.h>
+#include <ElfCache.h>
 #include <ElfLoad.h>
+#include <ElfSymbols.h>
 #include <FileFailureInject.h>
-#include <GdbLogParser.h>
 #include <MallocFailureInject.h>
 #include <MemorySim.h>
 #include <printfSpy.h>
@@ -25,6 +27,11 @@
 #include <version.h>
 
 
+/* Vector Table Offset Register in the System Control Block. */
+#define VTOR        0xE000ED08
+#define VTOR_TBLOFF 0xFFFFFF80
+
+
 static void displayCopyrightNotice(void)
 {
     fprintf(stderr,
@@ -37,8 +44,21 @@ static void displayUsage(void)
 {
     fprintf(stderr,
            "Usage: CrashDebug (--elf elfFilename | --bin imageFilename baseAddress)\n"
-           "                   --dump dumpFilename\n"
+           "                  (--dump dumpFilename |\n"
+           "                   --dedup (dumpDirectory | logFilename) [--jobs count]\n"
+           "                           [--split splitDirectory] |\n"
+           "                   --capture ttyFilename [--baud baudRate])\n"
+           "                  [--ram filename baseAddress]\n"
            "                  [--alias baseAddress size redirectAddress]\n"
+           "                  [--cache cacheDirectory]\n"
+           "                  [--core coreFilename]\n"
+           "                  [--convert compactFilename]\n"
+           "                  [--stats]\n"
+           "                  [--trace traceFilename]\n"
+           "                  [--heap]\n"
+           "                  [--stacks]\n"
+           "                  [--diff otherDumpFilename]\n"
+           "   or: CrashDebug --capture-script scriptFilename memoryMapFilename\n"
            "Where: NOTE: The --elf and --bin options are mutually exclusive.  Use one\n"
            "             or the other but not both.\n"
            "       --elf is used to provide the filename of the .elf image containing\n"
@@ -55,10 +75,76 @@ static void displayUsage(void)
            "         the crash.  See the following link to learn more about generating\n"
            "         these crash dumps:\n"
            "           http://github.com/adamgreen/CrashDebug#crash-dump-generation\n"
+           "         The dump is read in a single pass so it can also be a pipe.  Use\n"
+           "         \"--dump -\" to read it from stdin along with --core, --convert,\n"
+           "         --heap, --diff or --stacks.\n"
+           "       --dedup is used instead of --dump to calculate a crash signature for\n"
+           "         every dump in dumpDirectory and report which dumps share the same\n"
+           "         signature.  The signature combines the fault type and status\n"
+           "         registers, the faulting PC and return addresses found on the\n"
+           "         stack.  CrashDebug exits after printing the report.  If\n"
+           "         logFilename is given instead of a directory then every\n"
+           "         CrashCatcher hex dump embedded in that serial log is indexed in\n"
+           "         one pass and then decoded in parallel.\n"
+           "       --split writes each hex dump found in the --dedup logFilename out\n"
+           "         to splitDirectory as a binary dump named crash-lineNumber.dmp.\n"
+           "       --capture is used instead of --dump to wait for a CrashCatcher hex\n"
+           "         dump to arrive on a serial port or pty.  Text before the \"CRASH\n"
+           "         ENCOUNTERED\" banner, between it and the \"6343\" signature and\n"
+           "         after the \"End of dump\" line is skipped so the log doesn't need\n"
+           "         to be edited by hand.\n"
+           "       --baud sets the baud rate used when the --capture ttyFilename is a\n"
+           "         serial port, which is also switched to raw mode.  Defaults to\n"
+           "         115200.\n"
+           "       --capture-script writes a GDB script to scriptFilename which saves\n"
+           "         each read-write region listed in memoryMapFilename (the output\n"
+           "         of GDB's \"info mem\" command) to a raw binary file with \"dump\n"
+           "         binary memory\", along with the registers.  A manifest listing\n"
+           "         these files is written next to the script with a .manifest\n"
+           "         extension.  Pass the manifest to --dump once the script has run\n"
+           "         and the region files will be mapped rather than parsed.\n"
+           "       --jobs sets the number of threads used by --dedup to load dumps.\n"
+           "         Defaults to the number of processors on this machine.\n"
+           "       --ram is used to add a raw RAM image, such as one saved by OpenOCD's\n"
+           "         dump_image command, to the simulated memory at baseAddress.  The\n"
+           "         file is mapped copy-on-write so it is only read as GDB accesses\n"
+           "         it and GDB writes never make it back to the file.  It takes\n"
+           "         precedence over any RAM at the same address in --dump, which\n"
+           "         becomes optional.  Without --dump, the registers start from the\n"
+           "         reset SP and PC in the vector table.  The vector table is found\n"
+           "         through VTOR if an image covers it, else at address 0, else at\n"
+           "         the start of the --elf/--bin image.  Can be specified multiple\n"
+           "         times.\n"
            "       --alias is used to trap memory accesses to the region defined\n"
            "         by baseAddress/size and redirect them to the region at\n"
            "         redirectAddress. For example acesses to baseAddress will access\n"
-           "         redirectAddress instead).\n");
+           "         redirectAddress instead).\n"
+           "       --cache is used to provide a directory in which the FLASH contents\n"
+           "         extracted from --elf images are cached. Later sessions using the\n"
+           "         same .elf image (matched by its GNU build-id) map the cached\n"
+           "         contents directly instead of parsing the .elf again.\n"
+           "       --core is used to write the FLASH, RAM and registers out to an ARM ELF\n"
+           "         core file and exit instead of acting as a GDB remote stub.  GDB\n"
+           "         can then open the file directly with its core-file command.\n"
+           "       --convert is used to write the RAM and registers loaded from --dump\n"
+           "         out to a compressed and checksummed compact dump file and exit.\n"
+           "         Compact dump files can be passed to --dump in later sessions.\n"
+           "       --stats is used to print timing and memory/GDB packet statistics to\n"
+           "         stderr when CrashDebug exits.\n"
+           "       --trace is used to record the latency of every GDB request to a\n"
+           "         binary trace file and print latency percentiles for each\n"
+           "         packet type to stderr when CrashDebug exits.\n"
+           "       --heap is used to walk the newlib malloc heap found in --dump using\n"
+           "         the symbols from --elf, print its usage, fragmentation and any\n"
+           "         corruption found, and exit.\n"
+           "       --stacks is used to scan the main stack (found from the linker\n"
+           "         script symbols in --elf) and the stack of each FreeRTOS task for\n"
+           "         the 0xA5 fill pattern, print the used and free bytes of each,\n"
+           "         and exit.\n"
+           "       --diff is used to compare the RAM in --dump against the RAM in\n"
+           "         otherDumpFilename, a dump taken from the same firmware, print\n"
+           "         the address ranges which differ (with the --elf symbol\n"
+           "         containing each one), and exit.\n");
 }
 
 
@@ -68,16 +154,11 @@ typedef struct FileData
     long  dataSize;
 } FileData;
 
-typedef enum
-{
-    GDB_LOG,
-    CRASH_CATCHER_BIN,
-    CRASH_CATCHER_HEX,
-} DumpFileType;
-
 typedef enum
 {
     FIRST_PASS,
+    /* Runs after the image is loaded but before the dump so that --ram regions are found ahead of the dump's. */
+    RAM_PASS,
     SECOND_PASS
 } ParsePass;
 
@@ -89,18 +170,35 @@ static int parseFlagArgument(CrashDebugCommandLine* pThis, int argc, const char*
 static int parseBinFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
 static int parseElfFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
 static int parseDumpFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseRamOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static void loadRamImage(CrashDebugCommandLine* pThis, const char* pFilename, uint32_t baseAddress);
 static int parseAliasOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseCacheDirectoryOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseDedupDirectoryOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseJobsOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseSplitDirectoryOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseCoreFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseConvertFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseStatsOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseTraceFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseHeapOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseStacksOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseDiffFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseCaptureFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseBaudOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static int parseCaptureScriptOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass);
+static void throwIfCaptureScriptUsedWithOtherOptions(CrashDebugCommandLine* pThis);
 static void throwIfRequiredArgumentNotSpecified(CrashDebugCommandLine* pThis);
+static int isDumpReadFromStdin(CrashDebugCommandLine* pThis);
 static void loadImageFile(CrashDebugCommandLine* pThis);
+static void loadElfFileUsingCache(CrashDebugCommandLine* pThis);
+static void loadElfSymbols(CrashDebugCommandLine* pThis, const void* pElf, size_t elfSize);
 static FileData loadFileData(const char* pFilename);
 static void loadBinFile(CrashDebugCommandLine* pThis, volatile FileData* pFileData);
 static void loadDumpFile(CrashDebugCommandLine* pThis);
-static DumpFileType getFileType(const char* pDumpFilename);
-static int hasBinaryCrashCatcherSignature(const uint8_t* pHeader);
-static int hasHexCrashCatcherSignature(const uint8_t* pHeader);
-static uint8_t hiNibbleDigit(uint8_t byte);
-static uint8_t loNibbleDigit(uint8_t byte);
-static uint8_t nibbleDigit(uint8_t byte);
+static void seedRegistersFromVectorTable(CrashDebugCommandLine* pThis);
+static uint32_t findVectorTable(IMemory* pMem);
+static int tryReadLittleEndianWord(IMemory* pMem, uint32_t address, uint32_t* pWord);
 static void displayExceptionMessage(void);
 
 
@@ -109,12 +207,24 @@ __throws void CrashDebugCommandLine_Init(CrashDebugCommandLine* pThis, int volat
     __try
     {
         memset(pThis, 0, sizeof(*pThis));
+        pThis->startMicroseconds = Clock_GetMicroseconds();
         parseArguments(pThis, argc, argv, FIRST_PASS);
-        throwIfRequiredArgumentNotSpecified(pThis);
-        pThis->pMemory = MemorySim_Init();
-        loadImageFile(pThis);
-        loadDumpFile(pThis);
-        parseArguments(pThis, argc, argv, SECOND_PASS);
+        if (pThis->pCaptureScriptFilename)
+        {
+            /* Writing a capture script doesn't require any images or dumps to be loaded. */
+            throwIfCaptureScriptUsedWithOtherOptions(pThis);
+        }
+        else
+        {
+            throwIfRequiredArgumentNotSpecified(pThis);
+            pThis->pMemory = MemorySim_Init();
+            loadImageFile(pThis);
+            parseArguments(pThis, argc, argv, RAM_PASS);
+            pThis->imageLoadedMicroseconds = Clock_GetMicroseconds();
+            loadDumpFile(pThis);
+            pThis->dumpLoadedMicroseconds = Clock_GetMicroseconds();
+            parseArguments(pThis, argc, argv, SECOND_PASS);
+        }
     }
     __catch
     {
@@ -123,6 +233,8 @@ __throws void CrashDebugCommandLine_Init(CrashDebugCommandLine* pThis, int volat
         displayUsage();
         MemorySim_Uninit(pThis->pMemory);
         pThis->pMemory = NULL;
+        MappedFile_Close(&pThis->elfCacheFile);
+        ElfSymbols_Uninit(&pThis->symbols);
         __rethrow;
     }
 }
@@ -158,8 +270,38 @@ static int parseFlagArgument(CrashDebugCommandLine* pThis, int argc, const char*
         return parseElfFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
     else if (0 == strcasecmp(*ppArgs, "--dump"))
         return parseDumpFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--ram"))
+        return parseRamOption(pThis, argc - 1, &ppArgs[1], pass);
     else if (0 == strcasecmp(*ppArgs, "--alias"))
         return parseAliasOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--cache"))
+        return parseCacheDirectoryOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--dedup"))
+        return parseDedupDirectoryOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--jobs"))
+        return parseJobsOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--split"))
+        return parseSplitDirectoryOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--core"))
+        return parseCoreFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--convert"))
+        return parseConvertFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--stats"))
+        return parseStatsOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--trace"))
+        return parseTraceFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--heap"))
+        return parseHeapOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--stacks"))
+        return parseStacksOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--diff"))
+        return parseDiffFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--capture"))
+        return parseCaptureFilenameOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--capture-script"))
+        return parseCaptureScriptOption(pThis, argc - 1, &ppArgs[1], pass);
+    else if (0 == strcasecmp(*ppArgs, "--baud"))
+        return parseBaudOption(pThis, argc - 1, &ppArgs[1], pass);
     else
         __throw_msg(invalidArgumentException, "\"%s\" isn't a valid command line option.", *ppArgs);
 }
@@ -197,6 +339,38 @@ static int parseDumpFilenameOption(CrashDebugCommandLine* pThis, int argc, const
     return 2;
 }
 
+static int parseRamOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 2)
+        __throw_msg(invalidArgumentException, "The --ram command line option requires filename and baseAddress.");
+
+    if (pass == FIRST_PASS)
+        pThis->ramImageCount++;
+    else if (pass == RAM_PASS)
+        loadRamImage(pThis, ppArgs[0], strtoul(ppArgs[1], NULL, 0));
+    return 3;
+}
+
+static void loadRamImage(CrashDebugCommandLine* pThis, const char* pFilename, uint32_t baseAddress)
+{
+    MappedFile mapping = MappedFile_Open(pFilename, MAPPED_FILE_COPY_ON_WRITE);
+
+    if (mapping.size == 0)
+        __throw_msg(fileFormatException, "The \"%s\" RAM image is empty.", pFilename);
+    __try
+    {
+        if ((uint64_t)baseAddress + mapping.size > (uint64_t)0xFFFFFFFF + 1)
+            __throw(invalidArgumentException);
+        MemorySim_CreateRegionFromMappedFile(pThis->pMemory, baseAddress, &mapping);
+    }
+    __catch
+    {
+        MappedFile_Close(&mapping);
+        __throw_msg(getExceptionCode(), "Failed to create RAM region at address 0x%08X for \"%s\".",
+                    baseAddress, pFilename);
+    }
+}
+
 static int parseAliasOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
 {
     if (argc < 3)
@@ -221,24 +395,229 @@ static int parseAliasOption(CrashDebugCommandLine* pThis, int argc, const char**
     return 4;
 }
 
+static int parseCacheDirectoryOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --cache command line option requires directory.");
+
+    if (pass == FIRST_PASS)
+        pThis->pCacheDirectory = ppArgs[0];
+    return 2;
+}
+
+static int parseDedupDirectoryOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --dedup command line option requires directory.");
+
+    if (pass == FIRST_PASS)
+        pThis->pDedupDirectory = ppArgs[0];
+    return 2;
+}
+
+static int parseJobsOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --jobs command line option requires count.");
+
+    if (pass == FIRST_PASS)
+    {
+        pThis->jobCount = strtoul(ppArgs[0], NULL, 0);
+        if (pThis->jobCount == 0)
+            __throw_msg(invalidArgumentException, "The --jobs command line option requires a count greater than 0.");
+    }
+    return 2;
+}
+
+static int parseSplitDirectoryOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --split command line option requires directory.");
+
+    if (pass == FIRST_PASS)
+        pThis->pSplitDirectory = ppArgs[0];
+    return 2;
+}
+
+static int parseCoreFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --core command line option requires filename.");
+
+    if (pass == FIRST_PASS)
+        pThis->pCoreFilename = ppArgs[0];
+    return 2;
+}
+
+static int parseConvertFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --convert command line option requires filename.");
+
+    if (pass == FIRST_PASS)
+        pThis->pConvertFilename = ppArgs[0];
+    return 2;
+}
+
+static int parseStatsOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (pass == FIRST_PASS)
+        pThis->displayStats = TRUE;
+    return 1;
+}
+
+static int parseTraceFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --trace command line option requires filename.");
+
+    if (pass == FIRST_PASS)
+        pThis->pTraceFilename = ppArgs[0];
+    return 2;
+}
+
+static int parseHeapOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (pass == FIRST_PASS)
+        pThis->displayHeap = TRUE;
+    return 1;
+}
+
+static int parseStacksOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (pass == FIRST_PASS)
+        pThis->displayStacks = TRUE;
+    return 1;
+}
+
+static int parseDiffFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --diff command line option requires filename.");
+
+    if (pass == FIRST_PASS)
+        pThis->pDiffFilename = ppArgs[0];
+    return 2;
+}
+
+static int parseCaptureFilenameOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --capture command line option requires filename.");
+
+    if (pass == FIRST_PASS)
+        pThis->pCaptureFilename = ppArgs[0];
+    return 2;
+}
+
+static int parseBaudOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 1)
+        __throw_msg(invalidArgumentException, "The --baud command line option requires baudRate.");
+
+    if (pass == FIRST_PASS)
+    {
+        pThis->baudRate = strtoul(ppArgs[0], NULL, 0);
+        if (pThis->baudRate == 0)
+            __throw_msg(invalidArgumentException, "The --baud command line option requires a rate greater than 0.");
+    }
+    return 2;
+}
+
+static int parseCaptureScriptOption(CrashDebugCommandLine* pThis, int argc, const char** ppArgs, ParsePass pass)
+{
+    if (argc < 2)
+    {
+        __throw_msg(invalidArgumentException,
+                    "The --capture-script command line option requires scriptFilename and memoryMapFilename.");
+    }
+
+    if (pass == FIRST_PASS)
+    {
+        pThis->pCaptureScriptFilename = ppArgs[0];
+        pThis->pMemoryMapFilename = ppArgs[1];
+    }
+    return 3;
+}
+
+static void throwIfCaptureScriptUsedWithOtherOptions(CrashDebugCommandLine* pThis)
+{
+    if (pThis->pElfFilename || pThis->pBinFilename || pThis->pDumpFilename || pThis->pDedupDirectory ||
+        pThis->pCaptureFilename || pThis->ramImageCount)
+    {
+        __throw_msg(invalidArgumentException,
+                    "The --capture-script command line option can't be used with --elf, --bin, --dump, --dedup, "
+                    "--capture or --ram.");
+    }
+}
+
 static void throwIfRequiredArgumentNotSpecified(CrashDebugCommandLine* pThis)
 {
     if (!pThis->pBinFilename && !pThis->pElfFilename)
         __throw_msg(invalidArgumentException, "Must provide --bin or --elf command line option.");
-    if (!pThis->pDumpFilename)
+    if (!pThis->pDumpFilename && !pThis->pDedupDirectory && !pThis->pCaptureFilename && !pThis->ramImageCount)
         __throw_msg(invalidArgumentException, "Must provide --dump command line option.");
+    if (pThis->pCaptureFilename && (pThis->pDumpFilename || pThis->pDedupDirectory))
+        __throw_msg(invalidArgumentException, "The --capture command line option can't be used with --dump or --dedup.");
+    if (pThis->pDumpFilename && pThis->pDedupDirectory)
+        __throw_msg(invalidArgumentException, "The --dump and --dedup command line options are mutually exclusive.");
+    if (pThis->ramImageCount && pThis->pDedupDirectory)
+        __throw_msg(invalidArgumentException, "The --ram and --dedup command line options are mutually exclusive.");
+    if (pThis->pSplitDirectory && !pThis->pDedupDirectory)
+        __throw_msg(invalidArgumentException, "The --split command line option requires --dedup.");
+    if (pThis->jobCount && !pThis->pDedupDirectory)
+        __throw_msg(invalidArgumentException, "The --jobs command line option requires --dedup.");
+    if (pThis->baudRate && !pThis->pCaptureFilename)
+        __throw_msg(invalidArgumentException, "The --baud command line option requires --capture.");
+    if (pThis->pCoreFilename && pThis->pDedupDirectory)
+        __throw_msg(invalidArgumentException, "The --core and --dedup command line options are mutually exclusive.");
+    if (pThis->pConvertFilename && pThis->pDedupDirectory)
+        __throw_msg(invalidArgumentException, "The --convert and --dedup command line options are mutually exclusive.");
+    if (pThis->pConvertFilename && pThis->pCoreFilename)
+        __throw_msg(invalidArgumentException, "The --convert and --core command line options are mutually exclusive.");
+    if (pThis->displayHeap && !pThis->pElfFilename)
+        __throw_msg(invalidArgumentException, "The --heap command line option requires --elf.");
+    if (pThis->displayHeap && (pThis->pDedupDirectory || pThis->pCoreFilename || pThis->pConvertFilename))
+        __throw_msg(invalidArgumentException,
+                    "The --heap command line option can't be used with --dedup, --core or --convert.");
+    if (pThis->pDiffFilename && (pThis->pDedupDirectory || pThis->pCoreFilename || pThis->pConvertFilename ||
+                                 pThis->displayHeap))
+        __throw_msg(invalidArgumentException,
+                    "The --diff command line option can't be used with --dedup, --core, --convert or --heap.");
+    if (pThis->displayStacks && !pThis->pElfFilename)
+        __throw_msg(invalidArgumentException, "The --stacks command line option requires --elf.");
+    if (pThis->displayStacks && (pThis->pDedupDirectory || pThis->pCoreFilename || pThis->pConvertFilename ||
+                                 pThis->displayHeap || pThis->pDiffFilename))
+        __throw_msg(invalidArgumentException,
+                    "The --stacks command line option can't be used with --dedup, --core, --convert, --heap or --diff.");
+    if (isDumpReadFromStdin(pThis) && !pThis->pCoreFilename && !pThis->pConvertFilename && !pThis->displayHeap &&
+        !pThis->pDiffFilename && !pThis->displayStacks)
+        __throw_msg(invalidArgumentException,
+                    "Reading --dump from stdin requires --core, --convert, --heap, --diff or --stacks since GDB uses stdin.");
+}
+
+static int isDumpReadFromStdin(CrashDebugCommandLine* pThis)
+{
+    return pThis->pDumpFilename && 0 == strcmp(pThis->pDumpFilename, DUMP_LOAD_STDIN_FILENAME);
 }
 
 static void loadImageFile(CrashDebugCommandLine* pThis)
 {
     volatile FileData fileData = { NULL, 0 };
 
+    if (pThis->pElfFilename && pThis->pCacheDirectory)
+    {
+        loadElfFileUsingCache(pThis);
+        return;
+    }
+
     __try
     {
         if (pThis->pElfFilename)
         {
             fileData = loadFileData(pThis->pElfFilename);
             ElfLoad_FromMemory(pThis->pMemory, fileData.pData, fileData.dataSize);
+            loadElfSymbols(pThis, fileData.pData, fileData.dataSize);
         }
         else
         {
@@ -254,6 +633,43 @@ static void loadImageFile(CrashDebugCommandLine* pThis)
     }
 }
 
+static void loadElfFileUsingCache(CrashDebugCommandLine* pThis)
+{
+    MappedFile elfFile = MappedFile_Open(pThis->pElfFilename, MAPPED_FILE_READ_ONLY);
+
+    __try
+    {
+        pThis->elfCacheFile = ElfCache_Load(pThis->pMemory, &pThis->symbols, pThis->pCacheDirectory,
+                                            elfFile.pData, elfFile.size);
+        /* Cache hits restore the symbols as well so the ELF's symbol table only needs to be parsed (to report why it
+           is missing) when there weren't any. */
+        if (!pThis->symbols.pSymbols)
+            loadElfSymbols(pThis, elfFile.pData, elfFile.size);
+    }
+    __catch
+    {
+        MappedFile_Close(&elfFile);
+        __rethrow;
+    }
+    MappedFile_Close(&elfFile);
+}
+
+static void loadElfSymbols(CrashDebugCommandLine* pThis, const void* pElf, size_t elfSize)
+{
+    __try
+    {
+        ElfSymbols_Init(&pThis->symbols, pElf, elfSize);
+    }
+    __catch
+    {
+        /* Only --heap and --stacks require symbols.  Without them, symbol based features like RTOS thread support are
+           disabled. */
+        if (pThis->displayHeap || pThis->displayStacks)
+            __rethrow;
+        clearExceptionCode();
+    }
+}
+
 static FileData loadFileData(const char* pFilename)
 {
     FILE* volatile pFile = NULL;
@@ -312,65 +728,75 @@ static void loadBinFile(CrashDebugCommandLine* pThis, volatile FileData* pFileDa
 
 static void loadDumpFile(CrashDebugCommandLine* pThis)
 {
-    switch(getFileType(pThis->pDumpFilename))
+    if (pThis->pDedupDirectory)
+        return;
+    if (!pThis->pDumpFilename && !pThis->pCaptureFilename)
     {
-    case GDB_LOG:
-        GdbLogParse(pThis->pMemory, &pThis->context, pThis->pDumpFilename);
-        break;
-    case CRASH_CATCHER_HEX:
-        CrashCatcherDump_ReadHex(pThis->pMemory, &pThis->context, pThis->pDumpFilename);
-        break;
-    case CRASH_CATCHER_BIN:
-        CrashCatcherDump_ReadBinary(pThis->pMemory, &pThis->context, pThis->pDumpFilename);
-        break;
+        seedRegistersFromVectorTable(pThis);
+        return;
     }
+    if (pThis->pCaptureFilename)
+    {
+        CrashCapture_FromFile(pThis->pMemory, &pThis->context, pThis->pCaptureFilename,
+                              pThis->baudRate ? pThis->baudRate : CRASH_CAPTURE_DEFAULT_BAUD_RATE);
+        return;
+    }
+    DumpLoad_FromFile(pThis->pMemory, &pThis->context, pThis->pDumpFilename);
 }
 
-static DumpFileType getFileType(const char* pDumpFilename)
-{
-    uint8_t fileHeader[4] = { 0, 0, 0, 0 };
-
-    FILE*   pFile = fopen(pDumpFilename, "rb");
-    if (!pFile)
-        __throw_msg(fileException, "Failed to open \"%s\".", pDumpFilename);
-    fread(fileHeader, 1, sizeof(fileHeader), pFile);
-    fclose(pFile);
-
-    if (hasBinaryCrashCatcherSignature(fileHeader))
-        return CRASH_CATCHER_BIN;
-    else if (hasHexCrashCatcherSignature(fileHeader))
-        return CRASH_CATCHER_HEX;
-    else
-        return GDB_LOG;
-}
-
-static int hasBinaryCrashCatcherSignature(const uint8_t* pHeader)
-{
-    return (pHeader[0] == CRASH_CATCHER_SIGNATURE_BYTE0 && pHeader[1] == CRASH_CATCHER_SIGNATURE_BYTE1);
-}
-
-static int hasHexCrashCatcherSignature(const uint8_t* pHeader)
+static void seedRegistersFromVectorTable(CrashDebugCommandLine* pThis)
 {
-    return (pHeader[0] == hiNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE0) &&
-            pHeader[1] == loNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE0) &&
-            pHeader[2] == hiNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE1) &&
-            pHeader[3] == loNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE1));
+    uint32_t vectorTable;
+    uint32_t initialSp;
+    uint32_t resetVector;
+
+    /* Only --ram images were given so start from the reset state.  The vector table starts with the initial MSP and
+       then the reset handler's address. */
+    if (MemorySim_GetRegionCount(pThis->pMemory) == 0)
+        return;
+    vectorTable = findVectorTable(pThis->pMemory);
+    if (!tryReadLittleEndianWord(pThis->pMemory, vectorTable, &initialSp) ||
+        !tryReadLittleEndianWord(pThis->pMemory, vectorTable + 4, &resetVector))
+    {
+        return;
+    }
+    pThis->context.R[SP] = initialSp;
+    pThis->context.R[MSP] = initialSp;
+    pThis->context.R[PSP] = DEFAULT_SP_VALUE;
+    pThis->context.R[LR] = 0xFFFFFFFF;
+    pThis->context.R[PC] = resetVector & ~1;
+    /* Thumb state bit. */
+    pThis->context.R[XPSR] = 1 << 24;
 }
 
-static uint8_t hiNibbleDigit(uint8_t byte)
+static uint32_t findVectorTable(IMemory* pMem)
 {
-    return nibbleDigit(byte >> 4);
+    uint32_t vtor;
+    uint32_t initialSp;
+
+    /* Use VTOR if a --ram image covers the System Control Block since the code may have relocated the vector table.
+       Otherwise the processor boots from address 0.  Parts which only alias FLASH to address 0 at boot, and so have
+       nothing mapped there, fall back to the first region loaded, which is the --elf/--bin FLASH image. */
+    if (tryReadLittleEndianWord(pMem, VTOR, &vtor))
+        return vtor & VTOR_TBLOFF;
+    if (tryReadLittleEndianWord(pMem, FLASH_BASE_ADDRESS, &initialSp))
+        return FLASH_BASE_ADDRESS;
+    return MemorySim_GetRegionInfo(pMem, 0).baseAddress;
 }
 
-static uint8_t loNibbleDigit(uint8_t byte)
+static int tryReadLittleEndianWord(IMemory* pMem, uint32_t address, uint32_t* pWord)
 {
-    return nibbleDigit(byte & 0xF);
-}
+    uint8_t bytes[4];
+    size_t  i;
 
-static uint8_t nibbleDigit(uint8_t byte)
-{
-    static const uint8_t nibbleToHexDigit[] = "0123456789ABCDEF";
-    return nibbleToHexDigit[byte];
+    /* Images are raw little-endian target memory so assemble the word a byte at a time rather than in host order. */
+    for (i = 0 ; i < sizeof(bytes) ; i++)
+    {
+        if (!IMemory_TryRead8(pMem, address + i, &bytes[i]))
+            return FALSE;
+    }
+    *pWord = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    return TRUE;
 }
 
 static void displayExceptionMessage(void)
@@ -383,4 +809,7 @@ static void displayExceptionMessage(void)
 void CrashDebugCommandLine_Uninit(CrashDebugCommandLine* pThis)
 {
     MemorySim_Uninit(pThis->pMemory);
+    /* The cached FLASH regions reference this mapping so it can only be closed after the simulated memory is gone. */
+    MappedFile_Close(&pThis->elfCacheFile);
+    ElfSymbols_Uninit(&pThis->symbols);
 }
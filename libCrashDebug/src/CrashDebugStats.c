@@ -0,0 +1,93 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <Clock.h>
+#include <common.h>
+#include <CrashDebugStats.h>
+#include <ctype.h>
+#include <MemorySim.h>
+#include <printfSpy.h>
+#include <stdio.h>
+
+
+static void printPhaseTimes(const CrashDebugCommandLine* pCommandLine, const RspStats* pRspStats);
+static void printTime(const char* pDescription, uint64_t microseconds);
+static void printMemorySimStats(IMemory* pMemory);
+static void printRspStats(const RspStats* pRspStats);
+static void printPacketStats(int packetType, const RspPacketStats* pPacketStats);
+
+
+void CrashDebugStats_Print(const CrashDebugCommandLine* pCommandLine, const RspStats* pRspStats)
+{
+    printPhaseTimes(pCommandLine, pRspStats);
+    printMemorySimStats(pCommandLine->pMemory);
+    if (pRspStats)
+        printRspStats(pRspStats);
+}
+
+static void printPhaseTimes(const CrashDebugCommandLine* pCommandLine, const RspStats* pRspStats)
+{
+    uint64_t endMicroseconds = Clock_GetMicroseconds();
+
+    fprintf(stderr, "Phase times:\n");
+    printTime("Image load", pCommandLine->imageLoadedMicroseconds - pCommandLine->startMicroseconds);
+    printTime("Dump load", pCommandLine->dumpLoadedMicroseconds - pCommandLine->imageLoadedMicroseconds);
+    if (pRspStats && pRspStats->hasReceivedPacket)
+        printTime("First GDB packet", pRspStats->firstPacketMicroseconds);
+    printTime("Total", endMicroseconds - pCommandLine->startMicroseconds);
+}
+
+static void printTime(const char* pDescription, uint64_t microseconds)
+{
+    fprintf(stderr, "  %-18s%12.3f ms\n", pDescription, microseconds / 1000.0);
+}
+
+static void printMemorySimStats(IMemory* pMemory)
+{
+    MemorySimStats stats = MemorySim_GetStats(pMemory);
+
+    fprintf(stderr, "MemorySim:\n"
+                    "  Region lookups    %12lu\n"
+                    "  Region hits       %12lu\n"
+                    "  Region misses     %12lu\n"
+                    "  Bytes copied      %12lu\n"
+                    "  Lazy region loads %12lu\n"
+                    "  Watchpoint checks %12lu\n",
+            (unsigned long)stats.lookups, (unsigned long)stats.hits, (unsigned long)stats.misses,
+            (unsigned long)stats.bytesCopied, (unsigned long)stats.lazyRegionLoads,
+            (unsigned long)stats.watchpointChecks);
+}
+
+static void printRspStats(const RspStats* pRspStats)
+{
+    int i;
+
+    fprintf(stderr, "GDB packets:\n"
+                    "  Type        Count     Bytes In    Bytes Out  Response ms\n");
+    for (i = 0 ; i < (int)ARRAY_SIZE(pRspStats->packets) ; i++)
+        printPacketStats(i, &pRspStats->packets[i]);
+}
+
+static void printPacketStats(int packetType, const RspPacketStats* pPacketStats)
+{
+    char typeString[8];
+
+    if (pPacketStats->bytesIn == 0 && pPacketStats->bytesOut == 0)
+        return;
+    if (isgraph(packetType))
+        snprintf(typeString, sizeof(typeString), "%c", packetType);
+    else
+        snprintf(typeString, sizeof(typeString), "0x%02X", packetType);
+    fprintf(stderr, "  %-4s %12lu %12lu %12lu %12.3f\n",
+            typeString, (unsigned long)pPacketStats->packetCount, (unsigned long)pPacketStats->bytesIn,
+            (unsigned long)pPacketStats->bytesOut, pPacketStats->responseMicroseconds / 1000.0);
+}
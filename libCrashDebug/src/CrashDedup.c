@@ -0,0 +1,461 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <common.h>
+#include <CrashCatcherDump.h>
+#include <CrashDedup.h>
+#include <Directory.h>
+#include <DumpLoad.h>
+#include <MallocFailureInject.h>
+#include <MemorySim.h>
+#include <printfSpy.h>
+#include <WorkQueue.h>
+
+
+typedef struct WorkContext
+{
+    CrashDedup* pDedup;
+    IMemory*    pFlashMemory;
+} WorkContext;
+
+typedef struct SignatureGroup
+{
+    size_t firstEntry;
+    size_t entryCount;
+} SignatureGroup;
+
+
+static void findDumpFiles(CrashDedup* pThis, const char* pDumpDirectory);
+static void addEntry(CrashDedup* pThis, const char* pDumpDirectory, const char* pName);
+static void addLogEntries(CrashDedup* pThis, const char* pLogFilename);
+static char* allocateLogEntryName(const char* pLogFilename, unsigned long lineNumber);
+static char* allocatePath(const char* pDirectory, const char* pName);
+static void* throwingRealloc(void* pOriginal, size_t size);
+static void processEntriesWithThreads(CrashDedup* pThis, IMemory* pFlashMemory, unsigned int jobCount);
+static void processEntryCallback(void* pContext, size_t index);
+static void processEntry(CrashDedup* pThis, IMemory* pFlashMemory, CrashDedupEntry* pEntry);
+static void loadLogEntry(CrashDedup* pThis, IMemory* pMemory, RegisterContext* pContext, CrashDedupEntry* pEntry);
+static void writeSplitDump(const char* pSplitDirectory, unsigned long lineNumber, const CrashCapture* pCapture);
+static void writeFile(const char* pPath, const void* pData, size_t dataSize);
+static int compareEntries(const void* pv1, const void* pv2);
+static int compareFilenames(const void* pv1, const void* pv2);
+static size_t countFailedEntries(CrashDedup* pThis);
+static SignatureGroup* buildSortedGroups(CrashDedup* pThis, size_t* pGroupCount);
+static int compareGroups(const void* pv1, const void* pv2);
+static void printGroup(CrashDedup* pThis, const SignatureGroup* pGroup);
+static const char* exceptionName(uint32_t exceptionNumber);
+static void printFailedEntries(CrashDedup* pThis, size_t failedCount);
+
+
+__throws void CrashDedup_Init(CrashDedup* pThis, IMemory* pFlashMemory, const char* pDumpDirectory, unsigned int jobCount)
+{
+    if (Directory_IsRegularFile(pDumpDirectory))
+    {
+        CrashDedup_InitFromLog(pThis, pFlashMemory, pDumpDirectory, NULL, jobCount);
+        return;
+    }
+
+    memset(pThis, 0, sizeof(*pThis));
+    __try
+    {
+        findDumpFiles(pThis, pDumpDirectory);
+        processEntriesWithThreads(pThis, pFlashMemory, jobCount ? jobCount : WorkQueue_GetProcessorCount());
+        qsort(pThis->pEntries, pThis->entryCount, sizeof(*pThis->pEntries), compareEntries);
+    }
+    __catch
+    {
+        CrashDedup_Uninit(pThis);
+        __rethrow;
+    }
+}
+
+static void findDumpFiles(CrashDedup* pThis, const char* pDumpDirectory)
+{
+    Directory* volatile pDir = NULL;
+    const char*         pName;
+
+    pDir = Directory_Open(pDumpDirectory);
+    __try
+    {
+        while ((pName = Directory_Next(pDir)) != NULL)
+            addEntry(pThis, pDumpDirectory, pName);
+    }
+    __catch
+    {
+        Directory_Close(pDir);
+        __rethrow;
+    }
+    Directory_Close(pDir);
+
+    /* Directory listing order is file system specific so sort to make the report reproducible. */
+    qsort(pThis->pEntries, pThis->entryCount, sizeof(*pThis->pEntries), compareFilenames);
+}
+
+static void addEntry(CrashDedup* pThis, const char* pDumpDirectory, const char* pName)
+{
+    char*            pPath = allocatePath(pDumpDirectory, pName);
+    CrashDedupEntry* pEntry;
+
+    if (!Directory_IsRegularFile(pPath))
+    {
+        free(pPath);
+        return;
+    }
+    __try
+    {
+        pThis->pEntries = throwingRealloc(pThis->pEntries, (pThis->entryCount + 1) * sizeof(*pThis->pEntries));
+    }
+    __catch
+    {
+        free(pPath);
+        __rethrow;
+    }
+    pEntry = &pThis->pEntries[pThis->entryCount++];
+    memset(pEntry, 0, sizeof(*pEntry));
+    pEntry->pFilename = pPath;
+}
+
+__throws void CrashDedup_InitFromLog(CrashDedup* pThis, IMemory* pFlashMemory, const char* pLogFilename,
+                                     const char* pSplitDirectory, unsigned int jobCount)
+{
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pSplitDirectory = pSplitDirectory;
+    __try
+    {
+        CrashLog_Open(&pThis->log, pLogFilename);
+        addLogEntries(pThis, pLogFilename);
+        processEntriesWithThreads(pThis, pFlashMemory, jobCount ? jobCount : WorkQueue_GetProcessorCount());
+        qsort(pThis->pEntries, pThis->entryCount, sizeof(*pThis->pEntries), compareEntries);
+    }
+    __catch
+    {
+        CrashDedup_Uninit(pThis);
+        __rethrow;
+    }
+}
+
+static void addLogEntries(CrashDedup* pThis, const char* pLogFilename)
+{
+    size_t i;
+
+    if (pThis->log.dumpCount == 0)
+        return;
+    pThis->pEntries = throwingRealloc(NULL, pThis->log.dumpCount * sizeof(*pThis->pEntries));
+    memset(pThis->pEntries, 0, pThis->log.dumpCount * sizeof(*pThis->pEntries));
+    for (i = 0 ; i < pThis->log.dumpCount ; i++)
+    {
+        CrashDedupEntry* pEntry = &pThis->pEntries[i];
+
+        pEntry->pFilename = allocateLogEntryName(pLogFilename, pThis->log.pDumps[i].lineNumber);
+        pEntry->lineNumber = pThis->log.pDumps[i].lineNumber;
+        pEntry->logDumpIndex = i;
+        pThis->entryCount++;
+    }
+}
+
+static char* allocateLogEntryName(const char* pLogFilename, unsigned long lineNumber)
+{
+    size_t nameSize = strlen(pLogFilename) + 1 + 20 + 1;
+    char*  pName = malloc(nameSize);
+
+    if (!pName)
+        __throw(outOfMemoryException);
+    snprintf(pName, nameSize, "%s:%lu", pLogFilename, lineNumber);
+    return pName;
+}
+
+static char* allocatePath(const char* pDirectory, const char* pName)
+{
+    size_t directoryLength = strlen(pDirectory);
+    size_t nameLength = strlen(pName);
+    int    needsSeparator = directoryLength > 0 && pDirectory[directoryLength - 1] != '/';
+    char*  pPath = malloc(directoryLength + needsSeparator + nameLength + 1);
+
+    if (!pPath)
+        __throw(outOfMemoryException);
+    memcpy(pPath, pDirectory, directoryLength);
+    if (needsSeparator)
+        pPath[directoryLength] = '/';
+    memcpy(pPath + directoryLength + needsSeparator, pName, nameLength + 1);
+    return pPath;
+}
+
+static void* throwingRealloc(void* pOriginal, size_t size)
+{
+    void* pRealloc = realloc(pOriginal, size);
+    if (!pRealloc)
+        __throw(outOfMemoryException);
+    return pRealloc;
+}
+
+static void processEntriesWithThreads(CrashDedup* pThis, IMemory* pFlashMemory, unsigned int jobCount)
+{
+    WorkContext context;
+
+    context.pDedup = pThis;
+    context.pFlashMemory = pFlashMemory;
+    WorkQueue_Run(pThis->entryCount, jobCount, processEntryCallback, &context);
+}
+
+static void processEntryCallback(void* pContext, size_t index)
+{
+    WorkContext* pWork = (WorkContext*)pContext;
+
+    processEntry(pWork->pDedup, pWork->pFlashMemory, &pWork->pDedup->pEntries[index]);
+}
+
+static void processEntry(CrashDedup* pThis, IMemory* pFlashMemory, CrashDedupEntry* pEntry)
+{
+    IMemory* volatile pMemory = NULL;
+    RegisterContext   context;
+
+    __try
+    {
+        memset(&context, 0, sizeof(context));
+        pMemory = MemorySim_Create();
+        /* The FLASH contents are never written so every worker can reference the same copy. */
+        MemorySim_ShareReadOnlyRegions(pMemory, pFlashMemory);
+        if (pEntry->lineNumber)
+            loadLogEntry(pThis, pMemory, &context, pEntry);
+        else
+            DumpLoad_FromFile(pMemory, &context, pEntry->pFilename);
+        pEntry->signature = CrashSignature_Calculate(pMemory, &context);
+    }
+    __catch
+    {
+        pEntry->exceptionCode = getExceptionCode();
+        snprintf(pEntry->exceptionMessage, sizeof(pEntry->exceptionMessage), "%s", getExceptionMessage());
+        clearExceptionCode();
+    }
+    MemorySim_Destroy(pMemory);
+}
+
+static void loadLogEntry(CrashDedup* pThis, IMemory* pMemory, RegisterContext* pContext, CrashDedupEntry* pEntry)
+{
+    CrashCapture capture;
+
+    CrashCapture_Init(&capture);
+    __try
+    {
+        CrashLog_DecodeDump(&pThis->log, pEntry->logDumpIndex, &capture);
+        if (pThis->pSplitDirectory)
+            writeSplitDump(pThis->pSplitDirectory, pEntry->lineNumber, &capture);
+        CrashCatcherDump_ReadBinaryFromMemory(pMemory, pContext, capture.pDump, capture.dumpSize);
+    }
+    __catch
+    {
+        CrashCapture_Uninit(&capture);
+        __rethrow;
+    }
+    CrashCapture_Uninit(&capture);
+}
+
+static void writeSplitDump(const char* pSplitDirectory, unsigned long lineNumber, const CrashCapture* pCapture)
+{
+    char  name[32];
+    char* pPath;
+
+    snprintf(name, sizeof(name), "crash-%lu.dmp", lineNumber);
+    pPath = allocatePath(pSplitDirectory, name);
+    __try
+    {
+        writeFile(pPath, pCapture->pDump, pCapture->dumpSize);
+    }
+    __catch
+    {
+        free(pPath);
+        __rethrow;
+    }
+    free(pPath);
+}
+
+static void writeFile(const char* pPath, const void* pData, size_t dataSize)
+{
+    FILE*  pFile = fopen(pPath, "wb");
+    size_t bytesWritten;
+    int    closeResult;
+
+    if (!pFile)
+        __throw_msg(fileException, "Failed to create \"%s\".", pPath);
+    bytesWritten = fwrite(pData, 1, dataSize, pFile);
+    closeResult = fclose(pFile);
+    if (bytesWritten != dataSize || closeResult != 0)
+        __throw_msg(fileException, "Failed to write \"%s\".", pPath);
+}
+
+static int compareEntries(const void* pv1, const void* pv2)
+{
+    const CrashDedupEntry* p1 = (const CrashDedupEntry*)pv1;
+    const CrashDedupEntry* p2 = (const CrashDedupEntry*)pv2;
+
+    if ((p1->exceptionCode != noException) != (p2->exceptionCode != noException))
+        return p1->exceptionCode != noException ? 1 : -1;
+    if (p1->exceptionCode == noException && p1->signature.hash != p2->signature.hash)
+        return p1->signature.hash < p2->signature.hash ? -1 : 1;
+    return compareFilenames(pv1, pv2);
+}
+
+static int compareFilenames(const void* pv1, const void* pv2)
+{
+    const CrashDedupEntry* p1 = (const CrashDedupEntry*)pv1;
+    const CrashDedupEntry* p2 = (const CrashDedupEntry*)pv2;
+
+    /* Dumps from a log are listed in the order they appear rather than by the text of their line numbers. */
+    if (p1->lineNumber != p2->lineNumber)
+        return p1->lineNumber < p2->lineNumber ? -1 : 1;
+    return strcmp(p1->pFilename, p2->pFilename);
+}
+
+
+void CrashDedup_Uninit(CrashDedup* pThis)
+{
+    size_t i;
+
+    if (!pThis)
+        return;
+    for (i = 0 ; i < pThis->entryCount ; i++)
+        free(pThis->pEntries[i].pFilename);
+    free(pThis->pEntries);
+    CrashLog_Close(&pThis->log);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+
+void CrashDedup_PrintReport(CrashDedup* pThis)
+{
+    SignatureGroup* pGroups = NULL;
+    size_t          groupCount = 0;
+    size_t          failedCount = countFailedEntries(pThis);
+    size_t          i;
+
+    pGroups = buildSortedGroups(pThis, &groupCount);
+    printf("Found %lu unique crash signature(s) in %lu dump(s).\n",
+           (unsigned long)groupCount, (unsigned long)(pThis->entryCount - failedCount));
+    for (i = 0 ; i < groupCount ; i++)
+        printGroup(pThis, &pGroups[i]);
+    free(pGroups);
+    printFailedEntries(pThis, failedCount);
+}
+
+static size_t countFailedEntries(CrashDedup* pThis)
+{
+    size_t count = 0;
+    size_t i;
+
+    for (i = 0 ; i < pThis->entryCount ; i++)
+    {
+        if (pThis->pEntries[i].exceptionCode != noException)
+            count++;
+    }
+    return count;
+}
+
+static SignatureGroup* buildSortedGroups(CrashDedup* pThis, size_t* pGroupCount)
+{
+    size_t          loadedCount = pThis->entryCount - countFailedEntries(pThis);
+    SignatureGroup* pGroups = NULL;
+    size_t          groupCount = 0;
+    size_t          i;
+
+    *pGroupCount = 0;
+    if (loadedCount == 0)
+        return NULL;
+    pGroups = malloc(loadedCount * sizeof(*pGroups));
+    if (!pGroups)
+        return NULL;
+
+    for (i = 0 ; i < loadedCount ; i++)
+    {
+        if (i == 0 || pThis->pEntries[i].signature.hash != pThis->pEntries[i - 1].signature.hash)
+        {
+            pGroups[groupCount].firstEntry = i;
+            pGroups[groupCount].entryCount = 0;
+            groupCount++;
+        }
+        pGroups[groupCount - 1].entryCount++;
+    }
+
+    /* Most frequent crashes are listed first. */
+    qsort(pGroups, groupCount, sizeof(*pGroups), compareGroups);
+    *pGroupCount = groupCount;
+    return pGroups;
+}
+
+static int compareGroups(const void* pv1, const void* pv2)
+{
+    const SignatureGroup* p1 = (const SignatureGroup*)pv1;
+    const SignatureGroup* p2 = (const SignatureGroup*)pv2;
+
+    if (p1->entryCount != p2->entryCount)
+        return p1->entryCount > p2->entryCount ? -1 : 1;
+    return p1->firstEntry < p2->firstEntry ? -1 : 1;
+}
+
+static void printGroup(CrashDedup* pThis, const SignatureGroup* pGroup)
+{
+    const CrashSignature* pSignature = &pThis->pEntries[pGroup->firstEntry].signature;
+    size_t                i;
+
+    printf("\nSignature %08lx%08lx: %lu dump(s)\n",
+           (unsigned long)(pSignature->hash >> 32), (unsigned long)(pSignature->hash & 0xFFFFFFFF),
+           (unsigned long)pGroup->entryCount);
+    printf("  Fault: %s  HFSR: 0x%08X  CFSR: 0x%08X\n",
+           exceptionName(pSignature->faultStatus.exceptionNumber),
+           pSignature->faultStatus.hardFaultStatus,
+           pSignature->faultStatus.configurableFaultStatus);
+    printf("  PC: 0x%08X\n", pSignature->pc);
+    for (i = 0 ; i < pSignature->frameCount ; i++)
+        printf("  #%lu: 0x%08X\n", (unsigned long)(i + 1), pSignature->frames[i]);
+    for (i = 0 ; i < pGroup->entryCount ; i++)
+        printf("    %s\n", pThis->pEntries[pGroup->firstEntry + i].pFilename);
+}
+
+static const char* exceptionName(uint32_t exceptionNumber)
+{
+    switch (exceptionNumber)
+    {
+    case 0:
+        return "None";
+    case 2:
+        return "NMI";
+    case 3:
+        return "HardFault";
+    case 4:
+        return "MemManage";
+    case 5:
+        return "BusFault";
+    case 6:
+        return "UsageFault";
+    case 12:
+        return "DebugMonitor";
+    default:
+        return "Other";
+    }
+}
+
+static void printFailedEntries(CrashDedup* pThis, size_t failedCount)
+{
+    size_t i;
+
+    if (failedCount == 0)
+        return;
+    printf("\nFailed to load %lu dump(s):\n", (unsigned long)failedCount);
+    for (i = pThis->entryCount - failedCount ; i < pThis->entryCount ; i++)
+    {
+        const CrashDedupEntry* pEntry = &pThis->pEntries[i];
+        if (pEntry->exceptionMessage[0])
+            printf("    %s: %s\n", pEntry->pFilename, pEntry->exceptionMessage);
+        else
+            printf("    %s: Encountered unexpected error: %d\n", pEntry->pFilename, pEntry->exceptionCode);
+    }
+}
@@ -0,0 +1,157 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <CrashLog.h>
+#include <MallocFailureInject.h>
+
+
+typedef struct Scanner
+{
+    const char*   pLog;
+    size_t        logSize;
+    size_t        lineStart;
+    size_t        lineLength;
+    size_t        nextLineStart;
+    unsigned long lineNumber;
+} Scanner;
+
+
+static void indexDumps(CrashLog* pThis);
+static void initScanner(Scanner* pScanner, const char* pLog, size_t logSize);
+static int nextLine(Scanner* pScanner);
+static void addDump(CrashLog* pThis, size_t offset, size_t size, unsigned long lineNumber);
+
+
+__throws void CrashLog_Open(CrashLog* pThis, const char* pLogFilename)
+{
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->mapping = MappedFile_Open(pLogFilename, MAPPED_FILE_READ_ONLY);
+    __try
+    {
+        indexDumps(pThis);
+    }
+    __catch
+    {
+        CrashLog_Close(pThis);
+        __rethrow;
+    }
+}
+
+static void indexDumps(CrashLog* pThis)
+{
+    Scanner       scanner;
+    int           isInDump = FALSE;
+    size_t        dumpStart = 0;
+    unsigned long dumpLineNumber = 0;
+
+    /* Only the framing is checked here.  Decoding the hex is left to CrashLog_DecodeDump() so that it can be spread
+       across threads. */
+    initScanner(&scanner, pThis->mapping.pData, pThis->mapping.size);
+    while (nextLine(&scanner))
+    {
+        switch (CrashCapture_ClassifyLine(scanner.pLog + scanner.lineStart, scanner.lineLength))
+        {
+        case CRASH_CAPTURE_LINE_SIGNATURE:
+            if (!isInDump)
+            {
+                isInDump = TRUE;
+                dumpStart = scanner.lineStart;
+                dumpLineNumber = scanner.lineNumber;
+            }
+            break;
+        case CRASH_CAPTURE_LINE_BLANK:
+        case CRASH_CAPTURE_LINE_HEX:
+            break;
+        case CRASH_CAPTURE_LINE_END:
+            if (isInDump)
+                addDump(pThis, dumpStart, scanner.nextLineStart - dumpStart, dumpLineNumber);
+            isInDump = FALSE;
+            break;
+        case CRASH_CAPTURE_LINE_BANNER:
+        case CRASH_CAPTURE_LINE_OTHER:
+        default:
+            isInDump = FALSE;
+            break;
+        }
+    }
+}
+
+static void initScanner(Scanner* pScanner, const char* pLog, size_t logSize)
+{
+    memset(pScanner, 0, sizeof(*pScanner));
+    pScanner->pLog = pLog;
+    pScanner->logSize = logSize;
+}
+
+static int nextLine(Scanner* pScanner)
+{
+    const char* pNewLine;
+
+    if (pScanner->nextLineStart >= pScanner->logSize)
+        return FALSE;
+    pScanner->lineStart = pScanner->nextLineStart;
+    pNewLine = memchr(pScanner->pLog + pScanner->lineStart, '\n', pScanner->logSize - pScanner->lineStart);
+    if (pNewLine)
+    {
+        pScanner->lineLength = pNewLine - (pScanner->pLog + pScanner->lineStart);
+        pScanner->nextLineStart = pScanner->lineStart + pScanner->lineLength + 1;
+    }
+    else
+    {
+        pScanner->lineLength = pScanner->logSize - pScanner->lineStart;
+        pScanner->nextLineStart = pScanner->logSize;
+    }
+    pScanner->lineNumber++;
+    return TRUE;
+}
+
+static void addDump(CrashLog* pThis, size_t offset, size_t size, unsigned long lineNumber)
+{
+    CrashLogDump* pRealloc = realloc(pThis->pDumps, (pThis->dumpCount + 1) * sizeof(*pThis->pDumps));
+    CrashLogDump* pDump;
+
+    if (!pRealloc)
+        __throw(outOfMemoryException);
+    pThis->pDumps = pRealloc;
+    pDump = &pThis->pDumps[pThis->dumpCount++];
+    pDump->offset = offset;
+    pDump->size = size;
+    pDump->lineNumber = lineNumber;
+}
+
+
+void CrashLog_Close(CrashLog* pThis)
+{
+    if (!pThis)
+        return;
+    free(pThis->pDumps);
+    MappedFile_Close(&pThis->mapping);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+
+__throws void CrashLog_DecodeDump(const CrashLog* pThis, size_t dumpIndex, CrashCapture* pCapture)
+{
+    const CrashLogDump* pDump = &pThis->pDumps[dumpIndex];
+    Scanner             scanner;
+
+    initScanner(&scanner, (const char*)pThis->mapping.pData + pDump->offset, pDump->size);
+    while (nextLine(&scanner))
+    {
+        if (CrashCapture_HandleLine(pCapture, scanner.pLog + scanner.lineStart, scanner.lineLength))
+            return;
+    }
+    __throw_msg(fileFormatException, "The dump at line %lu of the log didn't end as expected.", pDump->lineNumber);
+}
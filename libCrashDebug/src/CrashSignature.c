@@ -0,0 +1,144 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <common.h>
+#include <CrashSignature.h>
+#include <MemorySim.h>
+
+
+/* Number of words above the crashing SP to scan for return addresses. */
+#define MAX_STACK_SCAN_WORDS 1024
+
+/* The valid address bits in CFSR only indicate whether MMFAR/BFAR were latched and vary between otherwise identical
+   crashes so they don't participate in the signature. */
+#define CFSR_MMARVALID  (1 << 7)
+#define CFSR_BFARVALID  (1 << 15)
+
+#define FNV1A_64_OFFSET_BASIS   0xcbf29ce484222325ULL
+#define FNV1A_64_PRIME          0x100000001b3ULL
+
+
+static void addFrame(CrashSignature* pSignature, uint32_t returnAddress);
+static void scanStackForReturnAddresses(CrashSignature* pSignature, IMemory* pMem, uint32_t sp);
+static int isReturnAddress(IMemory* pMem, uint32_t value);
+static int isInReadOnlyRegion(IMemory* pMem, uint32_t address, uint32_t size);
+static int isPrecededByBranchWithLink(IMemory* pMem, uint32_t returnAddress);
+static uint64_t hashSignature(const CrashSignature* pSignature);
+static uint64_t hashWord(uint64_t hash, uint32_t word);
+
+
+CrashSignature CrashSignature_Calculate(IMemory* pMem, const RegisterContext* pContext)
+{
+    CrashSignature signature;
+
+    memset(&signature, 0, sizeof(signature));
+    signature.faultStatus = mriPlatform_GetFaultStatus(pMem, pContext);
+    signature.pc = pContext->R[PC] & ~1;
+    if (isReturnAddress(pMem, pContext->R[LR]))
+        addFrame(&signature, pContext->R[LR]);
+    scanStackForReturnAddresses(&signature, pMem, pContext->R[SP]);
+    signature.hash = hashSignature(&signature);
+
+    return signature;
+}
+
+static void addFrame(CrashSignature* pSignature, uint32_t returnAddress)
+{
+    uint32_t address = returnAddress & ~1;
+
+    if (pSignature->frameCount >= ARRAY_SIZE(pSignature->frames))
+        return;
+    /* A stale LR which was also pushed to the stack shouldn't show up twice. */
+    if (pSignature->frameCount > 0 && pSignature->frames[pSignature->frameCount - 1] == address)
+        return;
+    pSignature->frames[pSignature->frameCount++] = address;
+}
+
+static void scanStackForReturnAddresses(CrashSignature* pSignature, IMemory* pMem, uint32_t sp)
+{
+    uint32_t i;
+
+    for (i = 0 ; i < MAX_STACK_SCAN_WORDS && pSignature->frameCount < ARRAY_SIZE(pSignature->frames) ; i++)
+    {
+        uint32_t value;
+
+        if (!IMemory_TryRead32(pMem, sp + i * sizeof(uint32_t), &value))
+            return;
+        if (isReturnAddress(pMem, value))
+            addFrame(pSignature, value);
+    }
+}
+
+static int isReturnAddress(IMemory* pMem, uint32_t value)
+{
+    uint32_t address = value & ~1;
+
+    /* Return addresses on Cortex-M always have the Thumb bit set and point just past a BL or BLX in FLASH. */
+    if ((value & 1) == 0 || address < 4)
+        return FALSE;
+    if (!isInReadOnlyRegion(pMem, address - 4, 4))
+        return FALSE;
+    return isPrecededByBranchWithLink(pMem, address);
+}
+
+static int isInReadOnlyRegion(IMemory* pMem, uint32_t address, uint32_t size)
+{
+    uint32_t baseAddress;
+    uint32_t regionSize;
+
+    if (!MemorySim_FindReadOnlyRegion(pMem, address, &baseAddress, &regionSize))
+        return FALSE;
+    return (uint64_t)address + size <= (uint64_t)baseAddress + regionSize;
+}
+
+static int isPrecededByBranchWithLink(IMemory* pMem, uint32_t returnAddress)
+{
+    const uint8_t* pCode = MemorySim_MapSimulatedAddressToHostAddressForRead(pMem, returnAddress - 4, 4);
+    uint16_t       firstHalfWord = pCode[0] | (pCode[1] << 8);
+    uint16_t       secondHalfWord = pCode[2] | (pCode[3] << 8);
+
+    /* 32-bit BL <label> (T1 encoding). */
+    if ((firstHalfWord & 0xF800) == 0xF000 && (secondHalfWord & 0xD000) == 0xD000)
+        return TRUE;
+    /* 16-bit BLX <Rm>. */
+    if ((secondHalfWord & 0xFF87) == 0x4780)
+        return TRUE;
+    return FALSE;
+}
+
+static uint64_t hashSignature(const CrashSignature* pSignature)
+{
+    uint64_t hash = FNV1A_64_OFFSET_BASIS;
+    uint32_t i;
+
+    hash = hashWord(hash, pSignature->faultStatus.exceptionNumber);
+    hash = hashWord(hash, pSignature->faultStatus.hardFaultStatus);
+    hash = hashWord(hash, pSignature->faultStatus.configurableFaultStatus & ~(CFSR_MMARVALID | CFSR_BFARVALID));
+    hash = hashWord(hash, pSignature->pc);
+    for (i = 0 ; i < pSignature->frameCount ; i++)
+        hash = hashWord(hash, pSignature->frames[i]);
+    return hash;
+}
+
+static uint64_t hashWord(uint64_t hash, uint32_t word)
+{
+    int i;
+
+    /* Hash in little endian byte order so that signatures match across hosts. */
+    for (i = 0 ; i < 4 ; i++)
+    {
+        hash ^= (word >> (8 * i)) & 0xFF;
+        hash *= FNV1A_64_PRIME;
+    }
+    return hash;
+}
@@ -0,0 +1,125 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <common.h>
+#include <Crc32.h>
+#include <CrcPackets.h>
+#include <MemorySim.h>
+
+
+#define CRC_PREFIX          "qCRC:"
+#define CRC_PREFIX_LENGTH   (sizeof(CRC_PREFIX) - 1)
+
+static int parseRequest(const char* pCurr, const char* pEnd, uint32_t* pAddress, uint32_t* pLength);
+static int parseHexField(const char** ppCurr, const char* pEnd, char separator, uint32_t* pValue);
+static int calculateCrc(IMemory* pMemory, uint32_t address, uint32_t length, uint32_t* pCrc);
+static int calculateCrcOfSpans(IMemory* pMemory, uint32_t address, uint32_t length, uint32_t* pCrc);
+
+
+int CrcPackets_Handle(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                      char* pResponse, size_t responseSize)
+{
+    uint32_t address = 0;
+    uint32_t length = 0;
+    uint32_t crc = 0;
+
+    if (requestLength < CRC_PREFIX_LENGTH || 0 != memcmp(pRequest, CRC_PREFIX, CRC_PREFIX_LENGTH))
+        return FALSE;
+
+    if (!parseRequest(pRequest + CRC_PREFIX_LENGTH, pRequest + requestLength, &address, &length))
+        snprintf(pResponse, responseSize, "E01");
+    else if (!calculateCrc((IMemory*)pHandlerObject, address, length, &crc))
+        snprintf(pResponse, responseSize, "E02");
+    else
+        snprintf(pResponse, responseSize, "C%08x", crc);
+    return TRUE;
+}
+
+static int parseRequest(const char* pCurr, const char* pEnd, uint32_t* pAddress, uint32_t* pLength)
+{
+    return parseHexField(&pCurr, pEnd, ',', pAddress) && parseHexField(&pCurr, pEnd, '\0', pLength);
+}
+
+static int parseHexField(const char** ppCurr, const char* pEnd, char separator, uint32_t* pValue)
+{
+    const char* pCurr = *ppCurr;
+    uint32_t    value = 0;
+
+    if (pCurr >= pEnd || *pCurr == separator)
+        return FALSE;
+    while (pCurr < pEnd && *pCurr != separator)
+    {
+        char digit = *pCurr++;
+
+        if (digit >= '0' && digit <= '9')
+            value = (value << 4) | (digit - '0');
+        else if (digit >= 'a' && digit <= 'f')
+            value = (value << 4) | (digit - 'a' + 10);
+        else if (digit >= 'A' && digit <= 'F')
+            value = (value << 4) | (digit - 'A' + 10);
+        else
+            return FALSE;
+    }
+    /* The last field is terminated by the end of the request rather than a separator. */
+    if (separator != '\0')
+    {
+        if (pCurr >= pEnd)
+            return FALSE;
+        pCurr++;
+    }
+    *ppCurr = pCurr;
+    *pValue = value;
+    return TRUE;
+}
+
+static int calculateCrc(IMemory* pMemory, uint32_t address, uint32_t length, uint32_t* pCrc)
+{
+    volatile int result = FALSE;
+
+    /* Lazily loaded regions can fail to load part way through the calculation. */
+    __try
+    {
+        result = calculateCrcOfSpans(pMemory, address, length, pCrc);
+    }
+    __catch
+    {
+        clearExceptionCode();
+        return FALSE;
+    }
+    return result;
+}
+
+static int calculateCrcOfSpans(IMemory* pMemory, uint32_t address, uint32_t length, uint32_t* pCrc)
+{
+    uint32_t crc = CRC32_GDB_INITIAL;
+
+    if ((uint64_t)address + length > 0x100000000ULL)
+        return FALSE;
+    while (length > 0)
+    {
+        uint32_t    spanSize = 0;
+        const void* pSpan = MemorySim_MapSimulatedAddressToHostSpan(pMemory, address, &spanSize);
+
+        /* Let GDB fall back to reading memory itself so that it can report the unreadable address. */
+        if (!pSpan)
+            return FALSE;
+        if (spanSize > length)
+            spanSize = length;
+        crc = Crc32_GdbUpdate(crc, pSpan, spanSize);
+        address += spanSize;
+        length -= spanSize;
+    }
+    *pCrc = crc;
+    return TRUE;
+}
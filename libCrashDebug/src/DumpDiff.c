@@ -0,0 +1,222 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <DumpDiff.h>
+#include <DumpLoad.h>
+#include <MallocFailureInject.h>
+#include <MemorySim.h>
+#include <printfSpy.h>
+
+
+/* Blocks are compared with memcmp(), which the C library vectorizes, and only blocks which differ are scanned a byte
+   at a time to find the exact ranges. */
+#define BLOCK_SIZE 64
+
+
+static void compareRegion(DumpDiff* pThis, IMemory* pMemory2, const MemoryRegionInfo* pRegion);
+static void compareSpans(DumpDiff* pThis, uint32_t address, const uint8_t* p1, const uint8_t* p2, uint32_t size);
+static void compareBytes(DumpDiff* pThis, uint32_t address, const uint8_t* p1, const uint8_t* p2, uint32_t size);
+static void addDifference(DumpDiff* pThis, uint32_t address, uint32_t size);
+static void growRangesIfNeeded(DumpDiff* pThis);
+static int compareRanges(const void* pv1, const void* pv2);
+
+
+__throws void DumpDiff_Compare(DumpDiff* pThis, IMemory* pMemory1, IMemory* pMemory2)
+{
+    size_t regionCount = MemorySim_GetRegionCount(pMemory1);
+    size_t i;
+
+    memset(pThis, 0, sizeof(*pThis));
+    __try
+    {
+        for (i = 0 ; i < regionCount ; i++)
+        {
+            MemoryRegionInfo info = MemorySim_GetRegionInfo(pMemory1, i);
+            if (!info.isAlias)
+                compareRegion(pThis, pMemory2, &info);
+        }
+    }
+    __catch
+    {
+        DumpDiff_Uninit(pThis);
+        __rethrow;
+    }
+    qsort(pThis->pRanges, pThis->rangeCount, sizeof(*pThis->pRanges), compareRanges);
+}
+
+static void compareRegion(DumpDiff* pThis, IMemory* pMemory2, const MemoryRegionInfo* pRegion)
+{
+    uint64_t endAddress = (uint64_t)pRegion->baseAddress + pRegion->size;
+    uint64_t address = pRegion->baseAddress;
+
+    while (address < endAddress)
+    {
+        uint32_t       offset = (uint32_t)(address - pRegion->baseAddress);
+        uint32_t       spanSize = 0;
+        const uint8_t* p2 = MemorySim_MapSimulatedAddressToHostSpan(pMemory2, (uint32_t)address, &spanSize);
+
+        if (!p2)
+        {
+            uint32_t nextAddress;
+
+            /* Jump straight over the gap to where the other dump has memory mapped again. */
+            if (!MemorySim_FindNextMappedAddress(pMemory2, (uint32_t)address, &nextAddress))
+                return;
+            address = nextAddress;
+            continue;
+        }
+        if (spanSize > endAddress - address)
+            spanSize = (uint32_t)(endAddress - address);
+        compareSpans(pThis, (uint32_t)address, pRegion->pData + offset, p2, spanSize);
+        address += spanSize;
+    }
+}
+
+static void compareSpans(DumpDiff* pThis, uint32_t address, const uint8_t* p1, const uint8_t* p2, uint32_t size)
+{
+    pThis->bytesCompared += size;
+    /* FLASH regions shared between the two dumps are identical by definition. */
+    if (p1 == p2)
+        return;
+
+    while (size > 0)
+    {
+        uint32_t blockSize = size < BLOCK_SIZE ? size : BLOCK_SIZE;
+
+        if (0 != memcmp(p1, p2, blockSize))
+            compareBytes(pThis, address, p1, p2, blockSize);
+        address += blockSize;
+        p1 += blockSize;
+        p2 += blockSize;
+        size -= blockSize;
+    }
+}
+
+static void compareBytes(DumpDiff* pThis, uint32_t address, const uint8_t* p1, const uint8_t* p2, uint32_t size)
+{
+    uint32_t i = 0;
+
+    while (i < size)
+    {
+        uint32_t start;
+
+        if (p1[i] == p2[i])
+        {
+            i++;
+            continue;
+        }
+        start = i;
+        while (i < size && p1[i] != p2[i])
+            i++;
+        addDifference(pThis, address + start, i - start);
+    }
+}
+
+static void addDifference(DumpDiff* pThis, uint32_t address, uint32_t size)
+{
+    DumpDiffRange* pLast = pThis->rangeCount ? &pThis->pRanges[pThis->rangeCount - 1] : NULL;
+
+    pThis->bytesDiffering += size;
+    if (pLast && address >= pLast->address && address - (pLast->address + pLast->size) < DUMP_DIFF_COALESCE_GAP)
+    {
+        pLast->size = address + size - pLast->address;
+        return;
+    }
+    growRangesIfNeeded(pThis);
+    pThis->pRanges[pThis->rangeCount].address = address;
+    pThis->pRanges[pThis->rangeCount].size = size;
+    pThis->rangeCount++;
+}
+
+static void growRangesIfNeeded(DumpDiff* pThis)
+{
+    size_t         newCapacity;
+    DumpDiffRange* pRealloc;
+
+    if (pThis->rangeCount < pThis->rangeCapacity)
+        return;
+    newCapacity = pThis->rangeCapacity ? pThis->rangeCapacity * 2 : 64;
+    pRealloc = realloc(pThis->pRanges, newCapacity * sizeof(*pThis->pRanges));
+    if (!pRealloc)
+        __throw(outOfMemoryException);
+    pThis->pRanges = pRealloc;
+    pThis->rangeCapacity = newCapacity;
+}
+
+static int compareRanges(const void* pv1, const void* pv2)
+{
+    const DumpDiffRange* p1 = (const DumpDiffRange*)pv1;
+    const DumpDiffRange* p2 = (const DumpDiffRange*)pv2;
+
+    if (p1->address != p2->address)
+        return p1->address < p2->address ? -1 : 1;
+    return 0;
+}
+
+
+__throws void DumpDiff_CompareWithFile(DumpDiff* pThis, IMemory* pMemory, const char* pDumpFilename)
+{
+    IMemory* volatile pOther = NULL;
+    RegisterContext   context;
+
+    memset(pThis, 0, sizeof(*pThis));
+    __try
+    {
+        memset(&context, 0, sizeof(context));
+        pOther = MemorySim_Create();
+        /* Both dumps were taken from the same firmware so they can reference the same copy of the FLASH contents. */
+        MemorySim_ShareReadOnlyRegions(pOther, pMemory);
+        DumpLoad_FromFile(pOther, &context, pDumpFilename);
+        DumpDiff_Compare(pThis, pMemory, pOther);
+    }
+    __catch
+    {
+        MemorySim_Destroy(pOther);
+        __rethrow;
+    }
+    MemorySim_Destroy(pOther);
+}
+
+
+void DumpDiff_Uninit(DumpDiff* pThis)
+{
+    if (!pThis)
+        return;
+    free(pThis->pRanges);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+
+void DumpDiff_PrintReport(const DumpDiff* pThis, const ElfSymbols* pSymbols)
+{
+    size_t i;
+
+    printf("Found %lu differing range(s) totalling %lu byte(s) in %lu byte(s) compared.\n",
+           (unsigned long)pThis->rangeCount, (unsigned long)pThis->bytesDiffering,
+           (unsigned long)pThis->bytesCompared);
+    for (i = 0 ; i < pThis->rangeCount ; i++)
+    {
+        const DumpDiffRange* pRange = &pThis->pRanges[i];
+        const ElfSymbol*     pSymbol = pSymbols ? ElfSymbols_FindByAddress(pSymbols, pRange->address) : NULL;
+
+        if (pSymbol)
+            printf("  0x%08X - 0x%08X (%u bytes)  %s+%u\n", pRange->address, pRange->address + pRange->size - 1,
+                   pRange->size, pSymbol->pName, pRange->address - pSymbol->address);
+        else
+            printf("  0x%08X - 0x%08X (%u bytes)\n", pRange->address, pRange->address + pRange->size - 1,
+                   pRange->size);
+    }
+}
@@ -0,0 +1,178 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <common.h>
+#include <CompactDump.h>
+#include <CrashCatcher.h>
+#include <CrashCatcherDump.h>
+#include <DumpLoad.h>
+#include <DumpStream.h>
+#include <FileFailureInject.h>
+#include <GdbLogParser.h>
+#include <RegionManifest.h>
+#include <stdio.h>
+
+
+typedef enum
+{
+    GDB_LOG,
+    CRASH_CATCHER_BIN,
+    CRASH_CATCHER_HEX,
+    COMPACT_DUMP,
+    REGION_MANIFEST,
+} DumpFileType;
+
+
+static FILE* openFileAndThrowOnError(const char* pDumpFilename);
+static void loadFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream, const char* pDumpFilename);
+static DumpFileType getFileType(DumpStream* pStream);
+static int hasBinaryCrashCatcherSignature(const uint8_t* pHeader);
+static int hasHexCrashCatcherSignature(const uint8_t* pHeader);
+static int hasCompactDumpSignature(const uint8_t* pHeader);
+static int hasRegionManifestSignature(const uint8_t* pHeader);
+static uint8_t hiNibbleDigit(uint8_t byte);
+static uint8_t loNibbleDigit(uint8_t byte);
+static uint8_t nibbleDigit(uint8_t byte);
+
+
+__throws void DumpLoad_FromFile(IMemory* pMem, RegisterContext* pContext, const char* pDumpFilename)
+{
+    DumpStream stream;
+
+    if (0 == strcmp(pDumpFilename, DUMP_LOAD_STDIN_FILENAME))
+    {
+        DumpLoad_FromStream(pMem, pContext, stdin);
+        return;
+    }
+
+    /* The file is only opened once so that pipes (mkfifo or <(...) for example) work as well as regular files. */
+    DumpStream_Init(&stream, openFileAndThrowOnError(pDumpFilename));
+    __try
+        loadFromStream(pMem, pContext, &stream, pDumpFilename);
+    __catch
+    {
+        DumpStream_Close(&stream);
+        __rethrow;
+    }
+    DumpStream_Close(&stream);
+}
+
+static FILE* openFileAndThrowOnError(const char* pDumpFilename)
+{
+    FILE* pFile = fopen(pDumpFilename, "rb");
+    if (!pFile)
+        __throw_msg(fileException, "Failed to open \"%s\".", pDumpFilename);
+    return pFile;
+}
+
+__throws void DumpLoad_FromStream(IMemory* pMem, RegisterContext* pContext, FILE* pFile)
+{
+    DumpStream stream;
+
+    DumpStream_Init(&stream, pFile);
+    __try
+        loadFromStream(pMem, pContext, &stream, NULL);
+    __catch
+    {
+        DumpStream_Close(&stream);
+        __rethrow;
+    }
+    DumpStream_Close(&stream);
+}
+
+static void loadFromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream, const char* pDumpFilename)
+{
+    switch(getFileType(pStream))
+    {
+    case GDB_LOG:
+        GdbLogParse_FromStream(pMem, pContext, pStream);
+        break;
+    case CRASH_CATCHER_HEX:
+        CrashCatcherDump_ReadHexFromStream(pMem, pContext, pStream);
+        break;
+    case CRASH_CATCHER_BIN:
+        CrashCatcherDump_ReadBinaryFromStream(pMem, pContext, pStream);
+        break;
+    case COMPACT_DUMP:
+        /* Map regular files rather than copying them into the heap. */
+        if (pDumpFilename && DumpStream_GetSize(pStream) >= 0)
+        {
+            DumpStream_Close(pStream);
+            CompactDump_Read(pMem, pContext, pDumpFilename);
+        }
+        else
+        {
+            CompactDump_ReadFromStream(pMem, pContext, pStream);
+        }
+        break;
+    case REGION_MANIFEST:
+        RegionManifest_Load(pMem, pContext, pStream, pDumpFilename);
+        break;
+    }
+}
+
+static DumpFileType getFileType(DumpStream* pStream)
+{
+    uint8_t fileHeader[DUMP_STREAM_MAX_PEEK] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    DumpStream_Peek(pStream, fileHeader, sizeof(fileHeader));
+    if (hasBinaryCrashCatcherSignature(fileHeader))
+        return CRASH_CATCHER_BIN;
+    else if (hasHexCrashCatcherSignature(fileHeader))
+        return CRASH_CATCHER_HEX;
+    else if (hasCompactDumpSignature(fileHeader))
+        return COMPACT_DUMP;
+    else if (hasRegionManifestSignature(fileHeader))
+        return REGION_MANIFEST;
+    else
+        return GDB_LOG;
+}
+
+static int hasBinaryCrashCatcherSignature(const uint8_t* pHeader)
+{
+    return (pHeader[0] == CRASH_CATCHER_SIGNATURE_BYTE0 && pHeader[1] == CRASH_CATCHER_SIGNATURE_BYTE1);
+}
+
+static int hasHexCrashCatcherSignature(const uint8_t* pHeader)
+{
+    return (pHeader[0] == hiNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE0) &&
+            pHeader[1] == loNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE0) &&
+            pHeader[2] == hiNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE1) &&
+            pHeader[3] == loNibbleDigit(CRASH_CATCHER_SIGNATURE_BYTE1));
+}
+
+static int hasCompactDumpSignature(const uint8_t* pHeader)
+{
+    return 0 == memcmp(pHeader, COMPACT_DUMP_SIGNATURE, COMPACT_DUMP_SIGNATURE_SIZE);
+}
+
+static int hasRegionManifestSignature(const uint8_t* pHeader)
+{
+    return 0 == memcmp(pHeader, REGION_MANIFEST_SIGNATURE, DUMP_STREAM_MAX_PEEK);
+}
+
+static uint8_t hiNibbleDigit(uint8_t byte)
+{
+    return nibbleDigit(byte >> 4);
+}
+
+static uint8_t loNibbleDigit(uint8_t byte)
+{
+    return nibbleDigit(byte & 0xF);
+}
+
+static uint8_t nibbleDigit(uint8_t byte)
+{
+    static const uint8_t nibbleToHexDigit[] = "0123456789ABCDEF";
+    return nibbleToHexDigit[byte];
+}
@@ -0,0 +1,126 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <common.h>
+#include <DumpStream.h>
+#include <FileFailureInject.h>
+#include <string.h>
+
+
+static size_t readPeekedBytes(DumpStream* pThis, void* pBuffer, size_t size);
+
+
+void DumpStream_Init(DumpStream* pThis, FILE* pFile)
+{
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pFile = pFile;
+}
+
+void DumpStream_Close(DumpStream* pThis)
+{
+    if (pThis->pFile && pThis->pFile != stdin)
+        fclose(pThis->pFile);
+    pThis->pFile = NULL;
+}
+
+FILE* DumpStream_Detach(DumpStream* pThis)
+{
+    FILE* pFile = pThis->pFile;
+
+    pThis->pFile = NULL;
+    return pFile;
+}
+
+size_t DumpStream_Peek(DumpStream* pThis, void* pBuffer, size_t size)
+{
+    size_t bytesRead;
+
+    if (size > sizeof(pThis->peeked))
+        size = sizeof(pThis->peeked);
+    if (pThis->peekedCount < size)
+    {
+        bytesRead = fread(pThis->peeked + pThis->peekedCount, 1, size - pThis->peekedCount, pThis->pFile);
+        if (bytesRead <= size - pThis->peekedCount)
+            pThis->peekedCount += bytesRead;
+    }
+    if (size > pThis->peekedCount)
+        size = pThis->peekedCount;
+    memcpy(pBuffer, pThis->peeked, size);
+    return size;
+}
+
+size_t DumpStream_Read(DumpStream* pThis, void* pBuffer, size_t size)
+{
+    size_t peekedBytes = readPeekedBytes(pThis, pBuffer, size);
+
+    if (peekedBytes == size)
+        return size;
+    return peekedBytes + fread((uint8_t*)pBuffer + peekedBytes, 1, size - peekedBytes, pThis->pFile);
+}
+
+static size_t readPeekedBytes(DumpStream* pThis, void* pBuffer, size_t size)
+{
+    size_t available = pThis->peekedCount - pThis->peekedIndex;
+
+    if (size > available)
+        size = available;
+    memcpy(pBuffer, pThis->peeked + pThis->peekedIndex, size);
+    pThis->peekedIndex += size;
+    return size;
+}
+
+char* DumpStream_Gets(DumpStream* pThis, char* pBuffer, int size)
+{
+    int i = 0;
+
+    while (i < size - 1 && pThis->peekedIndex < pThis->peekedCount)
+    {
+        char curr = pThis->peeked[pThis->peekedIndex++];
+
+        pBuffer[i++] = curr;
+        if (curr == '\n' || i == size - 1)
+        {
+            pBuffer[i] = '\0';
+            return pBuffer;
+        }
+    }
+    if (NULL == fgets(pBuffer + i, size - i, pThis->pFile))
+    {
+        if (i == 0)
+            return NULL;
+        pBuffer[i] = '\0';
+    }
+    return pBuffer;
+}
+
+long DumpStream_Tell(DumpStream* pThis)
+{
+    long offset = ftell(pThis->pFile);
+
+    if (offset < 0)
+        return -1;
+    return offset - (long)(pThis->peekedCount - pThis->peekedIndex);
+}
+
+__throws long DumpStream_GetSize(DumpStream* pThis)
+{
+    long position = ftell(pThis->pFile);
+    long size;
+
+    /* Pipes fail the first ftell() or fseek() without having consumed any of their data. */
+    if (position < 0 || fseek(pThis->pFile, 0, SEEK_END) != 0)
+        return -1;
+    size = ftell(pThis->pFile);
+    if (fseek(pThis->pFile, position, SEEK_SET) != 0)
+        __throw_msg(fileException, "Failed to rewind the dump file.");
+    return size;
+}
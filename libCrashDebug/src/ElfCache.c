@@ -0,0 +1,633 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <ElfCache.h>
+#include <ElfLoad.h>
+#include "ElfPriv.h"
+#include <FileFailureInject.h>
+#include <MallocFailureInject.h>
+#include <MemorySim.h>
+
+#ifdef WIN32
+#include <direct.h>
+#include <process.h>
+#define createDirectory(X)  _mkdir(X)
+#define getProcessId()      _getpid()
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define createDirectory(X)  mkdir((X), 0777)
+#define getProcessId()      getpid()
+#endif
+
+
+/* Cache files start with this header, followed by entryCount ElfCacheEntry structures and then the region data. */
+#define ELF_CACHE_SIGNATURE     "CDELFC\r\n"
+#define ELF_CACHE_VERSION       2
+#define ELF_CACHE_MAX_KEY_SIZE  32
+#define ELF_CACHE_DATA_ALIGN    8
+#define ELF_CACHE_EXTENSION     ".elfcache"
+
+typedef struct ElfCacheHeader
+{
+    char     signature[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t keyType;
+    uint32_t keySize;
+    uint8_t  key[ELF_CACHE_MAX_KEY_SIZE];
+} ElfCacheHeader;
+
+typedef enum ElfCacheEntryType
+{
+    ELF_CACHE_ENTRY_READ_ONLY_REGION = 1,
+    ELF_CACHE_ENTRY_SYMBOLS = 2
+} ElfCacheEntryType;
+
+/* For ELF_CACHE_ENTRY_SYMBOLS entries, baseAddress holds the number of ElfCacheSymbol records at fileOffset.  They are
+   followed by the NUL terminated names which nameOffset indexes into. */
+typedef struct ElfCacheEntry
+{
+    uint32_t type;
+    uint32_t baseAddress;
+    uint32_t size;
+    uint32_t fileOffset;
+} ElfCacheEntry;
+
+typedef struct ElfCacheSymbol
+{
+    uint32_t nameOffset;
+    uint32_t address;
+    uint32_t size;
+} ElfCacheSymbol;
+
+typedef enum CacheKeyType
+{
+    CACHE_KEY_BUILD_ID = 1,
+    CACHE_KEY_FNV1A_HASH = 2
+} CacheKeyType;
+
+typedef struct CacheKey
+{
+    uint32_t type;
+    uint32_t size;
+    uint8_t  bytes[ELF_CACHE_MAX_KEY_SIZE];
+} CacheKey;
+
+typedef struct ElfBlob
+{
+    const uint8_t* pElf;
+    size_t         elfSize;
+} ElfBlob;
+
+/* Large enough for a cache directory path, a hex key and the extension/temporary file suffix. */
+#define ELF_CACHE_MAX_PATH 1024
+
+
+static int isElf32Header(const ElfBlob* pBlob);
+static CacheKey calculateCacheKey(const ElfBlob* pBlob);
+static int findBuildIdInProgramHeaders(const ElfBlob* pBlob, CacheKey* pKey);
+static int findBuildIdInSectionHeaders(const ElfBlob* pBlob, CacheKey* pKey);
+static const void* fetchBytes(const ElfBlob* pBlob, uint32_t offset, uint32_t size);
+static int findBuildIdInNotes(const uint8_t* pNotes, uint32_t notesSize, CacheKey* pKey);
+static uint32_t alignUp(uint32_t value, uint32_t alignment);
+static CacheKey hashWholeElf(const ElfBlob* pBlob);
+static int buildCacheFilename(char* pBuffer, size_t bufferSize, const char* pDirectory, const CacheKey* pKey);
+static int loadFromCacheFile(IMemory* pMemory, ElfSymbols* pSymbols, const char* pFilename, const CacheKey* pKey,
+                             MappedFile* pMapping);
+static int isValidCacheImage(const MappedFile* pMapping, const CacheKey* pKey);
+static int isValidSymbolsEntry(const uint8_t* pImage, const ElfCacheEntry* pEntry);
+static void createRegionsFromCacheImage(IMemory* pMemory, MappedFile* pMapping);
+static void loadSymbolsFromCacheImage(ElfSymbols* pSymbols, const MappedFile* pMapping);
+static void loadSymbolsFromCacheEntry(ElfSymbols* pSymbols, const uint8_t* pImage, const ElfCacheEntry* pEntry);
+static void parseSymbolsIgnoringErrors(ElfSymbols* pSymbols, const void* pElf, size_t elfSize);
+static uint32_t calculateSymbolStringsSize(const ElfSymbols* pSymbols);
+static void writeCacheFileIgnoringErrors(IMemory* pMemory, size_t firstRegion, const ElfSymbols* pSymbols,
+                                         const char* pDirectory, const char* pFilename, const CacheKey* pKey);
+static void writeCacheFile(FILE* pFile, IMemory* pMemory, size_t firstRegion, const ElfSymbols* pSymbols,
+                           const CacheKey* pKey);
+static void writeSymbols(FILE* pFile, const ElfSymbols* pSymbols, uint32_t stringsSize);
+static void writeAndThrowOnError(FILE* pFile, const void* pData, size_t size);
+static void writePaddingAndThrowOnError(FILE* pFile, uint32_t currentOffset);
+
+
+__throws MappedFile ElfCache_Load(IMemory* pMemory, ElfSymbols* pSymbols, const char* pCacheDirectory,
+                                  const void* pElf, size_t elfSize)
+{
+    ElfBlob    blob = { pElf, elfSize };
+    MappedFile mapping = { NULL, 0 };
+    ElfSymbols symbols;
+    CacheKey   key;
+    size_t     firstRegion;
+    char       filename[ELF_CACHE_MAX_PATH];
+
+    if (pSymbols)
+        memset(pSymbols, 0, sizeof(*pSymbols));
+
+    /* Let ElfLoad_FromMemory() report the appropriate error for anything that isn't a 32-bit ELF file. */
+    if (!isElf32Header(&blob))
+    {
+        ElfLoad_FromMemory(pMemory, pElf, elfSize);
+        return mapping;
+    }
+
+    key = calculateCacheKey(&blob);
+    if (!buildCacheFilename(filename, sizeof(filename), pCacheDirectory, &key))
+    {
+        ElfLoad_FromMemory(pMemory, pElf, elfSize);
+        return mapping;
+    }
+    if (loadFromCacheFile(pMemory, pSymbols, filename, &key, &mapping))
+        return mapping;
+
+    firstRegion = MemorySim_GetRegionCount(pMemory);
+    ElfLoad_FromMemory(pMemory, pElf, elfSize);
+    /* The symbols are always parsed on a miss so that the cache file can hold them for later sessions. */
+    parseSymbolsIgnoringErrors(&symbols, pElf, elfSize);
+    writeCacheFileIgnoringErrors(pMemory, firstRegion, &symbols, pCacheDirectory, filename, &key);
+    if (pSymbols)
+        *pSymbols = symbols;
+    else
+        ElfSymbols_Uninit(&symbols);
+    return mapping;
+}
+
+static int isElf32Header(const ElfBlob* pBlob)
+{
+    const unsigned char expectedIdent[4] = { ELFMAG0, ELFMAG1, ELFMAG2, ELFMAG3 };
+    const Elf32_Ehdr*   pHeader = (const Elf32_Ehdr*)pBlob->pElf;
+
+    return pBlob->elfSize >= sizeof(*pHeader) &&
+           memcmp(pHeader->e_ident, expectedIdent, sizeof(expectedIdent)) == 0 &&
+           pHeader->e_ident[EI_CLASS] == ELFCLASS32 &&
+           pHeader->e_ident[EI_DATA] == ELFDATA2LSB;
+}
+
+static CacheKey calculateCacheKey(const ElfBlob* pBlob)
+{
+    CacheKey key;
+
+    memset(&key, 0, sizeof(key));
+    if (findBuildIdInProgramHeaders(pBlob, &key) || findBuildIdInSectionHeaders(pBlob, &key))
+        return key;
+    return hashWholeElf(pBlob);
+}
+
+static int findBuildIdInProgramHeaders(const ElfBlob* pBlob, CacheKey* pKey)
+{
+    const Elf32_Ehdr* pHeader = (const Elf32_Ehdr*)pBlob->pElf;
+    uint32_t          offset = pHeader->e_phoff;
+    Elf32_Half        i;
+
+    if (pHeader->e_phoff == 0 || pHeader->e_phentsize < sizeof(Elf32_Phdr))
+        return 0;
+    for (i = 0 ; i < pHeader->e_phnum ; i++, offset += pHeader->e_phentsize)
+    {
+        const Elf32_Phdr* pPgmHeader = fetchBytes(pBlob, offset, sizeof(*pPgmHeader));
+        const uint8_t*    pNotes = NULL;
+
+        if (!pPgmHeader)
+            return 0;
+        if (pPgmHeader->p_type != PT_NOTE)
+            continue;
+        pNotes = fetchBytes(pBlob, pPgmHeader->p_offset, pPgmHeader->p_filesz);
+        if (pNotes && findBuildIdInNotes(pNotes, pPgmHeader->p_filesz, pKey))
+            return 1;
+    }
+    return 0;
+}
+
+static int findBuildIdInSectionHeaders(const ElfBlob* pBlob, CacheKey* pKey)
+{
+    const Elf32_Ehdr* pHeader = (const Elf32_Ehdr*)pBlob->pElf;
+    uint32_t          offset = pHeader->e_shoff;
+    Elf32_Half        i;
+
+    if (pHeader->e_shoff == 0 || pHeader->e_shentsize < sizeof(Elf32_Shdr))
+        return 0;
+    for (i = 0 ; i < pHeader->e_shnum ; i++, offset += pHeader->e_shentsize)
+    {
+        const Elf32_Shdr* pSectionHeader = fetchBytes(pBlob, offset, sizeof(*pSectionHeader));
+        const uint8_t*    pNotes = NULL;
+
+        if (!pSectionHeader)
+            return 0;
+        if (pSectionHeader->sh_type != SHT_NOTE)
+            continue;
+        pNotes = fetchBytes(pBlob, pSectionHeader->sh_offset, pSectionHeader->sh_size);
+        if (pNotes && findBuildIdInNotes(pNotes, pSectionHeader->sh_size, pKey))
+            return 1;
+    }
+    return 0;
+}
+
+static const void* fetchBytes(const ElfBlob* pBlob, uint32_t offset, uint32_t size)
+{
+    if ((uint64_t)offset + size > pBlob->elfSize)
+        return NULL;
+    return pBlob->pElf + offset;
+}
+
+static int findBuildIdInNotes(const uint8_t* pNotes, uint32_t notesSize, CacheKey* pKey)
+{
+    static const char gnuName[4] = "GNU";
+
+    while (notesSize >= sizeof(Elf32_Nhdr))
+    {
+        Elf32_Nhdr     noteHeader;
+        const uint8_t* pName = pNotes + sizeof(noteHeader);
+        uint64_t       noteSize;
+
+        memcpy(&noteHeader, pNotes, sizeof(noteHeader));
+        noteSize = (uint64_t)sizeof(noteHeader) + alignUp(noteHeader.n_namesz, 4) + alignUp(noteHeader.n_descsz, 4);
+        if (noteHeader.n_namesz > notesSize || noteHeader.n_descsz > notesSize || noteSize > notesSize)
+            return 0;
+        if (noteHeader.n_type == NT_GNU_BUILD_ID &&
+            noteHeader.n_namesz == sizeof(gnuName) && memcmp(pName, gnuName, sizeof(gnuName)) == 0 &&
+            noteHeader.n_descsz > 0 && noteHeader.n_descsz <= sizeof(pKey->bytes))
+        {
+            pKey->type = CACHE_KEY_BUILD_ID;
+            pKey->size = noteHeader.n_descsz;
+            memcpy(pKey->bytes, pName + alignUp(noteHeader.n_namesz, 4), noteHeader.n_descsz);
+            return 1;
+        }
+        pNotes += noteSize;
+        notesSize -= (uint32_t)noteSize;
+    }
+    return 0;
+}
+
+static uint32_t alignUp(uint32_t value, uint32_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static CacheKey hashWholeElf(const ElfBlob* pBlob)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    CacheKey key;
+    size_t   i;
+
+    for (i = 0 ; i < pBlob->elfSize ; i++)
+    {
+        hash ^= pBlob->pElf[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    memset(&key, 0, sizeof(key));
+    key.type = CACHE_KEY_FNV1A_HASH;
+    key.size = sizeof(hash);
+    for (i = 0 ; i < sizeof(hash) ; i++)
+        key.bytes[i] = (uint8_t)(hash >> (8 * (sizeof(hash) - 1 - i)));
+    return key;
+}
+
+static int buildCacheFilename(char* pBuffer, size_t bufferSize, const char* pDirectory, const CacheKey* pKey)
+{
+    size_t   directoryLength = strlen(pDirectory);
+    size_t   offset;
+    uint32_t i;
+    int      result;
+
+    result = snprintf(pBuffer, bufferSize, "%s%s%s", pDirectory,
+                      (directoryLength > 0 && pDirectory[directoryLength - 1] == '/') ? "" : "/",
+                      pKey->type == CACHE_KEY_BUILD_ID ? "" : "fnv1a-");
+    if (result < 0 || (size_t)result >= bufferSize)
+        return 0;
+    offset = result;
+    for (i = 0 ; i < pKey->size ; i++)
+    {
+        result = snprintf(pBuffer + offset, bufferSize - offset, "%02x", pKey->bytes[i]);
+        if (result < 0 || (size_t)result >= bufferSize - offset)
+            return 0;
+        offset += result;
+    }
+    result = snprintf(pBuffer + offset, bufferSize - offset, "%s", ELF_CACHE_EXTENSION);
+    /* Leave room for the temporary file suffix used while writing a new cache file. */
+    return result >= 0 && (size_t)result + 32 < bufferSize - offset;
+}
+
+static int loadFromCacheFile(IMemory* pMemory, ElfSymbols* pSymbols, const char* pFilename, const CacheKey* pKey,
+                             MappedFile* pMapping)
+{
+    __try
+    {
+        *pMapping = MappedFile_Open(pFilename, MAPPED_FILE_READ_ONLY);
+    }
+    __catch
+    {
+        clearExceptionCode();
+        return 0;
+    }
+
+    if (!isValidCacheImage(pMapping, pKey))
+    {
+        MappedFile_Close(pMapping);
+        return 0;
+    }
+
+    __try
+    {
+        createRegionsFromCacheImage(pMemory, pMapping);
+        if (pSymbols)
+            loadSymbolsFromCacheImage(pSymbols, pMapping);
+    }
+    __catch
+    {
+        MappedFile_Close(pMapping);
+        __rethrow;
+    }
+    return 1;
+}
+
+static int isValidCacheImage(const MappedFile* pMapping, const CacheKey* pKey)
+{
+    const uint8_t*        pImage = pMapping->pData;
+    const ElfCacheHeader* pHeader = pMapping->pData;
+    const ElfCacheEntry*  pEntries = NULL;
+    uint64_t              dataOffset;
+    uint32_t              i;
+
+    if (pMapping->size < sizeof(*pHeader))
+        return 0;
+    if (memcmp(pHeader->signature, ELF_CACHE_SIGNATURE, sizeof(pHeader->signature)) != 0 ||
+        pHeader->version != ELF_CACHE_VERSION ||
+        pHeader->keyType != pKey->type ||
+        pHeader->keySize != pKey->size ||
+        memcmp(pHeader->key, pKey->bytes, pKey->size) != 0)
+    {
+        return 0;
+    }
+    if (pHeader->entryCount == 0 ||
+        pHeader->entryCount > (pMapping->size - sizeof(*pHeader)) / sizeof(*pEntries))
+    {
+        return 0;
+    }
+
+    /* The data is mapped in place and read a word at a time so each entry must be aligned and after the entry table. */
+    pEntries = (const ElfCacheEntry*)(pImage + sizeof(*pHeader));
+    dataOffset = sizeof(*pHeader) + (uint64_t)pHeader->entryCount * sizeof(*pEntries);
+    for (i = 0 ; i < pHeader->entryCount ; i++)
+    {
+        if ((pEntries[i].type != ELF_CACHE_ENTRY_READ_ONLY_REGION && pEntries[i].type != ELF_CACHE_ENTRY_SYMBOLS) ||
+            pEntries[i].size == 0 ||
+            pEntries[i].fileOffset < dataOffset ||
+            pEntries[i].fileOffset % ELF_CACHE_DATA_ALIGN != 0 ||
+            (uint64_t)pEntries[i].fileOffset + pEntries[i].size > pMapping->size)
+        {
+            return 0;
+        }
+        if (pEntries[i].type == ELF_CACHE_ENTRY_SYMBOLS && !isValidSymbolsEntry(pImage, &pEntries[i]))
+            return 0;
+    }
+    return 1;
+}
+
+static int isValidSymbolsEntry(const uint8_t* pImage, const ElfCacheEntry* pEntry)
+{
+    const ElfCacheSymbol* pRecords = (const ElfCacheSymbol*)(pImage + pEntry->fileOffset);
+    uint64_t              recordsSize = (uint64_t)pEntry->baseAddress * sizeof(*pRecords);
+    uint32_t              stringsSize;
+    uint32_t              i;
+
+    if (recordsSize >= pEntry->size)
+        return 0;
+    stringsSize = pEntry->size - (uint32_t)recordsSize;
+    if (pImage[pEntry->fileOffset + pEntry->size - 1] != '\0')
+        return 0;
+    for (i = 0 ; i < pEntry->baseAddress ; i++)
+    {
+        if (pRecords[i].nameOffset >= stringsSize)
+            return 0;
+    }
+    return 1;
+}
+
+static void createRegionsFromCacheImage(IMemory* pMemory, MappedFile* pMapping)
+{
+    uint8_t*              pImage = pMapping->pData;
+    const ElfCacheHeader* pHeader = pMapping->pData;
+    const ElfCacheEntry*  pEntries = (const ElfCacheEntry*)(pImage + sizeof(*pHeader));
+    uint32_t              i;
+
+    for (i = 0 ; i < pHeader->entryCount ; i++)
+    {
+        if (pEntries[i].type != ELF_CACHE_ENTRY_READ_ONLY_REGION)
+            continue;
+        MemorySim_CreateRegionFromHostBuffer(pMemory, pEntries[i].baseAddress,
+                                             pImage + pEntries[i].fileOffset, pEntries[i].size);
+        MemorySim_MakeRegionReadOnly(pMemory, pEntries[i].baseAddress);
+    }
+}
+
+static void loadSymbolsFromCacheImage(ElfSymbols* pSymbols, const MappedFile* pMapping)
+{
+    const uint8_t*        pImage = pMapping->pData;
+    const ElfCacheHeader* pHeader = pMapping->pData;
+    const ElfCacheEntry*  pEntries = (const ElfCacheEntry*)(pImage + sizeof(*pHeader));
+    uint32_t              i;
+
+    /* Cache files for ELF images without a symbol table have no symbols entry so pSymbols is left empty. */
+    for (i = 0 ; i < pHeader->entryCount ; i++)
+    {
+        if (pEntries[i].type == ELF_CACHE_ENTRY_SYMBOLS)
+        {
+            loadSymbolsFromCacheEntry(pSymbols, pImage, &pEntries[i]);
+            return;
+        }
+    }
+}
+
+static void loadSymbolsFromCacheEntry(ElfSymbols* pSymbols, const uint8_t* pImage, const ElfCacheEntry* pEntry)
+{
+    const ElfCacheSymbol* pRecords = (const ElfCacheSymbol*)(pImage + pEntry->fileOffset);
+    uint32_t              symbolCount = pEntry->baseAddress;
+    uint32_t              recordsSize = symbolCount * sizeof(*pRecords);
+    uint32_t              stringsSize = pEntry->size - recordsSize;
+    uint32_t              i;
+
+    pSymbols->pStrings = malloc(stringsSize);
+    pSymbols->pSymbols = malloc(symbolCount * sizeof(*pSymbols->pSymbols) + 1);
+    if (!pSymbols->pStrings || !pSymbols->pSymbols)
+    {
+        ElfSymbols_Uninit(pSymbols);
+        __throw_msg(outOfMemoryException, "Failed to allocate %u bytes for ELF symbols.", pEntry->size);
+    }
+    memcpy(pSymbols->pStrings, (const uint8_t*)pRecords + recordsSize, stringsSize);
+    for (i = 0 ; i < symbolCount ; i++)
+    {
+        pSymbols->pSymbols[i].pName = pSymbols->pStrings + pRecords[i].nameOffset;
+        pSymbols->pSymbols[i].address = pRecords[i].address;
+        pSymbols->pSymbols[i].size = pRecords[i].size;
+    }
+    pSymbols->symbolCount = symbolCount;
+}
+
+static void parseSymbolsIgnoringErrors(ElfSymbols* pSymbols, const void* pElf, size_t elfSize)
+{
+    __try
+    {
+        ElfSymbols_Init(pSymbols, pElf, elfSize);
+    }
+    __catch
+    {
+        /* ElfSymbols_Init() leaves pSymbols empty on failure and the caller reports the error if it needs symbols. */
+        clearExceptionCode();
+    }
+}
+
+static void writeCacheFileIgnoringErrors(IMemory* pMemory, size_t firstRegion, const ElfSymbols* pSymbols,
+                                         const char* pDirectory, const char* pFilename, const CacheKey* pKey)
+{
+    FILE* volatile pFile = NULL;
+    char           tempFilename[ELF_CACHE_MAX_PATH];
+
+    /* Write to a process specific temporary file and rename it into place so that other CrashDebug instances sharing
+       the same cache directory never see a partially written cache file. */
+    snprintf(tempFilename, sizeof(tempFilename), "%s.%d.tmp", pFilename, (int)getProcessId());
+    createDirectory(pDirectory);
+    __try
+    {
+        pFile = fopen(tempFilename, "wb");
+        if (!pFile)
+            __throw(fileException);
+        writeCacheFile(pFile, pMemory, firstRegion, pSymbols, pKey);
+        if (fclose(pFile) != 0)
+        {
+            pFile = NULL;
+            __throw(fileException);
+        }
+        pFile = NULL;
+        if (rename(tempFilename, pFilename) != 0)
+            __throw(fileException);
+    }
+    __catch
+    {
+        if (pFile)
+            fclose(pFile);
+        remove(tempFilename);
+        clearExceptionCode();
+    }
+}
+
+static void writeCacheFile(FILE* pFile, IMemory* pMemory, size_t firstRegion, const ElfSymbols* pSymbols,
+                           const CacheKey* pKey)
+{
+    ElfCacheHeader header;
+    size_t         regionCount = MemorySim_GetRegionCount(pMemory);
+    int            hasSymbols = pSymbols->pSymbols != NULL;
+    uint32_t       stringsSize = hasSymbols ? calculateSymbolStringsSize(pSymbols) : 0;
+    uint32_t       offset;
+    size_t         i;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.signature, ELF_CACHE_SIGNATURE, sizeof(header.signature));
+    header.version = ELF_CACHE_VERSION;
+    header.entryCount = regionCount - firstRegion + (hasSymbols ? 1 : 0);
+    header.keyType = pKey->type;
+    header.keySize = pKey->size;
+    memcpy(header.key, pKey->bytes, sizeof(header.key));
+    writeAndThrowOnError(pFile, &header, sizeof(header));
+
+    offset = alignUp(sizeof(header) + header.entryCount * sizeof(ElfCacheEntry), ELF_CACHE_DATA_ALIGN);
+    for (i = firstRegion ; i < regionCount ; i++)
+    {
+        MemoryRegionInfo info = MemorySim_GetRegionInfo(pMemory, i);
+        ElfCacheEntry    entry;
+
+        entry.type = ELF_CACHE_ENTRY_READ_ONLY_REGION;
+        entry.baseAddress = info.baseAddress;
+        entry.size = info.size;
+        entry.fileOffset = offset;
+        writeAndThrowOnError(pFile, &entry, sizeof(entry));
+        offset = alignUp(offset + info.size, ELF_CACHE_DATA_ALIGN);
+    }
+    if (hasSymbols)
+    {
+        ElfCacheEntry entry;
+
+        entry.type = ELF_CACHE_ENTRY_SYMBOLS;
+        entry.baseAddress = pSymbols->symbolCount;
+        entry.size = pSymbols->symbolCount * sizeof(ElfCacheSymbol) + stringsSize;
+        entry.fileOffset = offset;
+        writeAndThrowOnError(pFile, &entry, sizeof(entry));
+    }
+
+    offset = sizeof(header) + header.entryCount * sizeof(ElfCacheEntry);
+    for (i = firstRegion ; i < regionCount ; i++)
+    {
+        MemoryRegionInfo info = MemorySim_GetRegionInfo(pMemory, i);
+
+        writePaddingAndThrowOnError(pFile, offset);
+        offset = alignUp(offset, ELF_CACHE_DATA_ALIGN);
+        writeAndThrowOnError(pFile, info.pData, info.size);
+        offset += info.size;
+    }
+    if (hasSymbols)
+    {
+        writePaddingAndThrowOnError(pFile, offset);
+        writeSymbols(pFile, pSymbols, stringsSize);
+    }
+}
+
+static uint32_t calculateSymbolStringsSize(const ElfSymbols* pSymbols)
+{
+    uint32_t stringsSize = 1;
+    size_t   i;
+
+    /* Only the part of the string table up to the end of the last name used by a defined symbol is cached. */
+    for (i = 0 ; i < pSymbols->symbolCount ; i++)
+    {
+        const char* pName = pSymbols->pSymbols[i].pName;
+        uint32_t    end = (uint32_t)(pName - pSymbols->pStrings) + strlen(pName) + 1;
+
+        if (end > stringsSize)
+            stringsSize = end;
+    }
+    return stringsSize;
+}
+
+static void writeSymbols(FILE* pFile, const ElfSymbols* pSymbols, uint32_t stringsSize)
+{
+    size_t i;
+
+    for (i = 0 ; i < pSymbols->symbolCount ; i++)
+    {
+        const ElfSymbol* pSymbol = &pSymbols->pSymbols[i];
+        ElfCacheSymbol   record;
+
+        record.nameOffset = (uint32_t)(pSymbol->pName - pSymbols->pStrings);
+        record.address = pSymbol->address;
+        record.size = pSymbol->size;
+        writeAndThrowOnError(pFile, &record, sizeof(record));
+    }
+    writeAndThrowOnError(pFile, pSymbols->pStrings, stringsSize);
+}
+
+static void writeAndThrowOnError(FILE* pFile, const void* pData, size_t size)
+{
+    if (fwrite(pData, 1, size, pFile) != size)
+        __throw(fileException);
+}
+
+static void writePaddingAndThrowOnError(FILE* pFile, uint32_t currentOffset)
+{
+    static const uint8_t padding[ELF_CACHE_DATA_ALIGN];
+    uint32_t             paddingSize = alignUp(currentOffset, ELF_CACHE_DATA_ALIGN) - currentOffset;
+
+    if (paddingSize > 0)
+        writeAndThrowOnError(pFile, padding, paddingSize);
+}
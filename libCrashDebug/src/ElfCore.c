@@ -0,0 +1,296 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <common.h>
+#include <CrashCatcher.h>
+#include <ElfCore.h>
+#include "ElfPriv.h"
+#include <FileFailureInject.h>
+#include <MemorySim.h>
+
+
+/* Signal numbers used in NT_PRSTATUS to indicate the type of fault. */
+#define SIGILL  4
+#define SIGTRAP 5
+#define SIGBUS  7
+#define SIGSEGV 11
+
+/* Layout of the 32-bit ARM elf_prstatus structure expected by BFD/GDB in NT_PRSTATUS notes. */
+#define PRSTATUS_SIZE           148
+#define PRSTATUS_CURSIG_OFFSET  12
+#define PRSTATUS_PID_OFFSET     24
+#define PRSTATUS_REG_OFFSET     72
+#define PRSTATUS_REG_COUNT      18
+#define PRSTATUS_CPSR_INDEX     16
+#define PRSTATUS_FPVALID_OFFSET 144
+
+/* NT_ARM_VFP contains 32 double precision registers followed by FPSCR. */
+#define VFP_DOUBLE_COUNT        32
+#define VFP_SIZE                (VFP_DOUBLE_COUNT * sizeof(uint64_t) + sizeof(uint32_t))
+
+#define NOTE_NAME_CORE          "CORE"
+#define NOTE_NAME_LINUX         "LINUX"
+
+typedef struct CoreWriter
+{
+    FILE*       pFile;
+    const char* pFilename;
+    uint32_t    offset;
+} CoreWriter;
+
+
+static uint32_t countLoadSegments(IMemory* pMemory);
+static int hasFloatingPointRegisters(const RegisterContext* pContext);
+static uint32_t noteSize(const char* pName, uint32_t descriptorSize);
+static uint32_t alignUp(uint32_t value, uint32_t alignment);
+static void writeCoreFile(CoreWriter* pWriter, IMemory* pMemory, const RegisterContext* pContext);
+static void writeElfHeader(CoreWriter* pWriter, uint32_t programHeaderCount);
+static void writeNoteProgramHeader(CoreWriter* pWriter, uint32_t noteOffset, uint32_t notesSize);
+static void writeLoadProgramHeaders(CoreWriter* pWriter, IMemory* pMemory, uint32_t dataOffset);
+static void writePrStatusNote(CoreWriter* pWriter, const RegisterContext* pContext);
+static uint32_t signalFromExceptionNumber(uint32_t exceptionNumber);
+static void writeVfpNote(CoreWriter* pWriter, const RegisterContext* pContext);
+static void writeNote(CoreWriter* pWriter, const char* pName, uint32_t type, const void* pDescriptor, uint32_t size);
+static void writeLoadSegments(CoreWriter* pWriter, IMemory* pMemory);
+static void writeBytes(CoreWriter* pWriter, const void* pData, size_t size);
+static void writePadding(CoreWriter* pWriter, uint32_t alignment);
+
+
+__throws void ElfCore_Write(IMemory* pMemory, const RegisterContext* pContext, const char* pCoreFilename)
+{
+    CoreWriter writer;
+
+    writer.pFilename = pCoreFilename;
+    writer.offset = 0;
+    writer.pFile = fopen(pCoreFilename, "wb");
+    if (!writer.pFile)
+        __throw_msg(fileException, "Failed to create \"%s\" core file.", pCoreFilename);
+
+    __try
+    {
+        writeCoreFile(&writer, pMemory, pContext);
+    }
+    __catch
+    {
+        fclose(writer.pFile);
+        remove(pCoreFilename);
+        __rethrow;
+    }
+    if (fclose(writer.pFile) != 0)
+    {
+        remove(pCoreFilename);
+        __throw_msg(fileException, "Failed to write \"%s\" core file.", pCoreFilename);
+    }
+}
+
+static void writeCoreFile(CoreWriter* pWriter, IMemory* pMemory, const RegisterContext* pContext)
+{
+    uint32_t programHeaderCount = 1 + countLoadSegments(pMemory);
+    uint32_t noteOffset = sizeof(Elf32_Ehdr) + programHeaderCount * sizeof(Elf32_Phdr);
+    uint32_t notesSize = noteSize(NOTE_NAME_CORE, PRSTATUS_SIZE);
+
+    if (hasFloatingPointRegisters(pContext))
+        notesSize += noteSize(NOTE_NAME_LINUX, VFP_SIZE);
+
+    writeElfHeader(pWriter, programHeaderCount);
+    writeNoteProgramHeader(pWriter, noteOffset, notesSize);
+    writeLoadProgramHeaders(pWriter, pMemory, noteOffset + notesSize);
+    writePrStatusNote(pWriter, pContext);
+    if (hasFloatingPointRegisters(pContext))
+        writeVfpNote(pWriter, pContext);
+    writeLoadSegments(pWriter, pMemory);
+}
+
+static uint32_t countLoadSegments(IMemory* pMemory)
+{
+    size_t   regionCount = MemorySim_GetRegionCount(pMemory);
+    uint32_t count = 0;
+    size_t   i;
+
+    /* Aliases have no contents of their own so GDB won't be able to access them in the core file. */
+    for (i = 0 ; i < regionCount ; i++)
+    {
+        if (!MemorySim_GetRegionInfo(pMemory, i).isAlias)
+            count++;
+    }
+    return count;
+}
+
+static int hasFloatingPointRegisters(const RegisterContext* pContext)
+{
+    return pContext->flags & CRASH_CATCHER_FLAGS_FLOATING_POINT;
+}
+
+static uint32_t noteSize(const char* pName, uint32_t descriptorSize)
+{
+    return sizeof(Elf32_Nhdr) + alignUp(strlen(pName) + 1, 4) + alignUp(descriptorSize, 4);
+}
+
+static uint32_t alignUp(uint32_t value, uint32_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static void writeElfHeader(CoreWriter* pWriter, uint32_t programHeaderCount)
+{
+    Elf32_Ehdr header;
+
+    memset(&header, 0, sizeof(header));
+    header.e_ident[EI_MAG0] = ELFMAG0;
+    header.e_ident[EI_MAG1] = ELFMAG1;
+    header.e_ident[EI_MAG2] = ELFMAG2;
+    header.e_ident[EI_MAG3] = ELFMAG3;
+    header.e_ident[EI_CLASS] = ELFCLASS32;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_type = ET_CORE;
+    header.e_machine = EM_ARM;
+    header.e_version = EV_CURRENT;
+    header.e_phoff = sizeof(Elf32_Ehdr);
+    header.e_ehsize = sizeof(Elf32_Ehdr);
+    header.e_phentsize = sizeof(Elf32_Phdr);
+    header.e_phnum = programHeaderCount;
+    writeBytes(pWriter, &header, sizeof(header));
+}
+
+static void writeNoteProgramHeader(CoreWriter* pWriter, uint32_t noteOffset, uint32_t notesSize)
+{
+    Elf32_Phdr header;
+
+    memset(&header, 0, sizeof(header));
+    header.p_type = PT_NOTE;
+    header.p_offset = noteOffset;
+    header.p_filesz = notesSize;
+    header.p_align = 4;
+    writeBytes(pWriter, &header, sizeof(header));
+}
+
+static void writeLoadProgramHeaders(CoreWriter* pWriter, IMemory* pMemory, uint32_t dataOffset)
+{
+    size_t regionCount = MemorySim_GetRegionCount(pMemory);
+    size_t i;
+
+    for (i = 0 ; i < regionCount ; i++)
+    {
+        MemoryRegionInfo info = MemorySim_GetRegionInfo(pMemory, i);
+        Elf32_Phdr       header;
+
+        if (info.isAlias)
+            continue;
+        memset(&header, 0, sizeof(header));
+        header.p_type = PT_LOAD;
+        header.p_offset = dataOffset;
+        header.p_vaddr = info.baseAddress;
+        header.p_paddr = info.baseAddress;
+        header.p_filesz = info.size;
+        header.p_memsz = info.size;
+        header.p_flags = info.isReadOnly ? PF_R | PF_X : PF_R | PF_W;
+        header.p_align = 4;
+        writeBytes(pWriter, &header, sizeof(header));
+        dataOffset = alignUp(dataOffset + info.size, 4);
+    }
+}
+
+static void writePrStatusNote(CoreWriter* pWriter, const RegisterContext* pContext)
+{
+    uint8_t  prstatus[PRSTATUS_SIZE];
+    uint32_t registers[PRSTATUS_REG_COUNT];
+    uint16_t signal = signalFromExceptionNumber(pContext->exceptionPSR & 0xFF);
+    uint32_t pid = 1;
+    uint32_t fpValid = hasFloatingPointRegisters(pContext) ? 1 : 0;
+
+    /* R0 - PC map directly onto the first 16 elf_prstatus registers, xPSR goes in the CPSR slot and the ORIG_R0 slot
+       is left as 0.  MSP and PSP have no place in this structure but the SP register already has the active one. */
+    memset(registers, 0, sizeof(registers));
+    memcpy(registers, pContext->R, (PC + 1) * sizeof(uint32_t));
+    registers[PRSTATUS_CPSR_INDEX] = pContext->R[XPSR];
+
+    memset(prstatus, 0, sizeof(prstatus));
+    memcpy(&prstatus[PRSTATUS_CURSIG_OFFSET], &signal, sizeof(signal));
+    memcpy(&prstatus[PRSTATUS_PID_OFFSET], &pid, sizeof(pid));
+    memcpy(&prstatus[PRSTATUS_REG_OFFSET], registers, sizeof(registers));
+    memcpy(&prstatus[PRSTATUS_FPVALID_OFFSET], &fpValid, sizeof(fpValid));
+    writeNote(pWriter, NOTE_NAME_CORE, NT_PRSTATUS, prstatus, sizeof(prstatus));
+}
+
+static uint32_t signalFromExceptionNumber(uint32_t exceptionNumber)
+{
+    switch (exceptionNumber)
+    {
+    case 3:
+    case 4:
+        return SIGSEGV;
+    case 5:
+        return SIGBUS;
+    case 6:
+        return SIGILL;
+    default:
+        return SIGTRAP;
+    }
+}
+
+static void writeVfpNote(CoreWriter* pWriter, const RegisterContext* pContext)
+{
+    uint8_t vfp[VFP_SIZE];
+
+    /* S0 - S31 overlay D0 - D15 and the remaining double precision registers don't exist on Cortex-M. */
+    memset(vfp, 0, sizeof(vfp));
+    memcpy(vfp, pContext->FPR, (S31 + 1) * sizeof(uint32_t));
+    memcpy(&vfp[VFP_DOUBLE_COUNT * sizeof(uint64_t)], &pContext->FPR[FPSCR], sizeof(uint32_t));
+    writeNote(pWriter, NOTE_NAME_LINUX, NT_ARM_VFP, vfp, sizeof(vfp));
+}
+
+static void writeNote(CoreWriter* pWriter, const char* pName, uint32_t type, const void* pDescriptor, uint32_t size)
+{
+    Elf32_Nhdr header;
+
+    header.n_namesz = strlen(pName) + 1;
+    header.n_descsz = size;
+    header.n_type = type;
+    writeBytes(pWriter, &header, sizeof(header));
+    writeBytes(pWriter, pName, header.n_namesz);
+    writePadding(pWriter, 4);
+    writeBytes(pWriter, pDescriptor, size);
+    writePadding(pWriter, 4);
+}
+
+static void writeLoadSegments(CoreWriter* pWriter, IMemory* pMemory)
+{
+    size_t regionCount = MemorySim_GetRegionCount(pMemory);
+    size_t i;
+
+    for (i = 0 ; i < regionCount ; i++)
+    {
+        MemoryRegionInfo info = MemorySim_GetRegionInfo(pMemory, i);
+
+        if (info.isAlias)
+            continue;
+        writeBytes(pWriter, info.pData, info.size);
+        writePadding(pWriter, 4);
+    }
+}
+
+static void writeBytes(CoreWriter* pWriter, const void* pData, size_t size)
+{
+    if (fwrite(pData, 1, size, pWriter->pFile) != size)
+        __throw_msg(fileException, "Failed to write \"%s\" core file.", pWriter->pFilename);
+    pWriter->offset += size;
+}
+
+static void writePadding(CoreWriter* pWriter, uint32_t alignment)
+{
+    static const uint8_t zeroes[4] = { 0, 0, 0, 0 };
+
+    writeBytes(pWriter, zeroes, alignUp(pWriter->offset, alignment) - pWriter->offset);
+}
@@ -85,6 +85,24 @@
 #define PF_W    2
 #define PF_X    1
 
+/* Values for Elf32_Shdr::sh_type */
+#define SHT_NULL        0
+#define SHT_PROGBITS    1
+#define SHT_SYMTAB      2
+#define SHT_STRTAB      3
+#define SHT_RELA        4
+#define SHT_HASH        5
+#define SHT_DYNAMIC     6
+#define SHT_NOTE        7
+#define SHT_NOBITS      8
+
+/* Values for Elf32_Nhdr::n_type when the note name is "GNU". */
+#define NT_GNU_BUILD_ID 3
+
+/* Values for Elf32_Nhdr::n_type in core files (note name is "CORE" or "LINUX"). */
+#define NT_PRSTATUS     1
+#define NT_ARM_VFP      0x400
+
 typedef uint32_t Elf32_Addr;
 typedef uint16_t Elf32_Half;
 typedef uint32_t Elf32_Off;
@@ -123,5 +141,42 @@ typedef struct
     Elf32_Word p_align;
 } Elf32_Phdr;
 
+/* ELF Section Header */
+typedef struct
+{
+    Elf32_Word sh_name;
+    Elf32_Word sh_type;
+    Elf32_Word sh_flags;
+    Elf32_Addr sh_addr;
+    Elf32_Off  sh_offset;
+    Elf32_Word sh_size;
+    Elf32_Word sh_link;
+    Elf32_Word sh_info;
+    Elf32_Word sh_addralign;
+    Elf32_Word sh_entsize;
+} Elf32_Shdr;
+
+/* Elf32_Sym::st_shndx value for undefined symbols. */
+#define SHN_UNDEF   0
+
+/* ELF Symbol Table Entry */
+typedef struct
+{
+    Elf32_Word    st_name;
+    Elf32_Addr    st_value;
+    Elf32_Word    st_size;
+    unsigned char st_info;
+    unsigned char st_other;
+    Elf32_Half    st_shndx;
+} Elf32_Sym;
+
+/* ELF Note Header - Followed by name and descriptor, each padded to 4-byte boundary. */
+typedef struct
+{
+    Elf32_Word n_namesz;
+    Elf32_Word n_descsz;
+    Elf32_Word n_type;
+} Elf32_Nhdr;
+
 
 #endif /* _ELF_PRIV_H_ */
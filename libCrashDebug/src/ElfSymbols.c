@@ -0,0 +1,190 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include "ElfPriv.h"
+#include <ElfSymbols.h>
+#include <MallocFailureInject.h>
+
+
+typedef struct ElfBlob
+{
+    const uint8_t* pElf;
+    size_t         elfSize;
+} ElfBlob;
+
+
+static void validateElfHeader(const ElfBlob* pBlob);
+static const Elf32_Shdr* findSymbolTableSection(const ElfBlob* pBlob);
+static const Elf32_Shdr* fetchSectionHeader(const ElfBlob* pBlob, uint32_t index);
+static const void* fetchBytes(const ElfBlob* pBlob, uint32_t offset, uint32_t size);
+static void copyStrings(ElfSymbols* pThis, const ElfBlob* pBlob, const Elf32_Shdr* pStringSection);
+static void copySymbols(ElfSymbols* pThis, const ElfBlob* pBlob, const Elf32_Shdr* pSymbolSection,
+                        uint32_t stringsSize);
+static void* throwingMalloc(size_t size);
+
+
+__throws void ElfSymbols_Init(ElfSymbols* pThis, const void* pElf, size_t elfSize)
+{
+    ElfBlob           blob = { pElf, elfSize };
+    const Elf32_Shdr* pSymbolSection = NULL;
+    const Elf32_Shdr* pStringSection = NULL;
+
+    memset(pThis, 0, sizeof(*pThis));
+    __try
+    {
+        validateElfHeader(&blob);
+        pSymbolSection = findSymbolTableSection(&blob);
+        pStringSection = fetchSectionHeader(&blob, pSymbolSection->sh_link);
+        copyStrings(pThis, &blob, pStringSection);
+        copySymbols(pThis, &blob, pSymbolSection, pStringSection->sh_size);
+    }
+    __catch
+    {
+        ElfSymbols_Uninit(pThis);
+        __rethrow;
+    }
+}
+
+static void validateElfHeader(const ElfBlob* pBlob)
+{
+    const unsigned char expectedIdent[4] = { ELFMAG0, ELFMAG1, ELFMAG2, ELFMAG3 };
+    const Elf32_Ehdr*   pHeader = fetchBytes(pBlob, 0, sizeof(*pHeader));
+
+    if (!pHeader || memcmp(pHeader->e_ident, expectedIdent, sizeof(expectedIdent)) != 0 ||
+        pHeader->e_ident[EI_CLASS] != ELFCLASS32 || pHeader->e_ident[EI_DATA] != ELFDATA2LSB)
+    {
+        __throw_msg(elfFormatException, "ELF header isn't for a 32-bit little endian image.");
+    }
+    if (pHeader->e_shoff == 0 || pHeader->e_shentsize < sizeof(Elf32_Shdr))
+        __throw_msg(elfFormatException, "ELF doesn't contain any section headers.");
+}
+
+static const Elf32_Shdr* findSymbolTableSection(const ElfBlob* pBlob)
+{
+    const Elf32_Ehdr* pHeader = (const Elf32_Ehdr*)pBlob->pElf;
+    Elf32_Half        i;
+
+    for (i = 0 ; i < pHeader->e_shnum ; i++)
+    {
+        const Elf32_Shdr* pSectionHeader = fetchSectionHeader(pBlob, i);
+        if (pSectionHeader->sh_type == SHT_SYMTAB)
+            return pSectionHeader;
+    }
+    __throw_msg(elfFormatException, "ELF doesn't contain a symbol table. Was it stripped?");
+}
+
+static const Elf32_Shdr* fetchSectionHeader(const ElfBlob* pBlob, uint32_t index)
+{
+    const Elf32_Ehdr* pHeader = (const Elf32_Ehdr*)pBlob->pElf;
+    const Elf32_Shdr* pSectionHeader = NULL;
+
+    if (index < pHeader->e_shnum)
+        pSectionHeader = fetchBytes(pBlob, pHeader->e_shoff + index * pHeader->e_shentsize, sizeof(*pSectionHeader));
+    if (!pSectionHeader)
+        __throw_msg(elfFormatException, "ELF section header %u is at an invalid file offset.", index);
+    return pSectionHeader;
+}
+
+static const void* fetchBytes(const ElfBlob* pBlob, uint32_t offset, uint32_t size)
+{
+    if ((uint64_t)offset + size > pBlob->elfSize)
+        return NULL;
+    return pBlob->pElf + offset;
+}
+
+static void copyStrings(ElfSymbols* pThis, const ElfBlob* pBlob, const Elf32_Shdr* pStringSection)
+{
+    const char* pStrings = fetchBytes(pBlob, pStringSection->sh_offset, pStringSection->sh_size);
+
+    if (pStringSection->sh_type != SHT_STRTAB || !pStrings)
+        __throw_msg(elfFormatException, "ELF symbol table doesn't link to a valid string table.");
+    /* Append a terminator so that a string table which doesn't end in one can't be overrun. */
+    pThis->pStrings = throwingMalloc(pStringSection->sh_size + 1);
+    memcpy(pThis->pStrings, pStrings, pStringSection->sh_size);
+    pThis->pStrings[pStringSection->sh_size] = '\0';
+}
+
+static void copySymbols(ElfSymbols* pThis, const ElfBlob* pBlob, const Elf32_Shdr* pSymbolSection,
+                        uint32_t stringsSize)
+{
+    const uint8_t* pEntries = fetchBytes(pBlob, pSymbolSection->sh_offset, pSymbolSection->sh_size);
+    uint32_t       entrySize = pSymbolSection->sh_entsize;
+    uint32_t       entryCount = 0;
+    uint32_t       i;
+
+    if (!pEntries || entrySize < sizeof(Elf32_Sym))
+        __throw_msg(elfFormatException, "ELF symbol table is at an invalid file offset.");
+    entryCount = pSymbolSection->sh_size / entrySize;
+    pThis->pSymbols = throwingMalloc(entryCount * sizeof(*pThis->pSymbols) + 1);
+    for (i = 0 ; i < entryCount ; i++)
+    {
+        const Elf32_Sym* pEntry = (const Elf32_Sym*)(pEntries + i * entrySize);
+        ElfSymbol*       pSymbol = &pThis->pSymbols[pThis->symbolCount];
+
+        if (pEntry->st_shndx == SHN_UNDEF || pEntry->st_name == 0 || pEntry->st_name >= stringsSize)
+            continue;
+        pSymbol->pName = pThis->pStrings + pEntry->st_name;
+        pSymbol->address = pEntry->st_value;
+        pSymbol->size = pEntry->st_size;
+        pThis->symbolCount++;
+    }
+}
+
+static void* throwingMalloc(size_t size)
+{
+    void* p = malloc(size);
+    if (!p)
+        __throw_msg(outOfMemoryException, "Failed to allocate %lu bytes for ELF symbols.", (unsigned long)size);
+    return p;
+}
+
+
+void ElfSymbols_Uninit(ElfSymbols* pThis)
+{
+    free(pThis->pSymbols);
+    free(pThis->pStrings);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+
+const ElfSymbol* ElfSymbols_Find(const ElfSymbols* pThis, const char* pName)
+{
+    size_t i;
+
+    for (i = 0 ; i < pThis->symbolCount ; i++)
+    {
+        if (0 == strcmp(pThis->pSymbols[i].pName, pName))
+            return &pThis->pSymbols[i];
+    }
+    return NULL;
+}
+
+
+const ElfSymbol* ElfSymbols_FindByAddress(const ElfSymbols* pThis, uint32_t address)
+{
+    const ElfSymbol* pFound = NULL;
+    size_t           i;
+
+    for (i = 0 ; i < pThis->symbolCount ; i++)
+    {
+        const ElfSymbol* pSymbol = &pThis->pSymbols[i];
+
+        if (address < pSymbol->address || (uint64_t)address >= (uint64_t)pSymbol->address + pSymbol->size)
+            continue;
+        if (!pFound || pSymbol->size < pFound->size)
+            pFound = pSymbol;
+    }
+    return pFound;
+}
@@ -0,0 +1,283 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <CrashCatcher.h>
+#include <FreeRtosThreads.h>
+#include <MallocFailureInject.h>
+
+
+/* Layout of List_t and ListItem_t when configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is 0. */
+#define LIST_SIZE                   20
+#define LIST_NUMBER_OF_ITEMS_OFFSET 0
+#define LIST_END_OFFSET             8
+#define LIST_ITEM_NEXT_OFFSET       4
+#define LIST_ITEM_OWNER_OFFSET      12
+
+/* Layout of the start of TCB_t when portUSING_MPU_WRAPPERS is 0 and configMAX_TASK_NAME_LEN is 16. */
+#define TCB_TOP_OF_STACK_OFFSET     0
+#define TCB_PRIORITY_OFFSET         44
+#define TCB_STACK_OFFSET            48
+#define TCB_NAME_OFFSET             52
+#define TCB_END_OF_STACK_OFFSET     68
+
+/* Rejects implausible pxEndOfStack values. */
+#define MAX_STACK_SIZE              (1024 * 1024)
+
+/* Guards against walking forever around a corrupted list. */
+#define MAX_THREAD_COUNT            256
+
+/* The ARM_CM4F port pushes EXC_RETURN along with R4-R11 and its bit 4 is clear when S16-S31 were pushed too. */
+#define EXC_RETURN_MASK             0xFFFFFFE0
+#define EXC_RETURN_STANDARD_FRAME   (1 << 4)
+#define XPSR_STACK_ALIGNED          (1 << 9)
+#define FPU_FRAME_WORDS             18
+
+
+typedef struct ThreadWalker
+{
+    RtosThreads*           pThreads;
+    IMemory*               pMemory;
+    const ElfSymbols*      pSymbols;
+    const RegisterContext* pHaltedContext;
+    size_t                 allocatedCount;
+} ThreadWalker;
+
+
+static uint32_t findRequiredSymbol(const ElfSymbols* pSymbols, const char* pName, uint32_t* pSize);
+static void addReadyTasks(ThreadWalker* pWalker);
+static void addTasksFromOptionalList(ThreadWalker* pWalker, const char* pListName, const char* pState);
+static void addTasksFromList(ThreadWalker* pWalker, uint32_t listAddress, const char* pState);
+static void addThread(ThreadWalker* pWalker, uint32_t tcb, const char* pState);
+static RtosThread* allocateThread(ThreadWalker* pWalker);
+static void readTaskName(IMemory* pMemory, uint32_t tcb, char* pName);
+static uint32_t readStackEnd(IMemory* pMemory, uint32_t tcb, uint32_t base);
+static void unstackContext(ThreadWalker* pWalker, uint32_t tcb, RegisterContext* pContext);
+static uint32_t readWords(IMemory* pMemory, uint32_t address, uint32_t* pDest, size_t wordCount);
+
+
+__throws void FreeRtosThreads_Init(RtosThreads* pThis, IMemory* pMemory, const ElfSymbols* pSymbols,
+                                   const RegisterContext* pHaltedContext)
+{
+    ThreadWalker walker;
+
+    memset(pThis, 0, sizeof(*pThis));
+    memset(&walker, 0, sizeof(walker));
+    walker.pThreads = pThis;
+    walker.pMemory = pMemory;
+    walker.pSymbols = pSymbols;
+    walker.pHaltedContext = pHaltedContext;
+    __try
+    {
+        pThis->haltedThreadId = IMemory_Read32(pMemory, findRequiredSymbol(pSymbols, "pxCurrentTCB", NULL));
+        if (pThis->haltedThreadId == 0)
+            __throw_msg(fileFormatException, "The FreeRTOS scheduler hasn't created any tasks yet.");
+        addThread(&walker, pThis->haltedThreadId, "Running");
+        addReadyTasks(&walker);
+        addTasksFromOptionalList(&walker, "xPendingReadyList", "Ready");
+        addTasksFromOptionalList(&walker, "xDelayedTaskList1", "Blocked");
+        addTasksFromOptionalList(&walker, "xDelayedTaskList2", "Blocked");
+        addTasksFromOptionalList(&walker, "xSuspendedTaskList", "Suspended");
+        addTasksFromOptionalList(&walker, "xTasksWaitingTermination", "Deleted");
+    }
+    __catch
+    {
+        FreeRtosThreads_Uninit(pThis);
+        __rethrow;
+    }
+}
+
+static uint32_t findRequiredSymbol(const ElfSymbols* pSymbols, const char* pName, uint32_t* pSize)
+{
+    const ElfSymbol* pSymbol = ElfSymbols_Find(pSymbols, pName);
+
+    if (!pSymbol)
+        __throw_msg(elfFormatException, "ELF doesn't contain the FreeRTOS %s symbol.", pName);
+    if (pSize)
+        *pSize = pSymbol->size;
+    return pSymbol->address;
+}
+
+static void addReadyTasks(ThreadWalker* pWalker)
+{
+    uint32_t listsSize = 0;
+    uint32_t lists = findRequiredSymbol(pWalker->pSymbols, "pxReadyTasksLists", &listsSize);
+    uint32_t priority;
+
+    /* There is one ready list for each of the configMAX_PRIORITIES priority levels. */
+    for (priority = 0 ; priority < listsSize / LIST_SIZE ; priority++)
+        addTasksFromList(pWalker, lists + priority * LIST_SIZE, "Ready");
+}
+
+static void addTasksFromOptionalList(ThreadWalker* pWalker, const char* pListName, const char* pState)
+{
+    const ElfSymbol* pSymbol = ElfSymbols_Find(pWalker->pSymbols, pListName);
+
+    /* Lists like xSuspendedTaskList only exist if the features using them were enabled in FreeRTOSConfig.h. */
+    if (!pSymbol)
+        return;
+    addTasksFromList(pWalker, pSymbol->address, pState);
+}
+
+static void addTasksFromList(ThreadWalker* pWalker, uint32_t listAddress, const char* pState)
+{
+    uint32_t listEnd = listAddress + LIST_END_OFFSET;
+    uint32_t itemCount = IMemory_Read32(pWalker->pMemory, listAddress + LIST_NUMBER_OF_ITEMS_OFFSET);
+    uint32_t item = IMemory_Read32(pWalker->pMemory, listEnd + LIST_ITEM_NEXT_OFFSET);
+    uint32_t i;
+
+    if (itemCount > MAX_THREAD_COUNT)
+        __throw_msg(fileFormatException, "FreeRTOS list at 0x%08X claims to contain %u tasks. Is it corrupt?",
+                    listAddress, itemCount);
+    for (i = 0 ; i < itemCount && item != listEnd ; i++)
+    {
+        uint32_t tcb = IMemory_Read32(pWalker->pMemory, item + LIST_ITEM_OWNER_OFFSET);
+
+        /* The running task is also on its priority's ready list but it was already added first. */
+        if (!FreeRtosThreads_Find(pWalker->pThreads, tcb))
+            addThread(pWalker, tcb, pState);
+        item = IMemory_Read32(pWalker->pMemory, item + LIST_ITEM_NEXT_OFFSET);
+    }
+}
+
+static void addThread(ThreadWalker* pWalker, uint32_t tcb, const char* pState)
+{
+    RtosThread* pThread = allocateThread(pWalker);
+
+    pThread->id = tcb;
+    pThread->pState = pState;
+    pThread->priority = IMemory_Read32(pWalker->pMemory, tcb + TCB_PRIORITY_OFFSET);
+    readTaskName(pWalker->pMemory, tcb, pThread->name);
+    pThread->stackBase = IMemory_Read32(pWalker->pMemory, tcb + TCB_STACK_OFFSET);
+    pThread->stackEnd = readStackEnd(pWalker->pMemory, tcb, pThread->stackBase);
+    if (tcb == pWalker->pThreads->haltedThreadId)
+        pThread->context = *pWalker->pHaltedContext;
+    else
+        unstackContext(pWalker, tcb, &pThread->context);
+}
+
+static RtosThread* allocateThread(ThreadWalker* pWalker)
+{
+    RtosThreads* pThreads = pWalker->pThreads;
+    RtosThread*  pThread = NULL;
+
+    if (pThreads->threadCount >= MAX_THREAD_COUNT)
+        __throw_msg(fileFormatException, "FreeRTOS task lists contain more than %d tasks. Are they corrupt?",
+                    MAX_THREAD_COUNT);
+    if (pThreads->threadCount == pWalker->allocatedCount)
+    {
+        size_t      newCount = pWalker->allocatedCount ? pWalker->allocatedCount * 2 : 8;
+        RtosThread* pRealloc = realloc(pThreads->pThreads, newCount * sizeof(*pRealloc));
+
+        if (!pRealloc)
+            __throw_msg(outOfMemoryException, "Failed to allocate room for %lu FreeRTOS tasks.",
+                        (unsigned long)newCount);
+        pThreads->pThreads = pRealloc;
+        pWalker->allocatedCount = newCount;
+    }
+    pThread = &pThreads->pThreads[pThreads->threadCount++];
+    memset(pThread, 0, sizeof(*pThread));
+    return pThread;
+}
+
+static void readTaskName(IMemory* pMemory, uint32_t tcb, char* pName)
+{
+    size_t i;
+
+    for (i = 0 ; i < RTOS_THREAD_NAME_SIZE ; i++)
+    {
+        pName[i] = IMemory_Read8(pMemory, tcb + TCB_NAME_OFFSET + i);
+        if (pName[i] == '\0')
+            return;
+    }
+    pName[i] = '\0';
+}
+
+static uint32_t readStackEnd(IMemory* pMemory, uint32_t tcb, uint32_t base)
+{
+    uint32_t topOfStack = IMemory_Read32(pMemory, tcb + TCB_TOP_OF_STACK_OFFSET);
+    uint32_t endOfStack = 0;
+
+    /* pxEndOfStack only follows pcTaskName when configRECORD_STACK_HIGH_ADDRESS is set so the field is only trusted
+       if it points at the highest word of a stack which contains pxTopOfStack. */
+    if (!IMemory_TryRead32(pMemory, tcb + TCB_END_OF_STACK_OFFSET, &endOfStack))
+        return 0;
+    if ((endOfStack & 3) != 0 || topOfStack < base || topOfStack > endOfStack || endOfStack - base >= MAX_STACK_SIZE)
+        return 0;
+    return endOfStack + sizeof(uint32_t);
+}
+
+static void unstackContext(ThreadWalker* pWalker, uint32_t tcb, RegisterContext* pContext)
+{
+    IMemory* pMemory = pWalker->pMemory;
+    uint32_t sp = IMemory_Read32(pMemory, tcb + TCB_TOP_OF_STACK_OFFSET);
+    uint32_t excReturn = EXC_RETURN_STANDARD_FRAME;
+
+    /* Registers which the port doesn't save (like MSP) are shared with the running task. */
+    pContext->flags = pWalker->pHaltedContext->flags;
+    pContext->R[MSP] = pWalker->pHaltedContext->R[MSP];
+    sp = readWords(pMemory, sp, &pContext->R[R4], R11 - R4 + 1);
+    /* The ARM_CM3 port only saves R4-R11 but ARM_CM4F saves EXC_RETURN too. */
+    if ((IMemory_Read32(pMemory, sp) & EXC_RETURN_MASK) == EXC_RETURN_MASK)
+    {
+        excReturn = IMemory_Read32(pMemory, sp);
+        sp += sizeof(uint32_t);
+    }
+    if ((excReturn & EXC_RETURN_STANDARD_FRAME) == 0)
+        sp = readWords(pMemory, sp, &pContext->FPR[S16], S31 - S16 + 1);
+
+    /* Then comes the exception frame stacked by the hardware. */
+    sp = readWords(pMemory, sp, &pContext->R[R0], R3 - R0 + 1);
+    sp = readWords(pMemory, sp, &pContext->R[R12], 1);
+    sp = readWords(pMemory, sp, &pContext->R[LR], XPSR - LR + 1);
+    if ((excReturn & EXC_RETURN_STANDARD_FRAME) == 0)
+    {
+        readWords(pMemory, readWords(pMemory, sp, &pContext->FPR[S0], S15 - S0 + 1), &pContext->FPR[FPSCR], 1);
+        sp += FPU_FRAME_WORDS * sizeof(uint32_t);
+    }
+    if (pContext->R[XPSR] & XPSR_STACK_ALIGNED)
+        sp += sizeof(uint32_t);
+    pContext->R[SP] = sp;
+    pContext->R[PSP] = sp;
+    pContext->exceptionPSR = pContext->R[XPSR];
+}
+
+static uint32_t readWords(IMemory* pMemory, uint32_t address, uint32_t* pDest, size_t wordCount)
+{
+    size_t i;
+
+    for (i = 0 ; i < wordCount ; i++, address += sizeof(uint32_t))
+        pDest[i] = IMemory_Read32(pMemory, address);
+    return address;
+}
+
+
+void FreeRtosThreads_Uninit(RtosThreads* pThis)
+{
+    free(pThis->pThreads);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+
+RtosThread* FreeRtosThreads_Find(const RtosThreads* pThis, uint32_t id)
+{
+    size_t i;
+
+    for (i = 0 ; i < pThis->threadCount ; i++)
+    {
+        if (pThis->pThreads[i].id == id)
+            return &pThis->pThreads[i];
+    }
+    return NULL;
+}
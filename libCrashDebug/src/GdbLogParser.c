@@ -17,16 +17,23 @@
 #include <FileFailureInject.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <MallocFailureInject.h>
 
 typedef struct ParseObject
 {
     IMemory*         pMem;
     RegisterContext* pContext;
+    /* Bytes of the contiguous region currently being parsed.  It is created once the next discontinuity is found. */
+    uint8_t*         pRegionBytes;
+    size_t           regionByteCount;
+    size_t           regionByteCapacity;
     uint32_t         regionStart;
-    uint32_t         regionSize;
     uint32_t         nextExpectedAddress;
-    char             lineText[1024];
+    /* Grows as needed so that long lines are never split in the middle of a value. */
+    char*            pLineText;
+    size_t           lineTextSize;
 } ParseObject;
 
 typedef enum ParseType
@@ -42,9 +49,9 @@ typedef struct ParseResults
     {
         struct
         {
-            uint32_t  address;
-            uint32_t  values[4];
-            uint32_t  valueCount;
+            uint32_t    address;
+            /* Remainder of the line after the address (and any <symbol+offset> that follows it). */
+            const char* pValues;
         };
         struct
         {
@@ -57,55 +64,48 @@ typedef struct ParseResults
 
 
 static FILE* openFileAndThrowOnError(const char* pLogFilename);
+static void initParseObject(ParseObject* pObject, IMemory* pMem, RegisterContext* pContext);
 static void initPSPandMSP(RegisterContext* pContext);
-static void firstPassHandler(ParseObject* pObject, const ParseResults* pParseResults);
-static void firstPassMemoryHandler(ParseObject* pObject, const ParseResults* pParseResults);
-static void firstPassRegisterHandler(ParseObject* pObject, const ParseResults* pParseResults);
+static void freeParseObject(ParseObject* pObject);
+static void parseLines(ParseObject* pObject, DumpStream* pLogStream);
+static char* readLine(ParseObject* pObject, DumpStream* pLogStream);
+static void growLineText(ParseObject* pObject);
+static void parseResultsHandler(ParseObject* pObject, const ParseResults* pParseResults);
+static void memoryHandler(ParseObject* pObject, const ParseResults* pParseResults);
+static int parseNextValue(const char** ppLine, uint32_t* pValueLow, uint32_t* pValueHigh, size_t* pValueSize);
+static size_t countHexDigits(const char* pText);
+static void appendRegionBytes(ParseObject* pObject, uint32_t value, size_t byteCount);
+static void createParsedRegion(ParseObject* pObject);
+static void registerHandler(ParseObject* pObject, const ParseResults* pParseResults);
 static int isFloatingPointRegister(size_t registerOffset);
-static void secondPassHandler(ParseObject* pObject, const ParseResults* pParseResults);
-static void parseLines(IMemory* pMem,
-                       RegisterContext* pContext,
-                       FILE* pLogFile,
-                       void (*passHandler)(ParseObject*, const ParseResults*));
 static ParseResults parseLine(const char* pLine);
 static int isMemoryLine(const char* pLine);
 static int is8DigitHexValue(const char* pLine);
 static int isHexDigit(char c);
 static ParseResults parseMemoryLine(const char* pLine);
-static const char* parseAddress(ParseResults* pResults, const char* pLine);
-static int areMoreValuesToParseOnLine(const ParseResults* pResults, const char* pLine);
-static const char* skipWhitespaceSymbolsAndParseNextValue(ParseResults* pResults, const char* pLine);
 static const char* skipWhitespaceAndSymbol(const char* pLine);
 static const char* skipWhitespace(const char* pLine);
 static const char* skipSymbol(const char* pLine);
-static const char* parseValue(ParseResults* pResults, const char* pLine);
 static int isRegisterLine(const char* pLine, size_t* pRegisterOffset);
 static ParseResults parseRegisterLine(const char* pLine, size_t registerOffset);
 static uint32_t parseFloatRegisterLine(const char* pLine);
 static const char* findWhitespace(const char* pLine);
 static ParseResults parseOtherLine(const char* pLine);
-static void rewindLogFileAndThrowOnError(FILE* pLogFile);
 
 
 __throws void GdbLogParse(IMemory* pMem, RegisterContext* pContext, const char* pLogFilename)
 {
-    FILE* volatile pLogFile = NULL;
+    DumpStream stream;
 
+    DumpStream_Init(&stream, openFileAndThrowOnError(pLogFilename));
     __try
-    {
-        pLogFile = openFileAndThrowOnError(pLogFilename);
-        initPSPandMSP(pContext);
-        parseLines(pMem, pContext, pLogFile, firstPassHandler);
-        rewindLogFileAndThrowOnError(pLogFile);
-        parseLines(pMem, pContext, pLogFile, secondPassHandler);
-        fclose(pLogFile);
-    }
+        GdbLogParse_FromStream(pMem, pContext, &stream);
     __catch
     {
-        if (pLogFile)
-            fclose(pLogFile);
+        DumpStream_Close(&stream);
         __rethrow;
     }
+    DumpStream_Close(&stream);
 }
 
 static FILE* openFileAndThrowOnError(const char* pLogFilename)
@@ -116,21 +116,92 @@ static FILE* openFileAndThrowOnError(const char* pLogFilename)
     return pLogFile;
 }
 
+__throws void GdbLogParse_FromStream(IMemory* pMem, RegisterContext* pContext, DumpStream* pLogStream)
+{
+    ParseObject object;
+
+    initParseObject(&object, pMem, pContext);
+    initPSPandMSP(pContext);
+    __try
+        parseLines(&object, pLogStream);
+    __catch
+    {
+        freeParseObject(&object);
+        __rethrow;
+    }
+    freeParseObject(&object);
+}
+
+static void initParseObject(ParseObject* pObject, IMemory* pMem, RegisterContext* pContext)
+{
+    memset(pObject, 0, sizeof(*pObject));
+    pObject->pMem = pMem;
+    pObject->pContext = pContext;
+    pObject->regionStart = 0xFFFFFFFF;
+    pObject->nextExpectedAddress = 0xFFFFFFFF;
+}
+
 static void initPSPandMSP(RegisterContext* pContext)
 {
     pContext->R[MSP] = DEFAULT_SP_VALUE;
     pContext->R[PSP] = DEFAULT_SP_VALUE;
 }
 
-static void firstPassHandler(ParseObject* pObject, const ParseResults* pParseResults)
+static void freeParseObject(ParseObject* pObject)
+{
+    free(pObject->pRegionBytes);
+    free(pObject->pLineText);
+}
+
+static void parseLines(ParseObject* pObject, DumpStream* pLogStream)
+{
+    /* The log is parsed in a single pass so that it can be read from a pipe. */
+    while (NULL != readLine(pObject, pLogStream))
+    {
+        ParseResults parseResults = parseLine(pObject->pLineText);
+        parseResultsHandler(pObject, &parseResults);
+    }
+    createParsedRegion(pObject);
+}
+
+static char* readLine(ParseObject* pObject, DumpStream* pLogStream)
+{
+    size_t length = 0;
+
+    while (TRUE)
+    {
+        if (pObject->lineTextSize - length < 2)
+            growLineText(pObject);
+        if (NULL == DumpStream_Gets(pLogStream, pObject->pLineText + length, pObject->lineTextSize - length))
+            return length > 0 ? pObject->pLineText : NULL;
+        length += strlen(pObject->pLineText + length);
+        if (length < pObject->lineTextSize - 1 || pObject->pLineText[length - 1] == '\n')
+            return pObject->pLineText;
+    }
+}
+
+static void growLineText(ParseObject* pObject)
+{
+    size_t newSize = pObject->lineTextSize ? 2 * pObject->lineTextSize : 1024;
+    char*  pRealloc = realloc(pObject->pLineText, newSize);
+
+    if (!pRealloc)
+        __throw(outOfMemoryException);
+    if (pObject->lineTextSize == 0)
+        pRealloc[0] = '\0';
+    pObject->pLineText = pRealloc;
+    pObject->lineTextSize = newSize;
+}
+
+static void parseResultsHandler(ParseObject* pObject, const ParseResults* pParseResults)
 {
     switch (pParseResults->type)
     {
     case TYPE_MEMORY:
-        firstPassMemoryHandler(pObject, pParseResults);
+        memoryHandler(pObject, pParseResults);
         break;
     case TYPE_REGISTER:
-        firstPassRegisterHandler(pObject, pParseResults);
+        registerHandler(pObject, pParseResults);
         break;
     case TYPE_OTHER:
     default:
@@ -138,60 +209,106 @@ static void firstPassHandler(ParseObject* pObject, const ParseResults* pParseRes
     }
 }
 
-static void firstPassMemoryHandler(ParseObject* pObject, const ParseResults* pParseResults)
+static void memoryHandler(ParseObject* pObject, const ParseResults* pParseResults)
 {
+    const char* pLine = pParseResults->pValues;
+    uint32_t    lineByteCount = 0;
+    uint32_t    valueLow;
+    uint32_t    valueHigh;
+    size_t      valueSize;
+
     if (pParseResults->address != pObject->nextExpectedAddress)
     {
-        if (pObject->regionStart != 0xFFFFFFFF)
-            MemorySim_CreateRegion(pObject->pMem, pObject->regionStart, pObject->regionSize);
+        createParsedRegion(pObject);
         pObject->regionStart = pParseResults->address;
-        pObject->regionSize = 0;
     }
-    pObject->regionSize += pParseResults->valueCount * sizeof(uint32_t);
-    pObject->nextExpectedAddress = pParseResults->address + pParseResults->valueCount * sizeof(uint32_t);
+    /* x/Nbx, x/Nhx, x/Nwx and x/Ngx are all supported, with the unit size inferred from the width of each value. */
+    while (parseNextValue(&pLine, &valueLow, &valueHigh, &valueSize))
+    {
+        appendRegionBytes(pObject, valueLow, valueSize > 4 ? 4 : valueSize);
+        if (valueSize > 4)
+            appendRegionBytes(pObject, valueHigh, valueSize - 4);
+        lineByteCount += valueSize;
+    }
+    pObject->nextExpectedAddress = pParseResults->address + lineByteCount;
 }
 
-static void firstPassRegisterHandler(ParseObject* pObject, const ParseResults* pParseResults)
+static int parseNextValue(const char** ppLine, uint32_t* pValueLow, uint32_t* pValueHigh, size_t* pValueSize)
 {
-    if (isFloatingPointRegister(pParseResults->registerOffset))
-        pObject->pContext->flags |= CRASH_CATCHER_FLAGS_FLOATING_POINT;
-    *(uint32_t*)((uint8_t*)pObject->pContext + pParseResults->registerOffset) = pParseResults->registerValue;
+    const char* pLine = skipWhitespaceAndSymbol(*ppLine);
+    size_t      digitCount;
+    size_t      i;
+
+    if (pLine[0] != '0' || (pLine[1] != 'x' && pLine[1] != 'X'))
+        return FALSE;
+    pLine += 2;
+    digitCount = countHexDigits(pLine);
+    if (digitCount != 2 && digitCount != 4 && digitCount != 8 && digitCount != 16)
+        return FALSE;
+
+    *pValueLow = 0;
+    *pValueHigh = 0;
+    for (i = 0 ; i < digitCount ; i++)
+    {
+        *pValueHigh = (*pValueHigh << 4) | (*pValueLow >> 28);
+        *pValueLow = (*pValueLow << 4) | (uint32_t)HexDigitToNibble(pLine[i]);
+    }
+    *pValueSize = digitCount / 2;
+    *ppLine = pLine + digitCount;
+    return TRUE;
 }
 
-static int isFloatingPointRegister(size_t registerOffset)
+static size_t countHexDigits(const char* pText)
 {
-    return registerOffset >= offsetof(RegisterContext, FPR[S0]) &&
-           registerOffset <= offsetof(RegisterContext, FPR[S31]);
+    size_t count = 0;
+
+    while (isHexDigit(pText[count]))
+        count++;
+    return count;
+}
+
+static void appendRegionBytes(ParseObject* pObject, uint32_t value, size_t byteCount)
+{
+    size_t i;
+
+    if (pObject->regionByteCapacity - pObject->regionByteCount < byteCount)
+    {
+        size_t   newCapacity = pObject->regionByteCapacity ? 2 * pObject->regionByteCapacity : 1024;
+        uint8_t* pRealloc = realloc(pObject->pRegionBytes, newCapacity);
+        if (!pRealloc)
+            __throw(outOfMemoryException);
+        pObject->pRegionBytes = pRealloc;
+        pObject->regionByteCapacity = newCapacity;
+    }
+    /* GDB displays each unit in target byte order which is little endian for Cortex-M. */
+    for (i = 0 ; i < byteCount ; i++)
+        pObject->pRegionBytes[pObject->regionByteCount++] = value >> (8 * i);
 }
 
-static void secondPassHandler(ParseObject* pObject, const ParseResults* pParseResults)
+static void createParsedRegion(ParseObject* pObject)
 {
-    uint32_t i;
-    if (pParseResults->type != TYPE_MEMORY)
+    uint32_t regionSize = pObject->regionByteCount;
+    void*    pDest;
+
+    if (regionSize == 0)
         return;
-    for (i = 0 ; i < pParseResults->valueCount ; i++)
-        IMemory_Write32(pObject->pMem, pParseResults->address + i * sizeof(uint32_t), pParseResults->values[i]);
+    MemorySim_CreateRegion(pObject->pMem, pObject->regionStart, regionSize);
+    pDest = MemorySim_MapSimulatedAddressToHostAddressForWrite(pObject->pMem, pObject->regionStart, regionSize);
+    memcpy(pDest, pObject->pRegionBytes, regionSize);
+    pObject->regionByteCount = 0;
 }
 
-static void parseLines(IMemory* pMem,
-                       RegisterContext* pContext,
-                       FILE* pLogFile,
-                       void (*passHandler)(ParseObject*, const ParseResults*))
+static void registerHandler(ParseObject* pObject, const ParseResults* pParseResults)
 {
-    ParseObject object;
-    object.pMem = pMem;
-    object.pContext = pContext;
-    object.regionStart = 0xFFFFFFFF;
-    object.regionSize = 0;
-    object.nextExpectedAddress = 0xFFFFFFFF;
+    if (isFloatingPointRegister(pParseResults->registerOffset))
+        pObject->pContext->flags |= CRASH_CATCHER_FLAGS_FLOATING_POINT;
+    *(uint32_t*)((uint8_t*)pObject->pContext + pParseResults->registerOffset) = pParseResults->registerValue;
+}
 
-    while (NULL != fgets(object.lineText, sizeof(object.lineText), pLogFile))
-    {
-        ParseResults parseResults = parseLine(object.lineText);
-        passHandler(&object, &parseResults);
-    }
-    if (object.regionSize != 0)
-        MemorySim_CreateRegion(object.pMem, object.regionStart, object.regionSize);
+static int isFloatingPointRegister(size_t registerOffset)
+{
+    return registerOffset >= offsetof(RegisterContext, FPR[S0]) &&
+           registerOffset <= offsetof(RegisterContext, FPR[S31]);
 }
 
 static ParseResults parseLine(const char* pLine)
@@ -226,9 +343,7 @@ static int is8DigitHexValue(const char* pLine)
 
 static int isHexDigit(char c)
 {
-    return ((c >= '0' && c <= '9') ||
-            (c >= 'a' && c <= 'f') ||
-            (c >= 'A' && c <= 'F'));
+    return HexDigitToNibble(c) >= 0;
 }
 
 static ParseResults parseMemoryLine(const char* pLine)
@@ -236,32 +351,15 @@ static ParseResults parseMemoryLine(const char* pLine)
     ParseResults results;
 
     results.type = TYPE_MEMORY;
-    results.valueCount = 0;
-    pLine = parseAddress(&results, pLine);
-    while (areMoreValuesToParseOnLine(&results, pLine))
-        pLine = skipWhitespaceSymbolsAndParseNextValue(&results, pLine);
+    results.address = strtoul(pLine, NULL, 0);
+    // Skip 0xXXXXXXXX address and then the optional <symbol+offset> and colon which follow it.
+    pLine = skipWhitespaceAndSymbol(pLine + 2 + 8);
+    if (*pLine == ':')
+        pLine++;
+    results.pValues = pLine;
     return results;
 }
 
-static const char* parseAddress(ParseResults* pResults, const char* pLine)
-{
-    pResults->address = strtoul(pLine, NULL, 0);
-    // Skip 0xXXXXXXXX: address formatted string.
-    return pLine + (2 + 8 + 1);
-}
-
-static int areMoreValuesToParseOnLine(const ParseResults* pResults, const char* pLine)
-{
-    return (*pLine && pResults->valueCount < ARRAY_SIZE(pResults->values));
-}
-
-static const char* skipWhitespaceSymbolsAndParseNextValue(ParseResults* pResults, const char* pLine)
-{
-    pLine = skipWhitespaceAndSymbol(pLine);
-    pLine = parseValue(pResults, pLine);
-    return pLine;
-}
-
 static const char* skipWhitespaceAndSymbol(const char* pLine)
 {
     pLine = skipWhitespace(pLine);
@@ -297,13 +395,6 @@ static const char* skipSymbol(const char* pLine)
 
 }
 
-static const char* parseValue(ParseResults* pResults, const char* pLine)
-{
-    char* pNext = NULL;
-    pResults->values[pResults->valueCount++] = strtoul(pLine, &pNext, 0);
-    return pNext;
-}
-
 static int isRegisterLine(const char* pLine, size_t* pRegisterOffset)
 {
     size_t i;
@@ -424,10 +515,3 @@ static ParseResults parseOtherLine(const char* pLine)
     results.type = TYPE_OTHER;
     return results;
 }
-
-static void rewindLogFileAndThrowOnError(FILE* pLogFile)
-{
-    int seekResult = fseek(pLogFile, SEEK_SET, 0);
-    if (seekResult == -1)
-        __throw_msg(fileException, "Failed to rewind GDB log for second pass.");
-}
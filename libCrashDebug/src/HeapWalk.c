@@ -0,0 +1,257 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <common.h>
+#include <HeapWalk.h>
+#include <printfSpy.h>
+
+
+/* Layout of newlib's dlmalloc (mallocr.c) chunks and bins on 32-bit targets. */
+#define SIZE_SZ             4
+#define MALLOC_ALIGNMENT    8
+#define MINSIZE             16
+#define PREV_INUSE          0x1
+#define SIZE_BITS           0x3
+#define PREV_SIZE_OFFSET    0
+#define SIZE_OFFSET         4
+#define FD_OFFSET           8
+#define BK_OFFSET           12
+/* __malloc_av_ holds a fd/bk pair for each bin, offset so that bin_at(i) can be treated as a chunk. */
+#define NAV                 128
+#define TOP_OFFSET          (2 * SIZE_SZ)
+#define BINS_SIZE           (NAV * 2 * SIZE_SZ)
+
+#define SBRK_BASE_UNSET     0xFFFFFFFF
+
+typedef struct HeapWalker
+{
+    IMemory*       pMemory;
+    HeapWalkResult result;
+    uint32_t       binsStart;
+    uint32_t       top;
+    int            wasPrevChunkFree;
+} HeapWalker;
+
+
+static uint32_t findSbrkBase(IMemory* pMemory, const ElfSymbols* pSymbols);
+static uint32_t findSymbolAddress(const ElfSymbols* pSymbols, const char* pName);
+static uint32_t readMallocState(IMemory* pMemory, uint32_t address);
+static uint32_t firstChunkAddress(uint32_t sbrkBase);
+static void walkChunks(HeapWalker* pWalker);
+static int walkChunk(HeapWalker* pWalker, uint32_t chunk, uint32_t* pNextChunk);
+static int validateFreeChunk(HeapWalker* pWalker, uint32_t chunk, uint32_t size, uint32_t next);
+static int isValidFreeListPointer(HeapWalker* pWalker, uint32_t pointer);
+static void recordFreeBlock(HeapWalker* pWalker, uint32_t size);
+static int markCorrupt(HeapWalker* pWalker, uint32_t chunk, const char* pFormat, ...);
+
+
+__throws HeapWalkResult HeapWalk_FromSymbols(IMemory* pMemory, const ElfSymbols* pSymbols)
+{
+    uint32_t mallocState = findSymbolAddress(pSymbols, "__malloc_av_");
+    uint32_t sbrkBase = findSbrkBase(pMemory, pSymbols);
+
+    return HeapWalk_Dlmalloc(pMemory, mallocState, sbrkBase);
+}
+
+static uint32_t findSbrkBase(IMemory* pMemory, const ElfSymbols* pSymbols)
+{
+    const ElfSymbol* pSymbol = ElfSymbols_Find(pSymbols, "__malloc_sbrk_base");
+
+    if (pSymbol)
+        return readMallocState(pMemory, pSymbol->address);
+    /* Without the malloc global, assume that _sbrk() starts handing out memory at the end of the BSS. */
+    pSymbol = ElfSymbols_Find(pSymbols, "__end__");
+    if (!pSymbol)
+        pSymbol = ElfSymbols_Find(pSymbols, "end");
+    if (!pSymbol)
+        __throw_msg(elfFormatException, "ELF doesn't contain the __malloc_sbrk_base or end symbols needed to find the heap.");
+    return pSymbol->address;
+}
+
+static uint32_t findSymbolAddress(const ElfSymbols* pSymbols, const char* pName)
+{
+    const ElfSymbol* pSymbol = ElfSymbols_Find(pSymbols, pName);
+
+    if (!pSymbol)
+        __throw_msg(elfFormatException, "ELF doesn't contain the %s symbol used by newlib's malloc.", pName);
+    return pSymbol->address;
+}
+
+static uint32_t readMallocState(IMemory* pMemory, uint32_t address)
+{
+    uint32_t value = 0;
+
+    if (!IMemory_TryRead32(pMemory, address, &value))
+        __throw_msg(busErrorException, "Failed to read malloc state at 0x%08X. Does the dump contain all of RAM?",
+                    address);
+    return value;
+}
+
+
+__throws HeapWalkResult HeapWalk_Dlmalloc(IMemory* pMemory, uint32_t mallocStateAddress, uint32_t sbrkBase)
+{
+    HeapWalker walker;
+
+    memset(&walker, 0, sizeof(walker));
+    walker.pMemory = pMemory;
+    walker.binsStart = mallocStateAddress;
+    walker.top = readMallocState(pMemory, mallocStateAddress + TOP_OFFSET);
+    if (sbrkBase == SBRK_BASE_UNSET || walker.top == mallocStateAddress)
+        __throw_msg(fileFormatException, "The heap is empty since malloc() was never called.");
+
+    walker.result.heapStart = firstChunkAddress(sbrkBase);
+    walker.result.topSize = readMallocState(pMemory, walker.top + SIZE_OFFSET) & ~SIZE_BITS;
+    walker.result.heapEnd = walker.top + walker.result.topSize;
+    walkChunks(&walker);
+    return walker.result;
+}
+
+static uint32_t firstChunkAddress(uint32_t sbrkBase)
+{
+    /* malloc() moves the start of the heap up so that the data in the first chunk is aligned. */
+    uint32_t misalignment = (sbrkBase + 2 * SIZE_SZ) & (MALLOC_ALIGNMENT - 1);
+
+    if (misalignment == 0)
+        return sbrkBase;
+    return sbrkBase + MALLOC_ALIGNMENT - misalignment;
+}
+
+static void walkChunks(HeapWalker* pWalker)
+{
+    uint32_t chunk = pWalker->result.heapStart;
+
+    if (pWalker->top < chunk)
+    {
+        markCorrupt(pWalker, pWalker->top, "Top chunk is below the start of the heap at 0x%08X.", chunk);
+        return;
+    }
+    while (chunk < pWalker->top)
+    {
+        if (!walkChunk(pWalker, chunk, &chunk))
+            return;
+    }
+    recordFreeBlock(pWalker, pWalker->result.topSize);
+}
+
+static int walkChunk(HeapWalker* pWalker, uint32_t chunk, uint32_t* pNextChunk)
+{
+    uint32_t sizeField = 0;
+    uint32_t nextSizeField = 0;
+    uint32_t size = 0;
+    uint32_t next = 0;
+
+    if (!IMemory_TryRead32(pWalker->pMemory, chunk + SIZE_OFFSET, &sizeField))
+        return markCorrupt(pWalker, chunk, "Chunk header isn't in the dump.");
+    size = sizeField & ~SIZE_BITS;
+    next = chunk + size;
+    if (size < MINSIZE || (size & (MALLOC_ALIGNMENT - 1)) != 0)
+        return markCorrupt(pWalker, chunk, "Chunk has invalid size of 0x%X.", sizeField);
+    if (next > pWalker->top || next < chunk)
+        return markCorrupt(pWalker, chunk, "Chunk size of 0x%X runs past the top chunk at 0x%08X.",
+                           sizeField, pWalker->top);
+    if (chunk == pWalker->result.heapStart && (sizeField & PREV_INUSE) == 0)
+        return markCorrupt(pWalker, chunk, "First chunk doesn't have its PREV_INUSE bit set.");
+    if (!IMemory_TryRead32(pWalker->pMemory, next + SIZE_OFFSET, &nextSizeField))
+        return markCorrupt(pWalker, next, "Chunk header isn't in the dump.");
+
+    if (nextSizeField & PREV_INUSE)
+    {
+        pWalker->result.usedChunks++;
+        pWalker->result.usedBytes += size;
+        pWalker->wasPrevChunkFree = FALSE;
+    }
+    else
+    {
+        if (!validateFreeChunk(pWalker, chunk, size, next))
+            return FALSE;
+        recordFreeBlock(pWalker, size);
+        pWalker->wasPrevChunkFree = TRUE;
+    }
+    *pNextChunk = next;
+    return TRUE;
+}
+
+static int validateFreeChunk(HeapWalker* pWalker, uint32_t chunk, uint32_t size, uint32_t next)
+{
+    uint32_t prevSize = 0;
+    uint32_t fd = 0;
+    uint32_t bk = 0;
+    uint32_t fdBk = 0;
+
+    if (pWalker->wasPrevChunkFree)
+        return markCorrupt(pWalker, chunk, "Free chunk follows another free chunk without being coalesced.");
+    if (!IMemory_TryRead32(pWalker->pMemory, next + PREV_SIZE_OFFSET, &prevSize) || prevSize != size)
+        return markCorrupt(pWalker, chunk, "Free chunk of size 0x%X doesn't match next chunk's prev_size of 0x%X.",
+                           size, prevSize);
+    if (!IMemory_TryRead32(pWalker->pMemory, chunk + FD_OFFSET, &fd) ||
+        !IMemory_TryRead32(pWalker->pMemory, chunk + BK_OFFSET, &bk) ||
+        !isValidFreeListPointer(pWalker, fd) || !isValidFreeListPointer(pWalker, bk))
+    {
+        return markCorrupt(pWalker, chunk, "Free chunk has invalid fd/bk pointers of 0x%08X/0x%08X.", fd, bk);
+    }
+    if (!IMemory_TryRead32(pWalker->pMemory, fd + BK_OFFSET, &fdBk) || fdBk != chunk)
+        return markCorrupt(pWalker, chunk, "Free chunk's fd->bk points to 0x%08X instead of back to it.", fdBk);
+    return TRUE;
+}
+
+static int isValidFreeListPointer(HeapWalker* pWalker, uint32_t pointer)
+{
+    /* Free chunks are linked to other free chunks or to the bin headers within __malloc_av_. */
+    if (pointer >= pWalker->binsStart && pointer < pWalker->binsStart + BINS_SIZE)
+        return TRUE;
+    return pointer >= pWalker->result.heapStart && pointer < pWalker->top && (pointer & (MALLOC_ALIGNMENT - 1)) ==
+           (pWalker->result.heapStart & (MALLOC_ALIGNMENT - 1));
+}
+
+static void recordFreeBlock(HeapWalker* pWalker, uint32_t size)
+{
+    pWalker->result.freeChunks++;
+    pWalker->result.freeBytes += size;
+    if (size > pWalker->result.largestFreeBlock)
+        pWalker->result.largestFreeBlock = size;
+}
+
+static int markCorrupt(HeapWalker* pWalker, uint32_t chunk, const char* pFormat, ...)
+{
+    va_list valist;
+
+    va_start(valist, pFormat);
+    vsnprintf(pWalker->result.corruption, sizeof(pWalker->result.corruption), pFormat, valist);
+    va_end(valist);
+    pWalker->result.isCorrupt = TRUE;
+    pWalker->result.corruptChunk = chunk;
+    return FALSE;
+}
+
+
+void HeapWalk_PrintReport(const HeapWalkResult* pResult)
+{
+    uint32_t fragmentation = 0;
+
+    if (pResult->freeBytes > 0)
+        fragmentation = (uint32_t)(100 - (uint64_t)pResult->largestFreeBlock * 100 / pResult->freeBytes);
+    printf("Heap: 0x%08X - 0x%08X (%u bytes)\n"
+           "  Used chunks:        %u (%u bytes)\n"
+           "  Free chunks:        %u (%u bytes, including %u byte top chunk)\n"
+           "  Largest free block: %u bytes\n"
+           "  Fragmentation:      %u%%\n",
+           pResult->heapStart, pResult->heapEnd, pResult->heapEnd - pResult->heapStart,
+           pResult->usedChunks, pResult->usedBytes,
+           pResult->freeChunks, pResult->freeBytes, pResult->topSize,
+           pResult->largestFreeBlock,
+           fragmentation);
+    if (pResult->isCorrupt)
+        printf("CORRUPT: Heap walk stopped at chunk 0x%08X. %s\n", pResult->corruptChunk, pResult->corruption);
+}
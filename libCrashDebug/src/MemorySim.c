@@ -13,6 +13,8 @@
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
+#include <Arena.h>
+#include <common.h>
 #include <MemorySim.h>
 #include <MallocFailureInject.h>
 
@@ -23,6 +25,8 @@
 #define AccessType WatchpointType
 #define READING    WATCHPOINT_READ
 #define WRITING    WATCHPOINT_WRITE
+/* IMemory's 16-bit reads are instruction fetches which stop at breakpoints and are counted for FLASH regions. */
+#define FETCHING   (AccessType)((1 << 30) | WATCHPOINT_READ)
 /* Even though loading data into FLASH is a write operation, we don't want bus exceptions generated. */
 #define LOADING    WATCHPOINT_READ
 
@@ -50,19 +54,38 @@ typedef enum MatchResult
 
 } MatchResult;
 
+/* Contiguous run of host memory backing the simulated memory starting at a given address. */
+typedef struct HostSpan
+{
+    const uint8_t* pData;
+    uint32_t       size;
+} HostSpan;
+
+/* Keeps the file backing a MemorySim_CreateRegionFromMappedFile() region mapped until the region is released.  It is
+   never asked to load anything since the region's data is the mapping itself. */
+typedef struct MappedFileOwner
+{
+    MemorySimLoader loader;
+    MappedFile      mapping;
+} MappedFileOwner;
+
 /* Forward Declarations */
 typedef struct MemorySim MemorySim;
 typedef struct MemoryRegion MemoryRegion;
 typedef struct Watchpoint Watchpoint;
 
-static void freeRegion(MemoryRegion* pRegion);
-static void* throwingZeroedMalloc(size_t size);
+static void releaseRegion(MemoryRegion* pRegion);
+static void* allocate(MemorySim* pThis, size_t size);
+static void releaseMappedFileOwner(MemorySimLoader* pLoader);
 static void addRegionToTail(MemorySim* pThis, MemoryRegion* pRegion);
 static MemoryRegion* findMatchingRegion(MemorySim* pThis, uint32_t* pAddress, uint32_t size);
-static void allocateReadCountArrayForReadOnlyRegion(MemoryRegion* pRegion);
+static MemoryRegion* lookupRegion(MemorySim* pThis, uint32_t* pAddress, uint32_t size);
+static void allocateReadCountsIfNeeded(MemorySim* pThis, MemoryRegion* pRegion);
+static int tryAllocateReadCounts(MemorySim* pThis, MemoryRegion* pRegion);
 static void load32(IMemory* pMemory, uint32_t address, uint32_t value);
 static void load8(IMemory* pMemory, uint32_t address, uint8_t value);
 static void freeLastRegion(MemorySim* pThis);
+static void loadRegionIfNeeded(MemorySim* pThis, MemoryRegion* pRegion);
 static size_t countRegions(MemorySim* pThis);
 static void allocateMemoryMapXML(MemorySim* pThis, size_t allocSize);
 static void appendMemoryMapXmlHeader(MemorySim* pThis, SizedBuffer* pBuffer);
@@ -72,12 +95,22 @@ static void setWatchpoint(IMemory* pMemory, uint32_t address, uint32_t size, Wat
 static MatchResult findMatchingOrHigherWatchpoint(MemoryRegion* pRegion, Watchpoint* pKey, uint32_t* pIndex);
 static int compareWatchpoints(const void* pvKey, const void* pvCurr);
 static int watchpointsMatch(const Watchpoint* p1, const Watchpoint* p2);
-static void growWatchpointArrayIfNeeded(MemoryRegion* pRegion, uint32_t requiredSize);
+static void growWatchpointArrayIfNeeded(MemorySim* pThis, MemoryRegion* pRegion, uint32_t requiredSize);
 static void clearWatchpoint(IMemory* pMemory, uint32_t address, uint32_t size, WatchpointType type);
 static void* getDataPointer(MemorySim* pThis, uint32_t address, uint32_t size, AccessType type, int checkWatchpoints);
-static void checkForBreakWatchPoint(MemorySim* pThis,
-                                    MemoryRegion* pRegion,
-                                    uint32_t address, uint32_t size, AccessType type);
+static void* tryGetDataPointer(MemorySim* pThis, uint32_t address, uint32_t size, AccessType type);
+static int tryLoadRegion(MemorySim* pThis, MemoryRegion* pRegion);
+static uint8_t* accessRegionData(MemorySim* pThis,
+                                 MemoryRegion* pRegion,
+                                 uint32_t address, uint32_t size, AccessType type, int checkWatchpoints);
+static int checkForBreakWatchPoint(MemorySim* pThis,
+                                   MemoryRegion* pRegion,
+                                   uint32_t address, uint32_t size, AccessType type);
+static int findHostSpan(MemorySim* pThis, uint32_t address, HostSpan* pSpan);
+static int findNextRegionAbove(MemorySim* pThis, uint32_t address, uint32_t* pBaseAddress);
+static const uint8_t* searchSpan(const uint8_t* pStart, size_t size, const uint8_t* pPattern, uint32_t patternSize);
+static int matchesAcrossSpans(MemorySim* pThis, uint32_t address, uint64_t endAddress,
+                              const uint8_t* pPattern, uint32_t patternSize);
 static int accessInRange(Watchpoint* pWatchpoint, uint32_t startAddress, uint32_t endAddress);
 
 static uint32_t read32(IMemory* pMemory, uint32_t address);
@@ -86,8 +119,15 @@ static uint8_t read8(IMemory* pMemory, uint32_t address);
 static void write32(IMemory* pMemory, uint32_t address, uint32_t value);
 static void write16(IMemory* pMemory, uint32_t address, uint16_t value);
 static void write8(IMemory* pMemory, uint32_t address, uint8_t value);
+static int tryRead32(IMemory* pMemory, uint32_t address, uint32_t* pValue);
+static int tryRead16(IMemory* pMemory, uint32_t address, uint16_t* pValue);
+static int tryRead8(IMemory* pMemory, uint32_t address, uint8_t* pValue);
+static int tryWrite32(IMemory* pMemory, uint32_t address, uint32_t value);
+static int tryWrite16(IMemory* pMemory, uint32_t address, uint16_t value);
+static int tryWrite8(IMemory* pMemory, uint32_t address, uint8_t value);
 
-static IMemoryVTable g_vTable = {read32, read16, read8, write32, write16, write8};
+static IMemoryVTable g_vTable = {read32, read16, read8, write32, write16, write8,
+                                 tryRead32, tryRead16, tryRead8, tryWrite32, tryWrite16, tryWrite8};
 
 struct Watchpoint
 {
@@ -100,13 +140,19 @@ struct Watchpoint
 struct MemoryRegion
 {
     struct MemoryRegion* pNext;
+    /* Next region on MemorySim::pLoaderRegions. */
+    struct MemoryRegion* pNextWithLoader;
     struct MemoryRegion* pRedirect;
     uint8_t*             pData;
+    /* Buffer allocated for a lazy region's data.  Kept for the next attempt if the load fails. */
+    uint8_t*             pLoadBuffer;
+    MemorySimLoader*     pLoader;
     Watchpoint*          pWatchpoints;
     uint32_t*            pReadCounts;
     uint32_t             baseAddress;
     uint32_t             redirectAddress;
     uint32_t             size;
+    uint32_t             sourceOffset;
     uint32_t             watchpointCount;
     uint32_t             watchpointAlloc;
     uint32_t             readCounts;
@@ -119,7 +165,13 @@ struct MemorySim
     IMemoryVTable* pVTable;
     MemoryRegion*  pHeadRegion;
     MemoryRegion*  pTailRegion;
+    /* Most recently added first list of the regions which hold a loader reference. */
+    MemoryRegion*  pLoaderRegions;
     char*          pMemoryMapXML;
+    size_t         memoryMapXMLSize;
+    /* Everything allocated for the session except the MemorySim itself comes from here. */
+    Arena          arena;
+    MemorySimStats stats;
     int            watchpointEncountered;
 };
 
@@ -134,6 +186,25 @@ IMemory* MemorySim_Init(void)
 }
 
 
+__throws IMemory* MemorySim_Create(void)
+{
+    MemorySim* pThis = malloc(sizeof(*pThis));
+
+    if (!pThis)
+        __throw(outOfMemoryException);
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pVTable = &g_vTable;
+    return (IMemory*)pThis;
+}
+
+
+void MemorySim_Destroy(IMemory* pMemory)
+{
+    MemorySim_Uninit(pMemory);
+    free(pMemory);
+}
+
+
 void MemorySim_Uninit(IMemory* pMemory)
 {
     MemorySim*    pThis = (MemorySim*)pMemory;
@@ -142,58 +213,96 @@ void MemorySim_Uninit(IMemory* pMemory)
     if (!pThis)
         return;
 
-    pCurr = pThis->pHeadRegion;
-    while (pCurr)
-    {
-        MemoryRegion* pNext = pCurr->pNext;
-        freeRegion(pCurr);
-        pCurr = pNext;
-    }
-    pThis->pHeadRegion = pThis->pTailRegion = NULL;
-
-    free(pThis->pMemoryMapXML);
+    /* Only the regions with loaders need to be visited to drop their references.  Their memory is all freed with the
+       arena. */
+    for (pCurr = pThis->pLoaderRegions ; pCurr ; pCurr = pCurr->pNextWithLoader)
+        releaseRegion(pCurr);
+    pThis->pHeadRegion = pThis->pTailRegion = pThis->pLoaderRegions = NULL;
     pThis->pMemoryMapXML = NULL;
+    pThis->memoryMapXMLSize = 0;
+    Arena_Uninit(&pThis->arena);
 }
 
-static void freeRegion(MemoryRegion* pRegion)
+static void releaseRegion(MemoryRegion* pRegion)
 {
-    if (!pRegion)
-        return;
-
-    free(pRegion->pReadCounts);
-    free(pRegion->pWatchpoints);
-    free(pRegion->pData);
-    free(pRegion);
+    if (pRegion->pLoader && --pRegion->pLoader->refCount == 0)
+        pRegion->pLoader->release(pRegion->pLoader);
+    pRegion->pLoader = NULL;
 }
 
 
 void MemorySim_CreateRegion(IMemory* pMemory, uint32_t baseAddress, uint32_t size)
 {
-    MemorySim*             pThis = (MemorySim*)pMemory;
-    MemoryRegion* volatile pRegion = NULL;
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pRegion = allocate(pThis, sizeof(*pRegion));
 
-    __try
-    {
-        pRegion = throwingZeroedMalloc(sizeof(*pRegion));
-        pRegion->baseAddress = baseAddress;
-        pRegion->size = size;
-        pRegion->pData = throwingZeroedMalloc(size);
-        addRegionToTail(pThis, pRegion);
-    }
-    __catch
-    {
-        freeRegion(pRegion);
-        __rethrow;
-    }
+    pRegion->baseAddress = baseAddress;
+    pRegion->size = size;
+    pRegion->pData = allocate(pThis, size);
+    addRegionToTail(pThis, pRegion);
 }
 
-static void* throwingZeroedMalloc(size_t size)
+static void* allocate(MemorySim* pThis, size_t size)
 {
-    void* pvAlloc = malloc(size);
-    if (!pvAlloc)
-        __throw(outOfMemoryException);
-    memset(pvAlloc, 0, size);
-    return pvAlloc;
+    return Arena_Alloc(&pThis->arena, size);
+}
+
+__throws void MemorySim_CreateRegionFromHostBuffer(IMemory* pMemory, uint32_t baseAddress, void* pBuffer, uint32_t size)
+{
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pRegion = NULL;
+
+    /* The caller retains ownership of pBuffer and must keep it valid until MemorySim_Uninit() has been called. */
+    pRegion = allocate(pThis, sizeof(*pRegion));
+    pRegion->baseAddress = baseAddress;
+    pRegion->size = size;
+    pRegion->pData = pBuffer;
+    addRegionToTail(pThis, pRegion);
+}
+
+__throws void MemorySim_CreateLazyRegion(IMemory* pMemory, uint32_t baseAddress, uint32_t size, MemorySimLoader* pLoader, uint32_t sourceOffset)
+{
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pRegion = NULL;
+
+    /* The region's data isn't allocated and loaded until loadRegionIfNeeded() is called on first access. */
+    pRegion = allocate(pThis, sizeof(*pRegion));
+    pRegion->baseAddress = baseAddress;
+    pRegion->size = size;
+    pRegion->pLoader = pLoader;
+    pRegion->sourceOffset = sourceOffset;
+    pLoader->refCount++;
+    addRegionToTail(pThis, pRegion);
+}
+
+__throws void MemorySim_CreateRegionFromMappedFile(IMemory* pMemory, uint32_t baseAddress, MappedFile* pMapping)
+{
+    MemorySim*       pThis = (MemorySim*)pMemory;
+    MappedFileOwner* pOwner = NULL;
+    MemoryRegion*    pRegion = NULL;
+
+    if (pMapping->size == 0 || (uint64_t)pMapping->size > 0xFFFFFFFF)
+        __throw(invalidArgumentException);
+    pOwner = allocate(pThis, sizeof(*pOwner));
+    pRegion = allocate(pThis, sizeof(*pRegion));
+
+    pOwner->mapping = *pMapping;
+    pOwner->loader.release = releaseMappedFileOwner;
+    pOwner->loader.refCount = 1;
+    memset(pMapping, 0, sizeof(*pMapping));
+    pRegion->baseAddress = baseAddress;
+    pRegion->size = pOwner->mapping.size;
+    pRegion->pData = pOwner->mapping.pData;
+    pRegion->pLoader = &pOwner->loader;
+    addRegionToTail(pThis, pRegion);
+}
+
+static void releaseMappedFileOwner(MemorySimLoader* pLoader)
+{
+    MappedFileOwner* pThis = (MappedFileOwner*)pLoader;
+
+    /* The owner itself was allocated from the arena so only the mapping needs to be closed here. */
+    MappedFile_Close(&pThis->mapping);
 }
 
 static void addRegionToTail(MemorySim* pThis, MemoryRegion* pRegion)
@@ -203,37 +312,31 @@ static void addRegionToTail(MemorySim* pThis, MemoryRegion* pRegion)
     else
         pThis->pTailRegion->pNext = pRegion;
     pThis->pTailRegion = pRegion;
+    if (pRegion->pLoader)
+    {
+        pRegion->pNextWithLoader = pThis->pLoaderRegions;
+        pThis->pLoaderRegions = pRegion;
+    }
 }
 
 
 void MemorySim_CreateAlias(IMemory* pMemory, uint32_t aliasAddress, uint32_t redirectAddress, uint32_t size)
 {
-    MemorySim*             pThis = (MemorySim*)pMemory;
-    MemoryRegion* volatile pRegion = NULL;
-    MemoryRegion*          pRedirect = NULL;
-
-    __try
-    {
-        pRegion = throwingZeroedMalloc(sizeof(*pRegion));
-        pRegion->baseAddress = aliasAddress;
-        pRegion->redirectAddress = redirectAddress;
-        pRedirect = findMatchingRegion(pThis, &redirectAddress, 1);
-        uint32_t maxSize = pRedirect->size - (pRegion->redirectAddress - pRedirect->baseAddress);
-        if (size > maxSize)
-            pRegion->size = maxSize;
-        else
-            pRegion->size = size;
-        pRegion->pRedirect = pRedirect;
-        pRegion->pData = throwingZeroedMalloc(size);
-        pRegion->isAlias = 1;
-        pRegion->isReadOnly = pRedirect->isReadOnly;
-        addRegionToTail(pThis, pRegion);
-    }
-    __catch
-    {
-        freeRegion(pRegion);
-        __rethrow;
-    }
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pRedirect = findMatchingRegion(pThis, &redirectAddress, 1);
+    MemoryRegion* pRegion = allocate(pThis, sizeof(*pRegion));
+    uint32_t      maxSize = pRedirect->size - (redirectAddress - pRedirect->baseAddress);
+
+    pRegion->baseAddress = aliasAddress;
+    pRegion->redirectAddress = redirectAddress;
+    if (size > maxSize)
+        pRegion->size = maxSize;
+    else
+        pRegion->size = size;
+    pRegion->pRedirect = pRedirect;
+    pRegion->isAlias = 1;
+    pRegion->isReadOnly = pRedirect->isReadOnly;
+    addRegionToTail(pThis, pRegion);
 }
 
 
@@ -242,19 +345,50 @@ void MemorySim_MakeRegionReadOnly(IMemory* pMemory, uint32_t baseAddress)
     MemorySim* pThis = (MemorySim*)pMemory;
     MemoryRegion* pRegion = findMatchingRegion(pThis, &baseAddress, 1);
     pRegion->isReadOnly = 1;
-    allocateReadCountArrayForReadOnlyRegion(pRegion);
+}
+
+__throws void MemorySim_ShareReadOnlyRegions(IMemory* pDest, IMemory* pSrc)
+{
+    MemorySim*    pThis = (MemorySim*)pDest;
+    MemorySim*    pSource = (MemorySim*)pSrc;
+    MemoryRegion* pCurr;
+
+    for (pCurr = pSource->pHeadRegion ; pCurr ; pCurr = pCurr->pNext)
+    {
+        MemoryRegion* pRegion;
+
+        if (!pCurr->isReadOnly || pCurr->isAlias)
+            continue;
+        loadRegionIfNeeded(pSource, pCurr);
+        pRegion = allocate(pThis, sizeof(*pRegion));
+        pRegion->baseAddress = pCurr->baseAddress;
+        pRegion->size = pCurr->size;
+        pRegion->pData = pCurr->pData;
+        pRegion->isReadOnly = 1;
+        addRegionToTail(pThis, pRegion);
+    }
 }
 
 static MemoryRegion* findMatchingRegion(MemorySim* pThis, uint32_t* pAddress, uint32_t size)
+{
+    MemoryRegion* pRegion = lookupRegion(pThis, pAddress, size);
+    if (!pRegion)
+        __throw(busErrorException);
+    return pRegion;
+}
+
+static MemoryRegion* lookupRegion(MemorySim* pThis, uint32_t* pAddress, uint32_t size)
 {
     uint32_t address = *pAddress;
     MemoryRegion* pCurr = pThis->pHeadRegion;
 
+    pThis->stats.lookups++;
     while (pCurr)
     {
         MemoryRegion* pNext = pCurr->pNext;
         if (address >= pCurr->baseAddress && (uint64_t)address + size <= (uint64_t)pCurr->baseAddress + pCurr->size)
         {
+            pThis->stats.hits++;
             if (pCurr->isAlias)
             {
                 *pAddress = (address - pCurr->baseAddress) + pCurr->redirectAddress;
@@ -264,16 +398,34 @@ static MemoryRegion* findMatchingRegion(MemorySim* pThis, uint32_t* pAddress, ui
         }
         pCurr = pNext;
     }
-    __throw(busErrorException);
+    pThis->stats.misses++;
+    return NULL;
 }
 
-static void allocateReadCountArrayForReadOnlyRegion(MemoryRegion* pRegion)
+static void allocateReadCountsIfNeeded(MemorySim* pThis, MemoryRegion* pRegion)
 {
     uint32_t halfWordCount = pRegion->size / sizeof(uint16_t);
-    pRegion->pReadCounts = throwingZeroedMalloc(halfWordCount * sizeof(uint32_t));
+
+    /* Read-only regions only get a read count array on their first fetch so that making a large FLASH image read-only
+       doesn't cost time proportional to its size. */
+    if (!pRegion->isReadOnly || pRegion->pReadCounts)
+        return;
+    pRegion->pReadCounts = allocate(pThis, halfWordCount * sizeof(uint32_t));
     pRegion->readCounts = halfWordCount;
 }
 
+static int tryAllocateReadCounts(MemorySim* pThis, MemoryRegion* pRegion)
+{
+    __try
+        allocateReadCountsIfNeeded(pThis, pRegion);
+    __catch
+    {
+        clearExceptionCode();
+        return FALSE;
+    }
+    return TRUE;
+}
+
 
 __throws void MemorySim_CreateRegionsFromFlashImage(IMemory* pMemory, const void* pFlashImage, uint32_t flashImageSize)
 {
@@ -345,7 +497,25 @@ static void freeLastRegion(MemorySim* pThis)
     else
         pPrev->pNext = NULL;
     pThis->pTailRegion = pPrev;
-    freeRegion(pCurr);
+    /* The last region added is at the front of the loader list if it has a loader. */
+    if (pCurr && pCurr == pThis->pLoaderRegions)
+        pThis->pLoaderRegions = pCurr->pNextWithLoader;
+    if (pCurr)
+        releaseRegion(pCurr);
+}
+
+static void loadRegionIfNeeded(MemorySim* pThis, MemoryRegion* pRegion)
+{
+    if (pRegion->pData || !pRegion->pLoader)
+        return;
+
+    /* If the load throws, the region is left unloaded so that the next access will try again with the same buffer. */
+    if (!pRegion->pLoadBuffer)
+        pRegion->pLoadBuffer = allocate(pThis, pRegion->size);
+    pRegion->pLoader->load(pRegion->pLoader, pRegion->sourceOffset, pRegion->pLoadBuffer, pRegion->size);
+    pRegion->pData = pRegion->pLoadBuffer;
+    pThis->stats.lazyRegionLoads++;
+    pThis->stats.bytesCopied += pRegion->size;
 }
 
 
@@ -383,10 +553,9 @@ static size_t countRegions(MemorySim* pThis)
 
 static void allocateMemoryMapXML(MemorySim* pThis, size_t allocSize)
 {
-    char* pRealloc = realloc(pThis->pMemoryMapXML, allocSize);
-    if (!pRealloc)
-        __throw(outOfMemoryException);
-    pThis->pMemoryMapXML = pRealloc;
+    pThis->pMemoryMapXML = Arena_Realloc(&pThis->arena, pThis->pMemoryMapXML, pThis->memoryMapXMLSize, allocSize);
+    if (allocSize > pThis->memoryMapXMLSize)
+        pThis->memoryMapXMLSize = allocSize;
 }
 
 static void appendMemoryMapXmlHeader(MemorySim* pThis, SizedBuffer* pBuffer)
@@ -439,6 +608,22 @@ __throws const void* MemorySim_MapSimulatedAddressToHostAddressForRead(IMemory*
 }
 
 
+__throws uint16_t MemorySim_ReadData16(IMemory* pMemory, uint32_t address)
+{
+    return *(uint16_t*)getDataPointer((MemorySim*)pMemory, address, sizeof(uint16_t), READING, ENABLE_WATCHPOINT_CHECK);
+}
+
+
+int MemorySim_TryReadData16(IMemory* pMemory, uint32_t address, uint16_t* pValue)
+{
+    uint16_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(*pValue), READING);
+    if (!pData)
+        return FALSE;
+    *pValue = *pData;
+    return TRUE;
+}
+
+
 __throws uint32_t MemorySim_GetFlashReadCount(IMemory* pMemory, uint32_t address)
 {
     MemorySim*    pThis = (MemorySim*)pMemory;
@@ -447,10 +632,232 @@ __throws uint32_t MemorySim_GetFlashReadCount(IMemory* pMemory, uint32_t address
 
     if (!pRegion->isReadOnly)
         __throw(busErrorException);
+    if (!pRegion->pReadCounts)
+        return 0;
     return pRegion->pReadCounts[regionOffset / sizeof(uint16_t)];
 }
 
 
+size_t MemorySim_GetRegionCount(IMemory* pMemory)
+{
+    return countRegions((MemorySim*)pMemory);
+}
+
+
+int MemorySim_FindReadOnlyRegion(IMemory* pMemory, uint32_t address, uint32_t* pBaseAddress, uint32_t* pSize)
+{
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pCurr;
+
+    for (pCurr = pThis->pHeadRegion ; pCurr ; pCurr = pCurr->pNext)
+    {
+        if (address >= pCurr->baseAddress && address - pCurr->baseAddress < pCurr->size)
+        {
+            if (!pCurr->isReadOnly)
+                return FALSE;
+            *pBaseAddress = pCurr->baseAddress;
+            *pSize = pCurr->size;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+
+int MemorySim_FindNextMappedAddress(IMemory* pMemory, uint32_t address, uint32_t* pNextAddress)
+{
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pCurr;
+
+    for (pCurr = pThis->pHeadRegion ; pCurr ; pCurr = pCurr->pNext)
+    {
+        if (address >= pCurr->baseAddress && address - pCurr->baseAddress < pCurr->size)
+        {
+            *pNextAddress = address;
+            return TRUE;
+        }
+    }
+    return findNextRegionAbove(pThis, address, pNextAddress);
+}
+
+
+__throws MemoryRegionInfo MemorySim_GetRegionInfo(IMemory* pMemory, size_t index)
+{
+    MemorySim*       pThis = (MemorySim*)pMemory;
+    MemoryRegion*    pCurr = pThis->pHeadRegion;
+    MemoryRegionInfo info;
+
+    while (pCurr && index--)
+        pCurr = pCurr->pNext;
+    if (!pCurr)
+        __throw(bufferOverrunException);
+    loadRegionIfNeeded(pThis, pCurr);
+
+    info.pData = pCurr->isAlias ? NULL : pCurr->pData;
+    info.baseAddress = pCurr->baseAddress;
+    info.size = pCurr->size;
+    info.isReadOnly = pCurr->isReadOnly;
+    info.isAlias = pCurr->isAlias;
+    return info;
+}
+
+
+__throws const void* MemorySim_MapSimulatedAddressToHostSpan(IMemory* pMemory, uint32_t address, uint32_t* pSpanSize)
+{
+    HostSpan span;
+
+    if (!findHostSpan((MemorySim*)pMemory, address, &span))
+        return NULL;
+    *pSpanSize = span.size;
+    return span.pData;
+}
+
+
+__throws int MemorySim_Search(IMemory* pMemory, uint32_t address, uint32_t length,
+                              const void* pPattern, uint32_t patternSize, uint32_t* pFoundAddress)
+{
+    MemorySim*     pThis = (MemorySim*)pMemory;
+    const uint8_t* pBytes = (const uint8_t*)pPattern;
+    uint64_t       endAddress = (uint64_t)address + length;
+    uint64_t       curr = address;
+
+    if (endAddress > 0x100000000ULL)
+        endAddress = 0x100000000ULL;
+    if (patternSize == 0)
+        return FALSE;
+
+    while (curr + patternSize <= endAddress)
+    {
+        HostSpan       span;
+        uint64_t       spanEnd;
+        uint32_t       overlap;
+        const uint8_t* pMatch;
+
+        if (!findHostSpan(pThis, (uint32_t)curr, &span))
+        {
+            uint32_t nextBase = 0;
+
+            if (!findNextRegionAbove(pThis, (uint32_t)curr, &nextBase))
+                return FALSE;
+            curr = nextBase;
+            continue;
+        }
+
+        spanEnd = curr + span.size;
+        if (spanEnd > endAddress)
+            spanEnd = endAddress;
+        pMatch = searchSpan(span.pData, (size_t)(spanEnd - curr), pBytes, patternSize);
+        if (pMatch)
+        {
+            *pFoundAddress = (uint32_t)(curr + (pMatch - span.pData));
+            return TRUE;
+        }
+
+        /* Matches starting in the last few bytes of this span may continue into an adjacent region. */
+        overlap = patternSize - 1;
+        if (overlap > spanEnd - curr)
+            overlap = (uint32_t)(spanEnd - curr);
+        for ( ; overlap > 0 ; overlap--)
+        {
+            uint32_t start = (uint32_t)(spanEnd - overlap);
+            if (matchesAcrossSpans(pThis, start, endAddress, pBytes, patternSize))
+            {
+                *pFoundAddress = start;
+                return TRUE;
+            }
+        }
+        curr = spanEnd;
+    }
+    return FALSE;
+}
+
+static int findHostSpan(MemorySim* pThis, uint32_t address, HostSpan* pSpan)
+{
+    MemoryRegion* pCurr = pThis->pHeadRegion;
+
+    while (pCurr)
+    {
+        uint64_t regionEnd = (uint64_t)pCurr->baseAddress + pCurr->size;
+        if (address >= pCurr->baseAddress && address < regionEnd)
+        {
+            MemoryRegion* pTarget = pCurr->isAlias ? pCurr->pRedirect : pCurr;
+            uint32_t      offset = address - pCurr->baseAddress;
+
+            if (pCurr->isAlias)
+                offset += pCurr->redirectAddress - pTarget->baseAddress;
+            loadRegionIfNeeded(pThis, pTarget);
+            pSpan->pData = pTarget->pData + offset;
+            pSpan->size = (uint32_t)(regionEnd - address);
+            return TRUE;
+        }
+        pCurr = pCurr->pNext;
+    }
+    return FALSE;
+}
+
+static int findNextRegionAbove(MemorySim* pThis, uint32_t address, uint32_t* pBaseAddress)
+{
+    MemoryRegion* pCurr = pThis->pHeadRegion;
+    int           found = FALSE;
+
+    while (pCurr)
+    {
+        if (pCurr->baseAddress > address && (!found || pCurr->baseAddress < *pBaseAddress))
+        {
+            *pBaseAddress = pCurr->baseAddress;
+            found = TRUE;
+        }
+        pCurr = pCurr->pNext;
+    }
+    return found;
+}
+
+static const uint8_t* searchSpan(const uint8_t* pStart, size_t size, const uint8_t* pPattern, uint32_t patternSize)
+{
+    const uint8_t* pCurr = pStart;
+    const uint8_t* pLast;
+
+    if (size < patternSize)
+        return NULL;
+    /* memmem() isn't portable so let memchr() find candidates for the first byte. */
+    pLast = pStart + size - patternSize;
+    while (pCurr <= pLast)
+    {
+        pCurr = memchr(pCurr, pPattern[0], pLast - pCurr + 1);
+        if (!pCurr)
+            return NULL;
+        if (0 == memcmp(pCurr, pPattern, patternSize))
+            return pCurr;
+        pCurr++;
+    }
+    return NULL;
+}
+
+static int matchesAcrossSpans(MemorySim* pThis, uint32_t address, uint64_t endAddress,
+                              const uint8_t* pPattern, uint32_t patternSize)
+{
+    uint32_t matched = 0;
+
+    if ((uint64_t)address + patternSize > endAddress)
+        return FALSE;
+    while (matched < patternSize)
+    {
+        HostSpan span;
+        uint32_t count;
+
+        if (!findHostSpan(pThis, address + matched, &span))
+            return FALSE;
+        count = patternSize - matched;
+        if (count > span.size)
+            count = span.size;
+        if (0 != memcmp(span.pData, pPattern + matched, count))
+            return FALSE;
+        matched += count;
+    }
+    return TRUE;
+}
+
+
 __throws void MemorySim_SetHardwareBreakpoint(IMemory* pMemory, uint32_t address, uint32_t size)
 {
     setWatchpoint(pMemory, address, size, WATCHPOINT_BREAKPOINT);
@@ -458,7 +865,8 @@ __throws void MemorySim_SetHardwareBreakpoint(IMemory* pMemory, uint32_t address
 
 static void setWatchpoint(IMemory* pMemory, uint32_t address, uint32_t size, WatchpointType type)
 {
-    MemoryRegion* pRegion = findMatchingRegion((MemorySim*)pMemory, &address, size);
+    MemorySim*    pThis = (MemorySim*)pMemory;
+    MemoryRegion* pRegion = findMatchingRegion(pThis, &address, size);
     uint32_t      endAddress = address + size;
     Watchpoint    watchpoint = {type, address, endAddress};
     uint32_t      i;
@@ -466,7 +874,7 @@ static void setWatchpoint(IMemory* pMemory, uint32_t address, uint32_t size, Wat
 
     if (match == FOUND)
         return;
-    growWatchpointArrayIfNeeded(pRegion, pRegion->watchpointCount + 1);
+    growWatchpointArrayIfNeeded(pThis, pRegion, pRegion->watchpointCount + 1);
     memmove(&pRegion->pWatchpoints[i+1],
             &pRegion->pWatchpoints[i],
             sizeof(*pRegion->pWatchpoints) * (pRegion->watchpointCount - i));
@@ -515,16 +923,20 @@ static int watchpointsMatch(const Watchpoint* p1, const Watchpoint* p2)
     return 0 == memcmp(p1, p2, sizeof(*p1));
 }
 
-static void growWatchpointArrayIfNeeded(MemoryRegion* pRegion, uint32_t requiredSize)
+static void growWatchpointArrayIfNeeded(MemorySim* pThis, MemoryRegion* pRegion, uint32_t requiredSize)
 {
-    if (requiredSize > pRegion->watchpointAlloc)
-    {
-        Watchpoint* pRealloc = realloc(pRegion->pWatchpoints, sizeof(*pRegion->pWatchpoints) * requiredSize);
-        if (!pRealloc)
-            __throw(outOfMemoryException);
-        pRegion->pWatchpoints = pRealloc;
-        pRegion->watchpointAlloc = requiredSize;
-    }
+    uint32_t newAlloc;
+
+    if (requiredSize <= pRegion->watchpointAlloc)
+        return;
+    /* Grow geometrically since arrays which can't be grown in place leave their old copy in the arena. */
+    newAlloc = pRegion->watchpointAlloc ? pRegion->watchpointAlloc * 2 : 4;
+    if (newAlloc < requiredSize)
+        newAlloc = requiredSize;
+    pRegion->pWatchpoints = Arena_Realloc(&pThis->arena, pRegion->pWatchpoints,
+                                          sizeof(*pRegion->pWatchpoints) * pRegion->watchpointAlloc,
+                                          sizeof(*pRegion->pWatchpoints) * newAlloc);
+    pRegion->watchpointAlloc = newAlloc;
 }
 
 
@@ -562,6 +974,12 @@ __throws void MemorySim_ClearHardwareWatchpoint(IMemory* pMemory, uint32_t addre
 }
 
 
+MemorySimStats MemorySim_GetStats(IMemory* pMemory)
+{
+    return ((MemorySim*)pMemory)->stats;
+}
+
+
 int  MemorySim_WasWatchpointEncountered(IMemory* pMemory)
 {
     MemorySim* pThis = (MemorySim*)pMemory;
@@ -581,7 +999,7 @@ static uint32_t read32(IMemory* pMemory, uint32_t address)
 
 static uint16_t read16(IMemory* pMemory, uint32_t address)
 {
-    return *(uint16_t*)getDataPointer((MemorySim*)pMemory, address, sizeof(uint16_t), READING, ENABLE_WATCHPOINT_CHECK);
+    return *(uint16_t*)getDataPointer((MemorySim*)pMemory, address, sizeof(uint16_t), FETCHING, ENABLE_WATCHPOINT_CHECK);
 }
 
 static uint8_t read8(IMemory* pMemory, uint32_t address)
@@ -604,27 +1022,127 @@ static void write8(IMemory* pMemory, uint32_t address, uint8_t value)
     *(uint8_t*)getDataPointer((MemorySim*)pMemory, address, sizeof(uint8_t), WRITING, ENABLE_WATCHPOINT_CHECK) = value;
 }
 
+static int tryRead32(IMemory* pMemory, uint32_t address, uint32_t* pValue)
+{
+    uint32_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(*pValue), READING);
+    if (!pData)
+        return FALSE;
+    *pValue = *pData;
+    return TRUE;
+}
+
+static int tryRead16(IMemory* pMemory, uint32_t address, uint16_t* pValue)
+{
+    uint16_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(*pValue), FETCHING);
+    if (!pData)
+        return FALSE;
+    *pValue = *pData;
+    return TRUE;
+}
+
+static int tryRead8(IMemory* pMemory, uint32_t address, uint8_t* pValue)
+{
+    uint8_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(*pValue), READING);
+    if (!pData)
+        return FALSE;
+    *pValue = *pData;
+    return TRUE;
+}
+
+static int tryWrite32(IMemory* pMemory, uint32_t address, uint32_t value)
+{
+    uint32_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(value), WRITING);
+    if (!pData)
+        return FALSE;
+    *pData = value;
+    return TRUE;
+}
+
+static int tryWrite16(IMemory* pMemory, uint32_t address, uint16_t value)
+{
+    uint16_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(value), WRITING);
+    if (!pData)
+        return FALSE;
+    *pData = value;
+    return TRUE;
+}
+
+static int tryWrite8(IMemory* pMemory, uint32_t address, uint8_t value)
+{
+    uint8_t* pData = tryGetDataPointer((MemorySim*)pMemory, address, sizeof(value), WRITING);
+    if (!pData)
+        return FALSE;
+    *pData = value;
+    return TRUE;
+}
+
 
 static void* getDataPointer(MemorySim* pThis, uint32_t address, uint32_t size, AccessType type, int checkWatchpoints)
 {
     MemoryRegion* pRegion = findMatchingRegion(pThis, &address, size);
-    uint32_t regionOffset = address - pRegion->baseAddress;
+    uint8_t*      pData;
+
     if (type == WRITING && pRegion->isReadOnly)
         __throw(busErrorException);
-    if (type == READING && size == sizeof(uint16_t) && pRegion->pReadCounts)
+    loadRegionIfNeeded(pThis, pRegion);
+    if (type == FETCHING)
+        allocateReadCountsIfNeeded(pThis, pRegion);
+    pData = accessRegionData(pThis, pRegion, address, size, type, checkWatchpoints);
+    if (!pData)
+        __throw(hardwareBreakpointException);
+    return pData;
+}
+
+static void* tryGetDataPointer(MemorySim* pThis, uint32_t address, uint32_t size, AccessType type)
+{
+    MemoryRegion* pRegion = lookupRegion(pThis, &address, size);
+
+    if (!pRegion || (type == WRITING && pRegion->isReadOnly))
+        return NULL;
+    if (!pRegion->pData && pRegion->pLoader && !tryLoadRegion(pThis, pRegion))
+        return NULL;
+    if (type == FETCHING && pRegion->isReadOnly && !pRegion->pReadCounts && !tryAllocateReadCounts(pThis, pRegion))
+        return NULL;
+    return accessRegionData(pThis, pRegion, address, size, type, ENABLE_WATCHPOINT_CHECK);
+}
+
+static int tryLoadRegion(MemorySim* pThis, MemoryRegion* pRegion)
+{
+    /* Only the first access to a lazily loaded region has to pay for setting up an exception handler. */
+    __try
+        loadRegionIfNeeded(pThis, pRegion);
+    __catch
+    {
+        clearExceptionCode();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static uint8_t* accessRegionData(MemorySim* pThis,
+                                 MemoryRegion* pRegion,
+                                 uint32_t address, uint32_t size, AccessType type, int checkWatchpoints)
+{
+    uint32_t regionOffset = address - pRegion->baseAddress;
+
+    if (type == FETCHING && pRegion->pReadCounts)
         pRegion->pReadCounts[regionOffset / sizeof(uint16_t)]++;
-    if (checkWatchpoints)
-        checkForBreakWatchPoint(pThis, pRegion, address, size, type);
+    if (checkWatchpoints && checkForBreakWatchPoint(pThis, pRegion, address, size, type))
+        return NULL;
+    pThis->stats.bytesCopied += size;
     return pRegion->pData + regionOffset;
 }
 
-static void checkForBreakWatchPoint(MemorySim* pThis,
-                                    MemoryRegion* pRegion,
-                                    uint32_t address, uint32_t size, AccessType type)
+/* Returns TRUE if the access hit a hardware breakpoint. */
+static int checkForBreakWatchPoint(MemorySim* pThis,
+                                   MemoryRegion* pRegion,
+                                   uint32_t address, uint32_t size, AccessType type)
 {
     uint32_t endAddress = address + size;
     uint32_t i;
 
+    if (pRegion->watchpointCount > 0)
+        pThis->stats.watchpointChecks++;
     for (i = 0 ; i < pRegion->watchpointCount ; i++)
     {
         Watchpoint* pWatchpoint = &pRegion->pWatchpoints[i];
@@ -633,8 +1151,8 @@ static void checkForBreakWatchPoint(MemorySim* pThis,
             continue;
         if (pWatchpoint->type == WATCHPOINT_BREAKPOINT)
         {
-            if (size == sizeof(uint16_t) && accessInRange(pWatchpoint, address, endAddress))
-                __throw(hardwareBreakpointException);
+            if (type == FETCHING && accessInRange(pWatchpoint, address, endAddress))
+                return TRUE;
         }
         else if (accessInRange(pWatchpoint, address, endAddress))
         {
@@ -642,9 +1160,10 @@ static void checkForBreakWatchPoint(MemorySim* pThis,
         }
         else if (pWatchpoint->startAddress > address)
         {
-            return;
+            return FALSE;
         }
     }
+    return FALSE;
 }
 
 static int accessInRange(Watchpoint* pWatchpoint, uint32_t startAddress, uint32_t endAddress)
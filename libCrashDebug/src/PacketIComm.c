@@ -0,0 +1,592 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <common.h>
+#include <Crc32.h>
+#include <MallocFailureInject.h>
+#include <PacketIComm.h>
+
+
+/* Implementation of IComm interface which buffers each packet received from the wrapped IComm.  Packets claimed by a
+   handler are answered directly and never seen by the MRI core.  Everything else is replayed to the MRI core as it
+   arrives. */
+typedef enum ReceiveState
+{
+    OUTSIDE_PACKET,
+    BUFFERING_PACKET,
+    PASSING_DATA,
+    PASSING_CHECKSUM
+} ReceiveState;
+
+/* Room for the '$' and "#xx" around the largest request offered to the handlers. */
+#define MAX_PACKET_SIZE (PACKET_ICOMM_MAX_REQUEST_SIZE + 4)
+
+/* Must be a power of 2. */
+#define CACHE_BUCKET_COUNT 256
+
+typedef struct RegisteredHandler
+{
+    PacketHandler handler;
+    void*         pHandlerObject;
+} RegisteredHandler;
+
+/* What a request means for the response cache. */
+typedef enum CacheAction
+{
+    CACHE_IGNORE,
+    CACHE_LOOKUP,
+    CACHE_FLUSH
+} CacheAction;
+
+/* State of the capture of the MRI core's response to a cacheable request. */
+typedef enum CaptureState
+{
+    CAPTURE_WAITING_FOR_START,
+    CAPTURE_DATA,
+    CAPTURE_CHECKSUM
+} CaptureState;
+
+/* The request is stored directly after the entry and is followed by the response, neither of which are NUL
+   terminated. */
+typedef struct CacheEntry
+{
+    struct CacheEntry* pNext;
+    uint32_t           hash;
+    size_t             requestLength;
+    size_t             responseLength;
+} CacheEntry;
+
+typedef struct PacketIComm
+{
+    ICommVTable*      pVTable;
+    IComm*            pWrappedComm;
+    RegisteredHandler handlers[PACKET_ICOMM_MAX_HANDLERS];
+    size_t            handlerCount;
+    ReceiveState      receiveState;
+    size_t            packetLength;
+    size_t            hashIndex;
+    size_t            replayIndex;
+    size_t            replayLength;
+    size_t            checksumCharsPassed;
+    int               isWaitingForAck;
+    const char*       pLastResponse;
+    size_t            lastResponseLength;
+    CacheEntry*       buckets[CACHE_BUCKET_COUNT];
+    size_t            maxCacheSize;
+    size_t            cacheSize;
+    CacheEntry*       pCapture;
+    size_t            captureAllocSize;
+    CaptureState      captureState;
+    size_t            captureChecksumChars;
+    char              packet[MAX_PACKET_SIZE];
+    char              response[PACKET_ICOMM_MAX_RESPONSE_SIZE];
+} PacketIComm;
+
+static int  receivePacketChar(PacketIComm* pThis, int character);
+static int  bufferPacketChar(PacketIComm* pThis, int character);
+static void startReplay(PacketIComm* pThis);
+static int  isReplaying(PacketIComm* pThis);
+static int  handlePacket(PacketIComm* pThis);
+static int  hasValidChecksum(PacketIComm* pThis);
+static int  offerPacketToHandlers(PacketIComm* pThis);
+static void sendResponse(PacketIComm* pThis, const char* pResponse, size_t responseLength);
+static int  isCacheEnabled(PacketIComm* pThis);
+static CacheAction getCacheAction(const char* pRequest, size_t requestLength);
+static int  startsWith(const char* pRequest, size_t requestLength, const char* pPrefix);
+static CacheEntry* findCacheEntry(PacketIComm* pThis, const char* pRequest, size_t requestLength);
+static char* getEntryRequest(CacheEntry* pEntry);
+static char* getEntryResponse(CacheEntry* pEntry);
+static size_t getEntrySize(CacheEntry* pEntry);
+static void addCacheEntry(PacketIComm* pThis, const char* pRequest, size_t requestLength,
+                          const char* pResponse, size_t responseLength);
+static void insertCacheEntry(PacketIComm* pThis, CacheEntry* pEntry);
+static void flushCache(PacketIComm* pThis);
+static void startCapture(PacketIComm* pThis, const char* pRequest, size_t requestLength);
+static void captureResponseChar(PacketIComm* pThis, int character);
+static void appendCaptureChar(PacketIComm* pThis, int character);
+static void abandonCapture(PacketIComm* pThis);
+
+static int  hasReceiveData(IComm* pComm);
+static int  waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds);
+static int  receiveChar(IComm* pComm);
+static void sendChar(IComm* pComm, int character);
+static int  shouldStopRun(IComm* pComm);
+static int  isGdbConnected(IComm* pComm);
+
+static ICommVTable g_icommVTable = {hasReceiveData, waitForReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
+
+static PacketIComm g_comm;
+
+
+IComm* PacketIComm_Init(IComm* pWrappedComm)
+{
+    PacketIComm* pThis = &g_comm;
+
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pVTable = &g_icommVTable;
+    pThis->pWrappedComm = pWrappedComm;
+    return (IComm*)pThis;
+}
+
+
+void PacketIComm_Uninit(IComm* pComm)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+
+    if (!pThis)
+        return;
+    abandonCapture(pThis);
+    flushCache(pThis);
+}
+
+
+__throws void PacketIComm_AddHandler(IComm* pComm, PacketHandler handler, void* pHandlerObject)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+
+    if (pThis->handlerCount >= ARRAY_SIZE(pThis->handlers))
+        __throw(invalidArgumentException);
+    pThis->handlers[pThis->handlerCount].handler = handler;
+    pThis->handlers[pThis->handlerCount].pHandlerObject = pHandlerObject;
+    pThis->handlerCount++;
+}
+
+
+void PacketIComm_EnableResponseCache(IComm* pComm, size_t maxCacheSize)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+
+    flushCache(pThis);
+    pThis->maxCacheSize = maxCacheSize;
+}
+
+
+
+/* IComm Interface Implementation. */
+static int hasReceiveData(IComm* pComm)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+    return isReplaying(pThis) || IComm_HasReceiveData(pThis->pWrappedComm);
+}
+
+static int waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+    return isReplaying(pThis) || IComm_WaitForReceiveData(pThis->pWrappedComm, timeoutMilliseconds);
+}
+
+static int receiveChar(IComm* pComm)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+
+    for (;;)
+    {
+        int character;
+
+        if (isReplaying(pThis))
+            return pThis->packet[pThis->replayIndex++];
+        character = IComm_ReceiveChar(pThis->pWrappedComm);
+        if (receivePacketChar(pThis, character))
+            return character;
+    }
+}
+
+static int receivePacketChar(PacketIComm* pThis, int character)
+{
+    switch (pThis->receiveState)
+    {
+    case OUTSIDE_PACKET:
+        if (pThis->isWaitingForAck && (character == '+' || character == '-'))
+        {
+            /* GDB is acknowledging a response which the MRI core never sent so don't pass it along. */
+            if (character == '-')
+                sendResponse(pThis, pThis->pLastResponse, pThis->lastResponseLength);
+            else
+                pThis->isWaitingForAck = FALSE;
+            return FALSE;
+        }
+        pThis->isWaitingForAck = FALSE;
+        if (character != '$')
+            return TRUE;
+        /* A new request means that the MRI core has finished sending any response which was being captured. */
+        abandonCapture(pThis);
+        pThis->receiveState = BUFFERING_PACKET;
+        pThis->packetLength = 0;
+        pThis->hashIndex = 0;
+        return bufferPacketChar(pThis, character);
+    case BUFFERING_PACKET:
+        return bufferPacketChar(pThis, character);
+    case PASSING_DATA:
+        if (character == '#')
+        {
+            pThis->receiveState = PASSING_CHECKSUM;
+            pThis->checksumCharsPassed = 0;
+        }
+        return TRUE;
+    case PASSING_CHECKSUM:
+        if (++pThis->checksumCharsPassed == 2)
+            pThis->receiveState = OUTSIDE_PACKET;
+        return TRUE;
+    }
+    return TRUE;
+}
+
+static int bufferPacketChar(PacketIComm* pThis, int character)
+{
+    pThis->packet[pThis->packetLength++] = character;
+    if (character == '#' && pThis->hashIndex == 0)
+        pThis->hashIndex = pThis->packetLength - 1;
+
+    if (pThis->hashIndex != 0 && pThis->packetLength == pThis->hashIndex + 3)
+    {
+        pThis->receiveState = OUTSIDE_PACKET;
+        if (!handlePacket(pThis))
+            startReplay(pThis);
+    }
+    else if (pThis->packetLength == sizeof(pThis->packet))
+    {
+        /* Too long for the handlers so let the rest flow straight through to the MRI core.  These are typically
+           memory writes so the cached responses can no longer be trusted. */
+        flushCache(pThis);
+        if (pThis->hashIndex != 0)
+        {
+            pThis->receiveState = PASSING_CHECKSUM;
+            pThis->checksumCharsPassed = pThis->packetLength - pThis->hashIndex - 1;
+        }
+        else
+        {
+            pThis->receiveState = PASSING_DATA;
+        }
+        startReplay(pThis);
+    }
+    return FALSE;
+}
+
+static void startReplay(PacketIComm* pThis)
+{
+    pThis->replayIndex = 0;
+    pThis->replayLength = pThis->packetLength;
+}
+
+static int isReplaying(PacketIComm* pThis)
+{
+    return pThis->replayIndex < pThis->replayLength;
+}
+
+static int handlePacket(PacketIComm* pThis)
+{
+    const char* pRequest = &pThis->packet[1];
+    size_t      requestLength = pThis->hashIndex - 1;
+    CacheAction cacheAction = CACHE_IGNORE;
+    CacheEntry* pEntry = NULL;
+
+    if (!hasValidChecksum(pThis))
+        return FALSE;
+    if (isCacheEnabled(pThis))
+        cacheAction = getCacheAction(pRequest, requestLength);
+    if (cacheAction == CACHE_FLUSH)
+        flushCache(pThis);
+    else if (cacheAction == CACHE_LOOKUP)
+        pEntry = findCacheEntry(pThis, pRequest, requestLength);
+
+    if (pEntry)
+    {
+        /* Answer with the already encoded response without involving the handlers or the MRI core. */
+        IComm_SendChar(pThis->pWrappedComm, '+');
+        sendResponse(pThis, getEntryResponse(pEntry), pEntry->responseLength);
+        return TRUE;
+    }
+    if (!offerPacketToHandlers(pThis))
+    {
+        if (cacheAction == CACHE_LOOKUP)
+            startCapture(pThis, pRequest, requestLength);
+        return FALSE;
+    }
+
+    /* Acknowledge the request and then send the response prepared by the handler. */
+    IComm_SendChar(pThis->pWrappedComm, '+');
+    sendResponse(pThis, pThis->response, strlen(pThis->response));
+    if (cacheAction == CACHE_LOOKUP)
+        addCacheEntry(pThis, pRequest, requestLength, pThis->response, strlen(pThis->response));
+    return TRUE;
+}
+
+static int hasValidChecksum(PacketIComm* pThis)
+{
+    unsigned int checksum = 0;
+    unsigned int expected = 0;
+    char         hex[3];
+    size_t       i;
+
+    for (i = 1 ; i < pThis->hashIndex ; i++)
+        checksum += (unsigned char)pThis->packet[i];
+    memcpy(hex, &pThis->packet[pThis->hashIndex + 1], 2);
+    hex[2] = '\0';
+    if (1 != sscanf(hex, "%2x", &expected))
+        return FALSE;
+    return (checksum & 0xFF) == expected;
+}
+
+static int offerPacketToHandlers(PacketIComm* pThis)
+{
+    size_t i;
+
+    for (i = 0 ; i < pThis->handlerCount ; i++)
+    {
+        RegisteredHandler* pHandler = &pThis->handlers[i];
+
+        pThis->response[0] = '\0';
+        if (pHandler->handler(pHandler->pHandlerObject, &pThis->packet[1], pThis->hashIndex - 1,
+                              pThis->response, sizeof(pThis->response)))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void sendResponse(PacketIComm* pThis, const char* pResponse, size_t responseLength)
+{
+    unsigned int checksum = 0;
+    char         checksumHex[3];
+    size_t       i;
+
+    IComm_SendChar(pThis->pWrappedComm, '$');
+    for (i = 0 ; i < responseLength ; i++)
+    {
+        checksum += (unsigned char)pResponse[i];
+        IComm_SendChar(pThis->pWrappedComm, pResponse[i]);
+    }
+    IComm_SendChar(pThis->pWrappedComm, '#');
+    snprintf(checksumHex, sizeof(checksumHex), "%02x", checksum & 0xFF);
+    IComm_SendChar(pThis->pWrappedComm, checksumHex[0]);
+    IComm_SendChar(pThis->pWrappedComm, checksumHex[1]);
+    pThis->pLastResponse = pResponse;
+    pThis->lastResponseLength = responseLength;
+    pThis->isWaitingForAck = TRUE;
+}
+
+static int isCacheEnabled(PacketIComm* pThis)
+{
+    return pThis->maxCacheSize != 0;
+}
+
+static CacheAction getCacheAction(const char* pRequest, size_t requestLength)
+{
+    if (requestLength == 0)
+        return CACHE_IGNORE;
+    /* Reads of memory, registers and the target descriptions only change when the target does. */
+    if (pRequest[0] == 'm' || pRequest[0] == 'g' || pRequest[0] == 'p' ||
+        startsWith(pRequest, requestLength, "qXfer:memory-map:read:") ||
+        startsWith(pRequest, requestLength, "qXfer:features:read:"))
+    {
+        return CACHE_LOOKUP;
+    }
+    /* Other queries don't modify the target, with the exception of monitor commands. */
+    if (pRequest[0] == '?' || pRequest[0] == 'T' ||
+        (pRequest[0] == 'q' && !startsWith(pRequest, requestLength, "qRcmd,")))
+    {
+        return CACHE_IGNORE;
+    }
+    /* Memory and register writes (M, X, G, P) obviously invalidate the cache.  So can anything else which isn't known
+       to be safe, such as resuming execution or switching threads. */
+    return CACHE_FLUSH;
+}
+
+static int startsWith(const char* pRequest, size_t requestLength, const char* pPrefix)
+{
+    size_t prefixLength = strlen(pPrefix);
+    return requestLength >= prefixLength && 0 == memcmp(pRequest, pPrefix, prefixLength);
+}
+
+static CacheEntry* findCacheEntry(PacketIComm* pThis, const char* pRequest, size_t requestLength)
+{
+    uint32_t    hash = Crc32_Calculate(pRequest, requestLength);
+    CacheEntry* pEntry;
+
+    for (pEntry = pThis->buckets[hash & (CACHE_BUCKET_COUNT - 1)] ; pEntry ; pEntry = pEntry->pNext)
+    {
+        if (pEntry->hash == hash && pEntry->requestLength == requestLength &&
+            0 == memcmp(getEntryRequest(pEntry), pRequest, requestLength))
+        {
+            return pEntry;
+        }
+    }
+    return NULL;
+}
+
+static char* getEntryRequest(CacheEntry* pEntry)
+{
+    return (char*)(pEntry + 1);
+}
+
+static char* getEntryResponse(CacheEntry* pEntry)
+{
+    return getEntryRequest(pEntry) + pEntry->requestLength;
+}
+
+static size_t getEntrySize(CacheEntry* pEntry)
+{
+    return sizeof(*pEntry) + pEntry->requestLength + pEntry->responseLength;
+}
+
+/* The cache is only an optimization so allocation failures just mean that the response isn't cached.  Nothing here
+   can throw since it runs underneath the MRI core. */
+static void addCacheEntry(PacketIComm* pThis, const char* pRequest, size_t requestLength,
+                          const char* pResponse, size_t responseLength)
+{
+    CacheEntry* pEntry = malloc(sizeof(*pEntry) + requestLength + responseLength);
+
+    if (!pEntry)
+        return;
+    pEntry->requestLength = requestLength;
+    pEntry->responseLength = responseLength;
+    memcpy(getEntryRequest(pEntry), pRequest, requestLength);
+    memcpy(getEntryResponse(pEntry), pResponse, responseLength);
+    insertCacheEntry(pThis, pEntry);
+}
+
+static void insertCacheEntry(PacketIComm* pThis, CacheEntry* pEntry)
+{
+    size_t entrySize = getEntrySize(pEntry);
+    size_t bucket;
+
+    if (entrySize > pThis->maxCacheSize)
+    {
+        free(pEntry);
+        return;
+    }
+    /* Start over once full rather than tracking which entries are least recently used. */
+    if (pThis->cacheSize + entrySize > pThis->maxCacheSize)
+        flushCache(pThis);
+
+    pEntry->hash = Crc32_Calculate(getEntryRequest(pEntry), pEntry->requestLength);
+    bucket = pEntry->hash & (CACHE_BUCKET_COUNT - 1);
+    pEntry->pNext = pThis->buckets[bucket];
+    pThis->buckets[bucket] = pEntry;
+    pThis->cacheSize += entrySize;
+}
+
+static void flushCache(PacketIComm* pThis)
+{
+    size_t i;
+
+    for (i = 0 ; i < ARRAY_SIZE(pThis->buckets) ; i++)
+    {
+        CacheEntry* pEntry = pThis->buckets[i];
+
+        while (pEntry)
+        {
+            CacheEntry* pNext = pEntry->pNext;
+            free(pEntry);
+            pEntry = pNext;
+        }
+        pThis->buckets[i] = NULL;
+    }
+    pThis->cacheSize = 0;
+}
+
+static void startCapture(PacketIComm* pThis, const char* pRequest, size_t requestLength)
+{
+    size_t allocSize = sizeof(CacheEntry) + requestLength + 64;
+
+    pThis->pCapture = malloc(allocSize);
+    if (!pThis->pCapture)
+        return;
+    pThis->captureAllocSize = allocSize;
+    pThis->captureState = CAPTURE_WAITING_FOR_START;
+    pThis->pCapture->requestLength = requestLength;
+    pThis->pCapture->responseLength = 0;
+    memcpy(getEntryRequest(pThis->pCapture), pRequest, requestLength);
+}
+
+static void captureResponseChar(PacketIComm* pThis, int character)
+{
+    switch (pThis->captureState)
+    {
+    case CAPTURE_WAITING_FOR_START:
+        /* Skips the MRI core's acknowledgement of the request. */
+        if (character == '$')
+            pThis->captureState = CAPTURE_DATA;
+        break;
+    case CAPTURE_DATA:
+        if (character == '#')
+        {
+            pThis->captureState = CAPTURE_CHECKSUM;
+            pThis->captureChecksumChars = 0;
+        }
+        else
+        {
+            appendCaptureChar(pThis, character);
+        }
+        break;
+    case CAPTURE_CHECKSUM:
+        if (++pThis->captureChecksumChars == 2)
+        {
+            insertCacheEntry(pThis, pThis->pCapture);
+            pThis->pCapture = NULL;
+        }
+        break;
+    }
+}
+
+static void appendCaptureChar(PacketIComm* pThis, int character)
+{
+    CacheEntry* pCapture = pThis->pCapture;
+
+    if (getEntrySize(pCapture) == pThis->captureAllocSize)
+    {
+        size_t allocSize = pThis->captureAllocSize * 2;
+
+        if (allocSize - sizeof(*pCapture) > pThis->maxCacheSize)
+            pCapture = NULL;
+        else
+            pCapture = realloc(pCapture, allocSize);
+        if (!pCapture)
+        {
+            abandonCapture(pThis);
+            return;
+        }
+        pThis->pCapture = pCapture;
+        pThis->captureAllocSize = allocSize;
+    }
+    getEntryResponse(pCapture)[pCapture->responseLength++] = character;
+}
+
+static void abandonCapture(PacketIComm* pThis)
+{
+    free(pThis->pCapture);
+    pThis->pCapture = NULL;
+}
+
+static void sendChar(IComm* pComm, int character)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+
+    if (pThis->pCapture)
+        captureResponseChar(pThis, character);
+    IComm_SendChar(pThis->pWrappedComm, character);
+}
+
+static int shouldStopRun(IComm* pComm)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+    return IComm_ShouldStopRun(pThis->pWrappedComm);
+}
+
+static int isGdbConnected(IComm* pComm)
+{
+    PacketIComm* pThis = (PacketIComm*)pComm;
+    return IComm_IsGdbConnected(pThis->pWrappedComm);
+}
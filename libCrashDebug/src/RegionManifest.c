@@ -0,0 +1,432 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <FileFailureInject.h>
+#include <GdbLogParser.h>
+#include <MemorySim.h>
+#include <RegionManifest.h>
+#include <MallocFailureInject.h>
+
+
+typedef struct ManifestEntry
+{
+    const char* pFilename;
+    uint32_t    address;
+    int         isRegion;
+} ManifestEntry;
+
+typedef struct CaptureRegion
+{
+    uint32_t startAddress;
+    uint32_t endAddress;
+} CaptureRegion;
+
+typedef struct CaptureScript
+{
+    CaptureRegion* pRegions;
+    size_t         regionCount;
+    /* Script filename with its extension removed.  The names of the other files are built from it. */
+    char*          pBasePath;
+    char*          pManifestFilename;
+    FILE*          pFile;
+} CaptureScript;
+
+
+static void readMemoryMap(CaptureScript* pThis, const char* pMemoryMapFilename);
+static int parseMemoryMapLine(const char* pLine, CaptureRegion* pRegion);
+static void addCaptureRegion(CaptureScript* pThis, const CaptureRegion* pRegion);
+static void initFilenames(CaptureScript* pThis, const char* pScriptFilename);
+static const char* findBaseName(const char* pPath);
+static char* allocateString(const char* pText, size_t length, const char* pSuffix);
+static void writeScript(CaptureScript* pThis, const char* pScriptFilename, const char* pMemoryMapFilename);
+static void writeQuotedPath(FILE* pFile, const char* pPath);
+static void writeManifest(CaptureScript* pThis);
+static void createFile(CaptureScript* pThis, const char* pFilename);
+static void closeFile(CaptureScript* pThis, const char* pFilename);
+static void freeCaptureScript(CaptureScript* pThis);
+static void parseManifest(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream, const char* pDirectory);
+static char* trimLine(char* pLine);
+static void parseManifestEntry(IMemory* pMem, RegisterContext* pContext, char* pLine, const char* pDirectory,
+                               unsigned int lineNumber);
+static void loadManifestEntry(IMemory* pMem, RegisterContext* pContext, const ManifestEntry* pEntry, const char* pDirectory);
+static void loadManifestFile(IMemory* pMem, RegisterContext* pContext, const ManifestEntry* pEntry, const char* pPath);
+static char* skipWord(char* pText);
+static char* skipSpaces(char* pText);
+static void loadRegionFile(IMemory* pMem, uint32_t baseAddress, const char* pPath);
+static char* allocateDirectory(const char* pManifestFilename);
+static char* allocatePath(const char* pDirectory, const char* pFilename);
+static int isAbsolutePath(const char* pPath);
+
+
+__throws void RegionManifest_WriteCaptureScript(const char* pScriptFilename, const char* pMemoryMapFilename)
+{
+    CaptureScript script;
+
+    memset(&script, 0, sizeof(script));
+    __try
+    {
+        readMemoryMap(&script, pMemoryMapFilename);
+        initFilenames(&script, pScriptFilename);
+        writeScript(&script, pScriptFilename, pMemoryMapFilename);
+        writeManifest(&script);
+    }
+    __catch
+    {
+        freeCaptureScript(&script);
+        __rethrow;
+    }
+    freeCaptureScript(&script);
+}
+
+static void readMemoryMap(CaptureScript* pThis, const char* pMemoryMapFilename)
+{
+    FILE* volatile pFile = fopen(pMemoryMapFilename, "r");
+    char           line[256];
+
+    if (!pFile)
+        __throw_msg(fileException, "Failed to open \"%s\" memory map.", pMemoryMapFilename);
+    __try
+    {
+        while (fgets(line, sizeof(line), pFile))
+        {
+            CaptureRegion region;
+            if (parseMemoryMapLine(line, &region))
+                addCaptureRegion(pThis, &region);
+        }
+    }
+    __catch
+    {
+        fclose(pFile);
+        __rethrow;
+    }
+    fclose(pFile);
+
+    if (pThis->regionCount == 0)
+    {
+        __throw_msg(fileFormatException, "Failed to find any read-write regions in \"%s\" memory map.",
+                    pMemoryMapFilename);
+    }
+}
+
+static int parseMemoryMapLine(const char* pLine, CaptureRegion* pRegion)
+{
+    unsigned int  number;
+    char          enabled;
+    unsigned long startAddress;
+    unsigned long endAddress;
+    char          attributes[8];
+
+    /* Regions in the output of GDB's "info mem" command look like: "3   y  \t0x2007c000 0x20084000 rw nocache" */
+    if (5 != sscanf(pLine, "%u %c %lx %lx %7s", &number, &enabled, &startAddress, &endAddress, attributes))
+        return FALSE;
+    if (enabled != 'y' || 0 != strcmp(attributes, "rw") || endAddress <= startAddress || endAddress > 0xFFFFFFFF)
+        return FALSE;
+    pRegion->startAddress = startAddress;
+    pRegion->endAddress = endAddress;
+    return TRUE;
+}
+
+static void addCaptureRegion(CaptureScript* pThis, const CaptureRegion* pRegion)
+{
+    CaptureRegion* pRealloc = realloc(pThis->pRegions, (pThis->regionCount + 1) * sizeof(*pRealloc));
+
+    if (!pRealloc)
+        __throw(outOfMemoryException);
+    pThis->pRegions = pRealloc;
+    pThis->pRegions[pThis->regionCount++] = *pRegion;
+}
+
+static void initFilenames(CaptureScript* pThis, const char* pScriptFilename)
+{
+    size_t      length = strlen(pScriptFilename);
+    const char* pExtension = strrchr(pScriptFilename, '.');
+
+    if (pExtension && pExtension > findBaseName(pScriptFilename))
+        length = pExtension - pScriptFilename;
+    pThis->pBasePath = allocateString(pScriptFilename, length, "");
+    pThis->pManifestFilename = allocateString(pScriptFilename, length, ".manifest");
+}
+
+static const char* findBaseName(const char* pPath)
+{
+    const char* pBaseName = pPath;
+
+    /* Paths can use either separator on Windows. */
+    while (*pPath)
+    {
+        char c = *pPath++;
+        if (c == '/' || c == '\\')
+            pBaseName = pPath;
+    }
+    return pBaseName;
+}
+
+static char* allocateString(const char* pText, size_t length, const char* pSuffix)
+{
+    size_t suffixLength = strlen(pSuffix);
+    char*  pString = malloc(length + suffixLength + 1);
+
+    if (!pString)
+        __throw(outOfMemoryException);
+    memcpy(pString, pText, length);
+    memcpy(pString + length, pSuffix, suffixLength + 1);
+    return pString;
+}
+
+static void writeScript(CaptureScript* pThis, const char* pScriptFilename, const char* pMemoryMapFilename)
+{
+    size_t i;
+
+    createFile(pThis, pScriptFilename);
+    fprintf(pThis->pFile,
+            "# Generated by CrashDebug --capture-script from %s\n"
+            "# Run \"source %s\" from GDB while it is attached to the crashed device and then\n"
+            "# pass %s to the --dump option of CrashDebug.\n"
+            "set pagination off\n",
+            pMemoryMapFilename, pScriptFilename, pThis->pManifestFilename);
+    for (i = 0 ; i < pThis->regionCount ; i++)
+    {
+        fprintf(pThis->pFile, "dump binary memory \"");
+        writeQuotedPath(pThis->pFile, pThis->pBasePath);
+        fprintf(pThis->pFile, "-%08x.bin\" 0x%08x 0x%08x\n",
+                pThis->pRegions[i].startAddress, pThis->pRegions[i].startAddress, pThis->pRegions[i].endAddress);
+    }
+    /* GDB takes the rest of the line as the logging filename so it isn't quoted.  The older "set logging on/off" form
+       is used since "set logging enabled" only exists in GDB 12 and newer, which still accept the older form. */
+    fprintf(pThis->pFile,
+            "set logging file %s-registers.txt\n"
+            "set logging overwrite on\n"
+            "set logging redirect on\n"
+            "set logging on\n"
+            "info all-registers\n"
+            "set logging off\n"
+            "set logging redirect off\n"
+            "set pagination on\n",
+            pThis->pBasePath);
+    closeFile(pThis, pScriptFilename);
+}
+
+static void writeQuotedPath(FILE* pFile, const char* pPath)
+{
+    /* GDB treats backslash as an escape character within quoted filenames. */
+    for ( ; *pPath ; pPath++)
+    {
+        if (*pPath == '\\' || *pPath == '"')
+            fputc('\\', pFile);
+        fputc(*pPath, pFile);
+    }
+}
+
+static void writeManifest(CaptureScript* pThis)
+{
+    /* The manifest ends up in the same directory as the files written by the script so it refers to them by name. */
+    const char* pBaseName = findBaseName(pThis->pBasePath);
+    size_t      i;
+
+    createFile(pThis, pThis->pManifestFilename);
+    fprintf(pThis->pFile, "%s\n", REGION_MANIFEST_SIGNATURE);
+    fprintf(pThis->pFile, "registers %s-registers.txt\n", pBaseName);
+    for (i = 0 ; i < pThis->regionCount ; i++)
+    {
+        fprintf(pThis->pFile, "region 0x%08x %s-%08x.bin\n",
+                pThis->pRegions[i].startAddress, pBaseName, pThis->pRegions[i].startAddress);
+    }
+    closeFile(pThis, pThis->pManifestFilename);
+}
+
+static void createFile(CaptureScript* pThis, const char* pFilename)
+{
+    pThis->pFile = fopen(pFilename, "w");
+    if (!pThis->pFile)
+        __throw_msg(fileException, "Failed to create \"%s\".", pFilename);
+}
+
+static void closeFile(CaptureScript* pThis, const char* pFilename)
+{
+    int hadError = ferror(pThis->pFile);
+
+    hadError |= fclose(pThis->pFile);
+    pThis->pFile = NULL;
+    if (hadError)
+        __throw_msg(fileException, "Failed to write \"%s\".", pFilename);
+}
+
+static void freeCaptureScript(CaptureScript* pThis)
+{
+    if (pThis->pFile)
+        fclose(pThis->pFile);
+    free(pThis->pRegions);
+    free(pThis->pBasePath);
+    free(pThis->pManifestFilename);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+
+__throws void RegionManifest_Load(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream,
+                                  const char* volatile pManifestFilename)
+{
+    char* pDirectory = allocateDirectory(pManifestFilename);
+
+    __try
+    {
+        parseManifest(pMem, pContext, pStream, pDirectory);
+    }
+    __catch
+    {
+        free(pDirectory);
+        __rethrow;
+    }
+    free(pDirectory);
+}
+
+static void parseManifest(IMemory* pMem, RegisterContext* pContext, DumpStream* pStream, const char* pDirectory)
+{
+    char         line[1024];
+    unsigned int lineNumber = 1;
+
+    if (!DumpStream_Gets(pStream, line, sizeof(line)) || 0 != strcmp(trimLine(line), REGION_MANIFEST_SIGNATURE))
+        __throw_msg(fileFormatException, "The region manifest didn't start with \"%s\".", REGION_MANIFEST_SIGNATURE);
+    while (DumpStream_Gets(pStream, line, sizeof(line)))
+    {
+        char* pLine = trimLine(line);
+
+        lineNumber++;
+        if (*pLine == '\0' || *pLine == '#')
+            continue;
+        parseManifestEntry(pMem, pContext, pLine, pDirectory, lineNumber);
+    }
+}
+
+static char* trimLine(char* pLine)
+{
+    char* pEnd = pLine + strlen(pLine);
+
+    pLine = skipSpaces(pLine);
+    while (pEnd > pLine && (pEnd[-1] == '\n' || pEnd[-1] == '\r' || pEnd[-1] == ' ' || pEnd[-1] == '\t'))
+        *--pEnd = '\0';
+    return pLine;
+}
+
+static void parseManifestEntry(IMemory* pMem, RegisterContext* pContext, char* pLine, const char* pDirectory,
+                               unsigned int lineNumber)
+{
+    ManifestEntry entry;
+    char*         pArgs = skipWord(pLine);
+    char*         pAddressEnd = NULL;
+    int           isRegisters = (pArgs - pLine == 9 && 0 == strncmp(pLine, "registers", 9));
+    int           isValid;
+
+    /* Entries are either "registers filename" or "region address filename".  Filenames may contain spaces. */
+    memset(&entry, 0, sizeof(entry));
+    entry.isRegion = (pArgs - pLine == 6 && 0 == strncmp(pLine, "region", 6));
+    isValid = entry.isRegion || isRegisters;
+    pArgs = skipSpaces(pArgs);
+    if (entry.isRegion)
+    {
+        entry.address = strtoul(pArgs, &pAddressEnd, 0);
+        isValid = pAddressEnd != pArgs && (*pAddressEnd == ' ' || *pAddressEnd == '\t');
+        pArgs = skipSpaces(pAddressEnd);
+    }
+    entry.pFilename = pArgs;
+    if (!isValid || *entry.pFilename == '\0')
+        __throw_msg(fileFormatException, "The region manifest contained an invalid entry on line %u.", lineNumber);
+    loadManifestEntry(pMem, pContext, &entry, pDirectory);
+}
+
+static void loadManifestEntry(IMemory* pMem, RegisterContext* pContext, const ManifestEntry* pEntry, const char* pDirectory)
+{
+    char* pPath = allocatePath(pDirectory, pEntry->pFilename);
+
+    __try
+    {
+        loadManifestFile(pMem, pContext, pEntry, pPath);
+    }
+    __catch
+    {
+        free(pPath);
+        __rethrow;
+    }
+    free(pPath);
+}
+
+static void loadManifestFile(IMemory* pMem, RegisterContext* pContext, const ManifestEntry* pEntry, const char* pPath)
+{
+    if (pEntry->isRegion)
+        loadRegionFile(pMem, pEntry->address, pPath);
+    else
+        GdbLogParse(pMem, pContext, pPath);
+}
+
+static char* skipWord(char* pText)
+{
+    while (*pText && *pText != ' ' && *pText != '\t')
+        pText++;
+    return pText;
+}
+
+static char* skipSpaces(char* pText)
+{
+    while (*pText == ' ' || *pText == '\t')
+        pText++;
+    return pText;
+}
+
+static void loadRegionFile(IMemory* pMem, uint32_t baseAddress, const char* pPath)
+{
+    MappedFile mapping;
+
+    /* Copy-on-write so that GDB writes to RAM don't make it back to the captured file. */
+    mapping = MappedFile_Open(pPath, MAPPED_FILE_COPY_ON_WRITE);
+    if (mapping.size == 0)
+        __throw_msg(fileFormatException, "The \"%s\" region file is empty.", pPath);
+    __try
+    {
+        MemorySim_CreateRegionFromMappedFile(pMem, baseAddress, &mapping);
+    }
+    __catch
+    {
+        MappedFile_Close(&mapping);
+        __rethrow;
+    }
+}
+
+static char* allocateDirectory(const char* pManifestFilename)
+{
+    const char* pBaseName;
+
+    if (!pManifestFilename)
+        return NULL;
+    pBaseName = findBaseName(pManifestFilename);
+    if (pBaseName == pManifestFilename)
+        return NULL;
+    return allocateString(pManifestFilename, pBaseName - pManifestFilename, "");
+}
+
+static char* allocatePath(const char* pDirectory, const char* pFilename)
+{
+    if (!pDirectory || isAbsolutePath(pFilename))
+        return allocateString(pFilename, strlen(pFilename), "");
+    return allocateString(pDirectory, strlen(pDirectory), pFilename);
+}
+
+static int isAbsolutePath(const char* pPath)
+{
+    /* Manifests may have been written on Windows so accept X: drive prefixes as well as either separator. */
+    if (pPath[0] == '/' || pPath[0] == '\\')
+        return TRUE;
+    return isalpha((unsigned char)pPath[0]) && pPath[1] == ':';
+}
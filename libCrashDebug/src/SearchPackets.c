@@ -0,0 +1,132 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <MemorySim.h>
+#include <PacketIComm.h>
+#include <SearchPackets.h>
+
+
+#define SEARCH_PREFIX           "qSearch:memory:"
+#define SEARCH_PREFIX_LENGTH    (sizeof(SEARCH_PREFIX) - 1)
+
+typedef struct SearchRequest
+{
+    uint32_t address;
+    uint32_t length;
+    uint32_t patternSize;
+    uint8_t  pattern[PACKET_ICOMM_MAX_REQUEST_SIZE];
+} SearchRequest;
+
+static int parseRequest(SearchRequest* pSearch, const char* pCurr, const char* pEnd);
+static int parseHexField(const char** ppCurr, const char* pEnd, uint32_t* pValue);
+static int unescapePattern(SearchRequest* pSearch, const char* pCurr, const char* pEnd);
+static int search(IMemory* pMemory, const SearchRequest* pSearch, uint32_t* pFoundAddress);
+
+
+int SearchPackets_Handle(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                         char* pResponse, size_t responseSize)
+{
+    SearchRequest searchRequest;
+    uint32_t      foundAddress = 0;
+    int           result;
+
+    if (requestLength < SEARCH_PREFIX_LENGTH || 0 != memcmp(pRequest, SEARCH_PREFIX, SEARCH_PREFIX_LENGTH))
+        return FALSE;
+
+    if (!parseRequest(&searchRequest, pRequest + SEARCH_PREFIX_LENGTH, pRequest + requestLength))
+    {
+        snprintf(pResponse, responseSize, "E01");
+        return TRUE;
+    }
+    result = search((IMemory*)pHandlerObject, &searchRequest, &foundAddress);
+    if (result < 0)
+        snprintf(pResponse, responseSize, "E02");
+    else if (result)
+        snprintf(pResponse, responseSize, "1,%x", foundAddress);
+    else
+        snprintf(pResponse, responseSize, "0");
+    return TRUE;
+}
+
+static int parseRequest(SearchRequest* pSearch, const char* pCurr, const char* pEnd)
+{
+    if (!parseHexField(&pCurr, pEnd, &pSearch->address) || !parseHexField(&pCurr, pEnd, &pSearch->length))
+        return FALSE;
+    return unescapePattern(pSearch, pCurr, pEnd);
+}
+
+static int parseHexField(const char** ppCurr, const char* pEnd, uint32_t* pValue)
+{
+    const char* pCurr = *ppCurr;
+    uint32_t    value = 0;
+
+    if (pCurr >= pEnd || *pCurr == ';')
+        return FALSE;
+    while (pCurr < pEnd && *pCurr != ';')
+    {
+        char digit = *pCurr++;
+
+        if (digit >= '0' && digit <= '9')
+            value = (value << 4) | (digit - '0');
+        else if (digit >= 'a' && digit <= 'f')
+            value = (value << 4) | (digit - 'a' + 10);
+        else if (digit >= 'A' && digit <= 'F')
+            value = (value << 4) | (digit - 'A' + 10);
+        else
+            return FALSE;
+    }
+    if (pCurr >= pEnd)
+        return FALSE;
+    *ppCurr = pCurr + 1;
+    *pValue = value;
+    return TRUE;
+}
+
+static int unescapePattern(SearchRequest* pSearch, const char* pCurr, const char* pEnd)
+{
+    pSearch->patternSize = 0;
+    while (pCurr < pEnd)
+    {
+        uint8_t byte = (uint8_t)*pCurr++;
+
+        if (byte == '}')
+        {
+            if (pCurr >= pEnd)
+                return FALSE;
+            byte = (uint8_t)*pCurr++ ^ 0x20;
+        }
+        pSearch->pattern[pSearch->patternSize++] = byte;
+    }
+    return pSearch->patternSize > 0;
+}
+
+static int search(IMemory* pMemory, const SearchRequest* pSearch, uint32_t* pFoundAddress)
+{
+    volatile int result = 0;
+
+    /* Lazily loaded regions can fail to load part way through the search. */
+    __try
+    {
+        result = MemorySim_Search(pMemory, pSearch->address, pSearch->length, pSearch->pattern, pSearch->patternSize,
+                                  pFoundAddress);
+    }
+    __catch
+    {
+        clearExceptionCode();
+        return -1;
+    }
+    return result;
+}
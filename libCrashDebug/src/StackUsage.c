@@ -0,0 +1,214 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <MallocFailureInject.h>
+#include <MemorySim.h>
+#include <printfSpy.h>
+#include <StackUsage.h>
+
+
+/* Bounds the scan of stacks whose end isn't known. */
+#define MAX_STACK_SIZE              (1024 * 1024)
+
+/* Spans are compared with memcmp(), which the C library vectorizes, against a block holding enough copies of the
+   fill pattern to be started at any byte within it.  Only the block which differs is scanned a byte at a time. */
+#define BLOCK_SIZE                  256
+
+
+static const char* g_stackTopSymbols[] = { "__StackTop", "_estack", "_vStackTop" };
+static const char* g_stackLimitSymbols[] = { "__StackLimit", "_vStackBase" };
+
+
+static void addStacks(StackUsage* pThis, IMemory* pMemory, const ElfSymbols* pSymbols, const RtosThreads* pThreads);
+static int findMainStack(const ElfSymbols* pSymbols, uint32_t* pBase, uint32_t* pEnd);
+static const ElfSymbol* findFirstSymbol(const ElfSymbols* pSymbols, const char** ppNames, size_t nameCount);
+static void addStack(StackUsage* pThis, IMemory* pMemory, const char* pName, uint32_t base, uint32_t end);
+static void fillPatternBlock(uint8_t* pBlock, size_t blockSize, uint32_t fillPattern);
+static uint32_t countMatchingBytes(const uint8_t* pSpan, uint32_t spanSize, const uint8_t* pExpected);
+
+
+__throws void StackUsage_Init(StackUsage* pThis, IMemory* pMemory, const ElfSymbols* pSymbols,
+                              const RtosThreads* pThreads, uint32_t fillPattern)
+{
+    size_t threadCount = pThreads ? pThreads->threadCount : 0;
+
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->fillPattern = fillPattern;
+    pThis->pStacks = malloc((threadCount + 1) * sizeof(*pThis->pStacks));
+    if (!pThis->pStacks)
+        __throw(outOfMemoryException);
+    __try
+    {
+        addStacks(pThis, pMemory, pSymbols, pThreads);
+    }
+    __catch
+    {
+        StackUsage_Uninit(pThis);
+        __rethrow;
+    }
+}
+
+static void addStacks(StackUsage* pThis, IMemory* pMemory, const ElfSymbols* pSymbols, const RtosThreads* pThreads)
+{
+    uint32_t base = 0;
+    uint32_t end = 0;
+    size_t   i;
+
+    if (findMainStack(pSymbols, &base, &end))
+        addStack(pThis, pMemory, "Main", base, end);
+    for (i = 0 ; pThreads && i < pThreads->threadCount ; i++)
+    {
+        const RtosThread* pThread = &pThreads->pThreads[i];
+
+        addStack(pThis, pMemory, pThread->name, pThread->stackBase, pThread->stackEnd);
+    }
+    if (pThis->stackCount == 0)
+        __throw_msg(elfFormatException,
+                    "ELF doesn't contain the __StackLimit/__StackTop or _estack/_Min_Stack_Size symbols needed to find the stack.");
+}
+
+static int findMainStack(const ElfSymbols* pSymbols, uint32_t* pBase, uint32_t* pEnd)
+{
+    const ElfSymbol* pTop = findFirstSymbol(pSymbols, g_stackTopSymbols, ARRAY_SIZE(g_stackTopSymbols));
+    const ElfSymbol* pLimit = findFirstSymbol(pSymbols, g_stackLimitSymbols, ARRAY_SIZE(g_stackLimitSymbols));
+    const ElfSymbol* pMinSize = ElfSymbols_Find(pSymbols, "_Min_Stack_Size");
+
+    if (!pTop)
+        return FALSE;
+    if (pLimit)
+        *pBase = pLimit->address;
+    else if (pMinSize)
+        /* STM32 linker scripts only reserve _Min_Stack_Size bytes (the symbol's value) below _estack. */
+        *pBase = pTop->address - pMinSize->address;
+    else
+        return FALSE;
+    *pEnd = pTop->address;
+    return *pBase < *pEnd;
+}
+
+static const ElfSymbol* findFirstSymbol(const ElfSymbols* pSymbols, const char** ppNames, size_t nameCount)
+{
+    const ElfSymbol* pSymbol = NULL;
+    size_t           i;
+
+    for (i = 0 ; i < nameCount && !pSymbol ; i++)
+        pSymbol = ElfSymbols_Find(pSymbols, ppNames[i]);
+    return pSymbol;
+}
+
+static void addStack(StackUsage* pThis, IMemory* pMemory, const char* pName, uint32_t base, uint32_t end)
+{
+    StackUsageEntry* pEntry = &pThis->pStacks[pThis->stackCount++];
+    uint32_t         maxSize = end ? end - base : MAX_STACK_SIZE;
+
+    memset(pEntry, 0, sizeof(*pEntry));
+    strncpy(pEntry->name, pName, sizeof(pEntry->name) - 1);
+    pEntry->base = base;
+    pEntry->end = end;
+    pEntry->freeBytes = StackUsage_CountFillBytes(pMemory, base, maxSize, pThis->fillPattern, &pEntry->isIncomplete);
+    if (end)
+        pEntry->usedBytes = maxSize - pEntry->freeBytes;
+}
+
+void StackUsage_Uninit(StackUsage* pThis)
+{
+    free(pThis->pStacks);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+__throws uint32_t StackUsage_CountFillBytes(IMemory* pMemory, uint32_t base, uint32_t maxSize, uint32_t fillPattern,
+                                            int* pIsIncomplete)
+{
+    uint8_t  pattern[BLOCK_SIZE + sizeof(uint32_t)];
+    uint32_t count = 0;
+
+    fillPatternBlock(pattern, sizeof(pattern), fillPattern);
+    *pIsIncomplete = FALSE;
+    while (count < maxSize)
+    {
+        uint32_t       spanSize = 0;
+        const uint8_t* pSpan = MemorySim_MapSimulatedAddressToHostSpan(pMemory, base + count, &spanSize);
+        uint32_t       matchCount;
+
+        if (!pSpan)
+        {
+            *pIsIncomplete = TRUE;
+            break;
+        }
+        if (spanSize > maxSize - count)
+            spanSize = maxSize - count;
+        matchCount = countMatchingBytes(pSpan, spanSize, &pattern[(base + count) & 3]);
+        count += matchCount;
+        if (matchCount < spanSize)
+            break;
+    }
+    return count;
+}
+
+static void fillPatternBlock(uint8_t* pBlock, size_t blockSize, uint32_t fillPattern)
+{
+    size_t i;
+
+    /* Stacks are little endian so the pattern's low byte is the one at each 4-byte aligned address. */
+    for (i = 0 ; i < blockSize ; i++)
+        pBlock[i] = (uint8_t)(fillPattern >> (8 * (i & 3)));
+}
+
+static uint32_t countMatchingBytes(const uint8_t* pSpan, uint32_t spanSize, const uint8_t* pExpected)
+{
+    uint32_t offset = 0;
+
+    /* BLOCK_SIZE is a multiple of the pattern size so pExpected stays in phase from one block to the next. */
+    while (offset < spanSize)
+    {
+        uint32_t blockSize = spanSize - offset < BLOCK_SIZE ? spanSize - offset : BLOCK_SIZE;
+
+        if (0 != memcmp(&pSpan[offset], pExpected, blockSize))
+        {
+            uint32_t i = 0;
+
+            while (pSpan[offset + i] == pExpected[i])
+                i++;
+            return offset + i;
+        }
+        offset += blockSize;
+    }
+    return spanSize;
+}
+
+void StackUsage_PrintReport(const StackUsage* pThis)
+{
+    size_t i;
+
+    printf("Stack usage (fill pattern 0x%08X):\n", pThis->fillPattern);
+    for (i = 0 ; i < pThis->stackCount ; i++)
+    {
+        const StackUsageEntry* pEntry = &pThis->pStacks[i];
+        const char*            pNote = "";
+
+        if (pEntry->isIncomplete)
+            pNote = "  (stack isn't fully in dump)";
+        else if (pEntry->freeBytes == 0)
+            pNote = "  OVERFLOW? (no fill pattern left)";
+        if (pEntry->end)
+            printf("  %-16s 0x%08X - 0x%08X  %u of %u bytes used (%u%%), %u free%s\n",
+                   pEntry->name, pEntry->base, pEntry->end, pEntry->usedBytes, pEntry->end - pEntry->base,
+                   (uint32_t)((uint64_t)pEntry->usedBytes * 100 / (pEntry->end - pEntry->base)), pEntry->freeBytes,
+                   pNote);
+        else
+            printf("  %-16s 0x%08X - unknown     ? bytes used, %u free%s\n", pEntry->name, pEntry->base, pEntry->freeBytes, pNote);
+    }
+}
@@ -21,12 +21,13 @@
 typedef struct StandardIComm StandardIComm;
 
 static int  hasReceiveData(IComm* pComm);
+static int  waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds);
 static int  receiveChar(IComm* pComm);
 static void sendChar(IComm* pComm, int character);
 static int  shouldStopRun(IComm* pComm);
 static int  isGdbConnected(IComm* pComm);
 
-static ICommVTable g_icommVTable = {hasReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
+static ICommVTable g_icommVTable = {hasReceiveData, waitForReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
 
 static struct StandardIComm
 {
@@ -66,6 +67,22 @@ static int hasReceiveData(IComm* pComm)
     return hasData;
 }
 
+static int waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds)
+{
+    volatile int hasData = FALSE;
+
+    __try
+    {
+        hasData = Console_WaitForStdInData(timeoutMilliseconds);
+    }
+    __catch
+    {
+        clearExceptionCode();
+        return FALSE;
+    }
+    return hasData;
+}
+
 static int receiveChar(IComm* pComm)
 {
     StandardIComm* pThis = (StandardIComm*)pComm;
@@ -0,0 +1,210 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <Clock.h>
+#include <common.h>
+#include <StatsIComm.h>
+#include <string.h>
+
+
+/* Implementation of IComm interface which forwards all calls to another IComm and tracks the GDB remote serial
+   protocol framing ($data#xx) of the characters flowing in each direction. */
+typedef enum PacketState
+{
+    OUTSIDE_PACKET,
+    PACKET_TYPE,
+    PACKET_DATA,
+    PACKET_CHECKSUM1,
+    PACKET_CHECKSUM2
+} PacketState;
+
+typedef struct StatsIComm
+{
+    ICommVTable* pVTable;
+    IComm*       pWrappedComm;
+    RspStats     stats;
+    uint64_t     startMicroseconds;
+    uint64_t     requestMicroseconds;
+    PacketState  receiveState;
+    PacketState  sendState;
+    int          receiveType;
+    int          requestType;
+    int          isAwaitingResponse;
+} StatsIComm;
+
+static void trackReceivedChar(StatsIComm* pThis, int character);
+static void recordCompletedRequest(StatsIComm* pThis);
+static void trackSentChar(StatsIComm* pThis, int character);
+static void recordCompletedResponse(StatsIComm* pThis);
+static int  packetTypeFromChar(int character);
+
+static int  hasReceiveData(IComm* pComm);
+static int  waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds);
+static int  receiveChar(IComm* pComm);
+static void sendChar(IComm* pComm, int character);
+static int  shouldStopRun(IComm* pComm);
+static int  isGdbConnected(IComm* pComm);
+
+static ICommVTable g_icommVTable = {hasReceiveData, waitForReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
+
+static StatsIComm g_comm;
+
+
+IComm* StatsIComm_Init(IComm* pWrappedComm, uint64_t startMicroseconds)
+{
+    StatsIComm* pThis = &g_comm;
+
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pVTable = &g_icommVTable;
+    pThis->pWrappedComm = pWrappedComm;
+    pThis->startMicroseconds = startMicroseconds;
+    return (IComm*)pThis;
+}
+
+
+void StatsIComm_Uninit(IComm* pComm)
+{
+}
+
+
+const RspStats* StatsIComm_GetStats(IComm* pComm)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+    return &pThis->stats;
+}
+
+
+
+/* IComm Interface Implementation. */
+static int hasReceiveData(IComm* pComm)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+    return IComm_HasReceiveData(pThis->pWrappedComm);
+}
+
+static int waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+    return IComm_WaitForReceiveData(pThis->pWrappedComm, timeoutMilliseconds);
+}
+
+static int receiveChar(IComm* pComm)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+    int         character = IComm_ReceiveChar(pThis->pWrappedComm);
+
+    trackReceivedChar(pThis, character);
+    return character;
+}
+
+static void trackReceivedChar(StatsIComm* pThis, int character)
+{
+    switch (pThis->receiveState)
+    {
+    case OUTSIDE_PACKET:
+        if (character == '$')
+        {
+            /* The '$' is counted once the type of the packet is known. */
+            pThis->receiveState = PACKET_TYPE;
+            return;
+        }
+        pThis->stats.packets[packetTypeFromChar(character)].bytesIn++;
+        return;
+    case PACKET_TYPE:
+        pThis->receiveType = packetTypeFromChar(character);
+        pThis->stats.packets[pThis->receiveType].bytesIn += 2;
+        pThis->receiveState = character == '#' ? PACKET_CHECKSUM1 : PACKET_DATA;
+        return;
+    case PACKET_DATA:
+        if (character == '#')
+            pThis->receiveState = PACKET_CHECKSUM1;
+        break;
+    case PACKET_CHECKSUM1:
+        pThis->receiveState = PACKET_CHECKSUM2;
+        break;
+    case PACKET_CHECKSUM2:
+        pThis->receiveState = OUTSIDE_PACKET;
+        recordCompletedRequest(pThis);
+        break;
+    }
+    pThis->stats.packets[pThis->receiveType].bytesIn++;
+}
+
+static void recordCompletedRequest(StatsIComm* pThis)
+{
+    pThis->stats.packets[pThis->receiveType].packetCount++;
+    pThis->requestType = pThis->receiveType;
+    pThis->requestMicroseconds = Clock_GetMicroseconds();
+    pThis->isAwaitingResponse = TRUE;
+    if (!pThis->stats.hasReceivedPacket)
+    {
+        pThis->stats.hasReceivedPacket = TRUE;
+        pThis->stats.firstPacketMicroseconds = pThis->requestMicroseconds - pThis->startMicroseconds;
+    }
+}
+
+static int packetTypeFromChar(int character)
+{
+    return character & 0x7F;
+}
+
+static void sendChar(IComm* pComm, int character)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+
+    trackSentChar(pThis, character);
+    IComm_SendChar(pThis->pWrappedComm, character);
+}
+
+static void trackSentChar(StatsIComm* pThis, int character)
+{
+    pThis->stats.packets[pThis->requestType].bytesOut++;
+    switch (pThis->sendState)
+    {
+    case OUTSIDE_PACKET:
+        if (character == '$')
+            pThis->sendState = PACKET_DATA;
+        break;
+    case PACKET_TYPE:
+    case PACKET_DATA:
+        if (character == '#')
+            pThis->sendState = PACKET_CHECKSUM1;
+        break;
+    case PACKET_CHECKSUM1:
+        pThis->sendState = PACKET_CHECKSUM2;
+        break;
+    case PACKET_CHECKSUM2:
+        pThis->sendState = OUTSIDE_PACKET;
+        recordCompletedResponse(pThis);
+        break;
+    }
+}
+
+static void recordCompletedResponse(StatsIComm* pThis)
+{
+    if (!pThis->isAwaitingResponse)
+        return;
+    pThis->stats.packets[pThis->requestType].responseMicroseconds += Clock_GetMicroseconds() - pThis->requestMicroseconds;
+    pThis->isAwaitingResponse = FALSE;
+}
+
+static int shouldStopRun(IComm* pComm)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+    return IComm_ShouldStopRun(pThis->pWrappedComm);
+}
+
+static int isGdbConnected(IComm* pComm)
+{
+    StatsIComm* pThis = (StatsIComm*)pComm;
+    return IComm_IsGdbConnected(pThis->pWrappedComm);
+}
@@ -0,0 +1,214 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common.h>
+#include <PacketIComm.h>
+#include <ThreadPackets.h>
+
+
+/* Thread ids sent in each qfThreadInfo/qsThreadInfo response. */
+#define IDS_PER_RESPONSE    16
+
+typedef struct Response
+{
+    char*  pBuffer;
+    size_t size;
+    size_t length;
+} Response;
+
+static int  handleThreadPacket(ThreadPackets* pThis, const char* pData, Response* pResponse);
+static void respondWithThreadIds(ThreadPackets* pThis, Response* pResponse);
+static void respondWithExtraInfo(ThreadPackets* pThis, const char* pThreadId, Response* pResponse);
+static void respondToSelectThread(ThreadPackets* pThis, const char* pThreadId, Response* pResponse);
+static void respondToThreadAlive(ThreadPackets* pThis, const char* pThreadId, Response* pResponse);
+static RtosThread* findThread(ThreadPackets* pThis, const char* pThreadId);
+static void selectThread(ThreadPackets* pThis, RtosThread* pThread);
+static void respond(Response* pResponse, const char* pFormat, ...);
+static void append(Response* pResponse, const char* pFormat, ...);
+static void vappend(Response* pResponse, const char* pFormat, va_list valist);
+
+
+void ThreadPackets_Init(ThreadPackets* pThis, RtosThreads* pThreads, RegisterContext* pContext)
+{
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pThreads = pThreads;
+    pThis->pContext = pContext;
+    pThis->pSelectedThread = FreeRtosThreads_Find(pThreads, pThreads->haltedThreadId);
+}
+
+
+void ThreadPackets_Uninit(ThreadPackets* pThis)
+{
+    /* Leave the context holding the registers from the dump again. */
+    if (pThis && pThis->pThreads)
+        selectThread(pThis, FreeRtosThreads_Find(pThis->pThreads, pThis->pThreads->haltedThreadId));
+}
+
+
+int ThreadPackets_Handle(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                         char* pResponse, size_t responseSize)
+{
+    ThreadPackets* pThis = (ThreadPackets*)pHandlerObject;
+    char           data[PACKET_ICOMM_MAX_REQUEST_SIZE + 1];
+    Response       response;
+
+    if (requestLength >= sizeof(data))
+        return FALSE;
+    memcpy(data, pRequest, requestLength);
+    data[requestLength] = '\0';
+
+    response.pBuffer = pResponse;
+    response.size = responseSize;
+    response.length = 0;
+    return handleThreadPacket(pThis, data, &response);
+}
+
+static int handleThreadPacket(ThreadPackets* pThis, const char* pData, Response* pResponse)
+{
+    if (0 == strcmp(pData, "qfThreadInfo"))
+    {
+        pThis->nextThreadInfoIndex = 0;
+        respondWithThreadIds(pThis, pResponse);
+    }
+    else if (0 == strcmp(pData, "qsThreadInfo"))
+        respondWithThreadIds(pThis, pResponse);
+    else if (0 == strcmp(pData, "qC"))
+        respond(pResponse, "QC%x", pThis->pThreads->haltedThreadId);
+    else if (0 == strncmp(pData, "qThreadExtraInfo,", 17))
+        respondWithExtraInfo(pThis, pData + 17, pResponse);
+    else if (pData[0] == 'H' && (pData[1] == 'g' || pData[1] == 'c'))
+        respondToSelectThread(pThis, pData + 1, pResponse);
+    else if (pData[0] == 'T')
+        respondToThreadAlive(pThis, pData + 1, pResponse);
+    else
+        return FALSE;
+    return TRUE;
+}
+
+static void respondWithThreadIds(ThreadPackets* pThis, Response* pResponse)
+{
+    size_t count = 0;
+
+    if (pThis->nextThreadInfoIndex >= pThis->pThreads->threadCount)
+    {
+        respond(pResponse, "l");
+        return;
+    }
+    respond(pResponse, "m");
+    while (pThis->nextThreadInfoIndex < pThis->pThreads->threadCount && count < IDS_PER_RESPONSE)
+    {
+        append(pResponse, "%s%x", count ? "," : "", pThis->pThreads->pThreads[pThis->nextThreadInfoIndex].id);
+        pThis->nextThreadInfoIndex++;
+        count++;
+    }
+}
+
+static void respondWithExtraInfo(ThreadPackets* pThis, const char* pThreadId, Response* pResponse)
+{
+    RtosThread* pThread = findThread(pThis, pThreadId);
+    char        info[RTOS_THREAD_NAME_SIZE + 48];
+    size_t      i;
+
+    if (!pThread)
+    {
+        respond(pResponse, "E01");
+        return;
+    }
+    snprintf(info, sizeof(info), "%s (%s, priority %u)", pThread->name, pThread->pState, pThread->priority);
+    respond(pResponse, "");
+    for (i = 0 ; info[i] ; i++)
+        append(pResponse, "%02x", (unsigned char)info[i]);
+}
+
+static void respondToSelectThread(ThreadPackets* pThis, const char* pThreadId, Response* pResponse)
+{
+    RtosThread* pThread = NULL;
+
+    /* Threads can't be resumed individually so Hc has no effect.  The running thread is used for g in response to
+       the 0 (any thread) and -1 (all threads) ids. */
+    if (pThreadId[0] == 'c')
+    {
+        respond(pResponse, "OK");
+        return;
+    }
+    if (0 == strcmp(pThreadId + 1, "0") || 0 == strcmp(pThreadId + 1, "-1"))
+        pThread = FreeRtosThreads_Find(pThis->pThreads, pThis->pThreads->haltedThreadId);
+    else
+        pThread = findThread(pThis, pThreadId + 1);
+    if (!pThread)
+    {
+        respond(pResponse, "E01");
+        return;
+    }
+    selectThread(pThis, pThread);
+    respond(pResponse, "OK");
+}
+
+static void respondToThreadAlive(ThreadPackets* pThis, const char* pThreadId, Response* pResponse)
+{
+    respond(pResponse, findThread(pThis, pThreadId) ? "OK" : "E01");
+}
+
+static RtosThread* findThread(ThreadPackets* pThis, const char* pThreadId)
+{
+    char*         pEnd = NULL;
+    unsigned long id = strtoul(pThreadId, &pEnd, 16);
+
+    if (pEnd == pThreadId || *pEnd != '\0')
+        return NULL;
+    return FreeRtosThreads_Find(pThis->pThreads, (uint32_t)id);
+}
+
+static void selectThread(ThreadPackets* pThis, RtosThread* pThread)
+{
+    if (!pThread || pThread == pThis->pSelectedThread)
+        return;
+    /* Keep any registers modified by GDB with the thread they were modified in. */
+    if (pThis->pSelectedThread)
+        pThis->pSelectedThread->context = *pThis->pContext;
+    *pThis->pContext = pThread->context;
+    pThis->pSelectedThread = pThread;
+}
+
+static void respond(Response* pResponse, const char* pFormat, ...)
+{
+    va_list valist;
+
+    pResponse->length = 0;
+    va_start(valist, pFormat);
+    vappend(pResponse, pFormat, valist);
+    va_end(valist);
+}
+
+static void append(Response* pResponse, const char* pFormat, ...)
+{
+    va_list valist;
+
+    va_start(valist, pFormat);
+    vappend(pResponse, pFormat, valist);
+    va_end(valist);
+}
+
+static void vappend(Response* pResponse, const char* pFormat, va_list valist)
+{
+    int length;
+
+    if (pResponse->length >= pResponse->size)
+        return;
+    length = vsnprintf(&pResponse->pBuffer[pResponse->length], pResponse->size - pResponse->length, pFormat, valist);
+    if (length > 0)
+        pResponse->length += length;
+}
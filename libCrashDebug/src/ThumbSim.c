@@ -0,0 +1,2207 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <common.h>
+#include <MemorySim.h>
+#include <ThumbSim.h>
+
+
+/* Bits in XPSR. */
+#define APSR_N          (1U << 31)
+#define APSR_Z          (1U << 30)
+#define APSR_C          (1U << 29)
+#define APSR_V          (1U << 28)
+#define APSR_Q          (1U << 27)
+#define APSR_NZCVQ_MASK 0xF8000000
+#define EPSR_T          (1U << 24)
+#define IPSR_MASK       0x000001FF
+/* ITSTATE[7:2] is stored in XPSR[15:10] and ITSTATE[1:0] in XPSR[26:25]. */
+#define EPSR_IT_MASK    0x0600FC00
+
+/* Each page of the instruction cache covers this many bytes of code. */
+#define PAGE_SHIFT      9
+#define PAGE_SIZE       (1 << PAGE_SHIFT)
+#define PAGE_MASK       (PAGE_SIZE - 1)
+
+/* Condition code for instructions which always execute. */
+#define COND_AL         0xE
+
+/* Bits in DecodedInstruction::flags. */
+#define FLAG_SET_FLAGS              (1 << 0)
+/* 16-bit data processing instructions only set the flags when they aren't in an IT block. */
+#define FLAG_SET_FLAGS_OUTSIDE_IT   (1 << 1)
+#define FLAG_INDEX                  (1 << 2)
+#define FLAG_ADD                    (1 << 3)
+#define FLAG_WBACK                  (1 << 4)
+/* Modified immediate constants which required rotation set the carry flag from their top bit. */
+#define FLAG_CARRY_FROM_IMM         (1 << 5)
+
+typedef enum ShiftType
+{
+    SHIFT_LSL,
+    SHIFT_LSR,
+    SHIFT_ASR,
+    SHIFT_ROR,
+    SHIFT_RRX
+} ShiftType;
+
+typedef enum AluOp
+{
+    ALU_AND,
+    ALU_BIC,
+    ALU_ORR,
+    ALU_ORN,
+    ALU_EOR,
+    ALU_MOV,
+    ALU_MVN,
+    ALU_TST,
+    ALU_TEQ,
+    ALU_ADD,
+    ALU_ADC,
+    ALU_SBC,
+    ALU_SUB,
+    ALU_RSB,
+    ALU_CMP,
+    ALU_CMN
+} AluOp;
+
+typedef enum LoadStoreOp
+{
+    LS_STR,
+    LS_STRH,
+    LS_STRB,
+    LS_LDR,
+    LS_LDRH,
+    LS_LDRSH,
+    LS_LDRB,
+    LS_LDRSB,
+    /* Preload hints are decoded like loads but don't access memory. */
+    LS_HINT
+} LoadStoreOp;
+
+typedef enum MiscOp
+{
+    MISC_SBFX,
+    MISC_UBFX,
+    MISC_BFI,
+    MISC_BFC,
+    MISC_SSAT,
+    MISC_USAT,
+    MISC_MUL,
+    MISC_MLA,
+    MISC_MLS,
+    MISC_SMULL,
+    MISC_UMULL,
+    MISC_SMLAL,
+    MISC_UMLAL,
+    MISC_SDIV,
+    MISC_UDIV,
+    MISC_SXTB,
+    MISC_SXTH,
+    MISC_UXTB,
+    MISC_UXTH,
+    MISC_REV,
+    MISC_REV16,
+    MISC_REVSH,
+    MISC_RBIT,
+    MISC_CLZ
+} MiscOp;
+
+/* Special register numbers (SYSm) used by MRS and MSR. */
+#define SYSM_MSP         8
+#define SYSM_PSP         9
+#define SYSM_PRIMASK     16
+#define SYSM_BASEPRI     17
+#define SYSM_BASEPRI_MAX 18
+#define SYSM_FAULTMASK   19
+#define SYSM_CONTROL     20
+
+/* CONTROL register bits. */
+#define CONTROL_SPSEL    (1U << 1)
+#define CONTROL_MASK     0x7
+
+typedef struct DecodedInstruction DecodedInstruction;
+typedef void (*ExecuteFunction)(ThumbSim* pThis, const DecodedInstruction* pInstruction);
+
+/* An instruction with all of its fields already extracted.  How each field is used depends on the execute function. */
+struct DecodedInstruction
+{
+    ExecuteFunction execute;
+    uint32_t        imm;
+    uint8_t         size;
+    uint8_t         op;
+    uint8_t         d;
+    uint8_t         n;
+    uint8_t         m;
+    uint8_t         a;
+    uint8_t         shiftType;
+    uint8_t         shiftAmount;
+    uint8_t         flags;
+};
+
+/* Instructions are only cached between firstOffset and endOffset, the part of the page in read-only memory.  An entry
+   with a NULL execute pointer hasn't been decoded yet. */
+struct ThumbSimPage
+{
+    ThumbSimPage*       pNext;
+    DecodedInstruction* pInstructions;
+    uint32_t            baseAddress;
+    uint32_t            firstOffset;
+    uint32_t            endOffset;
+};
+
+
+static void                      executeInstructions(ThumbSim* pThis);
+static void                      executeInstruction(ThumbSim* pThis);
+static const DecodedInstruction* fetchDecodedInstruction(ThumbSim* pThis, uint16_t firstHalfWord,
+                                                         DecodedInstruction* pUncached);
+static DecodedInstruction*       findCacheEntry(ThumbSim* pThis, uint32_t address);
+static ThumbSimPage*             findPage(ThumbSim* pThis, uint32_t pageAddress);
+static ThumbSimPage*             createPage(ThumbSim* pThis, uint32_t pageAddress);
+static void*                     tryAllocate(ThumbSim* pThis, size_t size);
+static ThumbSimStopReason        stopReasonFromException(int exceptionCode);
+static uint32_t                  loadItState(uint32_t xpsr);
+static uint32_t                  storeItState(uint32_t xpsr, uint32_t itState);
+static int                       isInITBlock(ThumbSim* pThis);
+static uint32_t                  advanceItState(uint32_t itState);
+static int                       conditionPassed(uint32_t xpsr, uint32_t cond);
+
+static void     decodeInstruction(ThumbSim* pThis, uint16_t firstHalfWord, DecodedInstruction* p);
+static void     decode16(uint32_t instr, DecodedInstruction* p);
+static void     decodeShiftAddSubtractMoveCompare(uint32_t instr, DecodedInstruction* p);
+static void     decodeDataProcessing16(uint32_t instr, DecodedInstruction* p);
+static void     decodeSpecialDataAndBranchExchange(uint32_t instr, DecodedInstruction* p);
+static void     decodeLoadStore16(uint32_t instr, DecodedInstruction* p);
+static void     decodeMisc16(uint32_t instr, DecodedInstruction* p);
+static void     decode32(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeLoadStoreMultiple(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeLoadStoreDualExclusiveTableBranch(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeDataProcessingShiftedRegister(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static int      decodeAluOp32(uint32_t op, uint32_t d, uint32_t n, uint32_t setFlags, DecodedInstruction* p);
+static void     decodeDataProcessingModifiedImmediate(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static uint32_t expandModifiedImmediate(uint32_t imm12, int* pCarryFromImm);
+static void     decodeDataProcessingPlainImmediate(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeBranchesAndMiscControl(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeLoadStoreSingle(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeDataProcessingRegister(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeMultiply(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeLongMultiplyDivide(uint32_t hw1, uint32_t hw2, DecodedInstruction* p);
+static void     decodeImmediateShift(uint32_t type, uint32_t imm5, DecodedInstruction* p);
+static uint32_t signExtend(uint32_t value, uint32_t bitCount);
+
+static uint32_t readRegister(ThumbSim* pThis, uint32_t index);
+static void     writeRegister(ThumbSim* pThis, uint32_t index, uint32_t value);
+static void     branchWritePC(ThumbSim* pThis, uint32_t address);
+static void     bxWritePC(ThumbSim* pThis, uint32_t address);
+static int      shouldSetFlags(ThumbSim* pThis, const DecodedInstruction* p);
+static int      isCarrySet(ThumbSim* pThis);
+static void     setFlags(ThumbSim* pThis, uint32_t result, int carry, int overflow);
+static void     setNZFlags(ThumbSim* pThis, uint32_t result);
+static uint32_t addWithCarry(uint32_t x, uint32_t y, int carryIn, int* pCarryOut, int* pOverflow);
+static uint32_t shiftWithCarry(uint32_t value, uint32_t type, uint32_t amount, int carryIn, int* pCarryOut);
+static uint32_t rotateRight(uint32_t value, uint32_t amount);
+static uint32_t countLeadingZeros(uint32_t value);
+static uint32_t countBits(uint32_t value);
+
+static void executeUndefined(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeBkpt(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeNop(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeAluImmediate(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeAluRegister(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeAluOperation(ThumbSim* pThis, const DecodedInstruction* p, uint32_t operand2, int carry);
+static void executeShiftByRegister(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeAdr(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeMovt(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeBitfieldSaturate(ThumbSim* pThis, const DecodedInstruction* p);
+static uint32_t saturate(ThumbSim* pThis, int64_t value, uint32_t bits, int isSigned);
+static void executeMultiplyDivide(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeExtendReverse(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeLoadStoreImmediate(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeLoadStoreRegister(ThumbSim* pThis, const DecodedInstruction* p);
+static void loadStore(ThumbSim* pThis, const DecodedInstruction* p, uint32_t address);
+static void executeLoadStoreDual(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeLoadExclusive(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeStoreExclusive(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeClrex(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeLoadMultiple(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeStoreMultiple(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeBranch(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeBranchWithLink(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeBranchExchange(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeCompareAndBranch(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeTableBranch(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeIt(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeCps(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeMrs(ThumbSim* pThis, const DecodedInstruction* p);
+static void executeMsr(ThumbSim* pThis, const DecodedInstruction* p);
+static void writeControl(ThumbSim* pThis, uint32_t value);
+static int isThreadMode(ThumbSim* pThis);
+static int isProcessStackActive(ThumbSim* pThis);
+static void initSpecialRegisters(ThumbSim* pThis);
+
+
+void ThumbSim_Init(ThumbSim* pThis, IMemory* pMemory, RegisterContext* pContext)
+{
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pMemory = pMemory;
+    pThis->pContext = pContext;
+    initSpecialRegisters(pThis);
+}
+
+static void initSpecialRegisters(ThumbSim* pThis)
+{
+    const RegisterContext* pContext = pThis->pContext;
+
+    /* The register context only records the stack pointers, so CONTROL.SPSEL is set if SP was the PSP in Thread
+       mode.  PRIMASK, BASEPRI and FAULTMASK aren't captured so they are left cleared. */
+    if (isThreadMode(pThis) && pContext->R[SP] == pContext->R[PSP] && pContext->R[SP] != pContext->R[MSP])
+        pThis->control = CONTROL_SPSEL;
+}
+
+
+void ThumbSim_Uninit(ThumbSim* pThis)
+{
+    Arena_Uninit(&pThis->arena);
+    memset(pThis->buckets, 0, sizeof(pThis->buckets));
+    pThis->pLastPage = NULL;
+}
+
+
+ThumbSimStopReason ThumbSim_Run(ThumbSim* pThis, uint32_t maxInstructions)
+{
+    RegisterContext* pContext = pThis->pContext;
+
+    pThis->instructionsLeft = maxInstructions;
+    pThis->itState = loadItState(pContext->R[XPSR]);
+    __try
+    {
+        executeInstructions(pThis);
+    }
+    __catch
+    {
+        pThis->stopReason = stopReasonFromException(getExceptionCode());
+        clearExceptionCode();
+    }
+    pContext->R[XPSR] = storeItState(pContext->R[XPSR], pThis->itState);
+    return pThis->stopReason;
+}
+
+static void executeInstructions(ThumbSim* pThis)
+{
+    /* Discard any watchpoint hits from before execution started. */
+    MemorySim_WasWatchpointEncountered(pThis->pMemory);
+    pThis->stopReason = THUMB_SIM_STOP_COUNT;
+    while (pThis->instructionsLeft > 0)
+    {
+        executeInstruction(pThis);
+        pThis->instructionsLeft--;
+        pThis->stats.instructions++;
+        if (MemorySim_WasWatchpointEncountered(pThis->pMemory))
+        {
+            pThis->stopReason = THUMB_SIM_STOP_WATCHPOINT;
+            return;
+        }
+    }
+}
+
+static void executeInstruction(ThumbSim* pThis)
+{
+    RegisterContext*          pContext = pThis->pContext;
+    DecodedInstruction        uncached;
+    const DecodedInstruction* pInstruction;
+    uint16_t                  firstHalfWord;
+
+    /* Branching to an even address switches out of Thumb state and the next instruction faults. */
+    if ((pContext->R[XPSR] & EPSR_T) == 0)
+        __throw(undefinedException);
+    pThis->pc = pContext->R[PC] & ~1;
+    firstHalfWord = IMemory_Read16(pThis->pMemory, pThis->pc);
+    pInstruction = fetchDecodedInstruction(pThis, firstHalfWord, &uncached);
+    /* Instruction fetches don't trigger data watchpoints. */
+    MemorySim_WasWatchpointEncountered(pThis->pMemory);
+
+    pThis->nextPC = pThis->pc + pInstruction->size;
+    if (isInITBlock(pThis))
+    {
+        if (conditionPassed(pContext->R[XPSR], pThis->itState >> 4))
+            pInstruction->execute(pThis, pInstruction);
+        pThis->itState = advanceItState(pThis->itState);
+    }
+    else
+    {
+        pInstruction->execute(pThis, pInstruction);
+    }
+    pContext->R[PC] = pThis->nextPC;
+}
+
+static const DecodedInstruction* fetchDecodedInstruction(ThumbSim* pThis, uint16_t firstHalfWord,
+                                                         DecodedInstruction* pUncached)
+{
+    DecodedInstruction* pEntry = findCacheEntry(pThis, pThis->pc);
+
+    if (pEntry && pEntry->execute)
+    {
+        pThis->stats.cacheHits++;
+        return pEntry;
+    }
+    /* Decode into pUncached first so that a failed fetch of the second halfword doesn't leave a partial entry. */
+    decodeInstruction(pThis, firstHalfWord, pUncached);
+    pThis->stats.decodes++;
+    if (!pEntry)
+        return pUncached;
+    *pEntry = *pUncached;
+    return pEntry;
+}
+
+static DecodedInstruction* findCacheEntry(ThumbSim* pThis, uint32_t address)
+{
+    uint32_t      pageAddress = address & ~PAGE_MASK;
+    uint32_t      offset = address & PAGE_MASK;
+    ThumbSimPage* pPage = pThis->pLastPage;
+
+    if (!pPage || pPage->baseAddress != pageAddress)
+    {
+        pPage = findPage(pThis, pageAddress);
+        if (!pPage)
+            return NULL;
+        pThis->pLastPage = pPage;
+    }
+    if (!pPage->pInstructions || offset < pPage->firstOffset || offset >= pPage->endOffset)
+        return NULL;
+    return &pPage->pInstructions[offset / sizeof(uint16_t)];
+}
+
+static ThumbSimPage* findPage(ThumbSim* pThis, uint32_t pageAddress)
+{
+    ThumbSimPage** ppBucket = &pThis->buckets[(pageAddress >> PAGE_SHIFT) & (THUMB_SIM_PAGE_BUCKETS - 1)];
+    ThumbSimPage*  pPage;
+
+    for (pPage = *ppBucket ; pPage ; pPage = pPage->pNext)
+    {
+        if (pPage->baseAddress == pageAddress)
+            return pPage;
+    }
+    pPage = createPage(pThis, pageAddress);
+    if (!pPage)
+        return NULL;
+    pPage->pNext = *ppBucket;
+    *ppBucket = pPage;
+    return pPage;
+}
+
+static ThumbSimPage* createPage(ThumbSim* pThis, uint32_t pageAddress)
+{
+    ThumbSimPage* pPage = tryAllocate(pThis, sizeof(*pPage));
+    uint32_t      regionBase = 0;
+    uint32_t      regionSize = 0;
+    uint64_t      regionEnd;
+
+    if (!pPage)
+        return NULL;
+    pPage->baseAddress = pageAddress;
+    /* Only code in read-only memory can be cached since code in RAM could be modified at any time. */
+    if (!MemorySim_FindReadOnlyRegion(pThis->pMemory, pThis->pc, &regionBase, &regionSize))
+        return pPage;
+    regionEnd = (uint64_t)regionBase + regionSize;
+    pPage->firstOffset = regionBase > pageAddress ? regionBase - pageAddress : 0;
+    pPage->endOffset = regionEnd < (uint64_t)pageAddress + PAGE_SIZE ? (uint32_t)(regionEnd - pageAddress) : PAGE_SIZE;
+    pPage->pInstructions = tryAllocate(pThis, (PAGE_SIZE / sizeof(uint16_t)) * sizeof(DecodedInstruction));
+    return pPage;
+}
+
+static void* tryAllocate(ThumbSim* pThis, size_t size)
+{
+    /* The cache is just an optimization so running out of memory only means that instructions aren't cached. */
+    void* volatile pAlloc = NULL;
+
+    __try
+        pAlloc = Arena_Alloc(&pThis->arena, size);
+    __catch
+        clearExceptionCode();
+    return pAlloc;
+}
+
+static ThumbSimStopReason stopReasonFromException(int exceptionCode)
+{
+    switch (exceptionCode)
+    {
+    case hardwareBreakpointException:
+        return THUMB_SIM_STOP_BREAKPOINT;
+    case bkptException:
+        return THUMB_SIM_STOP_BKPT;
+    case busErrorException:
+        return THUMB_SIM_STOP_BUS_FAULT;
+    default:
+        return THUMB_SIM_STOP_USAGE_FAULT;
+    }
+}
+
+static uint32_t loadItState(uint32_t xpsr)
+{
+    return ((xpsr >> 8) & 0xFC) | ((xpsr >> 25) & 0x3);
+}
+
+static uint32_t storeItState(uint32_t xpsr, uint32_t itState)
+{
+    return (xpsr & ~EPSR_IT_MASK) | ((itState & 0xFC) << 8) | ((itState & 0x3) << 25);
+}
+
+static int isInITBlock(ThumbSim* pThis)
+{
+    return (pThis->itState & 0xF) != 0;
+}
+
+static uint32_t advanceItState(uint32_t itState)
+{
+    if ((itState & 0x7) == 0)
+        return 0;
+    return (itState & 0xE0) | ((itState << 1) & 0x1F);
+}
+
+static int conditionPassed(uint32_t xpsr, uint32_t cond)
+{
+    int n = (xpsr & APSR_N) != 0;
+    int z = (xpsr & APSR_Z) != 0;
+    int c = (xpsr & APSR_C) != 0;
+    int v = (xpsr & APSR_V) != 0;
+    int result;
+
+    switch (cond >> 1)
+    {
+    case 0:
+        result = z;
+        break;
+    case 1:
+        result = c;
+        break;
+    case 2:
+        result = n;
+        break;
+    case 3:
+        result = v;
+        break;
+    case 4:
+        result = c && !z;
+        break;
+    case 5:
+        result = n == v;
+        break;
+    case 6:
+        result = n == v && !z;
+        break;
+    default:
+        return TRUE;
+    }
+    return (cond & 1) ? !result : result;
+}
+
+
+
+/* Instruction decoding.  The encodings and their names come from the ARMv7-M Architecture Reference Manual. */
+static void decodeInstruction(ThumbSim* pThis, uint16_t firstHalfWord, DecodedInstruction* p)
+{
+    uint32_t hw1 = firstHalfWord;
+
+    memset(p, 0, sizeof(*p));
+    if ((hw1 & 0xE000) == 0xE000 && (hw1 & 0x1800) != 0)
+    {
+        uint32_t hw2 = IMemory_Read16(pThis->pMemory, pThis->pc + 2);
+        p->size = 4;
+        decode32(hw1, hw2, p);
+    }
+    else
+    {
+        p->size = 2;
+        decode16(hw1, p);
+    }
+    if (!p->execute)
+        p->execute = executeUndefined;
+}
+
+static void decode16(uint32_t instr, DecodedInstruction* p)
+{
+    uint32_t opcode = instr >> 10;
+
+    if ((opcode & 0x30) == 0x00)
+    {
+        decodeShiftAddSubtractMoveCompare(instr, p);
+    }
+    else if (opcode == 0x10)
+    {
+        decodeDataProcessing16(instr, p);
+    }
+    else if (opcode == 0x11)
+    {
+        decodeSpecialDataAndBranchExchange(instr, p);
+    }
+    else if ((opcode & 0x3E) == 0x12)
+    {
+        /* LDR (literal) */
+        p->execute = executeLoadStoreImmediate;
+        p->op = LS_LDR;
+        p->d = (instr >> 8) & 0x7;
+        p->n = PC;
+        p->imm = (instr & 0xFF) << 2;
+        p->flags = FLAG_INDEX | FLAG_ADD;
+    }
+    else if ((opcode & 0x3C) == 0x14 || (opcode & 0x38) == 0x18 || (opcode & 0x38) == 0x20)
+    {
+        decodeLoadStore16(instr, p);
+    }
+    else if ((opcode & 0x3E) == 0x28)
+    {
+        /* ADR */
+        p->execute = executeAdr;
+        p->op = ALU_ADD;
+        p->d = (instr >> 8) & 0x7;
+        p->imm = (instr & 0xFF) << 2;
+    }
+    else if ((opcode & 0x3E) == 0x2A)
+    {
+        /* ADD (SP plus immediate) */
+        p->execute = executeAluImmediate;
+        p->op = ALU_ADD;
+        p->d = (instr >> 8) & 0x7;
+        p->n = SP;
+        p->imm = (instr & 0xFF) << 2;
+    }
+    else if ((opcode & 0x3C) == 0x2C)
+    {
+        decodeMisc16(instr, p);
+    }
+    else if ((opcode & 0x3E) == 0x30 || (opcode & 0x3E) == 0x32)
+    {
+        /* STM / LDM, which only writes back the base register if it isn't also loaded. */
+        uint32_t isLoad = instr & 0x0800;
+
+        p->execute = isLoad ? executeLoadMultiple : executeStoreMultiple;
+        p->n = (instr >> 8) & 0x7;
+        p->imm = instr & 0xFF;
+        if (!isLoad || (p->imm & (1 << p->n)) == 0)
+            p->flags = FLAG_WBACK;
+        if (p->imm == 0)
+            p->execute = NULL;
+    }
+    else if ((opcode & 0x3C) == 0x34)
+    {
+        uint32_t cond = (instr >> 8) & 0xF;
+
+        if (cond == 0xE)
+            return; /* UDF */
+        if (cond == 0xF)
+            return; /* SVC - exceptions aren't simulated. */
+        p->execute = executeBranch;
+        p->op = cond;
+        p->imm = signExtend((instr & 0xFF) << 1, 9);
+    }
+    else if ((opcode & 0x3E) == 0x38)
+    {
+        p->execute = executeBranch;
+        p->op = COND_AL;
+        p->imm = signExtend((instr & 0x7FF) << 1, 12);
+    }
+}
+
+static void decodeShiftAddSubtractMoveCompare(uint32_t instr, DecodedInstruction* p)
+{
+    uint32_t opcode = (instr >> 9) & 0x1F;
+
+    p->flags = FLAG_SET_FLAGS_OUTSIDE_IT;
+    if (opcode < 0x0C)
+    {
+        /* LSL, LSR and ASR (immediate).  LSL #0 is MOVS (register). */
+        p->execute = executeAluRegister;
+        p->op = ALU_MOV;
+        p->d = instr & 0x7;
+        p->m = (instr >> 3) & 0x7;
+        decodeImmediateShift(opcode >> 2, (instr >> 6) & 0x1F, p);
+        return;
+    }
+    switch (opcode)
+    {
+    case 0x0C:
+    case 0x0D:
+        /* ADD / SUB (register) */
+        p->execute = executeAluRegister;
+        p->op = opcode == 0x0C ? ALU_ADD : ALU_SUB;
+        p->d = instr & 0x7;
+        p->n = (instr >> 3) & 0x7;
+        p->m = (instr >> 6) & 0x7;
+        break;
+    case 0x0E:
+    case 0x0F:
+        /* ADD / SUB (3-bit immediate) */
+        p->execute = executeAluImmediate;
+        p->op = opcode == 0x0E ? ALU_ADD : ALU_SUB;
+        p->d = instr & 0x7;
+        p->n = (instr >> 3) & 0x7;
+        p->imm = (instr >> 6) & 0x7;
+        break;
+    default:
+    {
+        /* MOV, CMP, ADD and SUB (8-bit immediate) */
+        static const uint8_t ops[4] = { ALU_MOV, ALU_CMP, ALU_ADD, ALU_SUB };
+
+        p->execute = executeAluImmediate;
+        p->op = ops[(opcode >> 2) & 0x3];
+        p->d = (instr >> 8) & 0x7;
+        p->n = p->d;
+        p->imm = instr & 0xFF;
+        if (p->op == ALU_CMP)
+            p->flags = FLAG_SET_FLAGS;
+        break;
+    }
+    }
+}
+
+static void decodeDataProcessing16(uint32_t instr, DecodedInstruction* p)
+{
+    static const uint8_t shiftTypes[8] = { 0, 0, SHIFT_LSL, SHIFT_LSR, SHIFT_ASR, 0, 0, SHIFT_ROR };
+    uint32_t             opcode = (instr >> 6) & 0xF;
+    uint32_t             dn = instr & 0x7;
+    uint32_t             m = (instr >> 3) & 0x7;
+
+    p->d = dn;
+    p->n = dn;
+    p->m = m;
+    p->flags = FLAG_SET_FLAGS_OUTSIDE_IT;
+    p->execute = executeAluRegister;
+    switch (opcode)
+    {
+    case 0x0:
+        p->op = ALU_AND;
+        break;
+    case 0x1:
+        p->op = ALU_EOR;
+        break;
+    case 0x2:
+    case 0x3:
+    case 0x4:
+    case 0x7:
+        p->execute = executeShiftByRegister;
+        p->shiftType = shiftTypes[opcode];
+        break;
+    case 0x5:
+        p->op = ALU_ADC;
+        break;
+    case 0x6:
+        p->op = ALU_SBC;
+        break;
+    case 0x8:
+        p->op = ALU_TST;
+        p->flags = FLAG_SET_FLAGS;
+        break;
+    case 0x9:
+        /* RSB (immediate) with an immediate of 0. */
+        p->execute = executeAluImmediate;
+        p->op = ALU_RSB;
+        p->n = m;
+        p->imm = 0;
+        break;
+    case 0xA:
+        p->op = ALU_CMP;
+        p->flags = FLAG_SET_FLAGS;
+        break;
+    case 0xB:
+        p->op = ALU_CMN;
+        p->flags = FLAG_SET_FLAGS;
+        break;
+    case 0xC:
+        p->op = ALU_ORR;
+        break;
+    case 0xD:
+        p->execute = executeMultiplyDivide;
+        p->op = MISC_MUL;
+        p->n = m;
+        p->m = dn;
+        break;
+    case 0xE:
+        p->op = ALU_BIC;
+        break;
+    case 0xF:
+        p->op = ALU_MVN;
+        break;
+    }
+}
+
+static void decodeSpecialDataAndBranchExchange(uint32_t instr, DecodedInstruction* p)
+{
+    uint32_t opcode = (instr >> 8) & 0x3;
+    uint32_t dn = ((instr >> 4) & 0x8) | (instr & 0x7);
+    uint32_t m = (instr >> 3) & 0xF;
+
+    p->d = dn;
+    p->n = dn;
+    p->m = m;
+    switch (opcode)
+    {
+    case 0:
+        /* ADD (register) with high registers. */
+        p->execute = executeAluRegister;
+        p->op = ALU_ADD;
+        break;
+    case 1:
+        p->execute = executeAluRegister;
+        p->op = ALU_CMP;
+        p->flags = FLAG_SET_FLAGS;
+        break;
+    case 2:
+        p->execute = executeAluRegister;
+        p->op = ALU_MOV;
+        break;
+    case 3:
+        /* BX / BLX (register) */
+        p->execute = executeBranchExchange;
+        p->op = (instr >> 7) & 1;
+        break;
+    }
+}
+
+static void decodeLoadStore16(uint32_t instr, DecodedInstruction* p)
+{
+    static const uint8_t registerOps[8] = { LS_STR, LS_STRH, LS_STRB, LS_LDRSB, LS_LDR, LS_LDRH, LS_LDRB, LS_LDRSH };
+    uint32_t             opA = instr >> 12;
+    uint32_t             isLoad = instr & 0x0800;
+    uint32_t             imm5 = (instr >> 6) & 0x1F;
+
+    p->d = instr & 0x7;
+    p->n = (instr >> 3) & 0x7;
+    p->flags = FLAG_INDEX | FLAG_ADD;
+    if (opA == 0x5)
+    {
+        p->execute = executeLoadStoreRegister;
+        p->op = registerOps[(instr >> 9) & 0x7];
+        p->m = (instr >> 6) & 0x7;
+        return;
+    }
+    p->execute = executeLoadStoreImmediate;
+    switch (opA)
+    {
+    case 0x6:
+        p->op = isLoad ? LS_LDR : LS_STR;
+        p->imm = imm5 << 2;
+        break;
+    case 0x7:
+        p->op = isLoad ? LS_LDRB : LS_STRB;
+        p->imm = imm5;
+        break;
+    case 0x8:
+        p->op = isLoad ? LS_LDRH : LS_STRH;
+        p->imm = imm5 << 1;
+        break;
+    case 0x9:
+        /* SP relative */
+        p->op = isLoad ? LS_LDR : LS_STR;
+        p->d = (instr >> 8) & 0x7;
+        p->n = SP;
+        p->imm = (instr & 0xFF) << 2;
+        break;
+    }
+}
+
+static void decodeMisc16(uint32_t instr, DecodedInstruction* p)
+{
+    uint32_t opcode = (instr >> 5) & 0x7F;
+
+    if ((opcode & 0x78) == 0x00)
+    {
+        /* ADD / SUB (SP plus/minus immediate) */
+        p->execute = executeAluImmediate;
+        p->op = (opcode & 0x04) ? ALU_SUB : ALU_ADD;
+        p->d = SP;
+        p->n = SP;
+        p->imm = (instr & 0x7F) << 2;
+    }
+    else if ((instr & 0x0500) == 0x0100)
+    {
+        /* CBZ / CBNZ */
+        p->execute = executeCompareAndBranch;
+        p->op = (instr >> 11) & 1;
+        p->n = instr & 0x7;
+        p->imm = ((instr >> 3) & 0x40) | ((instr >> 2) & 0x3E);
+    }
+    else if ((opcode & 0x78) == 0x10)
+    {
+        /* SXTH, SXTB, UXTH and UXTB */
+        static const uint8_t ops[4] = { MISC_SXTH, MISC_SXTB, MISC_UXTH, MISC_UXTB };
+
+        p->execute = executeExtendReverse;
+        p->op = ops[(instr >> 6) & 0x3];
+        p->d = instr & 0x7;
+        p->n = PC;
+        p->m = (instr >> 3) & 0x7;
+    }
+    else if ((opcode & 0x70) == 0x20)
+    {
+        /* PUSH */
+        p->execute = executeStoreMultiple;
+        p->op = TRUE;
+        p->n = SP;
+        p->imm = (instr & 0xFF) | ((instr & 0x100) << 6);
+        p->flags = FLAG_WBACK;
+        if (p->imm == 0)
+            p->execute = NULL;
+    }
+    else if ((opcode & 0x7E) == 0x32 && (instr & 0xC) == 0)
+    {
+        /* CPS */
+        p->execute = executeCps;
+        p->op = (instr >> 4) & 1;
+        p->imm = instr & 0x3;
+    }
+    else if ((opcode & 0x78) == 0x50)
+    {
+        /* REV, REV16 and REVSH */
+        static const uint8_t ops[4] = { MISC_REV, MISC_REV16, 0, MISC_REVSH };
+        uint32_t             op = (instr >> 6) & 0x3;
+
+        if (op == 2)
+            return;
+        p->execute = executeExtendReverse;
+        p->op = ops[op];
+        p->d = instr & 0x7;
+        p->m = (instr >> 3) & 0x7;
+    }
+    else if ((opcode & 0x70) == 0x60)
+    {
+        /* POP */
+        p->execute = executeLoadMultiple;
+        p->op = FALSE;
+        p->n = SP;
+        p->imm = (instr & 0xFF) | ((instr & 0x100) << 7);
+        p->flags = FLAG_WBACK;
+        if (p->imm == 0)
+            p->execute = NULL;
+    }
+    else if ((opcode & 0x78) == 0x70)
+    {
+        p->execute = executeBkpt;
+    }
+    else if ((opcode & 0x78) == 0x78)
+    {
+        if ((instr & 0xF) != 0)
+        {
+            /* IT */
+            uint32_t firstCond = (instr >> 4) & 0xF;
+
+            if (firstCond == 0xF || (firstCond == COND_AL && countBits(instr & 0xF) != 1))
+                return;
+            p->execute = executeIt;
+            p->imm = instr & 0xFF;
+        }
+        else
+        {
+            /* NOP, YIELD, WFE, WFI and SEV are all treated as NOPs. */
+            p->execute = executeNop;
+        }
+    }
+}
+
+static void decode32(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op1 = (hw1 >> 11) & 0x3;
+    uint32_t op2 = (hw1 >> 4) & 0x7F;
+    uint32_t op = hw2 >> 15;
+
+    switch (op1)
+    {
+    case 1:
+        if ((op2 & 0x64) == 0x00)
+            decodeLoadStoreMultiple(hw1, hw2, p);
+        else if ((op2 & 0x64) == 0x04)
+            decodeLoadStoreDualExclusiveTableBranch(hw1, hw2, p);
+        else if ((op2 & 0x60) == 0x20)
+            decodeDataProcessingShiftedRegister(hw1, hw2, p);
+        /* Coprocessor (floating point) instructions are left undefined. */
+        break;
+    case 2:
+        if (op == 1)
+            decodeBranchesAndMiscControl(hw1, hw2, p);
+        else if ((op2 & 0x20) == 0x00)
+            decodeDataProcessingModifiedImmediate(hw1, hw2, p);
+        else
+            decodeDataProcessingPlainImmediate(hw1, hw2, p);
+        break;
+    case 3:
+        if ((op2 & 0x60) == 0x00)
+            decodeLoadStoreSingle(hw1, hw2, p);
+        else if ((op2 & 0x70) == 0x20)
+            decodeDataProcessingRegister(hw1, hw2, p);
+        else if ((op2 & 0x78) == 0x30)
+            decodeMultiply(hw1, hw2, p);
+        else if ((op2 & 0x78) == 0x38)
+            decodeLongMultiplyDivide(hw1, hw2, p);
+        break;
+    }
+}
+
+static void decodeLoadStoreMultiple(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op = (hw1 >> 7) & 0x3;
+    uint32_t isLoad = hw1 & 0x0010;
+
+    /* Only the increment after (01) and decrement before (10) forms exist on M-profile. */
+    if (op != 1 && op != 2)
+        return;
+    p->execute = isLoad ? executeLoadMultiple : executeStoreMultiple;
+    p->op = op == 2;
+    p->n = hw1 & 0xF;
+    p->imm = hw2 & (isLoad ? 0xDFFF : 0x5FFF);
+    if (hw1 & 0x0020)
+        p->flags = FLAG_WBACK;
+    if (p->imm == 0 || p->n == PC)
+        p->execute = NULL;
+}
+
+static void decodeLoadStoreDualExclusiveTableBranch(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op1 = (hw1 >> 7) & 0x3;
+    uint32_t op2 = (hw1 >> 4) & 0x3;
+    uint32_t op3 = (hw2 >> 4) & 0xF;
+
+    p->n = hw1 & 0xF;
+    p->d = (hw2 >> 12) & 0xF;
+    if (op1 == 0 && op2 < 2)
+    {
+        /* STREX / LDREX */
+        p->execute = op2 ? executeLoadExclusive : executeStoreExclusive;
+        p->op = op2 ? LS_LDR : LS_STR;
+        p->a = (hw2 >> 8) & 0xF;
+        p->imm = (hw2 & 0xFF) << 2;
+    }
+    else if ((op1 & 0x2) || (op2 & 0x2))
+    {
+        /* STRD / LDRD (immediate) */
+        p->execute = executeLoadStoreDual;
+        p->op = (op2 & 1) ? LS_LDR : LS_STR;
+        p->a = (hw2 >> 8) & 0xF;
+        p->imm = (hw2 & 0xFF) << 2;
+        if (hw1 & 0x0100)
+            p->flags |= FLAG_INDEX;
+        if (hw1 & 0x0080)
+            p->flags |= FLAG_ADD;
+        if (hw1 & 0x0020)
+            p->flags |= FLAG_WBACK;
+    }
+    else if (op1 == 1 && op2 == 0 && (op3 == 4 || op3 == 5))
+    {
+        /* STREXB / STREXH */
+        p->execute = executeStoreExclusive;
+        p->op = op3 == 4 ? LS_STRB : LS_STRH;
+        p->a = hw2 & 0xF;
+    }
+    else if (op1 == 1 && op2 == 1 && (op3 == 0 || op3 == 1))
+    {
+        /* TBB / TBH */
+        p->execute = executeTableBranch;
+        p->op = op3;
+        p->m = hw2 & 0xF;
+    }
+    else if (op1 == 1 && op2 == 1 && (op3 == 4 || op3 == 5))
+    {
+        /* LDREXB / LDREXH */
+        p->execute = executeLoadExclusive;
+        p->op = op3 == 4 ? LS_LDRB : LS_LDRH;
+    }
+}
+
+static void decodeDataProcessingShiftedRegister(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op = (hw1 >> 5) & 0xF;
+    uint32_t imm5 = ((hw2 >> 10) & 0x1C) | ((hw2 >> 6) & 0x3);
+
+    if (!decodeAluOp32(op, (hw2 >> 8) & 0xF, hw1 & 0xF, hw1 & 0x0010, p))
+        return;
+    p->execute = executeAluRegister;
+    p->m = hw2 & 0xF;
+    decodeImmediateShift((hw2 >> 4) & 0x3, imm5, p);
+}
+
+/* Decodes the operation shared by the modified immediate and shifted register data processing instructions. */
+static int decodeAluOp32(uint32_t op, uint32_t d, uint32_t n, uint32_t setFlags, DecodedInstruction* p)
+{
+    static const int8_t ops[16] = { ALU_AND, ALU_BIC, ALU_ORR, ALU_ORN, ALU_EOR, -1, -1, -1,
+                                    ALU_ADD, -1, ALU_ADC, ALU_SBC, -1, ALU_SUB, ALU_RSB, -1 };
+    int                 aluOp = ops[op];
+
+    if (aluOp < 0)
+        return FALSE;
+    if (d == PC && setFlags)
+    {
+        /* The compare forms which only set the flags. */
+        switch (aluOp)
+        {
+        case ALU_AND:
+            aluOp = ALU_TST;
+            break;
+        case ALU_EOR:
+            aluOp = ALU_TEQ;
+            break;
+        case ALU_ADD:
+            aluOp = ALU_CMN;
+            break;
+        case ALU_SUB:
+            aluOp = ALU_CMP;
+            break;
+        }
+    }
+    if (n == PC)
+    {
+        /* MOV and MVN are encoded as ORR and ORN with no first operand. */
+        if (aluOp == ALU_ORR)
+            aluOp = ALU_MOV;
+        else if (aluOp == ALU_ORN)
+            aluOp = ALU_MVN;
+    }
+    p->op = aluOp;
+    p->d = d;
+    p->n = n;
+    p->flags = setFlags ? FLAG_SET_FLAGS : 0;
+    return TRUE;
+}
+
+static void decodeDataProcessingModifiedImmediate(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t imm12 = ((hw1 << 1) & 0x800) | ((hw2 >> 4) & 0x700) | (hw2 & 0xFF);
+    int      carryFromImm = FALSE;
+
+    if (!decodeAluOp32((hw1 >> 5) & 0xF, (hw2 >> 8) & 0xF, hw1 & 0xF, hw1 & 0x0010, p))
+        return;
+    p->execute = executeAluImmediate;
+    p->imm = expandModifiedImmediate(imm12, &carryFromImm);
+    if (carryFromImm)
+        p->flags |= FLAG_CARRY_FROM_IMM;
+}
+
+static uint32_t expandModifiedImmediate(uint32_t imm12, int* pCarryFromImm)
+{
+    uint32_t imm8 = imm12 & 0xFF;
+
+    if ((imm12 & 0xC00) == 0)
+    {
+        *pCarryFromImm = FALSE;
+        switch ((imm12 >> 8) & 0x3)
+        {
+        case 0:
+            return imm8;
+        case 1:
+            return (imm8 << 16) | imm8;
+        case 2:
+            return (imm8 << 24) | (imm8 << 8);
+        default:
+            return imm8 * 0x01010101;
+        }
+    }
+    *pCarryFromImm = TRUE;
+    return rotateRight(0x80 | (imm12 & 0x7F), (imm12 >> 7) & 0x1F);
+}
+
+static void decodeDataProcessingPlainImmediate(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op = (hw1 >> 4) & 0x1F;
+    uint32_t n = hw1 & 0xF;
+    uint32_t imm12 = ((hw1 << 1) & 0x800) | ((hw2 >> 4) & 0x700) | (hw2 & 0xFF);
+    uint32_t imm5 = ((hw2 >> 10) & 0x1C) | ((hw2 >> 6) & 0x3);
+    uint32_t low5 = hw2 & 0x1F;
+
+    p->d = (hw2 >> 8) & 0xF;
+    p->n = n;
+    switch (op)
+    {
+    case 0x00:
+    case 0x0A:
+        /* ADDW / SUBW, which are ADR when the base is PC. */
+        p->execute = n == PC ? executeAdr : executeAluImmediate;
+        p->op = op == 0 ? ALU_ADD : ALU_SUB;
+        p->imm = imm12;
+        break;
+    case 0x04:
+    case 0x0C:
+        /* MOVW / MOVT */
+        p->execute = op == 0x04 ? executeAluImmediate : executeMovt;
+        p->op = ALU_MOV;
+        p->imm = ((hw1 & 0xF) << 12) | imm12;
+        break;
+    case 0x10:
+    case 0x12:
+    case 0x18:
+    case 0x1A:
+        /* SSAT / USAT.  The forms with ASR #0 are the DSP extension's SSAT16 / USAT16. */
+        if ((op & 0x2) && imm5 == 0)
+            return;
+        p->execute = executeBitfieldSaturate;
+        p->op = (op & 0x8) ? MISC_USAT : MISC_SSAT;
+        p->imm = (op & 0x8) ? low5 : low5 + 1;
+        if (op & 0x2)
+            decodeImmediateShift(SHIFT_ASR, imm5, p);
+        else
+            decodeImmediateShift(SHIFT_LSL, imm5, p);
+        break;
+    case 0x14:
+    case 0x1C:
+        /* SBFX / UBFX with lsb in a and width in imm. */
+        if (imm5 + low5 > 31)
+            return;
+        p->execute = executeBitfieldSaturate;
+        p->op = op == 0x14 ? MISC_SBFX : MISC_UBFX;
+        p->a = imm5;
+        p->imm = low5 + 1;
+        break;
+    case 0x16:
+        /* BFI / BFC with lsb in a and msb in imm. */
+        if (low5 < imm5)
+            return;
+        p->execute = executeBitfieldSaturate;
+        p->op = n == PC ? MISC_BFC : MISC_BFI;
+        p->a = imm5;
+        p->imm = low5;
+        break;
+    }
+}
+
+static void decodeBranchesAndMiscControl(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op1 = (hw2 >> 12) & 0x7;
+    uint32_t op = (hw1 >> 4) & 0x7F;
+    uint32_t s = (hw1 >> 10) & 1;
+    uint32_t j1 = (hw2 >> 13) & 1;
+    uint32_t j2 = (hw2 >> 11) & 1;
+
+    if ((op1 & 0x5) == 0x0)
+    {
+        if ((op & 0x38) != 0x38)
+        {
+            /* B (T3) conditional branch */
+            p->execute = executeBranch;
+            p->op = (hw1 >> 6) & 0xF;
+            p->imm = signExtend((s << 20) | (j2 << 19) | (j1 << 18) | ((hw1 & 0x3F) << 12) | ((hw2 & 0x7FF) << 1), 21);
+            return;
+        }
+        switch (op)
+        {
+        case 0x38:
+        case 0x39:
+            p->execute = executeMsr;
+            p->n = hw1 & 0xF;
+            p->imm = hw2 & 0xFF;
+            p->a = (hw2 >> 10) & 0x3;
+            break;
+        case 0x3A:
+            /* NOP and the other hints. */
+            p->execute = executeNop;
+            break;
+        case 0x3B:
+            /* CLREX, DSB, DMB and ISB.  Memory is always coherent in the simulator. */
+            switch ((hw2 >> 4) & 0xF)
+            {
+            case 0x2:
+                p->execute = executeClrex;
+                break;
+            case 0x4:
+            case 0x5:
+            case 0x6:
+                p->execute = executeNop;
+                break;
+            }
+            break;
+        case 0x3E:
+        case 0x3F:
+            p->execute = executeMrs;
+            p->d = (hw2 >> 8) & 0xF;
+            p->imm = hw2 & 0xFF;
+            break;
+        }
+        /* UDF and everything else is left undefined. */
+    }
+    else if ((op1 & 0x5) == 0x1 || (op1 & 0x5) == 0x5)
+    {
+        /* B (T4) and BL share the same offset encoding. */
+        uint32_t i1 = !(j1 ^ s);
+        uint32_t i2 = !(j2 ^ s);
+
+        p->execute = (op1 & 0x4) ? executeBranchWithLink : executeBranch;
+        p->op = COND_AL;
+        p->imm = signExtend((s << 24) | (i1 << 23) | (i2 << 22) | ((hw1 & 0x3FF) << 12) | ((hw2 & 0x7FF) << 1), 25);
+    }
+}
+
+static void decodeLoadStoreSingle(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    static const uint8_t loadOps[2][3] = { { LS_LDRB, LS_LDRH, LS_LDR }, { LS_LDRSB, LS_LDRSH, 0xFF } };
+    static const uint8_t storeOps[3] = { LS_STRB, LS_STRH, LS_STR };
+    uint32_t             size = (hw1 >> 5) & 0x3;
+    uint32_t             isSigned = (hw1 >> 8) & 1;
+    uint32_t             isLoad = (hw1 >> 4) & 1;
+    uint32_t             n = hw1 & 0xF;
+    uint32_t             t = (hw2 >> 12) & 0xF;
+
+    if (size == 3 || (!isLoad && isSigned))
+        return;
+    if (isLoad)
+    {
+        if (loadOps[isSigned][size] == 0xFF)
+            return;
+        p->op = loadOps[isSigned][size];
+        /* Byte and halfword loads into PC are the PLD and PLI preload hints. */
+        if (t == PC && size != 2)
+            p->op = LS_HINT;
+    }
+    else
+    {
+        if (n == PC)
+            return;
+        p->op = storeOps[size];
+    }
+    p->d = t;
+    p->n = n;
+    if (n == PC)
+    {
+        /* Literal */
+        p->execute = executeLoadStoreImmediate;
+        p->imm = hw2 & 0xFFF;
+        p->flags = FLAG_INDEX | ((hw1 & 0x0080) ? FLAG_ADD : 0);
+    }
+    else if (hw1 & 0x0080)
+    {
+        /* 12-bit positive offset */
+        p->execute = executeLoadStoreImmediate;
+        p->imm = hw2 & 0xFFF;
+        p->flags = FLAG_INDEX | FLAG_ADD;
+    }
+    else if ((hw2 & 0x0FC0) == 0)
+    {
+        /* Register offset, shifted left by up to 3 bits. */
+        p->execute = executeLoadStoreRegister;
+        p->m = hw2 & 0xF;
+        p->shiftAmount = (hw2 >> 4) & 0x3;
+    }
+    else if (hw2 & 0x0800)
+    {
+        /* 8-bit offset with pre/post indexing.  The unprivileged forms (LDRT etc.) behave the same here. */
+        p->execute = executeLoadStoreImmediate;
+        p->imm = hw2 & 0xFF;
+        if (hw2 & 0x0400)
+            p->flags |= FLAG_INDEX;
+        if (hw2 & 0x0200)
+            p->flags |= FLAG_ADD;
+        if (hw2 & 0x0100)
+            p->flags |= FLAG_WBACK;
+        if ((p->flags & (FLAG_INDEX | FLAG_WBACK)) == 0)
+            p->execute = NULL;
+    }
+}
+
+static void decodeDataProcessingRegister(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op1 = (hw1 >> 4) & 0xF;
+    uint32_t op2 = (hw2 >> 4) & 0xF;
+
+    p->d = (hw2 >> 8) & 0xF;
+    p->n = hw1 & 0xF;
+    p->m = hw2 & 0xF;
+    if ((op1 & 0x8) == 0 && op2 == 0)
+    {
+        /* LSL, LSR, ASR and ROR (register) */
+        p->execute = executeShiftByRegister;
+        p->shiftType = (op1 >> 1) & 0x3;
+        p->flags = (op1 & 1) ? FLAG_SET_FLAGS : 0;
+    }
+    else if ((op1 & 0x8) == 0 && (op2 & 0x8))
+    {
+        /* SXTAH, UXTAH, SXTAB and UXTAB, which are SXTH etc. when the base is PC. */
+        static const int8_t ops[8] = { MISC_SXTH, MISC_UXTH, -1, -1, MISC_SXTB, MISC_UXTB, -1, -1 };
+
+        if (ops[op1 & 0x7] < 0)
+            return;
+        p->execute = executeExtendReverse;
+        p->op = ops[op1 & 0x7];
+        p->shiftAmount = ((hw2 >> 4) & 0x3) * 8;
+    }
+    else if ((op1 & 0xC) == 0x8 && (op2 & 0xC) == 0x8)
+    {
+        static const int8_t ops[4][4] = { { -1, -1, -1, -1 },
+                                          { MISC_REV, MISC_REV16, MISC_RBIT, MISC_REVSH },
+                                          { -1, -1, -1, -1 },
+                                          { MISC_CLZ, -1, -1, -1 } };
+        int                 op = ops[op1 & 0x3][op2 & 0x3];
+
+        if (op < 0)
+            return;
+        p->execute = executeExtendReverse;
+        p->op = op;
+    }
+    /* Parallel add/subtract and the other DSP extension instructions are left undefined. */
+}
+
+static void decodeMultiply(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op1 = (hw1 >> 4) & 0x7;
+    uint32_t op2 = (hw2 >> 4) & 0x3;
+
+    if (op1 != 0 || op2 > 1)
+        return;
+    p->execute = executeMultiplyDivide;
+    p->d = (hw2 >> 8) & 0xF;
+    p->n = hw1 & 0xF;
+    p->m = hw2 & 0xF;
+    p->a = (hw2 >> 12) & 0xF;
+    if (op2 == 1)
+        p->op = MISC_MLS;
+    else
+        p->op = p->a == PC ? MISC_MUL : MISC_MLA;
+}
+
+static void decodeLongMultiplyDivide(uint32_t hw1, uint32_t hw2, DecodedInstruction* p)
+{
+    uint32_t op1 = (hw1 >> 4) & 0x7;
+    uint32_t op2 = (hw2 >> 4) & 0xF;
+
+    p->execute = executeMultiplyDivide;
+    p->n = hw1 & 0xF;
+    p->m = hw2 & 0xF;
+    /* d holds RdHi and a holds RdLo for the long multiplies. */
+    p->d = (hw2 >> 8) & 0xF;
+    p->a = (hw2 >> 12) & 0xF;
+    if (op1 == 0 && op2 == 0)
+        p->op = MISC_SMULL;
+    else if (op1 == 1 && op2 == 0xF)
+        p->op = MISC_SDIV;
+    else if (op1 == 2 && op2 == 0)
+        p->op = MISC_UMULL;
+    else if (op1 == 3 && op2 == 0xF)
+        p->op = MISC_UDIV;
+    else if (op1 == 4 && op2 == 0)
+        p->op = MISC_SMLAL;
+    else if (op1 == 6 && op2 == 0)
+        p->op = MISC_UMLAL;
+    else
+        p->execute = NULL;
+}
+
+static void decodeImmediateShift(uint32_t type, uint32_t imm5, DecodedInstruction* p)
+{
+    p->shiftType = type;
+    p->shiftAmount = imm5;
+    switch (type)
+    {
+    case SHIFT_LSR:
+    case SHIFT_ASR:
+        if (imm5 == 0)
+            p->shiftAmount = 32;
+        break;
+    case SHIFT_ROR:
+        if (imm5 == 0)
+        {
+            p->shiftType = SHIFT_RRX;
+            p->shiftAmount = 1;
+        }
+        break;
+    }
+}
+
+static uint32_t signExtend(uint32_t value, uint32_t bitCount)
+{
+    uint32_t signBit = 1U << (bitCount - 1);
+    return (value ^ signBit) - signBit;
+}
+
+
+
+/* Helpers used while executing instructions. */
+static uint32_t readRegister(ThumbSim* pThis, uint32_t index)
+{
+    if (index == PC)
+        return pThis->pc + 4;
+    return pThis->pContext->R[index];
+}
+
+static void writeRegister(ThumbSim* pThis, uint32_t index, uint32_t value)
+{
+    if (index == PC)
+        branchWritePC(pThis, value);
+    else if (index == SP)
+        pThis->pContext->R[SP] = value & ~3;
+    else
+        pThis->pContext->R[index] = value;
+}
+
+static void branchWritePC(ThumbSim* pThis, uint32_t address)
+{
+    pThis->nextPC = address & ~1;
+}
+
+static void bxWritePC(ThumbSim* pThis, uint32_t address)
+{
+    /* Clearing the T bit leaves the next instruction to fault, just like real hardware. */
+    if ((address & 1) == 0)
+        pThis->pContext->R[XPSR] &= ~EPSR_T;
+    pThis->nextPC = address & ~1;
+}
+
+static int shouldSetFlags(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    if (p->flags & FLAG_SET_FLAGS)
+        return TRUE;
+    return (p->flags & FLAG_SET_FLAGS_OUTSIDE_IT) && !isInITBlock(pThis);
+}
+
+static int isCarrySet(ThumbSim* pThis)
+{
+    return (pThis->pContext->R[XPSR] & APSR_C) != 0;
+}
+
+static void setFlags(ThumbSim* pThis, uint32_t result, int carry, int overflow)
+{
+    uint32_t xpsr = pThis->pContext->R[XPSR] & ~(APSR_N | APSR_Z | APSR_C | APSR_V);
+
+    if (result & 0x80000000)
+        xpsr |= APSR_N;
+    if (result == 0)
+        xpsr |= APSR_Z;
+    if (carry)
+        xpsr |= APSR_C;
+    if (overflow)
+        xpsr |= APSR_V;
+    pThis->pContext->R[XPSR] = xpsr;
+}
+
+static void setNZFlags(ThumbSim* pThis, uint32_t result)
+{
+    uint32_t xpsr = pThis->pContext->R[XPSR];
+
+    setFlags(pThis, result, xpsr & APSR_C, xpsr & APSR_V);
+}
+
+static uint32_t addWithCarry(uint32_t x, uint32_t y, int carryIn, int* pCarryOut, int* pOverflow)
+{
+    uint64_t unsignedSum = (uint64_t)x + y + (carryIn ? 1 : 0);
+    int64_t  signedSum = (int64_t)(int32_t)x + (int32_t)y + (carryIn ? 1 : 0);
+    uint32_t result = (uint32_t)unsignedSum;
+
+    *pCarryOut = (unsignedSum >> 32) != 0;
+    *pOverflow = signedSum != (int64_t)(int32_t)result;
+    return result;
+}
+
+static uint32_t shiftWithCarry(uint32_t value, uint32_t type, uint32_t amount, int carryIn, int* pCarryOut)
+{
+    *pCarryOut = carryIn;
+    if (type == SHIFT_RRX)
+    {
+        *pCarryOut = value & 1;
+        return (value >> 1) | (carryIn ? 0x80000000 : 0);
+    }
+    if (amount == 0)
+        return value;
+
+    switch (type)
+    {
+    case SHIFT_LSL:
+        if (amount > 32)
+        {
+            *pCarryOut = 0;
+            return 0;
+        }
+        *pCarryOut = (value >> (32 - amount)) & 1;
+        return amount == 32 ? 0 : value << amount;
+    case SHIFT_LSR:
+        if (amount > 32)
+        {
+            *pCarryOut = 0;
+            return 0;
+        }
+        *pCarryOut = (value >> (amount - 1)) & 1;
+        return amount == 32 ? 0 : value >> amount;
+    case SHIFT_ASR:
+        if (amount >= 32)
+        {
+            *pCarryOut = value >> 31;
+            return *pCarryOut ? 0xFFFFFFFF : 0;
+        }
+        *pCarryOut = (value >> (amount - 1)) & 1;
+        if (value & 0x80000000)
+            return (value >> amount) | ~(0xFFFFFFFF >> amount);
+        return value >> amount;
+    default:
+    {
+        uint32_t result = rotateRight(value, amount & 31);
+
+        *pCarryOut = result >> 31;
+        return result;
+    }
+    }
+}
+
+static uint32_t rotateRight(uint32_t value, uint32_t amount)
+{
+    if (amount == 0)
+        return value;
+    return (value >> amount) | (value << (32 - amount));
+}
+
+static uint32_t countLeadingZeros(uint32_t value)
+{
+    uint32_t count = 0;
+
+    if (value == 0)
+        return 32;
+    while ((value & 0x80000000) == 0)
+    {
+        value <<= 1;
+        count++;
+    }
+    return count;
+}
+
+static uint32_t countBits(uint32_t value)
+{
+    uint32_t count = 0;
+
+    while (value)
+    {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+}
+
+
+
+/* Execute functions for each type of decoded instruction. */
+static void executeUndefined(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    __throw(undefinedException);
+}
+
+static void executeBkpt(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    __throw(bkptException);
+}
+
+static void executeNop(ThumbSim* pThis, const DecodedInstruction* p)
+{
+}
+
+static void executeAluImmediate(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    int carry = isCarrySet(pThis);
+
+    if (p->flags & FLAG_CARRY_FROM_IMM)
+        carry = p->imm >> 31;
+    executeAluOperation(pThis, p, p->imm, carry);
+}
+
+static void executeAluRegister(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    int      carry;
+    uint32_t operand2 = shiftWithCarry(readRegister(pThis, p->m), p->shiftType, p->shiftAmount, isCarrySet(pThis),
+                                       &carry);
+
+    executeAluOperation(pThis, p, operand2, carry);
+}
+
+static void executeAluOperation(ThumbSim* pThis, const DecodedInstruction* p, uint32_t operand2, int carry)
+{
+    uint32_t operand1 = readRegister(pThis, p->n);
+    int      overflow = (pThis->pContext->R[XPSR] & APSR_V) != 0;
+    int      writeResult = TRUE;
+    uint32_t result;
+
+    switch (p->op)
+    {
+    case ALU_AND:
+        result = operand1 & operand2;
+        break;
+    case ALU_TST:
+        result = operand1 & operand2;
+        writeResult = FALSE;
+        break;
+    case ALU_BIC:
+        result = operand1 & ~operand2;
+        break;
+    case ALU_ORR:
+        result = operand1 | operand2;
+        break;
+    case ALU_ORN:
+        result = operand1 | ~operand2;
+        break;
+    case ALU_EOR:
+        result = operand1 ^ operand2;
+        break;
+    case ALU_TEQ:
+        result = operand1 ^ operand2;
+        writeResult = FALSE;
+        break;
+    case ALU_MOV:
+        result = operand2;
+        break;
+    case ALU_MVN:
+        result = ~operand2;
+        break;
+    case ALU_ADD:
+        result = addWithCarry(operand1, operand2, FALSE, &carry, &overflow);
+        break;
+    case ALU_CMN:
+        result = addWithCarry(operand1, operand2, FALSE, &carry, &overflow);
+        writeResult = FALSE;
+        break;
+    case ALU_ADC:
+        result = addWithCarry(operand1, operand2, isCarrySet(pThis), &carry, &overflow);
+        break;
+    case ALU_SBC:
+        result = addWithCarry(operand1, ~operand2, isCarrySet(pThis), &carry, &overflow);
+        break;
+    case ALU_SUB:
+        result = addWithCarry(operand1, ~operand2, TRUE, &carry, &overflow);
+        break;
+    case ALU_CMP:
+        result = addWithCarry(operand1, ~operand2, TRUE, &carry, &overflow);
+        writeResult = FALSE;
+        break;
+    default:
+        result = addWithCarry(~operand1, operand2, TRUE, &carry, &overflow);
+        break;
+    }
+    if (shouldSetFlags(pThis, p))
+        setFlags(pThis, result, carry, overflow);
+    if (writeResult)
+        writeRegister(pThis, p->d, result);
+}
+
+static void executeShiftByRegister(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    int      carry;
+    uint32_t result = shiftWithCarry(readRegister(pThis, p->n), p->shiftType, readRegister(pThis, p->m) & 0xFF,
+                                     isCarrySet(pThis), &carry);
+
+    if (shouldSetFlags(pThis, p))
+        setFlags(pThis, result, carry, (pThis->pContext->R[XPSR] & APSR_V) != 0);
+    writeRegister(pThis, p->d, result);
+}
+
+static void executeAdr(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t base = (pThis->pc + 4) & ~3;
+
+    writeRegister(pThis, p->d, p->op == ALU_ADD ? base + p->imm : base - p->imm);
+}
+
+static void executeMovt(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    writeRegister(pThis, p->d, (p->imm << 16) | (readRegister(pThis, p->d) & 0xFFFF));
+}
+
+static void executeBitfieldSaturate(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t value = readRegister(pThis, p->n);
+    uint32_t lsb = p->a;
+    uint32_t mask;
+    int      carry;
+
+    switch (p->op)
+    {
+    case MISC_SBFX:
+        value = signExtend((value >> lsb) & (0xFFFFFFFF >> (32 - p->imm)), p->imm);
+        break;
+    case MISC_UBFX:
+        value = (value >> lsb) & (0xFFFFFFFF >> (32 - p->imm));
+        break;
+    case MISC_BFI:
+    case MISC_BFC:
+        mask = (0xFFFFFFFF >> (31 - p->imm)) & ~((1U << lsb) - 1);
+        value = p->op == MISC_BFC ? 0 : value << lsb;
+        value = (readRegister(pThis, p->d) & ~mask) | (value & mask);
+        break;
+    default:
+        value = shiftWithCarry(value, p->shiftType, p->shiftAmount, FALSE, &carry);
+        if (p->op == MISC_SSAT)
+            value = saturate(pThis, (int32_t)value, p->imm, TRUE);
+        else
+            value = saturate(pThis, (int32_t)value, p->imm, FALSE);
+        break;
+    }
+    writeRegister(pThis, p->d, value);
+}
+
+static uint32_t saturate(ThumbSim* pThis, int64_t value, uint32_t bits, int isSigned)
+{
+    int64_t maximum;
+    int64_t minimum;
+
+    if (isSigned)
+    {
+        maximum = ((int64_t)1 << (bits - 1)) - 1;
+        minimum = -((int64_t)1 << (bits - 1));
+    }
+    else
+    {
+        maximum = ((int64_t)1 << bits) - 1;
+        minimum = 0;
+    }
+    if (value > maximum || value < minimum)
+    {
+        pThis->pContext->R[XPSR] |= APSR_Q;
+        return (uint32_t)(value > maximum ? maximum : minimum);
+    }
+    return (uint32_t)value;
+}
+
+static void executeMultiplyDivide(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t n = readRegister(pThis, p->n);
+    uint32_t m = readRegister(pThis, p->m);
+    uint64_t accumulator = ((uint64_t)readRegister(pThis, p->d) << 32) | readRegister(pThis, p->a);
+    uint64_t result64;
+    uint32_t result;
+
+    switch (p->op)
+    {
+    case MISC_MUL:
+        result = n * m;
+        if (shouldSetFlags(pThis, p))
+            setNZFlags(pThis, result);
+        writeRegister(pThis, p->d, result);
+        return;
+    case MISC_MLA:
+        writeRegister(pThis, p->d, n * m + readRegister(pThis, p->a));
+        return;
+    case MISC_MLS:
+        writeRegister(pThis, p->d, readRegister(pThis, p->a) - n * m);
+        return;
+    case MISC_SDIV:
+        /* Division by 0 returns 0 since the divide by zero trap is disabled by default. */
+        if (m == 0)
+            result = 0;
+        else if (n == 0x80000000 && m == 0xFFFFFFFF)
+            result = n;
+        else
+            result = (uint32_t)((int32_t)n / (int32_t)m);
+        writeRegister(pThis, p->d, result);
+        return;
+    case MISC_UDIV:
+        writeRegister(pThis, p->d, m == 0 ? 0 : n / m);
+        return;
+    case MISC_SMULL:
+        result64 = (uint64_t)((int64_t)(int32_t)n * (int32_t)m);
+        break;
+    case MISC_UMULL:
+        result64 = (uint64_t)n * m;
+        break;
+    case MISC_SMLAL:
+        result64 = (uint64_t)((int64_t)(int32_t)n * (int32_t)m) + accumulator;
+        break;
+    default:
+        result64 = (uint64_t)n * m + accumulator;
+        break;
+    }
+    writeRegister(pThis, p->a, (uint32_t)result64);
+    writeRegister(pThis, p->d, (uint32_t)(result64 >> 32));
+}
+
+static void executeExtendReverse(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t value = rotateRight(readRegister(pThis, p->m), p->shiftAmount);
+    uint32_t result = 0;
+    uint32_t i;
+
+    switch (p->op)
+    {
+    case MISC_SXTB:
+        result = signExtend(value & 0xFF, 8);
+        break;
+    case MISC_SXTH:
+        result = signExtend(value & 0xFFFF, 16);
+        break;
+    case MISC_UXTB:
+        result = value & 0xFF;
+        break;
+    case MISC_UXTH:
+        result = value & 0xFFFF;
+        break;
+    case MISC_REV:
+        result = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+        break;
+    case MISC_REV16:
+        result = ((value >> 8) & 0x00FF00FF) | ((value << 8) & 0xFF00FF00);
+        break;
+    case MISC_REVSH:
+        result = signExtend(((value >> 8) & 0xFF) | ((value << 8) & 0xFF00), 16);
+        break;
+    case MISC_RBIT:
+        for (i = 0 ; i < 32 ; i++)
+            result |= ((value >> i) & 1) << (31 - i);
+        break;
+    case MISC_CLZ:
+        result = countLeadingZeros(value);
+        break;
+    }
+    /* The extend instructions have an accumulating form when Rn isn't PC. */
+    if (p->op <= MISC_UXTH && p->n != PC)
+        result += readRegister(pThis, p->n);
+    writeRegister(pThis, p->d, result);
+}
+
+static void executeLoadStoreImmediate(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t base = readRegister(pThis, p->n);
+    uint32_t offsetAddress;
+
+    if (p->n == PC)
+        base &= ~3;
+    offsetAddress = (p->flags & FLAG_ADD) ? base + p->imm : base - p->imm;
+    loadStore(pThis, p, (p->flags & FLAG_INDEX) ? offsetAddress : base);
+    if (p->flags & FLAG_WBACK)
+        writeRegister(pThis, p->n, offsetAddress);
+}
+
+static void executeLoadStoreRegister(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    loadStore(pThis, p, readRegister(pThis, p->n) + (readRegister(pThis, p->m) << p->shiftAmount));
+}
+
+static void loadStore(ThumbSim* pThis, const DecodedInstruction* p, uint32_t address)
+{
+    IMemory* pMemory = pThis->pMemory;
+    uint32_t t = p->d;
+
+    switch (p->op)
+    {
+    case LS_STR:
+        IMemory_Write32(pMemory, address, readRegister(pThis, t));
+        break;
+    case LS_STRH:
+        IMemory_Write16(pMemory, address, (uint16_t)readRegister(pThis, t));
+        break;
+    case LS_STRB:
+        IMemory_Write8(pMemory, address, (uint8_t)readRegister(pThis, t));
+        break;
+    case LS_LDR:
+        if (t == PC)
+            bxWritePC(pThis, IMemory_Read32(pMemory, address));
+        else
+            writeRegister(pThis, t, IMemory_Read32(pMemory, address));
+        break;
+    case LS_LDRH:
+        writeRegister(pThis, t, MemorySim_ReadData16(pMemory, address));
+        break;
+    case LS_LDRSH:
+        writeRegister(pThis, t, signExtend(MemorySim_ReadData16(pMemory, address), 16));
+        break;
+    case LS_LDRB:
+        writeRegister(pThis, t, IMemory_Read8(pMemory, address));
+        break;
+    case LS_LDRSB:
+        writeRegister(pThis, t, signExtend(IMemory_Read8(pMemory, address), 8));
+        break;
+    }
+}
+
+static void executeLoadStoreDual(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t base = readRegister(pThis, p->n);
+    uint32_t offsetAddress;
+    uint32_t address;
+
+    if (p->n == PC)
+        base &= ~3;
+    offsetAddress = (p->flags & FLAG_ADD) ? base + p->imm : base - p->imm;
+    address = (p->flags & FLAG_INDEX) ? offsetAddress : base;
+    if (address & 3)
+        __throw(alignmentException);
+    if (p->op == LS_LDR)
+    {
+        uint32_t value1 = IMemory_Read32(pThis->pMemory, address);
+        uint32_t value2 = IMemory_Read32(pThis->pMemory, address + 4);
+
+        writeRegister(pThis, p->d, value1);
+        writeRegister(pThis, p->a, value2);
+    }
+    else
+    {
+        IMemory_Write32(pThis->pMemory, address, readRegister(pThis, p->d));
+        IMemory_Write32(pThis->pMemory, address + 4, readRegister(pThis, p->a));
+    }
+    if (p->flags & FLAG_WBACK)
+        writeRegister(pThis, p->n, offsetAddress);
+}
+
+static void executeLoadExclusive(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t address = readRegister(pThis, p->n) + p->imm;
+
+    if ((p->op == LS_LDR && (address & 3)) || (p->op == LS_LDRH && (address & 1)))
+        __throw(alignmentException);
+    loadStore(pThis, p, address);
+    pThis->isExclusive = TRUE;
+}
+
+static void executeStoreExclusive(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t address = readRegister(pThis, p->n) + p->imm;
+
+    /* The status register is in a, 0 for success and 1 for failure. */
+    if ((p->op == LS_STR && (address & 3)) || (p->op == LS_STRH && (address & 1)))
+        __throw(alignmentException);
+    if (pThis->isExclusive)
+        loadStore(pThis, p, address);
+    writeRegister(pThis, p->a, pThis->isExclusive ? 0 : 1);
+    pThis->isExclusive = FALSE;
+}
+
+static void executeClrex(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    pThis->isExclusive = FALSE;
+}
+
+static void executeLoadMultiple(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t registers = p->imm;
+    uint32_t size = countBits(registers) * sizeof(uint32_t);
+    uint32_t base = readRegister(pThis, p->n);
+    uint32_t address = p->op ? base - size : base;
+    uint32_t values[16];
+    uint32_t i;
+
+    /* Load everything before updating any registers so that a fault leaves them untouched. */
+    if (address & 3)
+        __throw(alignmentException);
+    for (i = 0 ; i < 16 ; i++)
+    {
+        if (registers & (1 << i))
+        {
+            values[i] = IMemory_Read32(pThis->pMemory, address);
+            address += sizeof(uint32_t);
+        }
+    }
+    if (p->flags & FLAG_WBACK)
+        writeRegister(pThis, p->n, p->op ? base - size : base + size);
+    for (i = 0 ; i < 16 ; i++)
+    {
+        if ((registers & (1 << i)) == 0)
+            continue;
+        if (i == PC)
+            bxWritePC(pThis, values[i]);
+        else
+            writeRegister(pThis, i, values[i]);
+    }
+}
+
+static void executeStoreMultiple(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t registers = p->imm;
+    uint32_t size = countBits(registers) * sizeof(uint32_t);
+    uint32_t base = readRegister(pThis, p->n);
+    uint32_t address = p->op ? base - size : base;
+    uint32_t i;
+
+    if (address & 3)
+        __throw(alignmentException);
+    for (i = 0 ; i < 16 ; i++)
+    {
+        if (registers & (1 << i))
+        {
+            IMemory_Write32(pThis->pMemory, address, readRegister(pThis, i));
+            address += sizeof(uint32_t);
+        }
+    }
+    if (p->flags & FLAG_WBACK)
+        writeRegister(pThis, p->n, p->op ? base - size : base + size);
+}
+
+static void executeBranch(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    if (p->op != COND_AL && !conditionPassed(pThis->pContext->R[XPSR], p->op))
+        return;
+    branchWritePC(pThis, pThis->pc + 4 + p->imm);
+}
+
+static void executeBranchWithLink(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    pThis->pContext->R[LR] = pThis->nextPC | 1;
+    branchWritePC(pThis, pThis->pc + 4 + p->imm);
+}
+
+static void executeBranchExchange(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t target = readRegister(pThis, p->m);
+
+    /* BLX when op is set. */
+    if (p->op)
+        pThis->pContext->R[LR] = pThis->nextPC | 1;
+    bxWritePC(pThis, target);
+}
+
+static void executeCompareAndBranch(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    /* CBNZ when op is set. */
+    int isZero = readRegister(pThis, p->n) == 0;
+
+    if (isZero != (p->op != 0))
+        branchWritePC(pThis, pThis->pc + 4 + p->imm);
+}
+
+static void executeTableBranch(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t base = readRegister(pThis, p->n);
+    uint32_t index = readRegister(pThis, p->m);
+    uint32_t halfWords;
+
+    /* TBH when op is set. */
+    if (p->op)
+        halfWords = MemorySim_ReadData16(pThis->pMemory, base + (index << 1));
+    else
+        halfWords = IMemory_Read8(pThis->pMemory, base + index);
+    branchWritePC(pThis, pThis->pc + 4 + halfWords * 2);
+}
+
+static void executeIt(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    pThis->itState = p->imm;
+}
+
+static void executeCps(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    /* op is set for CPSID.  Bit 1 of imm selects PRIMASK and bit 0 selects FAULTMASK. */
+    if (p->imm & 0x2)
+        pThis->primask = p->op;
+    if (p->imm & 0x1)
+        pThis->faultmask = p->op;
+}
+
+static void executeMrs(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    uint32_t xpsr = pThis->pContext->R[XPSR];
+    uint32_t sysm = p->imm;
+    uint32_t value = 0;
+
+    if (sysm < 8)
+    {
+        /* Combinations of APSR and IPSR.  EPSR always reads as 0. */
+        if ((sysm & 0x4) == 0)
+            value |= xpsr & APSR_NZCVQ_MASK;
+        if (sysm & 0x1)
+            value |= xpsr & IPSR_MASK;
+    }
+    else
+    {
+        switch (sysm)
+        {
+        /* SP holds the latest value of whichever stack pointer is active. */
+        case SYSM_MSP:
+            value = isProcessStackActive(pThis) ? pThis->pContext->R[MSP] : pThis->pContext->R[SP];
+            break;
+        case SYSM_PSP:
+            value = isProcessStackActive(pThis) ? pThis->pContext->R[SP] : pThis->pContext->R[PSP];
+            break;
+        case SYSM_PRIMASK:
+            value = pThis->primask;
+            break;
+        case SYSM_BASEPRI:
+        case SYSM_BASEPRI_MAX:
+            value = pThis->basepri;
+            break;
+        case SYSM_FAULTMASK:
+            value = pThis->faultmask;
+            break;
+        case SYSM_CONTROL:
+            value = pThis->control;
+            break;
+        }
+    }
+    writeRegister(pThis, p->d, value);
+}
+
+static void executeMsr(ThumbSim* pThis, const DecodedInstruction* p)
+{
+    RegisterContext* pContext = pThis->pContext;
+    uint32_t         value = readRegister(pThis, p->n);
+
+    switch (p->imm)
+    {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+        /* Only the APSR flags can be written and only when the nzcvq bit of the mask is set. */
+        if (p->a & 0x2)
+            pContext->R[XPSR] = (pContext->R[XPSR] & ~APSR_NZCVQ_MASK) | (value & APSR_NZCVQ_MASK);
+        break;
+    case SYSM_MSP:
+        pContext->R[MSP] = value & ~3;
+        if (!isProcessStackActive(pThis))
+            pContext->R[SP] = pContext->R[MSP];
+        break;
+    case SYSM_PSP:
+        pContext->R[PSP] = value & ~3;
+        if (isProcessStackActive(pThis))
+            pContext->R[SP] = pContext->R[PSP];
+        break;
+    case SYSM_PRIMASK:
+        pThis->primask = value & 1;
+        break;
+    case SYSM_BASEPRI:
+        pThis->basepri = value & 0xFF;
+        break;
+    case SYSM_BASEPRI_MAX:
+        if ((value & 0xFF) != 0 && ((value & 0xFF) < pThis->basepri || pThis->basepri == 0))
+            pThis->basepri = value & 0xFF;
+        break;
+    case SYSM_FAULTMASK:
+        pThis->faultmask = value & 1;
+        break;
+    case SYSM_CONTROL:
+        writeControl(pThis, value);
+        break;
+    }
+}
+
+static void writeControl(ThumbSim* pThis, uint32_t value)
+{
+    RegisterContext* pContext = pThis->pContext;
+    int              wasProcessStackActive = isProcessStackActive(pThis);
+
+    /* SPSEL can only be changed from Thread mode. */
+    if (!isThreadMode(pThis))
+        value = (value & ~CONTROL_SPSEL) | (pThis->control & CONTROL_SPSEL);
+    pThis->control = value & CONTROL_MASK;
+    if (isProcessStackActive(pThis) == wasProcessStackActive)
+        return;
+
+    /* Bank the outgoing stack pointer and switch SP over to the newly selected one. */
+    if (wasProcessStackActive)
+    {
+        pContext->R[PSP] = pContext->R[SP];
+        pContext->R[SP] = pContext->R[MSP];
+    }
+    else
+    {
+        pContext->R[MSP] = pContext->R[SP];
+        pContext->R[SP] = pContext->R[PSP];
+    }
+}
+
+static int isThreadMode(ThumbSim* pThis)
+{
+    return (pThis->pContext->R[XPSR] & IPSR_MASK) == 0;
+}
+
+static int isProcessStackActive(ThumbSim* pThis)
+{
+    return isThreadMode(pThis) && (pThis->control & CONTROL_SPSEL);
+}
+
+
+ThumbSimStats ThumbSim_GetStats(ThumbSim* pThis)
+{
+    return pThis->stats;
+}
@@ -0,0 +1,323 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <Clock.h>
+#include <common.h>
+#include <ctype.h>
+#include <FileFailureInject.h>
+#include <printfSpy.h>
+#include <stdio.h>
+#include <string.h>
+#include <TraceIComm.h>
+
+
+/* Implementation of IComm interface which forwards all calls to another IComm while timing each request from its
+   first received byte to the last sent byte of the response packet. */
+typedef enum PacketState
+{
+    OUTSIDE_PACKET,
+    PACKET_TYPE,
+    PACKET_DATA,
+    PACKET_CHECKSUM1,
+    PACKET_CHECKSUM2
+} PacketState;
+
+typedef struct TraceFileHeader
+{
+    char     signature[TRACE_FILE_SIGNATURE_SIZE];
+    uint32_t version;
+} TraceFileHeader;
+
+typedef struct TraceIComm
+{
+    ICommVTable*   pVTable;
+    IComm*         pWrappedComm;
+    FILE*          pFile;
+    TraceHistogram histograms[128];
+    uint64_t       startMicroseconds;
+    uint64_t       requestMicroseconds;
+    PacketState    receiveState;
+    PacketState    sendState;
+    int            requestType;
+    int            isAwaitingResponse;
+    int            hasWriteFailed;
+} TraceIComm;
+
+static void trackReceivedChar(TraceIComm* pThis, int character);
+static void trackSentChar(TraceIComm* pThis, int character);
+static void recordLatency(TraceIComm* pThis);
+static void addToHistogram(TraceHistogram* pHistogram, uint32_t latencyMicroseconds);
+static uint32_t bucketIndex(uint32_t latencyMicroseconds);
+static uint32_t bucketUpperBound(uint32_t bucket);
+static void writeRecord(TraceIComm* pThis, const TraceRecord* pRecord);
+static void printHistogram(int packetType, const TraceHistogram* pHistogram);
+
+static int  hasReceiveData(IComm* pComm);
+static int  waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds);
+static int  receiveChar(IComm* pComm);
+static void sendChar(IComm* pComm, int character);
+static int  shouldStopRun(IComm* pComm);
+static int  isGdbConnected(IComm* pComm);
+
+static ICommVTable g_icommVTable = {hasReceiveData, waitForReceiveData, receiveChar, sendChar, shouldStopRun, isGdbConnected};
+
+static TraceIComm g_comm;
+
+
+__throws IComm* TraceIComm_Init(IComm* pWrappedComm, const char* pTraceFilename)
+{
+    TraceIComm*     pThis = &g_comm;
+    TraceFileHeader header;
+
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->pVTable = &g_icommVTable;
+    pThis->pWrappedComm = pWrappedComm;
+    pThis->pFile = fopen(pTraceFilename, "wb");
+    if (!pThis->pFile)
+        __throw_msg(fileException, "Failed to create \"%s\" trace file.", pTraceFilename);
+
+    memcpy(header.signature, TRACE_FILE_SIGNATURE, sizeof(header.signature));
+    header.version = TRACE_FILE_VERSION;
+    if (fwrite(&header, 1, sizeof(header), pThis->pFile) != sizeof(header))
+    {
+        fclose(pThis->pFile);
+        pThis->pFile = NULL;
+        __throw_msg(fileException, "Failed to write \"%s\" trace file.", pTraceFilename);
+    }
+    pThis->startMicroseconds = Clock_GetMicroseconds();
+    return (IComm*)pThis;
+}
+
+
+void TraceIComm_Uninit(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+
+    if (!pThis || !pThis->pFile)
+        return;
+    if (fclose(pThis->pFile) != 0)
+        pThis->hasWriteFailed = TRUE;
+    pThis->pFile = NULL;
+}
+
+
+const TraceHistogram* TraceIComm_GetHistogram(IComm* pComm, int packetType)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    return &pThis->histograms[packetType & 0x7F];
+}
+
+
+int TraceIComm_HasWriteFailed(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    return pThis->hasWriteFailed;
+}
+
+
+void TraceIComm_PrintSummary(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    int         i;
+
+    fprintf(stderr, "GDB request latency percentiles (us):\n"
+                    "  Type        Count          p50          p90          p99          Max\n");
+    for (i = 0 ; i < (int)ARRAY_SIZE(pThis->histograms) ; i++)
+        printHistogram(i, &pThis->histograms[i]);
+    if (pThis->hasWriteFailed)
+        fprintf(stderr, "WARNING: Failed to write all records to the trace file.\n");
+}
+
+static void printHistogram(int packetType, const TraceHistogram* pHistogram)
+{
+    char typeString[8];
+
+    if (pHistogram->count == 0)
+        return;
+    if (isgraph(packetType))
+        snprintf(typeString, sizeof(typeString), "%c", packetType);
+    else
+        snprintf(typeString, sizeof(typeString), "0x%02X", packetType);
+    fprintf(stderr, "  %-4s %12lu %12lu %12lu %12lu %12lu\n",
+            typeString, (unsigned long)pHistogram->count,
+            (unsigned long)TraceHistogram_GetPercentile(pHistogram, 50),
+            (unsigned long)TraceHistogram_GetPercentile(pHistogram, 90),
+            (unsigned long)TraceHistogram_GetPercentile(pHistogram, 99),
+            (unsigned long)pHistogram->maxMicroseconds);
+}
+
+
+uint32_t TraceHistogram_GetPercentile(const TraceHistogram* pHistogram, unsigned int percentile)
+{
+    uint64_t target = ((uint64_t)pHistogram->count * percentile + 99) / 100;
+    uint64_t total = 0;
+    uint32_t i;
+
+    if (target == 0)
+        target = 1;
+    for (i = 0 ; i < TRACE_HISTOGRAM_BUCKETS ; i++)
+    {
+        total += pHistogram->buckets[i];
+        if (total >= target)
+            break;
+    }
+    if (i >= TRACE_HISTOGRAM_BUCKETS || bucketUpperBound(i) > pHistogram->maxMicroseconds)
+        return pHistogram->maxMicroseconds;
+    return bucketUpperBound(i);
+}
+
+static uint32_t bucketUpperBound(uint32_t bucket)
+{
+    if (bucket >= TRACE_HISTOGRAM_BUCKETS - 1)
+        return 0xFFFFFFFF;
+    return (1U << bucket) - 1;
+}
+
+
+
+/* IComm Interface Implementation. */
+static int hasReceiveData(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    return IComm_HasReceiveData(pThis->pWrappedComm);
+}
+
+static int waitForReceiveData(IComm* pComm, uint32_t timeoutMilliseconds)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    return IComm_WaitForReceiveData(pThis->pWrappedComm, timeoutMilliseconds);
+}
+
+static int receiveChar(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    int         character = IComm_ReceiveChar(pThis->pWrappedComm);
+
+    trackReceivedChar(pThis, character);
+    return character;
+}
+
+static void trackReceivedChar(TraceIComm* pThis, int character)
+{
+    switch (pThis->receiveState)
+    {
+    case OUTSIDE_PACKET:
+        if (character == '$')
+        {
+            pThis->requestMicroseconds = Clock_GetMicroseconds();
+            pThis->receiveState = PACKET_TYPE;
+        }
+        break;
+    case PACKET_TYPE:
+        pThis->requestType = character & 0x7F;
+        pThis->receiveState = character == '#' ? PACKET_CHECKSUM1 : PACKET_DATA;
+        break;
+    case PACKET_DATA:
+        if (character == '#')
+            pThis->receiveState = PACKET_CHECKSUM1;
+        break;
+    case PACKET_CHECKSUM1:
+        pThis->receiveState = PACKET_CHECKSUM2;
+        break;
+    case PACKET_CHECKSUM2:
+        pThis->receiveState = OUTSIDE_PACKET;
+        pThis->isAwaitingResponse = TRUE;
+        break;
+    }
+}
+
+static void sendChar(IComm* pComm, int character)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+
+    IComm_SendChar(pThis->pWrappedComm, character);
+    trackSentChar(pThis, character);
+}
+
+static void trackSentChar(TraceIComm* pThis, int character)
+{
+    switch (pThis->sendState)
+    {
+    case OUTSIDE_PACKET:
+        if (character == '$')
+            pThis->sendState = PACKET_DATA;
+        break;
+    case PACKET_TYPE:
+    case PACKET_DATA:
+        if (character == '#')
+            pThis->sendState = PACKET_CHECKSUM1;
+        break;
+    case PACKET_CHECKSUM1:
+        pThis->sendState = PACKET_CHECKSUM2;
+        break;
+    case PACKET_CHECKSUM2:
+        pThis->sendState = OUTSIDE_PACKET;
+        if (pThis->isAwaitingResponse)
+            recordLatency(pThis);
+        break;
+    }
+}
+
+static void recordLatency(TraceIComm* pThis)
+{
+    uint64_t    latency = Clock_GetMicroseconds() - pThis->requestMicroseconds;
+    TraceRecord record;
+
+    memset(&record, 0, sizeof(record));
+    record.requestMicroseconds = pThis->requestMicroseconds - pThis->startMicroseconds;
+    record.latencyMicroseconds = latency > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)latency;
+    record.packetType = (uint8_t)pThis->requestType;
+    addToHistogram(&pThis->histograms[pThis->requestType], record.latencyMicroseconds);
+    writeRecord(pThis, &record);
+    pThis->isAwaitingResponse = FALSE;
+}
+
+static void addToHistogram(TraceHistogram* pHistogram, uint32_t latencyMicroseconds)
+{
+    pHistogram->count++;
+    pHistogram->buckets[bucketIndex(latencyMicroseconds)]++;
+    if (latencyMicroseconds > pHistogram->maxMicroseconds)
+        pHistogram->maxMicroseconds = latencyMicroseconds;
+}
+
+static uint32_t bucketIndex(uint32_t latencyMicroseconds)
+{
+    uint32_t bucket = 0;
+
+    while (latencyMicroseconds != 0 && bucket < TRACE_HISTOGRAM_BUCKETS - 1)
+    {
+        latencyMicroseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void writeRecord(TraceIComm* pThis, const TraceRecord* pRecord)
+{
+    /* A failing trace file shouldn't end the debug session so just stop writing to it. */
+    if (!pThis->pFile || pThis->hasWriteFailed)
+        return;
+    if (fwrite(pRecord, 1, sizeof(*pRecord), pThis->pFile) != sizeof(*pRecord))
+        pThis->hasWriteFailed = TRUE;
+}
+
+static int shouldStopRun(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    return IComm_ShouldStopRun(pThis->pWrappedComm);
+}
+
+static int isGdbConnected(IComm* pComm)
+{
+    TraceIComm* pThis = (TraceIComm*)pComm;
+    return IComm_IsGdbConnected(pThis->pWrappedComm);
+}
@@ -23,6 +23,7 @@
 #include <posix4win.h>
 #include <printfSpy.h>
 #include <semihost.h>
+#include <ThumbSim.h>
 
 
 /* NOTE: This is the original version of the following XML which has had things stripped to reduce the amount of
@@ -139,6 +140,13 @@ static const char g_targetFpuXML[] =
 #define MMFAR 0xE000ED34
 #define BFAR  0xE000ED38
 
+/* The MRI core polls Platform_CommHasReceiveData() in a loop while it waits for GDB to send the next packet.  Blocking
+   for up to this long in each call keeps an idle session from spinning a CPU core. */
+#define COMM_WAIT_TIMEOUT_MILLISECONDS 50
+
+/* Number of instructions to simulate between checks for GDB sending a break (CTRL+C) while continuing. */
+#define INSTRUCTIONS_PER_COMM_POLL (64 * 1024)
+
 
 static RegisterContext* g_pContext;
 static IMemory*         g_pMemory;
@@ -146,13 +154,26 @@ static IComm*           g_pComm;
 static char             g_packetBuffer[16 * 1024];
 static int              g_memoryFaultEncountered;
 static int              g_shouldWaitForGdbConnect = TRUE;
+static ThumbSim         g_sim;
+static int              g_isSingleStepping;
+static uint32_t         g_pcOnEntry;
+/* Signal for the last stop in simulated execution, 0 until code has been executed. */
+static uint8_t          g_stopSignal;
+/* Set by mriPlatform_RequestStop() which can be called from a signal handler. */
+static volatile sig_atomic_t g_isStopRequested;
 
 
 /* Core MRI function not exposed in public header since typically called by ASM. */
 void __mriDebugException(void);
 
 /* Forward static function declarations. */
+static void runUntilStopped(void);
+static void throwIfStopRequested(void);
+static void resumeExecution(void);
+static uint8_t signalFromStopReason(ThumbSimStopReason stopReason);
 static uint32_t getCurrentlyExecutingExceptionNumber(void);
+static uint32_t getExceptionNumber(const RegisterContext* pContext);
+static uint32_t readFaultStatusRegister(IMemory* pMem, uint32_t address);
 static void displayHardFaultCauseToGdbConsole(void);
 static void displayMemFaultCauseToGdbConsole(void);
 static void displayBusFaultCauseToGdbConsole(void);
@@ -161,6 +182,9 @@ static void sendRegisterForTResponse(Buffer* pBuffer, uint8_t registerOffset, ui
 static void writeBytesToBufferAsHex(Buffer* pBuffer, void* pBytes, size_t byteCount);
 static int hasFPURegisters();
 static void readBytesFromBufferAsHex(Buffer* pBuffer, void* pBytes, size_t byteCount);
+static uint32_t breakpointSizeFromKind(uint32_t kind);
+static WatchpointType watchpointTypeFromPlatformType(PlatformWatchpointType type);
+static int peekCurrentInstruction(uint16_t* pInstruction);
 
 
 __throws void mriPlatform_Init(RegisterContext* pContext, IMemory* pMem)
@@ -168,17 +192,91 @@ __throws void mriPlatform_Init(RegisterContext* pContext, IMemory* pMem)
     g_pContext = pContext;
     g_pMemory = pMem;
     g_memoryFaultEncountered = FALSE;
+    g_isSingleStepping = FALSE;
+    g_stopSignal = 0;
+    ThumbSim_Init(&g_sim, pMem, pContext);
 
     __mriInit("");
 }
 
+void mriPlatform_Uninit(void)
+{
+    ThumbSim_Uninit(&g_sim);
+    g_isStopRequested = FALSE;
+}
+
 void mriPlatform_Run(IComm* pComm)
 {
     g_pComm = pComm;
-    do
+    __try
+    {
+        runUntilStopped();
+    }
+    __catch
+    {
+        /* A stop request unwinds out of the MRI core from wherever it was waiting on GDB. */
+        if (getExceptionCode() != stopRequestedException)
+            __rethrow;
+        clearExceptionCode();
+    }
+}
+
+static void runUntilStopped(void)
+{
+    for (;;)
     {
         __mriDebugException();
-    } while (!IComm_ShouldStopRun(pComm));
+        if (IComm_ShouldStopRun(g_pComm))
+            break;
+        resumeExecution();
+    }
+}
+
+void mriPlatform_RequestStop(void)
+{
+    g_isStopRequested = TRUE;
+}
+
+static void throwIfStopRequested(void)
+{
+    if (g_isStopRequested)
+        __throw(stopRequestedException);
+}
+
+static void resumeExecution(void)
+{
+    ThumbSimStopReason stopReason;
+
+    if (g_isSingleStepping)
+    {
+        g_stopSignal = signalFromStopReason(ThumbSim_Run(&g_sim, 1));
+        return;
+    }
+    do
+    {
+        throwIfStopRequested();
+        stopReason = ThumbSim_Run(&g_sim, INSTRUCTIONS_PER_COMM_POLL);
+        if (stopReason != THUMB_SIM_STOP_COUNT)
+        {
+            g_stopSignal = signalFromStopReason(stopReason);
+            return;
+        }
+    } while (!IComm_HasReceiveData(g_pComm));
+    /* GDB sent a break so stop and let the debug exception handler process it. */
+    g_stopSignal = SIGINT;
+}
+
+static uint8_t signalFromStopReason(ThumbSimStopReason stopReason)
+{
+    switch (stopReason)
+    {
+    case THUMB_SIM_STOP_BUS_FAULT:
+        return SIGBUS;
+    case THUMB_SIM_STOP_USAGE_FAULT:
+        return SIGILL;
+    default:
+        return SIGTRAP;
+    }
 }
 
 /* This routine is just used for unit testing so that it can run tests where a T response packet and/or exception
@@ -209,6 +307,7 @@ uint32_t  Platform_GetPacketBufferSize(void)
 
 void Platform_EnteringDebugger(void)
 {
+    g_pcOnEntry = g_pContext->R[PC];
     Platform_DisableSingleStep();
 }
 
@@ -219,9 +318,7 @@ void Platform_LeavingDebugger(void)
 uint32_t Platform_MemRead32(const void* pv)
 {
     uint32_t retVal = 0;
-    __try
-        retVal = IMemory_Read32(g_pMemory, (uint32_t)(unsigned long)pv);
-    __catch
+    if (!IMemory_TryRead32(g_pMemory, (uint32_t)(unsigned long)pv, &retVal))
         g_memoryFaultEncountered++;
     return retVal;
 }
@@ -229,9 +326,7 @@ uint32_t Platform_MemRead32(const void* pv)
 uint16_t Platform_MemRead16(const void* pv)
 {
     uint16_t retVal = 0;
-    __try
-        retVal = IMemory_Read16(g_pMemory, (uint32_t)(unsigned long)pv);
-    __catch
+    if (!MemorySim_TryReadData16(g_pMemory, (uint32_t)(unsigned long)pv, &retVal))
         g_memoryFaultEncountered++;
     return retVal;
 }
@@ -239,40 +334,33 @@ uint16_t Platform_MemRead16(const void* pv)
 uint8_t Platform_MemRead8(const void* pv)
 {
     uint8_t retVal = 0;
-    __try
-        retVal = IMemory_Read8(g_pMemory, (uint32_t)(unsigned long)pv);
-    __catch
+    if (!IMemory_TryRead8(g_pMemory, (uint32_t)(unsigned long)pv, &retVal))
         g_memoryFaultEncountered++;
     return retVal;
 }
 
 void Platform_MemWrite32(void* pv, uint32_t value)
 {
-    __try
-        IMemory_Write32(g_pMemory, (uint32_t)(unsigned long)pv, value);
-    __catch
+    if (!IMemory_TryWrite32(g_pMemory, (uint32_t)(unsigned long)pv, value))
         g_memoryFaultEncountered++;
 }
 
 void Platform_MemWrite16(void* pv, uint16_t value)
 {
-    __try
-        IMemory_Write16(g_pMemory, (uint32_t)(unsigned long)pv, value);
-    __catch
+    if (!IMemory_TryWrite16(g_pMemory, (uint32_t)(unsigned long)pv, value))
         g_memoryFaultEncountered++;
 }
 
 void Platform_MemWrite8(void* pv, uint8_t value)
 {
-    __try
-        IMemory_Write8(g_pMemory, (uint32_t)(unsigned long)pv, value);
-    __catch
+    if (!IMemory_TryWrite8(g_pMemory, (uint32_t)(unsigned long)pv, value))
         g_memoryFaultEncountered++;
 }
 
 uint32_t Platform_CommHasReceiveData(void)
 {
-    return IComm_HasReceiveData(g_pComm);
+    throwIfStopRequested();
+    return IComm_WaitForReceiveData(g_pComm, COMM_WAIT_TIMEOUT_MILLISECONDS);
 }
 
 int Platform_CommReceiveChar(void)
@@ -310,6 +398,10 @@ void Platform_CommPrepareToWaitForGdbConnection(void)
 
 int Platform_CommIsWaitingForGdbToConnect(void)
 {
+    throwIfStopRequested();
+    if (IComm_IsGdbConnected(g_pComm))
+        return FALSE;
+    IComm_WaitForReceiveData(g_pComm, COMM_WAIT_TIMEOUT_MILLISECONDS);
     return !IComm_IsGdbConnected(g_pComm);
 }
 
@@ -321,6 +413,9 @@ uint8_t Platform_DetermineCauseOfException(void)
 {
     uint32_t exceptionNumber = getCurrentlyExecutingExceptionNumber();
 
+    /* Once code has been executed, the exception in the dump is no longer the reason for stopping. */
+    if (g_stopSignal)
+        return g_stopSignal;
     switch(exceptionNumber)
     {
     case 2:
@@ -349,11 +444,38 @@ uint8_t Platform_DetermineCauseOfException(void)
 
 static uint32_t getCurrentlyExecutingExceptionNumber(void)
 {
-    return (g_pContext->exceptionPSR & 0xFF);
+    return getExceptionNumber(g_pContext);
+}
+
+static uint32_t getExceptionNumber(const RegisterContext* pContext)
+{
+    return (pContext->exceptionPSR & 0xFF);
+}
+
+FaultStatus mriPlatform_GetFaultStatus(IMemory* pMem, const RegisterContext* pContext)
+{
+    FaultStatus status;
+
+    status.exceptionNumber = getExceptionNumber(pContext);
+    status.hardFaultStatus = readFaultStatusRegister(pMem, HFSR);
+    status.configurableFaultStatus = readFaultStatusRegister(pMem, CFSR);
+    return status;
+}
+
+static uint32_t readFaultStatusRegister(IMemory* pMem, uint32_t address)
+{
+    uint32_t value = 0;
+
+    if (!IMemory_TryRead32(pMem, address, &value))
+        return 0;
+    return value;
 }
 
 void Platform_DisplayFaultCauseToGdbConsole(void)
 {
+    /* The fault status registers in the dump don't describe faults hit while executing code in the simulator. */
+    if (g_stopSignal)
+        return;
     switch (getCurrentlyExecutingExceptionNumber())
     {
     case 3:
@@ -543,33 +665,33 @@ static void displayUsageFaultCauseToGdbConsole(void)
 
 void Platform_EnableSingleStep(void)
 {
+    g_isSingleStepping = TRUE;
 }
 
 void Platform_DisableSingleStep(void)
 {
+    g_isSingleStepping = FALSE;
 }
 
 int Platform_IsSingleStepping(void)
 {
-    /* Can't really single step so just return FALSE here. */
-    return FALSE;
+    return g_isSingleStepping;
 }
 
 void Platform_SetProgramCounter(uint32_t newPC)
 {
-    /* This is just called when user tries to set new PC value from continue command which we don't really support
-       so just ignore this request. */
+    g_pContext->R[PC] = newPC;
 }
 
 void Platform_AdvanceProgramCounterToNextInstruction(void)
 {
-    /* This is just called to advance past hardcoded breakpoints before continuing execution so just ignore. */
+    /* Only called to skip over hardcoded breakpoints which are always 16-bit instructions. */
+    g_pContext->R[PC] += sizeof(uint16_t);
 }
 
 int Platform_WasProgramCounterModifiedByUser(void)
 {
-    /* Pretend that PC was always modified so that mriCore doesn't check for hardcoded breakpoint on resume. */
-    return TRUE;
+    return g_pContext->R[PC] != g_pcOnEntry;
 }
 
 int Platform_WasMemoryFaultEncountered(void)
@@ -660,30 +782,71 @@ const char* Platform_GetTargetXml(void)
 
 __throws void Platform_SetHardwareBreakpoint(uint32_t address, uint32_t kind)
 {
-    /* Ignore during post-mortem debugging. */
+    MemorySim_SetHardwareBreakpoint(g_pMemory, address, breakpointSizeFromKind(kind));
 }
 
 __throws void Platform_ClearHardwareBreakpoint(uint32_t address, uint32_t kind)
 {
-    /* Ignore during post-mortem debugging. */
+    MemorySim_ClearHardwareBreakpoint(g_pMemory, address, breakpointSizeFromKind(kind));
+}
+
+static uint32_t breakpointSizeFromKind(uint32_t kind)
+{
+    /* GDB uses a kind of 3 for breakpoints on 32-bit Thumb-2 instructions. */
+    return kind == 3 ? sizeof(uint32_t) : sizeof(uint16_t);
 }
 
 __throws void Platform_SetHardwareWatchpoint(uint32_t address, uint32_t size, PlatformWatchpointType type)
 {
-    /* Ignore during post-mortem debugging. */
+    MemorySim_SetHardwareWatchpoint(g_pMemory, address, size, watchpointTypeFromPlatformType(type));
 }
 
 __throws void Platform_ClearHardwareWatchpoint(uint32_t address, uint32_t size,  PlatformWatchpointType type)
 {
-    /* Ignore during post-mortem debugging. */
+    MemorySim_ClearHardwareWatchpoint(g_pMemory, address, size, watchpointTypeFromPlatformType(type));
+}
+
+static WatchpointType watchpointTypeFromPlatformType(PlatformWatchpointType type)
+{
+    switch (type)
+    {
+    case MRI_PLATFORM_READ_WATCHPOINT:
+        return WATCHPOINT_READ;
+    case MRI_PLATFORM_WRITE_WATCHPOINT:
+        return WATCHPOINT_WRITE;
+    default:
+        return WATCHPOINT_READ_WRITE;
+    }
 }
 
 PlatformInstructionType Platform_TypeOfCurrentInstruction(void)
 {
-    /* Ignore semihost and hard coded breakpoint instructions during post-mortem debugging. */
+    uint16_t instruction = 0;
+
+    /* Semihost calls are ignored but hardcoded breakpoints need to be skipped when execution is resumed. */
+    if (!peekCurrentInstruction(&instruction))
+        return MRI_PLATFORM_INSTRUCTION_OTHER;
+    if ((instruction & 0xFF00) == 0xBE00)
+        return MRI_PLATFORM_INSTRUCTION_HARDCODED_BREAKPOINT;
     return MRI_PLATFORM_INSTRUCTION_OTHER;
 }
 
+static int peekCurrentInstruction(uint16_t* pInstruction)
+{
+    /* Bypass IMemory so that hardware breakpoints and FLASH read counts aren't triggered by this check. */
+    const void* volatile pData = NULL;
+    uint32_t             spanSize = 0;
+
+    __try
+        pData = MemorySim_MapSimulatedAddressToHostSpan(g_pMemory, g_pContext->R[PC], &spanSize);
+    __catch
+        clearExceptionCode();
+    if (!pData || spanSize < sizeof(*pInstruction))
+        return FALSE;
+    memcpy(pInstruction, (const void*)pData, sizeof(*pInstruction));
+    return TRUE;
+}
+
 PlatformSemihostParameters Platform_GetSemihostCallParameters(void)
 {
     /* Ignore during post-mortem debugging. */
@@ -0,0 +1,362 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CompactDump.h>
+    #include <Crc32.h>
+    #include <DumpLoad.h>
+    #include <FileFailureInject.h>
+    #include <MemorySim.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+// Offsets of fields within a compact dump file containing the RAM region followed by the random region.
+#define VERSION_OFFSET          4
+#define INDEX_CRC_OFFSET        12
+#define CONTEXT_OFFSET          16
+#define CONTEXT_SIZE            ((1 + TOTAL_REG_COUNT + 1 + TOTAL_FPREG_COUNT) * 4)
+#define INDEX_OFFSET            (CONTEXT_OFFSET + CONTEXT_SIZE)
+#define INDEX_ENTRY_SIZE        24
+#define ENCODING_OFFSET         8
+#define FILE_OFFSET_OFFSET      12
+#define STORED_SIZE_OFFSET      16
+
+#define RAM_BASE                0x10000000
+#define RANDOM_BASE             0x20000000
+#define RANDOM_SIZE             64
+
+static const char* g_compactFilename = "CompactDumpTest.dmp";
+
+
+TEST_GROUP(CompactDump)
+{
+    IMemory*        m_pSource;
+    IMemory*        m_pDest;
+    RegisterContext m_sourceContext;
+    RegisterContext m_destContext;
+    uint8_t*        m_pFile;
+    long            m_fileSize;
+
+    void setup()
+    {
+        static const uint32_t flashImage[2] = { 0x10000100, 0x00000101 };
+
+        m_pFile = NULL;
+        m_fileSize = 0;
+        m_pSource = MemorySim_Init();
+        MemorySim_CreateRegionsFromFlashImage(m_pSource, flashImage, sizeof(flashImage));
+        IMemory_Write32(m_pSource, RAM_BASE + 0x10, 0x11111111);
+        IMemory_Write32(m_pSource, RAM_BASE + 0xFC, 0xFFFFFFFF);
+        MemorySim_CreateRegion(m_pSource, RANDOM_BASE, RANDOM_SIZE);
+        uint32_t seed = 0x12345678;
+        for (uint32_t i = 0 ; i < RANDOM_SIZE ; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            IMemory_Write8(m_pSource, RANDOM_BASE + i, seed >> 24);
+        }
+        MemorySim_CreateAlias(m_pSource, 0xA0000000, RAM_BASE, 0x100);
+
+        memset(&m_sourceContext, 0, sizeof(m_sourceContext));
+        for (size_t i = 0 ; i < ARRAY_SIZE(m_sourceContext.R) ; i++)
+            m_sourceContext.R[i] = 0x11111111 * i;
+        m_sourceContext.flags = 1;
+        m_sourceContext.exceptionPSR = 3;
+        for (size_t i = 0 ; i < ARRAY_SIZE(m_sourceContext.FPR) ; i++)
+            m_sourceContext.FPR[i] = 0xF0000000 | i;
+
+        m_pDest = MemorySim_Create();
+        memset(&m_destContext, 0, sizeof(m_destContext));
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        fopenRestore();
+        fwriteRestore();
+        free(m_pFile);
+        MemorySim_Destroy(m_pDest);
+        MemorySim_Uninit(m_pSource);
+        remove(g_compactFilename);
+    }
+
+    void readCompactFile()
+    {
+        FILE* pFile = fopen(g_compactFilename, "rb");
+        CHECK(pFile != NULL);
+        fseek(pFile, 0, SEEK_END);
+        m_fileSize = ftell(pFile);
+        fseek(pFile, 0, SEEK_SET);
+        m_pFile = (uint8_t*)malloc(m_fileSize);
+        CHECK_EQUAL(m_fileSize, (long)fread(m_pFile, 1, m_fileSize, pFile));
+        fclose(pFile);
+    }
+
+    void rewriteCompactFile(long size)
+    {
+        FILE* pFile = fopen(g_compactFilename, "wb");
+        fwrite(m_pFile, 1, size, pFile);
+        fclose(pFile);
+    }
+
+    uint32_t fileWord(size_t offset)
+    {
+        const uint8_t* p = m_pFile + offset;
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    void setFileWord(size_t offset, uint32_t value)
+    {
+        uint8_t* p = m_pFile + offset;
+        p[0] = (uint8_t)value;
+        p[1] = (uint8_t)(value >> 8);
+        p[2] = (uint8_t)(value >> 16);
+        p[3] = (uint8_t)(value >> 24);
+    }
+
+    uint32_t indexField(size_t region, size_t fieldOffset)
+    {
+        return fileWord(INDEX_OFFSET + region * INDEX_ENTRY_SIZE + fieldOffset);
+    }
+
+    void validateReadThrows(int expectedException, const char* pExpectedMessage)
+    {
+        __try_and_catch( CompactDump_Read(m_pDest, &m_destContext, g_compactFilename) );
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        clearExceptionCode();
+        STRCMP_EQUAL(pExpectedMessage, getExceptionMessage());
+    }
+
+    void validateAccessThrows(uint32_t address, int expectedException, const char* pExpectedMessage)
+    {
+        __try_and_catch( MemorySim_MapSimulatedAddressToHostAddressForRead(m_pDest, address, 4) );
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        clearExceptionCode();
+        STRCMP_EQUAL(pExpectedMessage, getExceptionMessage());
+    }
+
+    void validateDestMatchesSource()
+    {
+        CHECK_EQUAL(0, memcmp(&m_sourceContext, &m_destContext, sizeof(m_sourceContext)));
+        CHECK_EQUAL(2, MemorySim_GetRegionCount(m_pDest));
+        CHECK_EQUAL(0, memcmp(MemorySim_MapSimulatedAddressToHostAddressForRead(m_pSource, RAM_BASE, 0x100),
+                              MemorySim_MapSimulatedAddressToHostAddressForRead(m_pDest, RAM_BASE, 0x100),
+                              0x100));
+        CHECK_EQUAL(0, memcmp(MemorySim_MapSimulatedAddressToHostAddressForRead(m_pSource, RANDOM_BASE, RANDOM_SIZE),
+                              MemorySim_MapSimulatedAddressToHostAddressForRead(m_pDest, RANDOM_BASE, RANDOM_SIZE),
+                              RANDOM_SIZE));
+    }
+};
+
+TEST(CompactDump, WriteAndRead_ShouldRoundTripRegistersAndWritableRegions)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    CompactDump_Read(m_pDest, &m_destContext, g_compactFilename);
+    validateDestMatchesSource();
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pDest, RAM_BASE + 0x10));
+}
+
+TEST(CompactDump, Write_ShouldStoreEachRegisterAsLittleEndianWord)
+{
+    static const uint8_t expectedFlags[4] = { 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t expectedR1[4] = { 0x11, 0x11, 0x11, 0x11 };
+    static const uint8_t expectedR2[4] = { 0x22, 0x22, 0x22, 0x22 };
+    static const uint8_t expectedExceptionPSR[4] = { 0x03, 0x00, 0x00, 0x00 };
+    static const uint8_t expectedFPR1[4] = { 0x01, 0x00, 0x00, 0xF0 };
+    const uint8_t*       pR;
+    const uint8_t*       pFPR;
+
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    pR = m_pFile + CONTEXT_OFFSET + 4;
+    pFPR = pR + TOTAL_REG_COUNT * 4 + 4;
+    CHECK_EQUAL(0, memcmp(expectedFlags, m_pFile + CONTEXT_OFFSET, 4));
+    CHECK_EQUAL(0, memcmp(expectedR1, pR + 1 * 4, 4));
+    CHECK_EQUAL(0, memcmp(expectedR2, pR + 2 * 4, 4));
+    CHECK_EQUAL(0, memcmp(expectedExceptionPSR, pR + TOTAL_REG_COUNT * 4, 4));
+    CHECK_EQUAL(0, memcmp(expectedFPR1, pFPR + 1 * 4, 4));
+}
+
+TEST(CompactDump, Write_ShouldStoreHeaderAsLittleEndianWords)
+{
+    static const uint8_t expectedHeader[12] = { 'C', 'D', 'M', 'P',
+                                                0x01, 0x00, 0x00, 0x00,
+                                                0x02, 0x00, 0x00, 0x00 };
+    uint32_t             indexCrc;
+
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    indexCrc = Crc32_Calculate(m_pFile + CONTEXT_OFFSET, CONTEXT_SIZE + 2 * INDEX_ENTRY_SIZE);
+    CHECK_EQUAL(0, memcmp(expectedHeader, m_pFile, sizeof(expectedHeader)));
+    CHECK_EQUAL((uint8_t)indexCrc, m_pFile[INDEX_CRC_OFFSET]);
+    CHECK_EQUAL((uint8_t)(indexCrc >> 8), m_pFile[INDEX_CRC_OFFSET + 1]);
+    CHECK_EQUAL((uint8_t)(indexCrc >> 16), m_pFile[INDEX_CRC_OFFSET + 2]);
+    CHECK_EQUAL((uint8_t)(indexCrc >> 24), m_pFile[INDEX_CRC_OFFSET + 3]);
+}
+
+TEST(CompactDump, Write_ShouldStoreIndexEntriesAsLittleEndianWords)
+{
+    static const uint8_t expectedRandomBaseAndSize[8] = { 0x00, 0x00, 0x00, 0x20,
+                                                          RANDOM_SIZE, 0x00, 0x00, 0x00 };
+
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    CHECK_EQUAL(0, memcmp(expectedRandomBaseAndSize, m_pFile + INDEX_OFFSET + INDEX_ENTRY_SIZE,
+                          sizeof(expectedRandomBaseAndSize)));
+}
+
+TEST(CompactDump, Write_ShouldSkipFlashAndAliasesAndOnlyCompressWhenSmaller)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    CHECK_EQUAL(0, memcmp(COMPACT_DUMP_SIGNATURE, m_pFile, COMPACT_DUMP_SIGNATURE_SIZE));
+    // RAM region is mostly zeroes so it is stored compressed but the random region is stored raw.
+    CHECK_EQUAL(1, indexField(0, ENCODING_OFFSET));
+    CHECK(indexField(0, STORED_SIZE_OFFSET) < 0x100 / 4);
+    CHECK_EQUAL(0, indexField(1, ENCODING_OFFSET));
+    CHECK_EQUAL(RANDOM_SIZE, indexField(1, STORED_SIZE_OFFSET));
+    CHECK_EQUAL(m_fileSize, (long)(indexField(1, FILE_OFFSET_OFFSET) + RANDOM_SIZE));
+}
+
+TEST(CompactDump, DumpLoad_ShouldDetectCompactDumpSignature)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    DumpLoad_FromFile(m_pDest, &m_destContext, g_compactFilename);
+    validateDestMatchesSource();
+}
+
+TEST(CompactDump, FailToCreateFile_ShouldThrow)
+{
+    fopenSetReturn(NULL);
+    __try_and_catch( CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename) );
+    fopenRestore();
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("Failed to create \"CompactDumpTest.dmp\" compact dump file.", getExceptionMessage());
+}
+
+TEST(CompactDump, FailToWriteFile_ShouldThrowAndRemoveFile)
+{
+    fwriteFail(0);
+    __try_and_catch( CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename) );
+    fwriteRestore();
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("Failed to write \"CompactDumpTest.dmp\" compact dump file.", getExceptionMessage());
+    POINTERS_EQUAL(NULL, fopen(g_compactFilename, "rb"));
+}
+
+TEST(CompactDump, ReadNonExistentFile_ShouldThrow)
+{
+    validateReadThrows(fileException, "Failed to open \"CompactDumpTest.dmp\".");
+}
+
+TEST(CompactDump, ReadTruncatedHeader_ShouldThrow)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    rewriteCompactFile(INDEX_OFFSET - 1);
+    validateReadThrows(fileFormatException, "The dump file was too short to contain the compact dump header.");
+}
+
+TEST(CompactDump, ReadBadSignature_ShouldThrow)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    m_pFile[0] = 'X';
+    rewriteCompactFile(m_fileSize);
+    validateReadThrows(fileFormatException, "The dump file didn't start with the expected compact dump signature.");
+}
+
+TEST(CompactDump, ReadUnsupportedVersion_ShouldThrow)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    m_pFile[VERSION_OFFSET] = 2;
+    rewriteCompactFile(m_fileSize);
+    validateReadThrows(fileFormatException, "The compact dump file has unsupported version 2.");
+}
+
+TEST(CompactDump, ReadTruncatedIndex_ShouldThrow)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    rewriteCompactFile(INDEX_OFFSET + INDEX_ENTRY_SIZE + 1);
+    validateReadThrows(fileFormatException, "The dump file was too short to contain the compact dump region index.");
+}
+
+TEST(CompactDump, ReadCorruptRegisterContext_ShouldFailCrcCheck)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    m_pFile[CONTEXT_OFFSET + 4] ^= 0x01;
+    rewriteCompactFile(m_fileSize);
+    validateReadThrows(fileFormatException, "The compact dump file's register context and region index failed CRC check.");
+}
+
+TEST(CompactDump, ReadTruncatedRegionData_ShouldThrow)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    rewriteCompactFile(m_fileSize - 1);
+    validateReadThrows(fileFormatException, "The compact dump file contained a truncated memory region at 0x20000000.");
+}
+
+TEST(CompactDump, ReadUnknownEncoding_ShouldThrow)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    m_pFile[INDEX_OFFSET + INDEX_ENTRY_SIZE + ENCODING_OFFSET] = 2;
+    setFileWord(INDEX_CRC_OFFSET, Crc32_Calculate(m_pFile + CONTEXT_OFFSET, CONTEXT_SIZE + 2 * INDEX_ENTRY_SIZE));
+    rewriteCompactFile(m_fileSize);
+    validateReadThrows(fileFormatException, "The compact dump file contained an unknown encoding for memory region at 0x20000000.");
+    CHECK_EQUAL(1, MemorySim_GetRegionCount(m_pDest));
+}
+
+TEST(CompactDump, ReadCorruptRawRegion_ShouldOnlyFailCrcCheckOnFirstAccess)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    m_pFile[m_fileSize - 1] ^= 0x01;
+    rewriteCompactFile(m_fileSize);
+    CompactDump_Read(m_pDest, &m_destContext, g_compactFilename);
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pDest, RAM_BASE + 0x10));
+    validateAccessThrows(RANDOM_BASE, fileFormatException, "The compact dump file contained a corrupt memory region at 0x20000000.");
+}
+
+TEST(CompactDump, ReadCorruptCompressedRegion_ShouldOnlyThrowOnFirstAccess)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    readCompactFile();
+    m_pFile[indexField(0, FILE_OFFSET_OFFSET)] ^= 0xFF;
+    rewriteCompactFile(m_fileSize);
+    CompactDump_Read(m_pDest, &m_destContext, g_compactFilename);
+    CHECK_EQUAL(2, MemorySim_GetRegionCount(m_pDest));
+    validateAccessThrows(RAM_BASE, fileFormatException, "The compact dump file contained a corrupt memory region at 0x10000000.");
+    validateAccessThrows(RAM_BASE, fileFormatException, "The compact dump file contained a corrupt memory region at 0x10000000.");
+}
+
+TEST(CompactDump, Read_ShouldKeepFileMappedUntilRegionsAreFreed)
+{
+    CompactDump_Write(m_pSource, &m_sourceContext, g_compactFilename);
+    CompactDump_Read(m_pDest, &m_destContext, g_compactFilename);
+    remove(g_compactFilename);
+    validateDestMatchesSource();
+}
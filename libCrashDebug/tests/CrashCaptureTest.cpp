@@ -0,0 +1,278 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrashCapture.h>
+    #include <CrashCatcher.h>
+    #include <MallocFailureInject.h>
+    #include <MemorySim.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+struct HexDumpWithOneRegion
+{
+    uint8_t                      signature[4];
+    uint32_t                     flags;
+    uint32_t                     R[TOTAL_REG_COUNT];
+    uint32_t                     exceptionPSR;
+    CrashCatcherMemoryRegionInfo region;
+    uint32_t                     regionData[2];
+};
+
+static const char* g_captureFilename = "CrashCaptureTest.log";
+
+
+TEST_GROUP(CrashCapture)
+{
+    IMemory*             m_pMem;
+    RegisterContext      m_context;
+    HexDumpWithOneRegion m_dump;
+    std::string          m_hexDump;
+
+    void setup()
+    {
+        m_pMem = MemorySim_Init();
+        memset(&m_context, 0, sizeof(m_context));
+        initDump(0xAAAAAAAA);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MemorySim_Uninit(m_pMem);
+        MallocFailureInject_Restore();
+        clearExceptionCode();
+        remove(g_captureFilename);
+    }
+
+    void initDump(uint32_t regionValue)
+    {
+        memset(&m_dump, 0, sizeof(m_dump));
+        m_dump.signature[0] = CRASH_CATCHER_SIGNATURE_BYTE0;
+        m_dump.signature[1] = CRASH_CATCHER_SIGNATURE_BYTE1;
+        m_dump.signature[2] = CRASH_CATCHER_VERSION_MAJOR;
+        m_dump.signature[3] = CRASH_CATCHER_VERSION_MINOR;
+        for (size_t i = 0 ; i < ARRAY_SIZE(m_dump.R) ; i++)
+            m_dump.R[i] = 0x01010101 * i;
+        m_dump.region.startAddress = 0x10000000;
+        m_dump.region.endAddress = 0x10000008;
+        m_dump.regionData[0] = regionValue;
+        m_dump.regionData[1] = 0xBBBBBBBB;
+        m_hexDump = hexLines(&m_dump, sizeof(m_dump), "\n");
+    }
+
+    std::string hexLines(const void* pData, size_t dataSize, const char* pLineEnd)
+    {
+        static const char nibbleToHex[] = "0123456789ABCDEF";
+        const uint8_t*    pCurr = (const uint8_t*)pData;
+        std::string       text;
+
+        for (size_t i = 0 ; i < dataSize ; i++)
+        {
+            text += nibbleToHex[pCurr[i] >> 4];
+            text += nibbleToHex[pCurr[i] & 0xF];
+            if (i % 16 == 15 || i == dataSize - 1)
+                text += pLineEnd;
+        }
+        return text;
+    }
+
+    void capture(const std::string& text)
+    {
+        FILE* pFile = fopen(g_captureFilename, "wb");
+        fwrite(text.c_str(), 1, text.length(), pFile);
+        fclose(pFile);
+        CrashCapture_FromFile(m_pMem, &m_context, g_captureFilename, CRASH_CAPTURE_DEFAULT_BAUD_RATE);
+    }
+
+    void captureFromPipe(const std::string& text)
+    {
+        DumpStream stream;
+        int        fds[2];
+
+        CHECK_EQUAL(0, pipe(fds));
+        CHECK_EQUAL((ssize_t)text.length(), write(fds[1], text.c_str(), text.length()));
+        close(fds[1]);
+        DumpStream_Init(&stream, fdopen(fds[0], "rb"));
+        __try_and_catch( CrashCapture_FromStream(m_pMem, &m_context, &stream) );
+        DumpStream_Close(&stream);
+    }
+
+    int openPseudoTerminal(const char** ppSlaveName)
+    {
+        int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+
+        CHECK_TRUE(masterFd >= 0);
+        CHECK_EQUAL(0, grantpt(masterFd));
+        CHECK_EQUAL(0, unlockpt(masterFd));
+        *ppSlaveName = ptsname(masterFd);
+        CHECK_TRUE(*ppSlaveName != NULL);
+        return masterFd;
+    }
+
+    void validateDumpLoaded(uint32_t regionValue)
+    {
+        CHECK_EQUAL(0x01010101 * PC, m_context.R[PC]);
+        CHECK_EQUAL(regionValue, IMemory_Read32(m_pMem, 0x10000000));
+        CHECK_EQUAL(0xBBBBBBBB, IMemory_Read32(m_pMem, 0x10000004));
+    }
+};
+
+
+TEST(CrashCapture, InvalidFilename_ShouldThrow)
+{
+    __try_and_catch( CrashCapture_FromFile(m_pMem, &m_context, "invalid/file.log", CRASH_CAPTURE_DEFAULT_BAUD_RATE) );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    STRCMP_EQUAL("Failed to open \"invalid/file.log\" for crash dump capture.", getExceptionMessage());
+    clearExceptionCode();
+}
+
+TEST(CrashCapture, DumpWithCrashCatcherFraming_ShouldSkipTextAroundDump)
+{
+    captureFromPipe("\r\nCRASH ENCOUNTERED\r\nEnable logging and then press any key to start dump.\r\n\r\n" +
+                    m_hexDump +
+                    "\r\nEnd of dump\r\n\r\n\r\nCRASH ENCOUNTERED\r\n");
+    validateDumpLoaded(0xAAAAAAAA);
+}
+
+TEST(CrashCapture, DumpWithCRLFLineEndings_ShouldLoad)
+{
+    capture("CRASH ENCOUNTERED\r\n" + hexLines(&m_dump, sizeof(m_dump), "\r\n") + "End of dump\r\n");
+    validateDumpLoaded(0xAAAAAAAA);
+}
+
+TEST(CrashCapture, LowercaseHexDigitsAndSurroundingWhitespace_ShouldLoad)
+{
+    std::string text = m_hexDump;
+    for (size_t i = 0 ; i < text.length() ; i++)
+        text[i] = tolower(text[i]);
+    capture("  CRASH ENCOUNTERED \n  " + text + "  End of dump  \n");
+    validateDumpLoaded(0xAAAAAAAA);
+}
+
+TEST(CrashCapture, DumpInterruptedByDeviceReset_ShouldDiscardItAndCaptureNextDump)
+{
+    std::string firstDump = m_hexDump.substr(0, 40) + "\n";
+    initDump(0xCCCCCCCC);
+    captureFromPipe("CRASH ENCOUNTERED\n" + firstDump +
+                    "CRASH ENCOUNTERED\nEnable logging and then press any key to start dump.\n" +
+                    m_hexDump + "End of dump\n");
+    validateDumpLoaded(0xCCCCCCCC);
+}
+
+TEST(CrashCapture, HexLinesWithoutSignatureBeforeDump_ShouldBeIgnored)
+{
+    capture("CRASH ENCOUNTERED\nDEADBEEF\n12345678\n" + m_hexDump + "End of dump\n");
+    validateDumpLoaded(0xAAAAAAAA);
+}
+
+TEST(CrashCapture, SignatureHexBeforeBanner_ShouldBeIgnored)
+{
+    std::string unframedDump = m_hexDump;
+    initDump(0xCCCCCCCC);
+    capture(unframedDump + "End of dump\nCRASH ENCOUNTERED\n" + m_hexDump + "End of dump\n");
+    validateDumpLoaded(0xCCCCCCCC);
+}
+
+TEST(CrashCapture, DumpInterruptedByOtherText_ShouldWaitForNextBanner)
+{
+    std::string firstDump = m_hexDump.substr(0, 40) + "\n";
+    std::string unframedDump = m_hexDump;
+    initDump(0xCCCCCCCC);
+    capture("CRASH ENCOUNTERED\n" + firstDump + "Booting...\n" + unframedDump + "End of dump\n" +
+            "CRASH ENCOUNTERED\n" + m_hexDump + "End of dump\n");
+    validateDumpLoaded(0xCCCCCCCC);
+}
+
+TEST(CrashCapture, DumpWithoutBanner_ShouldThrowAtEndOfStream)
+{
+    captureFromPipe(m_hexDump + "End of dump\n");
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    STRCMP_EQUAL("The capture stream ended before a complete crash dump was received.", getExceptionMessage());
+    clearExceptionCode();
+}
+
+TEST(CrashCapture, PseudoTerminal_ShouldSwitchToRawModeAtRequestedBaudRate)
+{
+    const char*    pSlaveName;
+    int            masterFd = openPseudoTerminal(&pSlaveName);
+    int            slaveFd = open(pSlaveName, O_RDWR | O_NOCTTY);
+    std::string    text = "CRASH ENCOUNTERED\n" + m_hexDump + "End of dump\n";
+    struct termios settings;
+
+    CHECK_TRUE(slaveFd >= 0);
+    CHECK_EQUAL((ssize_t)text.length(), write(masterFd, text.c_str(), text.length()));
+    CrashCapture_FromFile(m_pMem, &m_context, pSlaveName, 9600);
+    validateDumpLoaded(0xAAAAAAAA);
+    CHECK_EQUAL(0, tcgetattr(slaveFd, &settings));
+    CHECK_EQUAL(B9600, cfgetispeed(&settings));
+    CHECK_EQUAL(B9600, cfgetospeed(&settings));
+    CHECK_EQUAL(0, settings.c_lflag & (ICANON | ECHO));
+    CHECK_EQUAL(0, settings.c_iflag & ICRNL);
+    close(slaveFd);
+    close(masterFd);
+}
+
+TEST(CrashCapture, PseudoTerminalWithUnsupportedBaudRate_ShouldThrow)
+{
+    const char* pSlaveName;
+    int         masterFd = openPseudoTerminal(&pSlaveName);
+
+    __try_and_catch( CrashCapture_FromFile(m_pMem, &m_context, pSlaveName, 12345) );
+    CHECK_EQUAL(invalidArgumentException, getExceptionCode());
+    STRCMP_EQUAL("12345 isn't a supported baud rate.", getExceptionMessage());
+    clearExceptionCode();
+    close(masterFd);
+}
+
+TEST(CrashCapture, StreamEndsBeforeEndOfDump_ShouldThrow)
+{
+    captureFromPipe("CRASH ENCOUNTERED\n" + m_hexDump);
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    STRCMP_EQUAL("The capture stream ended before a complete crash dump was received.", getExceptionMessage());
+    clearExceptionCode();
+}
+
+TEST(CrashCapture, StreamWithNoDump_ShouldThrow)
+{
+    captureFromPipe("CRASH ENCOUNTERED\nEnable logging and then press any key to start dump.\n");
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(CrashCapture, TruncatedDumpBeforeEndOfDump_ShouldThrowFromDumpParser)
+{
+    __try_and_catch( capture("CRASH ENCOUNTERED\n" + hexLines(&m_dump, sizeof(m_dump) - 4, "\n") + "End of dump\n") );
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(CrashCapture, FailAllocationOfCaptureBuffer_ShouldThrow)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( capture("CRASH ENCOUNTERED\n" + m_hexDump + "End of dump\n") );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+}
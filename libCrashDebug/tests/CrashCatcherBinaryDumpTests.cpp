@@ -23,6 +23,7 @@ TEST_GROUP_BASE(CrashCatcherBinaryDump, DumpBaseTest)
 
     void teardown()
     {
+        ftellRestore();
         DumpBaseTest::teardown();
     }
 
@@ -32,6 +33,14 @@ TEST_GROUP_BASE(CrashCatcherBinaryDump, DumpBaseTest)
         fwrite(pData, 1, dataSize, pFile);
         fclose(pFile);
     }
+
+    void overwriteTestDumpFile(long offset, const void* pData, size_t dataSize)
+    {
+        FILE* pFile = fopen(m_pTestFilename, "r+b");
+        fseek(pFile, offset, SEEK_SET);
+        fwrite(pData, 1, dataSize, pFile);
+        fclose(pFile);
+    }
 };
 
 
@@ -40,3 +49,58 @@ TEST_GROUP_BASE(CrashCatcherBinaryDump, DumpBaseTest)
 #define CRASH_CATCHER_DUMP_READ_FUNC CrashCatcherDump_ReadBinary
 
 #include "CrashCatcherDumpTests.h"
+
+
+struct OneRegionFileData
+{
+    DumpFileTop                  fileTop;
+    CrashCatcherMemoryRegionInfo region1;
+    uint32_t                     region1Data[1];
+};
+
+TEST(CrashCatcherBinaryDump, DumpContainingOneMemoryRegion_ShouldNotReadRegionDataUntilFirstAccess)
+{
+    static const uint32_t newData = 0x22222222;
+    OneRegionFileData     fileData;
+    memcpy(&fileData.fileTop, &m_fileTop, sizeof(m_fileTop));
+    fileData.region1.startAddress = 0x10000000;
+    fileData.region1.endAddress = 0x10000004;
+    fileData.region1Data[0] = 0x11111111;
+    createTestDumpFile(&fileData, sizeof(fileData));
+        CrashCatcherDump_ReadBinary(m_pMem, &m_actualRegisters, m_pTestFilename);
+    overwriteTestDumpFile(offsetof(OneRegionFileData, region1Data), &newData, sizeof(newData));
+    CHECK_EQUAL(0x22222222, IMemory_Read32(m_pMem, 0x10000000));
+}
+
+TEST(CrashCatcherBinaryDump, FailReadOfRegionDataOnFirstAccess_ShouldThrowFromMemoryAccess)
+{
+    OneRegionFileData fileData;
+    memcpy(&fileData.fileTop, &m_fileTop, sizeof(m_fileTop));
+    fileData.region1.startAddress = 0x10000000;
+    fileData.region1.endAddress = 0x10000004;
+    fileData.region1Data[0] = 0x11111111;
+    createTestDumpFile(&fileData, sizeof(fileData));
+        CrashCatcherDump_ReadBinary(m_pMem, &m_actualRegisters, m_pTestFilename);
+    freadFail(0);
+        __try_and_catch( IMemory_Read32(m_pMem, 0x10000000) );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    freadRestore();
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMem, 0x10000000));
+}
+
+TEST(CrashCatcherBinaryDump, FailToDetermineFileSize_ShouldFallBackToReadingRegionDataUpFront)
+{
+    static const uint32_t newData = 0x22222222;
+    OneRegionFileData     fileData;
+    memcpy(&fileData.fileTop, &m_fileTop, sizeof(m_fileTop));
+    fileData.region1.startAddress = 0x10000000;
+    fileData.region1.endAddress = 0x10000004;
+    fileData.region1Data[0] = 0x11111111;
+    createTestDumpFile(&fileData, sizeof(fileData));
+    ftellFail(-1);
+        CrashCatcherDump_ReadBinary(m_pMem, &m_actualRegisters, m_pTestFilename);
+    ftellRestore();
+    overwriteTestDumpFile(offsetof(OneRegionFileData, region1Data), &newData, sizeof(newData));
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMem, 0x10000000));
+}
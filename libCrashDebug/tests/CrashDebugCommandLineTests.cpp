@@ -11,6 +11,8 @@
     GNU General Public License for more details.
 */
 #include "string.h"
+#include <dirent.h>
+#include <unistd.h>
 
 // Include headers from C modules under test.
 extern "C"
@@ -20,6 +22,7 @@ extern "C"
     #include <FileFailureInject.h>
     #include <MallocFailureInject.h>
     #include <CrashDebugCommandLine.h>
+    #include <mockClock.h>
     #include <printfSpy.h>
 }
 
@@ -42,12 +45,15 @@ struct ElfFile
 static const char     g_usageString[] = "Usage:";
 static const char*    g_imageFilename = "image.bin";
 static const char*    g_elfFilename = "image.elf";
+static const char*    g_cacheDirectory = "CrashDebugCommandLineTests.dir";
 static const char*    g_dumpFilenameV2 = "gdb_v2.txt";
 static const char*    g_dumpFilenameV3 = "gdb_v3.txt";
 static const char*    g_hexDumpFilenameV2 = "crash_v2.txt";
 static const char*    g_hexDumpFilenameV3 = "crash_v3.txt";
 static const char*    g_binDumpFilenameV2 = "crash_v2.dmp";
 static const char*    g_binDumpFilenameV3 = "crash_v3.dmp";
+static const char*    g_ramFilename = "ram.bin";
+static const uint32_t g_ramData[2] = { 0xCAFEBABE, 0x8BADF00D };
 static const uint32_t g_imageData[2] = { 0x10000004, 0x00000100 };
 static const char     g_dumpDataV2[] =  "0x10000000:\t0x11111111\t0x22222222\t0x33333333\t0x44444444\n"
                                       "r0             0x5a5a5a5a\t0\n"
@@ -173,6 +179,7 @@ TEST_GROUP(CrashDebugCommandLine)
         fwriteRestore();
         printfSpy_Unhook();
         MallocFailureInject_Restore();
+        ClockMock_Uninit();
         CrashDebugCommandLine_Uninit(&m_commandLine);
         remove(g_imageFilename);
         remove(g_dumpFilenameV2);
@@ -182,6 +189,32 @@ TEST_GROUP(CrashDebugCommandLine)
         remove(g_hexDumpFilenameV3);
         remove(g_binDumpFilenameV3);
         remove(g_elfFilename);
+        remove(g_ramFilename);
+        removeCacheDirectory();
+    }
+
+    void removeCacheDirectory()
+    {
+        DIR*           pDir = opendir(g_cacheDirectory);
+        struct dirent* pEntry;
+
+        if (!pDir)
+            return;
+        while ((pEntry = readdir(pDir)) != NULL)
+        {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/%s", g_cacheDirectory, pEntry->d_name);
+            remove(path);
+        }
+        closedir(pDir);
+        rmdir(g_cacheDirectory);
+    }
+
+    void createRamFile(const void* pData, size_t dataSize)
+    {
+        FILE* pFile = fopen(g_ramFilename, "wb");
+        fwrite(pData, 1, dataSize, pFile);
+        fclose(pFile);
     }
 
     void checkRegisters()
@@ -1026,3 +1059,849 @@ TEST(CrashDebugCommandLine, UsingAliasesWithLargeSizesToBeTruncated_ValidateMemo
     m_expectedRegisters.R[MSP] = 0xa5a5a5a5;
     m_expectedRegisters.R[PSP] = 0xbcbcbcbc;
 }
+
+TEST(CrashDebugCommandLine, LeaveOffCacheDirectory_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--cache");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --cache command line option requires directory.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, InvalidElfFilenameWithCache_ShouldThrow)
+{
+    addArg("--elf");
+    addArg("invalidFilename.elf");
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--cache");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(fileException, "Failed to open \"invalidFilename.elf\".");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, InvalidElfSignatureWithCache_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--cache");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    m_elfFile.elfHeader.e_ident[EI_MAG0] += 1;
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(elfFormatException, "ELF header doesn't start with expected magic ELF identifier.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfWithCache_FirstRunShouldMissAndSecondRunShouldHit_ValidateMemoryAndRegisters)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--cache");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    POINTERS_EQUAL(NULL, m_commandLine.elfCacheFile.pData);
+    CHECK_EQUAL(g_imageData[0], IMemory_Read32(m_commandLine.pMemory, 0x00000000));
+    CHECK_EQUAL(g_imageData[1], IMemory_Read32(m_commandLine.pMemory, 0x00000004));
+    CrashDebugCommandLine_Uninit(&m_commandLine);
+
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    CHECK(m_commandLine.elfCacheFile.pData != NULL);
+    CHECK_EQUAL(g_imageData[0], IMemory_Read32(m_commandLine.pMemory, 0x00000000));
+    CHECK_EQUAL(g_imageData[1], IMemory_Read32(m_commandLine.pMemory, 0x00000004));
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_commandLine.pMemory, 0x10000000));
+    CHECK_EQUAL(0x22222222, IMemory_Read32(m_commandLine.pMemory, 0x10000004));
+    CHECK_EQUAL(0x33333333, IMemory_Read32(m_commandLine.pMemory, 0x10000008));
+    CHECK_EQUAL(0x44444444, IMemory_Read32(m_commandLine.pMemory, 0x1000000c));
+    m_expectedRegisters.R[R0]  = 0x5a5a5a5a;
+    m_expectedRegisters.R[R1]  = 0x11111111;
+    m_expectedRegisters.R[R2]  = 0x22222222;
+    m_expectedRegisters.R[R3]  = 0x33333333;
+    m_expectedRegisters.R[R4]  = 0x44444444;
+    m_expectedRegisters.R[R5]  = 0x55555555;
+    m_expectedRegisters.R[R6]  = 0x66666666;
+    m_expectedRegisters.R[R7]  = 0x77777777;
+    m_expectedRegisters.R[R8]  = 0x88888888;
+    m_expectedRegisters.R[R9]  = 0x99999999;
+    m_expectedRegisters.R[R10] = 0xAAAAAAAA;
+    m_expectedRegisters.R[R11] = 0xBBBBBBBB;
+    m_expectedRegisters.R[R12] = 0xCCCCCCCC;
+    m_expectedRegisters.R[SP]  = 0xDDDDDDDD;
+    m_expectedRegisters.R[LR]  = 0xEEEEEEEE;
+    m_expectedRegisters.R[PC]  = 0xFFFFFFFF;
+    m_expectedRegisters.R[XPSR] = 0xF00DF00D;
+    m_expectedRegisters.R[MSP] = DEFAULT_SP_VALUE;
+    m_expectedRegisters.R[PSP] = DEFAULT_SP_VALUE;
+}
+
+TEST(CrashDebugCommandLine, LeaveOffDedupDirectory_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --dedup command line option requires directory.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothDumpAndDedup_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --dump and --dedup command line options are mutually exclusive.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffJobsCount_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    addArg("--jobs");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --jobs command line option requires count.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ZeroJobsCount_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    addArg("--jobs");
+    addArg("0");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --jobs command line option requires a count greater than 0.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, JobsWithoutDedup_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--jobs");
+    addArg("4");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --jobs command line option requires --dedup.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfWithDedupAndJobs_ShouldLoadFlashButNoDump)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    addArg("--jobs");
+    addArg("4");
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL(g_cacheDirectory, m_commandLine.pDedupDirectory);
+    CHECK_EQUAL(4, m_commandLine.jobCount);
+    POINTERS_EQUAL(NULL, m_commandLine.pDumpFilename);
+    CHECK_EQUAL(g_imageData[0], IMemory_Read32(m_commandLine.pMemory, 0x00000000));
+    CHECK_EQUAL(g_imageData[1], IMemory_Read32(m_commandLine.pMemory, 0x00000004));
+    __try_and_catch( IMemory_Read32(m_commandLine.pMemory, 0x10000000) );
+    CHECK_EQUAL(busErrorException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(CrashDebugCommandLine, ValidElfWithDedupButNoJobs_ShouldDefaultJobCountToZero)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL(g_cacheDirectory, m_commandLine.pDedupDirectory);
+    CHECK_EQUAL(0, m_commandLine.jobCount);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffSplitDirectory_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_dumpFilenameV2);
+    addArg("--split");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --split command line option requires directory.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SplitWithoutDedup_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--split");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --split command line option requires --dedup.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfWithDedupLogAndSplit_ShouldLoadFlashButNoDump)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_dumpFilenameV2);
+    addArg("--split");
+    addArg(g_cacheDirectory);
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL(g_dumpFilenameV2, m_commandLine.pDedupDirectory);
+    STRCMP_EQUAL(g_cacheDirectory, m_commandLine.pSplitDirectory);
+    POINTERS_EQUAL(NULL, m_commandLine.pDumpFilename);
+    CHECK_EQUAL(g_imageData[0], IMemory_Read32(m_commandLine.pMemory, 0x00000000));
+}
+
+TEST(CrashDebugCommandLine, LeaveOffCoreFilename_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--core");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --core command line option requires filename.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothCoreAndDedup_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    addArg("--core");
+    addArg("crash.core");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --core and --dedup command line options are mutually exclusive.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfDumpAndCore_ShouldLoadDumpAndRecordCoreFilename)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--core");
+    addArg("crash.core");
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL("crash.core", m_commandLine.pCoreFilename);
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_commandLine.pMemory, 0x10000000));
+    m_expectedRegisters.R[R0]  = 0x5a5a5a5a;
+    m_expectedRegisters.R[R1]  = 0x11111111;
+    m_expectedRegisters.R[R2]  = 0x22222222;
+    m_expectedRegisters.R[R3]  = 0x33333333;
+    m_expectedRegisters.R[R4]  = 0x44444444;
+    m_expectedRegisters.R[R5]  = 0x55555555;
+    m_expectedRegisters.R[R6]  = 0x66666666;
+    m_expectedRegisters.R[R7]  = 0x77777777;
+    m_expectedRegisters.R[R8]  = 0x88888888;
+    m_expectedRegisters.R[R9]  = 0x99999999;
+    m_expectedRegisters.R[R10] = 0xAAAAAAAA;
+    m_expectedRegisters.R[R11] = 0xBBBBBBBB;
+    m_expectedRegisters.R[R12] = 0xCCCCCCCC;
+    m_expectedRegisters.R[SP]  = 0xDDDDDDDD;
+    m_expectedRegisters.R[LR]  = 0xEEEEEEEE;
+    m_expectedRegisters.R[PC]  = 0xFFFFFFFF;
+    m_expectedRegisters.R[XPSR] = 0xF00DF00D;
+    m_expectedRegisters.R[MSP] = DEFAULT_SP_VALUE;
+    m_expectedRegisters.R[PSP] = DEFAULT_SP_VALUE;
+}
+
+TEST(CrashDebugCommandLine, LeaveOffConvertFilename_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--convert");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --convert command line option requires filename.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothConvertAndDedup_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    addArg("--convert");
+    addArg("crash.cdmp");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --convert and --dedup command line options are mutually exclusive.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothConvertAndCore_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV2);
+    addArg("--core");
+    addArg("crash.core");
+    addArg("--convert");
+    addArg("crash.cdmp");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --convert and --core command line options are mutually exclusive.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfDumpAndConvert_ShouldLoadDumpAndRecordConvertFilename)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--convert");
+    addArg("crash.cdmp");
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL("crash.cdmp", m_commandLine.pConvertFilename);
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_commandLine.pMemory, 0x10000000));
+    m_expectedRegisters = m_commandLine.context;
+}
+
+TEST(CrashDebugCommandLine, ValidElfAndDumpWithoutStats_ShouldNotSetDisplayStats)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    CHECK_FALSE(m_commandLine.displayStats);
+    m_expectedRegisters = m_commandLine.context;
+}
+
+TEST(CrashDebugCommandLine, ValidElfDumpAndStats_ShouldSetDisplayStatsAndRecordPhaseTimes)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--stats");
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    initElfFile();
+    createTestFiles();
+    ClockMock_SetMicroseconds(1000);
+    ClockMock_SetIncrement(25);
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    CHECK_TRUE(m_commandLine.displayStats);
+    CHECK_EQUAL(1000, m_commandLine.startMicroseconds);
+    CHECK_EQUAL(1025, m_commandLine.imageLoadedMicroseconds);
+    CHECK_EQUAL(1050, m_commandLine.dumpLoadedMicroseconds);
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_commandLine.pMemory, 0x10000000));
+    m_expectedRegisters = m_commandLine.context;
+}
+
+TEST(CrashDebugCommandLine, LeaveOffTraceFilename_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--trace");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --trace command line option requires filename.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfDumpAndTrace_ShouldRecordTraceFilename)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--trace");
+    addArg("session.trace");
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL("session.trace", m_commandLine.pTraceFilename);
+    m_expectedRegisters = m_commandLine.context;
+}
+
+TEST(CrashDebugCommandLine, SpecifyHeapWithBin_ShouldThrowAsElfIsRequired)
+{
+    addArg("--bin");
+    addArg(g_imageFilename);
+    addArg("0x00000000");
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--heap");
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --heap command line option requires --elf.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothHeapAndCore_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--core");
+    addArg("crash.core");
+    addArg("--heap");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --heap command line option can't be used with --dedup, --core or --convert.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffDiffFilename_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--diff");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --diff command line option requires filename.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothDiffAndHeap_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--diff");
+    addArg(g_hexDumpFilenameV3);
+    addArg("--heap");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --diff command line option can't be used with --dedup, --core, --convert or --heap.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyDumpFromStdinWithoutCoreConvertHeapDiffOrStacks_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg("-");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "Reading --dump from stdin requires --core, --convert, --heap, --diff or --stacks since GDB uses stdin.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyStacksWithBin_ShouldThrowAsElfIsRequired)
+{
+    addArg("--bin");
+    addArg(g_imageFilename);
+    addArg("0x00000000");
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--stacks");
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --stacks command line option requires --elf.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothStacksAndHeap_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--heap");
+    addArg("--stacks");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --stacks command line option can't be used with --dedup, --core, --convert, --heap or --diff.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffCaptureFilename_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--capture");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --capture command line option requires filename.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothCaptureAndDump_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--capture");
+    addArg(g_hexDumpFilenameV3);
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --capture command line option can't be used with --dump or --dedup.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, CaptureFromLogMissingEndOfDump_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--capture");
+    addArg(g_hexDumpFilenameV3);
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(fileFormatException, "The capture stream ended before a complete crash dump was received.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffBaudRate_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--capture");
+    addArg(g_hexDumpFilenameV3);
+    addArg("--baud");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --baud command line option requires baudRate.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ZeroBaudRate_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--capture");
+    addArg(g_hexDumpFilenameV3);
+    addArg("--baud");
+    addArg("0");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --baud command line option requires a rate greater than 0.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, BaudWithoutCapture_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--baud");
+    addArg("9600");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --baud command line option requires --capture.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, CaptureWithBaudFromRegularFile_ShouldRecordBaudRateAndIgnoreIt)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--capture");
+    addArg(g_hexDumpFilenameV3);
+    addArg("--baud");
+    addArg("12345");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    // An unsupported rate would have been rejected if the file was a tty so the capture gets as far as the log.
+    validateExceptionThrownAndUsageStringDisplayed(fileFormatException, "The capture stream ended before a complete crash dump was received.");
+    CHECK_EQUAL(12345, m_commandLine.baudRate);
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfDumpAndDiff_ShouldRecordDiffFilename)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--diff");
+    addArg(g_hexDumpFilenameV3);
+    initElfFile();
+    createTestFiles();
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL(g_hexDumpFilenameV3, m_commandLine.pDiffFilename);
+    m_expectedRegisters = m_commandLine.context;
+}
+
+TEST(CrashDebugCommandLine, SpecifyHeapWithElfMissingSymbolTable_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--heap");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(elfFormatException, "ELF doesn't contain any section headers.");
+    CHECK(m_commandLine.pMemory == NULL);
+    CHECK(m_commandLine.symbols.pStrings == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyStacksWithElfMissingSymbolTable_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_binDumpFilenameV3);
+    addArg("--stacks");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(elfFormatException, "ELF doesn't contain any section headers.");
+    CHECK(m_commandLine.pMemory == NULL);
+    CHECK(m_commandLine.symbols.pStrings == NULL);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffCaptureScriptMemoryMapFilename_ShouldThrow)
+{
+    addArg("--capture-script");
+    addArg("capture.gdb");
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --capture-script command line option requires scriptFilename and memoryMapFilename.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothCaptureScriptAndElf_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--capture-script");
+    addArg("capture.gdb");
+    addArg("memmap.txt");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --capture-script command line option can't be used with --elf, --bin, --dump, --dedup, --capture or --ram.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, CaptureScriptOnItsOwn_ShouldRecordFilenamesAndNotLoadAnything)
+{
+    addArg("--capture-script");
+    addArg("capture.gdb");
+    addArg("memmap.txt");
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    STRCMP_EQUAL("capture.gdb", m_commandLine.pCaptureScriptFilename);
+    STRCMP_EQUAL("memmap.txt", m_commandLine.pMemoryMapFilename);
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, LeaveOffRamBaseAddress_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --ram command line option requires filename and baseAddress.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, ValidElfAndRamWithoutDump_ShouldMapRamImageCopyOnWrite)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0x60000000");
+    initElfFile();
+    createTestFiles();
+    createRamFile(g_ramData, sizeof(g_ramData));
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    CHECK_EQUAL(1, m_commandLine.ramImageCount);
+    CHECK_EQUAL(0xCAFEBABE, IMemory_Read32(m_commandLine.pMemory, 0x60000000));
+    CHECK_EQUAL(0x8BADF00D, IMemory_Read32(m_commandLine.pMemory, 0x60000004));
+    // Registers should be seeded from the reset vectors since there is no dump.
+    m_expectedRegisters.R[SP] = g_imageData[0];
+    m_expectedRegisters.R[MSP] = g_imageData[0];
+    m_expectedRegisters.R[PSP] = DEFAULT_SP_VALUE;
+    m_expectedRegisters.R[LR] = 0xFFFFFFFF;
+    m_expectedRegisters.R[PC] = g_imageData[1];
+    m_expectedRegisters.R[XPSR] = 1 << 24;
+    IMemory_Write32(m_commandLine.pMemory, 0x60000000, 0x12345678);
+    CHECK_EQUAL(0x12345678, IMemory_Read32(m_commandLine.pMemory, 0x60000000));
+
+    uint32_t onDisk[2];
+    FILE*    pFile = fopen(g_ramFilename, "rb");
+    CHECK_EQUAL(ARRAY_SIZE(onDisk), fread(onDisk, sizeof(onDisk[0]), ARRAY_SIZE(onDisk), pFile));
+    fclose(pFile);
+    CHECK_EQUAL(0xCAFEBABE, onDisk[0]);
+}
+
+TEST(CrashDebugCommandLine, RamImageCoveringVtorWithoutDump_ShouldSeedRegistersFromRelocatedVectorTable)
+{
+    // Little-endian SP and reset vector followed by VTOR (0xE000ED08) pointing back at the start of this image.
+    static const uint8_t scbImage[12] = { 0x00, 0x20, 0x00, 0x20,
+                                          0x01, 0x03, 0x00, 0x00,
+                                          0x00, 0xED, 0x00, 0xE0 };
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0xE000ED00");
+    initElfFile();
+    createTestFiles();
+    createRamFile(scbImage, sizeof(scbImage));
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    m_expectedRegisters.R[SP] = 0x20002000;
+    m_expectedRegisters.R[MSP] = 0x20002000;
+    m_expectedRegisters.R[PSP] = DEFAULT_SP_VALUE;
+    m_expectedRegisters.R[LR] = 0xFFFFFFFF;
+    m_expectedRegisters.R[PC] = 0x00000300;
+    m_expectedRegisters.R[XPSR] = 1 << 24;
+}
+
+TEST(CrashDebugCommandLine, MultipleRamImagesAndDump_RamShouldTakePrecedenceOverDump)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dump");
+    addArg(g_dumpFilenameV3);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0x10000000");
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0xC0000000");
+    initElfFile();
+    createTestFiles();
+    createRamFile(g_ramData, sizeof(g_ramData));
+        CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv);
+    CHECK_EQUAL(2, m_commandLine.ramImageCount);
+    CHECK_EQUAL(0xCAFEBABE, IMemory_Read32(m_commandLine.pMemory, 0x10000000));
+    CHECK_EQUAL(0x33333333, IMemory_Read32(m_commandLine.pMemory, 0x10000008));
+    CHECK_EQUAL(0x8BADF00D, IMemory_Read32(m_commandLine.pMemory, 0xC0000004));
+    m_expectedRegisters = m_commandLine.context;
+}
+
+TEST(CrashDebugCommandLine, EmptyRamImage_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0x60000000");
+    initElfFile();
+    createTestFiles();
+    createRamFile("", 0);
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(fileFormatException, "The \"ram.bin\" RAM image is empty.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, RamImagePastEndOfAddressSpace_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0xFFFFFFFC");
+    initElfFile();
+    createTestFiles();
+    createRamFile(g_ramData, sizeof(g_ramData));
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "Failed to create RAM region at address 0xFFFFFFFC for \"ram.bin\".");
+    CHECK(m_commandLine.pMemory == NULL);
+}
+
+TEST(CrashDebugCommandLine, SpecifyBothRamAndDedup_ShouldThrow)
+{
+    addArg("--elf");
+    addArg(g_elfFilename);
+    addArg("--dedup");
+    addArg(g_cacheDirectory);
+    addArg("--ram");
+    addArg(g_ramFilename);
+    addArg("0x60000000");
+    initElfFile();
+    createTestFiles();
+        __try_and_catch( CrashDebugCommandLine_Init(&m_commandLine, m_argc, m_argv) );
+    validateExceptionThrownAndUsageStringDisplayed(invalidArgumentException, "The --ram and --dedup command line options are mutually exclusive.");
+    CHECK(m_commandLine.pMemory == NULL);
+}
@@ -0,0 +1,110 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <CrashDebugStats.h>
+    #include <MemorySim.h>
+    #include <mockClock.h>
+    #include <printfSpy.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+TEST_GROUP(CrashDebugStats)
+{
+    CrashDebugCommandLine m_commandLine;
+    RspStats              m_rspStats;
+
+    void setup()
+    {
+        memset(&m_commandLine, 0, sizeof(m_commandLine));
+        memset(&m_rspStats, 0, sizeof(m_rspStats));
+        m_commandLine.pMemory = MemorySim_Init();
+        m_commandLine.startMicroseconds = 1000;
+        m_commandLine.imageLoadedMicroseconds = 3500;
+        m_commandLine.dumpLoadedMicroseconds = 4000;
+        ClockMock_SetMicroseconds(11000);
+        printfSpy_Hook(256);
+    }
+
+    void teardown()
+    {
+        printfSpy_Unhook();
+        ClockMock_Uninit();
+        MemorySim_Uninit(m_commandLine.pMemory);
+    }
+};
+
+
+TEST(CrashDebugStats, WithoutRspStats_ShouldPrintPhaseTimesAndMemorySimStats)
+{
+    MemorySim_CreateRegion(m_commandLine.pMemory, 0x10000000, 4);
+    IMemory_Read32(m_commandLine.pMemory, 0x10000000);
+
+    CrashDebugStats_Print(&m_commandLine, NULL);
+
+    CHECK_EQUAL(5, printfSpy_GetCallCount());
+    STRCMP_EQUAL("  Image load               2.500 ms\n", printfSpy_GetNthErrorOutput(4));
+    STRCMP_EQUAL("  Dump load                0.500 ms\n", printfSpy_GetNthErrorOutput(3));
+    STRCMP_EQUAL("  Total                   10.000 ms\n", printfSpy_GetNthErrorOutput(2));
+    STRCMP_EQUAL("MemorySim:\n"
+                 "  Region lookups               1\n"
+                 "  Region hits                  1\n"
+                 "  Region misses                0\n"
+                 "  Bytes copied                 4\n"
+                 "  Lazy region loads            0\n"
+                 "  Watchpoint checks            0\n", printfSpy_GetLastErrorOutput());
+}
+
+TEST(CrashDebugStats, WithNoPacketsReceived_ShouldSkipFirstPacketTimeAndPacketRows)
+{
+    CrashDebugStats_Print(&m_commandLine, &m_rspStats);
+
+    CHECK_EQUAL(6, printfSpy_GetCallCount());
+    STRCMP_EQUAL("  Total                   10.000 ms\n", printfSpy_GetNthErrorOutput(3));
+    STRCMP_EQUAL("GDB packets:\n"
+                 "  Type        Count     Bytes In    Bytes Out  Response ms\n", printfSpy_GetLastErrorOutput());
+}
+
+TEST(CrashDebugStats, WithPacketReceived_ShouldPrintFirstPacketTime)
+{
+    m_rspStats.hasReceivedPacket = 1;
+    m_rspStats.firstPacketMicroseconds = 1250;
+
+    CrashDebugStats_Print(&m_commandLine, &m_rspStats);
+
+    CHECK_EQUAL(7, printfSpy_GetCallCount());
+    STRCMP_EQUAL("  First GDB packet         1.250 ms\n", printfSpy_GetNthErrorOutput(4));
+}
+
+TEST(CrashDebugStats, WithPackets_ShouldPrintRowForEachActivePacketType)
+{
+    m_rspStats.packets[0x03].bytesIn = 1;
+    m_rspStats.packets['+'].bytesIn = 2;
+    m_rspStats.packets['m'].packetCount = 2;
+    m_rspStats.packets['m'].bytesIn = 16;
+    m_rspStats.packets['m'].bytesOut = 26;
+    m_rspStats.packets['m'].responseMicroseconds = 75;
+
+    CrashDebugStats_Print(&m_commandLine, &m_rspStats);
+
+    CHECK_EQUAL(9, printfSpy_GetCallCount());
+    STRCMP_EQUAL("  0x03            0            1            0        0.000\n", printfSpy_GetNthErrorOutput(3));
+    STRCMP_EQUAL("  +               0            2            0        0.000\n", printfSpy_GetPreviousErrorOutput());
+    STRCMP_EQUAL("  m               2           16           26        0.075\n", printfSpy_GetLastErrorOutput());
+}
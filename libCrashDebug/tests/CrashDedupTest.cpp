@@ -0,0 +1,494 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <dirent.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrashDedup.h>
+    #include <MemorySim.h>
+    #include <printfSpy.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define FLASH_BASE  0x00000000
+#define RAM_BASE    0x10000000
+#define CFSR        0xE000ED28
+
+// Return addresses just past a BL and a BLX placed in FLASH by setup().
+#define BL_RETURN   0x00000105
+#define BLX_RETURN  0x00000205
+
+
+static const char* g_dumpDirectory = "CrashDedupTest.dir";
+static const char* g_logFilename = "CrashDedupTest.log";
+
+
+TEST_GROUP(CrashDedup)
+{
+    IMemory*    m_pFlash;
+    CrashDedup  m_dedup;
+    uint8_t     m_flash[0x400];
+    uint8_t     m_dump[256];
+    size_t      m_dumpSize;
+    std::string m_log;
+
+    void setup()
+    {
+        memset(m_flash, 0x00, sizeof(m_flash));
+        // bl <label>
+        setHalfWord(0x100, 0xF000);
+        setHalfWord(0x102, 0xF800);
+        // nop; blx r3
+        setHalfWord(0x200, 0xBF00);
+        setHalfWord(0x202, 0x4798);
+
+        m_pFlash = MemorySim_Create();
+        MemorySim_CreateRegionFromHostBuffer(m_pFlash, FLASH_BASE, m_flash, sizeof(m_flash));
+        MemorySim_MakeRegionReadOnly(m_pFlash, FLASH_BASE);
+
+        memset(&m_dedup, 0, sizeof(m_dedup));
+        removeDumpDirectory();
+        mkdir(g_dumpDirectory, 0777);
+        printfSpy_Hook(128);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        printfSpy_Unhook();
+        CrashDedup_Uninit(&m_dedup);
+        MemorySim_Destroy(m_pFlash);
+        removeDumpDirectory();
+        remove(g_logFilename);
+    }
+
+    void setHalfWord(uint32_t address, uint16_t value)
+    {
+        m_flash[address] = value & 0xFF;
+        m_flash[address + 1] = value >> 8;
+    }
+
+    void removeDumpDirectory()
+    {
+        DIR*           pDir = opendir(g_dumpDirectory);
+        struct dirent* pEntry;
+
+        if (!pDir)
+            return;
+        while ((pEntry = readdir(pDir)) != NULL)
+        {
+            char path[256];
+            if (0 == strcmp(pEntry->d_name, ".") || 0 == strcmp(pEntry->d_name, ".."))
+                continue;
+            snprintf(path, sizeof(path), "%s/%s", g_dumpDirectory, pEntry->d_name);
+            if (0 != remove(path))
+                rmdir(path);
+        }
+        closedir(pDir);
+        rmdir(g_dumpDirectory);
+    }
+
+    void startDump(uint32_t pc, uint32_t lr, uint32_t exceptionNumber)
+    {
+        static const uint8_t signature[4] = { 0x63, 0x43, 0x03, 0x00 };
+        uint32_t             registers[TOTAL_REG_COUNT];
+
+        memset(registers, 0, sizeof(registers));
+        registers[SP] = RAM_BASE;
+        registers[LR] = lr;
+        registers[PC] = pc;
+        m_dumpSize = 0;
+        appendBytes(signature, sizeof(signature));
+        appendWord(0);
+        for (size_t i = 0 ; i < ARRAY_SIZE(registers) ; i++)
+            appendWord(registers[i]);
+        appendWord(exceptionNumber);
+    }
+
+    void appendRegion(uint32_t startAddress, const uint32_t* pWords, size_t wordCount)
+    {
+        appendWord(startAddress);
+        appendWord(startAddress + wordCount * sizeof(uint32_t));
+        for (size_t i = 0 ; i < wordCount ; i++)
+            appendWord(pWords[i]);
+    }
+
+    void appendWord(uint32_t word)
+    {
+        uint8_t bytes[4] = { (uint8_t)word, (uint8_t)(word >> 8), (uint8_t)(word >> 16), (uint8_t)(word >> 24) };
+        appendBytes(bytes, sizeof(bytes));
+    }
+
+    void appendBytes(const void* pBytes, size_t byteCount)
+    {
+        CHECK(m_dumpSize + byteCount <= sizeof(m_dump));
+        memcpy(&m_dump[m_dumpSize], pBytes, byteCount);
+        m_dumpSize += byteCount;
+    }
+
+    void writeDump(const char* pName)
+    {
+        char  path[256];
+        FILE* pFile;
+
+        snprintf(path, sizeof(path), "%s/%s", g_dumpDirectory, pName);
+        pFile = fopen(path, "wb");
+        fwrite(m_dump, 1, m_dumpSize, pFile);
+        fclose(pFile);
+    }
+
+    void writeCrashDump(const char* pName, uint32_t pc, uint32_t returnAddress, uint32_t cfsr)
+    {
+        uint32_t stack[2] = { 0x12345678, returnAddress };
+        uint32_t faultStatus[2] = { cfsr, 0x40000000 };
+
+        startDump(pc, 0xFFFFFFF9, 3);
+        appendRegion(RAM_BASE, stack, ARRAY_SIZE(stack));
+        appendRegion(CFSR, faultStatus, ARRAY_SIZE(faultStatus));
+        writeDump(pName);
+    }
+
+    void writeTestDumps()
+    {
+        writeCrashDump("d.dmp", 0x00000381, BLX_RETURN, 0x00000100);
+        writeCrashDump("c.dmp", 0x00000301, BL_RETURN, 0x00008200);
+        writeCrashDump("a.dmp", 0x00000301, BL_RETURN, 0x00000200);
+        writeCrashDump("b.dmp", 0x00000381, BLX_RETURN, 0x00000100);
+        writeCrashDump("e.dmp", 0x00000301, BL_RETURN, 0x00000200);
+
+        m_dumpSize = 0;
+        appendWord(0x00034363);
+        writeDump("truncated.dmp");
+    }
+
+    void buildCrashDump(uint32_t pc, uint32_t returnAddress, uint32_t cfsr)
+    {
+        uint32_t stack[2] = { 0x12345678, returnAddress };
+        uint32_t faultStatus[2] = { cfsr, 0x40000000 };
+
+        startDump(pc, 0xFFFFFFF9, 3);
+        appendRegion(RAM_BASE, stack, ARRAY_SIZE(stack));
+        appendRegion(CFSR, faultStatus, ARRAY_SIZE(faultStatus));
+    }
+
+    void appendDumpToLog(size_t byteCount, const char* pTrailer)
+    {
+        static const char nibbleToHex[] = "0123456789ABCDEF";
+
+        m_log += "\r\nCRASH ENCOUNTERED\r\nEnable logging and then press any key to start dump.\r\n\r\n";
+        for (size_t i = 0 ; i < byteCount ; i++)
+        {
+            m_log += nibbleToHex[m_dump[i] >> 4];
+            m_log += nibbleToHex[m_dump[i] & 0xF];
+            if (i % 16 == 15 || i == byteCount - 1)
+                m_log += "\r\n";
+        }
+        m_log += pTrailer;
+    }
+
+    void writeLog()
+    {
+        FILE* pFile = fopen(g_logFilename, "wb");
+        fwrite(m_log.c_str(), 1, m_log.length(), pFile);
+        fclose(pFile);
+    }
+
+    unsigned long lineNumberOfDump(size_t dumpIndex)
+    {
+        size_t        offset = 0;
+        unsigned long lineNumber = 1;
+
+        for (size_t i = 0 ; i <= dumpIndex ; i++)
+            offset = m_log.find("63430300", offset + 1);
+        for (size_t i = 0 ; i < offset ; i++)
+        {
+            if (m_log[i] == '\n')
+                lineNumber++;
+        }
+        return lineNumber;
+    }
+
+    void writeTestLog()
+    {
+        // Application output and an interrupted dump surround three complete dumps, two of which share a signature.
+        m_log = "Booting...\r\n";
+        buildCrashDump(0x00000301, BL_RETURN, 0x00000200);
+        appendDumpToLog(m_dumpSize, "\r\nEnd of dump\r\n");
+        m_log += "Booting...\r\n";
+        buildCrashDump(0x00000381, BLX_RETURN, 0x00000100);
+        appendDumpToLog(m_dumpSize / 2, "");
+        appendDumpToLog(m_dumpSize, "\r\nEnd of dump\r\n");
+        m_log += "Booting...\r\napp: ok\r\n";
+        buildCrashDump(0x00000301, BL_RETURN, 0x00008200);
+        appendDumpToLog(m_dumpSize, "\r\nEnd of dump\r\n");
+        m_log += "Booting...\r\n";
+        writeLog();
+    }
+
+    void validateTestLogResults()
+    {
+        char expected[64];
+
+        CHECK_EQUAL(3, m_dedup.entryCount);
+        CHECK_TRUE(m_dedup.pEntries[0].signature.hash == m_dedup.pEntries[1].signature.hash);
+        CHECK_FALSE(m_dedup.pEntries[0].signature.hash == m_dedup.pEntries[2].signature.hash);
+        for (size_t i = 0 ; i < m_dedup.entryCount ; i++)
+            CHECK_EQUAL(noException, m_dedup.pEntries[i].exceptionCode);
+        CHECK_EQUAL(lineNumberOfDump(0), m_dedup.pEntries[0].lineNumber);
+        CHECK_EQUAL(lineNumberOfDump(3), m_dedup.pEntries[1].lineNumber);
+        CHECK_EQUAL(lineNumberOfDump(2), m_dedup.pEntries[2].lineNumber);
+        snprintf(expected, sizeof(expected), "%s:%lu", g_logFilename, lineNumberOfDump(0));
+        STRCMP_EQUAL(expected, m_dedup.pEntries[0].pFilename);
+        CHECK_EQUAL(BLX_RETURN & ~1, m_dedup.pEntries[2].signature.frames[0]);
+    }
+
+    const char* filename(size_t index)
+    {
+        const char* pFilename = m_dedup.pEntries[index].pFilename;
+        return pFilename + strlen(g_dumpDirectory) + 1;
+    }
+
+    void validateTestDumpResults()
+    {
+        CHECK_EQUAL(6, m_dedup.entryCount);
+        // a, c and e are the same crash since the CFSR BFARVALID bit doesn't participate in the signature.
+        CHECK_TRUE(m_dedup.pEntries[0].signature.hash == m_dedup.pEntries[1].signature.hash ||
+                   m_dedup.pEntries[0].signature.hash == m_dedup.pEntries[2].signature.hash);
+        CHECK_EQUAL(noException, m_dedup.pEntries[0].exceptionCode);
+        CHECK_EQUAL(noException, m_dedup.pEntries[4].exceptionCode);
+        STRCMP_EQUAL("truncated.dmp", filename(5));
+        CHECK_EQUAL(fileFormatException, m_dedup.pEntries[5].exceptionCode);
+        STRCMP_EQUAL("The dump file was too short to contain the flags.", m_dedup.pEntries[5].exceptionMessage);
+
+        const CrashDedupEntry* pA = findEntry("a.dmp");
+        const CrashDedupEntry* pB = findEntry("b.dmp");
+        const CrashDedupEntry* pC = findEntry("c.dmp");
+        const CrashDedupEntry* pD = findEntry("d.dmp");
+        const CrashDedupEntry* pE = findEntry("e.dmp");
+        CHECK_TRUE(pA->signature.hash == pC->signature.hash);
+        CHECK_TRUE(pA->signature.hash == pE->signature.hash);
+        CHECK_TRUE(pB->signature.hash == pD->signature.hash);
+        CHECK_FALSE(pA->signature.hash == pB->signature.hash);
+        CHECK_EQUAL(3, pA->signature.faultStatus.exceptionNumber);
+        CHECK_EQUAL(0x40000000, pA->signature.faultStatus.hardFaultStatus);
+        CHECK_EQUAL(0x00000300, pA->signature.pc);
+        CHECK_EQUAL(1, pA->signature.frameCount);
+        CHECK_EQUAL(BL_RETURN & ~1, pA->signature.frames[0]);
+        CHECK_EQUAL(BLX_RETURN & ~1, pB->signature.frames[0]);
+    }
+
+    const CrashDedupEntry* findEntry(const char* pName)
+    {
+        for (size_t i = 0 ; i < m_dedup.entryCount ; i++)
+        {
+            if (0 == strcmp(filename(i), pName))
+                return &m_dedup.pEntries[i];
+        }
+        FAIL("Entry not found.");
+        return NULL;
+    }
+};
+
+TEST(CrashDedup, Uninit_ShouldHandleNULLPointer)
+{
+    CrashDedup_Uninit(NULL);
+}
+
+TEST(CrashDedup, InvalidDirectory_ShouldThrow)
+{
+    memset(&m_dedup, 0xff, sizeof(m_dedup));
+    __try_and_catch( CrashDedup_Init(&m_dedup, m_pFlash, "invalidDirectory", 1) );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    STRCMP_EQUAL("Failed to open \"invalidDirectory\" directory.", getExceptionMessage());
+    clearExceptionCode();
+    CHECK_EQUAL(0, m_dedup.entryCount);
+    POINTERS_EQUAL(NULL, m_dedup.pEntries);
+}
+
+TEST(CrashDedup, EmptyDirectory_ShouldReportNoSignatures)
+{
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 1);
+    CHECK_EQUAL(0, m_dedup.entryCount);
+    CrashDedup_PrintReport(&m_dedup);
+    STRCMP_EQUAL("Found 0 unique crash signature(s) in 0 dump(s).\n", printfSpy_GetLastOutput());
+}
+
+TEST(CrashDedup, HiddenFilesAndSubdirectories_ShouldBeSkipped)
+{
+    char path[256];
+
+    writeCrashDump(".hidden.dmp", 0x00000301, BL_RETURN, 0);
+    snprintf(path, sizeof(path), "%s/subdir", g_dumpDirectory);
+    mkdir(path, 0777);
+    writeCrashDump("a.dmp", 0x00000301, BL_RETURN, 0);
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 1);
+    CHECK_EQUAL(1, m_dedup.entryCount);
+    STRCMP_EQUAL("a.dmp", filename(0));
+}
+
+TEST(CrashDedup, SingleJob_ShouldGroupMatchingDumpsAndPlaceFailuresLast)
+{
+    writeTestDumps();
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 1);
+    validateTestDumpResults();
+}
+
+TEST(CrashDedup, MultipleJobs_ShouldMatchSingleJobResults)
+{
+    writeTestDumps();
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 4);
+    validateTestDumpResults();
+}
+
+TEST(CrashDedup, DefaultJobCount_ShouldMatchSingleJobResults)
+{
+    writeTestDumps();
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 0);
+    validateTestDumpResults();
+}
+
+TEST(CrashDedup, DumpsShouldNotModifySharedFlash)
+{
+    uint32_t flashOverwrite[1] = { 0xFFFFFFFF };
+
+    startDump(0x00000301, 0xFFFFFFF9, 3);
+    appendRegion(0x00000100, flashOverwrite, ARRAY_SIZE(flashOverwrite));
+    writeDump("a.dmp");
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 1);
+    CHECK_EQUAL(1, m_dedup.entryCount);
+    CHECK_EQUAL(0xF800F000, IMemory_Read32(m_pFlash, 0x00000100));
+}
+
+TEST(CrashDedup, InvalidLogFilename_ShouldThrow)
+{
+    __try_and_catch( CrashDedup_InitFromLog(&m_dedup, m_pFlash, "invalid.log", NULL, 1) );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    CHECK_EQUAL(0, m_dedup.entryCount);
+    POINTERS_EQUAL(NULL, m_dedup.pEntries);
+}
+
+TEST(CrashDedup, LogWithoutDumps_ShouldReportNoSignatures)
+{
+    m_log = "Booting...\r\napp: ok\r\n";
+    writeLog();
+    CrashDedup_InitFromLog(&m_dedup, m_pFlash, g_logFilename, NULL, 1);
+    CHECK_EQUAL(0, m_dedup.entryCount);
+}
+
+TEST(CrashDedup, LogSingleJob_ShouldFindEachCompleteDumpAndGroupThem)
+{
+    writeTestLog();
+    CrashDedup_InitFromLog(&m_dedup, m_pFlash, g_logFilename, NULL, 1);
+    validateTestLogResults();
+}
+
+TEST(CrashDedup, LogMultipleJobs_ShouldMatchSingleJobResults)
+{
+    writeTestLog();
+    CrashDedup_InitFromLog(&m_dedup, m_pFlash, g_logFilename, NULL, 4);
+    validateTestLogResults();
+}
+
+TEST(CrashDedup, InitWithLogFilenameInsteadOfDirectory_ShouldTreatItAsLog)
+{
+    writeTestLog();
+    CrashDedup_Init(&m_dedup, m_pFlash, g_logFilename, 2);
+    validateTestLogResults();
+}
+
+TEST(CrashDedup, LogWithSplitDirectory_ShouldWriteEachDumpAsBinary)
+{
+    char    path[256];
+    uint8_t buffer[sizeof(m_dump)];
+    FILE*   pFile;
+
+    writeTestLog();
+    CrashDedup_InitFromLog(&m_dedup, m_pFlash, g_logFilename, g_dumpDirectory, 2);
+    validateTestLogResults();
+
+    // The last dump built by writeTestLog() should match the last dump in the log.
+    snprintf(path, sizeof(path), "%s/crash-%lu.dmp", g_dumpDirectory, lineNumberOfDump(3));
+    pFile = fopen(path, "rb");
+    CHECK(pFile != NULL);
+    CHECK_EQUAL(m_dumpSize, fread(buffer, 1, sizeof(buffer), pFile));
+    fclose(pFile);
+    MEMCMP_EQUAL(m_dump, buffer, m_dumpSize);
+    snprintf(path, sizeof(path), "%s/crash-%lu.dmp", g_dumpDirectory, lineNumberOfDump(0));
+    CHECK_EQUAL(0, access(path, F_OK));
+    snprintf(path, sizeof(path), "%s/crash-%lu.dmp", g_dumpDirectory, lineNumberOfDump(2));
+    CHECK_EQUAL(0, access(path, F_OK));
+}
+
+TEST(CrashDedup, LogWithInvalidSplitDirectory_ShouldFailEachDump)
+{
+    char expected[64];
+
+    writeTestLog();
+    CrashDedup_InitFromLog(&m_dedup, m_pFlash, g_logFilename, "invalidDirectory", 1);
+    CHECK_EQUAL(3, m_dedup.entryCount);
+    CHECK_EQUAL(fileException, m_dedup.pEntries[0].exceptionCode);
+    snprintf(expected, sizeof(expected), "Failed to create \"invalidDirectory/crash-%lu.dmp\".", lineNumberOfDump(0));
+    STRCMP_EQUAL(expected, m_dedup.pEntries[0].exceptionMessage);
+}
+
+TEST(CrashDedup, PrintReport_SingleDumpWithoutStack_ShouldListSignatureFaultPCAndFilename)
+{
+    uint32_t faultStatus[2] = { 0x00000100, 0x00000000 };
+    char     expected[64];
+
+    startDump(0x00000301, 0xFFFFFFF9, 4);
+    appendRegion(CFSR, faultStatus, ARRAY_SIZE(faultStatus));
+    writeDump("a.dmp");
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 1);
+    CrashDedup_PrintReport(&m_dedup);
+
+    const CrashSignature* pSignature = &m_dedup.pEntries[0].signature;
+    CHECK_EQUAL(5, printfSpy_GetCallCount());
+    snprintf(expected, sizeof(expected), "\nSignature %08lx%08lx: 1 dump(s)\n",
+             (unsigned long)(pSignature->hash >> 32), (unsigned long)(pSignature->hash & 0xFFFFFFFF));
+    STRCMP_EQUAL(expected, printfSpy_GetNthOutput(4));
+    STRCMP_EQUAL("  Fault: MemManage  HFSR: 0x00000000  CFSR: 0x00000100\n", printfSpy_GetNthOutput(3));
+    STRCMP_EQUAL("  PC: 0x00000300\n", printfSpy_GetNthOutput(2));
+    snprintf(expected, sizeof(expected), "    %s/a.dmp\n", g_dumpDirectory);
+    STRCMP_EQUAL(expected, printfSpy_GetNthOutput(1));
+}
+
+TEST(CrashDedup, PrintReport_ShouldListMostFrequentSignatureFirstAndThenFailures)
+{
+    char expected[128];
+
+    writeTestDumps();
+    CrashDedup_Init(&m_dedup, m_pFlash, g_dumpDirectory, 2);
+    CrashDedup_PrintReport(&m_dedup);
+
+    // 1 summary + (header + fault + PC + 1 frame + 3 files) + (header + fault + PC + 1 frame + 2 files) + 2 failure lines
+    CHECK_EQUAL(16, printfSpy_GetCallCount());
+    snprintf(expected, sizeof(expected), "    %s/b.dmp\n", g_dumpDirectory);
+    STRCMP_EQUAL(expected, printfSpy_GetNthOutput(4));
+    snprintf(expected, sizeof(expected), "    %s/d.dmp\n", g_dumpDirectory);
+    STRCMP_EQUAL(expected, printfSpy_GetNthOutput(3));
+    STRCMP_EQUAL("\nFailed to load 1 dump(s):\n", printfSpy_GetNthOutput(2));
+    snprintf(expected, sizeof(expected), "    %s/truncated.dmp: The dump file was too short to contain the flags.\n",
+             g_dumpDirectory);
+    STRCMP_EQUAL(expected, printfSpy_GetNthOutput(1));
+}
@@ -0,0 +1,146 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <string>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrashLog.h>
+    #include <MallocFailureInject.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+static const char* g_logFilename = "CrashLogTest.log";
+
+
+TEST_GROUP(CrashLog)
+{
+    CrashLog     m_log;
+    CrashCapture m_capture;
+    std::string  m_text;
+
+    void setup()
+    {
+        memset(&m_log, 0, sizeof(m_log));
+        CrashCapture_Init(&m_capture);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        CrashCapture_Uninit(&m_capture);
+        CrashLog_Close(&m_log);
+        MallocFailureInject_Restore();
+        clearExceptionCode();
+        remove(g_logFilename);
+    }
+
+    void openLog(const std::string& text)
+    {
+        FILE* pFile = fopen(g_logFilename, "wb");
+
+        m_text = text;
+        fwrite(text.c_str(), 1, text.length(), pFile);
+        fclose(pFile);
+        CrashLog_Open(&m_log, g_logFilename);
+    }
+
+    void validateDump(size_t index, const char* pExpectedText, unsigned long expectedLineNumber)
+    {
+        CHECK_TRUE(index < m_log.dumpCount);
+        std::string dumpText = m_text.substr(m_log.pDumps[index].offset, m_log.pDumps[index].size);
+        STRCMP_EQUAL(pExpectedText, dumpText.c_str());
+        CHECK_EQUAL(expectedLineNumber, m_log.pDumps[index].lineNumber);
+    }
+};
+
+
+TEST(CrashLog, Close_ShouldHandleNULLPointer)
+{
+    CrashLog_Close(NULL);
+}
+
+TEST(CrashLog, InvalidFilename_ShouldThrow)
+{
+    __try_and_catch( CrashLog_Open(&m_log, "invalid/file.log") );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(CrashLog, EmptyLog_ShouldFindNoDumps)
+{
+    openLog("");
+    CHECK_EQUAL(0, m_log.dumpCount);
+}
+
+TEST(CrashLog, LogWithoutDumps_ShouldFindNoDumps)
+{
+    openLog("Booting...\r\nDEADBEEF\r\nEnd of dump\r\n");
+    CHECK_EQUAL(0, m_log.dumpCount);
+}
+
+TEST(CrashLog, SingleDump_ShouldIndexFromSignatureThroughEndLine)
+{
+    openLog("Booting...\r\nCRASH ENCOUNTERED\r\n\r\n63430300\r\n01020304\r\n\r\nEnd of dump\r\nBooting...\r\n");
+    CHECK_EQUAL(1, m_log.dumpCount);
+    validateDump(0, "63430300\r\n01020304\r\n\r\nEnd of dump\r\n", 4);
+}
+
+TEST(CrashLog, LastLineWithoutNewLine_ShouldStillBeIndexed)
+{
+    openLog("63430300\nEnd of dump");
+    CHECK_EQUAL(1, m_log.dumpCount);
+    validateDump(0, "63430300\nEnd of dump", 1);
+}
+
+TEST(CrashLog, MultipleDumps_ShouldSkipInterruptedAndUnfinishedOnes)
+{
+    openLog("63430300\n"
+            "Booting...\n"
+            "63430300\n"
+            "AABB\n"
+            "End of dump\n"
+            "app: ok\n"
+            "63430300\n"
+            "CCDD\n"
+            "End of dump\n"
+            "63430300\n"
+            "EEFF\n");
+    CHECK_EQUAL(2, m_log.dumpCount);
+    validateDump(0, "63430300\nAABB\nEnd of dump\n", 3);
+    validateDump(1, "63430300\nCCDD\nEnd of dump\n", 7);
+}
+
+TEST(CrashLog, DecodeDump_ShouldReturnDumpBytes)
+{
+    static const uint8_t expected[] = { 0x63, 0x43, 0x03, 0x00, 0xAA, 0xBB };
+
+    openLog("junk\n63430300\nAABB\nEnd of dump\n");
+    CrashLog_DecodeDump(&m_log, 0, &m_capture);
+    CHECK_EQUAL(sizeof(expected), m_capture.dumpSize);
+    MEMCMP_EQUAL(expected, m_capture.pDump, sizeof(expected));
+}
+
+TEST(CrashLog, FailAllocationOfDumpIndex_ShouldThrowAndCloseLog)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( openLog("63430300\nEnd of dump\n") );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+    POINTERS_EQUAL(NULL, m_log.mapping.pData);
+}
@@ -0,0 +1,251 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrashSignature.h>
+    #include <MemorySim.h>
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define FLASH_BASE  0x00000000
+#define RAM_BASE    0x10000000
+#define RAM_SIZE    0x1000
+#define SCB_BASE    0xE000ED00
+#define CFSR        0xE000ED28
+#define HFSR        0xE000ED2C
+
+// Return addresses just past a BL, a BLX and a non-branch instruction placed in FLASH by setup().
+#define BL_RETURN       0x00000105
+#define BLX_RETURN      0x00000205
+#define NOT_A_RETURN    0x00000305
+
+
+TEST_GROUP(CrashSignature)
+{
+    IMemory*        m_pMemory;
+    RegisterContext m_context;
+    CrashSignature  m_signature;
+    uint8_t         m_flash[0x400];
+
+    void setup()
+    {
+        memset(m_flash, 0x00, sizeof(m_flash));
+        // bl <label>
+        setHalfWord(0x100, 0xF000);
+        setHalfWord(0x102, 0xF800);
+        // nop; blx r3
+        setHalfWord(0x200, 0xBF00);
+        setHalfWord(0x202, 0x4798);
+        // nop; nop
+        setHalfWord(0x300, 0xBF00);
+        setHalfWord(0x302, 0xBF00);
+
+        m_pMemory = MemorySim_Create();
+        MemorySim_CreateRegionFromHostBuffer(m_pMemory, FLASH_BASE, m_flash, sizeof(m_flash));
+        MemorySim_MakeRegionReadOnly(m_pMemory, FLASH_BASE);
+        MemorySim_CreateRegion(m_pMemory, RAM_BASE, RAM_SIZE);
+
+        memset(&m_context, 0, sizeof(m_context));
+        m_context.R[SP] = RAM_BASE;
+        m_context.R[PC] = 0x00000381;
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MemorySim_Destroy(m_pMemory);
+    }
+
+    void setHalfWord(uint32_t address, uint16_t value)
+    {
+        m_flash[address] = value & 0xFF;
+        m_flash[address + 1] = value >> 8;
+    }
+
+    void pushStackWords(const uint32_t* pWords, size_t wordCount)
+    {
+        for (size_t i = 0 ; i < wordCount ; i++)
+            IMemory_Write32(m_pMemory, m_context.R[SP] + i * sizeof(uint32_t), pWords[i]);
+    }
+
+    void createFaultStatusRegisters(uint32_t hfsr, uint32_t cfsr)
+    {
+        MemorySim_CreateRegion(m_pMemory, SCB_BASE, 0x100);
+        IMemory_Write32(m_pMemory, HFSR, hfsr);
+        IMemory_Write32(m_pMemory, CFSR, cfsr);
+    }
+
+    void calculate()
+    {
+        m_signature = CrashSignature_Calculate(m_pMemory, &m_context);
+    }
+};
+
+TEST(CrashSignature, NoFaultStatusRegistersAndEmptyStack_ShouldOnlyContainPC)
+{
+    calculate();
+    CHECK_EQUAL(0x00000380, m_signature.pc);
+    CHECK_EQUAL(0, m_signature.frameCount);
+    CHECK_EQUAL(0, m_signature.faultStatus.exceptionNumber);
+    CHECK_EQUAL(0, m_signature.faultStatus.hardFaultStatus);
+    CHECK_EQUAL(0, m_signature.faultStatus.configurableFaultStatus);
+}
+
+TEST(CrashSignature, FaultStatusRegisters_ShouldBeCaptured)
+{
+    m_context.exceptionPSR = 3;
+    createFaultStatusRegisters(0x40000000, 0x00008200);
+    calculate();
+    CHECK_EQUAL(3, m_signature.faultStatus.exceptionNumber);
+    CHECK_EQUAL(0x40000000, m_signature.faultStatus.hardFaultStatus);
+    CHECK_EQUAL(0x00008200, m_signature.faultStatus.configurableFaultStatus);
+}
+
+TEST(CrashSignature, LRIsReturnAddress_ShouldBeFirstFrame)
+{
+    m_context.R[LR] = BL_RETURN;
+    calculate();
+    CHECK_EQUAL(1, m_signature.frameCount);
+    CHECK_EQUAL(BL_RETURN & ~1, m_signature.frames[0]);
+}
+
+TEST(CrashSignature, LRWithoutThumbBitOrEXC_RETURN_ShouldBeIgnored)
+{
+    m_context.R[LR] = BL_RETURN & ~1;
+    calculate();
+    CHECK_EQUAL(0, m_signature.frameCount);
+
+    m_context.R[LR] = 0xFFFFFFF9;
+    calculate();
+    CHECK_EQUAL(0, m_signature.frameCount);
+}
+
+TEST(CrashSignature, StackScan_ShouldOnlyKeepAddressesFollowingBLAndBLXInOrder)
+{
+    static const uint32_t stack[] = { 0x12345678, BLX_RETURN, NOT_A_RETURN, RAM_BASE + 1, BL_RETURN };
+    pushStackWords(stack, ARRAY_SIZE(stack));
+    calculate();
+    CHECK_EQUAL(2, m_signature.frameCount);
+    CHECK_EQUAL(BLX_RETURN & ~1, m_signature.frames[0]);
+    CHECK_EQUAL(BL_RETURN & ~1, m_signature.frames[1]);
+}
+
+TEST(CrashSignature, StackScan_ReturnAddressInRAMPrecededByBL_ShouldBeIgnored)
+{
+    uint32_t stack[] = { RAM_BASE + 0x105 };
+    IMemory_Write16(m_pMemory, RAM_BASE + 0x100, 0xF000);
+    IMemory_Write16(m_pMemory, RAM_BASE + 0x102, 0xF800);
+    m_context.R[SP] = RAM_BASE + 0x200;
+    pushStackWords(stack, ARRAY_SIZE(stack));
+    calculate();
+    CHECK_EQUAL(0, m_signature.frameCount);
+}
+
+TEST(CrashSignature, LRAlsoPushedToStack_ShouldOnlyAppearOnce)
+{
+    static const uint32_t stack[] = { BL_RETURN, BLX_RETURN };
+    m_context.R[LR] = BL_RETURN;
+    pushStackWords(stack, ARRAY_SIZE(stack));
+    calculate();
+    CHECK_EQUAL(2, m_signature.frameCount);
+    CHECK_EQUAL(BL_RETURN & ~1, m_signature.frames[0]);
+    CHECK_EQUAL(BLX_RETURN & ~1, m_signature.frames[1]);
+}
+
+TEST(CrashSignature, MoreReturnAddressesThanMaxFrames_ShouldTruncate)
+{
+    uint32_t stack[CRASH_SIGNATURE_MAX_FRAMES * 2 + 1];
+    for (size_t i = 0 ; i < ARRAY_SIZE(stack) ; i++)
+        stack[i] = (i & 1) ? BLX_RETURN : BL_RETURN;
+    pushStackWords(stack, ARRAY_SIZE(stack));
+    calculate();
+    CHECK_EQUAL(CRASH_SIGNATURE_MAX_FRAMES, m_signature.frameCount);
+    CHECK_EQUAL(BL_RETURN & ~1, m_signature.frames[0]);
+    CHECK_EQUAL(BLX_RETURN & ~1, m_signature.frames[CRASH_SIGNATURE_MAX_FRAMES - 1]);
+}
+
+TEST(CrashSignature, StackScanRunsOffEndOfRAM_ShouldStopWithoutThrowing)
+{
+    uint32_t stack[] = { BL_RETURN };
+    m_context.R[SP] = RAM_BASE + RAM_SIZE - sizeof(uint32_t);
+    pushStackWords(stack, ARRAY_SIZE(stack));
+    calculate();
+    CHECK_EQUAL(1, m_signature.frameCount);
+}
+
+TEST(CrashSignature, InvalidSP_ShouldHaveNoFramesAndNotThrow)
+{
+    m_context.R[SP] = 0x20000000;
+    calculate();
+    CHECK_EQUAL(0, m_signature.frameCount);
+}
+
+TEST(CrashSignature, SameCrash_ShouldHaveSameHash)
+{
+    static const uint32_t stack[] = { BL_RETURN, BLX_RETURN };
+    pushStackWords(stack, ARRAY_SIZE(stack));
+    calculate();
+    CrashSignature first = m_signature;
+
+    m_context.R[R0] = 0x12345678;
+    calculate();
+    CHECK_TRUE(first.hash == m_signature.hash);
+}
+
+TEST(CrashSignature, KnownInput_ShouldHaveStableHash)
+{
+    calculate();
+    // FNV-1a 64-bit over 3 zero words for the fault status and 0x00000380 for the PC, in little endian byte order.
+    CHECK_TRUE(0x70CDAA8E37691FE4ULL == m_signature.hash);
+}
+
+TEST(CrashSignature, CFSRValidBits_ShouldNotChangeHash)
+{
+    createFaultStatusRegisters(0x40000000, 0x00000200);
+    calculate();
+    CrashSignature first = m_signature;
+
+    IMemory_Write32(m_pMemory, CFSR, 0x00008200);
+    calculate();
+    CHECK_TRUE(first.hash == m_signature.hash);
+    IMemory_Write32(m_pMemory, CFSR, 0x00000282);
+    calculate();
+    CHECK_FALSE(first.hash == m_signature.hash);
+}
+
+TEST(CrashSignature, DifferentPCExceptionOrFrames_ShouldChangeHash)
+{
+    calculate();
+    CrashSignature first = m_signature;
+
+    m_context.R[PC] = 0x00000391;
+    calculate();
+    CHECK_FALSE(first.hash == m_signature.hash);
+
+    m_context.R[PC] = first.pc;
+    m_context.exceptionPSR = 4;
+    calculate();
+    CHECK_FALSE(first.hash == m_signature.hash);
+
+    m_context.exceptionPSR = 0;
+    m_context.R[LR] = BL_RETURN;
+    calculate();
+    CHECK_FALSE(first.hash == m_signature.hash);
+}
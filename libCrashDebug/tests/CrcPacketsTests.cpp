@@ -0,0 +1,114 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrcPackets.h>
+    #include <MemorySim.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+TEST_GROUP(CrcPackets)
+{
+    IMemory* m_pMemory;
+    char     m_response[64];
+
+    void setup()
+    {
+        m_pMemory = MemorySim_Init();
+        memset(m_response, 0, sizeof(m_response));
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MemorySim_Uninit(m_pMemory);
+    }
+
+    int handle(const char* pRequest)
+    {
+        return CrcPackets_Handle(m_pMemory, pRequest, strlen(pRequest), m_response, sizeof(m_response));
+    }
+
+    void writeString(uint32_t address, const char* pString)
+    {
+        while (*pString)
+            IMemory_Write8(m_pMemory, address++, *pString++);
+    }
+};
+
+
+TEST(CrcPackets, OtherPackets_ShouldNotBeClaimed)
+{
+    CHECK_FALSE(handle("qCR"));
+    CHECK_FALSE(handle("qC"));
+    CHECK_FALSE(handle("m10000000,4"));
+}
+
+TEST(CrcPackets, SingleRegion_ShouldReturnGdbCrc)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    writeString(0x10000004, "123456789");
+    CHECK_TRUE(handle("qCRC:10000004,9"));
+    STRCMP_EQUAL("C0376e6e7", m_response);
+}
+
+TEST(CrcPackets, RangeSpanningAdjacentRegionsAndAlias_ShouldReturnCrcOfWholeRange)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+    MemorySim_CreateRegion(m_pMemory, 0x10000004, 4);
+    MemorySim_CreateRegion(m_pMemory, 0x20000000, 4);
+    MemorySim_CreateAlias(m_pMemory, 0x10000008, 0x20000000, 4);
+    writeString(0x10000000, "1234");
+    writeString(0x10000004, "5678");
+    writeString(0x20000000, "9");
+    CHECK_TRUE(handle("qCRC:10000000,9"));
+    STRCMP_EQUAL("C0376e6e7", m_response);
+}
+
+TEST(CrcPackets, ZeroLength_ShouldReturnInitialCrc)
+{
+    CHECK_TRUE(handle("qCRC:10000000,0"));
+    STRCMP_EQUAL("Cffffffff", m_response);
+}
+
+TEST(CrcPackets, UnmappedMemoryInRange_ShouldReturnError)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+    CHECK_TRUE(handle("qCRC:10000000,5"));
+    STRCMP_EQUAL("E02", m_response);
+}
+
+TEST(CrcPackets, RangeWrappingAddressSpace_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qCRC:ffffffff,2"));
+    STRCMP_EQUAL("E02", m_response);
+}
+
+TEST(CrcPackets, MissingLength_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qCRC:10000000"));
+    STRCMP_EQUAL("E01", m_response);
+}
+
+TEST(CrcPackets, BadHexLength_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qCRC:10000000,1z"));
+    STRCMP_EQUAL("E01", m_response);
+}
@@ -0,0 +1,248 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <DumpDiff.h>
+    #include <MallocFailureInject.h>
+    #include <MemorySim.h>
+    #include <mriPlatform.h>
+    #include <printfSpy.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define FLASH_BASE  0x00000000
+#define RAM_BASE    0x10000000
+
+
+static const char* g_dumpFilename = "DumpDiffTest.dmp";
+
+
+TEST_GROUP(DumpDiff)
+{
+    IMemory* m_pMemory1;
+    IMemory* m_pMemory2;
+    DumpDiff m_diff;
+    uint8_t  m_flash[0x100];
+
+    void setup()
+    {
+        memset(m_flash, 0xA5, sizeof(m_flash));
+        memset(&m_diff, 0, sizeof(m_diff));
+        m_pMemory1 = MemorySim_Create();
+        m_pMemory2 = MemorySim_Create();
+        printfSpy_Hook(128);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        printfSpy_Unhook();
+        DumpDiff_Uninit(&m_diff);
+        MemorySim_Destroy(m_pMemory1);
+        MemorySim_Destroy(m_pMemory2);
+        MallocFailureInject_Restore();
+        remove(g_dumpFilename);
+    }
+
+    void createRam(uint32_t baseAddress, uint32_t size)
+    {
+        MemorySim_CreateRegion(m_pMemory1, baseAddress, size);
+        MemorySim_CreateRegion(m_pMemory2, baseAddress, size);
+    }
+
+    void validateRange(size_t index, uint32_t expectedAddress, uint32_t expectedSize)
+    {
+        CHECK_TRUE(index < m_diff.rangeCount);
+        CHECK_EQUAL(expectedAddress, m_diff.pRanges[index].address);
+        CHECK_EQUAL(expectedSize, m_diff.pRanges[index].size);
+    }
+
+    void writeDumpFile(const uint32_t* pRam, size_t wordCount)
+    {
+        static const uint8_t signature[4] = { 0x63, 0x43, 0x03, 0x00 };
+        FILE*                pFile = fopen(g_dumpFilename, "wb");
+        uint32_t             word = 0;
+
+        fwrite(signature, 1, sizeof(signature), pFile);
+        fwrite(&word, 1, sizeof(word), pFile);
+        for (int i = 0 ; i < TOTAL_REG_COUNT ; i++)
+            fwrite(&word, 1, sizeof(word), pFile);
+        fwrite(&word, 1, sizeof(word), pFile);
+        word = RAM_BASE;
+        fwrite(&word, 1, sizeof(word), pFile);
+        word = RAM_BASE + wordCount * sizeof(uint32_t);
+        fwrite(&word, 1, sizeof(word), pFile);
+        fwrite(pRam, sizeof(*pRam), wordCount, pFile);
+        fclose(pFile);
+    }
+};
+
+
+TEST(DumpDiff, IdenticalDumps_ShouldHaveNoRanges)
+{
+    createRam(RAM_BASE, 256);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(0, m_diff.rangeCount);
+    CHECK_EQUAL(256, m_diff.bytesCompared);
+    CHECK_EQUAL(0, m_diff.bytesDiffering);
+}
+
+TEST(DumpDiff, SingleDifferingWord_ShouldReportItsBytes)
+{
+    createRam(RAM_BASE, 256);
+    IMemory_Write32(m_pMemory2, RAM_BASE + 0x80, 0x12345678);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(1, m_diff.rangeCount);
+    validateRange(0, RAM_BASE + 0x80, 4);
+    CHECK_EQUAL(4, m_diff.bytesDiffering);
+}
+
+TEST(DumpDiff, DifferencesSeparatedBySmallGap_ShouldBeCoalesced)
+{
+    createRam(RAM_BASE, 256);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 0x10, 0x01);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 0x10 + DUMP_DIFF_COALESCE_GAP, 0x01);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 0x40, 0x01);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 0x41 + DUMP_DIFF_COALESCE_GAP, 0x01);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(3, m_diff.rangeCount);
+    validateRange(0, RAM_BASE + 0x10, DUMP_DIFF_COALESCE_GAP + 1);
+    validateRange(1, RAM_BASE + 0x40, 1);
+    validateRange(2, RAM_BASE + 0x41 + DUMP_DIFF_COALESCE_GAP, 1);
+    CHECK_EQUAL(4, m_diff.bytesDiffering);
+}
+
+TEST(DumpDiff, DifferenceCrossingBlockBoundary_ShouldBeSingleRange)
+{
+    createRam(RAM_BASE, 256);
+    IMemory_Write32(m_pMemory2, RAM_BASE + 62, 0xFFFFFFFF);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(1, m_diff.rangeCount);
+    validateRange(0, RAM_BASE + 62, 4);
+}
+
+TEST(DumpDiff, RegionsCreatedOutOfOrder_ShouldReportRangesSortedByAddress)
+{
+    createRam(RAM_BASE + 0x100, 16);
+    createRam(RAM_BASE, 16);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 0x100, 0x01);
+    IMemory_Write8(m_pMemory2, RAM_BASE, 0x01);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(2, m_diff.rangeCount);
+    validateRange(0, RAM_BASE, 1);
+    validateRange(1, RAM_BASE + 0x100, 1);
+}
+
+TEST(DumpDiff, PartiallyOverlappingRegions_ShouldOnlyCompareOverlap)
+{
+    MemorySim_CreateRegion(m_pMemory1, RAM_BASE, 32);
+    MemorySim_CreateRegion(m_pMemory2, RAM_BASE + 8, 8);
+    MemorySim_CreateRegion(m_pMemory2, RAM_BASE + 16, 32);
+    IMemory_Write8(m_pMemory1, RAM_BASE, 0x01);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 16, 0x01);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(24, m_diff.bytesCompared);
+    CHECK_EQUAL(1, m_diff.rangeCount);
+    validateRange(0, RAM_BASE + 16, 1);
+}
+
+TEST(DumpDiff, LargeUnmappedGapInSecondDump_ShouldSkipToNextMappedAddress)
+{
+    MemorySim_CreateRegion(m_pMemory1, RAM_BASE, 0x100000);
+    MemorySim_CreateRegion(m_pMemory2, RAM_BASE + 0xFFFF0, 8);
+    MemorySim_CreateRegion(m_pMemory2, RAM_BASE + 0x200000, 8);
+    IMemory_Write8(m_pMemory2, RAM_BASE + 0xFFFF4, 0x01);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(8, m_diff.bytesCompared);
+    CHECK_EQUAL(1, m_diff.rangeCount);
+    validateRange(0, RAM_BASE + 0xFFFF4, 1);
+}
+
+TEST(DumpDiff, NothingMappedAboveInSecondDump_ShouldStopComparingRegion)
+{
+    MemorySim_CreateRegion(m_pMemory1, RAM_BASE, 32);
+    MemorySim_CreateRegion(m_pMemory2, RAM_BASE, 8);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(8, m_diff.bytesCompared);
+    CHECK_EQUAL(0, m_diff.rangeCount);
+}
+
+TEST(DumpDiff, ManyDifferences_ShouldGrowRangeArray)
+{
+    createRam(RAM_BASE, 4096);
+    for (uint32_t offset = 0 ; offset < 4096 ; offset += 2 * DUMP_DIFF_COALESCE_GAP)
+        IMemory_Write8(m_pMemory2, RAM_BASE + offset, 0x01);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    CHECK_EQUAL(4096 / (2 * DUMP_DIFF_COALESCE_GAP), m_diff.rangeCount);
+}
+
+TEST(DumpDiff, FailRangeAllocation_ShouldThrowAndFreeRanges)
+{
+    createRam(RAM_BASE, 16);
+    IMemory_Write8(m_pMemory2, RAM_BASE, 0x01);
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2) );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+    POINTERS_EQUAL(NULL, m_diff.pRanges);
+}
+
+TEST(DumpDiff, CompareWithFile_ShouldShareFlashAndDiffRam)
+{
+    static const uint32_t ram[4] = { 0x11111111, 0x22222222, 0x33333333, 0x44444444 };
+
+    MemorySim_CreateRegionFromHostBuffer(m_pMemory1, FLASH_BASE, m_flash, sizeof(m_flash));
+    MemorySim_MakeRegionReadOnly(m_pMemory1, FLASH_BASE);
+    MemorySim_CreateRegion(m_pMemory1, RAM_BASE, sizeof(ram));
+    for (size_t i = 0 ; i < ARRAY_SIZE(ram) ; i++)
+        IMemory_Write32(m_pMemory1, RAM_BASE + i * sizeof(uint32_t), ram[i]);
+    IMemory_Write32(m_pMemory1, RAM_BASE + 8, 0x3333AAAA);
+    writeDumpFile(ram, ARRAY_SIZE(ram));
+
+    DumpDiff_CompareWithFile(&m_diff, m_pMemory1, g_dumpFilename);
+    CHECK_EQUAL(sizeof(m_flash) + sizeof(ram), m_diff.bytesCompared);
+    CHECK_EQUAL(1, m_diff.rangeCount);
+    validateRange(0, RAM_BASE + 8, 2);
+}
+
+TEST(DumpDiff, CompareWithMissingFile_ShouldThrow)
+{
+    __try_and_catch( DumpDiff_CompareWithFile(&m_diff, m_pMemory1, "missing.dmp") );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(DumpDiff, PrintReport_ShouldAnnotateRangesWithSymbols)
+{
+    ElfSymbol  symbols[1] = { { "g_counter", RAM_BASE + 0x10, 8 } };
+    ElfSymbols elfSymbols = { symbols, NULL, ARRAY_SIZE(symbols) };
+
+    createRam(RAM_BASE, 256);
+    IMemory_Write16(m_pMemory2, RAM_BASE + 0x14, 0xFFFF);
+    IMemory_Write16(m_pMemory2, RAM_BASE + 0x80, 0xFFFF);
+    DumpDiff_Compare(&m_diff, m_pMemory1, m_pMemory2);
+    DumpDiff_PrintReport(&m_diff, &elfSymbols);
+
+    CHECK_EQUAL(3, printfSpy_GetCallCount());
+    STRCMP_EQUAL("Found 2 differing range(s) totalling 4 byte(s) in 256 byte(s) compared.\n", printfSpy_GetNthOutput(3));
+    STRCMP_EQUAL("  0x10000014 - 0x10000015 (2 bytes)  g_counter+4\n", printfSpy_GetNthOutput(2));
+    STRCMP_EQUAL("  0x10000080 - 0x10000081 (2 bytes)\n", printfSpy_GetLastOutput());
+}
@@ -0,0 +1,314 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <unistd.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CompactDump.h>
+    #include <CrashCatcher.h>
+    #include <DumpLoad.h>
+    #include <DumpStream.h>
+    #include <MemorySim.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+static const char* g_regularFilename = "DumpStreamTest.dmp";
+
+static FILE* createPipeContaining(const void* pData, size_t dataSize)
+{
+    int fds[2];
+
+    // Dumps used in these tests are small enough to fit in the pipe's buffer before the reader starts.
+    CHECK_EQUAL(0, pipe(fds));
+    CHECK_EQUAL((ssize_t)dataSize, write(fds[1], pData, dataSize));
+    close(fds[1]);
+    return fdopen(fds[0], "rb");
+}
+
+static FILE* createRegularFileContaining(const void* pData, size_t dataSize)
+{
+    FILE* pFile = fopen(g_regularFilename, "wb");
+    fwrite(pData, 1, dataSize, pFile);
+    fclose(pFile);
+    return fopen(g_regularFilename, "rb");
+}
+
+
+TEST_GROUP(DumpStream)
+{
+    DumpStream m_stream;
+    char       m_buffer[32];
+
+    void setup()
+    {
+        memset(&m_stream, 0, sizeof(m_stream));
+        memset(m_buffer, 0, sizeof(m_buffer));
+    }
+
+    void teardown()
+    {
+        DumpStream_Close(&m_stream);
+        remove(g_regularFilename);
+    }
+
+    void initStreamFromPipe(const char* pData)
+    {
+        DumpStream_Init(&m_stream, createPipeContaining(pData, strlen(pData)));
+    }
+};
+
+TEST(DumpStream, Peek_ShouldReturnBytesWhichAreThenReadAgain)
+{
+    initStreamFromPipe("0123456789");
+    CHECK_EQUAL(4, DumpStream_Peek(&m_stream, m_buffer, 4));
+    STRCMP_EQUAL("0123", m_buffer);
+    CHECK_EQUAL(6, DumpStream_Read(&m_stream, m_buffer, 6));
+    STRCMP_EQUAL("012345", m_buffer);
+    CHECK_EQUAL(4, DumpStream_Read(&m_stream, m_buffer, sizeof(m_buffer)));
+    m_buffer[4] = '\0';
+    STRCMP_EQUAL("6789", m_buffer);
+}
+
+TEST(DumpStream, PeekPastEndOfShortStream_ShouldReturnAvailableBytes)
+{
+    initStreamFromPipe("01");
+    CHECK_EQUAL(2, DumpStream_Peek(&m_stream, m_buffer, 4));
+    CHECK_EQUAL(2, DumpStream_Read(&m_stream, m_buffer, 4));
+    CHECK_EQUAL(0, DumpStream_Read(&m_stream, m_buffer, 4));
+}
+
+TEST(DumpStream, ReadSmallerThanPeek_ShouldReturnRestOfPeekedBytesOnNextRead)
+{
+    initStreamFromPipe("0123456789");
+    DumpStream_Peek(&m_stream, m_buffer, 4);
+    CHECK_EQUAL(1, DumpStream_Read(&m_stream, m_buffer, 1));
+    CHECK_EQUAL('0', m_buffer[0]);
+    CHECK_EQUAL(5, DumpStream_Read(&m_stream, m_buffer, 5));
+    m_buffer[5] = '\0';
+    STRCMP_EQUAL("12345", m_buffer);
+}
+
+TEST(DumpStream, GetsAfterPeek_ShouldReturnWholeLine)
+{
+    initStreamFromPipe("0x10000000:\t0x11111111\nr0 0\n");
+    DumpStream_Peek(&m_stream, m_buffer, 4);
+    POINTERS_EQUAL(m_buffer, DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer)));
+    STRCMP_EQUAL("0x10000000:\t0x11111111\n", m_buffer);
+    POINTERS_EQUAL(m_buffer, DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer)));
+    STRCMP_EQUAL("r0 0\n", m_buffer);
+    POINTERS_EQUAL(NULL, DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer)));
+}
+
+TEST(DumpStream, GetsAfterPeekingPastEndOfLine_ShouldStopAtNewLine)
+{
+    initStreamFromPipe("a\nbcdef\n");
+    DumpStream_Peek(&m_stream, m_buffer, 4);
+    DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer));
+    STRCMP_EQUAL("a\n", m_buffer);
+    DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer));
+    STRCMP_EQUAL("bcdef\n", m_buffer);
+}
+
+TEST(DumpStream, GetsOfPeekedLineWithoutNewLineAtEndOfStream_ShouldReturnPartialLine)
+{
+    initStreamFromPipe("ab");
+    DumpStream_Peek(&m_stream, m_buffer, 4);
+    POINTERS_EQUAL(m_buffer, DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer)));
+    STRCMP_EQUAL("ab", m_buffer);
+    POINTERS_EQUAL(NULL, DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer)));
+}
+
+TEST(DumpStream, GetsWithBufferSmallerThanPeek_ShouldTruncateLikeFgets)
+{
+    initStreamFromPipe("abcdef\n");
+    DumpStream_Peek(&m_stream, m_buffer, 4);
+    DumpStream_Gets(&m_stream, m_buffer, 3);
+    STRCMP_EQUAL("ab", m_buffer);
+    DumpStream_Gets(&m_stream, m_buffer, sizeof(m_buffer));
+    STRCMP_EQUAL("cdef\n", m_buffer);
+}
+
+TEST(DumpStream, GetSizeAndTellOnPipe_ShouldReturnNegativeOneWithoutConsumingData)
+{
+    initStreamFromPipe("0123");
+    CHECK_EQUAL(-1, DumpStream_GetSize(&m_stream));
+    CHECK_EQUAL(-1, DumpStream_Tell(&m_stream));
+    CHECK_EQUAL(4, DumpStream_Read(&m_stream, m_buffer, sizeof(m_buffer)));
+    STRCMP_EQUAL("0123", m_buffer);
+}
+
+TEST(DumpStream, GetSizeAndTellOnRegularFileAfterPeek_ShouldAccountForPeekedBytes)
+{
+    DumpStream_Init(&m_stream, createRegularFileContaining("0123456789", 10));
+    DumpStream_Peek(&m_stream, m_buffer, 4);
+    CHECK_EQUAL(0, DumpStream_Tell(&m_stream));
+    CHECK_EQUAL(10, DumpStream_GetSize(&m_stream));
+    DumpStream_Read(&m_stream, m_buffer, 6);
+    CHECK_EQUAL(6, DumpStream_Tell(&m_stream));
+    CHECK_EQUAL(4, DumpStream_Read(&m_stream, m_buffer, sizeof(m_buffer)));
+}
+
+TEST(DumpStream, Detach_ShouldLeaveFileOpenForCaller)
+{
+    initStreamFromPipe("0123");
+    FILE* pFile = DumpStream_Detach(&m_stream);
+    DumpStream_Close(&m_stream);
+    CHECK_EQUAL('0', fgetc(pFile));
+    fclose(pFile);
+}
+
+
+// Every dump format should load from a pipe with no seeking and no temporary file.
+struct BinaryDumpWithOneRegion
+{
+    uint8_t                      signature[4];
+    uint32_t                     flags;
+    uint32_t                     R[TOTAL_REG_COUNT];
+    uint32_t                     exceptionPSR;
+    CrashCatcherMemoryRegionInfo region;
+    uint32_t                     regionData[2];
+};
+
+TEST_GROUP(DumpLoadFromPipe)
+{
+    IMemory*        m_pMem;
+    RegisterContext m_context;
+
+    void setup()
+    {
+        m_pMem = MemorySim_Init();
+        memset(&m_context, 0, sizeof(m_context));
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MemorySim_Uninit(m_pMem);
+        clearExceptionCode();
+        remove(g_regularFilename);
+    }
+
+    void initBinaryDump(BinaryDumpWithOneRegion* pDump)
+    {
+        memset(pDump, 0, sizeof(*pDump));
+        pDump->signature[0] = CRASH_CATCHER_SIGNATURE_BYTE0;
+        pDump->signature[1] = CRASH_CATCHER_SIGNATURE_BYTE1;
+        pDump->signature[2] = CRASH_CATCHER_VERSION_MAJOR;
+        pDump->signature[3] = CRASH_CATCHER_VERSION_MINOR;
+        for (size_t i = 0 ; i < ARRAY_SIZE(pDump->R) ; i++)
+            pDump->R[i] = 0x01010101 * i;
+        pDump->region.startAddress = 0x10000000;
+        pDump->region.endAddress = 0x10000008;
+        pDump->regionData[0] = 0xAAAAAAAA;
+        pDump->regionData[1] = 0xBBBBBBBB;
+    }
+
+    void validateBinaryDumpLoaded()
+    {
+        CHECK_EQUAL(0x01010101 * PC, m_context.R[PC]);
+        CHECK_EQUAL(0xAAAAAAAA, IMemory_Read32(m_pMem, 0x10000000));
+        CHECK_EQUAL(0xBBBBBBBB, IMemory_Read32(m_pMem, 0x10000004));
+    }
+};
+
+TEST(DumpLoadFromPipe, GdbLog_ShouldLoadInSinglePass)
+{
+    static const char log[] = "r0             0x11111111\t286331153\n"
+                              "0x10000000:\t0x22222222\t0x33333333\t0x00000000\t0x00000000\n"
+                              "0x10000010:\t0x00000000\t0x00000000\t0x44444444\t0x00000000\n"
+                              "0x20000000:\t0x55555555\t0x00000000\t0x00000000\t0x00000000\n";
+
+    DumpLoad_FromStream(m_pMem, &m_context, createPipeContaining(log, sizeof(log) - 1));
+    CHECK_EQUAL(0x11111111, m_context.R[R0]);
+    CHECK_EQUAL(DEFAULT_SP_VALUE, m_context.R[MSP]);
+    CHECK_EQUAL(0x22222222, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0x33333333, IMemory_Read32(m_pMem, 0x10000004));
+    CHECK_EQUAL(0x44444444, IMemory_Read32(m_pMem, 0x10000018));
+    CHECK_EQUAL(0x55555555, IMemory_Read32(m_pMem, 0x20000000));
+}
+
+TEST(DumpLoadFromPipe, CrashCatcherBinary_ShouldLoadRegionsUpFront)
+{
+    BinaryDumpWithOneRegion dump;
+
+    initBinaryDump(&dump);
+    DumpLoad_FromStream(m_pMem, &m_context, createPipeContaining(&dump, sizeof(dump)));
+    validateBinaryDumpLoaded();
+}
+
+TEST(DumpLoadFromPipe, CrashCatcherBinaryFromRegularFile_ShouldStillWork)
+{
+    BinaryDumpWithOneRegion dump;
+
+    initBinaryDump(&dump);
+    DumpLoad_FromStream(m_pMem, &m_context, createRegularFileContaining(&dump, sizeof(dump)));
+    validateBinaryDumpLoaded();
+}
+
+TEST(DumpLoadFromPipe, CrashCatcherHex_ShouldLoad)
+{
+    static const char    nibbleToHex[] = "0123456789ABCDEF";
+    BinaryDumpWithOneRegion dump;
+    const uint8_t*       pCurr = (const uint8_t*)&dump;
+    char                 hex[2 * sizeof(dump) + 1];
+
+    initBinaryDump(&dump);
+    for (size_t i = 0 ; i < sizeof(dump) ; i++)
+    {
+        hex[2 * i] = nibbleToHex[pCurr[i] >> 4];
+        hex[2 * i + 1] = nibbleToHex[pCurr[i] & 0xF];
+    }
+    hex[sizeof(hex) - 1] = '\n';
+    DumpLoad_FromStream(m_pMem, &m_context, createPipeContaining(hex, sizeof(hex)));
+    validateBinaryDumpLoaded();
+}
+
+TEST(DumpLoadFromPipe, CompactDump_ShouldCopyIntoMemoryAndLoad)
+{
+    IMemory*        pSource = MemorySim_Init();
+    RegisterContext sourceContext;
+    uint8_t         fileData[4096];
+    size_t          fileSize;
+
+    memset(&sourceContext, 0, sizeof(sourceContext));
+    sourceContext.R[PC] = 0x12345678;
+    MemorySim_CreateRegion(pSource, 0x10000000, 0x100);
+    IMemory_Write32(pSource, 0x100000FC, 0xCCCCCCCC);
+    CompactDump_Write(pSource, &sourceContext, g_regularFilename);
+    MemorySim_Uninit(pSource);
+    FILE* pFile = fopen(g_regularFilename, "rb");
+    fileSize = fread(fileData, 1, sizeof(fileData), pFile);
+    fclose(pFile);
+    CHECK_TRUE(fileSize < sizeof(fileData));
+
+    DumpLoad_FromStream(m_pMem, &m_context, createPipeContaining(fileData, fileSize));
+    CHECK_EQUAL(0x12345678, m_context.R[PC]);
+    CHECK_EQUAL(0x00000000, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0xCCCCCCCC, IMemory_Read32(m_pMem, 0x100000FC));
+}
+
+TEST(DumpLoadFromPipe, TruncatedBinaryDump_ShouldThrowAndCloseStream)
+{
+    BinaryDumpWithOneRegion dump;
+
+    initBinaryDump(&dump);
+    __try_and_catch( DumpLoad_FromStream(m_pMem, &m_context, createPipeContaining(&dump, sizeof(dump) - 4)) );
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    clearExceptionCode();
+}
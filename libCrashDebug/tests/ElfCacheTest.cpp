@@ -0,0 +1,477 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <ElfCache.h>
+    #include <ElfPriv.h>
+    #include <FileFailureInject.h>
+    #include <MemorySim.h>
+}
+
+#include <dirent.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Include C++ headers for test harness.
+#include <CppUTest/TestHarness.h>
+
+
+static const char* g_cacheDirectory = "ElfCacheTest.dir";
+static const char* g_buildIdCacheFilename = "ElfCacheTest.dir/000102030405060708090a0b0c0d0e0f10111213.elfcache";
+
+/* The first entry follows the 56 byte header and its fileOffset is the entry's fourth word. */
+#define FIRST_ENTRY_FILE_OFFSET_POSITION    (56 + 3 * sizeof(uint32_t))
+
+struct BuildIdNote
+{
+    Elf32_Nhdr header;
+    char       name[4];
+    uint8_t    buildId[20];
+};
+
+struct ElfFileWithBuildId
+{
+    Elf32_Ehdr  elfHeader;
+    Elf32_Phdr  pgmHeaders[2];
+    uint32_t    data[3];
+    BuildIdNote note;
+};
+
+struct ElfFileWithSymbols
+{
+    ElfFileWithBuildId elf;
+    Elf32_Shdr         sectionHeaders[3];
+    Elf32_Sym          symbols[3];
+    char               strings[32];
+};
+
+TEST_GROUP(ElfCache)
+{
+    IMemory*           m_pMemory;
+    MappedFile         m_mappedCache;
+    ElfFileWithBuildId m_elf;
+    ElfFileWithSymbols m_elfWithSymbols;
+    ElfSymbols         m_symbols;
+
+    void setup()
+    {
+        m_pMemory = MemorySim_Init();
+        memset(&m_mappedCache, 0, sizeof(m_mappedCache));
+        memset(&m_symbols, 0, sizeof(m_symbols));
+        initElfFile(&m_elf);
+        initElfFileWithSymbols(&m_elfWithSymbols);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        clearExceptionCode();
+        ElfSymbols_Uninit(&m_symbols);
+        unload();
+        fopenRestore();
+        fwriteRestore();
+        removeCacheDirectory();
+    }
+
+    void unload()
+    {
+        MemorySim_Uninit(m_pMemory);
+        MappedFile_Close(&m_mappedCache);
+        m_pMemory = NULL;
+    }
+
+    void reload()
+    {
+        unload();
+        m_pMemory = MemorySim_Init();
+        m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    }
+
+    void removeCacheDirectory()
+    {
+        DIR*           pDir = opendir(g_cacheDirectory);
+        struct dirent* pEntry;
+
+        if (!pDir)
+            return;
+        while ((pEntry = readdir(pDir)) != NULL)
+        {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/%s", g_cacheDirectory, pEntry->d_name);
+            remove(path);
+        }
+        closedir(pDir);
+        rmdir(g_cacheDirectory);
+    }
+
+    int countCacheDirectoryFiles()
+    {
+        DIR*           pDir = opendir(g_cacheDirectory);
+        struct dirent* pEntry;
+        int            count = 0;
+
+        if (!pDir)
+            return 0;
+        while ((pEntry = readdir(pDir)) != NULL)
+        {
+            if (pEntry->d_name[0] != '.')
+                count++;
+        }
+        closedir(pDir);
+        return count;
+    }
+
+    int fileExists(const char* pFilename)
+    {
+        FILE* pFile = fopen(pFilename, "rb");
+        if (pFile)
+            fclose(pFile);
+        return pFile != NULL;
+    }
+
+    void overwriteFile(const char* pFilename, const void* pData, size_t dataSize)
+    {
+        FILE* pFile = fopen(pFilename, "wb");
+        fwrite(pData, 1, dataSize, pFile);
+        fclose(pFile);
+    }
+
+    void setFirstEntryFileOffset(uint32_t fileOffset)
+    {
+        MappedFile cache = MappedFile_Open(g_buildIdCacheFilename, MAPPED_FILE_READ_ONLY);
+        size_t     cacheSize = cache.size;
+        char*      pCopy = (char*)malloc(cacheSize);
+
+        memcpy(pCopy, cache.pData, cacheSize);
+        MappedFile_Close(&cache);
+        memcpy(pCopy + FIRST_ENTRY_FILE_OFFSET_POSITION, &fileOffset, sizeof(fileOffset));
+        overwriteFile(g_buildIdCacheFilename, pCopy, cacheSize);
+        free(pCopy);
+    }
+
+    void initElfFile(ElfFileWithBuildId* pElf)
+    {
+        memset(pElf, 0, sizeof(*pElf));
+        pElf->elfHeader.e_ident[EI_MAG0] = ELFMAG0;
+        pElf->elfHeader.e_ident[EI_MAG1] = ELFMAG1;
+        pElf->elfHeader.e_ident[EI_MAG2] = ELFMAG2;
+        pElf->elfHeader.e_ident[EI_MAG3] = ELFMAG3;
+        pElf->elfHeader.e_ident[EI_CLASS] = ELFCLASS32;
+        pElf->elfHeader.e_ident[EI_DATA] = ELFDATA2LSB;
+        pElf->elfHeader.e_type = ET_EXEC;
+        pElf->elfHeader.e_phoff = offsetof(ElfFileWithBuildId, pgmHeaders);
+        pElf->elfHeader.e_phnum = 2;
+        pElf->elfHeader.e_phentsize = sizeof(Elf32_Phdr);
+
+        pElf->pgmHeaders[0].p_type = PT_LOAD;
+        pElf->pgmHeaders[0].p_flags = PF_R | PF_X;
+        pElf->pgmHeaders[0].p_offset = offsetof(ElfFileWithBuildId, data);
+        pElf->pgmHeaders[0].p_filesz = sizeof(pElf->data);
+        pElf->pgmHeaders[0].p_memsz = sizeof(pElf->data);
+
+        pElf->pgmHeaders[1].p_type = PT_NOTE;
+        pElf->pgmHeaders[1].p_offset = offsetof(ElfFileWithBuildId, note);
+        pElf->pgmHeaders[1].p_filesz = sizeof(pElf->note);
+
+        pElf->data[0] = 0x10008000;
+        pElf->data[1] = 0x00000100;
+        pElf->data[2] = 0xBAADF00D;
+
+        pElf->note.header.n_namesz = 4;
+        pElf->note.header.n_descsz = sizeof(pElf->note.buildId);
+        pElf->note.header.n_type = NT_GNU_BUILD_ID;
+        memcpy(pElf->note.name, "GNU", 4);
+        for (size_t i = 0 ; i < sizeof(pElf->note.buildId) ; i++)
+            pElf->note.buildId[i] = i;
+    }
+
+    void initElfFileWithSymbols(ElfFileWithSymbols* pElf)
+    {
+        static const char strings[] = "\0pxCurrentTCB\0printf";
+
+        memset(pElf, 0, sizeof(*pElf));
+        initElfFile(&pElf->elf);
+        pElf->elf.elfHeader.e_shoff = offsetof(ElfFileWithSymbols, sectionHeaders);
+        pElf->elf.elfHeader.e_shnum = 3;
+        pElf->elf.elfHeader.e_shentsize = sizeof(Elf32_Shdr);
+
+        pElf->sectionHeaders[1].sh_type = SHT_SYMTAB;
+        pElf->sectionHeaders[1].sh_offset = offsetof(ElfFileWithSymbols, symbols);
+        pElf->sectionHeaders[1].sh_size = sizeof(pElf->symbols);
+        pElf->sectionHeaders[1].sh_entsize = sizeof(Elf32_Sym);
+        pElf->sectionHeaders[1].sh_link = 2;
+        pElf->sectionHeaders[2].sh_type = SHT_STRTAB;
+        pElf->sectionHeaders[2].sh_offset = offsetof(ElfFileWithSymbols, strings);
+        pElf->sectionHeaders[2].sh_size = sizeof(strings);
+
+        /* printf is undefined so it shouldn't make it into the symbols. */
+        pElf->symbols[1].st_name = 1;
+        pElf->symbols[1].st_value = 0x20000000;
+        pElf->symbols[1].st_size = 4;
+        pElf->symbols[1].st_shndx = 1;
+        pElf->symbols[2].st_name = 14;
+        pElf->symbols[2].st_shndx = SHN_UNDEF;
+        memcpy(pElf->strings, strings, sizeof(strings));
+    }
+
+    void loadElfWithSymbols(ElfSymbols* pSymbols)
+    {
+        ElfSymbols_Uninit(&m_symbols);
+        unload();
+        m_pMemory = MemorySim_Init();
+        m_mappedCache = ElfCache_Load(m_pMemory, pSymbols, g_cacheDirectory,
+                                      &m_elfWithSymbols, sizeof(m_elfWithSymbols));
+    }
+
+    void validateSymbols()
+    {
+        CHECK_EQUAL(1, m_symbols.symbolCount);
+        const ElfSymbol* pSymbol = ElfSymbols_Find(&m_symbols, "pxCurrentTCB");
+        CHECK(pSymbol != NULL);
+        CHECK_EQUAL(0x20000000, pSymbol->address);
+        CHECK_EQUAL(4, pSymbol->size);
+    }
+
+    void removeBuildIdNote()
+    {
+        m_elf.pgmHeaders[1].p_type = PT_NULL;
+    }
+
+    void validateFlashContents()
+    {
+        CHECK_EQUAL(0x10008000, IMemory_Read32(m_pMemory, 0x00000000));
+        CHECK_EQUAL(0x00000100, IMemory_Read32(m_pMemory, 0x00000004));
+        CHECK_EQUAL(0xBAADF00D, IMemory_Read32(m_pMemory, 0x00000008));
+        __try_and_catch( IMemory_Write32(m_pMemory, 0x00000000, 0xFFFFFFFF) );
+        CHECK_EQUAL(busErrorException, getExceptionCode());
+        clearExceptionCode();
+        CHECK_EQUAL(1, MemorySim_GetRegionCount(m_pMemory));
+    }
+};
+
+
+TEST(ElfCache, FirstLoad_ShouldMissLoadFromElfAndWriteCacheFileNamedAfterBuildId)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    validateFlashContents();
+    CHECK_TRUE(fileExists(g_buildIdCacheFilename));
+    CHECK_EQUAL(1, countCacheDirectoryFiles());
+}
+
+TEST(ElfCache, SecondLoad_ShouldHitAndMapCachedContents)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    reload();
+    CHECK(m_mappedCache.pData != NULL);
+    validateFlashContents();
+}
+
+TEST(ElfCache, SecondLoad_ShouldHitEvenIfElfContentsChangeSinceBuildIdIsTheKey)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    m_elf.data[2] = 0xFFFFFFFF;
+    reload();
+    CHECK(m_mappedCache.pData != NULL);
+    validateFlashContents();
+}
+
+TEST(ElfCache, CachedRegions_ShouldTrackFlashReadCounts)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    reload();
+    IMemory_Read16(m_pMemory, 0x00000002);
+    CHECK_EQUAL(1, MemorySim_GetFlashReadCount(m_pMemory, 0x00000002));
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(m_pMemory, 0x00000000));
+}
+
+TEST(ElfCache, FirstLoadWithSymbols_ShouldMissAndParseSymbolsFromElf)
+{
+    loadElfWithSymbols(&m_symbols);
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    validateFlashContents();
+    validateSymbols();
+}
+
+TEST(ElfCache, SecondLoadWithSymbols_ShouldRestoreSymbolsFromCacheWithoutParsingElf)
+{
+    loadElfWithSymbols(NULL);
+    /* Corrupt the ELF's symbol table so that the symbols can only have come from the cache file. */
+    m_elfWithSymbols.sectionHeaders[1].sh_type = SHT_NULL;
+    m_elfWithSymbols.strings[1] = 'X';
+    loadElfWithSymbols(&m_symbols);
+    CHECK(m_mappedCache.pData != NULL);
+    validateFlashContents();
+    validateSymbols();
+}
+
+TEST(ElfCache, LoadWithSymbols_ElfWithoutSymbolTable_ShouldLeaveSymbolsEmptyOnMissAndHit)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, &m_symbols, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    POINTERS_EQUAL(NULL, m_symbols.pSymbols);
+    unload();
+    m_pMemory = MemorySim_Init();
+    m_mappedCache = ElfCache_Load(m_pMemory, &m_symbols, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    CHECK(m_mappedCache.pData != NULL);
+    validateFlashContents();
+    POINTERS_EQUAL(NULL, m_symbols.pSymbols);
+    CHECK_EQUAL(0, m_symbols.symbolCount);
+}
+
+TEST(ElfCache, BuildIdInSectionHeaderOnly_ShouldStillUseBuildIdAsKey)
+{
+    struct
+    {
+        ElfFileWithBuildId elf;
+        Elf32_Shdr         sectionHeaders[2];
+    } elfWithSections;
+
+    removeBuildIdNote();
+    memcpy(&elfWithSections.elf, &m_elf, sizeof(m_elf));
+    memset(elfWithSections.sectionHeaders, 0, sizeof(elfWithSections.sectionHeaders));
+    elfWithSections.elf.elfHeader.e_shoff = (char*)elfWithSections.sectionHeaders - (char*)&elfWithSections;
+    elfWithSections.elf.elfHeader.e_shnum = 2;
+    elfWithSections.elf.elfHeader.e_shentsize = sizeof(Elf32_Shdr);
+    elfWithSections.sectionHeaders[1].sh_type = SHT_NOTE;
+    elfWithSections.sectionHeaders[1].sh_offset = offsetof(ElfFileWithBuildId, note);
+    elfWithSections.sectionHeaders[1].sh_size = sizeof(BuildIdNote);
+
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &elfWithSections, sizeof(elfWithSections));
+    validateFlashContents();
+    CHECK_TRUE(fileExists(g_buildIdCacheFilename));
+}
+
+TEST(ElfCache, NoBuildId_ShouldFallBackToContentHashAndHitOnSecondLoad)
+{
+    removeBuildIdNote();
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    CHECK_FALSE(fileExists(g_buildIdCacheFilename));
+    CHECK_EQUAL(1, countCacheDirectoryFiles());
+    reload();
+    CHECK(m_mappedCache.pData != NULL);
+    validateFlashContents();
+}
+
+TEST(ElfCache, NoBuildId_ChangedElfContents_ShouldMissAndAddSecondCacheFile)
+{
+    removeBuildIdNote();
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    m_elf.data[2] = 0xFFFFFFFF;
+    reload();
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    CHECK_EQUAL(0xFFFFFFFF, IMemory_Read32(m_pMemory, 0x00000008));
+    CHECK_EQUAL(2, countCacheDirectoryFiles());
+}
+
+TEST(ElfCache, TruncatedBuildIdNote_ShouldFallBackToContentHash)
+{
+    m_elf.note.header.n_descsz = 0x1000;
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    validateFlashContents();
+    CHECK_FALSE(fileExists(g_buildIdCacheFilename));
+    CHECK_EQUAL(1, countCacheDirectoryFiles());
+}
+
+TEST(ElfCache, CorruptCacheFile_ShouldMissAndRewriteCacheFile)
+{
+    static const char garbage[] = "This isn't a cache file.";
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    overwriteFile(g_buildIdCacheFilename, garbage, sizeof(garbage));
+    reload();
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    validateFlashContents();
+    reload();
+    CHECK(m_mappedCache.pData != NULL);
+    validateFlashContents();
+}
+
+TEST(ElfCache, TruncatedCacheFile_ShouldMiss)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    unload();
+    m_mappedCache = MappedFile_Open(g_buildIdCacheFilename, MAPPED_FILE_READ_ONLY);
+    char* pTruncated = (char*)malloc(m_mappedCache.size - 1);
+    size_t truncatedSize = m_mappedCache.size - 1;
+    memcpy(pTruncated, m_mappedCache.pData, truncatedSize);
+    MappedFile_Close(&m_mappedCache);
+    overwriteFile(g_buildIdCacheFilename, pTruncated, truncatedSize);
+    free(pTruncated);
+
+    m_pMemory = MemorySim_Init();
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    validateFlashContents();
+}
+
+TEST(ElfCache, CacheEntryWithUnalignedFileOffset_ShouldMiss)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    unload();
+    setFirstEntryFileOffset(71);
+    m_pMemory = MemorySim_Init();
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    validateFlashContents();
+}
+
+TEST(ElfCache, CacheEntryWithFileOffsetInsideHeader_ShouldMiss)
+{
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    unload();
+    setFirstEntryFileOffset(0);
+    m_pMemory = MemorySim_Init();
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    POINTERS_EQUAL(NULL, m_mappedCache.pData);
+    validateFlashContents();
+}
+
+TEST(ElfCache, FailToCreateCacheFile_ShouldStillLoadFromElfWithoutThrowing)
+{
+    fopenSetReturn(NULL);
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    fopenRestore();
+    validateFlashContents();
+    CHECK_EQUAL(0, countCacheDirectoryFiles());
+}
+
+TEST(ElfCache, FailToWriteCacheFile_ShouldStillLoadFromElfAndLeaveNoFilesBehind)
+{
+    fwriteFail(0);
+    m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf));
+    fwriteRestore();
+    validateFlashContents();
+    CHECK_EQUAL(0, countCacheDirectoryFiles());
+}
+
+TEST(ElfCache, InvalidElfSignature_ShouldThrowSameErrorAsElfLoad)
+{
+    m_elf.elfHeader.e_ident[EI_MAG0] += 1;
+    __try_and_catch( m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf)) );
+    CHECK_EQUAL(elfFormatException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("ELF header doesn't start with expected magic ELF identifier.", getExceptionMessage());
+    CHECK_EQUAL(0, countCacheDirectoryFiles());
+}
+
+TEST(ElfCache, ElfWithNoLoadableEntries_ShouldThrowAndNotWriteCacheFile)
+{
+    m_elf.pgmHeaders[0].p_type = PT_NULL;
+    __try_and_catch( m_mappedCache = ElfCache_Load(m_pMemory, NULL, g_cacheDirectory, &m_elf, sizeof(m_elf)) );
+    CHECK_EQUAL(elfFormatException, getExceptionCode());
+    clearExceptionCode();
+    CHECK_EQUAL(0, countCacheDirectoryFiles());
+}
@@ -0,0 +1,237 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrashCatcher.h>
+    #include <ElfCore.h>
+    #include <ElfPriv.h>
+    #include <FileFailureInject.h>
+    #include <MemorySim.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define PRSTATUS_SIZE   148
+#define VFP_SIZE        260
+
+static const char* g_coreFilename = "ElfCoreTest.core";
+
+
+TEST_GROUP(ElfCore)
+{
+    IMemory*        m_pMemory;
+    RegisterContext m_context;
+    uint8_t*        m_pCore;
+    long            m_coreSize;
+
+    void setup()
+    {
+        static const uint32_t flashImage[2] = { 0x10000100, 0x00000101 };
+
+        m_pCore = NULL;
+        m_coreSize = 0;
+        m_pMemory = MemorySim_Init();
+        MemorySim_CreateRegionsFromFlashImage(m_pMemory, flashImage, sizeof(flashImage));
+        IMemory_Write32(m_pMemory, 0x10000000, 0x11111111);
+        IMemory_Write32(m_pMemory, 0x100000FC, 0xFFFFFFFF);
+        MemorySim_CreateAlias(m_pMemory, 0xA0000000, 0x00000000, 8);
+
+        memset(&m_context, 0, sizeof(m_context));
+        for (size_t i = 0 ; i < ARRAY_SIZE(m_context.R) ; i++)
+            m_context.R[i] = 0x11111111 * i;
+        m_context.exceptionPSR = 3;
+        for (size_t i = 0 ; i < ARRAY_SIZE(m_context.FPR) ; i++)
+            m_context.FPR[i] = 0xF0000000 | i;
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        fopenRestore();
+        fwriteRestore();
+        free(m_pCore);
+        MemorySim_Uninit(m_pMemory);
+        remove(g_coreFilename);
+    }
+
+    void readCoreFile()
+    {
+        FILE* pFile = fopen(g_coreFilename, "rb");
+        CHECK(pFile != NULL);
+        fseek(pFile, 0, SEEK_END);
+        m_coreSize = ftell(pFile);
+        fseek(pFile, 0, SEEK_SET);
+        m_pCore = (uint8_t*)malloc(m_coreSize);
+        CHECK_EQUAL(m_coreSize, (long)fread(m_pCore, 1, m_coreSize, pFile));
+        fclose(pFile);
+    }
+
+    const Elf32_Ehdr* elfHeader()
+    {
+        return (const Elf32_Ehdr*)m_pCore;
+    }
+
+    const Elf32_Phdr* programHeader(size_t index)
+    {
+        return (const Elf32_Phdr*)(m_pCore + elfHeader()->e_phoff + index * sizeof(Elf32_Phdr));
+    }
+
+    const uint8_t* findNote(uint32_t type, const char* pExpectedName, uint32_t expectedSize)
+    {
+        const Elf32_Phdr* pNotes = programHeader(0);
+        uint32_t          offset = 0;
+
+        CHECK_EQUAL(PT_NOTE, pNotes->p_type);
+        while (offset < pNotes->p_filesz)
+        {
+            const Elf32_Nhdr* pHeader = (const Elf32_Nhdr*)(m_pCore + pNotes->p_offset + offset);
+            const char*       pName = (const char*)(pHeader + 1);
+            const uint8_t*    pDescriptor = (const uint8_t*)pName + ((pHeader->n_namesz + 3) & ~3);
+
+            if (pHeader->n_type == type)
+            {
+                STRCMP_EQUAL(pExpectedName, pName);
+                CHECK_EQUAL(expectedSize, pHeader->n_descsz);
+                return pDescriptor;
+            }
+            offset += sizeof(*pHeader) + ((pHeader->n_namesz + 3) & ~3) + ((pHeader->n_descsz + 3) & ~3);
+        }
+        return NULL;
+    }
+
+    uint32_t word(const uint8_t* pData, size_t offset)
+    {
+        uint32_t value;
+        memcpy(&value, pData + offset, sizeof(value));
+        return value;
+    }
+};
+
+TEST(ElfCore, WriteCore_ShouldHaveArmCoreElfHeader)
+{
+    ElfCore_Write(m_pMemory, &m_context, g_coreFilename);
+    readCoreFile();
+    CHECK_EQUAL(ELFMAG0, elfHeader()->e_ident[EI_MAG0]);
+    CHECK_EQUAL(ELFMAG1, elfHeader()->e_ident[EI_MAG1]);
+    CHECK_EQUAL(ELFMAG2, elfHeader()->e_ident[EI_MAG2]);
+    CHECK_EQUAL(ELFMAG3, elfHeader()->e_ident[EI_MAG3]);
+    CHECK_EQUAL(ELFCLASS32, elfHeader()->e_ident[EI_CLASS]);
+    CHECK_EQUAL(ELFDATA2LSB, elfHeader()->e_ident[EI_DATA]);
+    CHECK_EQUAL(ET_CORE, elfHeader()->e_type);
+    CHECK_EQUAL(EM_ARM, elfHeader()->e_machine);
+    CHECK_EQUAL(sizeof(Elf32_Phdr), elfHeader()->e_phentsize);
+    // 1 PT_NOTE + FLASH + RAM (the alias is skipped).
+    CHECK_EQUAL(3, elfHeader()->e_phnum);
+}
+
+TEST(ElfCore, WriteCore_ShouldHaveLoadSegmentForEachNonAliasRegion)
+{
+    ElfCore_Write(m_pMemory, &m_context, g_coreFilename);
+    readCoreFile();
+
+    const Elf32_Phdr* pFlash = programHeader(1);
+    CHECK_EQUAL(PT_LOAD, pFlash->p_type);
+    CHECK_EQUAL(0x00000000, pFlash->p_vaddr);
+    CHECK_EQUAL(8, pFlash->p_filesz);
+    CHECK_EQUAL(8, pFlash->p_memsz);
+    CHECK_EQUAL(PF_R | PF_X, pFlash->p_flags);
+    CHECK_EQUAL(0, pFlash->p_offset % 4);
+    CHECK_EQUAL(0x10000100, word(m_pCore, pFlash->p_offset));
+    CHECK_EQUAL(0x00000101, word(m_pCore, pFlash->p_offset + 4));
+
+    const Elf32_Phdr* pRam = programHeader(2);
+    CHECK_EQUAL(PT_LOAD, pRam->p_type);
+    CHECK_EQUAL(0x10000000, pRam->p_vaddr);
+    CHECK_EQUAL(0x100, pRam->p_filesz);
+    CHECK_EQUAL(PF_R | PF_W, pRam->p_flags);
+    CHECK_EQUAL(0x11111111, word(m_pCore, pRam->p_offset));
+    CHECK_EQUAL(0xFFFFFFFF, word(m_pCore, pRam->p_offset + 0xFC));
+    CHECK_EQUAL(m_coreSize, (long)(pRam->p_offset + pRam->p_filesz));
+}
+
+TEST(ElfCore, WriteCore_ShouldPlaceRegistersInPrStatusNote)
+{
+    ElfCore_Write(m_pMemory, &m_context, g_coreFilename);
+    readCoreFile();
+
+    const uint8_t* pPrStatus = findNote(NT_PRSTATUS, "CORE", PRSTATUS_SIZE);
+    CHECK(pPrStatus != NULL);
+    // SIGSEGV for a hard fault.
+    CHECK_EQUAL(11, pPrStatus[12]);
+    for (int i = R0 ; i <= PC ; i++)
+        CHECK_EQUAL(m_context.R[i], word(pPrStatus, 72 + i * sizeof(uint32_t)));
+    CHECK_EQUAL(m_context.R[XPSR], word(pPrStatus, 72 + 16 * sizeof(uint32_t)));
+    CHECK_EQUAL(0, word(pPrStatus, 72 + 17 * sizeof(uint32_t)));
+    CHECK_EQUAL(0, word(pPrStatus, 144));
+    POINTERS_EQUAL(NULL, findNote(NT_ARM_VFP, "LINUX", VFP_SIZE));
+}
+
+TEST(ElfCore, WriteCoreWithFloatingPointRegisters_ShouldAddVfpNote)
+{
+    m_context.flags = CRASH_CATCHER_FLAGS_FLOATING_POINT;
+    ElfCore_Write(m_pMemory, &m_context, g_coreFilename);
+    readCoreFile();
+
+    const uint8_t* pPrStatus = findNote(NT_PRSTATUS, "CORE", PRSTATUS_SIZE);
+    CHECK_EQUAL(1, word(pPrStatus, 144));
+    const uint8_t* pVfp = findNote(NT_ARM_VFP, "LINUX", VFP_SIZE);
+    CHECK(pVfp != NULL);
+    for (int i = S0 ; i <= S31 ; i++)
+        CHECK_EQUAL(m_context.FPR[i], word(pVfp, i * sizeof(uint32_t)));
+    for (int i = 32 ; i < 64 ; i++)
+        CHECK_EQUAL(0, word(pVfp, i * sizeof(uint32_t)));
+    CHECK_EQUAL(m_context.FPR[FPSCR], word(pVfp, 256));
+}
+
+TEST(ElfCore, BusFaultAndUsageFault_ShouldMapToSigbusAndSigill)
+{
+    m_context.exceptionPSR = 5;
+    ElfCore_Write(m_pMemory, &m_context, g_coreFilename);
+    readCoreFile();
+    CHECK_EQUAL(7, findNote(NT_PRSTATUS, "CORE", PRSTATUS_SIZE)[12]);
+    free(m_pCore);
+    m_pCore = NULL;
+
+    m_context.exceptionPSR = 6;
+    ElfCore_Write(m_pMemory, &m_context, g_coreFilename);
+    readCoreFile();
+    CHECK_EQUAL(4, findNote(NT_PRSTATUS, "CORE", PRSTATUS_SIZE)[12]);
+}
+
+TEST(ElfCore, FailToCreateFile_ShouldThrow)
+{
+    fopenSetReturn(NULL);
+    __try_and_catch( ElfCore_Write(m_pMemory, &m_context, g_coreFilename) );
+    fopenRestore();
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("Failed to create \"ElfCoreTest.core\" core file.", getExceptionMessage());
+}
+
+TEST(ElfCore, FailToWriteFile_ShouldThrowAndRemoveFile)
+{
+    fwriteFail(0);
+    __try_and_catch( ElfCore_Write(m_pMemory, &m_context, g_coreFilename) );
+    fwriteRestore();
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("Failed to write \"ElfCoreTest.core\" core file.", getExceptionMessage());
+    POINTERS_EQUAL(NULL, fopen(g_coreFilename, "rb"));
+}
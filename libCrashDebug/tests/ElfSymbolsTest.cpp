@@ -0,0 +1,234 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <ElfPriv.h>
+    #include <ElfSymbols.h>
+    #include <MallocFailureInject.h>
+}
+
+#include <stddef.h>
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include <CppUTest/TestHarness.h>
+
+
+static const char g_strings[] = "\0main\0__malloc_av_\0undefined";
+
+struct ElfFile
+{
+    Elf32_Ehdr elfHeader;
+    Elf32_Shdr sectionHeaders[3];
+    Elf32_Sym  symbols[4];
+    char       strings[sizeof(g_strings)];
+};
+
+TEST_GROUP(ElfSymbols)
+{
+    ElfSymbols m_symbols;
+    ElfFile    m_elf;
+
+    void setup()
+    {
+        memset(&m_symbols, 0, sizeof(m_symbols));
+        initElfFile();
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MallocFailureInject_Restore();
+        ElfSymbols_Uninit(&m_symbols);
+    }
+
+    void initElfFile()
+    {
+        Elf32_Ehdr* pHeader = &m_elf.elfHeader;
+
+        memset(&m_elf, 0, sizeof(m_elf));
+        pHeader->e_ident[EI_MAG0] = ELFMAG0;
+        pHeader->e_ident[EI_MAG1] = ELFMAG1;
+        pHeader->e_ident[EI_MAG2] = ELFMAG2;
+        pHeader->e_ident[EI_MAG3] = ELFMAG3;
+        pHeader->e_ident[EI_CLASS] = ELFCLASS32;
+        pHeader->e_ident[EI_DATA] = ELFDATA2LSB;
+        pHeader->e_type = ET_EXEC;
+        pHeader->e_shoff = offsetof(ElfFile, sectionHeaders);
+        pHeader->e_shnum = 3;
+        pHeader->e_shentsize = sizeof(Elf32_Shdr);
+
+        m_elf.sectionHeaders[1].sh_type = SHT_SYMTAB;
+        m_elf.sectionHeaders[1].sh_offset = offsetof(ElfFile, symbols);
+        m_elf.sectionHeaders[1].sh_size = sizeof(m_elf.symbols);
+        m_elf.sectionHeaders[1].sh_entsize = sizeof(Elf32_Sym);
+        m_elf.sectionHeaders[1].sh_link = 2;
+        m_elf.sectionHeaders[2].sh_type = SHT_STRTAB;
+        m_elf.sectionHeaders[2].sh_offset = offsetof(ElfFile, strings);
+        m_elf.sectionHeaders[2].sh_size = sizeof(m_elf.strings);
+
+        // Entry 0 is the null symbol required by the ELF specification.
+        initSymbol(&m_elf.symbols[1], 1, 0x00000101, 0x20, 1);
+        initSymbol(&m_elf.symbols[2], 6, 0x20000000, 0x408, 2);
+        initSymbol(&m_elf.symbols[3], 19, 0x00000000, 0, SHN_UNDEF);
+        memcpy(m_elf.strings, g_strings, sizeof(g_strings));
+    }
+
+    void initSymbol(Elf32_Sym* pSymbol, uint32_t nameOffset, uint32_t value, uint32_t size, uint16_t sectionIndex)
+    {
+        pSymbol->st_name = nameOffset;
+        pSymbol->st_value = value;
+        pSymbol->st_size = size;
+        pSymbol->st_shndx = sectionIndex;
+    }
+
+    void validateException(int expectedException, const char* pExpectedMessage)
+    {
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        STRCMP_EQUAL(pExpectedMessage, getExceptionMessage());
+        clearExceptionCode();
+        POINTERS_EQUAL(NULL, m_symbols.pSymbols);
+        POINTERS_EQUAL(NULL, m_symbols.pStrings);
+    }
+};
+
+
+TEST(ElfSymbols, LoadValidElf_ShouldFindDefinedSymbolsByName)
+{
+    ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf));
+    LONGS_EQUAL(2, m_symbols.symbolCount);
+
+    const ElfSymbol* pMain = ElfSymbols_Find(&m_symbols, "main");
+    CHECK_TRUE(pMain != NULL);
+    STRCMP_EQUAL("main", pMain->pName);
+    CHECK_EQUAL(0x00000101, pMain->address);
+    CHECK_EQUAL(0x20, pMain->size);
+
+    const ElfSymbol* pMallocAv = ElfSymbols_Find(&m_symbols, "__malloc_av_");
+    CHECK_TRUE(pMallocAv != NULL);
+    CHECK_EQUAL(0x20000000, pMallocAv->address);
+    CHECK_EQUAL(0x408, pMallocAv->size);
+}
+
+TEST(ElfSymbols, FindUndefinedOrMissingSymbol_ShouldReturnNull)
+{
+    ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf));
+    POINTERS_EQUAL(NULL, ElfSymbols_Find(&m_symbols, "undefined"));
+    POINTERS_EQUAL(NULL, ElfSymbols_Find(&m_symbols, "missing"));
+    POINTERS_EQUAL(NULL, ElfSymbols_Find(&m_symbols, ""));
+}
+
+TEST(ElfSymbols, FindByAddress_ShouldReturnSymbolContainingAddress)
+{
+    ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf));
+    STRCMP_EQUAL("__malloc_av_", ElfSymbols_FindByAddress(&m_symbols, 0x20000000)->pName);
+    STRCMP_EQUAL("__malloc_av_", ElfSymbols_FindByAddress(&m_symbols, 0x20000407)->pName);
+    POINTERS_EQUAL(NULL, ElfSymbols_FindByAddress(&m_symbols, 0x20000408));
+    POINTERS_EQUAL(NULL, ElfSymbols_FindByAddress(&m_symbols, 0x1FFFFFFF));
+}
+
+TEST(ElfSymbols, FindByAddressWithNestedSymbols_ShouldReturnSmallest)
+{
+    initSymbol(&m_elf.symbols[3], 1, 0x20000100, 0x10, 2);
+    ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf));
+    STRCMP_EQUAL("main", ElfSymbols_FindByAddress(&m_symbols, 0x20000104)->pName);
+    STRCMP_EQUAL("__malloc_av_", ElfSymbols_FindByAddress(&m_symbols, 0x20000110)->pName);
+}
+
+TEST(ElfSymbols, SymbolNameOffsetPastStringTable_ShouldSkipSymbol)
+{
+    m_elf.symbols[1].st_name = sizeof(g_strings);
+    ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf));
+    LONGS_EQUAL(1, m_symbols.symbolCount);
+    POINTERS_EQUAL(NULL, ElfSymbols_Find(&m_symbols, "main"));
+}
+
+TEST(ElfSymbols, UninitTwice_ShouldBeSafe)
+{
+    ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf));
+    ElfSymbols_Uninit(&m_symbols);
+    ElfSymbols_Uninit(&m_symbols);
+}
+
+TEST(ElfSymbols, TruncatedElfHeader_ShouldThrow)
+{
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf.elfHeader) - 1) );
+    validateException(elfFormatException, "ELF header isn't for a 32-bit little endian image.");
+}
+
+TEST(ElfSymbols, BigEndianElf_ShouldThrow)
+{
+    m_elf.elfHeader.e_ident[EI_DATA] = ELFDATA2MSB;
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    validateException(elfFormatException, "ELF header isn't for a 32-bit little endian image.");
+}
+
+TEST(ElfSymbols, NoSectionHeaders_ShouldThrow)
+{
+    m_elf.elfHeader.e_shoff = 0;
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    validateException(elfFormatException, "ELF doesn't contain any section headers.");
+}
+
+TEST(ElfSymbols, StrippedElf_ShouldThrow)
+{
+    m_elf.sectionHeaders[1].sh_type = SHT_NULL;
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    validateException(elfFormatException, "ELF doesn't contain a symbol table. Was it stripped?");
+}
+
+TEST(ElfSymbols, SectionHeadersPastEndOfFile_ShouldThrow)
+{
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, offsetof(ElfFile, sectionHeaders[1])) );
+    validateException(elfFormatException, "ELF section header 1 is at an invalid file offset.");
+}
+
+TEST(ElfSymbols, SymbolTableLinksToNonStringSection_ShouldThrow)
+{
+    m_elf.sectionHeaders[1].sh_link = 1;
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    validateException(elfFormatException, "ELF symbol table doesn't link to a valid string table.");
+}
+
+TEST(ElfSymbols, SymbolTableLinksToInvalidSection_ShouldThrow)
+{
+    m_elf.sectionHeaders[1].sh_link = 3;
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    validateException(elfFormatException, "ELF section header 3 is at an invalid file offset.");
+}
+
+TEST(ElfSymbols, SymbolTablePastEndOfFile_ShouldThrow)
+{
+    m_elf.sectionHeaders[1].sh_size = sizeof(m_elf);
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    validateException(elfFormatException, "ELF symbol table is at an invalid file offset.");
+}
+
+TEST(ElfSymbols, FailStringAllocation_ShouldThrow)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(ElfSymbols, FailSymbolAllocation_ShouldThrowAndFreeStrings)
+{
+    MallocFailureInject_FailAllocation(2);
+    __try_and_catch( ElfSymbols_Init(&m_symbols, &m_elf, sizeof(m_elf)) );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+    POINTERS_EQUAL(NULL, m_symbols.pStrings);
+}
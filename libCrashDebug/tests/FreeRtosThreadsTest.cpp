@@ -0,0 +1,367 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <CrashCatcher.h>
+    #include <FreeRtosThreads.h>
+    #include <MallocFailureInject.h>
+    #include <MemorySim.h>
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include <CppUTest/TestHarness.h>
+
+
+#define RAM_BASE            0x20000000
+#define CURRENT_TCB_VAR     0x20000000
+#define READY_LISTS         0x20000010
+#define DELAYED_LIST1       0x20000040
+#define DELAYED_LIST2       0x20000060
+#define SUSPENDED_LIST      0x20000080
+#define RUNNING_TCB         0x20000100
+#define BLOCKED_TCB         0x20000200
+#define IDLE_TCB            0x20000300
+#define BLOCKED_STACK       0x20000800
+#define IDLE_STACK          0x20000900
+
+TEST_GROUP(FreeRtosThreads)
+{
+    IMemory*        m_pMemory;
+    RtosThreads     m_threads;
+    RegisterContext m_haltedContext;
+    ElfSymbol       m_symbolArray[5];
+    ElfSymbols      m_symbols;
+
+    void setup()
+    {
+        static const ElfSymbol symbols[] =
+        {
+            { "pxCurrentTCB", CURRENT_TCB_VAR, 4 },
+            { "pxReadyTasksLists", READY_LISTS, 2 * 20 },
+            { "xDelayedTaskList1", DELAYED_LIST1, 20 },
+            { "xDelayedTaskList2", DELAYED_LIST2, 20 },
+            { "xSuspendedTaskList", SUSPENDED_LIST, 20 }
+        };
+
+        memset(&m_threads, 0, sizeof(m_threads));
+        memcpy(m_symbolArray, symbols, sizeof(symbols));
+        m_symbols.pSymbols = m_symbolArray;
+        m_symbols.pStrings = NULL;
+        m_symbols.symbolCount = ARRAY_SIZE(m_symbolArray);
+
+        memset(&m_haltedContext, 0, sizeof(m_haltedContext));
+        for (size_t i = 0 ; i < ARRAY_SIZE(m_haltedContext.R) ; i++)
+            m_haltedContext.R[i] = 0xC0DE0000 + i;
+
+        m_pMemory = MemorySim_Init();
+        MemorySim_CreateRegion(m_pMemory, RAM_BASE, 0x1000);
+        buildKernelState();
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MallocFailureInject_Restore();
+        FreeRtosThreads_Uninit(&m_threads);
+        MemorySim_Uninit(m_pMemory);
+    }
+
+    // The running task is on the priority 1 ready list, IDLE is on the priority 0 ready list and net is delayed.
+    void buildKernelState()
+    {
+        uint32_t noTasks[] = { 0 };
+        uint32_t idleTasks[] = { IDLE_TCB, 0 };
+        uint32_t runningTasks[] = { RUNNING_TCB, 0 };
+        uint32_t blockedTasks[] = { BLOCKED_TCB, 0 };
+
+        write32(CURRENT_TCB_VAR, RUNNING_TCB);
+        initList(READY_LISTS, idleTasks);
+        initList(READY_LISTS + 20, runningTasks);
+        initList(DELAYED_LIST1, blockedTasks);
+        initList(DELAYED_LIST2, noTasks);
+        initList(SUSPENDED_LIST, noTasks);
+        initTcb(RUNNING_TCB, "main", 1, 0x20000F00);
+        initTcb(BLOCKED_TCB, "net", 3, BLOCKED_STACK);
+        initTcb(IDLE_TCB, "IDLE", 0, IDLE_STACK);
+        initCm3Frame(BLOCKED_STACK, 0x01000000);
+        initCm4fFrame(IDLE_STACK, 0xFFFFFFFD, 0x01000200);
+    }
+
+    void initList(uint32_t list, const uint32_t* pTcbs)
+    {
+        uint32_t listEnd = list + 8;
+        uint32_t prevItem = listEnd;
+        uint32_t count = 0;
+
+        for ( ; *pTcbs ; pTcbs++, count++)
+        {
+            // xStateListItem follows pxTopOfStack in the TCB.
+            uint32_t item = *pTcbs + 4;
+            write32(prevItem + 4, item);
+            write32(item + 12, *pTcbs);
+            prevItem = item;
+        }
+        write32(prevItem + 4, listEnd);
+        write32(list, count);
+    }
+
+    void initTcb(uint32_t tcb, const char* pName, uint32_t priority, uint32_t topOfStack)
+    {
+        write32(tcb, topOfStack);
+        write32(tcb + 44, priority);
+        for (size_t i = 0 ; i <= strlen(pName) ; i++)
+            IMemory_Write8(m_pMemory, tcb + 52 + i, pName[i]);
+    }
+
+    // R4-R11 followed by the hardware stacked R0-R3, R12, LR, PC and XPSR.
+    uint32_t initCm3Frame(uint32_t sp, uint32_t xpsr)
+    {
+        for (uint32_t reg = R4 ; reg <= R11 ; reg++)
+            sp = push(sp, 0x11111111 * (reg - R4 + 4));
+        return initHardwareFrame(sp, xpsr);
+    }
+
+    uint32_t initCm4fFrame(uint32_t sp, uint32_t excReturn, uint32_t xpsr)
+    {
+        for (uint32_t reg = R4 ; reg <= R11 ; reg++)
+            sp = push(sp, 0x40000000 + reg);
+        sp = push(sp, excReturn);
+        if ((excReturn & 0x10) == 0)
+        {
+            for (uint32_t reg = S16 ; reg <= S31 ; reg++)
+                sp = push(sp, 0x3F800000 + reg);
+        }
+        sp = initHardwareFrame(sp, xpsr);
+        if ((excReturn & 0x10) == 0)
+        {
+            for (uint32_t reg = S0 ; reg <= S15 ; reg++)
+                sp = push(sp, 0x3F800000 + reg);
+            sp = push(sp, 0xF95C);
+            sp = push(sp, 0);
+        }
+        return sp;
+    }
+
+    uint32_t initHardwareFrame(uint32_t sp, uint32_t xpsr)
+    {
+        sp = push(sp, 0x00000000);
+        sp = push(sp, 0x01010101);
+        sp = push(sp, 0x02020202);
+        sp = push(sp, 0x03030303);
+        sp = push(sp, 0x0C0C0C0C);
+        sp = push(sp, 0x00000201);
+        sp = push(sp, 0x00000300);
+        return push(sp, xpsr);
+    }
+
+    uint32_t push(uint32_t sp, uint32_t value)
+    {
+        write32(sp, value);
+        return sp + 4;
+    }
+
+    void write32(uint32_t address, uint32_t value)
+    {
+        IMemory_Write32(m_pMemory, address, value);
+    }
+
+    void init()
+    {
+        FreeRtosThreads_Init(&m_threads, m_pMemory, &m_symbols, &m_haltedContext);
+    }
+
+    void validateException(int expectedException, const char* pExpectedMessage)
+    {
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        STRCMP_EQUAL(pExpectedMessage, getExceptionMessage());
+        clearExceptionCode();
+        POINTERS_EQUAL(NULL, m_threads.pThreads);
+        LONGS_EQUAL(0, m_threads.threadCount);
+    }
+};
+
+
+TEST(FreeRtosThreads, ShouldListRunningTaskFirstAndEachTaskOnce)
+{
+    init();
+    LONGS_EQUAL(3, m_threads.threadCount);
+    CHECK_EQUAL(RUNNING_TCB, m_threads.haltedThreadId);
+
+    CHECK_EQUAL(RUNNING_TCB, m_threads.pThreads[0].id);
+    STRCMP_EQUAL("main", m_threads.pThreads[0].name);
+    STRCMP_EQUAL("Running", m_threads.pThreads[0].pState);
+    CHECK_EQUAL(1, m_threads.pThreads[0].priority);
+
+    CHECK_EQUAL(IDLE_TCB, m_threads.pThreads[1].id);
+    STRCMP_EQUAL("IDLE", m_threads.pThreads[1].name);
+    STRCMP_EQUAL("Ready", m_threads.pThreads[1].pState);
+    CHECK_EQUAL(0, m_threads.pThreads[1].priority);
+
+    CHECK_EQUAL(BLOCKED_TCB, m_threads.pThreads[2].id);
+    STRCMP_EQUAL("net", m_threads.pThreads[2].name);
+    STRCMP_EQUAL("Blocked", m_threads.pThreads[2].pState);
+    CHECK_EQUAL(3, m_threads.pThreads[2].priority);
+}
+
+TEST(FreeRtosThreads, Find_ShouldLookupById)
+{
+    init();
+    POINTERS_EQUAL(&m_threads.pThreads[2], FreeRtosThreads_Find(&m_threads, BLOCKED_TCB));
+    POINTERS_EQUAL(NULL, FreeRtosThreads_Find(&m_threads, 0x20000400));
+}
+
+TEST(FreeRtosThreads, RunningTask_ShouldUseHaltedContext)
+{
+    init();
+    MEMCMP_EQUAL(&m_haltedContext, &m_threads.pThreads[0].context, sizeof(m_haltedContext));
+}
+
+TEST(FreeRtosThreads, TaskSwitchedOutByCm3Port_ShouldUnstackIntegerRegisters)
+{
+    init();
+    const RegisterContext* pContext = &m_threads.pThreads[2].context;
+    CHECK_EQUAL(0x00000000, pContext->R[R0]);
+    CHECK_EQUAL(0x03030303, pContext->R[R3]);
+    CHECK_EQUAL(0x44444444, pContext->R[R4]);
+    CHECK_EQUAL(0xBBBBBBBB, pContext->R[R11]);
+    CHECK_EQUAL(0x0C0C0C0C, pContext->R[R12]);
+    CHECK_EQUAL(BLOCKED_STACK + 16 * 4, pContext->R[SP]);
+    CHECK_EQUAL(BLOCKED_STACK + 16 * 4, pContext->R[PSP]);
+    CHECK_EQUAL(m_haltedContext.R[MSP], pContext->R[MSP]);
+    CHECK_EQUAL(0x00000201, pContext->R[LR]);
+    CHECK_EQUAL(0x00000300, pContext->R[PC]);
+    CHECK_EQUAL(0x01000000, pContext->R[XPSR]);
+}
+
+TEST(FreeRtosThreads, TaskSwitchedOutByCm4fPortWithPadding_ShouldSkipExcReturnAndAlignmentWord)
+{
+    init();
+    const RegisterContext* pContext = &m_threads.pThreads[1].context;
+    CHECK_EQUAL(0x40000000 + R4, pContext->R[R4]);
+    CHECK_EQUAL(0x40000000 + R11, pContext->R[R11]);
+    CHECK_EQUAL(0x02020202, pContext->R[R2]);
+    CHECK_EQUAL(0x00000300, pContext->R[PC]);
+    CHECK_EQUAL(IDLE_STACK + 17 * 4 + 4, pContext->R[SP]);
+    CHECK_EQUAL(0, pContext->FPR[S16]);
+}
+
+TEST(FreeRtosThreads, TaskSwitchedOutWithFpuContext_ShouldUnstackFloatingPointRegisters)
+{
+    m_haltedContext.flags = CRASH_CATCHER_FLAGS_FLOATING_POINT;
+    initCm4fFrame(IDLE_STACK, 0xFFFFFFED, 0x01000000);
+    init();
+    const RegisterContext* pContext = &m_threads.pThreads[1].context;
+    CHECK_EQUAL(CRASH_CATCHER_FLAGS_FLOATING_POINT, pContext->flags);
+    CHECK_EQUAL(0x3F800000 + S0, pContext->FPR[S0]);
+    CHECK_EQUAL(0x3F800000 + S15, pContext->FPR[S15]);
+    CHECK_EQUAL(0x3F800000 + S16, pContext->FPR[S16]);
+    CHECK_EQUAL(0x3F800000 + S31, pContext->FPR[S31]);
+    CHECK_EQUAL(0xF95C, pContext->FPR[FPSCR]);
+    CHECK_EQUAL(0x00000300, pContext->R[PC]);
+    CHECK_EQUAL(IDLE_STACK + (9 + 16 + 8 + 18) * 4, pContext->R[SP]);
+}
+
+TEST(FreeRtosThreads, TaskNameFillingWholeBuffer_ShouldBeTerminated)
+{
+    initTcb(BLOCKED_TCB, "0123456789ABCDEFextra", 3, BLOCKED_STACK);
+    init();
+    STRCMP_EQUAL("0123456789ABCDEF", m_threads.pThreads[2].name);
+}
+
+TEST(FreeRtosThreads, TaskWithRecordedStackEnd_ShouldReportStackBounds)
+{
+    write32(BLOCKED_TCB + 48, BLOCKED_STACK - 0x100);
+    write32(BLOCKED_TCB + 68, BLOCKED_STACK + 0xFC);
+    init();
+    CHECK_EQUAL(BLOCKED_STACK - 0x100, m_threads.pThreads[2].stackBase);
+    CHECK_EQUAL(BLOCKED_STACK + 0x100, m_threads.pThreads[2].stackEnd);
+}
+
+TEST(FreeRtosThreads, TaskWithUnalignedStackEnd_ShouldTreatEndAsUnknown)
+{
+    write32(BLOCKED_TCB + 48, BLOCKED_STACK - 0x100);
+    write32(BLOCKED_TCB + 68, 3);
+    init();
+    CHECK_EQUAL(BLOCKED_STACK - 0x100, m_threads.pThreads[2].stackBase);
+    CHECK_EQUAL(0, m_threads.pThreads[2].stackEnd);
+}
+
+TEST(FreeRtosThreads, TaskStackEndBelowTopOfStack_ShouldTreatEndAsUnknown)
+{
+    write32(BLOCKED_TCB + 48, BLOCKED_STACK - 0x100);
+    write32(BLOCKED_TCB + 68, BLOCKED_STACK - 0x80);
+    init();
+    CHECK_EQUAL(0, m_threads.pThreads[2].stackEnd);
+}
+
+TEST(FreeRtosThreads, OptionalListsMissing_ShouldOnlyListReadyTasks)
+{
+    m_symbols.symbolCount = 2;
+    init();
+    LONGS_EQUAL(2, m_threads.threadCount);
+    CHECK_EQUAL(IDLE_TCB, m_threads.pThreads[1].id);
+}
+
+TEST(FreeRtosThreads, MissingCurrentTcbSymbol_ShouldThrow)
+{
+    m_symbolArray[0].pName = "notCurrentTCB";
+    __try_and_catch( init() );
+    validateException(elfFormatException, "ELF doesn't contain the FreeRTOS pxCurrentTCB symbol.");
+}
+
+TEST(FreeRtosThreads, MissingReadyListsSymbol_ShouldThrow)
+{
+    m_symbolArray[1].pName = "notReadyTasksLists";
+    __try_and_catch( init() );
+    validateException(elfFormatException, "ELF doesn't contain the FreeRTOS pxReadyTasksLists symbol.");
+}
+
+TEST(FreeRtosThreads, SchedulerNotStarted_ShouldThrow)
+{
+    write32(CURRENT_TCB_VAR, 0);
+    __try_and_catch( init() );
+    validateException(fileFormatException, "The FreeRTOS scheduler hasn't created any tasks yet.");
+}
+
+TEST(FreeRtosThreads, ListWithCorruptItemCount_ShouldThrow)
+{
+    write32(DELAYED_LIST1, 0xFFFFFFFF);
+    __try_and_catch( init() );
+    validateException(fileFormatException, "FreeRTOS list at 0x20000040 claims to contain 4294967295 tasks. Is it corrupt?");
+}
+
+TEST(FreeRtosThreads, TcbOutsideOfDump_ShouldThrow)
+{
+    // List item in RAM which points to an owning TCB outside of RAM.
+    write32(DELAYED_LIST2, 1);
+    write32(DELAYED_LIST2 + 12, 0x20000A00);
+    write32(0x20000A00 + 4, DELAYED_LIST2 + 8);
+    write32(0x20000A00 + 12, 0x30000000);
+    __try_and_catch( init() );
+    CHECK_EQUAL(busErrorException, getExceptionCode());
+    clearExceptionCode();
+    POINTERS_EQUAL(NULL, m_threads.pThreads);
+}
+
+TEST(FreeRtosThreads, FailAllocation_ShouldThrow)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( init() );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+}
@@ -11,6 +11,9 @@
     GNU General Public License for more details.
 */
 
+#include <string>
+#include <unistd.h>
+
 // Include headers from C modules under test.
 extern "C"
 {
@@ -61,16 +64,14 @@ TEST(GdbLogParser, InvalidLogFilename_ShouldThrowMSPandPSPnotInit)
     m_expectedRegisters.R[PSP] = 0xDEADBEEF;
 }
 
-TEST(GdbLogParser, OneLineLogFile_1RamValue_FailFSeekCall_ShouldThrow)
+TEST(GdbLogParser, OneLineLogFile_1RamValue_FailFSeekCall_ShouldStillParseSinceLogIsNeverRewound)
 {
     static const char* testLines[] = { "0x10000000:\t0x11111111" };
 
     fgetsSetData(testLines, ARRAY_SIZE(testLines));
     fseekSetReturn(-1);
-        __try_and_catch( GdbLogParse(m_pMem, &m_actualRegisters, "foo.log") );
-    CHECK_EQUAL(fileException, getExceptionCode());
-    clearExceptionCode();
-    STRCMP_EQUAL("Failed to rewind GDB log for second pass.", getExceptionMessage());
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMem, 0x10000000));
 }
 
 TEST(GdbLogParser, EmptyLogfile_ShouldReturnNoRegions)
@@ -256,6 +257,130 @@ TEST(GdbLogParser, TwoLineLogFile_8RamValues_ShouldReturnTwo4WordRegions)
     CHECK_EQUAL(0x88888888, IMemory_Read32(m_pMem, 0x2000000c));
 }
 
+TEST(GdbLogParser, LogWithMoreValuesThanInitialRegionBuffer_ShouldGrowBufferAndReturnOneRegion)
+{
+    static const char* xmlForMemory = "<?xml version=\"1.0\"?>"
+                                      "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" \"http://sourceware.org/gdb/gdb-memory-map.dtd\">"
+                                      "<memory-map>"
+                                      "<memory type=\"ram\" start=\"0x10000000\" length=\"0x640\"></memory>"
+                                      "</memory-map>";
+    static char        lineText[100][64];
+    static const char* testLines[100];
+
+    for (uint32_t i = 0 ; i < ARRAY_SIZE(testLines) ; i++)
+    {
+        uint32_t address = 0x10000000 + i * 16;
+        snprintf(lineText[i], sizeof(lineText[i]), "0x%08x:\t0x%08x\t0x%08x\t0x%08x\t0x%08x",
+                 address, address, address + 4, address + 8, address + 12);
+        testLines[i] = lineText[i];
+    }
+
+    fgetsSetData(testLines, ARRAY_SIZE(testLines));
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    const char* pMemoryLayout = MemorySim_GetMemoryMapXML(m_pMem);
+    STRCMP_EQUAL(xmlForMemory, pMemoryLayout);
+    CHECK_EQUAL(0x10000000, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0x10000400, IMemory_Read32(m_pMem, 0x10000400));
+    CHECK_EQUAL(0x1000063C, IMemory_Read32(m_pMem, 0x1000063C));
+}
+
+TEST(GdbLogParser, OneLineLogFile_1RamValueWithTrailingNewLine_ShouldReturn1WordRegion)
+{
+    static const char* testLines[] = { "0x10000000:\t0x11111111\n",
+                                       "0x10000004:\t0x22222222\n" };
+
+    fgetsSetData(testLines, ARRAY_SIZE(testLines));
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0x22222222, IMemory_Read32(m_pMem, 0x10000004));
+    __try_and_catch( IMemory_Read32(m_pMem, 0x10000008) );
+    CHECK_EQUAL(busErrorException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(GdbLogParser, ByteLines_ShouldReturnContiguousRegion)
+{
+    static const char* xmlForMemory = "<?xml version=\"1.0\"?>"
+                                      "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" \"http://sourceware.org/gdb/gdb-memory-map.dtd\">"
+                                      "<memory-map>"
+                                      "<memory type=\"ram\" start=\"0x10000000\" length=\"0xA\"></memory>"
+                                      "</memory-map>";
+    static const char* testLines[] = { "0x10000000 <buffer>:\t0x11\t0x22\t0x33\t0x44\t0x55\t0x66\t0x77\t0x88\n",
+                                       "0x10000008 <buffer+8>:\t0x99\t0xaa\n" };
+
+    fgetsSetData(testLines, ARRAY_SIZE(testLines));
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    STRCMP_EQUAL(xmlForMemory, MemorySim_GetMemoryMapXML(m_pMem));
+    CHECK_EQUAL(0x44332211, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0x88776655, IMemory_Read32(m_pMem, 0x10000004));
+    CHECK_EQUAL(0xAA99, IMemory_Read16(m_pMem, 0x10000008));
+}
+
+TEST(GdbLogParser, HalfWordLines_ShouldReturnLittleEndianRegion)
+{
+    static const char* testLines[] = { "0x10000000:\t0x1122\t0x3344\t0x5566\t0x7788\t0x99aa\t0xbbcc\t0xddee\t0xff00\n" };
+
+    fgetsSetData(testLines, ARRAY_SIZE(testLines));
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    CHECK_EQUAL(0x33441122, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0xFF00DDEE, IMemory_Read32(m_pMem, 0x1000000C));
+}
+
+TEST(GdbLogParser, GiantWordLinesWithSymbolOffsets_ShouldReturnLittleEndianRegion)
+{
+    static const char* xmlForMemory = "<?xml version=\"1.0\"?>"
+                                      "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" \"http://sourceware.org/gdb/gdb-memory-map.dtd\">"
+                                      "<memory-map>"
+                                      "<memory type=\"ram\" start=\"0x10000000\" length=\"0x20\"></memory>"
+                                      "</memory-map>";
+    static const char* testLines[] = { "0x10000000 <g_table>:\t0x1111111122222222\t0x3333333344444444\n",
+                                       "0x10000010 <g_table+16>:\t0x5555555566666666\t0x7777777788888888\n" };
+
+    fgetsSetData(testLines, ARRAY_SIZE(testLines));
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    STRCMP_EQUAL(xmlForMemory, MemorySim_GetMemoryMapXML(m_pMem));
+    CHECK_EQUAL(0x22222222, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMem, 0x10000004));
+    CHECK_EQUAL(0x44444444, IMemory_Read32(m_pMem, 0x10000008));
+    CHECK_EQUAL(0x77777777, IMemory_Read32(m_pMem, 0x1000001C));
+}
+
+TEST(GdbLogParser, WordLineWithMoreThan4Values_ShouldParseAllValues)
+{
+    static const char* testLines[] = { "0x10000000:\t0x11111111\t0x22222222\t0x33333333\t0x44444444\t0x55555555\t0x66666666" };
+
+    fgetsSetData(testLines, ARRAY_SIZE(testLines));
+        GdbLogParse(m_pMem, &m_actualRegisters, "foo.log");
+    CHECK_EQUAL(0x55555555, IMemory_Read32(m_pMem, 0x10000010));
+    CHECK_EQUAL(0x66666666, IMemory_Read32(m_pMem, 0x10000014));
+}
+
+TEST(GdbLogParser, LineLongerThanInitialLineBuffer_ShouldNotBeSplit)
+{
+    std::string line = "0x10000000:";
+    DumpStream  stream;
+    int         fds[2];
+    char        value[16];
+
+    for (uint32_t i = 0 ; i < 512 ; i++)
+    {
+        snprintf(value, sizeof(value), "\t0x%02x", i & 0xFF);
+        line += value;
+    }
+    line += "\n";
+    CHECK_EQUAL(0, pipe(fds));
+    CHECK_EQUAL((ssize_t)line.length(), write(fds[1], line.c_str(), line.length()));
+    close(fds[1]);
+    DumpStream_Init(&stream, fdopen(fds[0], "r"));
+        GdbLogParse_FromStream(m_pMem, &m_actualRegisters, &stream);
+    DumpStream_Close(&stream);
+    CHECK_EQUAL(0x03020100, IMemory_Read32(m_pMem, 0x10000000));
+    CHECK_EQUAL(0xFFFEFDFC, IMemory_Read32(m_pMem, 0x100001FC));
+    __try_and_catch( IMemory_Read32(m_pMem, 0x10000200) );
+    CHECK_EQUAL(busErrorException, getExceptionCode());
+    clearExceptionCode();
+}
+
 TEST(GdbLogParser, FailMemoryAllocationForRegion_ShouldThrow)
 {
     static const char* xmlForMemory = "<?xml version=\"1.0\"?>"
@@ -0,0 +1,294 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <HeapWalk.h>
+    #include <MemorySim.h>
+    #include <printfSpy.h>
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include <CppUTest/TestHarness.h>
+
+
+#define MALLOC_AV       0x20000000
+#define SBRK_BASE_VAR   0x20000800
+#define HEAP_BASE       0x20001000
+#define HEAP_SIZE       0x200
+#define BIN_ADDRESS     (MALLOC_AV + 0x30)
+
+// Chunks laid out by buildHeap() relative to the start of the heap.
+#define CHUNK_A         0x000
+#define CHUNK_B         0x020
+#define CHUNK_C         0x050
+#define CHUNK_TOP       0x090
+
+TEST_GROUP(HeapWalk)
+{
+    IMemory*       m_pMemory;
+    HeapWalkResult m_result;
+    uint32_t       m_heapStart;
+
+    void setup()
+    {
+        memset(&m_result, 0, sizeof(m_result));
+        m_pMemory = MemorySim_Init();
+        MemorySim_CreateRegion(m_pMemory, MALLOC_AV, 0x1000);
+        MemorySim_CreateRegion(m_pMemory, HEAP_BASE, HEAP_SIZE);
+        printfSpy_Hook(512);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        printfSpy_Unhook();
+        MemorySim_Uninit(m_pMemory);
+    }
+
+    // Used chunk A, free chunk B linked into a bin, used chunk C and then the top chunk.
+    void buildHeap(uint32_t heapStart)
+    {
+        m_heapStart = heapStart;
+        IMemory_Write32(m_pMemory, SBRK_BASE_VAR, heapStart);
+        IMemory_Write32(m_pMemory, MALLOC_AV + 8, heapStart + CHUNK_TOP);
+
+        writeSize(CHUNK_A, 0x21);
+        writeSize(CHUNK_B, 0x31);
+        writeField(CHUNK_B, 8, BIN_ADDRESS);
+        writeField(CHUNK_B, 12, BIN_ADDRESS);
+        IMemory_Write32(m_pMemory, BIN_ADDRESS + 8, heapStart + CHUNK_B);
+        IMemory_Write32(m_pMemory, BIN_ADDRESS + 12, heapStart + CHUNK_B);
+        writeField(CHUNK_C, 0, 0x30);
+        writeSize(CHUNK_C, 0x40);
+        writeSize(CHUNK_TOP, (HEAP_BASE + HEAP_SIZE - heapStart - CHUNK_TOP) | 1);
+    }
+
+    void writeSize(uint32_t chunkOffset, uint32_t size)
+    {
+        writeField(chunkOffset, 4, size);
+    }
+
+    void writeField(uint32_t chunkOffset, uint32_t fieldOffset, uint32_t value)
+    {
+        IMemory_Write32(m_pMemory, m_heapStart + chunkOffset + fieldOffset, value);
+    }
+
+    void walk()
+    {
+        m_result = HeapWalk_Dlmalloc(m_pMemory, MALLOC_AV, m_heapStart);
+    }
+
+    void validateCorruption(uint32_t chunkOffset, const char* pExpectedMessage)
+    {
+        CHECK_TRUE(m_result.isCorrupt);
+        CHECK_EQUAL(m_heapStart + chunkOffset, m_result.corruptChunk);
+        STRCMP_EQUAL(pExpectedMessage, m_result.corruption);
+    }
+};
+
+
+TEST(HeapWalk, ValidHeap_ShouldCountUsedAndFreeChunks)
+{
+    buildHeap(HEAP_BASE);
+    walk();
+    CHECK_FALSE(m_result.isCorrupt);
+    CHECK_EQUAL(HEAP_BASE, m_result.heapStart);
+    CHECK_EQUAL(HEAP_BASE + HEAP_SIZE, m_result.heapEnd);
+    CHECK_EQUAL(2, m_result.usedChunks);
+    CHECK_EQUAL(0x60, m_result.usedBytes);
+    CHECK_EQUAL(2, m_result.freeChunks);
+    CHECK_EQUAL(0x1A0, m_result.freeBytes);
+    CHECK_EQUAL(0x170, m_result.topSize);
+    CHECK_EQUAL(0x170, m_result.largestFreeBlock);
+}
+
+TEST(HeapWalk, MisalignedSbrkBase_ShouldStartAtFirstAlignedChunk)
+{
+    IMemory_Write32(m_pMemory, HEAP_BASE + 0x08 + 4, 0x21);
+    IMemory_Write32(m_pMemory, HEAP_BASE + 0x28 + 4, 0x1D9);
+    IMemory_Write32(m_pMemory, MALLOC_AV + 8, HEAP_BASE + 0x28);
+    m_result = HeapWalk_Dlmalloc(m_pMemory, MALLOC_AV, HEAP_BASE + 4);
+    CHECK_FALSE(m_result.isCorrupt);
+    CHECK_EQUAL(HEAP_BASE + 0x08, m_result.heapStart);
+    CHECK_EQUAL(1, m_result.usedChunks);
+    CHECK_EQUAL(0x20, m_result.usedBytes);
+    CHECK_EQUAL(1, m_result.freeChunks);
+    CHECK_EQUAL(0x1D8, m_result.freeBytes);
+}
+
+TEST(HeapWalk, PrintReport_ShouldIncludeFragmentation)
+{
+    buildHeap(HEAP_BASE);
+    walk();
+    HeapWalk_PrintReport(&m_result);
+    STRCMP_EQUAL("Heap: 0x20001000 - 0x20001200 (512 bytes)\n"
+                 "  Used chunks:        2 (96 bytes)\n"
+                 "  Free chunks:        2 (416 bytes, including 368 byte top chunk)\n"
+                 "  Largest free block: 368 bytes\n"
+                 "  Fragmentation:      12%\n",
+                 printfSpy_GetLastOutput());
+}
+
+TEST(HeapWalk, PrintCorruptReport_ShouldAppendCorruptionLine)
+{
+    buildHeap(HEAP_BASE);
+    writeSize(CHUNK_A, 0x1);
+    walk();
+    HeapWalk_PrintReport(&m_result);
+    STRCMP_EQUAL("CORRUPT: Heap walk stopped at chunk 0x20001000. Chunk has invalid size of 0x1.\n",
+                 printfSpy_GetLastOutput());
+}
+
+TEST(HeapWalk, MallocNeverCalled_ShouldThrow)
+{
+    buildHeap(HEAP_BASE);
+    IMemory_Write32(m_pMemory, MALLOC_AV + 8, MALLOC_AV);
+    __try_and_catch( walk() );
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    STRCMP_EQUAL("The heap is empty since malloc() was never called.", getExceptionMessage());
+    clearExceptionCode();
+}
+
+TEST(HeapWalk, SbrkBaseNeverSet_ShouldThrow)
+{
+    buildHeap(HEAP_BASE);
+    __try_and_catch( m_result = HeapWalk_Dlmalloc(m_pMemory, MALLOC_AV, 0xFFFFFFFF) );
+    CHECK_EQUAL(fileFormatException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(HeapWalk, TopChunkNotInDump_ShouldThrow)
+{
+    buildHeap(HEAP_BASE);
+    IMemory_Write32(m_pMemory, MALLOC_AV + 8, 0x30000000);
+    __try_and_catch( walk() );
+    CHECK_EQUAL(busErrorException, getExceptionCode());
+    STRCMP_EQUAL("Failed to read malloc state at 0x30000004. Does the dump contain all of RAM?", getExceptionMessage());
+    clearExceptionCode();
+}
+
+TEST(HeapWalk, TopChunkBelowHeapStart_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    m_result = HeapWalk_Dlmalloc(m_pMemory, MALLOC_AV, HEAP_BASE + 0x100);
+    CHECK_TRUE(m_result.isCorrupt);
+    CHECK_EQUAL(HEAP_BASE + CHUNK_TOP, m_result.corruptChunk);
+    STRCMP_EQUAL("Top chunk is below the start of the heap at 0x20001100.", m_result.corruption);
+}
+
+TEST(HeapWalk, FirstChunkWithoutPrevInUse_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    writeSize(CHUNK_A, 0x20);
+    walk();
+    validateCorruption(CHUNK_A, "First chunk doesn't have its PREV_INUSE bit set.");
+}
+
+TEST(HeapWalk, ChunkSizeNotMultipleOf8_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    writeSize(CHUNK_A, 0x25);
+    walk();
+    validateCorruption(CHUNK_A, "Chunk has invalid size of 0x25.");
+}
+
+TEST(HeapWalk, ChunkSizePastTop_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    writeSize(CHUNK_C, 0x1000);
+    walk();
+    validateCorruption(CHUNK_C, "Chunk size of 0x1000 runs past the top chunk at 0x20001090.");
+    CHECK_EQUAL(1, m_result.usedChunks);
+    CHECK_EQUAL(1, m_result.freeChunks);
+}
+
+TEST(HeapWalk, FreeChunkWithMismatchedPrevSize_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    writeField(CHUNK_C, 0, 0x28);
+    walk();
+    validateCorruption(CHUNK_B, "Free chunk of size 0x30 doesn't match next chunk's prev_size of 0x28.");
+}
+
+TEST(HeapWalk, FreeChunkWithWildForwardPointer_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    writeField(CHUNK_B, 8, 0xDEADBEEF);
+    walk();
+    validateCorruption(CHUNK_B, "Free chunk has invalid fd/bk pointers of 0xDEADBEEF/0x20000030.");
+}
+
+TEST(HeapWalk, FreeChunkWithBrokenBackLink_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    IMemory_Write32(m_pMemory, BIN_ADDRESS + 12, BIN_ADDRESS);
+    walk();
+    validateCorruption(CHUNK_B, "Free chunk's fd->bk points to 0x20000030 instead of back to it.");
+}
+
+TEST(HeapWalk, AdjacentFreeChunks_ShouldReportCorruption)
+{
+    buildHeap(HEAP_BASE);
+    writeSize(CHUNK_TOP, 0x170);
+    walk();
+    validateCorruption(CHUNK_C, "Free chunk follows another free chunk without being coalesced.");
+}
+
+TEST(HeapWalk, FromSymbols_ShouldReadSbrkBaseFromGlobal)
+{
+    ElfSymbol  symbolArray[2] = { { "__malloc_av_", MALLOC_AV, 0x408 }, { "__malloc_sbrk_base", SBRK_BASE_VAR, 4 } };
+    ElfSymbols symbols = { symbolArray, NULL, 2 };
+
+    buildHeap(HEAP_BASE);
+    m_result = HeapWalk_FromSymbols(m_pMemory, &symbols);
+    CHECK_FALSE(m_result.isCorrupt);
+    CHECK_EQUAL(HEAP_BASE, m_result.heapStart);
+    CHECK_EQUAL(2, m_result.usedChunks);
+}
+
+TEST(HeapWalk, FromSymbolsWithoutMallocState_ShouldThrow)
+{
+    ElfSymbol  symbolArray[1] = { { "__malloc_sbrk_base", SBRK_BASE_VAR, 4 } };
+    ElfSymbols symbols = { symbolArray, NULL, 1 };
+
+    __try_and_catch( m_result = HeapWalk_FromSymbols(m_pMemory, &symbols) );
+    CHECK_EQUAL(elfFormatException, getExceptionCode());
+    STRCMP_EQUAL("ELF doesn't contain the __malloc_av_ symbol used by newlib's malloc.", getExceptionMessage());
+    clearExceptionCode();
+}
+
+TEST(HeapWalk, FromSymbolsWithoutSbrkBase_ShouldFallBackToEndOfBss)
+{
+    ElfSymbol  symbolArray[2] = { { "__malloc_av_", MALLOC_AV, 0x408 }, { "__end__", HEAP_BASE, 0 } };
+    ElfSymbols symbols = { symbolArray, NULL, 2 };
+
+    buildHeap(HEAP_BASE);
+    m_result = HeapWalk_FromSymbols(m_pMemory, &symbols);
+    CHECK_FALSE(m_result.isCorrupt);
+    CHECK_EQUAL(HEAP_BASE, m_result.heapStart);
+}
+
+TEST(HeapWalk, FromSymbolsWithoutHeapStart_ShouldThrow)
+{
+    ElfSymbol  symbolArray[1] = { { "__malloc_av_", MALLOC_AV, 0x408 } };
+    ElfSymbols symbols = { symbolArray, NULL, 1 };
+
+    __try_and_catch( m_result = HeapWalk_FromSymbols(m_pMemory, &symbols) );
+    CHECK_EQUAL(elfFormatException, getExceptionCode());
+    STRCMP_EQUAL("ELF doesn't contain the __malloc_sbrk_base or end symbols needed to find the heap.", getExceptionMessage());
+    clearExceptionCode();
+}
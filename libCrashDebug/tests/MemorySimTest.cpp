@@ -13,21 +13,56 @@
 // Include headers from C modules under test.
 extern "C"
 {
+    #include <Arena.h>
     #include <MemorySim.h>
     #include <MallocFailureInject.h>
 }
 
+#include <stdio.h>
+#include <string.h>
+
 // Include C++ headers for test harness.
 #include "CppUTest/TestHarness.h"
 
 
+// Loader for lazy regions which fills each byte with its offset from sourceOffset.
+struct TestLoader
+{
+    MemorySimLoader loader;
+    uint32_t        loadCount;
+    uint32_t        releaseCount;
+    int             exceptionToThrow;
+};
+
+static void testLoad(MemorySimLoader* pLoader, uint32_t sourceOffset, void* pDest, uint32_t size)
+{
+    TestLoader* pThis = (TestLoader*)pLoader;
+    uint8_t*    pCurr = (uint8_t*)pDest;
+
+    pThis->loadCount++;
+    if (pThis->exceptionToThrow)
+        __throw(pThis->exceptionToThrow);
+    for (uint32_t i = 0 ; i < size ; i++)
+        *pCurr++ = (uint8_t)(sourceOffset + i);
+}
+
+static void testRelease(MemorySimLoader* pLoader)
+{
+    ((TestLoader*)pLoader)->releaseCount++;
+}
+
+
 TEST_GROUP(MemorySim)
 {
-    IMemory* m_pMemory;
+    IMemory*   m_pMemory;
+    TestLoader m_loader;
 
     void setup()
     {
         m_pMemory = MemorySim_Init();
+        memset(&m_loader, 0, sizeof(m_loader));
+        m_loader.loader.load = testLoad;
+        m_loader.loader.release = testRelease;
     }
 
     void teardown()
@@ -37,7 +72,7 @@ TEST_GROUP(MemorySim)
         MemorySim_Uninit(m_pMemory);
         MallocFailureInject_Restore();
     }
-
+
     void validateExceptionThrown(int expectedExceptionCode)
     {
         CHECK_EQUAL(expectedExceptionCode, getExceptionCode());
@@ -73,10 +108,9 @@ TEST(MemorySim, NoMemoryRegionsSetupShouldResultInAllReadsAndWritesThrowing)
 
 TEST(MemorySim, ShouldThrowIfOutOfMemory)
 {
-    // Each region has two allocations.
-    // 1. The MemoryRegion structure which describes the region.
-    // 2. The array of bytes used to simulate the memory.
-    static const size_t allocationsToFail = 2;
+    // The MemoryRegion structure and the small array of bytes used to simulate the memory both come from the first
+    // block allocated for the session's arena.
+    static const size_t allocationsToFail = 1;
     size_t volatile     i;
 
     for (i = 1 ; i <= allocationsToFail ; i++)
@@ -329,12 +363,9 @@ TEST(MemorySim, CreateRegionsBasedOnFlashImage_NonWordSizedFlash)
 
 TEST(MemorySim, CreateRegionsFromFlashImage_ShouldThrowIfOutOfMemory)
 {
-    // Each region has two allocations:
-    // 1. The MemoryRegion structure which describes the region.
-    // 2. The array of bytes used to simulate the memory.
-    // The FLASH region has an additional allocation for the read count array.
-    // This API creates two regions (FLASH and RAM) so there are a total of 3 + 2 = 5 allocations.
-    static const size_t allocationsToFail = 5;
+    // This API creates two small regions (FLASH and RAM) along with a read count array for the FLASH region.  They
+    // all fit in the first block allocated for the session's arena.
+    static const size_t allocationsToFail = 1;
     uint32_t            flashBinary[2] = { 0x10000004, 0x00000200 };
     size_t volatile     i;
 
@@ -353,13 +384,10 @@ TEST(MemorySim, CreateRegionsFromFlashImage_MakeSureItHandlesOutOfMemoryWhenTher
     MemorySim_CreateRegion(m_pMemory, 0xF0000000, 4);
     IMemory_Write32(m_pMemory, 0xF0000000, 0x12345678);
 
-    // Each region has two allocations:
-    // 1. The MemoryRegion structure which describes the region.
-    // 2. The array of bytes used to simulate the memory.
-    // The FLASH region has an additional allocation for the read count array.
-    // This API creates two regions (FLASH and RAM) so there are a total of 3 + 2 = 5 allocations.
-    static const size_t allocationsToFail = 5;
-    uint32_t            flashBinary[2] = { 0x10000004, 0x00000200 };
+    // The FLASH region and its read count array fit in the arena block already allocated for the existing region but
+    // the 1MB RAM region is large enough to require a block of its own.
+    static const size_t allocationsToFail = 1;
+    uint32_t            flashBinary[2] = { 0x10100000, 0x00000200 };
     size_t volatile     i;
 
     for (i = 1 ; i <= allocationsToFail ; i++)
@@ -369,8 +397,9 @@ TEST(MemorySim, CreateRegionsFromFlashImage_MakeSureItHandlesOutOfMemoryWhenTher
         validateExceptionThrown(outOfMemoryException);
     }
 
-    // The manually created region should still be valid.
+    // The manually created region should still be valid and the FLASH region should have been removed.
     CHECK_EQUAL(0x12345678, IMemory_Read32(m_pMemory, 0xF0000000));
+    CHECK_EQUAL(1, MemorySim_GetRegionCount(m_pMemory));
 }
 
 TEST(MemorySim, CreateRegionsBasedOnFlashImage_ShouldThrowIfNotBigEnoughForInitialStackPointer)
@@ -396,21 +425,14 @@ TEST(MemorySim, AttemptToClearBreakpointAtInvalidAddress_ShouldThrow)
     validateExceptionThrown(busErrorException);
 }
 
-TEST(MemorySim, SetBreakpointShouldThrowIfOutOfMemory)
+TEST(MemorySim, SetBreakpoint_ShouldAllocateFromSessionArenaWithoutCallingMalloc)
 {
-    static const size_t allocationsToFail = 1;
-    uint32_t            testBase = 0x00000000;
-    size_t              i;
+    uint32_t testBase = 0x00000000;
 
     MemorySim_CreateRegion(m_pMemory, testBase, 3 * sizeof(uint16_t));
-    for (i = 1 ; i <= allocationsToFail ; i++)
-    {
-        MallocFailureInject_FailAllocation(i);
-        __try_and_catch( MemorySim_SetHardwareBreakpoint(m_pMemory, testBase, sizeof(uint16_t)) );
-        validateExceptionThrown(outOfMemoryException);
-    }
-    MallocFailureInject_FailAllocation(i);
+    MallocFailureInject_FailAllocation(1);
     MemorySim_SetHardwareBreakpoint(m_pMemory, testBase, sizeof(uint16_t));
+    MemorySim_SetHardwareBreakpoint(m_pMemory, testBase + sizeof(uint16_t), sizeof(uint16_t));
 }
 
 TEST(MemorySim, SetAndClear2ByteHardwareBreakpoint_IssueReadsWhichHitAndMissBreakpoint)
@@ -632,21 +654,28 @@ TEST(MemorySim, AttemptToClearWatchpointAtInvalidAddress_ShouldThrow)
     validateExceptionThrown(busErrorException);
 }
 
-TEST(MemorySim, SetWatchpointShouldThrowIfOutOfMemory)
+TEST(MemorySim, SetWatchpoint_ShouldAllocateFromSessionArenaWithoutCallingMalloc)
 {
-    static const size_t allocationsToFail = 1;
-    uint32_t            testBase = 0x00000000;
-    size_t              i;
+    uint32_t testBase = 0x00000000;
 
     MemorySim_CreateRegion(m_pMemory, testBase, 3 * sizeof(uint16_t));
-    for (i = 1 ; i <= allocationsToFail ; i++)
+    MallocFailureInject_FailAllocation(1);
+    MemorySim_SetHardwareWatchpoint(m_pMemory, testBase, sizeof(uint16_t), WATCHPOINT_READ);
+}
+
+TEST(MemorySim, SetManyWatchpoints_ShouldGrowArrayAndKeepEarlierOnes)
+{
+    uint32_t testBase = 0x00000000;
+    uint32_t i;
+
+    MemorySim_CreateRegion(m_pMemory, testBase, 64);
+    for (i = 0 ; i < 64 ; i += 2)
+        MemorySim_SetHardwareWatchpoint(m_pMemory, testBase + i, sizeof(uint16_t), WATCHPOINT_READ);
+    for (i = 0 ; i < 64 ; i += 2)
     {
-        MallocFailureInject_FailAllocation(i);
-        __try_and_catch( MemorySim_SetHardwareWatchpoint(m_pMemory, testBase, sizeof(uint16_t), WATCHPOINT_READ) );
-        validateExceptionThrown(outOfMemoryException);
+        IMemory_Read16(m_pMemory, testBase + i);
+        CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
     }
-    MallocFailureInject_FailAllocation(i);
-    MemorySim_SetHardwareWatchpoint(m_pMemory, testBase, sizeof(uint16_t), WATCHPOINT_READ);
 }
 
 TEST(MemorySim, SetAndClear2ByteHardwareWatchpoint_IssueReadsWhichHitAndMissWatchpoint)
@@ -1175,6 +1204,28 @@ TEST(MemorySim, MapSimulatedAddressForWrite_MapValidAddressRegionAndAliases)
     CHECK_EQUAL(pvHostAddress1, pvHostAddress2);
 }
 
+TEST(MemorySim, MakeRegionReadOnly_ShouldDeferReadCountAllocationToFirstFetch)
+{
+    static const uint32_t testAddress = 0x00000000;
+    uint16_t              value = 0;
+    MemorySim_CreateRegion(m_pMemory, testAddress, 1024 * 1024);
+    MallocFailureInject_FailAllocation(1);
+    MemorySim_MakeRegionReadOnly(m_pMemory, testAddress);
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(m_pMemory, testAddress));
+    CHECK_EQUAL(0, IMemory_Read32(m_pMemory, testAddress));
+
+    MallocFailureInject_FailAllocation(1);
+    CHECK_FALSE(IMemory_TryRead16(m_pMemory, testAddress, &value));
+    CHECK_EQUAL(noException, getExceptionCode());
+    MallocFailureInject_FailAllocation(1);
+        __try_and_catch( IMemory_Read16(m_pMemory, testAddress) );
+        validateExceptionThrown(outOfMemoryException);
+
+    MallocFailureInject_Restore();
+    IMemory_Read16(m_pMemory, testAddress);
+    CHECK_EQUAL(1, MemorySim_GetFlashReadCount(m_pMemory, testAddress));
+}
+
 TEST(MemorySim, GetReadCount_CheckFlashRegionWithOneAliasReads_ShouldReadCountOfOne)
 {
     static const uint32_t testAddress = 0x00000000;
@@ -1195,3 +1246,591 @@ TEST(MemorySim, AttemptToAliasNonExistentRegion_ShouldThrow)
     __try_and_catch( MemorySim_CreateAlias(m_pMemory, aliasAddress, testAddress + 4, 4) );
     validateExceptionThrown(busErrorException);
 }
+
+TEST(MemorySim, CreateRegionFromHostBuffer_ShouldReadAndWriteCallerBuffer)
+{
+    static const uint32_t testAddress = 0x00000004;
+    uint32_t              hostBuffer[2] = { 0x11111111, 0x22222222 };
+    MemorySim_CreateRegionFromHostBuffer(m_pMemory, testAddress, hostBuffer, sizeof(hostBuffer));
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMemory, testAddress));
+    CHECK_EQUAL(0x22222222, IMemory_Read32(m_pMemory, testAddress + 4));
+    IMemory_Write32(m_pMemory, testAddress + 4, 0x33333333);
+    CHECK_EQUAL(0x33333333, hostBuffer[1]);
+}
+
+TEST(MemorySim, CreateRegionFromHostBuffer_MakeReadOnly_ShouldThrowOnWriteAndCountReads)
+{
+    static const uint32_t testAddress = 0x00000000;
+    uint32_t              hostBuffer[1] = { 0x11111111 };
+    MemorySim_CreateRegionFromHostBuffer(m_pMemory, testAddress, hostBuffer, sizeof(hostBuffer));
+    MemorySim_MakeRegionReadOnly(m_pMemory, testAddress);
+    __try_and_catch( IMemory_Write32(m_pMemory, testAddress, 0x22222222) );
+    validateExceptionThrown(busErrorException);
+    CHECK_EQUAL(0x1111, IMemory_Read16(m_pMemory, testAddress));
+    CHECK_EQUAL(1, MemorySim_GetFlashReadCount(m_pMemory, testAddress));
+    CHECK_EQUAL(0x11111111, hostBuffer[0]);
+}
+
+TEST(MemorySim, CreateRegionFromHostBuffer_ShouldThrowIfOutOfMemory)
+{
+    uint32_t hostBuffer[1] = { 0x11111111 };
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( MemorySim_CreateRegionFromHostBuffer(m_pMemory, 0x00000000, hostBuffer, sizeof(hostBuffer)) );
+    validateExceptionThrown(outOfMemoryException);
+    CHECK_EQUAL(0, MemorySim_GetRegionCount(m_pMemory));
+}
+
+TEST(MemorySim, GetRegionCount_NoRegions_ShouldReturnZero)
+{
+    CHECK_EQUAL(0, MemorySim_GetRegionCount(m_pMemory));
+}
+
+TEST(MemorySim, GetRegionInfo_RegionReadOnlyRegionAndAlias_ShouldReturnEachInCreationOrder)
+{
+    uint32_t flashBinary[2] = { 0x10008000, 0x00000200 };
+    MemorySim_CreateRegionsFromFlashImage(m_pMemory, flashBinary, sizeof(flashBinary));
+    MemorySim_CreateAlias(m_pMemory, 0xA0000000, 0x00000000, 8);
+    CHECK_EQUAL(3, MemorySim_GetRegionCount(m_pMemory));
+
+    MemoryRegionInfo info = MemorySim_GetRegionInfo(m_pMemory, 0);
+    CHECK_EQUAL(0x00000000, info.baseAddress);
+    CHECK_EQUAL(8, info.size);
+    CHECK_TRUE(info.isReadOnly);
+    CHECK_FALSE(info.isAlias);
+    CHECK_EQUAL(0, memcmp(info.pData, flashBinary, sizeof(flashBinary)));
+
+    info = MemorySim_GetRegionInfo(m_pMemory, 1);
+    CHECK_EQUAL(0x10000000, info.baseAddress);
+    CHECK_EQUAL(0x8000, info.size);
+    CHECK_FALSE(info.isReadOnly);
+    CHECK_FALSE(info.isAlias);
+    CHECK(info.pData != NULL);
+
+    info = MemorySim_GetRegionInfo(m_pMemory, 2);
+    CHECK_EQUAL(0xA0000000, info.baseAddress);
+    CHECK_TRUE(info.isAlias);
+    POINTERS_EQUAL(NULL, info.pData);
+}
+
+TEST(MemorySim, GetRegionInfo_IndexPastLastRegion_ShouldThrow)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    __try_and_catch( MemorySim_GetRegionInfo(m_pMemory, 1) );
+    validateExceptionThrown(bufferOverrunException);
+}
+
+TEST(MemorySim, FindReadOnlyRegion_ShouldOnlyMatchReadOnlyRegionsAndTheirAliases)
+{
+    uint32_t flashBinary[2] = { 0x10008000, 0x00000200 };
+    uint32_t baseAddress = 0;
+    uint32_t size = 0;
+    MemorySim_CreateRegionsFromFlashImage(m_pMemory, flashBinary, sizeof(flashBinary));
+    MemorySim_CreateAlias(m_pMemory, 0xA0000000, 0x00000000, 8);
+
+    CHECK_TRUE(MemorySim_FindReadOnlyRegion(m_pMemory, 0x00000006, &baseAddress, &size));
+    CHECK_EQUAL(0x00000000, baseAddress);
+    CHECK_EQUAL(8, size);
+    CHECK_TRUE(MemorySim_FindReadOnlyRegion(m_pMemory, 0xA0000004, &baseAddress, &size));
+    CHECK_EQUAL(0xA0000000, baseAddress);
+    CHECK_EQUAL(8, size);
+    CHECK_FALSE(MemorySim_FindReadOnlyRegion(m_pMemory, 0x00000008, &baseAddress, &size));
+    CHECK_FALSE(MemorySim_FindReadOnlyRegion(m_pMemory, 0x10000000, &baseAddress, &size));
+}
+
+TEST(MemorySim, FindReadOnlyRegion_ShouldNotLoadLazyRegions)
+{
+    uint32_t baseAddress = 0;
+    uint32_t size = 0;
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00);
+    CHECK_FALSE(MemorySim_FindReadOnlyRegion(m_pMemory, 0x10000000, &baseAddress, &size));
+    CHECK_EQUAL(0, m_loader.loadCount);
+}
+
+TEST(MemorySim, FindNextMappedAddress_ShouldReturnAddressItselfOrLowestRegionAboveIt)
+{
+    uint32_t nextAddress = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x20000000, 4);
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+
+    CHECK_TRUE(MemorySim_FindNextMappedAddress(m_pMemory, 0x10000002, &nextAddress));
+    CHECK_EQUAL(0x10000002, nextAddress);
+    CHECK_TRUE(MemorySim_FindNextMappedAddress(m_pMemory, 0x00000000, &nextAddress));
+    CHECK_EQUAL(0x10000000, nextAddress);
+    CHECK_TRUE(MemorySim_FindNextMappedAddress(m_pMemory, 0x10000004, &nextAddress));
+    CHECK_EQUAL(0x20000000, nextAddress);
+    CHECK_FALSE(MemorySim_FindNextMappedAddress(m_pMemory, 0x20000004, &nextAddress));
+}
+
+TEST(MemorySim, ShareReadOnlyRegions_ShouldReferenceSourceDataForReadOnlyNonAliasRegionsOnly)
+{
+    uint32_t flashBinary[2] = { 0x10008000, 0x00000200 };
+    IMemory* pOther = MemorySim_Create();
+    MemorySim_CreateRegionsFromFlashImage(m_pMemory, flashBinary, sizeof(flashBinary));
+    MemorySim_CreateAlias(m_pMemory, 0xA0000000, 0x00000000, 8);
+
+    MemorySim_ShareReadOnlyRegions(pOther, m_pMemory);
+    CHECK_EQUAL(1, MemorySim_GetRegionCount(pOther));
+    MemoryRegionInfo info = MemorySim_GetRegionInfo(pOther, 0);
+    CHECK_EQUAL(0x00000000, info.baseAddress);
+    CHECK_EQUAL(8, info.size);
+    CHECK_TRUE(info.isReadOnly);
+    POINTERS_EQUAL(MemorySim_GetRegionInfo(m_pMemory, 0).pData, info.pData);
+    CHECK_EQUAL(0x00000200, IMemory_Read32(pOther, 0x00000004));
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(pOther, 0x00000004));
+    __try_and_catch( IMemory_Write32(pOther, 0x00000004, 0) );
+    validateExceptionThrown(busErrorException);
+    MemorySim_Destroy(pOther);
+}
+
+TEST(MemorySim, ShareReadOnlyRegions_ShouldLoadLazySourceRegionsFirst)
+{
+    IMemory* pOther = MemorySim_Create();
+    MemorySim_CreateLazyRegion(m_pMemory, 0x00000000, 4, &m_loader.loader, 0x00);
+    MemorySim_MakeRegionReadOnly(m_pMemory, 0x00000000);
+
+    MemorySim_ShareReadOnlyRegions(pOther, m_pMemory);
+    CHECK_EQUAL(1, m_loader.loadCount);
+    CHECK_EQUAL(1, MemorySim_GetRegionCount(pOther));
+    POINTERS_EQUAL(MemorySim_GetRegionInfo(m_pMemory, 0).pData, MemorySim_GetRegionInfo(pOther, 0).pData);
+    MemorySim_Destroy(pOther);
+}
+
+TEST(MemorySim, Create_ShouldReturnInstanceIndependentOfInit)
+{
+    IMemory* pOther = MemorySim_Create();
+    CHECK(pOther != m_pMemory);
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    MemorySim_CreateRegion(pOther, 0x10000000, 4);
+    IMemory_Write32(m_pMemory, 0x00000000, 0x11111111);
+    IMemory_Write32(pOther, 0x10000000, 0x22222222);
+    CHECK_EQUAL(1, MemorySim_GetRegionCount(m_pMemory));
+    CHECK_EQUAL(1, MemorySim_GetRegionCount(pOther));
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMemory, 0x00000000));
+    CHECK_EQUAL(0x22222222, IMemory_Read32(pOther, 0x10000000));
+    __try_and_catch( IMemory_Read32(pOther, 0x00000000) );
+    validateExceptionThrown(busErrorException);
+    MemorySim_Destroy(pOther);
+}
+
+TEST(MemorySim, Create_ShouldThrowIfOutOfMemory)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( MemorySim_Create() );
+    validateExceptionThrown(outOfMemoryException);
+}
+
+TEST(MemorySim, Destroy_ShouldHandleNULLPointer)
+{
+    MemorySim_Destroy(NULL);
+}
+
+TEST(MemorySim, CreateLazyRegion_ShouldNotLoadUntilFirstAccess)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 8, &m_loader.loader, 0x10);
+    CHECK_EQUAL(1, m_loader.loader.refCount);
+    MemorySim_GetMemoryMapXML(m_pMemory);
+    MemorySim_SetHardwareWatchpoint(m_pMemory, 0x10000000, 4, WATCHPOINT_WRITE);
+    CHECK_EQUAL(0, m_loader.loadCount);
+    CHECK_EQUAL(0x13121110, IMemory_Read32(m_pMemory, 0x10000000));
+    CHECK_EQUAL(0x17161514, IMemory_Read32(m_pMemory, 0x10000004));
+    CHECK_EQUAL(1, m_loader.loadCount);
+}
+
+TEST(MemorySim, CreateLazyRegion_WriteBeforeRead_ShouldLoadBeforeWriting)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 8, &m_loader.loader, 0x00);
+    IMemory_Write8(m_pMemory, 0x10000001, 0xFF);
+    CHECK_EQUAL(1, m_loader.loadCount);
+    CHECK_EQUAL(0x0302FF00, IMemory_Read32(m_pMemory, 0x10000000));
+}
+
+TEST(MemorySim, CreateLazyRegion_AccessThroughAlias_ShouldLoadRedirectedRegion)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 8, &m_loader.loader, 0x00);
+    MemorySim_CreateAlias(m_pMemory, 0xA0000000, 0x10000000, 8);
+    CHECK_EQUAL(0, m_loader.loadCount);
+    CHECK_EQUAL(0x07060504, IMemory_Read32(m_pMemory, 0xA0000004));
+    CHECK_EQUAL(1, m_loader.loadCount);
+}
+
+TEST(MemorySim, CreateLazyRegion_GetRegionInfo_ShouldLoadRegion)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x20);
+    MemoryRegionInfo info = MemorySim_GetRegionInfo(m_pMemory, 0);
+    CHECK_EQUAL(1, m_loader.loadCount);
+    CHECK(info.pData != NULL);
+    CHECK_EQUAL(0x23222120, *(const uint32_t*)info.pData);
+}
+
+TEST(MemorySim, CreateLazyRegion_LoaderThrows_ShouldPropagateAndRetryOnNextAccess)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00);
+    m_loader.exceptionToThrow = fileException;
+    __try_and_catch( IMemory_Read32(m_pMemory, 0x10000000) );
+    validateExceptionThrown(fileException);
+    m_loader.exceptionToThrow = noException;
+    CHECK_EQUAL(0x03020100, IMemory_Read32(m_pMemory, 0x10000000));
+    CHECK_EQUAL(2, m_loader.loadCount);
+}
+
+TEST(MemorySim, CreateLazyRegion_LoaderThrows_RetryShouldReuseDataBuffer)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, ARENA_BLOCK_SIZE, &m_loader.loader, 0x00);
+    m_loader.exceptionToThrow = fileException;
+    __try_and_catch( IMemory_Read32(m_pMemory, 0x10000000) );
+    validateExceptionThrown(fileException);
+    m_loader.exceptionToThrow = noException;
+    MallocFailureInject_FailAllocation(1);
+    CHECK_EQUAL(0x03020100, IMemory_Read32(m_pMemory, 0x10000000));
+}
+
+TEST(MemorySim, CreateLazyRegion_FailDataAllocation_ShouldThrowWithoutCallingLoader)
+{
+    // Large enough to need its own arena block rather than fitting in the one holding the MemoryRegion structure.
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, ARENA_BLOCK_SIZE, &m_loader.loader, 0x00);
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( IMemory_Read32(m_pMemory, 0x10000000) );
+    validateExceptionThrown(outOfMemoryException);
+    CHECK_EQUAL(0, m_loader.loadCount);
+}
+
+TEST(MemorySim, CreateLazyRegion_ShouldThrowIfOutOfMemory)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00) );
+    validateExceptionThrown(outOfMemoryException);
+    CHECK_EQUAL(0, m_loader.loader.refCount);
+    CHECK_EQUAL(0, MemorySim_GetRegionCount(m_pMemory));
+}
+
+TEST(MemorySim, CreateLazyRegion_SharedLoader_ShouldOnlyBeReleasedWithLastRegion)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00);
+    MemorySim_CreateLazyRegion(m_pMemory, 0x20000000, 4, &m_loader.loader, 0x04);
+    CHECK_EQUAL(2, m_loader.loader.refCount);
+    CHECK_EQUAL(0x07060504, IMemory_Read32(m_pMemory, 0x20000000));
+    MemorySim_Uninit(m_pMemory);
+    CHECK_EQUAL(0, m_loader.loader.refCount);
+    CHECK_EQUAL(1, m_loader.releaseCount);
+}
+
+TEST(MemorySim, Uninit_LazyRegionsMixedWithOtherRegions_ShouldReleaseLoaderOnceAndResetForReuse)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00);
+    MemorySim_CreateAlias(m_pMemory, 0x08000000, 0x00000000, 4);
+    MemorySim_CreateLazyRegion(m_pMemory, 0x20000000, 4, &m_loader.loader, 0x04);
+    MemorySim_CreateRegion(m_pMemory, 0x30000000, 4);
+    MemorySim_Uninit(m_pMemory);
+    CHECK_EQUAL(0, m_loader.loader.refCount);
+    CHECK_EQUAL(1, m_loader.releaseCount);
+
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00);
+    MemorySim_Uninit(m_pMemory);
+    CHECK_EQUAL(2, m_loader.releaseCount);
+}
+
+TEST(MemorySim, TryReadWrite_ValidAddresses_ShouldSucceed)
+{
+    uint32_t value32 = 0;
+    uint16_t value16 = 0;
+    uint8_t  value8 = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 8);
+    CHECK_TRUE(IMemory_TryWrite32(m_pMemory, 0x10000000, 0x12345678));
+    CHECK_TRUE(IMemory_TryWrite16(m_pMemory, 0x10000004, 0xBAAD));
+    CHECK_TRUE(IMemory_TryWrite8(m_pMemory, 0x10000006, 0xF0));
+    CHECK_TRUE(IMemory_TryRead32(m_pMemory, 0x10000000, &value32));
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, 0x10000004, &value16));
+    CHECK_TRUE(IMemory_TryRead8(m_pMemory, 0x10000006, &value8));
+    CHECK_EQUAL(0x12345678, value32);
+    CHECK_EQUAL(0xBAAD, value16);
+    CHECK_EQUAL(0xF0, value8);
+}
+
+TEST(MemorySim, TryReadWrite_InvalidAddresses_ShouldFailWithoutThrowing)
+{
+    uint32_t value32 = 0xDEADBEEF;
+    uint16_t value16 = 0xDEAD;
+    uint8_t  value8 = 0xDE;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+    CHECK_FALSE(IMemory_TryRead32(m_pMemory, 0x10000002, &value32));
+    CHECK_FALSE(IMemory_TryRead16(m_pMemory, 0x10000004, &value16));
+    CHECK_FALSE(IMemory_TryRead8(m_pMemory, 0x0FFFFFFF, &value8));
+    CHECK_FALSE(IMemory_TryWrite32(m_pMemory, 0x10000004, 0));
+    CHECK_FALSE(IMemory_TryWrite16(m_pMemory, 0x10000003, 0));
+    CHECK_FALSE(IMemory_TryWrite8(m_pMemory, 0x10000004, 0));
+    CHECK_EQUAL(noException, getExceptionCode());
+    CHECK_EQUAL(0xDEADBEEF, value32);
+    CHECK_EQUAL(0xDEAD, value16);
+    CHECK_EQUAL(0xDE, value8);
+}
+
+TEST(MemorySim, TryWrite_ReadOnlyRegion_ShouldFailButStillAllowReads)
+{
+    uint16_t value = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    MemorySim_MakeRegionReadOnly(m_pMemory, 0x00000000);
+    CHECK_FALSE(IMemory_TryWrite16(m_pMemory, 0x00000000, 0xFFFF));
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, 0x00000002, &value));
+    CHECK_EQUAL(1, MemorySim_GetFlashReadCount(m_pMemory, 0x00000002));
+}
+
+TEST(MemorySim, TryRead16_HardwareBreakpoint_ShouldFail)
+{
+    uint16_t value = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    MemorySim_SetHardwareBreakpoint(m_pMemory, 0x00000002, 2);
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, 0x00000000, &value));
+    CHECK_FALSE(IMemory_TryRead16(m_pMemory, 0x00000002, &value));
+    CHECK_EQUAL(noException, getExceptionCode());
+}
+
+TEST(MemorySim, ReadData16_HardwareBreakpointInFlash_ShouldSucceedWithoutCountingRead)
+{
+    uint16_t value = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    MemorySim_MakeRegionReadOnly(m_pMemory, 0x00000000);
+    MemorySim_SetHardwareBreakpoint(m_pMemory, 0x00000002, 2);
+    CHECK_EQUAL(0x0000, MemorySim_ReadData16(m_pMemory, 0x00000002));
+    CHECK_TRUE(MemorySim_TryReadData16(m_pMemory, 0x00000002, &value));
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(m_pMemory, 0x00000002));
+}
+
+TEST(MemorySim, ReadData16_Watchpoint_ShouldFlagWatchpoint)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    MemorySim_SetHardwareWatchpoint(m_pMemory, 0x00000002, 2, WATCHPOINT_READ);
+    MemorySim_ReadData16(m_pMemory, 0x00000002);
+    CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
+}
+
+TEST(MemorySim, TryReadData16_UnmappedAddress_ShouldFail)
+{
+    uint16_t value = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 4);
+    CHECK_FALSE(MemorySim_TryReadData16(m_pMemory, 0x00000004, &value));
+    CHECK_EQUAL(noException, getExceptionCode());
+}
+
+TEST(MemorySim, TryRead32_Watchpoint_ShouldSucceedAndFlagWatchpoint)
+{
+    uint32_t value = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+    MemorySim_SetHardwareWatchpoint(m_pMemory, 0x10000000, 4, WATCHPOINT_READ);
+    CHECK_TRUE(IMemory_TryRead32(m_pMemory, 0x10000000, &value));
+    CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
+}
+
+TEST(MemorySim, TryRead32_LazyRegionWithFailingLoader_ShouldFailWithoutThrowing)
+{
+    uint32_t value = 0;
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 4, &m_loader.loader, 0x00);
+    m_loader.exceptionToThrow = fileException;
+    CHECK_FALSE(IMemory_TryRead32(m_pMemory, 0x10000000, &value));
+    CHECK_EQUAL(noException, getExceptionCode());
+    m_loader.exceptionToThrow = noException;
+    CHECK_TRUE(IMemory_TryRead32(m_pMemory, 0x10000000, &value));
+    CHECK_EQUAL(0x03020100, value);
+}
+
+TEST(MemorySim, GetStats_ShouldStartAtZero)
+{
+    MemorySimStats stats = MemorySim_GetStats(m_pMemory);
+    CHECK_EQUAL(0, stats.lookups);
+    CHECK_EQUAL(0, stats.hits);
+    CHECK_EQUAL(0, stats.misses);
+    CHECK_EQUAL(0, stats.bytesCopied);
+    CHECK_EQUAL(0, stats.lazyRegionLoads);
+    CHECK_EQUAL(0, stats.watchpointChecks);
+}
+
+TEST(MemorySim, GetStats_ShouldCountLookupsHitsMissesAndBytesCopied)
+{
+    uint32_t value = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 8);
+    IMemory_Write32(m_pMemory, 0x10000000, 0x12345678);
+    IMemory_Read16(m_pMemory, 0x10000004);
+    IMemory_Read8(m_pMemory, 0x10000006);
+    CHECK_FALSE(IMemory_TryRead32(m_pMemory, 0x20000000, &value));
+
+    MemorySimStats stats = MemorySim_GetStats(m_pMemory);
+    CHECK_EQUAL(4, stats.lookups);
+    CHECK_EQUAL(3, stats.hits);
+    CHECK_EQUAL(1, stats.misses);
+    CHECK_EQUAL(4 + 2 + 1, stats.bytesCopied);
+    CHECK_EQUAL(0, stats.lazyRegionLoads);
+    CHECK_EQUAL(0, stats.watchpointChecks);
+}
+
+TEST(MemorySim, GetStats_ShouldCountLazyRegionLoadsOnlyOnce)
+{
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 16, &m_loader.loader, 0x00);
+    IMemory_Read32(m_pMemory, 0x10000000);
+    IMemory_Read32(m_pMemory, 0x10000004);
+
+    MemorySimStats stats = MemorySim_GetStats(m_pMemory);
+    CHECK_EQUAL(1, stats.lazyRegionLoads);
+    CHECK_EQUAL(16 + 4 + 4, stats.bytesCopied);
+}
+
+TEST(MemorySim, GetStats_ShouldOnlyCountWatchpointChecksInRegionsWithWatchpoints)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+    MemorySim_CreateRegion(m_pMemory, 0x20000000, 4);
+    MemorySim_SetHardwareWatchpoint(m_pMemory, 0x10000000, 4, WATCHPOINT_WRITE);
+    IMemory_Read32(m_pMemory, 0x10000000);
+    IMemory_Read32(m_pMemory, 0x20000000);
+
+    MemorySimStats stats = MemorySim_GetStats(m_pMemory);
+    CHECK_EQUAL(1, stats.watchpointChecks);
+}
+
+TEST(MemorySim, Search_PatternInSingleRegion_ShouldReturnLowestMatch)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    IMemory_Write32(m_pMemory, 0x10000004, 0x44332211);
+    IMemory_Write32(m_pMemory, 0x1000000C, 0x44332211);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x10000000, 16, "\x11\x22\x33", 3, &found));
+    CHECK_EQUAL(0x10000004, found);
+}
+
+TEST(MemorySim, Search_PatternNotPresent_ShouldReturnFalse)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    IMemory_Write32(m_pMemory, 0x10000004, 0x44332211);
+    CHECK_FALSE(MemorySim_Search(m_pMemory, 0x10000000, 16, "\x11\x33", 2, &found));
+}
+
+TEST(MemorySim, Search_MatchEndingPastSearchRange_ShouldReturnFalse)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    IMemory_Write32(m_pMemory, 0x10000004, 0x44332211);
+    CHECK_FALSE(MemorySim_Search(m_pMemory, 0x10000000, 7, "\x11\x22\x33\x44", 4, &found));
+}
+
+TEST(MemorySim, Search_PatternSpanningAdjacentRegions_ShouldBeFound)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 8);
+    MemorySim_CreateRegion(m_pMemory, 0x10000008, 8);
+    IMemory_Write32(m_pMemory, 0x10000004, 0x22110000);
+    IMemory_Write32(m_pMemory, 0x10000008, 0x00004433);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x10000000, 16, "\x11\x22\x33\x44", 4, &found));
+    CHECK_EQUAL(0x10000006, found);
+}
+
+TEST(MemorySim, Search_PatternSpanningThreeSmallRegions_ShouldBeFound)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 1);
+    MemorySim_CreateRegion(m_pMemory, 0x10000001, 1);
+    MemorySim_CreateRegion(m_pMemory, 0x10000002, 1);
+    IMemory_Write8(m_pMemory, 0x10000000, 0x11);
+    IMemory_Write8(m_pMemory, 0x10000001, 0x22);
+    IMemory_Write8(m_pMemory, 0x10000002, 0x33);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x10000000, 3, "\x11\x22\x33", 3, &found));
+    CHECK_EQUAL(0x10000000, found);
+}
+
+TEST(MemorySim, Search_UnmappedGap_ShouldBeSkippedButNotMatchedAcross)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 4);
+    MemorySim_CreateRegion(m_pMemory, 0x20000000, 4);
+    IMemory_Write32(m_pMemory, 0x10000000, 0x11000000);
+    IMemory_Write32(m_pMemory, 0x20000000, 0x00002211);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x00000000, 0x30000000, "\x11\x22", 2, &found));
+    CHECK_EQUAL(0x20000000, found);
+}
+
+TEST(MemorySim, Search_ThroughAlias_ShouldSearchRedirectedRegion)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    MemorySim_CreateAlias(m_pMemory, 0x00000000, 0x10000008, 8);
+    IMemory_Write32(m_pMemory, 0x1000000C, 0x44332211);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x00000000, 8, "\x11\x22\x33\x44", 4, &found));
+    CHECK_EQUAL(0x00000004, found);
+}
+
+TEST(MemorySim, Search_LazyRegion_ShouldLoadItFirst)
+{
+    uint32_t found = 0;
+    MemorySim_CreateLazyRegion(m_pMemory, 0x10000000, 16, &m_loader.loader, 0x00);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x10000000, 16, "\x05\x06\x07", 3, &found));
+    CHECK_EQUAL(0x10000005, found);
+    CHECK_EQUAL(1, m_loader.loadCount);
+}
+
+TEST(MemorySim, Search_ShouldNotCountFlashReads)
+{
+    uint32_t found = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 8);
+    MemorySim_MakeRegionReadOnly(m_pMemory, 0x00000000);
+    CHECK_TRUE(MemorySim_Search(m_pMemory, 0x00000000, 8, "\x00\x00", 2, &found));
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(m_pMemory, 0x00000000));
+}
+
+TEST(MemorySim, MapSimulatedAddressToHostSpan_ShouldReturnDataUpToEndOfRegion)
+{
+    uint32_t spanSize = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    IMemory_Write32(m_pMemory, 0x10000004, 0x12345678);
+    const uint8_t* pData = (const uint8_t*)MemorySim_MapSimulatedAddressToHostSpan(m_pMemory, 0x10000004, &spanSize);
+    CHECK_EQUAL(12, spanSize);
+    CHECK_EQUAL(0x78, pData[0]);
+}
+
+TEST(MemorySim, MapSimulatedAddressToHostSpan_ThroughAlias_ShouldStopAtEndOfAlias)
+{
+    uint32_t spanSize = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    MemorySim_CreateAlias(m_pMemory, 0x00000000, 0x10000004, 8);
+    IMemory_Write32(m_pMemory, 0x10000008, 0x12345678);
+    const uint8_t* pData = (const uint8_t*)MemorySim_MapSimulatedAddressToHostSpan(m_pMemory, 0x00000004, &spanSize);
+    CHECK_EQUAL(4, spanSize);
+    CHECK_EQUAL(0x78, pData[0]);
+}
+
+TEST(MemorySim, MapSimulatedAddressToHostSpan_Unmapped_ShouldReturnNull)
+{
+    uint32_t spanSize = 0;
+    MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+    POINTERS_EQUAL(NULL, MemorySim_MapSimulatedAddressToHostSpan(m_pMemory, 0x10000010, &spanSize));
+}
+
+TEST(MemorySim, CreateRegionFromMappedFile_ShouldTakeOwnershipAndKeepWritesPrivate)
+{
+    static const uint8_t fileData[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+    static const char*   pFilename = "MemorySimTest.bin";
+    uint8_t              onDisk[sizeof(fileData)];
+    FILE*                pFile = fopen(pFilename, "wb");
+    fwrite(fileData, 1, sizeof(fileData), pFile);
+    fclose(pFile);
+    MappedFile mapping = MappedFile_Open(pFilename, MAPPED_FILE_COPY_ON_WRITE);
+
+    MemorySim_CreateRegionFromMappedFile(m_pMemory, 0x20000000, &mapping);
+    POINTERS_EQUAL(NULL, mapping.pData);
+    CHECK_EQUAL(0, mapping.size);
+    CHECK_EQUAL(0x44332211, IMemory_Read32(m_pMemory, 0x20000000));
+    IMemory_Write32(m_pMemory, 0x20000004, 0xDEADBEEF);
+    CHECK_EQUAL(0xDEADBEEF, IMemory_Read32(m_pMemory, 0x20000004));
+    __try_and_catch( IMemory_Read8(m_pMemory, 0x20000008) );
+    validateExceptionThrown(busErrorException);
+
+    pFile = fopen(pFilename, "rb");
+    CHECK_EQUAL(sizeof(onDisk), fread(onDisk, 1, sizeof(onDisk), pFile));
+    fclose(pFile);
+    remove(pFilename);
+    MEMCMP_EQUAL(fileData, onDisk, sizeof(fileData));
+}
+
+TEST(MemorySim, CreateRegionFromMappedFile_EmptyMapping_ShouldThrow)
+{
+    MappedFile mapping = { NULL, 0 };
+    __try_and_catch( MemorySim_CreateRegionFromMappedFile(m_pMemory, 0x20000000, &mapping) );
+    validateExceptionThrown(invalidArgumentException);
+}
@@ -0,0 +1,425 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <MallocFailureInject.h>
+    #include <PacketIComm.h>
+}
+#include <mockIComm.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+struct TestHandler
+{
+    const char* pRequest;
+    const char* pResponse;
+    char        lastRequest[PACKET_ICOMM_MAX_REQUEST_SIZE + 1];
+    int         callCount;
+};
+
+static int testHandle(void* pHandlerObject, const char* pRequest, size_t requestLength,
+                      char* pResponse, size_t responseSize)
+{
+    TestHandler* pHandler = (TestHandler*)pHandlerObject;
+
+    pHandler->callCount++;
+    memcpy(pHandler->lastRequest, pRequest, requestLength);
+    pHandler->lastRequest[requestLength] = '\0';
+    if (0 != strcmp(pHandler->lastRequest, pHandler->pRequest))
+        return FALSE;
+    strncpy(pResponse, pHandler->pResponse, responseSize - 1);
+    pResponse[responseSize - 1] = '\0';
+    return TRUE;
+}
+
+
+TEST_GROUP(PacketIComm)
+{
+    IComm*      m_pComm;
+    TestHandler m_handler1;
+    TestHandler m_handler2;
+
+    void setup()
+    {
+        initHandler(&m_handler1, "qFirst", "one");
+        initHandler(&m_handler2, "qSecond", "two");
+        m_pComm = PacketIComm_Init(mockIComm_Get());
+        mockIComm_InitTransmitDataBuffer(512);
+    }
+
+    void teardown()
+    {
+        MallocFailureInject_Restore();
+        PacketIComm_Uninit(m_pComm);
+        mockIComm_Uninit();
+        clearExceptionCode();
+    }
+
+    void initHandler(TestHandler* pHandler, const char* pRequest, const char* pResponse)
+    {
+        memset(pHandler, 0, sizeof(*pHandler));
+        pHandler->pRequest = pRequest;
+        pHandler->pResponse = pResponse;
+    }
+
+    void addHandlers()
+    {
+        PacketIComm_AddHandler(m_pComm, testHandle, &m_handler1);
+        PacketIComm_AddHandler(m_pComm, testHandle, &m_handler2);
+    }
+
+    void receiveAll(const char* pData)
+    {
+        size_t i;
+
+        mockIComm_InitReceiveData(pData);
+        for (i = 0 ; i < strlen(pData) ; i++)
+            CHECK_EQUAL(pData[i], IComm_ReceiveChar(m_pComm));
+    }
+
+    // Sends pRequest followed by a packet which should make it through to the MRI core.
+    void receiveHandledPacket(const char* pRequest)
+    {
+        char data[256];
+
+        snprintf(data, sizeof(data), "%s+$g#", pRequest);
+        mockIComm_InitReceiveChecksummedData(data);
+        CHECK_EQUAL('$', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('g', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('#', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('6', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('7', IComm_ReceiveChar(m_pComm));
+    }
+
+    void receiveAllChecksummed(const char* pData)
+    {
+        receiveAll(mockIComm_ChecksumData(pData));
+    }
+
+    // Sends pData from the MRI core side, filling in the checksums.
+    void sendFromMri(const char* pData)
+    {
+        const char* p;
+
+        for (p = mockIComm_ChecksumData(pData) ; *p ; p++)
+            IComm_SendChar(m_pComm, *p);
+    }
+
+    void primeCache()
+    {
+        PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+        receiveAllChecksummed("$m0,4#");
+        sendFromMri("+$01020304#");
+    }
+
+    // The cached m0,4 response should no longer be used after pRequest has been received.
+    void validateCacheFlushedBy(const char* pRequest)
+    {
+        primeCache();
+        receiveAllChecksummed(pRequest);
+        sendFromMri("+$OK#");
+        receiveAllChecksummed("$m0,4#");
+        STRCMP_EQUAL(mockIComm_ChecksumData("+$01020304#+$OK#"), mockIComm_GetTransmittedData());
+    }
+
+    void validateCacheHit()
+    {
+        mockIComm_InitTransmitDataBuffer(512);
+        receiveHandledPacket("$m0,4#");
+        STRCMP_EQUAL(mockIComm_ChecksumData("+$01020304#"), mockIComm_GetTransmittedData());
+    }
+};
+
+
+TEST(PacketIComm, ShouldForwardCallsToWrappedComm)
+{
+    mockIComm_SetShouldStopRunFlag(TRUE);
+    mockIComm_SetIsGdbConnectedFlag(FALSE);
+    mockIComm_InitReceiveData("+");
+    CHECK_TRUE(IComm_HasReceiveData(m_pComm));
+    CHECK_TRUE(IComm_WaitForReceiveData(m_pComm, 50));
+    CHECK_TRUE(IComm_ShouldStopRun(m_pComm));
+    CHECK_FALSE(IComm_IsGdbConnected(m_pComm));
+    CHECK_EQUAL('+', IComm_ReceiveChar(m_pComm));
+    IComm_SendChar(m_pComm, '$');
+    STRCMP_EQUAL("$", mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, NoHandlers_ShouldPassPacketsAndAcksThroughUnchanged)
+{
+    receiveAll("+\x03$m0,4#fd+$qFirst#00+$g#67");
+    STRCMP_EQUAL("", mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, UnclaimedPacket_ShouldBeOfferedToEachHandlerWithoutFraming)
+{
+    addHandlers();
+    receiveAll("$m0,4#fd");
+    STRCMP_EQUAL("", mockIComm_GetTransmittedData());
+    STRCMP_EQUAL("m0,4", m_handler1.lastRequest);
+    STRCMP_EQUAL("m0,4", m_handler2.lastRequest);
+}
+
+TEST(PacketIComm, BufferedPacket_ShouldReportReceiveDataWhileReplaying)
+{
+    mockIComm_InitReceiveData("$g#67");
+    CHECK_EQUAL('$', IComm_ReceiveChar(m_pComm));
+    mockIComm_InitReceiveData("");
+    CHECK_TRUE(IComm_HasReceiveData(m_pComm));
+    CHECK_TRUE(IComm_WaitForReceiveData(m_pComm, 50));
+    CHECK_EQUAL('g', IComm_ReceiveChar(m_pComm));
+}
+
+TEST(PacketIComm, PacketLongerThanBuffer_ShouldPassThroughWithoutBeingOffered)
+{
+    char packet[512];
+
+    addHandlers();
+    memset(packet, 'A', sizeof(packet));
+    packet[0] = '$';
+    packet[1] = 'q';
+    strcpy(&packet[PACKET_ICOMM_MAX_REQUEST_SIZE + 32], "#00");
+    receiveAll(packet);
+    STRCMP_EQUAL("", mockIComm_GetTransmittedData());
+    CHECK_EQUAL(0, m_handler1.callCount);
+}
+
+TEST(PacketIComm, PacketWithBadChecksum_ShouldPassThroughToLetMriRejectIt)
+{
+    addHandlers();
+    receiveAll("$qFirst#00");
+    STRCMP_EQUAL("", mockIComm_GetTransmittedData());
+    CHECK_EQUAL(0, m_handler1.callCount);
+}
+
+TEST(PacketIComm, ClaimedPacket_ShouldBeAckedAndAnsweredWithoutReachingMri)
+{
+    addHandlers();
+    receiveHandledPacket("$qFirst#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$one#"), mockIComm_GetTransmittedData());
+    // The second handler only gets offered the g packet which follows.
+    CHECK_EQUAL(1, m_handler2.callCount);
+}
+
+TEST(PacketIComm, PacketClaimedBySecondHandler_ShouldBeOfferedToFirstHandlerBeforeIt)
+{
+    addHandlers();
+    receiveHandledPacket("$qSecond#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$two#"), mockIComm_GetTransmittedData());
+    // Both handlers are also offered the g packet which follows.
+    CHECK_EQUAL(2, m_handler1.callCount);
+    CHECK_EQUAL(2, m_handler2.callCount);
+}
+
+TEST(PacketIComm, NackOfHandledResponse_ShouldResendIt)
+{
+    addHandlers();
+    receiveHandledPacket("$qFirst#-");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$one#$one#"), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, AddHandler_ShouldThrowOnceAllSlotsAreUsed)
+{
+    for (int i = 0 ; i < PACKET_ICOMM_MAX_HANDLERS ; i++)
+        PacketIComm_AddHandler(m_pComm, testHandle, &m_handler1);
+    __try_and_catch( PacketIComm_AddHandler(m_pComm, testHandle, &m_handler2) );
+    CHECK_EQUAL(invalidArgumentException, getExceptionCode());
+}
+
+TEST(PacketIComm, ResponseCacheDisabled_ShouldPassRepeatedReadsThroughToMri)
+{
+    receiveAllChecksummed("$m0,4#");
+    sendFromMri("+$01020304#");
+    receiveAllChecksummed("$m0,4#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$01020304#"), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, RepeatedRead_ShouldBeAnsweredFromCacheWithoutReachingMri)
+{
+    primeCache();
+    receiveHandledPacket("$m0,4#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$01020304#+$01020304#"), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, NackOfCachedResponse_ShouldResendIt)
+{
+    primeCache();
+    receiveHandledPacket("$m0,4#-");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$01020304#+$01020304#$01020304#"), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, RegisterReads_ShouldAlsoBeCached)
+{
+    PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    receiveAllChecksummed("$p1#");
+    sendFromMri("+$78563412#");
+    mockIComm_InitTransmitDataBuffer(512);
+    receiveHandledPacket("$p1#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$78563412#"), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, ReadOfDifferentAddress_ShouldPassThroughToMri)
+{
+    primeCache();
+    receiveAllChecksummed("$m4,4#");
+    sendFromMri("+$05060708#");
+    validateCacheHit();
+}
+
+TEST(PacketIComm, ResponseFromHandler_ShouldBeCachedForCacheableRequests)
+{
+    initHandler(&m_handler1, "p1", "78563412");
+    addHandlers();
+    PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    receiveHandledPacket("$p1#");
+    receiveHandledPacket("$p1#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$78563412#+$78563412#"), mockIComm_GetTransmittedData());
+    // Offered the first p1 and the g packets which followed each request.
+    CHECK_EQUAL(3, m_handler1.callCount);
+}
+
+TEST(PacketIComm, MemoryWrite_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$M0,4:05060708#");
+}
+
+TEST(PacketIComm, BinaryMemoryWrite_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$X0,1:A#");
+}
+
+TEST(PacketIComm, RegistersWrite_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$G00000000#");
+}
+
+TEST(PacketIComm, RegisterWrite_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$P1=00000000#");
+}
+
+TEST(PacketIComm, Continue_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$c#");
+}
+
+TEST(PacketIComm, ThreadSwitch_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$Hg2#");
+}
+
+TEST(PacketIComm, MonitorCommand_ShouldFlushCache)
+{
+    validateCacheFlushedBy("$qRcmd,7265736574#");
+}
+
+TEST(PacketIComm, Queries_ShouldNotFlushCache)
+{
+    primeCache();
+    receiveAllChecksummed("$qfThreadInfo#");
+    sendFromMri("+$l#");
+    receiveAllChecksummed("$?#");
+    sendFromMri("+$T05#");
+    validateCacheHit();
+}
+
+TEST(PacketIComm, PacketLongerThanBuffer_ShouldFlushCache)
+{
+    char packet[512];
+
+    primeCache();
+    memset(packet, 'A', sizeof(packet));
+    packet[0] = '$';
+    packet[1] = 'X';
+    strcpy(&packet[PACKET_ICOMM_MAX_REQUEST_SIZE + 32], "#00");
+    receiveAll(packet);
+    receiveAllChecksummed("$m0,4#");
+}
+
+TEST(PacketIComm, ResponseInterruptedByNextRequest_ShouldNotBeCached)
+{
+    PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    receiveAllChecksummed("$m0,4#");
+    sendFromMri("+$0102");
+    receiveAllChecksummed("$m0,4#");
+    sendFromMri("+$01020304#");
+    validateCacheHit();
+}
+
+TEST(PacketIComm, LargeResponse_ShouldGrowCaptureBuffer)
+{
+    char response[512];
+    char expected[512];
+
+    memset(response, 0, sizeof(response));
+    memset(response, '0', 400);
+    PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    receiveAllChecksummed("$m0,200#");
+    sendFromMri("+$");
+    sendFromMri(response);
+    sendFromMri("#00");
+    mockIComm_InitTransmitDataBuffer(512);
+    receiveHandledPacket("$m0,200#");
+    snprintf(expected, sizeof(expected), "+$%s#", response);
+    STRCMP_EQUAL(mockIComm_ChecksumData(expected), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, ResponseLargerThanCache_ShouldNotBeCached)
+{
+    PacketIComm_EnableResponseCache(m_pComm, 8);
+    receiveAllChecksummed("$m0,4#");
+    sendFromMri("+$01020304#");
+    receiveAllChecksummed("$m0,4#");
+}
+
+TEST(PacketIComm, FullCache_ShouldBeFlushedToMakeRoomForNewResponse)
+{
+    // Only room for one of the two responses.
+    PacketIComm_EnableResponseCache(m_pComm, 64);
+    receiveAllChecksummed("$m0,4#");
+    sendFromMri("+$01020304#");
+    receiveAllChecksummed("$m4,4#");
+    sendFromMri("+$05060708#");
+    receiveAllChecksummed("$m0,4#");
+}
+
+TEST(PacketIComm, FailedAllocation_ShouldJustSkipCachingResponse)
+{
+    PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    MallocFailureInject_FailAllocation(1);
+    receiveAllChecksummed("$m0,4#");
+    sendFromMri("+$01020304#");
+    receiveAllChecksummed("$m0,4#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$01020304#"), mockIComm_GetTransmittedData());
+}
+
+TEST(PacketIComm, FailedReallocation_ShouldJustSkipCachingResponse)
+{
+    char response[128];
+
+    memset(response, 0, sizeof(response));
+    memset(response, '0', 100);
+    PacketIComm_EnableResponseCache(m_pComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    MallocFailureInject_FailAllocation(2);
+    receiveAllChecksummed("$m0,32#");
+    sendFromMri("+$");
+    sendFromMri(response);
+    sendFromMri("#00");
+    receiveAllChecksummed("$m0,32#");
+}
@@ -0,0 +1,306 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <DumpLoad.h>
+    #include <MemorySim.h>
+    #include <RegionManifest.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define TEST_DIRECTORY "RegionManifestTest.dir"
+
+static const char* g_memoryMapFilename = TEST_DIRECTORY "/memmap.txt";
+static const char* g_scriptFilename = TEST_DIRECTORY "/capture.gdb";
+static const char* g_manifestFilename = TEST_DIRECTORY "/capture.manifest";
+static const char* g_registersFilename = TEST_DIRECTORY "/capture-registers.txt";
+static const char* g_regionFilename = TEST_DIRECTORY "/capture-20000000.bin";
+
+
+TEST_GROUP(RegionManifest)
+{
+    IMemory*        m_pMemory;
+    RegisterContext m_context;
+
+    void setup()
+    {
+        mkdir(TEST_DIRECTORY, 0755);
+        m_pMemory = MemorySim_Init();
+        memset(&m_context, 0, sizeof(m_context));
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        clearExceptionCode();
+        MemorySim_Uninit(m_pMemory);
+        remove(g_memoryMapFilename);
+        remove(g_scriptFilename);
+        remove(g_manifestFilename);
+        remove(g_registersFilename);
+        remove(g_regionFilename);
+        rmdir(TEST_DIRECTORY);
+    }
+
+    void writeFile(const char* pFilename, const void* pData, size_t dataSize)
+    {
+        FILE* pFile = fopen(pFilename, "wb");
+        CHECK_TRUE(pFile != NULL);
+        fwrite(pData, 1, dataSize, pFile);
+        fclose(pFile);
+    }
+
+    void writeTextFile(const char* pFilename, const char* pText)
+    {
+        writeFile(pFilename, pText, strlen(pText));
+    }
+
+    std::string readTextFile(const char* pFilename)
+    {
+        std::string text;
+        char        buffer[256];
+        size_t      bytesRead;
+        FILE*       pFile = fopen(pFilename, "rb");
+
+        CHECK_TRUE(pFile != NULL);
+        while ((bytesRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+            text.append(buffer, bytesRead);
+        fclose(pFile);
+        return text;
+    }
+
+    void writeRegionAndRegisters()
+    {
+        static const uint8_t regionData[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+
+        writeFile(g_regionFilename, regionData, sizeof(regionData));
+        writeTextFile(g_registersFilename, "r0             0x12345678\t305419896\n"
+                                           "pc             0x00000400\t0x400 <main>\n");
+    }
+
+    void validateLoadedRegionAndRegisters()
+    {
+        CHECK_EQUAL(0x44332211, IMemory_Read32(m_pMemory, 0x20000000));
+        CHECK_EQUAL(0x88776655, IMemory_Read32(m_pMemory, 0x20000004));
+        CHECK_EQUAL(0x12345678, m_context.R[R0]);
+        CHECK_EQUAL(0x00000400, m_context.R[PC]);
+    }
+
+    void validateException(int expectedExceptionCode, const char* pExpectedMessage)
+    {
+        CHECK_EQUAL(expectedExceptionCode, getExceptionCode());
+        STRCMP_EQUAL(pExpectedMessage, getExceptionMessage());
+        clearExceptionCode();
+    }
+};
+
+
+TEST(RegionManifest, WriteCaptureScript_ShouldOnlyDumpEnabledReadWriteRegions)
+{
+    writeTextFile(g_memoryMapFilename,
+                  "Using memory regions provided by the target.\n"
+                  "Num Enb Low Addr   High Addr  Attrs \n"
+                  "0   y  \t0x00000000 0x00080000 ro nocache \n"
+                  "1   y  \t0x10000000 0x10008000 rw nocache \n"
+                  "2   n  \t0x2007c000 0x20084000 rw nocache \n"
+                  "3   y  \t0x20000000 0x20001000 rw nocache \n");
+    RegionManifest_WriteCaptureScript(g_scriptFilename, g_memoryMapFilename);
+
+    std::string script = readTextFile(g_scriptFilename);
+    STRCMP_EQUAL("# Generated by CrashDebug --capture-script from " TEST_DIRECTORY "/memmap.txt\n"
+                 "# Run \"source " TEST_DIRECTORY "/capture.gdb\" from GDB while it is attached to the crashed device and then\n"
+                 "# pass " TEST_DIRECTORY "/capture.manifest to the --dump option of CrashDebug.\n"
+                 "set pagination off\n"
+                 "dump binary memory \"" TEST_DIRECTORY "/capture-10000000.bin\" 0x10000000 0x10008000\n"
+                 "dump binary memory \"" TEST_DIRECTORY "/capture-20000000.bin\" 0x20000000 0x20001000\n"
+                 "set logging file " TEST_DIRECTORY "/capture-registers.txt\n"
+                 "set logging overwrite on\n"
+                 "set logging redirect on\n"
+                 "set logging on\n"
+                 "info all-registers\n"
+                 "set logging off\n"
+                 "set logging redirect off\n"
+                 "set pagination on\n",
+                 script.c_str());
+    std::string manifest = readTextFile(g_manifestFilename);
+    STRCMP_EQUAL(REGION_MANIFEST_SIGNATURE "\n"
+                 "registers capture-registers.txt\n"
+                 "region 0x10000000 capture-10000000.bin\n"
+                 "region 0x20000000 capture-20000000.bin\n",
+                 manifest.c_str());
+}
+
+TEST(RegionManifest, WriteCaptureScript_BackslashSeparatedPath_ShouldSplitBaseNameAndEscapeDumpPaths)
+{
+    static const char* pScriptFilename = "RegionManifestTest\\capture.gdb";
+    static const char* pManifestFilename = "RegionManifestTest\\capture.manifest";
+
+    writeTextFile(g_memoryMapFilename,
+                  "Num Enb Low Addr   High Addr  Attrs \n"
+                  "0   y  \t0x20000000 0x20001000 rw nocache \n");
+    RegionManifest_WriteCaptureScript(pScriptFilename, g_memoryMapFilename);
+
+    std::string script = readTextFile(pScriptFilename);
+    std::string manifest = readTextFile(pManifestFilename);
+    remove(pScriptFilename);
+    remove(pManifestFilename);
+    CHECK_TRUE(script.find("dump binary memory \"RegionManifestTest\\\\capture-20000000.bin\" 0x20000000 0x20001000\n")
+               != std::string::npos);
+    STRCMP_EQUAL(REGION_MANIFEST_SIGNATURE "\n"
+                 "registers capture-registers.txt\n"
+                 "region 0x20000000 capture-20000000.bin\n",
+                 manifest.c_str());
+}
+
+TEST(RegionManifest, WriteCaptureScript_InvalidMemoryMapFilename_ShouldThrow)
+{
+    __try_and_catch( RegionManifest_WriteCaptureScript(g_scriptFilename, TEST_DIRECTORY "/invalid.txt") );
+    validateException(fileException, "Failed to open \"" TEST_DIRECTORY "/invalid.txt\" memory map.");
+}
+
+TEST(RegionManifest, WriteCaptureScript_NoReadWriteRegions_ShouldThrowAndNotWriteScript)
+{
+    writeTextFile(g_memoryMapFilename, "0   y  \t0x00000000 0x00080000 ro nocache \n");
+    __try_and_catch( RegionManifest_WriteCaptureScript(g_scriptFilename, g_memoryMapFilename) );
+    validateException(fileFormatException,
+                      "Failed to find any read-write regions in \"" TEST_DIRECTORY "/memmap.txt\" memory map.");
+    CHECK_EQUAL(-1, access(g_scriptFilename, F_OK));
+}
+
+TEST(RegionManifest, WriteCaptureScript_InvalidScriptFilename_ShouldThrow)
+{
+    writeTextFile(g_memoryMapFilename, "1   y  \t0x10000000 0x10008000 rw nocache \n");
+    __try_and_catch( RegionManifest_WriteCaptureScript(TEST_DIRECTORY "/invalid/capture.gdb", g_memoryMapFilename) );
+    validateException(fileException, "Failed to create \"" TEST_DIRECTORY "/invalid/capture.gdb\".");
+}
+
+TEST(RegionManifest, DumpLoad_ShouldMapRegionsRelativeToManifestAndParseRegisters)
+{
+    writeRegionAndRegisters();
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "\n"
+                                      "# Comments and blank lines are ignored.\n"
+                                      "registers capture-registers.txt\n"
+                                      "region 0x20000000 capture-20000000.bin\n");
+    DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename);
+    validateLoadedRegionAndRegisters();
+    __try_and_catch( IMemory_Read8(m_pMemory, 0x20000008) );
+    CHECK_EQUAL(busErrorException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(RegionManifest, DumpLoad_WritesToRegion_ShouldNotModifyRegionFile)
+{
+    writeRegionAndRegisters();
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "region 0x20000000 capture-20000000.bin\n");
+    DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename);
+    IMemory_Write32(m_pMemory, 0x20000000, 0xDEADBEEF);
+    CHECK_EQUAL(0xDEADBEEF, IMemory_Read32(m_pMemory, 0x20000000));
+    std::string region = readTextFile(g_regionFilename);
+    MEMCMP_EQUAL("\x11\x22\x33\x44", region.c_str(), 4);
+}
+
+TEST(RegionManifest, DumpLoad_FromScriptOutput_ShouldLoadEverythingCaptured)
+{
+    writeTextFile(g_memoryMapFilename, "3   y  \t0x20000000 0x20000008 rw nocache \n");
+    RegionManifest_WriteCaptureScript(g_scriptFilename, g_memoryMapFilename);
+    writeRegionAndRegisters();
+    DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename);
+    validateLoadedRegionAndRegisters();
+}
+
+TEST(RegionManifest, Load_NullManifestFilename_ShouldUsePathsRelativeToCurrentDirectory)
+{
+    DumpStream stream;
+    writeRegionAndRegisters();
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "registers " TEST_DIRECTORY "/capture-registers.txt\n"
+                                      "region 0x20000000 " TEST_DIRECTORY "/capture-20000000.bin\n");
+    DumpStream_Init(&stream, fopen(g_manifestFilename, "rb"));
+    RegionManifest_Load(m_pMemory, &m_context, &stream, NULL);
+    DumpStream_Close(&stream);
+    validateLoadedRegionAndRegisters();
+}
+
+TEST(RegionManifest, DumpLoad_InvalidEntry_ShouldThrowWithLineNumber)
+{
+    writeRegionAndRegisters();
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "registers capture-registers.txt\n"
+                                      "region capture-20000000.bin\n");
+    __try_and_catch( DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename) );
+    validateException(fileFormatException, "The region manifest contained an invalid entry on line 3.");
+}
+
+TEST(RegionManifest, DumpLoad_UnknownEntry_ShouldThrow)
+{
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "flash 0x00000000 image.bin\n");
+    __try_and_catch( DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename) );
+    validateException(fileFormatException, "The region manifest contained an invalid entry on line 2.");
+}
+
+TEST(RegionManifest, DumpLoad_EmptyRegionFile_ShouldThrow)
+{
+    writeFile(g_regionFilename, "", 0);
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "region 0x20000000 capture-20000000.bin\n");
+    __try_and_catch( DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename) );
+    validateException(fileFormatException, "The \"" TEST_DIRECTORY "/capture-20000000.bin\" region file is empty.");
+}
+
+TEST(RegionManifest, DumpLoad_MissingRegionFile_ShouldThrow)
+{
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "region 0x20000000 capture-20000000.bin\n");
+    __try_and_catch( DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename) );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(RegionManifest, DumpLoad_DriveLetterPath_ShouldNotBeMadeRelativeToManifest)
+{
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "region 0x20000000 Z:\\capture\\capture-20000000.bin\n");
+    __try_and_catch( DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename) );
+    validateException(fileException, "Failed to open \"Z:\\capture\\capture-20000000.bin\".");
+}
+
+TEST(RegionManifest, DumpLoad_BackslashRootedPath_ShouldNotBeMadeRelativeToManifest)
+{
+    writeTextFile(g_manifestFilename, REGION_MANIFEST_SIGNATURE "\n"
+                                      "region 0x20000000 \\capture\\capture-20000000.bin\n");
+    __try_and_catch( DumpLoad_FromFile(m_pMemory, &m_context, g_manifestFilename) );
+    validateException(fileException, "Failed to open \"\\capture\\capture-20000000.bin\".");
+}
+
+TEST(RegionManifest, Load_WrongSignature_ShouldThrow)
+{
+    DumpStream stream;
+    writeTextFile(g_manifestFilename, "# CrashDebug region list\n");
+    DumpStream_Init(&stream, fopen(g_manifestFilename, "rb"));
+    __try_and_catch( RegionManifest_Load(m_pMemory, &m_context, &stream, g_manifestFilename) );
+    DumpStream_Close(&stream);
+    validateException(fileFormatException, "The region manifest didn't start with \"" REGION_MANIFEST_SIGNATURE "\".");
+}
@@ -0,0 +1,112 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <MemorySim.h>
+    #include <SearchPackets.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+TEST_GROUP(SearchPackets)
+{
+    IMemory* m_pMemory;
+    char     m_response[64];
+
+    void setup()
+    {
+        m_pMemory = MemorySim_Init();
+        MemorySim_CreateRegion(m_pMemory, 0x10000000, 16);
+        memset(m_response, 0, sizeof(m_response));
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        MemorySim_Uninit(m_pMemory);
+    }
+
+    int handle(const char* pRequest, size_t requestLength)
+    {
+        return SearchPackets_Handle(m_pMemory, pRequest, requestLength, m_response, sizeof(m_response));
+    }
+
+    int handle(const char* pRequest)
+    {
+        return handle(pRequest, strlen(pRequest));
+    }
+};
+
+
+TEST(SearchPackets, OtherPackets_ShouldNotBeClaimed)
+{
+    CHECK_FALSE(handle("qSearch:mem"));
+    CHECK_FALSE(handle("m10000000,4"));
+}
+
+TEST(SearchPackets, PatternFound_ShouldReturnItsAddress)
+{
+    IMemory_Write32(m_pMemory, 0x10000008, 0x44332211);
+    CHECK_TRUE(handle("qSearch:memory:10000000;10;\x22\x33"));
+    STRCMP_EQUAL("1,10000009", m_response);
+}
+
+TEST(SearchPackets, PatternNotFound_ShouldReturnZero)
+{
+    CHECK_TRUE(handle("qSearch:memory:10000000;10;abc"));
+    STRCMP_EQUAL("0", m_response);
+}
+
+TEST(SearchPackets, EscapedPatternBytes_ShouldBeUnescaped)
+{
+    IMemory_Write32(m_pMemory, 0x10000004, 0x2A7D2423);
+    CHECK_TRUE(handle("qSearch:memory:10000000;10;}\x03}\x04}]}\x0a"));
+    STRCMP_EQUAL("1,10000004", m_response);
+}
+
+TEST(SearchPackets, PatternContainingNul_ShouldUseRequestLength)
+{
+    IMemory_Write32(m_pMemory, 0x10000004, 0x00110022);
+    CHECK_TRUE(handle("qSearch:memory:10000000;10;\x22\x00\x11", 30));
+    STRCMP_EQUAL("1,10000004", m_response);
+}
+
+TEST(SearchPackets, MissingLength_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qSearch:memory:10000000;abc"));
+    STRCMP_EQUAL("E01", m_response);
+}
+
+TEST(SearchPackets, BadHexAddress_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qSearch:memory:1000z000;10;abc"));
+    STRCMP_EQUAL("E01", m_response);
+}
+
+TEST(SearchPackets, EmptyPattern_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qSearch:memory:10000000;10;"));
+    STRCMP_EQUAL("E01", m_response);
+}
+
+TEST(SearchPackets, TruncatedEscape_ShouldReturnError)
+{
+    CHECK_TRUE(handle("qSearch:memory:10000000;10;a}"));
+    STRCMP_EQUAL("E01", m_response);
+}
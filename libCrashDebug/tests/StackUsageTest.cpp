@@ -0,0 +1,259 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <MallocFailureInject.h>
+    #include <MemorySim.h>
+    #include <printfSpy.h>
+    #include <StackUsage.h>
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include <CppUTest/TestHarness.h>
+
+
+#define RAM_BASE            0x20000000
+#define RAM_SIZE            0x2000
+#define TASK1_TCB           0x20000100
+#define TASK2_TCB           0x20000200
+#define TASK1_STACK         0x20000400
+#define TASK2_STACK         0x20000800
+#define TASK_STACK_SIZE     0x400
+#define MAIN_STACK_LIMIT    0x20001800
+#define MAIN_STACK_TOP      0x20002000
+
+TEST_GROUP(StackUsage)
+{
+    IMemory*    m_pMemory;
+    StackUsage  m_usage;
+    ElfSymbol   m_symbolArray[2];
+    ElfSymbols  m_symbols;
+    RtosThread  m_threadArray[2];
+    RtosThreads m_threads;
+    int         m_isIncomplete;
+
+    void setup()
+    {
+        memset(&m_usage, 0, sizeof(m_usage));
+        memset(&m_symbols, 0, sizeof(m_symbols));
+        memset(m_threadArray, 0, sizeof(m_threadArray));
+        memset(&m_threads, 0, sizeof(m_threads));
+        m_isIncomplete = -1;
+        m_pMemory = MemorySim_Init();
+        MemorySim_CreateRegion(m_pMemory, RAM_BASE, RAM_SIZE);
+        fill(RAM_BASE, RAM_SIZE, 0xA5);
+        printfSpy_Hook(512);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        clearExceptionCode();
+        printfSpy_Unhook();
+        MallocFailureInject_Restore();
+        StackUsage_Uninit(&m_usage);
+        MemorySim_Uninit(m_pMemory);
+    }
+
+    void fill(uint32_t address, uint32_t size, uint8_t value)
+    {
+        memset(MemorySim_MapSimulatedAddressToHostAddressForWrite(m_pMemory, address, size), value, size);
+    }
+
+    void setSymbols(const char* pName1, uint32_t address1, const char* pName2, uint32_t address2)
+    {
+        m_symbolArray[0].pName = pName1;
+        m_symbolArray[0].address = address1;
+        m_symbolArray[1].pName = pName2;
+        m_symbolArray[1].address = address2;
+        m_symbols.pSymbols = m_symbolArray;
+        m_symbols.symbolCount = ARRAY_SIZE(m_symbolArray);
+    }
+
+    void addTask(uint32_t tcb, const char* pName, uint32_t stackBase, uint32_t stackEnd)
+    {
+        RtosThread* pThread = &m_threadArray[m_threads.threadCount++];
+
+        pThread->id = tcb;
+        strcpy(pThread->name, pName);
+        pThread->stackBase = stackBase;
+        pThread->stackEnd = stackEnd;
+        m_threads.pThreads = m_threadArray;
+    }
+
+    uint32_t countFillBytes(uint32_t base, uint32_t maxSize, uint32_t fillPattern)
+    {
+        return StackUsage_CountFillBytes(m_pMemory, base, maxSize, fillPattern, &m_isIncomplete);
+    }
+};
+
+
+TEST(StackUsage, CountFillBytes_AllFill_ShouldReturnMaxSize)
+{
+    CHECK_EQUAL(0x1000, countFillBytes(RAM_BASE, 0x1000, STACK_USAGE_DEFAULT_FILL));
+    CHECK_FALSE(m_isIncomplete);
+}
+
+TEST(StackUsage, CountFillBytes_NoFill_ShouldReturnZero)
+{
+    IMemory_Write8(m_pMemory, RAM_BASE, 0x00);
+    CHECK_EQUAL(0, countFillBytes(RAM_BASE, 0x1000, STACK_USAGE_DEFAULT_FILL));
+    CHECK_FALSE(m_isIncomplete);
+}
+
+TEST(StackUsage, CountFillBytes_ShouldStopAtFirstByteWhichDiffers)
+{
+    IMemory_Write8(m_pMemory, RAM_BASE + 0x3A7, 0xA4);
+    IMemory_Write8(m_pMemory, RAM_BASE + 0x3B0, 0x00);
+    CHECK_EQUAL(0x3A7, countFillBytes(RAM_BASE, 0x1000, STACK_USAGE_DEFAULT_FILL));
+}
+
+TEST(StackUsage, CountFillBytes_UnalignedBase_ShouldKeepPatternInPhaseWithAddress)
+{
+    uint32_t i;
+
+    for (i = 0 ; i < 0x800 ; i += 4)
+        IMemory_Write32(m_pMemory, RAM_BASE + i, 0xDEADBEEF);
+    IMemory_Write8(m_pMemory, RAM_BASE + 0x502, 0xAD ^ 0xFF);
+    CHECK_EQUAL(0x502 - 0x3, countFillBytes(RAM_BASE + 3, 0x800 - 3, 0xDEADBEEF));
+}
+
+TEST(StackUsage, CountFillBytes_ScanShouldContinueAcrossAdjacentRegions)
+{
+    MemorySim_CreateRegion(m_pMemory, RAM_BASE + RAM_SIZE, 0x100);
+    fill(RAM_BASE + RAM_SIZE, 0x80, 0xA5);
+    CHECK_EQUAL(RAM_SIZE - 0x100 + 0x80, countFillBytes(RAM_BASE + 0x100, 0x1000000, STACK_USAGE_DEFAULT_FILL));
+    CHECK_FALSE(m_isIncomplete);
+}
+
+TEST(StackUsage, CountFillBytes_RunIntoMemoryNotInDump_ShouldFlagIncomplete)
+{
+    CHECK_EQUAL(0x100, countFillBytes(RAM_BASE + RAM_SIZE - 0x100, 0x200, STACK_USAGE_DEFAULT_FILL));
+    CHECK_TRUE(m_isIncomplete);
+}
+
+TEST(StackUsage, CountFillBytes_ShouldNotAffectReadCounts)
+{
+    MemorySim_CreateRegion(m_pMemory, 0x00000000, 0x100);
+    MemorySim_MakeRegionReadOnly(m_pMemory, 0x00000000);
+    countFillBytes(0x00000000, 0x100, STACK_USAGE_DEFAULT_FILL);
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(m_pMemory, 0x00000000));
+}
+
+TEST(StackUsage, Init_CmsisStackSymbols_ShouldReportMainStack)
+{
+    setSymbols("__StackLimit", MAIN_STACK_LIMIT, "__StackTop", MAIN_STACK_TOP);
+    fill(MAIN_STACK_LIMIT + 0x600, 0x200, 0x00);
+    StackUsage_Init(&m_usage, m_pMemory, &m_symbols, NULL, STACK_USAGE_DEFAULT_FILL);
+    CHECK_EQUAL(1, m_usage.stackCount);
+    STRCMP_EQUAL("Main", m_usage.pStacks[0].name);
+    CHECK_EQUAL(MAIN_STACK_LIMIT, m_usage.pStacks[0].base);
+    CHECK_EQUAL(MAIN_STACK_TOP, m_usage.pStacks[0].end);
+    CHECK_EQUAL(0x600, m_usage.pStacks[0].freeBytes);
+    CHECK_EQUAL(0x200, m_usage.pStacks[0].usedBytes);
+    CHECK_FALSE(m_usage.pStacks[0].isIncomplete);
+}
+
+TEST(StackUsage, Init_Stm32StackSymbols_ShouldReserveMinStackSizeBelowEstack)
+{
+    setSymbols("_estack", MAIN_STACK_TOP, "_Min_Stack_Size", 0x400);
+    fill(MAIN_STACK_TOP - 0x100, 0x100, 0x00);
+    StackUsage_Init(&m_usage, m_pMemory, &m_symbols, NULL, STACK_USAGE_DEFAULT_FILL);
+    CHECK_EQUAL(1, m_usage.stackCount);
+    CHECK_EQUAL(MAIN_STACK_TOP - 0x400, m_usage.pStacks[0].base);
+    CHECK_EQUAL(0x300, m_usage.pStacks[0].freeBytes);
+    CHECK_EQUAL(0x100, m_usage.pStacks[0].usedBytes);
+}
+
+TEST(StackUsage, Init_NoStackSymbolsOrThreads_ShouldThrow)
+{
+    setSymbols("_estack", MAIN_STACK_TOP, "main", 0x00000100);
+    __try_and_catch( StackUsage_Init(&m_usage, m_pMemory, &m_symbols, &m_threads, STACK_USAGE_DEFAULT_FILL) );
+    CHECK_EQUAL(elfFormatException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(StackUsage, Init_TasksWithRecordedStackEnd_ShouldReportUsedAndFreeBytes)
+{
+    setSymbols("__StackLimit", MAIN_STACK_LIMIT, "__StackTop", MAIN_STACK_TOP);
+    addTask(TASK1_TCB, "IDLE", TASK1_STACK, TASK1_STACK + TASK_STACK_SIZE);
+    addTask(TASK2_TCB, "Worker", TASK2_STACK, TASK2_STACK + TASK_STACK_SIZE);
+    fill(TASK1_STACK + 0x380, 0x80, 0x00);
+    fill(TASK2_STACK + 0x0C4, 0x33C, 0x00);
+    StackUsage_Init(&m_usage, m_pMemory, &m_symbols, &m_threads, STACK_USAGE_DEFAULT_FILL);
+    CHECK_EQUAL(3, m_usage.stackCount);
+    STRCMP_EQUAL("IDLE", m_usage.pStacks[1].name);
+    CHECK_EQUAL(TASK1_STACK, m_usage.pStacks[1].base);
+    CHECK_EQUAL(TASK1_STACK + TASK_STACK_SIZE, m_usage.pStacks[1].end);
+    CHECK_EQUAL(0x380, m_usage.pStacks[1].freeBytes);
+    CHECK_EQUAL(0x80, m_usage.pStacks[1].usedBytes);
+    STRCMP_EQUAL("Worker", m_usage.pStacks[2].name);
+    CHECK_EQUAL(0xC4, m_usage.pStacks[2].freeBytes);
+    CHECK_EQUAL(0x33C, m_usage.pStacks[2].usedBytes);
+}
+
+TEST(StackUsage, Init_TaskWithoutRecordedStackEnd_ShouldOnlyReportFreeBytes)
+{
+    addTask(TASK1_TCB, "IDLE", TASK1_STACK, 0);
+    fill(TASK1_STACK + 0x380, 0x80, 0x00);
+    StackUsage_Init(&m_usage, m_pMemory, &m_symbols, &m_threads, STACK_USAGE_DEFAULT_FILL);
+    CHECK_EQUAL(1, m_usage.stackCount);
+    CHECK_EQUAL(0, m_usage.pStacks[0].end);
+    CHECK_EQUAL(0x380, m_usage.pStacks[0].freeBytes);
+    CHECK_EQUAL(0, m_usage.pStacks[0].usedBytes);
+}
+
+TEST(StackUsage, Init_FailAllocation_ShouldThrow)
+{
+    setSymbols("__StackLimit", MAIN_STACK_LIMIT, "__StackTop", MAIN_STACK_TOP);
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( StackUsage_Init(&m_usage, m_pMemory, &m_symbols, NULL, STACK_USAGE_DEFAULT_FILL) );
+    CHECK_EQUAL(outOfMemoryException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(StackUsage, PrintReport_ShouldListEachStack)
+{
+    setSymbols("__StackLimit", MAIN_STACK_LIMIT, "__StackTop", MAIN_STACK_TOP);
+    addTask(TASK1_TCB, "IDLE", TASK1_STACK, TASK1_STACK + TASK_STACK_SIZE);
+    addTask(TASK2_TCB, "Worker", TASK2_STACK, 0);
+    fill(MAIN_STACK_LIMIT, 0x800, 0x00);
+    fill(TASK1_STACK + 0x300, 0x100, 0x00);
+    fill(TASK2_STACK + 0x200, 0x200, 0x00);
+    StackUsage_Init(&m_usage, m_pMemory, &m_symbols, &m_threads, STACK_USAGE_DEFAULT_FILL);
+    StackUsage_PrintReport(&m_usage);
+    CHECK_EQUAL(4, printfSpy_GetCallCount());
+    STRCMP_EQUAL("Stack usage (fill pattern 0xA5A5A5A5):\n", printfSpy_GetNthOutput(4));
+    STRCMP_EQUAL("  Main             0x20001800 - 0x20002000  2048 of 2048 bytes used (100%), 0 free"
+                 "  OVERFLOW? (no fill pattern left)\n",
+                 printfSpy_GetNthOutput(3));
+    STRCMP_EQUAL("  IDLE             0x20000400 - 0x20000800  256 of 1024 bytes used (25%), 768 free\n",
+                 printfSpy_GetNthOutput(2));
+    STRCMP_EQUAL("  Worker           0x20000800 - unknown     ? bytes used, 512 free\n",
+                 printfSpy_GetNthOutput(1));
+}
+
+TEST(StackUsage, PrintReport_StackNotFullyInDump_ShouldBeNoted)
+{
+    setSymbols("__StackLimit", RAM_BASE + RAM_SIZE - 0x100, "__StackTop", RAM_BASE + RAM_SIZE + 0x100);
+    StackUsage_Init(&m_usage, m_pMemory, &m_symbols, NULL, STACK_USAGE_DEFAULT_FILL);
+    StackUsage_PrintReport(&m_usage);
+    STRCMP_EQUAL("  Main             0x20001F00 - 0x20002100  256 of 512 bytes used (50%), 256 free"
+                 "  (stack isn't fully in dump)\n",
+                 printfSpy_GetLastOutput());
+}
@@ -66,6 +66,27 @@ TEST(StandardIComm, HasReceiveData_Return0_ShouldReturnFalse)
 }
 
 
+TEST(StandardIComm, WaitForReceiveData_ThrowException_ShouldReturnFalse)
+{
+    ConsoleMock_WaitForStdInData_SetException(fileException);
+    CHECK_FALSE(IComm_WaitForReceiveData(m_pComm, 50));
+}
+
+TEST(StandardIComm, WaitForReceiveData_Return1_ShouldReturnTrueAndPassTimeoutToConsole)
+{
+    ConsoleMock_WaitForStdInData_SetReturn(1);
+    CHECK_TRUE(IComm_WaitForReceiveData(m_pComm, 50));
+    CHECK_EQUAL(50, ConsoleMock_WaitForStdInData_GetLastTimeout());
+}
+
+TEST(StandardIComm, WaitForReceiveData_Return0_ShouldReturnFalse)
+{
+    ConsoleMock_WaitForStdInData_SetReturn(0);
+    CHECK_FALSE(IComm_WaitForReceiveData(m_pComm, 1000));
+    CHECK_EQUAL(1000, ConsoleMock_WaitForStdInData_GetLastTimeout());
+}
+
+
 TEST(StandardIComm, ReceiveChar_ThrowException_VerifyExceptionThrown)
 {
     ConsoleMock_ReadStdIn_SetException(fileException);
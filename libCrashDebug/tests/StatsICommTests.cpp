@@ -0,0 +1,163 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <mockClock.h>
+    #include <StatsIComm.h>
+}
+#include <mockIComm.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+TEST_GROUP(StatsIComm)
+{
+    IComm*          m_pComm;
+    const RspStats* m_pStats;
+
+    void setup()
+    {
+        m_pComm = StatsIComm_Init(mockIComm_Get(), 100);
+        m_pStats = StatsIComm_GetStats(m_pComm);
+        mockIComm_InitTransmitDataBuffer(64);
+    }
+
+    void teardown()
+    {
+        StatsIComm_Uninit(m_pComm);
+        mockIComm_Uninit();
+        ClockMock_Uninit();
+    }
+
+    void receiveAll(const char* pData)
+    {
+        size_t i;
+
+        mockIComm_InitReceiveData(pData);
+        for (i = 0 ; i < strlen(pData) ; i++)
+            CHECK_EQUAL(pData[i], IComm_ReceiveChar(m_pComm));
+    }
+
+    void sendAll(const char* pData)
+    {
+        while (*pData)
+            IComm_SendChar(m_pComm, *pData++);
+    }
+};
+
+
+TEST(StatsIComm, Init_ShouldStartWithNoStats)
+{
+    CHECK_FALSE(m_pStats->hasReceivedPacket);
+    CHECK_EQUAL(0, m_pStats->packets['m'].packetCount);
+    CHECK_EQUAL(0, m_pStats->packets['m'].bytesIn);
+    CHECK_EQUAL(0, m_pStats->packets['m'].bytesOut);
+}
+
+TEST(StatsIComm, ShouldForwardCallsToWrappedComm)
+{
+    mockIComm_SetShouldStopRunFlag(TRUE);
+    mockIComm_SetIsGdbConnectedFlag(FALSE);
+    mockIComm_InitReceiveData("+");
+    CHECK_TRUE(IComm_HasReceiveData(m_pComm));
+    CHECK_TRUE(IComm_WaitForReceiveData(m_pComm, 50));
+    CHECK_TRUE(IComm_ShouldStopRun(m_pComm));
+    CHECK_FALSE(IComm_IsGdbConnected(m_pComm));
+    CHECK_EQUAL('+', IComm_ReceiveChar(m_pComm));
+    sendAll("$OK#9a");
+    STRCMP_EQUAL("$OK#9a", mockIComm_GetTransmittedData());
+}
+
+TEST(StatsIComm, ReceivePacket_ShouldCountAllBytesAgainstPacketType)
+{
+    receiveAll("$m0,4#fd");
+    CHECK_EQUAL(1, m_pStats->packets['m'].packetCount);
+    CHECK_EQUAL(8, m_pStats->packets['m'].bytesIn);
+    CHECK_EQUAL(0, m_pStats->packets['$'].bytesIn);
+}
+
+TEST(StatsIComm, ReceiveAcksAndInterrupts_ShouldCountAgainstThatCharacter)
+{
+    receiveAll("+\x03+");
+    CHECK_EQUAL(2, m_pStats->packets['+'].bytesIn);
+    CHECK_EQUAL(1, m_pStats->packets[0x03].bytesIn);
+    CHECK_EQUAL(0, m_pStats->packets['+'].packetCount);
+    CHECK_FALSE(m_pStats->hasReceivedPacket);
+}
+
+TEST(StatsIComm, ReceiveEmptyPacket_ShouldCountAgainstPoundSign)
+{
+    receiveAll("$#00");
+    CHECK_EQUAL(1, m_pStats->packets['#'].packetCount);
+    CHECK_EQUAL(4, m_pStats->packets['#'].bytesIn);
+}
+
+TEST(StatsIComm, ReceiveMultiplePackets_ShouldCountEachType)
+{
+    receiveAll("$g#67+$m0,4#fd+$m4,4#01");
+    CHECK_EQUAL(1, m_pStats->packets['g'].packetCount);
+    CHECK_EQUAL(5, m_pStats->packets['g'].bytesIn);
+    CHECK_EQUAL(2, m_pStats->packets['m'].packetCount);
+    CHECK_EQUAL(16, m_pStats->packets['m'].bytesIn);
+    CHECK_EQUAL(2, m_pStats->packets['+'].bytesIn);
+}
+
+TEST(StatsIComm, FirstPacket_ShouldRecordTimeSinceStart)
+{
+    ClockMock_SetMicroseconds(350);
+    receiveAll("$g#67");
+    CHECK_TRUE(m_pStats->hasReceivedPacket);
+    CHECK_EQUAL(250, m_pStats->firstPacketMicroseconds);
+
+    ClockMock_SetMicroseconds(1000);
+    receiveAll("$g#67");
+    CHECK_EQUAL(250, m_pStats->firstPacketMicroseconds);
+}
+
+TEST(StatsIComm, SendResponse_ShouldCountBytesAndTimeAgainstRequestType)
+{
+    ClockMock_SetMicroseconds(1000);
+    ClockMock_SetIncrement(40);
+    receiveAll("$m0,4#fd");
+    sendAll("+$01020304#");
+    CHECK_EQUAL(0, m_pStats->packets['m'].responseMicroseconds);
+    sendAll("2a");
+    CHECK_EQUAL(13, m_pStats->packets['m'].bytesOut);
+    CHECK_EQUAL(40, m_pStats->packets['m'].responseMicroseconds);
+}
+
+TEST(StatsIComm, SendResponses_ShouldAccumulateTimeForEachRequest)
+{
+    ClockMock_SetIncrement(10);
+    receiveAll("$m0,4#fd");
+    sendAll("$OK#9a");
+    receiveAll("$m0,4#fd");
+    sendAll("$OK#9a");
+    CHECK_EQUAL(2, m_pStats->packets['m'].packetCount);
+    CHECK_EQUAL(20, m_pStats->packets['m'].responseMicroseconds);
+}
+
+TEST(StatsIComm, SendSecondPacketWithoutNewRequest_ShouldNotAddResponseTime)
+{
+    ClockMock_SetIncrement(10);
+    receiveAll("$c#63");
+    sendAll("$O41#b5");
+    sendAll("$T05#b9");
+    CHECK_EQUAL(14, m_pStats->packets['c'].bytesOut);
+    CHECK_EQUAL(10, m_pStats->packets['c'].responseMicroseconds);
+}
@@ -0,0 +1,212 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <PacketIComm.h>
+    #include <ThreadPackets.h>
+}
+#include <mockIComm.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define HALTED_ID   0x20000100
+#define BLOCKED_ID  0x20000200
+#define IDLE_ID     0x20000300
+
+TEST_GROUP(ThreadPackets)
+{
+    IComm*          m_pComm;
+    ThreadPackets   m_threadPackets;
+    RtosThread      m_threadArray[17];
+    RtosThreads     m_threads;
+    RegisterContext m_context;
+
+    void setup()
+    {
+        memset(m_threadArray, 0, sizeof(m_threadArray));
+        initThread(&m_threadArray[0], HALTED_ID, "main", "Running", 2);
+        initThread(&m_threadArray[1], BLOCKED_ID, "net", "Blocked", 3);
+        initThread(&m_threadArray[2], IDLE_ID, "IDLE", "Ready", 0);
+        m_threads.pThreads = m_threadArray;
+        m_threads.threadCount = 3;
+        m_threads.haltedThreadId = HALTED_ID;
+        m_context = m_threadArray[0].context;
+
+        ThreadPackets_Init(&m_threadPackets, &m_threads, &m_context);
+        m_pComm = PacketIComm_Init(mockIComm_Get());
+        PacketIComm_AddHandler(m_pComm, ThreadPackets_Handle, &m_threadPackets);
+        mockIComm_InitTransmitDataBuffer(512);
+    }
+
+    void teardown()
+    {
+        ThreadPackets_Uninit(&m_threadPackets);
+        PacketIComm_Uninit(m_pComm);
+        mockIComm_Uninit();
+    }
+
+    void initThread(RtosThread* pThread, uint32_t id, const char* pName, const char* pState, uint32_t priority)
+    {
+        pThread->id = id;
+        pThread->priority = priority;
+        pThread->pState = pState;
+        strcpy(pThread->name, pName);
+        for (size_t i = 0 ; i < ARRAY_SIZE(pThread->context.R) ; i++)
+            pThread->context.R[i] = id + i;
+    }
+
+    void receiveAll(const char* pData)
+    {
+        size_t i;
+
+        mockIComm_InitReceiveData(pData);
+        for (i = 0 ; i < strlen(pData) ; i++)
+            CHECK_EQUAL(pData[i], IComm_ReceiveChar(m_pComm));
+    }
+
+    // Sends pRequest followed by a packet which should make it through to the MRI core.
+    void receiveThreadPacket(const char* pRequest)
+    {
+        char data[256];
+
+        snprintf(data, sizeof(data), "%s+$g#", pRequest);
+        mockIComm_InitReceiveChecksummedData(data);
+        CHECK_EQUAL('$', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('g', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('#', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('6', IComm_ReceiveChar(m_pComm));
+        CHECK_EQUAL('7', IComm_ReceiveChar(m_pComm));
+    }
+
+    void validateResponse(const char* pExpectedResponse)
+    {
+        char expected[256];
+
+        snprintf(expected, sizeof(expected), "+$%s#", pExpectedResponse);
+        STRCMP_EQUAL(mockIComm_ChecksumData(expected), mockIComm_GetTransmittedData());
+    }
+};
+
+
+TEST(ThreadPackets, NonThreadPackets_ShouldPassThroughUnchanged)
+{
+    receiveAll("+\x03$m0,4#fd+$g#67");
+    STRCMP_EQUAL("", mockIComm_GetTransmittedData());
+}
+
+TEST(ThreadPackets, qfThreadInfo_ShouldListAllThreadIds)
+{
+    receiveThreadPacket("$qfThreadInfo#");
+    validateResponse("m20000100,20000200,20000300");
+}
+
+TEST(ThreadPackets, qsThreadInfoAfterAllThreadsListed_ShouldReturnEndOfList)
+{
+    receiveThreadPacket("$qfThreadInfo#+$qsThreadInfo#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$m20000100,20000200,20000300#+$l#"), mockIComm_GetTransmittedData());
+}
+
+TEST(ThreadPackets, qfThreadInfoWithManyThreads_ShouldSplitAcrossResponses)
+{
+    for (size_t i = 3 ; i < ARRAY_SIZE(m_threadArray) ; i++)
+        initThread(&m_threadArray[i], 0x20001000 + i, "task", "Ready", 1);
+    m_threads.threadCount = ARRAY_SIZE(m_threadArray);
+
+    receiveThreadPacket("$qfThreadInfo#+$qsThreadInfo#+$qsThreadInfo#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$m20000100,20000200,20000300,20001003,20001004,20001005,20001006,20001007,"
+                                        "20001008,20001009,2000100a,2000100b,2000100c,2000100d,2000100e,2000100f#"
+                                        "+$m20001010#+$l#"),
+                 mockIComm_GetTransmittedData());
+}
+
+TEST(ThreadPackets, qC_ShouldReturnHaltedThread)
+{
+    receiveThreadPacket("$qC#");
+    validateResponse("QC20000100");
+}
+
+TEST(ThreadPackets, qThreadExtraInfo_ShouldReturnHexEncodedNameStateAndPriority)
+{
+    receiveThreadPacket("$qThreadExtraInfo,20000200#");
+    // "net (Blocked, priority 3)"
+    validateResponse("6e65742028426c6f636b65642c207072696f72697479203329");
+}
+
+TEST(ThreadPackets, qThreadExtraInfoForUnknownThread_ShouldReturnError)
+{
+    receiveThreadPacket("$qThreadExtraInfo,1234#");
+    validateResponse("E01");
+}
+
+TEST(ThreadPackets, HgOtherThread_ShouldSwitchToItsRegisters)
+{
+    receiveThreadPacket("$Hg20000200#");
+    validateResponse("OK");
+    CHECK_EQUAL(BLOCKED_ID + PC, m_context.R[PC]);
+    CHECK_EQUAL(BLOCKED_ID + SP, m_context.R[SP]);
+}
+
+TEST(ThreadPackets, HgZeroAfterOtherThread_ShouldSwitchBackToHaltedRegisters)
+{
+    receiveThreadPacket("$Hg20000200#+$Hg0#");
+    CHECK_EQUAL(HALTED_ID + PC, m_context.R[PC]);
+}
+
+TEST(ThreadPackets, HgMinusOne_ShouldSelectHaltedThread)
+{
+    receiveThreadPacket("$Hg-1#");
+    validateResponse("OK");
+    CHECK_EQUAL(HALTED_ID + PC, m_context.R[PC]);
+}
+
+TEST(ThreadPackets, HgUnknownThread_ShouldReturnErrorAndKeepRegisters)
+{
+    receiveThreadPacket("$Hg1234#");
+    validateResponse("E01");
+    CHECK_EQUAL(HALTED_ID + PC, m_context.R[PC]);
+}
+
+TEST(ThreadPackets, RegistersModifiedInThread_ShouldBeKeptWhenSwitchingBack)
+{
+    receiveThreadPacket("$Hg20000200#");
+    m_context.R[R0] = 0xBAADF00D;
+    receiveThreadPacket("$Hg20000100#+$Hg20000200#");
+    CHECK_EQUAL(0xBAADF00D, m_context.R[R0]);
+}
+
+TEST(ThreadPackets, Hc_ShouldSucceedWithoutSwitchingRegisters)
+{
+    receiveThreadPacket("$Hc20000200#");
+    validateResponse("OK");
+    CHECK_EQUAL(HALTED_ID + PC, m_context.R[PC]);
+}
+
+TEST(ThreadPackets, ThreadAlive_ShouldSucceedForKnownThreadsOnly)
+{
+    receiveThreadPacket("$T20000300#+$T20000400#");
+    STRCMP_EQUAL(mockIComm_ChecksumData("+$OK#+$E01#"), mockIComm_GetTransmittedData());
+}
+
+TEST(ThreadPackets, Uninit_ShouldRestoreHaltedRegisters)
+{
+    receiveThreadPacket("$Hg20000300#");
+    CHECK_EQUAL(IDLE_ID + PC, m_context.R[PC]);
+    ThreadPackets_Uninit(&m_threadPackets);
+    CHECK_EQUAL(HALTED_ID + PC, m_context.R[PC]);
+}
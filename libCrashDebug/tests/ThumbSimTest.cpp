@@ -0,0 +1,491 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <MemorySim.h>
+    #include <ThumbSim.h>
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+#define FLASH_BASE  0x00000000
+#define FLASH_SIZE  0x400
+#define RAM_BASE    0x20000000
+#define RAM_SIZE    0x400
+#define DATA_BASE   (RAM_BASE + 0x200)
+
+#define EPSR_T      (1 << 24)
+#define APSR_N      (1U << 31)
+#define APSR_Z      (1 << 30)
+#define APSR_C      (1 << 29)
+#define APSR_V      (1 << 28)
+
+TEST_GROUP(ThumbSim)
+{
+    IMemory*        m_pMemory;
+    RegisterContext m_context;
+    ThumbSim        m_sim;
+    uint8_t         m_flash[FLASH_SIZE];
+    uint32_t        m_emitAddress;
+
+    void setup()
+    {
+        m_pMemory = MemorySim_Init();
+        memset(m_flash, 0, sizeof(m_flash));
+        MemorySim_CreateRegionFromHostBuffer(m_pMemory, FLASH_BASE, m_flash, sizeof(m_flash));
+        MemorySim_MakeRegionReadOnly(m_pMemory, FLASH_BASE);
+        MemorySim_CreateRegion(m_pMemory, RAM_BASE, RAM_SIZE);
+        memset(&m_context, 0, sizeof(m_context));
+        m_context.R[SP] = RAM_BASE + RAM_SIZE;
+        m_context.R[XPSR] = EPSR_T;
+        ThumbSim_Init(&m_sim, m_pMemory, &m_context);
+        startCodeAt(RAM_BASE);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        clearExceptionCode();
+        ThumbSim_Uninit(&m_sim);
+        MemorySim_Uninit(m_pMemory);
+    }
+
+    void startCodeAt(uint32_t address)
+    {
+        m_emitAddress = address;
+        m_context.R[PC] = address;
+    }
+
+    void emit16(uint16_t halfWord)
+    {
+        if (m_emitAddress < FLASH_BASE + FLASH_SIZE)
+        {
+            m_flash[m_emitAddress - FLASH_BASE] = (uint8_t)halfWord;
+            m_flash[m_emitAddress - FLASH_BASE + 1] = (uint8_t)(halfWord >> 8);
+        }
+        else
+        {
+            IMemory_Write16(m_pMemory, m_emitAddress, halfWord);
+        }
+        m_emitAddress += 2;
+    }
+
+    void emit32(uint16_t firstHalfWord, uint16_t secondHalfWord)
+    {
+        emit16(firstHalfWord);
+        emit16(secondHalfWord);
+    }
+
+    void run(uint32_t instructionCount, ThumbSimStopReason expectedStopReason = THUMB_SIM_STOP_COUNT)
+    {
+        CHECK_EQUAL(expectedStopReason, ThumbSim_Run(&m_sim, instructionCount));
+    }
+};
+
+
+TEST(ThumbSim, MovsImmediate_ShouldSetRegisterAndNZFlagsAndAdvancePC)
+{
+    emit16(0x2000);     // movs r0, #0
+    emit16(0x21ff);     // movs r1, #255
+    m_context.R[0] = 0x12345678;
+    run(1);
+    CHECK_EQUAL(0, m_context.R[0]);
+    CHECK_EQUAL(RAM_BASE + 2, m_context.R[PC]);
+    CHECK_EQUAL(EPSR_T | APSR_Z, m_context.R[XPSR]);
+    run(1);
+    CHECK_EQUAL(255, m_context.R[1]);
+    CHECK_EQUAL(RAM_BASE + 4, m_context.R[PC]);
+    CHECK_EQUAL(EPSR_T, m_context.R[XPSR]);
+    CHECK_EQUAL(2, ThumbSim_GetStats(&m_sim).instructions);
+}
+
+TEST(ThumbSim, AddsAndSubs_ShouldSetCarryAndOverflow)
+{
+    emit16(0x1842);     // adds r2, r0, r1
+    emit16(0x1a42);     // subs r2, r0, r1
+    m_context.R[0] = 0x7fffffff;
+    m_context.R[1] = 1;
+    run(1);
+    CHECK_EQUAL(0x80000000, m_context.R[2]);
+    CHECK_EQUAL(EPSR_T | APSR_N | APSR_V, m_context.R[XPSR]);
+    m_context.R[0] = 1;
+    run(1);
+    CHECK_EQUAL(0, m_context.R[2]);
+    CHECK_EQUAL(EPSR_T | APSR_Z | APSR_C, m_context.R[XPSR]);
+}
+
+TEST(ThumbSim, MovWideAndModifiedImmediate_ShouldBuild32BitConstants)
+{
+    emit32(0xf04f, 0x10ff);     // mov.w r0, #0x00ff00ff
+    emit32(0xf245, 0x6178);     // movw r1, #0x5678
+    emit32(0xf2c1, 0x2134);     // movt r1, #0x1234
+    run(3);
+    CHECK_EQUAL(0x00ff00ff, m_context.R[0]);
+    CHECK_EQUAL(0x12345678, m_context.R[1]);
+    CHECK_EQUAL(RAM_BASE + 12, m_context.R[PC]);
+}
+
+TEST(ThumbSim, LdrLiteralAndStrLdrImmediate_ShouldAccessMemory)
+{
+    emit16(0x4801);     // ldr r0, [pc, #4]
+    emit16(0x6041);     // str r1, [r0, #4]
+    emit16(0x6842);     // ldr r2, [r0, #4]
+    emit16(0xbf00);     // nop
+    emit32(DATA_BASE & 0xffff, DATA_BASE >> 16);
+    m_context.R[1] = 0xbaadf00d;
+    run(3);
+    CHECK_EQUAL(DATA_BASE, m_context.R[0]);
+    CHECK_EQUAL(0xbaadf00d, IMemory_Read32(m_pMemory, DATA_BASE + 4));
+    CHECK_EQUAL(0xbaadf00d, m_context.R[2]);
+}
+
+TEST(ThumbSim, BlPushPopPc_ShouldCallAndReturn)
+{
+    emit32(0xf000, 0xf804);     // bl function
+    emit16(0x2001);             // movs r0, #1
+    emit16(0xbf00);             // nop
+    emit16(0xbf00);             // nop
+    emit16(0xbf00);             // nop
+    emit16(0xb510);             // function: push {r4, lr}
+    emit16(0x2402);             // movs r4, #2
+    emit16(0xbd10);             // pop {r4, pc}
+    m_context.R[4] = 0x44444444;
+    run(1);
+    CHECK_EQUAL(RAM_BASE + 12, m_context.R[PC]);
+    CHECK_EQUAL(RAM_BASE + 4 + 1, m_context.R[LR]);
+    run(3);
+    CHECK_EQUAL(RAM_BASE + 4, m_context.R[PC]);
+    CHECK_EQUAL(0x44444444, m_context.R[4]);
+    CHECK_EQUAL(RAM_BASE + RAM_SIZE, m_context.R[SP]);
+    CHECK_EQUAL(0x44444444, IMemory_Read32(m_pMemory, RAM_BASE + RAM_SIZE - 8));
+    CHECK_EQUAL(EPSR_T, m_context.R[XPSR] & EPSR_T);
+    run(1);
+    CHECK_EQUAL(1, m_context.R[0]);
+}
+
+TEST(ThumbSim, ConditionalBranch_ShouldOnlyBranchWhenConditionPasses)
+{
+    emit16(0x2805);     // cmp r0, #5
+    emit16(0xd0fd);     // beq back to cmp
+    emit16(0x2101);     // movs r1, #1
+    m_context.R[0] = 5;
+    run(2);
+    CHECK_EQUAL(RAM_BASE, m_context.R[PC]);
+    m_context.R[0] = 4;
+    run(2);
+    CHECK_EQUAL(RAM_BASE + 4, m_context.R[PC]);
+}
+
+TEST(ThumbSim, IteBlock_ShouldExecuteOnlyOneOfThePairAndNotSetFlags)
+{
+    emit16(0x2800);     // cmp r0, #0
+    emit16(0xbf0c);     // ite eq
+    emit16(0x2101);     // moveq r1, #1
+    emit16(0x2102);     // movne r1, #2
+    emit16(0x2200);     // movs r2, #0
+    m_context.R[0] = 0;
+    run(4);
+    CHECK_EQUAL(1, m_context.R[1]);
+    CHECK_EQUAL(EPSR_T | APSR_Z | APSR_C, m_context.R[XPSR]);
+
+    startCodeAt(RAM_BASE);
+    m_context.R[0] = 1;
+    run(4);
+    CHECK_EQUAL(2, m_context.R[1]);
+    CHECK_EQUAL(EPSR_T | APSR_C, m_context.R[XPSR]);
+    run(1);
+    CHECK_EQUAL(EPSR_T | APSR_Z | APSR_C, m_context.R[XPSR]);
+}
+
+TEST(ThumbSim, StopInsideItBlock_ShouldSaveAndRestoreItStateInXpsr)
+{
+    emit16(0x2800);     // cmp r0, #0
+    emit16(0xbf0c);     // ite eq
+    emit16(0x2101);     // moveq r1, #1
+    emit16(0x2102);     // movne r1, #2
+    m_context.R[0] = 0;
+    run(3);
+    CHECK_EQUAL(1, m_context.R[1]);
+    CHECK_TRUE((m_context.R[XPSR] & 0x0600fc00) != 0);
+    run(1);
+    CHECK_EQUAL(1, m_context.R[1]);
+    CHECK_EQUAL(0, m_context.R[XPSR] & 0x0600fc00);
+}
+
+TEST(ThumbSim, CbzAndTbb_ShouldBranch)
+{
+    emit16(0xb110);     // cbz r0, tbb
+    emit16(0xbf00);     // nop
+    emit16(0xbf00);     // nop
+    emit16(0xbf00);     // nop
+    emit32(0xe8df, 0xf001);     // tbb [pc, r1]
+    emit16(0x0301);             // table: 1, 3
+    emit16(0x2001);             // movs r0, #1
+    emit16(0x2002);             // movs r0, #2
+    emit16(0x2003);             // movs r0, #3
+    m_context.R[0] = 0;
+    m_context.R[1] = 1;
+    run(1);
+    CHECK_EQUAL(RAM_BASE + 8, m_context.R[PC]);
+    run(1);
+    CHECK_EQUAL(RAM_BASE + 12 + 2 * 3, m_context.R[PC]);
+    run(1);
+    CHECK_EQUAL(3, m_context.R[0]);
+
+    startCodeAt(RAM_BASE);
+    m_context.R[0] = 1;
+    run(1);
+    CHECK_EQUAL(RAM_BASE + 2, m_context.R[PC]);
+}
+
+TEST(ThumbSim, DivideAndLongMultiply_ShouldMatchArchitecture)
+{
+    emit32(0xfbb0, 0xf2f1);     // udiv r2, r0, r1
+    emit32(0xfb90, 0xf2f1);     // sdiv r2, r0, r1
+    emit32(0xfba0, 0x2301);     // umull r2, r3, r0, r1
+    m_context.R[0] = 0xfffffff0;
+    m_context.R[1] = 0;
+    m_context.R[2] = 0x22222222;
+    run(1);
+    CHECK_EQUAL(0, m_context.R[2]);
+    m_context.R[1] = 0xfffffffc;
+    run(1);
+    CHECK_EQUAL(4, m_context.R[2]);
+    run(1);
+    CHECK_EQUAL(0x00000040, m_context.R[2]);
+    CHECK_EQUAL(0xffffffec, m_context.R[3]);
+}
+
+TEST(ThumbSim, BitfieldsAndShiftByRegister_ShouldMatchArchitecture)
+{
+    emit32(0xf3c0, 0x1107);     // ubfx r1, r0, #4, #8
+    emit32(0xf360, 0x220b);     // bfi r2, r0, #8, #4
+    emit16(0x4088);             // lsls r0, r1
+    m_context.R[0] = 0x80001234;
+    m_context.R[2] = 0xffffffff;
+    run(2);
+    CHECK_EQUAL(0x23, m_context.R[1]);
+    CHECK_EQUAL(0xfffff4ff, m_context.R[2]);
+    m_context.R[1] = 1;
+    run(1);
+    CHECK_EQUAL(0x00002468, m_context.R[0]);
+    CHECK_EQUAL(EPSR_T | APSR_C, m_context.R[XPSR]);
+}
+
+TEST(ThumbSim, CpsidAndMrs_ShouldTrackPrimask)
+{
+    emit16(0xb672);             // cpsid i
+    emit32(0xf3ef, 0x8010);     // mrs r0, primask
+    run(2);
+    CHECK_EQUAL(1, m_context.R[0]);
+}
+
+TEST(ThumbSim, MsrMsp_WithMainStackActive_ShouldAlsoUpdateSP)
+{
+    m_context.R[0] = RAM_BASE + 0x103;
+    emit32(0xf380, 0x8808);     // msr msp, r0
+    emit32(0xf3ef, 0x8108);     // mrs r1, msp
+    run(2);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[MSP]);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[SP]);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[1]);
+}
+
+TEST(ThumbSim, MsrPsp_WithMainStackActive_ShouldLeaveSPAlone)
+{
+    m_context.R[0] = RAM_BASE + 0x100;
+    emit32(0xf380, 0x8809);     // msr psp, r0
+    run(1);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[PSP]);
+    CHECK_EQUAL(RAM_BASE + RAM_SIZE, m_context.R[SP]);
+}
+
+TEST(ThumbSim, MsrControl_SetSpselInThreadMode_ShouldSwitchSPToPsp)
+{
+    m_context.R[0] = RAM_BASE + 0x100;
+    m_context.R[1] = 2;
+    emit32(0xf380, 0x8809);     // msr psp, r0
+    emit32(0xf381, 0x8814);     // msr control, r1
+    emit32(0xf3ef, 0x8208);     // mrs r2, msp
+    emit32(0xf380, 0x8809);     // msr psp, r0
+    run(4);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[SP]);
+    CHECK_EQUAL(RAM_BASE + RAM_SIZE, m_context.R[MSP]);
+    CHECK_EQUAL(RAM_BASE + RAM_SIZE, m_context.R[2]);
+}
+
+TEST(ThumbSim, MsrControl_ClearSpsel_ShouldBankPspAndRestoreMsp)
+{
+    m_context.R[0] = RAM_BASE + 0x100;
+    m_context.R[1] = 2;
+    m_context.R[2] = 0;
+    emit32(0xf380, 0x8809);     // msr psp, r0
+    emit32(0xf381, 0x8814);     // msr control, r1
+    emit16(0xb082);             // sub sp, #8
+    emit32(0xf382, 0x8814);     // msr control, r2
+    run(4);
+    CHECK_EQUAL(RAM_BASE + RAM_SIZE, m_context.R[SP]);
+    CHECK_EQUAL(RAM_BASE + 0x100 - 8, m_context.R[PSP]);
+}
+
+TEST(ThumbSim, MsrControl_SetSpselInHandlerMode_ShouldBeIgnored)
+{
+    m_context.R[XPSR] = EPSR_T | 3;
+    m_context.R[PSP] = RAM_BASE + 0x100;
+    m_context.R[1] = 2;
+    emit32(0xf381, 0x8814);     // msr control, r1
+    emit32(0xf3ef, 0x8014);     // mrs r0, control
+    run(2);
+    CHECK_EQUAL(0, m_context.R[0]);
+    CHECK_EQUAL(RAM_BASE + RAM_SIZE, m_context.R[SP]);
+}
+
+TEST(ThumbSim, Init_WithSPMatchingPspInThreadMode_ShouldSetSpsel)
+{
+    m_context.R[PSP] = m_context.R[SP];
+    m_context.R[MSP] = RAM_BASE + 0x100;
+    ThumbSim_Uninit(&m_sim);
+    ThumbSim_Init(&m_sim, m_pMemory, &m_context);
+    emit32(0xf3ef, 0x8014);     // mrs r0, control
+    emit32(0xf3ef, 0x8108);     // mrs r1, msp
+    run(2);
+    CHECK_EQUAL(2, m_context.R[0]);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[1]);
+}
+
+TEST(ThumbSim, Bkpt_ShouldStopWithPCAtBkpt)
+{
+    emit16(0x2001);     // movs r0, #1
+    emit16(0xbe00);     // bkpt #0
+    run(10, THUMB_SIM_STOP_BKPT);
+    CHECK_EQUAL(1, m_context.R[0]);
+    CHECK_EQUAL(RAM_BASE + 2, m_context.R[PC]);
+    CHECK_EQUAL(1, ThumbSim_GetStats(&m_sim).instructions);
+}
+
+TEST(ThumbSim, HardwareBreakpoint_ShouldStopBeforeExecutingInstruction)
+{
+    emit16(0x2001);     // movs r0, #1
+    emit16(0x2002);     // movs r0, #2
+    MemorySim_SetHardwareBreakpoint(m_pMemory, RAM_BASE + 2, 2);
+    run(10, THUMB_SIM_STOP_BREAKPOINT);
+    CHECK_EQUAL(1, m_context.R[0]);
+    CHECK_EQUAL(RAM_BASE + 2, m_context.R[PC]);
+}
+
+TEST(ThumbSim, Watchpoint_ShouldStopAfterAccessingInstruction)
+{
+    emit16(0x6041);     // str r1, [r0, #4]
+    emit16(0x2001);     // movs r0, #1
+    MemorySim_SetHardwareWatchpoint(m_pMemory, DATA_BASE + 4, 4, WATCHPOINT_WRITE);
+    m_context.R[0] = DATA_BASE;
+    m_context.R[1] = 0x11111111;
+    run(10, THUMB_SIM_STOP_WATCHPOINT);
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMemory, DATA_BASE + 4));
+    CHECK_EQUAL(RAM_BASE + 2, m_context.R[PC]);
+    CHECK_EQUAL(DATA_BASE, m_context.R[0]);
+}
+
+TEST(ThumbSim, LoadFromUnmappedMemory_ShouldStopWithBusFaultAndLeaveRegistersUnchanged)
+{
+    emit16(0xc806);     // ldm r0!, {r1, r2}
+    m_context.R[0] = 0x40000000;
+    run(1, THUMB_SIM_STOP_BUS_FAULT);
+    CHECK_EQUAL(0x40000000, m_context.R[0]);
+    CHECK_EQUAL(RAM_BASE, m_context.R[PC]);
+}
+
+TEST(ThumbSim, UnalignedLdm_ShouldStopWithUsageFault)
+{
+    emit16(0xc806);     // ldm r0!, {r1, r2}
+    m_context.R[0] = DATA_BASE + 2;
+    run(1, THUMB_SIM_STOP_USAGE_FAULT);
+    CHECK_EQUAL(DATA_BASE + 2, m_context.R[0]);
+}
+
+TEST(ThumbSim, FloatingPointInstruction_ShouldStopWithUsageFault)
+{
+    emit32(0xee30, 0x0a00);     // vadd.f32 s0, s0, s0
+    run(1, THUMB_SIM_STOP_USAGE_FAULT);
+    CHECK_EQUAL(RAM_BASE, m_context.R[PC]);
+}
+
+TEST(ThumbSim, BxToEvenAddress_ShouldStopWithUsageFaultOnNextInstruction)
+{
+    emit16(0x4700);     // bx r0
+    m_context.R[0] = RAM_BASE + 0x100;
+    run(2, THUMB_SIM_STOP_USAGE_FAULT);
+    CHECK_EQUAL(RAM_BASE + 0x100, m_context.R[PC]);
+    CHECK_EQUAL(0, m_context.R[XPSR] & EPSR_T);
+}
+
+TEST(ThumbSim, LoopInFlash_ShouldOnlyDecodeEachInstructionOnce)
+{
+    startCodeAt(FLASH_BASE + 0x100);
+    emit16(0x3001);     // loop: adds r0, #1
+    emit16(0xe7fd);     // b loop
+    run(100);
+    CHECK_EQUAL(50, m_context.R[0]);
+    ThumbSimStats stats = ThumbSim_GetStats(&m_sim);
+    CHECK_EQUAL(100, stats.instructions);
+    CHECK_EQUAL(2, stats.decodes);
+    CHECK_EQUAL(98, stats.cacheHits);
+    CHECK_EQUAL(50, MemorySim_GetFlashReadCount(m_pMemory, FLASH_BASE + 0x100));
+}
+
+TEST(ThumbSim, HalfWordDataReadsOfBreakpointAddress_ShouldNotStopOrCountAsFetches)
+{
+    m_flash[0x200] = 0x02;
+    m_context.R[0] = FLASH_BASE + 0x200;
+    m_context.R[3] = 0;
+    MemorySim_SetHardwareBreakpoint(m_pMemory, FLASH_BASE + 0x200, 2);
+    emit16(0x8801);             // ldrh r1, [r0]
+    emit16(0x5ec2);             // ldrsh r2, [r0, r3]
+    emit32(0xe8d0, 0xf013);     // tbh [r0, r3]
+    run(3);
+    CHECK_EQUAL(2, m_context.R[1]);
+    CHECK_EQUAL(2, m_context.R[2]);
+    CHECK_EQUAL(RAM_BASE + 4 + 4 + 2 * 2, m_context.R[PC]);
+    CHECK_EQUAL(0, MemorySim_GetFlashReadCount(m_pMemory, FLASH_BASE + 0x200));
+}
+
+TEST(ThumbSim, LoopInFlash_ShouldStillHitBreakpointsAfterCaching)
+{
+    startCodeAt(FLASH_BASE + 0x100);
+    emit16(0x3001);     // loop: adds r0, #1
+    emit16(0xe7fd);     // b loop
+    run(10);
+    MemorySim_SetHardwareBreakpoint(m_pMemory, FLASH_BASE + 0x102, 2);
+    run(10, THUMB_SIM_STOP_BREAKPOINT);
+    CHECK_EQUAL(FLASH_BASE + 0x102, m_context.R[PC]);
+    CHECK_EQUAL(6, m_context.R[0]);
+}
+
+TEST(ThumbSim, LoopInRam_ShouldDecodeEveryTimeToSeeModifiedCode)
+{
+    emit16(0x3001);     // loop: adds r0, #1
+    emit16(0xe7fd);     // b loop
+    run(4);
+    CHECK_EQUAL(2, m_context.R[0]);
+    IMemory_Write16(m_pMemory, RAM_BASE, 0x3002);   // adds r0, #2
+    run(2);
+    CHECK_EQUAL(4, m_context.R[0]);
+    ThumbSimStats stats = ThumbSim_GetStats(&m_sim);
+    CHECK_EQUAL(6, stats.decodes);
+    CHECK_EQUAL(0, stats.cacheHits);
+}
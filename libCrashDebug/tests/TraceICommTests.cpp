@@ -0,0 +1,258 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <common.h>
+    #include <FileFailureInject.h>
+    #include <mockClock.h>
+    #include <printfSpy.h>
+    #include <TraceIComm.h>
+}
+#include <mockIComm.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+static const char* g_traceFilename = "TraceICommTest.trace";
+
+
+TEST_GROUP(TraceIComm)
+{
+    IComm*       m_pComm;
+    TraceRecord* m_pRecords;
+    size_t       m_recordCount;
+
+    void setup()
+    {
+        m_pComm = NULL;
+        m_pRecords = NULL;
+        m_recordCount = 0;
+        mockIComm_InitTransmitDataBuffer(64);
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(noException, getExceptionCode());
+        TraceIComm_Uninit(m_pComm);
+        free(m_pRecords);
+        fopenRestore();
+        fwriteRestore();
+        printfSpy_Unhook();
+        mockIComm_Uninit();
+        ClockMock_Uninit();
+        remove(g_traceFilename);
+    }
+
+    void initTrace()
+    {
+        m_pComm = TraceIComm_Init(mockIComm_Get(), g_traceFilename);
+    }
+
+    void receiveAll(const char* pData)
+    {
+        size_t i;
+
+        mockIComm_InitReceiveData(pData);
+        for (i = 0 ; i < strlen(pData) ; i++)
+            CHECK_EQUAL(pData[i], IComm_ReceiveChar(m_pComm));
+    }
+
+    void sendAll(const char* pData)
+    {
+        while (*pData)
+            IComm_SendChar(m_pComm, *pData++);
+    }
+
+    void readTraceRecords()
+    {
+        char     signature[TRACE_FILE_SIGNATURE_SIZE];
+        uint32_t version = 0;
+        long     fileSize = 0;
+
+        TraceIComm_Uninit(m_pComm);
+        FILE* pFile = fopen(g_traceFilename, "rb");
+        CHECK(pFile != NULL);
+        fseek(pFile, 0, SEEK_END);
+        fileSize = ftell(pFile);
+        fseek(pFile, 0, SEEK_SET);
+        CHECK_EQUAL(sizeof(signature), fread(signature, 1, sizeof(signature), pFile));
+        CHECK_EQUAL(sizeof(version), fread(&version, 1, sizeof(version), pFile));
+        CHECK_EQUAL(0, memcmp(TRACE_FILE_SIGNATURE, signature, sizeof(signature)));
+        CHECK_EQUAL(TRACE_FILE_VERSION, version);
+        m_recordCount = (fileSize - sizeof(signature) - sizeof(version)) / sizeof(TraceRecord);
+        m_pRecords = (TraceRecord*)malloc(m_recordCount * sizeof(TraceRecord) + 1);
+        CHECK_EQUAL(m_recordCount, fread(m_pRecords, sizeof(TraceRecord), m_recordCount, pFile));
+        fclose(pFile);
+    }
+};
+
+
+TEST(TraceIComm, FailToCreateFile_ShouldThrow)
+{
+    fopenSetReturn(NULL);
+    __try_and_catch( initTrace() );
+    fopenRestore();
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("Failed to create \"TraceICommTest.trace\" trace file.", getExceptionMessage());
+}
+
+TEST(TraceIComm, FailToWriteHeader_ShouldThrow)
+{
+    fwriteFail(0);
+    __try_and_catch( initTrace() );
+    fwriteRestore();
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+    STRCMP_EQUAL("Failed to write \"TraceICommTest.trace\" trace file.", getExceptionMessage());
+}
+
+TEST(TraceIComm, NoTraffic_ShouldWriteHeaderOnly)
+{
+    initTrace();
+    readTraceRecords();
+    CHECK_EQUAL(0, m_recordCount);
+    CHECK_EQUAL(0, TraceIComm_GetHistogram(m_pComm, 'm')->count);
+}
+
+TEST(TraceIComm, ShouldForwardCallsToWrappedComm)
+{
+    initTrace();
+    mockIComm_SetShouldStopRunFlag(TRUE);
+    mockIComm_SetIsGdbConnectedFlag(FALSE);
+    mockIComm_InitReceiveData("+");
+    CHECK_TRUE(IComm_HasReceiveData(m_pComm));
+    CHECK_TRUE(IComm_WaitForReceiveData(m_pComm, 50));
+    CHECK_TRUE(IComm_ShouldStopRun(m_pComm));
+    CHECK_FALSE(IComm_IsGdbConnected(m_pComm));
+    CHECK_EQUAL('+', IComm_ReceiveChar(m_pComm));
+    sendAll("$OK#9a");
+    STRCMP_EQUAL("$OK#9a", mockIComm_GetTransmittedData());
+}
+
+TEST(TraceIComm, RequestAndResponse_ShouldTimeFromFirstRequestByteToLastResponseByte)
+{
+    ClockMock_SetMicroseconds(1000);
+    initTrace();
+    ClockMock_SetMicroseconds(1500);
+    ClockMock_SetIncrement(100);
+    receiveAll("$m0,4#fd");
+    sendAll("+$01020304#2a");
+    readTraceRecords();
+
+    CHECK_EQUAL(1, m_recordCount);
+    CHECK_EQUAL(500, m_pRecords[0].requestMicroseconds);
+    CHECK_EQUAL(100, m_pRecords[0].latencyMicroseconds);
+    CHECK_EQUAL('m', m_pRecords[0].packetType);
+    const TraceHistogram* pHistogram = TraceIComm_GetHistogram(m_pComm, 'm');
+    CHECK_EQUAL(1, pHistogram->count);
+    CHECK_EQUAL(100, pHistogram->maxMicroseconds);
+    CHECK_EQUAL(1, pHistogram->buckets[7]);
+}
+
+TEST(TraceIComm, AcksAndExtraPackets_ShouldNotBeTraced)
+{
+    initTrace();
+    receiveAll("+");
+    sendAll("$O41#b5");
+    receiveAll("$c#63+");
+    sendAll("+$T05#b9");
+    sendAll("$O41#b5");
+    readTraceRecords();
+
+    CHECK_EQUAL(1, m_recordCount);
+    CHECK_EQUAL('c', m_pRecords[0].packetType);
+}
+
+TEST(TraceIComm, EmptyRequestPacket_ShouldBeTracedAgainstPoundSign)
+{
+    initTrace();
+    receiveAll("$#00");
+    sendAll("$#00");
+    readTraceRecords();
+
+    CHECK_EQUAL(1, m_recordCount);
+    CHECK_EQUAL('#', m_pRecords[0].packetType);
+}
+
+TEST(TraceIComm, FailToWriteRecord_ShouldStopTracingButKeepHistogramsAndWarn)
+{
+    initTrace();
+    fwriteFail(0);
+    receiveAll("$g#67");
+    sendAll("$00#60");
+    fwriteRestore();
+    receiveAll("$g#67");
+    sendAll("$00#60");
+    CHECK_TRUE(TraceIComm_HasWriteFailed(m_pComm));
+    CHECK_EQUAL(2, TraceIComm_GetHistogram(m_pComm, 'g')->count);
+    readTraceRecords();
+    CHECK_EQUAL(0, m_recordCount);
+
+    printfSpy_Hook(128);
+    TraceIComm_PrintSummary(m_pComm);
+    STRCMP_EQUAL("WARNING: Failed to write all records to the trace file.\n", printfSpy_GetLastErrorOutput());
+}
+
+TEST(TraceIComm, PrintSummary_ShouldPrintPercentilesForEachPacketTypeSeen)
+{
+    static const uint32_t latencies[] = { 3, 3, 5, 9, 200 };
+    size_t                i;
+
+    initTrace();
+    for (i = 0 ; i < ARRAY_SIZE(latencies) ; i++)
+    {
+        ClockMock_SetIncrement(latencies[i]);
+        receiveAll("$m0,4#fd");
+        sendAll("$OK#9a");
+    }
+    ClockMock_SetIncrement(0);
+    receiveAll("$g#67");
+    sendAll("$00#60");
+    printfSpy_Hook(128);
+    TraceIComm_PrintSummary(m_pComm);
+
+    CHECK_EQUAL(3, printfSpy_GetCallCount());
+    STRCMP_EQUAL("  g               1            0            0            0            0\n",
+                 printfSpy_GetPreviousErrorOutput());
+    STRCMP_EQUAL("  m               5            7          200          200          200\n",
+                 printfSpy_GetLastErrorOutput());
+}
+
+TEST(TraceIComm, GetPercentile_EmptyHistogram_ShouldReturnZero)
+{
+    TraceHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    CHECK_EQUAL(0, TraceHistogram_GetPercentile(&histogram, 50));
+}
+
+TEST(TraceIComm, GetPercentile_ShouldReturnUpperBoundOfBucketClampedToMax)
+{
+    TraceHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    histogram.count = 100;
+    histogram.buckets[0] = 50;
+    histogram.buckets[4] = 49;
+    histogram.buckets[31] = 1;
+    histogram.maxMicroseconds = 0x90000000;
+    CHECK_EQUAL(0, TraceHistogram_GetPercentile(&histogram, 0));
+    CHECK_EQUAL(0, TraceHistogram_GetPercentile(&histogram, 50));
+    CHECK_EQUAL(15, TraceHistogram_GetPercentile(&histogram, 51));
+    CHECK_EQUAL(15, TraceHistogram_GetPercentile(&histogram, 99));
+    CHECK_EQUAL(0x90000000, TraceHistogram_GetPercentile(&histogram, 100));
+}
@@ -34,9 +34,10 @@ TEST_GROUP_BASE(breakpointTests, mriPlatformBase)
 };
 
 
-TEST(breakpointTests, Set16bitBreakpoint_ShouldBeIgnored)
+TEST(breakpointTests, Set16bitBreakpoint_ShouldSetInMemorySim)
 {
-    char commands[64];
+    char     commands[64];
+    uint16_t instruction;
     snprintf(commands, sizeof(commands), "+$Z1,%x,2#", INITIAL_PC + 6);
     mockIComm_InitReceiveChecksummedData(commands, "+$c#");
         mriPlatform_Run(mockIComm_Get());
@@ -44,11 +45,15 @@ TEST(breakpointTests, Set16bitBreakpoint_ShouldBeIgnored)
     appendExpectedString("+$OK#+");
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 4, &instruction));
+    CHECK_FALSE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 6, &instruction));
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 8, &instruction));
 }
 
-TEST(breakpointTests, Set32bitBreakpoint_ShouldBeIgnored)
+TEST(breakpointTests, Set32bitBreakpoint_ShouldSetInMemorySim)
 {
-    char commands[64];
+    char     commands[64];
+    uint16_t instruction;
     snprintf(commands, sizeof(commands), "+$Z1,%x,3#", INITIAL_PC + 6);
     mockIComm_InitReceiveChecksummedData(commands, "+$c#");
         mriPlatform_Run(mockIComm_Get());
@@ -56,11 +61,15 @@ TEST(breakpointTests, Set32bitBreakpoint_ShouldBeIgnored)
     appendExpectedString("+$OK#+");
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 4, &instruction));
+    CHECK_FALSE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 6, &instruction));
+    CHECK_FALSE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 8, &instruction));
 }
 
-TEST(breakpointTests, SetBreakpointHit_ClearBreakpoint_ShouldBeIgnored)
+TEST(breakpointTests, SetBreakpoint_ClearBreakpoint_ShouldRemoveFromMemorySim)
 {
-    char commands[64];
+    char     commands[64];
+    uint16_t instruction;
     snprintf(commands, sizeof(commands), "+$Z1,%x,2#", INITIAL_PC + 4);
     mockIComm_InitReceiveChecksummedData(commands, "+$c#");
         mriPlatform_Run(mockIComm_Get());
@@ -78,11 +87,13 @@ TEST(breakpointTests, SetBreakpointHit_ClearBreakpoint_ShouldBeIgnored)
     appendExpectedString("+$OK#+");
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 4, &instruction));
 }
 
-TEST(breakpointTests, Set32bitBreakpoint_Clear32bitBreakpoint_ShouldBeIgnored)
+TEST(breakpointTests, Set32bitBreakpoint_Clear32bitBreakpoint_ShouldRemoveFromMemorySim)
 {
-    char commands[64];
+    char     commands[64];
+    uint16_t instruction;
     snprintf(commands, sizeof(commands), "+$Z1,%x,3#", INITIAL_PC + 6);
     mockIComm_InitReceiveChecksummedData(commands, "+$c#");
         mriPlatform_Run(mockIComm_Get());
@@ -100,4 +111,27 @@ TEST(breakpointTests, Set32bitBreakpoint_Clear32bitBreakpoint_ShouldBeIgnored)
     appendExpectedString("+$OK#+");
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 6, &instruction));
+    CHECK_TRUE(IMemory_TryRead16(m_pMemory, INITIAL_PC + 8, &instruction));
+}
+
+TEST(breakpointTests, SetBreakpointAndContinue_ShouldStopAtBreakpoint)
+{
+    char commands[64];
+    emitMOVimmediate(R0, 1);
+    emitMOVimmediate(R1, 2);
+    emitMOVimmediate(R2, 3);
+    snprintf(commands, sizeof(commands), "+$Z1,%x,2#", INITIAL_PC + 4);
+    mockIComm_InitReceiveChecksummedData(commands, "+$c#+$c#");
+    mockIComm_SetShouldStopRunFlag(2);
+        mriPlatform_Run(mockIComm_Get());
+    appendExpectedTPacket(SIGTRAP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+$OK#+");
+    appendExpectedTPacket(SIGTRAP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC + 4);
+    appendExpectedString("+");
+    STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
+    CHECK_EQUAL(1, m_context.R[R0]);
+    CHECK_EQUAL(2, m_context.R[R1]);
+    CHECK_EQUAL(0x22222222, m_context.R[R2]);
+    CHECK_EQUAL(INITIAL_PC + 4, m_context.R[PC]);
 }
@@ -37,7 +37,7 @@ TEST(continueTests, AttemptToContinue_ShouldRemainWhereItWas)
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
 }
 
-TEST(continueTests, AttemptToContinueWithNewPC_ShouldRemainWhereItWas)
+TEST(continueTests, ContinueWithNewPC_ShouldUpdatePC)
 {
     setIPSR(0);
     mockIComm_InitReceiveChecksummedData("+$cbaadfeed#");
@@ -45,10 +45,10 @@ TEST(continueTests, AttemptToContinueWithNewPC_ShouldRemainWhereItWas)
     appendExpectedTPacket(SIGSTOP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
     appendExpectedString("+");
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
-    CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+    CHECK_EQUAL(0xbaadfeed, m_context.R[PC]);
 }
 
-TEST(continueTests, AttemptToContinueAndSkipHardcodedBreakpoint_ShouldRemainWhereItWas)
+TEST(continueTests, ContinueFromHardcodedBreakpoint_ShouldAdvancePastIt)
 {
     setIPSR(0);
     emitBKPT(0);
@@ -57,5 +57,43 @@ TEST(continueTests, AttemptToContinueAndSkipHardcodedBreakpoint_ShouldRemainWher
     appendExpectedTPacket(SIGSTOP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
     appendExpectedString("+");
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
-    CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+    CHECK_EQUAL(INITIAL_PC + 2, m_context.R[PC]);
+}
+
+TEST(continueTests, Continue_ShouldExecuteUntilHardcodedBreakpoint)
+{
+    setIPSR(0);
+    emitMOVimmediate(R0, 0x12);
+    emitMOVimmediate(R1, 0x34);
+    emitBKPT(0);
+    mockIComm_InitReceiveChecksummedData("+$c#", "+$c#");
+    mockIComm_SetShouldStopRunFlag(2);
+        mriPlatform_Run(mockIComm_Get());
+    appendExpectedTPacket(SIGSTOP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+");
+    appendExpectedTPacket(SIGTRAP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC + 4);
+    appendExpectedString("+");
+    STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
+    CHECK_EQUAL(0x12, m_context.R[R0]);
+    CHECK_EQUAL(0x34, m_context.R[R1]);
+    // The second continue skips over the hardcoded breakpoint.
+    CHECK_EQUAL(INITIAL_PC + 6, m_context.R[PC]);
+}
+
+TEST(continueTests, Continue_ShouldStopWithSIGBUSOnUnmappedLoad)
+{
+    setIPSR(0);
+    setRegisterValue(R1, 0xFFFFFFF0);
+    emitMOVimmediate(R0, 0x12);
+    emitLDRImmediate(R2, R1, 0);
+    mockIComm_InitReceiveChecksummedData("+$c#", "+$c#");
+    mockIComm_SetShouldStopRunFlag(2);
+        mriPlatform_Run(mockIComm_Get());
+    appendExpectedTPacket(SIGSTOP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+");
+    appendExpectedTPacket(SIGBUS, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC + 2);
+    appendExpectedString("+");
+    STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
+    CHECK_EQUAL(0x12, m_context.R[R0]);
+    CHECK_EQUAL(0x22222222, m_context.R[R2]);
 }
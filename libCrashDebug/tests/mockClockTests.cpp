@@ -0,0 +1,56 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+// Include headers from C modules under test.
+extern "C"
+{
+    #include <Clock.h>
+    #include <mockClock.h>
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+
+TEST_GROUP(Clock)
+{
+    void setup()
+    {
+    }
+
+    void teardown()
+    {
+        ClockMock_Uninit();
+    }
+};
+
+
+TEST(Clock, DefaultsToZeroWithoutAdvancing)
+{
+    CHECK_EQUAL(0, Clock_GetMicroseconds());
+    CHECK_EQUAL(0, Clock_GetMicroseconds());
+}
+
+TEST(Clock, SetMicroseconds_ShouldReturnThatTime)
+{
+    ClockMock_SetMicroseconds(0x100000000ULL);
+    CHECK_EQUAL(0x100000000ULL, Clock_GetMicroseconds());
+}
+
+TEST(Clock, SetIncrement_ShouldAdvanceAfterEachCall)
+{
+    ClockMock_SetMicroseconds(10);
+    ClockMock_SetIncrement(5);
+    CHECK_EQUAL(10, Clock_GetMicroseconds());
+    CHECK_EQUAL(15, Clock_GetMicroseconds());
+    CHECK_EQUAL(20, Clock_GetMicroseconds());
+}
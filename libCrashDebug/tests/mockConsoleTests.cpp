@@ -61,6 +61,28 @@ TEST(Console, HasStdinDataToRead_SetToThrow_VerifyException)
 
 
 
+TEST(Console, WaitForStdInData_ShouldDefaultToReturn0)
+{
+    CHECK_EQUAL(0, Console_WaitForStdInData(100));
+}
+
+TEST(Console, WaitForStdInData_SetToReturn1_VerifyReturnAndTimeout)
+{
+    ConsoleMock_WaitForStdInData_SetReturn(1);
+        int result = Console_WaitForStdInData(250);
+    CHECK_EQUAL(1, result);
+    CHECK_EQUAL(250, ConsoleMock_WaitForStdInData_GetLastTimeout());
+}
+
+TEST(Console, WaitForStdInData_SetToThrow_VerifyException)
+{
+    ConsoleMock_WaitForStdInData_SetException(fileException);
+        __try_and_catch( Console_WaitForStdInData(100) );
+    CHECK_EQUAL(fileException, getExceptionCode());
+    clearExceptionCode();
+}
+
+
 TEST(Console, ReadStdIn_ShouldDefaultToEmptyBufferAndReturnZero)
 {
     int result = Console_ReadStdIn();
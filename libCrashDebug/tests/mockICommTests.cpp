@@ -59,6 +59,16 @@ TEST(mockIComm, IComm_HasRecieveData_NotEmpty_ButDelayResponseByTwoCalls)
     CHECK_TRUE( IComm_HasReceiveData(mockIComm_Get()) );
 }
 
+TEST(mockIComm, IComm_WaitForReceiveData_ShouldActLikeHasReceiveData)
+{
+    static const char testData[] = "$";
+
+    mockIComm_InitReceiveData(testData);
+    mockIComm_DelayReceiveData(1);
+    CHECK_FALSE( IComm_WaitForReceiveData(mockIComm_Get(), 50) );
+    CHECK_TRUE( IComm_WaitForReceiveData(mockIComm_Get(), 50) );
+}
+
 TEST(mockIComm, IComm_RecieveChar_NotEmpty)
 {
     static const char testData[] = "$";
@@ -290,6 +300,15 @@ TEST(mockIComm, ShouldStopRun_SetToReturnTrue)
     CHECK_TRUE(IComm_ShouldStopRun(mockIComm_Get()));
 }
 
+TEST(mockIComm, ShouldStopRun_SetToCountDownBeforeReturningTrue)
+{
+    mockIComm_SetShouldStopRunFlag(3);
+    CHECK_FALSE(IComm_ShouldStopRun(mockIComm_Get()));
+    CHECK_FALSE(IComm_ShouldStopRun(mockIComm_Get()));
+    CHECK_TRUE(IComm_ShouldStopRun(mockIComm_Get()));
+    CHECK_TRUE(IComm_ShouldStopRun(mockIComm_Get()));
+}
+
 TEST(mockIComm, IsGdbConnected_ShouldDefaultToReturnTrue)
 {
     CHECK_TRUE(IComm_IsGdbConnected(mockIComm_Get()));
@@ -104,6 +104,7 @@ protected:
     void teardown()
     {
         printfSpy_Unhook();
+        mriPlatform_Uninit();
         MemorySim_Uninit(m_pMemory);
         mockIComm_Uninit();
     }
@@ -56,3 +56,38 @@ TEST(otherTests, CallAPIsNotUsedByMRI_GuaranteeCoverage)
 
     Semihost_HandleSemihostRequest();
 }
+
+TEST(otherTests, CommIsWaitingForGdbToConnect_ShouldWaitForDataUntilGdbConnects)
+{
+    mockIComm_SetIsGdbConnectedFlag(FALSE);
+    mockIComm_InitReceiveData("");
+    CHECK_TRUE(Platform_CommIsWaitingForGdbToConnect());
+    mockIComm_SetIsGdbConnectedFlag(TRUE);
+    CHECK_FALSE(Platform_CommIsWaitingForGdbToConnect());
+}
+
+TEST(otherTests, RequestStopBeforeRun_ShouldReturnWhileWaitingForFirstPacket)
+{
+    mockIComm_InitReceiveData("");
+    mockIComm_SetShouldStopRunFlag(0);
+    mriPlatform_RequestStop();
+        mriPlatform_Run(mockIComm_Get());
+    CHECK_EQUAL(noException, getExceptionCode());
+}
+
+TEST(otherTests, RequestStop_ShouldMakeCommHasReceiveDataThrow)
+{
+    mockIComm_InitReceiveData("+");
+    mriPlatform_RequestStop();
+    __try_and_catch( Platform_CommHasReceiveData() );
+    CHECK_EQUAL(stopRequestedException, getExceptionCode());
+    clearExceptionCode();
+}
+
+TEST(otherTests, CommHasReceiveData_ShouldReturnWhetherDataIsAvailable)
+{
+    mockIComm_InitReceiveData("+");
+    CHECK_TRUE(Platform_CommHasReceiveData());
+    mockIComm_InitReceiveData("");
+    CHECK_FALSE(Platform_CommHasReceiveData());
+}
@@ -37,3 +37,36 @@ TEST(stepTests, AttemptToStep_ShouldRemainWhereItWas)
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
 }
+
+TEST(stepTests, Step_ShouldExecuteOneInstructionAndStopWithSIGTRAP)
+{
+    setIPSR(0);
+    emitMOVimmediate(R0, 0x12);
+    emitMOVimmediate(R1, 0x34);
+    mockIComm_InitReceiveChecksummedData("+$s#", "+$s#");
+    mockIComm_SetShouldStopRunFlag(2);
+        mriPlatform_Run(mockIComm_Get());
+    appendExpectedTPacket(SIGSTOP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+");
+    appendExpectedTPacket(SIGTRAP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC + 2);
+    appendExpectedString("+");
+    STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
+    CHECK_EQUAL(0x12, m_context.R[R0]);
+    CHECK_EQUAL(0x11111111, m_context.R[R1]);
+    CHECK_EQUAL(INITIAL_PC + 2, m_context.R[PC]);
+}
+
+TEST(stepTests, StepOverUndefinedInstruction_ShouldStopWithSIGILLAndNotAdvance)
+{
+    setIPSR(0);
+    emitUND(0);
+    mockIComm_InitReceiveChecksummedData("+$s#", "+$s#");
+    mockIComm_SetShouldStopRunFlag(2);
+        mriPlatform_Run(mockIComm_Get());
+    appendExpectedTPacket(SIGSTOP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+");
+    appendExpectedTPacket(SIGILL, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+");
+    STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
+    CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
+}
@@ -36,7 +36,7 @@ TEST_GROUP_BASE(watchpointTests, mriPlatformBase)
 };
 
 
-TEST(watchpointTests, Set4ByteReadWatchpoint_ShouldBeIgnored)
+TEST(watchpointTests, Set4ByteReadWatchpoint_ShouldOnlyTriggerOnRead)
 {
     char commands[64];
     snprintf(commands, sizeof(commands), "+$Z3,%x,4#", INITIAL_SP - 4);
@@ -48,12 +48,14 @@ TEST(watchpointTests, Set4ByteReadWatchpoint_ShouldBeIgnored)
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
 
+    IMemory_Write32(m_pMemory, INITIAL_SP - 4, 0xBAADF00D);
+    CHECK_FALSE(MemorySim_WasWatchpointEncountered(m_pMemory));
     uint32_t value = IMemory_Read32(m_pMemory, INITIAL_SP - 4);
     CHECK_EQUAL(0xBAADF00D, value);
-    CHECK_FALSE(MemorySim_WasWatchpointEncountered(m_pMemory));
+    CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
 }
 
-TEST(watchpointTests, Set4ByteWriteWatchpoint_ShouldBeIgnored)
+TEST(watchpointTests, Set4ByteWriteWatchpoint_ShouldOnlyTriggerOnWrite)
 {
     char commands[64];
     snprintf(commands, sizeof(commands), "+$Z2,%x,4#", INITIAL_SP - 4);
@@ -64,11 +66,13 @@ TEST(watchpointTests, Set4ByteWriteWatchpoint_ShouldBeIgnored)
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
 
-    IMemory_Write32(m_pMemory, INITIAL_SP - 4, 0xBAADF00D);
+    IMemory_Read32(m_pMemory, INITIAL_SP - 4);
     CHECK_FALSE(MemorySim_WasWatchpointEncountered(m_pMemory));
+    IMemory_Write32(m_pMemory, INITIAL_SP - 4, 0xBAADF00D);
+    CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
 }
 
-TEST(watchpointTests, Set4ByteReadWriteWatchpoint_ShouldBeIgnored)
+TEST(watchpointTests, Set4ByteReadWriteWatchpoint_ShouldTriggerOnReadAndWrite)
 {
     char commands[64];
     snprintf(commands, sizeof(commands), "+$Z4,%x,4#", INITIAL_SP - 4);
@@ -80,14 +84,14 @@ TEST(watchpointTests, Set4ByteReadWriteWatchpoint_ShouldBeIgnored)
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
 
     IMemory_Write32(m_pMemory, INITIAL_SP - 4, 0xBAADF00D);
-    CHECK_FALSE(MemorySim_WasWatchpointEncountered(m_pMemory));
+    CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
 
     uint32_t value = IMemory_Read32(m_pMemory, INITIAL_SP - 4);
     CHECK_EQUAL(0xBAADF00D, value);
-    CHECK_FALSE(MemorySim_WasWatchpointEncountered(m_pMemory));
+    CHECK_TRUE(MemorySim_WasWatchpointEncountered(m_pMemory));
 }
 
-TEST(watchpointTests, Clear4ByteReadWatchpoint_ShouldBeIgnored)
+TEST(watchpointTests, Clear4ByteReadWatchpointWhichWasNeverSet_ShouldSucceed)
 {
     char commands[64];
     snprintf(commands, sizeof(commands), "+$z3,%x,4#", INITIAL_SP - 4);
@@ -99,3 +103,22 @@ TEST(watchpointTests, Clear4ByteReadWatchpoint_ShouldBeIgnored)
     STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
     CHECK_EQUAL(INITIAL_PC, m_context.R[PC]);
 }
+
+TEST(watchpointTests, SetWriteWatchpointAndContinue_ShouldStopAfterWritingInstruction)
+{
+    char commands[64];
+    setRegisterValue(R0, INITIAL_SP - 4);
+    emitSTRImmediate(R1, R0, 0);
+    emitMOVimmediate(R2, 2);
+    snprintf(commands, sizeof(commands), "+$Z2,%x,4#", INITIAL_SP - 4);
+    mockIComm_InitReceiveChecksummedData(commands, "+$c#+$c#");
+    mockIComm_SetShouldStopRunFlag(2);
+        mriPlatform_Run(mockIComm_Get());
+    appendExpectedTPacket(SIGTRAP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC);
+    appendExpectedString("+$OK#+");
+    appendExpectedTPacket(SIGTRAP, 0xCCCCCCCC, INITIAL_SP, INITIAL_LR, INITIAL_PC + 2);
+    appendExpectedString("+");
+    STRCMP_EQUAL(checksumExpected(), mockIComm_GetTransmittedData());
+    CHECK_EQUAL(0x11111111, IMemory_Read32(m_pMemory, INITIAL_SP - 4));
+    CHECK_EQUAL(0x22222222, m_context.R[R2]);
+}
@@ -0,0 +1,125 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+#include <Arena.h>
+#include <common.h>
+#include <MallocFailureInject.h>
+
+
+/* Alignment suitable for any of the types allocated from an arena, including 64-bit integers and doubles. */
+#define ARENA_ALIGNMENT         16
+#define ALIGN_UP(X)             (((X) + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1))
+#define ARENA_HEADER_SIZE       ALIGN_UP(sizeof(ArenaBlock))
+#define ARENA_LARGE_ALLOCATION  (ARENA_BLOCK_SIZE / 4)
+
+struct ArenaBlock
+{
+    ArenaBlock* pNext;
+};
+
+
+static uint8_t* allocateBlock(Arena* pThis, size_t dataSize);
+static int isMostRecentAllocation(Arena* pThis, const uint8_t* pAlloc, size_t alignedSize);
+
+
+__throws void* Arena_Alloc(Arena* pThis, size_t size)
+{
+    uint8_t* pAlloc;
+
+    if (size > (size_t)-1 - ARENA_BLOCK_SIZE)
+        __throw(outOfMemoryException);
+    size = ALIGN_UP(size);
+
+    if (size > ARENA_LARGE_ALLOCATION)
+    {
+        pAlloc = allocateBlock(pThis, size);
+    }
+    else
+    {
+        if (size > pThis->bytesLeft)
+        {
+            pThis->pNext = allocateBlock(pThis, ARENA_BLOCK_SIZE - ARENA_HEADER_SIZE);
+            pThis->bytesLeft = ARENA_BLOCK_SIZE - ARENA_HEADER_SIZE;
+        }
+        pAlloc = pThis->pNext;
+        pThis->pNext += size;
+        pThis->bytesLeft -= size;
+    }
+    return pAlloc;
+}
+
+static uint8_t* allocateBlock(Arena* pThis, size_t dataSize)
+{
+    /* Each byte of a block is handed out at most once so the zero fill from calloc() is all that allocations need.  The
+       C library gets large blocks straight from the OS as pages which are only zeroed once they are touched. */
+    ArenaBlock* pBlock = calloc(1, ARENA_HEADER_SIZE + dataSize);
+
+    if (!pBlock)
+        __throw(outOfMemoryException);
+    /* Order of the list doesn't matter since blocks are only ever freed all together. */
+    pBlock->pNext = pThis->pBlocks;
+    pThis->pBlocks = pBlock;
+    pThis->blockCount++;
+    return (uint8_t*)pBlock + ARENA_HEADER_SIZE;
+}
+
+__throws void* Arena_Realloc(Arena* pThis, void* pOld, size_t oldSize, size_t newSize)
+{
+    uint8_t* pNew;
+    size_t   alignedOldSize = ALIGN_UP(oldSize);
+
+    if (!pOld)
+        return Arena_Alloc(pThis, newSize);
+    if (newSize <= alignedOldSize)
+    {
+        if (newSize > oldSize)
+            memset((uint8_t*)pOld + oldSize, 0, newSize - oldSize);
+        return pOld;
+    }
+
+    if (isMostRecentAllocation(pThis, pOld, alignedOldSize) && ALIGN_UP(newSize) - alignedOldSize <= pThis->bytesLeft)
+    {
+        size_t growth = ALIGN_UP(newSize) - alignedOldSize;
+
+        /* Only the tail of the old allocation could have been written, the growth hasn't been handed out before. */
+        memset((uint8_t*)pOld + oldSize, 0, alignedOldSize - oldSize);
+        pThis->pNext += growth;
+        pThis->bytesLeft -= growth;
+        return pOld;
+    }
+
+    pNew = Arena_Alloc(pThis, newSize);
+    memcpy(pNew, pOld, oldSize);
+    return pNew;
+}
+
+static int isMostRecentAllocation(Arena* pThis, const uint8_t* pAlloc, size_t alignedSize)
+{
+    return pThis->pNext && pAlloc + alignedSize == pThis->pNext;
+}
+
+void Arena_Uninit(Arena* pThis)
+{
+    ArenaBlock* pCurr;
+
+    if (!pThis)
+        return;
+    pCurr = pThis->pBlocks;
+    while (pCurr)
+    {
+        ArenaBlock* pNext = pCurr->pNext;
+        free(pCurr);
+        pCurr = pNext;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+}
@@ -0,0 +1,132 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <common.h>
+#include <Directory.h>
+#include <MallocFailureInject.h>
+
+
+/* Provide different implementation of Directory* functions depending on whether building for a Posix or Windows OS. */
+#ifdef WIN32
+#include <windows.h>
+
+struct Directory
+{
+    HANDLE           hFind;
+    WIN32_FIND_DATAA findData;
+    /* FindFirstFile() has already fetched the first entry so Directory_Next() returns it without fetching another. */
+    int              isFirst;
+};
+
+__throws Directory* Directory_Open(const char* pDirectory)
+{
+    Directory* pThis = NULL;
+    char       pattern[MAX_PATH];
+    int        result;
+
+    result = snprintf(pattern, sizeof(pattern), "%s\\*", pDirectory);
+    if (result < 0 || (size_t)result >= sizeof(pattern))
+        __throw_msg(fileException, "Failed to open \"%s\" directory.", pDirectory);
+    pThis = malloc(sizeof(*pThis));
+    if (!pThis)
+        __throw(outOfMemoryException);
+    pThis->hFind = FindFirstFileA(pattern, &pThis->findData);
+    if (pThis->hFind == INVALID_HANDLE_VALUE)
+    {
+        free(pThis);
+        __throw_msg(fileException, "Failed to open \"%s\" directory.", pDirectory);
+    }
+    pThis->isFirst = TRUE;
+    return pThis;
+}
+
+const char* Directory_Next(Directory* pThis)
+{
+    do
+    {
+        if (!pThis->isFirst && !FindNextFileA(pThis->hFind, &pThis->findData))
+            return NULL;
+        pThis->isFirst = FALSE;
+    } while (pThis->findData.cFileName[0] == '.');
+    return pThis->findData.cFileName;
+}
+
+void Directory_Close(Directory* pThis)
+{
+    if (!pThis)
+        return;
+    FindClose(pThis->hFind);
+    free(pThis);
+}
+
+int Directory_IsRegularFile(const char* pPath)
+{
+    struct _stat fileStats;
+
+    return _stat(pPath, &fileStats) == 0 && (fileStats.st_mode & _S_IFMT) == _S_IFREG;
+}
+
+#else
+#include <dirent.h>
+
+struct Directory
+{
+    DIR* pDir;
+};
+
+__throws Directory* Directory_Open(const char* pDirectory)
+{
+    Directory* pThis = malloc(sizeof(*pThis));
+
+    if (!pThis)
+        __throw(outOfMemoryException);
+    pThis->pDir = opendir(pDirectory);
+    if (!pThis->pDir)
+    {
+        free(pThis);
+        __throw_msg(fileException, "Failed to open \"%s\" directory.", pDirectory);
+    }
+    return pThis;
+}
+
+const char* Directory_Next(Directory* pThis)
+{
+    struct dirent* pEntry;
+
+    do
+    {
+        pEntry = readdir(pThis->pDir);
+        if (!pEntry)
+            return NULL;
+    } while (pEntry->d_name[0] == '.');
+    return pEntry->d_name;
+}
+
+void Directory_Close(Directory* pThis)
+{
+    if (!pThis)
+        return;
+    closedir(pThis->pDir);
+    free(pThis);
+}
+
+int Directory_IsRegularFile(const char* pPath)
+{
+    struct stat fileStats;
+
+    return stat(pPath, &fileStats) == 0 && S_ISREG(fileStats.st_mode);
+}
+
+#endif /* WIN32 */
@@ -0,0 +1,222 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+/* The compressed data is a series of sequences.  Each sequence starts with a token byte whose upper nibble is the
+   number of literal bytes which follow and whose lower nibble is the length of the match (minus MIN_MATCH) which is
+   copied from earlier in the output after those literals.  A nibble of 15 means that more length bytes follow, each
+   of which is added to the length, until one that isn't 255 is encountered.  The match is described by a 16-bit little
+   endian offset back into the output and then any extra match length bytes.  The last sequence ends after its
+   literals.
+*/
+#include <stdint.h>
+#include <string.h>
+#include <common.h>
+#include <LzCodec.h>
+
+
+#define MIN_MATCH       4
+#define MAX_OFFSET      0xFFFF
+#define HASH_BITS       12
+#define NIBBLE_MAX      15
+
+typedef struct Output
+{
+    uint8_t* pCurr;
+    uint8_t* pEnd;
+    int      isFull;
+} Output;
+
+typedef struct Input
+{
+    const uint8_t* pCurr;
+    const uint8_t* pEnd;
+} Input;
+
+
+static uint32_t read32(const uint8_t* p);
+static uint32_t hashSequence(uint32_t sequence);
+static void writeSequence(Output* pOutput, const uint8_t* pLiterals, size_t literalLength, size_t offset, size_t matchLength);
+static void writeLastSequence(Output* pOutput, const uint8_t* pLiterals, size_t literalLength);
+static void writeExtraLength(Output* pOutput, size_t length);
+static void writeByte(Output* pOutput, uint8_t byte);
+static void writeBytes(Output* pOutput, const uint8_t* pBytes, size_t size);
+static size_t readLength(Input* pInput, size_t nibble);
+static uint8_t readByte(Input* pInput);
+
+
+size_t LzCodec_Compress(const void* pSrc, size_t srcSize, void* pDest, size_t destSize)
+{
+    const uint8_t* pIn = (const uint8_t*)pSrc;
+    uint32_t       hashTable[1 << HASH_BITS];
+    Output         output;
+    size_t         literalStart = 0;
+    size_t         pos = 0;
+
+    /* Hash table entries are position + 1 so that 0 can indicate an empty slot. */
+    memset(hashTable, 0, sizeof(hashTable));
+    output.pCurr = (uint8_t*)pDest;
+    output.pEnd = output.pCurr + destSize;
+    output.isFull = FALSE;
+
+    while (pos + MIN_MATCH <= srcSize && !output.isFull)
+    {
+        uint32_t sequence = read32(&pIn[pos]);
+        uint32_t hash = hashSequence(sequence);
+        size_t   candidate = hashTable[hash];
+
+        hashTable[hash] = pos + 1;
+        if (candidate && pos - (candidate - 1) <= MAX_OFFSET && read32(&pIn[candidate - 1]) == sequence)
+        {
+            size_t matchStart = candidate - 1;
+            size_t matchLength = MIN_MATCH;
+
+            while (pos + matchLength < srcSize && pIn[matchStart + matchLength] == pIn[pos + matchLength])
+                matchLength++;
+            writeSequence(&output, &pIn[literalStart], pos - literalStart, pos - matchStart, matchLength);
+            pos += matchLength;
+            literalStart = pos;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+    writeLastSequence(&output, &pIn[literalStart], srcSize - literalStart);
+
+    if (output.isFull)
+        return 0;
+    return output.pCurr - (uint8_t*)pDest;
+}
+
+static uint32_t read32(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t hashSequence(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static void writeSequence(Output* pOutput, const uint8_t* pLiterals, size_t literalLength, size_t offset, size_t matchLength)
+{
+    size_t extraMatchLength = matchLength - MIN_MATCH;
+    size_t literalNibble = literalLength < NIBBLE_MAX ? literalLength : NIBBLE_MAX;
+    size_t matchNibble = extraMatchLength < NIBBLE_MAX ? extraMatchLength : NIBBLE_MAX;
+
+    writeByte(pOutput, (literalNibble << 4) | matchNibble);
+    if (literalNibble == NIBBLE_MAX)
+        writeExtraLength(pOutput, literalLength - NIBBLE_MAX);
+    writeBytes(pOutput, pLiterals, literalLength);
+    writeByte(pOutput, offset & 0xFF);
+    writeByte(pOutput, offset >> 8);
+    if (matchNibble == NIBBLE_MAX)
+        writeExtraLength(pOutput, extraMatchLength - NIBBLE_MAX);
+}
+
+static void writeLastSequence(Output* pOutput, const uint8_t* pLiterals, size_t literalLength)
+{
+    size_t literalNibble = literalLength < NIBBLE_MAX ? literalLength : NIBBLE_MAX;
+
+    writeByte(pOutput, literalNibble << 4);
+    if (literalNibble == NIBBLE_MAX)
+        writeExtraLength(pOutput, literalLength - NIBBLE_MAX);
+    writeBytes(pOutput, pLiterals, literalLength);
+}
+
+static void writeExtraLength(Output* pOutput, size_t length)
+{
+    while (length >= 255)
+    {
+        writeByte(pOutput, 255);
+        length -= 255;
+    }
+    writeByte(pOutput, length);
+}
+
+static void writeByte(Output* pOutput, uint8_t byte)
+{
+    writeBytes(pOutput, &byte, 1);
+}
+
+static void writeBytes(Output* pOutput, const uint8_t* pBytes, size_t size)
+{
+    if (pOutput->isFull || size > (size_t)(pOutput->pEnd - pOutput->pCurr))
+    {
+        pOutput->isFull = TRUE;
+        return;
+    }
+    memcpy(pOutput->pCurr, pBytes, size);
+    pOutput->pCurr += size;
+}
+
+
+__throws void LzCodec_Decompress(const void* pSrc, size_t srcSize, void* pDest, size_t destSize)
+{
+    Input    input;
+    uint8_t* pOut = (uint8_t*)pDest;
+    size_t   outPos = 0;
+
+    input.pCurr = (const uint8_t*)pSrc;
+    input.pEnd = input.pCurr + srcSize;
+    while (TRUE)
+    {
+        uint8_t token = readByte(&input);
+        size_t  literalLength = readLength(&input, token >> 4);
+        size_t  offset;
+        size_t  matchLength;
+
+        if (literalLength > (size_t)(input.pEnd - input.pCurr) || literalLength > destSize - outPos)
+            __throw(bufferOverrunException);
+        memcpy(&pOut[outPos], input.pCurr, literalLength);
+        input.pCurr += literalLength;
+        outPos += literalLength;
+        if (input.pCurr == input.pEnd)
+            break;
+
+        offset = readByte(&input);
+        offset |= readByte(&input) << 8;
+        matchLength = readLength(&input, token & 0xF) + MIN_MATCH;
+        if (offset == 0 || offset > outPos || matchLength > destSize - outPos)
+            __throw(bufferOverrunException);
+        /* Byte at a time since the match is allowed to overlap the bytes it is producing (ie. runs). */
+        while (matchLength--)
+        {
+            pOut[outPos] = pOut[outPos - offset];
+            outPos++;
+        }
+    }
+    if (outPos != destSize)
+        __throw(bufferOverrunException);
+}
+
+static size_t readLength(Input* pInput, size_t nibble)
+{
+    size_t length = nibble;
+    uint8_t byte;
+
+    if (nibble != NIBBLE_MAX)
+        return length;
+    do
+    {
+        byte = readByte(pInput);
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+static uint8_t readByte(Input* pInput)
+{
+    if (pInput->pCurr >= pInput->pEnd)
+        __throw(bufferOverrunException);
+    return *pInput->pCurr++;
+}
@@ -0,0 +1,142 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <common.h>
+#include <MappedFile.h>
+#include <string.h>
+
+
+/* Provide different implementation of MappedFile* functions depending on whether building for a Posix or Windows OS. */
+#ifdef WIN32
+/* Windows - Just read the whole file into a heap allocation since pages are only touched by the caller anyway. */
+
+#include <FileFailureInject.h>
+#include <MallocFailureInject.h>
+
+__throws MappedFile MappedFile_Open(const char* pFilename, MappedFileAccess access)
+{
+    FILE* volatile pFile = NULL;
+    void* volatile pData = NULL;
+    volatile long  fileSize = 0;
+    MappedFile     mappedFile;
+
+    __try
+    {
+        pFile = fopen(pFilename, "rb");
+        if (!pFile)
+            __throw_msg(fileException, "Failed to open \"%s\".", pFilename);
+        fileSize = GetFileSize(pFile);
+        if (fileSize > 0)
+        {
+            pData = malloc(fileSize);
+            if (!pData)
+                __throw_msg(outOfMemoryException, "Failed to allocate %ld bytes for mapping \"%s\".", fileSize, pFilename);
+            if ((long)fread(pData, 1, fileSize, pFile) != fileSize)
+                __throw_msg(fileException, "Failed to read \"%s\".", pFilename);
+        }
+        fclose(pFile);
+    }
+    __catch
+    {
+        free(pData);
+        if (pFile)
+            fclose(pFile);
+        __rethrow;
+    }
+
+    mappedFile.pData = pData;
+    mappedFile.size = fileSize;
+    return mappedFile;
+}
+
+void MappedFile_Close(MappedFile* pThis)
+{
+    if (!pThis)
+        return;
+    free(pThis->pData);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+#else
+/* Posix */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int openAndThrowOnError(const char* pFilename);
+static size_t getFileSizeAndThrowOnError(int fileDescriptor, const char* pFilename);
+static void* mapAndThrowOnError(int fileDescriptor, size_t size, MappedFileAccess access, const char* pFilename);
+
+
+__throws MappedFile MappedFile_Open(const char* pFilename, MappedFileAccess access)
+{
+    volatile int fileDescriptor = -1;
+    MappedFile   mappedFile = { NULL, 0 };
+
+    __try
+    {
+        fileDescriptor = openAndThrowOnError(pFilename);
+        mappedFile.size = getFileSizeAndThrowOnError(fileDescriptor, pFilename);
+        /* mmap() doesn't allow zero-length mappings so just leave pData as NULL for empty files. */
+        if (mappedFile.size > 0)
+            mappedFile.pData = mapAndThrowOnError(fileDescriptor, mappedFile.size, access, pFilename);
+        close(fileDescriptor);
+    }
+    __catch
+    {
+        if (fileDescriptor != -1)
+            close(fileDescriptor);
+        __rethrow;
+    }
+
+    return mappedFile;
+}
+
+static int openAndThrowOnError(const char* pFilename)
+{
+    int fileDescriptor = open(pFilename, O_RDONLY);
+    if (fileDescriptor == -1)
+        __throw_msg(fileException, "Failed to open \"%s\".", pFilename);
+    return fileDescriptor;
+}
+
+static size_t getFileSizeAndThrowOnError(int fileDescriptor, const char* pFilename)
+{
+    struct stat fileStats;
+
+    if (fstat(fileDescriptor, &fileStats) == -1 || !S_ISREG(fileStats.st_mode))
+        __throw_msg(fileException, "Failed to get file size of \"%s\".", pFilename);
+    return fileStats.st_size;
+}
+
+static void* mapAndThrowOnError(int fileDescriptor, size_t size, MappedFileAccess access, const char* pFilename)
+{
+    int   protection = (access == MAPPED_FILE_COPY_ON_WRITE) ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* pData = mmap(NULL, size, protection, MAP_PRIVATE, fileDescriptor, 0);
+    if (pData == MAP_FAILED)
+        __throw_msg(fileException, "Failed to map \"%s\" into memory.", pFilename);
+    return pData;
+}
+
+
+void MappedFile_Close(MappedFile* pThis)
+{
+    if (!pThis)
+        return;
+    if (pThis->pData)
+        munmap(pThis->pData, pThis->size);
+    memset(pThis, 0, sizeof(*pThis));
+}
+
+#endif /* WIN32 */
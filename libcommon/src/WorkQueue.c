@@ -0,0 +1,161 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdlib.h>
+#include <common.h>
+#include <MallocFailureInject.h>
+#include <WorkQueue.h>
+
+
+/* Provide different thread and lock primitives depending on whether building for a Posix or Windows OS. */
+#ifdef WIN32
+#include <windows.h>
+#include <process.h>
+
+typedef HANDLE           Thread;
+typedef CRITICAL_SECTION Lock;
+
+#define initLock(P)      InitializeCriticalSection(P)
+#define uninitLock(P)    DeleteCriticalSection(P)
+#define acquireLock(P)   EnterCriticalSection(P)
+#define releaseLock(P)   LeaveCriticalSection(P)
+#define THREAD_RESULT    unsigned __stdcall
+#define THREAD_RETURN    0
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_t        Thread;
+typedef pthread_mutex_t  Lock;
+
+#define initLock(P)      pthread_mutex_init((P), NULL)
+#define uninitLock(P)    pthread_mutex_destroy(P)
+#define acquireLock(P)   pthread_mutex_lock(P)
+#define releaseLock(P)   pthread_mutex_unlock(P)
+#define THREAD_RESULT    void*
+#define THREAD_RETURN    NULL
+#endif /* WIN32 */
+
+
+typedef struct WorkQueue
+{
+    WorkQueueItemHandler handler;
+    void*                pContext;
+    size_t               itemCount;
+    size_t               nextItem;
+    Lock                 lock;
+} WorkQueue;
+
+
+static int startThread(Thread* pThread, WorkQueue* pQueue);
+static void joinThread(Thread thread);
+static THREAD_RESULT workerThread(void* pv);
+static int claimNextItem(WorkQueue* pQueue, size_t* pIndex);
+
+
+void WorkQueue_Run(size_t itemCount, unsigned int jobCount, WorkQueueItemHandler handler, void* pContext)
+{
+    Thread*      pThreads = NULL;
+    unsigned int threadCount = 0;
+    WorkQueue    queue;
+    unsigned int i;
+
+    queue.handler = handler;
+    queue.pContext = pContext;
+    queue.itemCount = itemCount;
+    queue.nextItem = 0;
+    initLock(&queue.lock);
+
+    if (jobCount > itemCount)
+        jobCount = itemCount;
+    if (jobCount > 1)
+        pThreads = malloc((jobCount - 1) * sizeof(*pThreads));
+    if (pThreads)
+    {
+        for (threadCount = 0 ; threadCount < jobCount - 1 ; threadCount++)
+        {
+            if (!startThread(&pThreads[threadCount], &queue))
+                break;
+        }
+    }
+
+    workerThread(&queue);
+    for (i = 0 ; i < threadCount ; i++)
+        joinThread(pThreads[i]);
+
+    free(pThreads);
+    uninitLock(&queue.lock);
+}
+
+#ifdef WIN32
+static int startThread(Thread* pThread, WorkQueue* pQueue)
+{
+    *pThread = (HANDLE)_beginthreadex(NULL, 0, workerThread, pQueue, 0, NULL);
+    return *pThread != 0;
+}
+
+static void joinThread(Thread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static int startThread(Thread* pThread, WorkQueue* pQueue)
+{
+    return pthread_create(pThread, NULL, workerThread, pQueue) == 0;
+}
+
+static void joinThread(Thread thread)
+{
+    pthread_join(thread, NULL);
+}
+#endif /* WIN32 */
+
+static THREAD_RESULT workerThread(void* pv)
+{
+    WorkQueue* pQueue = (WorkQueue*)pv;
+    size_t     index;
+
+    while (claimNextItem(pQueue, &index))
+        pQueue->handler(pQueue->pContext, index);
+    return THREAD_RETURN;
+}
+
+static int claimNextItem(WorkQueue* pQueue, size_t* pIndex)
+{
+    int isValid;
+
+    acquireLock(&pQueue->lock);
+    *pIndex = pQueue->nextItem;
+    isValid = pQueue->nextItem < pQueue->itemCount;
+    if (isValid)
+        pQueue->nextItem++;
+    releaseLock(&pQueue->lock);
+    return isValid;
+}
+
+
+unsigned int WorkQueue_GetProcessorCount(void)
+{
+#ifdef WIN32
+    SYSTEM_INFO systemInfo;
+
+    GetSystemInfo(&systemInfo);
+    if (systemInfo.dwNumberOfProcessors > 0)
+        return systemInfo.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processorCount > 0)
+        return processorCount;
+#endif
+    return 1;
+}
@@ -13,6 +13,6 @@
 /* Very rough exception handling like macros for C. */
 #include "try_catch.h"
 
-ExceptionHandler* g_pExceptionHandlers;
-char              g_exceptionMessage[1024];
-int               g_exceptionCode;
+TRY_CATCH_THREAD_LOCAL ExceptionHandler* g_pExceptionHandlers;
+TRY_CATCH_THREAD_LOCAL char              g_exceptionMessage[1024];
+TRY_CATCH_THREAD_LOCAL int               g_exceptionCode;
@@ -0,0 +1,176 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+extern "C"
+{
+#include "common.h"
+#include "Arena.h"
+#include "MallocFailureInject.h"
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(Arena)
+{
+    Arena m_arena;
+
+    void setup()
+    {
+        memset(&m_arena, 0, sizeof(m_arena));
+    }
+
+    void teardown()
+    {
+        Arena_Uninit(&m_arena);
+        MallocFailureInject_Restore();
+        CHECK_EQUAL(0, getExceptionCode());
+    }
+
+    void validateExceptionThrown(int expectedException)
+    {
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        clearExceptionCode();
+    }
+
+    void validateZeroFilled(const void* pData, size_t size)
+    {
+        const uint8_t* pCurr = (const uint8_t*)pData;
+        for (size_t i = 0 ; i < size ; i++)
+            CHECK_EQUAL(0, pCurr[i]);
+    }
+};
+
+TEST(Arena, Uninit_ShouldHandleNULLPointerAndEmptyArena)
+{
+    Arena_Uninit(NULL);
+    Arena_Uninit(&m_arena);
+    CHECK_EQUAL(0, m_arena.blockCount);
+}
+
+TEST(Arena, SmallAllocations_ShouldShareOneBlockAndBeAlignedAndZeroFilled)
+{
+    uint8_t* p1 = (uint8_t*)Arena_Alloc(&m_arena, 1);
+    memset(p1, 0xFF, 1);
+    uint8_t* p2 = (uint8_t*)Arena_Alloc(&m_arena, 24);
+    uint8_t* p3 = (uint8_t*)Arena_Alloc(&m_arena, 0);
+    memset(p2, 0xFF, 24);
+    uint8_t* p4 = (uint8_t*)Arena_Alloc(&m_arena, 100);
+
+    CHECK_EQUAL(1, m_arena.blockCount);
+    CHECK_EQUAL(0, (uintptr_t)p1 % 16);
+    CHECK_EQUAL(0, (uintptr_t)p2 % 16);
+    CHECK_EQUAL(0, (uintptr_t)p4 % 16);
+    CHECK_TRUE(p2 >= p1 + 1);
+    CHECK_TRUE(p4 >= p2 + 24);
+    CHECK_TRUE(p3 <= p4);
+    CHECK_EQUAL(0xFF, p1[0]);
+    validateZeroFilled(p4, 100);
+}
+
+TEST(Arena, FillFirstBlock_ShouldAllocateSecondBlock)
+{
+    size_t allocSize = ARENA_BLOCK_SIZE / 4;
+    size_t i;
+
+    for (i = 0 ; i < 3 ; i++)
+        Arena_Alloc(&m_arena, allocSize);
+    CHECK_EQUAL(1, m_arena.blockCount);
+    Arena_Alloc(&m_arena, allocSize);
+    CHECK_EQUAL(2, m_arena.blockCount);
+}
+
+TEST(Arena, LargeAllocation_ShouldGetItsOwnBlockWithoutWastingCurrentOne)
+{
+    uint8_t* pSmall1 = (uint8_t*)Arena_Alloc(&m_arena, 16);
+    uint8_t* pLarge = (uint8_t*)Arena_Alloc(&m_arena, 1024 * 1024);
+    uint8_t* pSmall2 = (uint8_t*)Arena_Alloc(&m_arena, 16);
+
+    CHECK_EQUAL(2, m_arena.blockCount);
+    POINTERS_EQUAL(pSmall1 + 16, pSmall2);
+    validateZeroFilled(pLarge, 1024 * 1024);
+}
+
+TEST(Arena, FailFirstBlockAllocation_ShouldThrow)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( Arena_Alloc(&m_arena, 16) );
+    validateExceptionThrown(outOfMemoryException);
+    CHECK_EQUAL(0, m_arena.blockCount);
+}
+
+TEST(Arena, FailLargeAllocation_ShouldThrowAndLeaveArenaUsable)
+{
+    Arena_Alloc(&m_arena, 16);
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( Arena_Alloc(&m_arena, ARENA_BLOCK_SIZE) );
+    validateExceptionThrown(outOfMemoryException);
+    Arena_Alloc(&m_arena, 16);
+    CHECK_EQUAL(1, m_arena.blockCount);
+}
+
+TEST(Arena, HugeAllocation_ShouldThrowRatherThanOverflow)
+{
+    __try_and_catch( Arena_Alloc(&m_arena, (size_t)-1) );
+    validateExceptionThrown(outOfMemoryException);
+}
+
+TEST(Arena, ReallocNULL_ShouldAllocate)
+{
+    void* p = Arena_Realloc(&m_arena, NULL, 0, 32);
+    CHECK_TRUE(p != NULL);
+    validateZeroFilled(p, 32);
+}
+
+TEST(Arena, ReallocMostRecentAllocation_ShouldGrowInPlaceAndZeroFillGrowth)
+{
+    uint8_t* p = (uint8_t*)Arena_Alloc(&m_arena, 12);
+    memset(p, 0xAA, 12);
+    uint8_t* pGrown = (uint8_t*)Arena_Realloc(&m_arena, p, 12, 40);
+    uint8_t* pNext = (uint8_t*)Arena_Alloc(&m_arena, 1);
+
+    POINTERS_EQUAL(p, pGrown);
+    CHECK_EQUAL(0xAA, pGrown[11]);
+    validateZeroFilled(pGrown + 12, 40 - 12);
+    CHECK_TRUE(pNext >= pGrown + 40);
+}
+
+TEST(Arena, ReallocOlderAllocation_ShouldCopyToNewAllocation)
+{
+    uint8_t* p = (uint8_t*)Arena_Alloc(&m_arena, 16);
+    memset(p, 0x55, 16);
+    Arena_Alloc(&m_arena, 16);
+    uint8_t* pGrown = (uint8_t*)Arena_Realloc(&m_arena, p, 16, 64);
+
+    CHECK_TRUE(pGrown != p);
+    CHECK_EQUAL(0x55, pGrown[0]);
+    CHECK_EQUAL(0x55, pGrown[15]);
+    validateZeroFilled(pGrown + 16, 64 - 16);
+}
+
+TEST(Arena, ReallocSmaller_ShouldReturnSameAllocation)
+{
+    void* p = Arena_Alloc(&m_arena, 64);
+    POINTERS_EQUAL(p, Arena_Realloc(&m_arena, p, 64, 8));
+}
+
+TEST(Arena, ReallocFailure_ShouldThrowAndLeaveOldAllocationIntact)
+{
+    uint8_t* p = (uint8_t*)Arena_Alloc(&m_arena, 16);
+    memset(p, 0x55, 16);
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( Arena_Realloc(&m_arena, p, 16, ARENA_BLOCK_SIZE) );
+    validateExceptionThrown(outOfMemoryException);
+    CHECK_EQUAL(0x55, p[15]);
+}
@@ -0,0 +1,95 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+extern "C"
+{
+#include "Crc32.h"
+}
+
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(Crc32)
+{
+    void setup()
+    {
+    }
+
+    void teardown()
+    {
+    }
+};
+
+TEST(Crc32, EmptyBuffer_ShouldBeZero)
+{
+    CHECK_EQUAL(0x00000000, Crc32_Calculate("", 0));
+}
+
+TEST(Crc32, StandardCheckValue_ShouldMatch)
+{
+    static const char checkString[] = "123456789";
+    CHECK_EQUAL(0xCBF43926, Crc32_Calculate(checkString, strlen(checkString)));
+}
+
+TEST(Crc32, AllZeroes_ShouldMatchZlib)
+{
+    uint8_t zeroes[32];
+    memset(zeroes, 0, sizeof(zeroes));
+    CHECK_EQUAL(0x190A55AD, Crc32_Calculate(zeroes, sizeof(zeroes)));
+}
+
+TEST(Crc32, UpdateInPieces_ShouldMatchCalculateOfWhole)
+{
+    static const char testString[] = "The quick brown fox jumps over the lazy dog";
+    size_t            length = strlen(testString);
+    uint32_t          crc = 0;
+
+    for (size_t i = 0 ; i < length ; i += 5)
+        crc = Crc32_Update(crc, &testString[i], length - i < 5 ? length - i : 5);
+    CHECK_EQUAL(0x414FA339, crc);
+    CHECK_EQUAL(0x414FA339, Crc32_Calculate(testString, length));
+}
+
+TEST(Crc32, Gdb_EmptyBuffer_ShouldBeInitialValue)
+{
+    CHECK_EQUAL(CRC32_GDB_INITIAL, Crc32_GdbCalculate("", 0));
+}
+
+TEST(Crc32, Gdb_StandardCheckValue_ShouldMatch)
+{
+    static const char checkString[] = "123456789";
+    CHECK_EQUAL(0x0376E6E7, Crc32_GdbCalculate(checkString, strlen(checkString)));
+}
+
+TEST(Crc32, Gdb_AllZeroes_ShouldMatch)
+{
+    uint8_t zeroes[32];
+    memset(zeroes, 0, sizeof(zeroes));
+    CHECK_EQUAL(0x4A55AF67, Crc32_GdbCalculate(zeroes, sizeof(zeroes)));
+}
+
+TEST(Crc32, Gdb_UpdateInPiecesOfEverySize_ShouldMatchCalculateOfWhole)
+{
+    static const char testString[] = "The quick brown fox jumps over the lazy dog";
+    size_t            length = strlen(testString);
+
+    CHECK_EQUAL(0xBA62119E, Crc32_GdbCalculate(testString, length));
+    for (size_t pieceSize = 1 ; pieceSize <= 17 ; pieceSize++)
+    {
+        uint32_t crc = CRC32_GDB_INITIAL;
+        for (size_t i = 0 ; i < length ; i += pieceSize)
+            crc = Crc32_GdbUpdate(crc, &testString[i], length - i < pieceSize ? length - i : pieceSize);
+        CHECK_EQUAL(0xBA62119E, crc);
+    }
+}
@@ -0,0 +1,128 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include "common.h"
+#include "Directory.h"
+#include "MallocFailureInject.h"
+}
+
+static const char* g_testDirectory = "DirectoryTest.dir";
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(Directory)
+{
+    Directory* m_pDirectory;
+
+    void setup()
+    {
+        m_pDirectory = NULL;
+        mkdir(g_testDirectory, 0777);
+    }
+
+    void teardown()
+    {
+        MallocFailureInject_Restore();
+        Directory_Close(m_pDirectory);
+        remove("DirectoryTest.dir/a.dmp");
+        remove("DirectoryTest.dir/b.dmp");
+        remove("DirectoryTest.dir/.hidden");
+        rmdir("DirectoryTest.dir/subdir");
+        rmdir(g_testDirectory);
+        CHECK_EQUAL(0, getExceptionCode());
+    }
+
+    void createTestFile(const char* pPath)
+    {
+        FILE* pFile = fopen(pPath, "wb");
+        fwrite("\0", 1, 1, pFile);
+        fclose(pFile);
+    }
+
+    void validateExceptionThrown(int expectedException)
+    {
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        clearExceptionCode();
+    }
+};
+
+TEST(Directory, OpenNonExistentDirectory_ShouldThrow)
+{
+    __try_and_catch( m_pDirectory = Directory_Open("invalidDirectory.dir") );
+    validateExceptionThrown(fileException);
+    STRCMP_EQUAL("Failed to open \"invalidDirectory.dir\" directory.", getExceptionMessage());
+    POINTERS_EQUAL(NULL, m_pDirectory);
+}
+
+TEST(Directory, OpenWithFailedAllocation_ShouldThrow)
+{
+    MallocFailureInject_FailAllocation(1);
+    __try_and_catch( m_pDirectory = Directory_Open(g_testDirectory) );
+    validateExceptionThrown(outOfMemoryException);
+    POINTERS_EQUAL(NULL, m_pDirectory);
+}
+
+TEST(Directory, EmptyDirectory_ShouldReturnNoEntries)
+{
+    m_pDirectory = Directory_Open(g_testDirectory);
+    POINTERS_EQUAL(NULL, Directory_Next(m_pDirectory));
+}
+
+TEST(Directory, DirectoryWithEntries_ShouldReturnEachVisibleEntryOnce)
+{
+    int foundA = 0;
+    int foundB = 0;
+    int foundSubdir = 0;
+    const char* pName;
+
+    createTestFile("DirectoryTest.dir/a.dmp");
+    createTestFile("DirectoryTest.dir/b.dmp");
+    createTestFile("DirectoryTest.dir/.hidden");
+    mkdir("DirectoryTest.dir/subdir", 0777);
+    m_pDirectory = Directory_Open(g_testDirectory);
+    while ((pName = Directory_Next(m_pDirectory)) != NULL)
+    {
+        if (0 == strcmp(pName, "a.dmp"))
+            foundA++;
+        else if (0 == strcmp(pName, "b.dmp"))
+            foundB++;
+        else if (0 == strcmp(pName, "subdir"))
+            foundSubdir++;
+        else
+            FAIL(pName);
+    }
+    CHECK_EQUAL(1, foundA);
+    CHECK_EQUAL(1, foundB);
+    CHECK_EQUAL(1, foundSubdir);
+}
+
+TEST(Directory, CloseNull_ShouldBeIgnored)
+{
+    Directory_Close(NULL);
+}
+
+TEST(Directory, IsRegularFile_ShouldOnlyBeTrueForFiles)
+{
+    createTestFile("DirectoryTest.dir/a.dmp");
+    mkdir("DirectoryTest.dir/subdir", 0777);
+    CHECK_TRUE(Directory_IsRegularFile("DirectoryTest.dir/a.dmp"));
+    CHECK_FALSE(Directory_IsRegularFile("DirectoryTest.dir/subdir"));
+    CHECK_FALSE(Directory_IsRegularFile("DirectoryTest.dir/missing.dmp"));
+}
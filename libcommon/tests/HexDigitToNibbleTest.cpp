@@ -0,0 +1,53 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+extern "C"
+{
+#include "common.h"
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(HexDigitToNibble)
+{
+};
+
+TEST(HexDigitToNibble, DecimalDigits)
+{
+    CHECK_EQUAL(0, HexDigitToNibble('0'));
+    CHECK_EQUAL(9, HexDigitToNibble('9'));
+}
+
+TEST(HexDigitToNibble, LowercaseDigits)
+{
+    CHECK_EQUAL(0xa, HexDigitToNibble('a'));
+    CHECK_EQUAL(0xf, HexDigitToNibble('f'));
+}
+
+TEST(HexDigitToNibble, UppercaseDigits)
+{
+    CHECK_EQUAL(0xA, HexDigitToNibble('A'));
+    CHECK_EQUAL(0xF, HexDigitToNibble('F'));
+}
+
+TEST(HexDigitToNibble, NonHexCharacters_ShouldReturnNegativeOne)
+{
+    CHECK_EQUAL(-1, HexDigitToNibble('/'));
+    CHECK_EQUAL(-1, HexDigitToNibble(':'));
+    CHECK_EQUAL(-1, HexDigitToNibble('@'));
+    CHECK_EQUAL(-1, HexDigitToNibble('G'));
+    CHECK_EQUAL(-1, HexDigitToNibble('`'));
+    CHECK_EQUAL(-1, HexDigitToNibble('g'));
+    CHECK_EQUAL(-1, HexDigitToNibble('x'));
+    CHECK_EQUAL(-1, HexDigitToNibble('\0'));
+}
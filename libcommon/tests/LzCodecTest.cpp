@@ -0,0 +1,199 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+extern "C"
+{
+#include "common.h"
+#include "LzCodec.h"
+}
+
+#include <stdlib.h>
+#include <string.h>
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(LzCodec)
+{
+    uint8_t* m_pInput;
+    uint8_t* m_pCompressed;
+    uint8_t* m_pOutput;
+    size_t   m_inputSize;
+    size_t   m_compressedSize;
+
+    void setup()
+    {
+        m_pInput = NULL;
+        m_pCompressed = NULL;
+        m_pOutput = NULL;
+        m_inputSize = 0;
+        m_compressedSize = 0;
+    }
+
+    void teardown()
+    {
+        free(m_pInput);
+        free(m_pCompressed);
+        free(m_pOutput);
+        CHECK_EQUAL(0, getExceptionCode());
+    }
+
+    void allocateInput(size_t size)
+    {
+        m_inputSize = size;
+        m_pInput = (uint8_t*)malloc(size + 1);
+        m_pCompressed = (uint8_t*)malloc(LZ_CODEC_MAX_COMPRESSED_SIZE(size));
+        m_pOutput = (uint8_t*)malloc(size + 1);
+    }
+
+    void fillWithPseudoRandomBytes(uint8_t* pDest, size_t size)
+    {
+        uint32_t seed = 0x12345678;
+        for (size_t i = 0 ; i < size ; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            pDest[i] = seed >> 24;
+        }
+    }
+
+    void compressAndValidateRoundTrip()
+    {
+        m_compressedSize = LzCodec_Compress(m_pInput, m_inputSize, m_pCompressed, LZ_CODEC_MAX_COMPRESSED_SIZE(m_inputSize));
+        CHECK(m_compressedSize > 0);
+        CHECK(m_compressedSize <= LZ_CODEC_MAX_COMPRESSED_SIZE(m_inputSize));
+        memset(m_pOutput, 0xA5, m_inputSize + 1);
+        LzCodec_Decompress(m_pCompressed, m_compressedSize, m_pOutput, m_inputSize);
+        CHECK_EQUAL(0, memcmp(m_pInput, m_pOutput, m_inputSize));
+        CHECK_EQUAL(0xA5, m_pOutput[m_inputSize]);
+    }
+
+    void validateDecompressThrows(const void* pCompressed, size_t compressedSize, size_t outputSize)
+    {
+        uint8_t output[64];
+        CHECK(outputSize <= sizeof(output));
+        __try_and_catch( LzCodec_Decompress(pCompressed, compressedSize, output, outputSize) );
+        CHECK_EQUAL(bufferOverrunException, getExceptionCode());
+        clearExceptionCode();
+    }
+};
+
+TEST(LzCodec, EmptyInput_ShouldRoundTrip)
+{
+    allocateInput(0);
+    compressAndValidateRoundTrip();
+    CHECK_EQUAL(1, m_compressedSize);
+}
+
+TEST(LzCodec, ShortLiteralOnlyInput_ShouldRoundTrip)
+{
+    allocateInput(3);
+    memcpy(m_pInput, "abc", 3);
+    compressAndValidateRoundTrip();
+    CHECK_EQUAL(4, m_compressedSize);
+}
+
+TEST(LzCodec, AllZeroes_ShouldCompressToTinyFractionAndRoundTrip)
+{
+    allocateInput(64 * 1024);
+    memset(m_pInput, 0, m_inputSize);
+    compressAndValidateRoundTrip();
+    CHECK(m_compressedSize < m_inputSize / 200);
+}
+
+TEST(LzCodec, RepetitivePattern_ShouldCompressAndRoundTrip)
+{
+    allocateInput(10000);
+    for (size_t i = 0 ; i < m_inputSize ; i++)
+        m_pInput[i] = "0123456789ABCDEFGHIJ"[i % 20];
+    compressAndValidateRoundTrip();
+    CHECK(m_compressedSize < m_inputSize / 20);
+}
+
+TEST(LzCodec, RandomData_ShouldRoundTripWithLongLiteralRuns)
+{
+    allocateInput(5000);
+    fillWithPseudoRandomBytes(m_pInput, m_inputSize);
+    compressAndValidateRoundTrip();
+}
+
+TEST(LzCodec, MixOfRandomAndZeroes_ShouldRoundTrip)
+{
+    allocateInput(70000);
+    memset(m_pInput, 0, m_inputSize);
+    fillWithPseudoRandomBytes(m_pInput + 1000, 300);
+    fillWithPseudoRandomBytes(m_pInput + 68000, 1000);
+    compressAndValidateRoundTrip();
+    CHECK(m_compressedSize < 2000);
+}
+
+TEST(LzCodec, DestinationTooSmall_ShouldReturnZero)
+{
+    allocateInput(1000);
+    fillWithPseudoRandomBytes(m_pInput, m_inputSize);
+    CHECK_EQUAL(0, LzCodec_Compress(m_pInput, m_inputSize, m_pCompressed, m_inputSize - 1));
+}
+
+TEST(LzCodec, DecompressHandEncodedRun_ShouldOverlapMatchWithOutput)
+{
+    // 1 literal 'a' followed by match of length 5 at offset 1 and then an empty final sequence.
+    static const uint8_t compressed[] = { 0x11, 'a', 0x01, 0x00, 0x00 };
+    uint8_t              output[6];
+    LzCodec_Decompress(compressed, sizeof(compressed), output, sizeof(output));
+    CHECK_EQUAL(0, memcmp("aaaaaa", output, sizeof(output)));
+}
+
+TEST(LzCodec, DecompressEmptyInput_ShouldThrow)
+{
+    validateDecompressThrows("", 0, 0);
+}
+
+TEST(LzCodec, DecompressTruncatedLiterals_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0x30, 'a', 'b' };
+    validateDecompressThrows(compressed, sizeof(compressed), 3);
+}
+
+TEST(LzCodec, DecompressTruncatedOffset_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0x11, 'a', 0x01 };
+    validateDecompressThrows(compressed, sizeof(compressed), 6);
+}
+
+TEST(LzCodec, DecompressZeroOffset_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0x11, 'a', 0x00, 0x00, 0x00 };
+    validateDecompressThrows(compressed, sizeof(compressed), 6);
+}
+
+TEST(LzCodec, DecompressOffsetBeforeStartOfOutput_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0x11, 'a', 0x02, 0x00, 0x00 };
+    validateDecompressThrows(compressed, sizeof(compressed), 6);
+}
+
+TEST(LzCodec, DecompressMoreThanDestinationSize_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0x11, 'a', 0x01, 0x00, 0x00 };
+    validateDecompressThrows(compressed, sizeof(compressed), 5);
+}
+
+TEST(LzCodec, DecompressLessThanDestinationSize_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0x11, 'a', 0x01, 0x00, 0x00 };
+    validateDecompressThrows(compressed, sizeof(compressed), 7);
+}
+
+TEST(LzCodec, DecompressTruncatedExtraLength_ShouldThrow)
+{
+    static const uint8_t compressed[] = { 0xF0, 0xFF };
+    validateDecompressThrows(compressed, sizeof(compressed), 64);
+}
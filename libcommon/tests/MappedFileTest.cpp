@@ -0,0 +1,104 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+extern "C"
+{
+#include "common.h"
+#include "MappedFile.h"
+}
+
+#include <string.h>
+
+static const char* g_testFilename = "MappedFileTest.tst";
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(MappedFile)
+{
+    MappedFile m_mappedFile;
+
+    void setup()
+    {
+        memset(&m_mappedFile, 0, sizeof(m_mappedFile));
+    }
+
+    void teardown()
+    {
+        MappedFile_Close(&m_mappedFile);
+        remove(g_testFilename);
+        CHECK_EQUAL(0, getExceptionCode());
+    }
+
+    void createTestFile(const char* pData, size_t dataSize)
+    {
+        FILE* pFile = fopen(g_testFilename, "wb");
+        fwrite(pData, 1, dataSize, pFile);
+        fclose(pFile);
+    }
+
+    void validateExceptionThrown(int expectedException)
+    {
+        CHECK_EQUAL(expectedException, getExceptionCode());
+        clearExceptionCode();
+    }
+};
+
+TEST(MappedFile, OpenNonExistentFile_ShouldThrow)
+{
+    __try_and_catch( m_mappedFile = MappedFile_Open("invalidFilename.tst", MAPPED_FILE_READ_ONLY) );
+    validateExceptionThrown(fileException);
+    STRCMP_EQUAL("Failed to open \"invalidFilename.tst\".", getExceptionMessage());
+    POINTERS_EQUAL(NULL, m_mappedFile.pData);
+}
+
+TEST(MappedFile, OpenZeroLengthFile_ShouldReturnNullDataAndZeroSize)
+{
+    createTestFile("", 0);
+    m_mappedFile = MappedFile_Open(g_testFilename, MAPPED_FILE_READ_ONLY);
+    POINTERS_EQUAL(NULL, m_mappedFile.pData);
+    CHECK_EQUAL(0, m_mappedFile.size);
+}
+
+TEST(MappedFile, OpenReadOnly_ShouldSeeFileContents)
+{
+    createTestFile("12345", 5);
+    m_mappedFile = MappedFile_Open(g_testFilename, MAPPED_FILE_READ_ONLY);
+    CHECK_EQUAL(5, m_mappedFile.size);
+    CHECK_EQUAL(0, memcmp(m_mappedFile.pData, "12345", 5));
+}
+
+TEST(MappedFile, OpenCopyOnWrite_WritesShouldNotMakeItBackToFile)
+{
+    createTestFile("12345", 5);
+    m_mappedFile = MappedFile_Open(g_testFilename, MAPPED_FILE_COPY_ON_WRITE);
+    ((char*)m_mappedFile.pData)[0] = 'A';
+    CHECK_EQUAL(0, memcmp(m_mappedFile.pData, "A2345", 5));
+    MappedFile_Close(&m_mappedFile);
+
+    m_mappedFile = MappedFile_Open(g_testFilename, MAPPED_FILE_READ_ONLY);
+    CHECK_EQUAL(0, memcmp(m_mappedFile.pData, "12345", 5));
+}
+
+TEST(MappedFile, Close_ShouldClearStructure)
+{
+    createTestFile("12345", 5);
+    m_mappedFile = MappedFile_Open(g_testFilename, MAPPED_FILE_READ_ONLY);
+    MappedFile_Close(&m_mappedFile);
+    POINTERS_EQUAL(NULL, m_mappedFile.pData);
+    CHECK_EQUAL(0, m_mappedFile.size);
+}
+
+TEST(MappedFile, Close_ShouldHandleNullPointer)
+{
+    MappedFile_Close(NULL);
+}
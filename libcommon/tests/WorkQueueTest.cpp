@@ -0,0 +1,91 @@
+/*  Copyright (C) 2026  Adam Green (https://github.com/adamgreen)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+#include <string.h>
+
+extern "C"
+{
+#include "common.h"
+#include "MallocFailureInject.h"
+#include "WorkQueue.h"
+}
+
+// Include C++ headers for test harness.
+#include "CppUTest/TestHarness.h"
+
+static void countItem(void* pContext, size_t index)
+{
+    int* pCounts = (int*)pContext;
+
+    /* Each index is claimed by exactly one thread so no locking is needed here. */
+    pCounts[index]++;
+}
+
+TEST_GROUP(WorkQueue)
+{
+    int m_counts[64];
+
+    void setup()
+    {
+        memset(m_counts, 0, sizeof(m_counts));
+    }
+
+    void teardown()
+    {
+        MallocFailureInject_Restore();
+        CHECK_EQUAL(0, getExceptionCode());
+    }
+
+    void validateEachItemProcessedOnce(size_t itemCount)
+    {
+        for (size_t i = 0 ; i < itemCount ; i++)
+            CHECK_EQUAL(1, m_counts[i]);
+        for (size_t i = itemCount ; i < sizeof(m_counts)/sizeof(m_counts[0]) ; i++)
+            CHECK_EQUAL(0, m_counts[i]);
+    }
+};
+
+TEST(WorkQueue, NoItems_ShouldNotCallHandler)
+{
+    WorkQueue_Run(0, 4, countItem, m_counts);
+    validateEachItemProcessedOnce(0);
+}
+
+TEST(WorkQueue, SingleJob_ShouldProcessEachItemOnce)
+{
+    WorkQueue_Run(10, 1, countItem, m_counts);
+    validateEachItemProcessedOnce(10);
+}
+
+TEST(WorkQueue, MultipleJobs_ShouldProcessEachItemOnce)
+{
+    WorkQueue_Run(64, 4, countItem, m_counts);
+    validateEachItemProcessedOnce(64);
+}
+
+TEST(WorkQueue, MoreJobsThanItems_ShouldProcessEachItemOnce)
+{
+    WorkQueue_Run(3, 16, countItem, m_counts);
+    validateEachItemProcessedOnce(3);
+}
+
+TEST(WorkQueue, FailedThreadAllocation_ShouldStillProcessEachItemOnCallingThread)
+{
+    MallocFailureInject_FailAllocation(1);
+    WorkQueue_Run(20, 4, countItem, m_counts);
+    validateEachItemProcessedOnce(20);
+}
+
+TEST(WorkQueue, GetProcessorCount_ShouldBeAtLeastOne)
+{
+    CHECK_TRUE(WorkQueue_GetProcessorCount() >= 1);
+}
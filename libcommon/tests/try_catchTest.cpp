@@ -14,6 +14,8 @@ extern "C"
 {
 #include "try_catch.h"
 }
+#include <pthread.h>
+#include <stdio.h>
 #include <string.h>
 
 // Include C++ headers for test harness.
@@ -261,3 +263,89 @@ TEST(TryCatch, subsequentTryClearsExceptionMessage)
     validateException(noException);
     STRCMP_EQUAL("", getExceptionMessage());
 }
+
+
+// Each thread repeatedly throws and catches exceptions with its own codes and messages through nested handlers.  Any
+// sharing of the exception state between threads would show up as a mismatched code, message or handler chain.
+#define STRESS_THREAD_COUNT 8
+#define STRESS_ITERATIONS   20000
+
+struct StressThread
+{
+    pthread_t thread;
+    int       index;
+    int       failures;
+};
+
+static void throwFromThread(int exceptionCode, int threadIndex, int iteration)
+{
+    __throw_msg(exceptionCode, "thread %d iteration %d", threadIndex, iteration);
+}
+
+static void rethrowFromThread(int exceptionCode, int threadIndex, int iteration)
+{
+    __try
+        throwFromThread(exceptionCode, threadIndex, iteration);
+    __catch
+        __rethrow;
+}
+
+static int throwAndCatchFromThread(int exceptionCode, int threadIndex, int iteration)
+{
+    char expectedMessage[64];
+    int  isStateValid;
+
+    snprintf(expectedMessage, sizeof(expectedMessage), "thread %d iteration %d", threadIndex, iteration);
+    __try
+        rethrowFromThread(exceptionCode, threadIndex, iteration);
+    __catch
+    {
+    }
+    isStateValid = getExceptionCode() == exceptionCode &&
+                   0 == strcmp(expectedMessage, getExceptionMessage()) &&
+                   g_pExceptionHandlers == NULL;
+    clearExceptionCode();
+    return isStateValid;
+}
+
+static void* stressThread(void* pv)
+{
+    StressThread* pThis = (StressThread*)pv;
+    int           exceptionCode = (pThis->index & 1) ? unpredictableException : undefinedException;
+    int           i;
+
+    for (i = 0 ; i < STRESS_ITERATIONS ; i++)
+    {
+        if (!throwAndCatchFromThread(exceptionCode, pThis->index, i))
+            pThis->failures++;
+    }
+    return NULL;
+}
+
+TEST(TryCatch, MultipleThreads_ShouldEachHaveIndependentExceptionState)
+{
+    StressThread threads[STRESS_THREAD_COUNT];
+    int          i;
+
+    __try
+        __throw_msg(bufferOverrunException, "main thread");
+    __catch
+        flagExceptionHit();
+
+    for (i = 0 ; i < STRESS_THREAD_COUNT ; i++)
+    {
+        threads[i].index = i;
+        threads[i].failures = 0;
+        LONGS_EQUAL(0, pthread_create(&threads[i].thread, NULL, stressThread, &threads[i]));
+    }
+    for (i = 0 ; i < STRESS_THREAD_COUNT ; i++)
+    {
+        pthread_join(threads[i].thread, NULL);
+        LONGS_EQUAL(0, threads[i].failures);
+    }
+
+    validateException(bufferOverrunException);
+    STRCMP_EQUAL("main thread", getExceptionMessage());
+    POINTERS_EQUAL(NULL, g_pExceptionHandlers);
+    clearExceptionCode();
+}
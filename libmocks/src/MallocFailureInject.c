@@ -15,10 +15,12 @@
 
 static void* defaultMalloc(size_t size);
 static void* defaultRealloc(void* ptr, size_t size);
+static void* defaultCalloc(size_t count, size_t size);
 static void  defaultFree(void* ptr);
 
 void* (*hook_malloc)(size_t size) = defaultMalloc;
 void* (*hook_realloc)(void* ptr, size_t size) = defaultRealloc;
+void* (*hook_calloc)(size_t count, size_t size) = defaultCalloc;
 void  (*hook_free)(void* ptr) = defaultFree;
 
 unsigned int   g_allocationToFail = 0;
@@ -35,6 +37,11 @@ static void* defaultRealloc(void* ptr, size_t size)
     return realloc(ptr, size);
 }
 
+static void* defaultCalloc(size_t count, size_t size)
+{
+    return calloc(count, size);
+}
+
 static void defaultFree(void* ptr)
 {
     free(ptr);
@@ -61,6 +68,14 @@ static void* mock_realloc(void* ptr, size_t size)
         return realloc(ptr, size);
 }
 
+static void* mock_calloc(size_t count, size_t size)
+{
+    if (shouldThisAllocationBeFailed())
+        return NULL;
+    else
+        return calloc(count, size);
+}
+
 
 /********************/
 /* Public routines. */
@@ -69,11 +84,13 @@ void MallocFailureInject_FailAllocation(unsigned int allocationToFail)
 {
     hook_malloc = mock_malloc;
     hook_realloc = mock_realloc;
+    hook_calloc = mock_calloc;
     g_allocationToFail = allocationToFail;
 }
 
 void MallocFailureInject_Restore(void)
 {
     hook_realloc = defaultRealloc;
+    hook_calloc = defaultCalloc;
     hook_malloc = defaultMalloc;
 }
@@ -81,9 +81,25 @@ TEST(MallocFailureInject, FailSecondReallocOutOfThree)
     reallocShouldPass();
 }
 
+TEST(MallocFailureInject, FailSecondCallocAfterMalloc)
+{
+    MallocFailureInject_FailAllocation(2);
+
+    void* pFirstMalloc = hook_malloc(10);
+    CHECK(NULL != pFirstMalloc);
+
+    void* pCalloc = hook_calloc(2, 10);
+    POINTERS_EQUAL(NULL, pCalloc);
+
+    free(pFirstMalloc);
+}
+
 TEST(MallocFailureInject, VerifyDefaultsSucceed)
 {
     void* pAlloc = hook_malloc(1);
     pAlloc = hook_realloc(pAlloc, 2);
     hook_free(pAlloc);
+    pAlloc = hook_calloc(4, 4);
+    CHECK_EQUAL(0, ((char*)pAlloc)[15]);
+    hook_free(pAlloc);
 }
@@ -10,6 +10,8 @@
     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
     GNU General Public License for more details.
 */
+#include <Clock.h>
+#include <common.h>
 #include <Console.h>
 #include <stdio.h>
 
@@ -18,6 +20,7 @@
 FILE*  (*hook_fopen)(const char* filename, const char* mode) = fopen;
 int    (*hook_fclose)(FILE* stream) = fclose;
 size_t (*hook_fread)(void* ptr, size_t size, size_t nitems, FILE* stream) = fread;
+size_t (*hook_fwrite)(const void* ptr, size_t size, size_t nitems, FILE* stream) = fwrite;
 int    (*hook_fseek)(FILE* stream, long offset, int whence) = fseek;
 long   (*hook_ftell)(FILE* stream) = ftell;
 char*  (*hook_fgets)(char * str, int size, FILE * stream) = fgets;
@@ -55,6 +58,20 @@ int Console_HasStdInDataToRead()
     return bytesAvailable > 0;
 }
 
+int Console_WaitForStdInData(uint32_t timeoutMilliseconds)
+{
+    DWORD startTicks = GetTickCount();
+
+    /* Anonymous pipes can't be waited upon so sleep between checks instead of spinning. */
+    while (!Console_HasStdInDataToRead())
+    {
+        if (GetTickCount() - startTicks >= timeoutMilliseconds)
+            return FALSE;
+        Sleep(1);
+    }
+    return TRUE;
+}
+
 int Console_ReadStdIn()
 {
     char   c = 0;
@@ -82,10 +99,24 @@ void Console_WriteStdOut(int character)
         __throw(fileException);
 }
 
+uint64_t Clock_GetMicroseconds(void)
+{
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart / frequency.QuadPart * 1000000 +
+           (uint64_t)counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart;
+}
+
 #else
 /* Posix */
 
+#include <errno.h>
+#include <poll.h>
 #include <sys/select.h>
+#include <time.h>
 #include <unistd.h>
 
 int Console_HasStdInDataToRead()
@@ -102,6 +133,22 @@ int Console_HasStdInDataToRead()
     return result;
 }
 
+int Console_WaitForStdInData(uint32_t timeoutMilliseconds)
+{
+    int           result = -1;
+    struct pollfd pollFd;
+
+    pollFd.fd = STDIN_FILENO;
+    pollFd.events = POLLIN;
+    pollFd.revents = 0;
+    result = poll(&pollFd, 1, (int)timeoutMilliseconds);
+    if (result == -1 && errno == EINTR)
+        return FALSE;
+    if (result == -1)
+        __throw(fileException);
+    return result > 0;
+}
+
 int Console_ReadStdIn()
 {
     ssize_t result = -1;
@@ -123,4 +170,12 @@ void Console_WriteStdOut(int character)
         __throw(fileException);
 }
 
+uint64_t Clock_GetMicroseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
 #endif /* WIN32 */
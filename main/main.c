@@ -11,10 +11,55 @@
     GNU General Public License for more details.
 */
 #include <assert.h>
+#include <common.h>
 #include <CrashDebugCommandLine.h>
+#include <CrashDebugStats.h>
+#include <CompactDump.h>
+#include <CrcPackets.h>
+#include <CrashDedup.h>
+#include <DumpDiff.h>
+#include <ElfCore.h>
+#include <FreeRtosThreads.h>
+#include <HeapWalk.h>
 #include <mriPlatform.h>
+#include <PacketIComm.h>
+#include <RegionManifest.h>
+#include <signal.h>
+#include <SearchPackets.h>
+#include <StackUsage.h>
 #include <StandardIComm.h>
+#include <StatsIComm.h>
 #include <stdio.h>
+#include <ThreadPackets.h>
+#include <TraceIComm.h>
+
+
+static CrashDebugCommandLine* g_pReportCommandLine;
+static IComm*                 g_pStatsComm;
+static IComm*                 g_pTraceComm;
+static IComm*                 g_pPacketComm;
+static RtosThreads            g_rtosThreads;
+static ThreadPackets          g_threadPackets;
+/* Set by handleTerminationSignal() so it is only ever accessed as a sig_atomic_t. */
+static volatile sig_atomic_t  g_terminationSignal;
+
+
+static void writeCaptureScript(CrashDebugCommandLine* pCommandLine);
+static void runDedup(CrashDebugCommandLine* pCommandLine);
+static void writeCoreFile(CrashDebugCommandLine* pCommandLine);
+static void writeCompactDump(CrashDebugCommandLine* pCommandLine);
+static void runHeapWalk(CrashDebugCommandLine* pCommandLine);
+static void runDiff(CrashDebugCommandLine* pCommandLine);
+static void runStackUsage(CrashDebugCommandLine* pCommandLine);
+static IComm* wrapCommForPackets(CrashDebugCommandLine* pCommandLine, IComm* pComm);
+static void addThreadPackets(CrashDebugCommandLine* pCommandLine, IComm* pPacketComm);
+static int loadFreeRtosThreads(CrashDebugCommandLine* pCommandLine);
+static IComm* wrapCommForTrace(CrashDebugCommandLine* pCommandLine, IComm* pComm);
+static IComm* wrapCommForStats(CrashDebugCommandLine* pCommandLine, IComm* pComm);
+static void installTerminationHandlers(CrashDebugCommandLine* pCommandLine);
+static void handleTerminationSignal(int signalNumber);
+static void printExitReports(void);
+static void reraiseTerminationSignal(void);
 
 
 int main(int argc, const char** argv)
@@ -26,9 +71,43 @@ int main(int argc, const char** argv)
     __try
     {
         CrashDebugCommandLine_Init(&commandLine, argc-1, argv+1);
-        pComm = StandardIComm_Init();
-        mriPlatform_Init(&commandLine.context, commandLine.pMemory);
-        mriPlatform_Run(pComm);
+        g_pReportCommandLine = &commandLine;
+        if (commandLine.pCaptureScriptFilename)
+        {
+            writeCaptureScript(&commandLine);
+        }
+        else if (commandLine.pDedupDirectory)
+        {
+            runDedup(&commandLine);
+        }
+        else if (commandLine.pCoreFilename)
+        {
+            writeCoreFile(&commandLine);
+        }
+        else if (commandLine.pConvertFilename)
+        {
+            writeCompactDump(&commandLine);
+        }
+        else if (commandLine.displayHeap)
+        {
+            runHeapWalk(&commandLine);
+        }
+        else if (commandLine.pDiffFilename)
+        {
+            runDiff(&commandLine);
+        }
+        else if (commandLine.displayStacks)
+        {
+            runStackUsage(&commandLine);
+        }
+        else
+        {
+            pComm = StandardIComm_Init();
+            mriPlatform_Init(&commandLine.context, commandLine.pMemory);
+            installTerminationHandlers(&commandLine);
+            mriPlatform_Run(wrapCommForPackets(&commandLine,
+                                               wrapCommForStats(&commandLine, wrapCommForTrace(&commandLine, pComm))));
+        }
     }
     __catch
     {
@@ -36,6 +115,8 @@ int main(int argc, const char** argv)
         {
         case fileException:
         case elfFormatException:
+        case fileFormatException:
+        case busErrorException:
         case invalidArgumentException:
             // Appropriate error message will already have been displayed by CrashDebugCommandLine module.
             break;
@@ -45,8 +126,224 @@ int main(int argc, const char** argv)
         }
         returnValue = -1;
     }
+    /* Close the trace file first so that a failure to flush its last records is included in the summary. */
+    TraceIComm_Uninit(g_pTraceComm);
+    printExitReports();
+    ThreadPackets_Uninit(&g_threadPackets);
+    PacketIComm_Uninit(g_pPacketComm);
+    mriPlatform_Uninit();
+    FreeRtosThreads_Uninit(&g_rtosThreads);
+    StatsIComm_Uninit(g_pStatsComm);
     StandardIComm_Uninit(pComm);
     CrashDebugCommandLine_Uninit(&commandLine);
+    reraiseTerminationSignal();
 
     return returnValue;
 }
+
+static void writeCaptureScript(CrashDebugCommandLine* pCommandLine)
+{
+    __try
+    {
+        RegionManifest_WriteCaptureScript(pCommandLine->pCaptureScriptFilename, pCommandLine->pMemoryMapFilename);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+}
+
+static void runDedup(CrashDebugCommandLine* pCommandLine)
+{
+    CrashDedup dedup;
+
+    __try
+    {
+        if (pCommandLine->pSplitDirectory)
+            CrashDedup_InitFromLog(&dedup, pCommandLine->pMemory, pCommandLine->pDedupDirectory,
+                                   pCommandLine->pSplitDirectory, pCommandLine->jobCount);
+        else
+            CrashDedup_Init(&dedup, pCommandLine->pMemory, pCommandLine->pDedupDirectory, pCommandLine->jobCount);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+    CrashDedup_PrintReport(&dedup);
+    CrashDedup_Uninit(&dedup);
+}
+
+static void writeCoreFile(CrashDebugCommandLine* pCommandLine)
+{
+    __try
+    {
+        ElfCore_Write(pCommandLine->pMemory, &pCommandLine->context, pCommandLine->pCoreFilename);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+}
+
+static void writeCompactDump(CrashDebugCommandLine* pCommandLine)
+{
+    __try
+    {
+        CompactDump_Write(pCommandLine->pMemory, &pCommandLine->context, pCommandLine->pConvertFilename);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+}
+
+static void runHeapWalk(CrashDebugCommandLine* pCommandLine)
+{
+    __try
+    {
+        HeapWalkResult result = HeapWalk_FromSymbols(pCommandLine->pMemory, &pCommandLine->symbols);
+        HeapWalk_PrintReport(&result);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+}
+
+static void runDiff(CrashDebugCommandLine* pCommandLine)
+{
+    DumpDiff diff;
+
+    __try
+    {
+        DumpDiff_CompareWithFile(&diff, pCommandLine->pMemory, pCommandLine->pDiffFilename);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+    DumpDiff_PrintReport(&diff, &pCommandLine->symbols);
+    DumpDiff_Uninit(&diff);
+}
+
+static void runStackUsage(CrashDebugCommandLine* pCommandLine)
+{
+    const RtosThreads* pThreads = loadFreeRtosThreads(pCommandLine) ? &g_rtosThreads : NULL;
+    StackUsage         usage;
+
+    __try
+    {
+        StackUsage_Init(&usage, pCommandLine->pMemory, &pCommandLine->symbols, pThreads, STACK_USAGE_DEFAULT_FILL);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+    StackUsage_PrintReport(&usage);
+    StackUsage_Uninit(&usage);
+}
+
+static IComm* wrapCommForPackets(CrashDebugCommandLine* pCommandLine, IComm* pComm)
+{
+    g_pPacketComm = PacketIComm_Init(pComm);
+    PacketIComm_EnableResponseCache(g_pPacketComm, PACKET_ICOMM_DEFAULT_CACHE_SIZE);
+    PacketIComm_AddHandler(g_pPacketComm, SearchPackets_Handle, pCommandLine->pMemory);
+    PacketIComm_AddHandler(g_pPacketComm, CrcPackets_Handle, pCommandLine->pMemory);
+    addThreadPackets(pCommandLine, g_pPacketComm);
+    return g_pPacketComm;
+}
+
+static void addThreadPackets(CrashDebugCommandLine* pCommandLine, IComm* pPacketComm)
+{
+    if (!loadFreeRtosThreads(pCommandLine))
+        return;
+    ThreadPackets_Init(&g_threadPackets, &g_rtosThreads, &pCommandLine->context);
+    PacketIComm_AddHandler(pPacketComm, ThreadPackets_Handle, &g_threadPackets);
+}
+
+static int loadFreeRtosThreads(CrashDebugCommandLine* pCommandLine)
+{
+    /* FreeRTOS firmware is recognized by its pxCurrentTCB global. */
+    if (!ElfSymbols_Find(&pCommandLine->symbols, "pxCurrentTCB"))
+        return FALSE;
+    __try
+    {
+        FreeRtosThreads_Init(&g_rtosThreads, pCommandLine->pMemory, &pCommandLine->symbols, &pCommandLine->context);
+    }
+    __catch
+    {
+        fprintf(stderr, "WARNING: FreeRTOS threads aren't available. %s\n", getExceptionMessage());
+        clearExceptionCode();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static IComm* wrapCommForTrace(CrashDebugCommandLine* pCommandLine, IComm* pComm)
+{
+    if (!pCommandLine->pTraceFilename)
+        return pComm;
+    __try
+    {
+        g_pTraceComm = TraceIComm_Init(pComm, pCommandLine->pTraceFilename);
+    }
+    __catch
+    {
+        fprintf(stderr, "ERROR: %s\n", getExceptionMessage());
+        __rethrow;
+    }
+    return g_pTraceComm;
+}
+
+static IComm* wrapCommForStats(CrashDebugCommandLine* pCommandLine, IComm* pComm)
+{
+    if (!pCommandLine->displayStats)
+        return pComm;
+    g_pStatsComm = StatsIComm_Init(pComm, pCommandLine->dumpLoadedMicroseconds);
+    return g_pStatsComm;
+}
+
+static void installTerminationHandlers(CrashDebugCommandLine* pCommandLine)
+{
+    /* GDB terminates its pipe connected remote stubs with a signal when it exits.  Stop the session cleanly instead so
+       that the exit reports still get printed. */
+    if (!pCommandLine->displayStats && !pCommandLine->pTraceFilename)
+        return;
+    signal(SIGTERM, handleTerminationSignal);
+    signal(SIGINT, handleTerminationSignal);
+}
+
+static void handleTerminationSignal(int signalNumber)
+{
+    /* Only async-signal-safe work can be done here.  main() prints the reports once mriPlatform_Run() returns. */
+    g_terminationSignal = signalNumber;
+    mriPlatform_RequestStop();
+}
+
+static void printExitReports(void)
+{
+    CrashDebugCommandLine* pCommandLine = g_pReportCommandLine;
+
+    if (!pCommandLine)
+        return;
+    if (pCommandLine->displayStats)
+        CrashDebugStats_Print(pCommandLine, g_pStatsComm ? StatsIComm_GetStats(g_pStatsComm) : NULL);
+    if (g_pTraceComm)
+        TraceIComm_PrintSummary(g_pTraceComm);
+}
+
+static void reraiseTerminationSignal(void)
+{
+    /* Exit with the same status as if the signal hadn't been caught. */
+    if (!g_terminationSignal)
+        return;
+    signal(g_terminationSignal, SIG_DFL);
+    raise(g_terminationSignal);
+}